@@ -201,12 +201,15 @@
         'allocator_shim.cc',
         'allocator_shim.h',
         'generic_allocators.cc',
+        'size_class_allocator.cc',
+        'size_class_allocator.h',
         'win_allocator.cc',        
       ],
       # sources! means that these are not compiled directly.
       'sources!': [
         # Included by allocator_shim.cc for maximal inlining.
         'generic_allocators.cc',
+        'size_class_allocator.cc',
         'win_allocator.cc',
 
         # We simply don't use these, but list them above so that IDE
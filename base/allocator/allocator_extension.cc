@@ -24,6 +24,27 @@ void ReleaseFreeMemory() {
     release_free_memory_function();
 }
 
+ScopedHeap::ScopedHeap(HeapId heap_id) : previous_heap_id_(HEAP_DEFAULT) {
+  if (thunks::SetCurrentHeapFunction* set_current_heap_function =
+          base::allocator::thunks::GetSetCurrentHeapFunction())
+    previous_heap_id_ = set_current_heap_function(heap_id);
+}
+
+ScopedHeap::~ScopedHeap() {
+  if (thunks::SetCurrentHeapFunction* set_current_heap_function =
+          base::allocator::thunks::GetSetCurrentHeapFunction())
+    set_current_heap_function(previous_heap_id_);
+}
+
+bool GetHeapUsage(HeapId heap_id,
+                  size_t* allocated_bytes,
+                  size_t* committed_bytes) {
+  if (thunks::GetHeapUsageFunction* get_heap_usage_function =
+          base::allocator::thunks::GetGetHeapUsageFunction())
+    return get_heap_usage_function(heap_id, allocated_bytes, committed_bytes);
+  return false;
+}
+
 void SetGetStatsFunction(thunks::GetStatsFunction* get_stats_function) {
   DCHECK_EQ(base::allocator::thunks::GetGetStatsFunction(),
             reinterpret_cast<thunks::GetStatsFunction*>(NULL));
@@ -38,5 +59,20 @@ void SetReleaseFreeMemoryFunction(
       release_free_memory_function);
 }
 
+void SetSetCurrentHeapFunction(
+    thunks::SetCurrentHeapFunction* set_current_heap_function) {
+  DCHECK_EQ(base::allocator::thunks::GetSetCurrentHeapFunction(),
+            reinterpret_cast<thunks::SetCurrentHeapFunction*>(NULL));
+  base::allocator::thunks::SetSetCurrentHeapFunction(
+      set_current_heap_function);
+}
+
+void SetGetHeapUsageFunction(
+    thunks::GetHeapUsageFunction* get_heap_usage_function) {
+  DCHECK_EQ(base::allocator::thunks::GetGetHeapUsageFunction(),
+            reinterpret_cast<thunks::GetHeapUsageFunction*>(NULL));
+  base::allocator::thunks::SetGetHeapUsageFunction(get_heap_usage_function);
+}
+
 }  // namespace allocator
 }  // namespace base
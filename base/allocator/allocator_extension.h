@@ -6,8 +6,11 @@
 #define BASE_ALLOCATOR_ALLOCATOR_EXTENSION_H
 #pragma once
 
+#include <stddef.h>
+
 #include "base/allocator/allocator_extension_thunks.h"
 #include "base/base_export.h"
+#include "base/basictypes.h"
 #include "build/build_config.h"
 
 namespace base {
@@ -25,6 +28,41 @@ BASE_EXPORT void GetStats(char* buffer, int buffer_length);
 // system.
 BASE_EXPORT void ReleaseFreeMemory();
 
+// Subsystems whose allocations can be kept in heaps of their own, with
+// allocators that support it (currently the size-class allocator).  Keeping
+// them apart stops one subsystem's churn from fragmenting another's memory,
+// and lets GetHeapUsage() show which one is using it.
+enum HeapId {
+  HEAP_DEFAULT = 0,
+  HEAP_RENDERER,
+  HEAP_NET,
+  HEAP_GPU,
+  HEAP_ID_COUNT
+};
+
+// Makes allocations made on the current thread during the lifetime of this
+// object come from the heap for |heap_id|.  Memory is still freed back to
+// the heap it came from, on any thread.  Does nothing if the allocator
+// doesn't keep separate heaps.
+class BASE_EXPORT ScopedHeap {
+ public:
+  explicit ScopedHeap(HeapId heap_id);
+  ~ScopedHeap();
+
+ private:
+  int previous_heap_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedHeap);
+};
+
+// Returns, through |allocated_bytes|, the number of bytes allocated from the
+// heap for |heap_id| and, through |committed_bytes|, the number of bytes it
+// has taken from the system.  Returns false if the allocator doesn't keep
+// separate heaps.
+BASE_EXPORT bool GetHeapUsage(HeapId heap_id,
+                              size_t* allocated_bytes,
+                              size_t* committed_bytes);
+
 
 // These settings allow specifying a callback used to implement the allocator
 // extension functions.  These are optional, but if set they must only be set
@@ -39,6 +77,12 @@ BASE_EXPORT void SetGetStatsFunction(
 
 BASE_EXPORT void SetReleaseFreeMemoryFunction(
     thunks::ReleaseFreeMemoryFunction* release_free_memory_function);
+
+BASE_EXPORT void SetSetCurrentHeapFunction(
+    thunks::SetCurrentHeapFunction* set_current_heap_function);
+
+BASE_EXPORT void SetGetHeapUsageFunction(
+    thunks::GetHeapUsageFunction* get_heap_usage_function);
 }  // namespace allocator
 }  // namespace base
 
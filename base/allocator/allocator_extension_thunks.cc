@@ -19,6 +19,8 @@ namespace thunks {
 
 static GetStatsFunction* g_get_stats_function = NULL;
 static ReleaseFreeMemoryFunction* g_release_free_memory_function = NULL;
+static SetCurrentHeapFunction* g_set_current_heap_function = NULL;
+static GetHeapUsageFunction* g_get_heap_usage_function = NULL;
 
 void SetGetStatsFunction(GetStatsFunction* get_stats_function) {
   g_get_stats_function = get_stats_function;
@@ -37,6 +39,23 @@ ReleaseFreeMemoryFunction* GetReleaseFreeMemoryFunction() {
   return g_release_free_memory_function;
 }
 
+void SetSetCurrentHeapFunction(
+    SetCurrentHeapFunction* set_current_heap_function) {
+  g_set_current_heap_function = set_current_heap_function;
+}
+
+SetCurrentHeapFunction* GetSetCurrentHeapFunction() {
+  return g_set_current_heap_function;
+}
+
+void SetGetHeapUsageFunction(GetHeapUsageFunction* get_heap_usage_function) {
+  g_get_heap_usage_function = get_heap_usage_function;
+}
+
+GetHeapUsageFunction* GetGetHeapUsageFunction() {
+  return g_get_heap_usage_function;
+}
+
 }  // namespace thunks
 }  // namespace allocator
 }  // namespace base
@@ -6,6 +6,8 @@
 #define BASE_ALLOCATOR_ALLOCATOR_THUNKS_EXTENSION_H
 #pragma once
 
+#include <stddef.h>
+
 namespace base {
 namespace allocator {
 namespace thunks {
@@ -23,6 +25,15 @@ void SetReleaseFreeMemoryFunction(
     ReleaseFreeMemoryFunction* release_free_memory_function);
 ReleaseFreeMemoryFunction* GetReleaseFreeMemoryFunction();
 
+typedef int SetCurrentHeapFunction(int);
+void SetSetCurrentHeapFunction(
+    SetCurrentHeapFunction* set_current_heap_function);
+SetCurrentHeapFunction* GetSetCurrentHeapFunction();
+
+typedef bool GetHeapUsageFunction(int, size_t*, size_t*);
+void SetGetHeapUsageFunction(GetHeapUsageFunction* get_heap_usage_function);
+GetHeapUsageFunction* GetGetHeapUsageFunction();
+
 }  // namespace thunks
 }  // namespace allocator
 }  // namespace base
@@ -37,6 +37,7 @@ typedef enum {
   JEMALLOC,    // JEMalloc.
   WINHEAP,  // Windows Heap (standard Windows allocator).
   WINLFH,      // Windows LFH Heap.
+  SIZECLASS,   // Size-class allocator with a heap per subsystem.
 } Allocator;
 
 // This is the default allocator. This value can be changed at startup by
@@ -57,6 +58,7 @@ static const char secondary_name[] = "CHROME_ALLOCATOR_2";
 // possible.
 #include "tcmalloc.cc"
 #include "win_allocator.cc"
+#include "size_class_allocator.cc"
 
 // Forward declarations from jemalloc.
 extern "C" {
@@ -121,6 +123,9 @@ void* malloc(size_t size) __THROW {
       case WINLFH:
         ptr = win_heap_malloc(size);
         break;
+      case SIZECLASS:
+        ptr = size_class_malloc(size);
+        break;
       case TCMALLOC:
       default:
         ptr = do_malloc(size);
@@ -149,6 +154,9 @@ void free(void* p) __THROW {
     case WINLFH:
       win_heap_free(p);
       return;
+    case SIZECLASS:
+      size_class_free(p);
+      return;
   }
 #endif
   // TCMalloc case.
@@ -173,6 +181,9 @@ void* realloc(void* ptr, size_t size) __THROW {
       case WINLFH:
         new_ptr = win_heap_realloc(ptr, size);
         break;
+      case SIZECLASS:
+        new_ptr = size_class_realloc(ptr, size);
+        break;
       case TCMALLOC:
       default:
         new_ptr = do_realloc(ptr, size);
@@ -205,6 +216,9 @@ void malloc_stats(void) __THROW {
     case WINLFH:
       // No stats.
       return;
+    case SIZECLASS:
+      // Stats are reported through base::allocator::GetStats().
+      return;
   }
 #endif
   tc_malloc_stats();
@@ -220,6 +234,8 @@ extern "C" size_t _msize(void* p) {
     case WINHEAP:
     case WINLFH:
       return win_heap_msize(p);
+    case SIZECLASS:
+      return size_class_msize(p);
   }
 #endif
   return MallocExtension::instance()->GetAllocatedSize(p);
@@ -238,6 +254,18 @@ static void release_free_memory_thunk() {
   MallocExtension::instance()->ReleaseFreeMemory();
 }
 
+static bool size_class_heap_init() {
+  if (!size_class_init())
+    return false;
+  base::allocator::thunks::SetGetStatsFunction(size_class_get_stats);
+  base::allocator::thunks::SetReleaseFreeMemoryFunction(
+      size_class_release_free_memory);
+  base::allocator::thunks::SetSetCurrentHeapFunction(
+      size_class_set_current_heap);
+  base::allocator::thunks::SetGetHeapUsageFunction(size_class_get_heap_usage);
+  return true;
+}
+
 // The CRT heap initialization stub.
 extern "C" int _heap_init() {
 #ifdef ENABLE_DYNAMIC_ALLOCATOR_SWITCHING
@@ -251,6 +279,8 @@ extern "C" int _heap_init() {
       allocator = WINLFH;
     else if (!stricmp(environment_value, "tcmalloc"))
       allocator = TCMALLOC;
+    else if (!stricmp(environment_value, "sizeclass"))
+      allocator = SIZECLASS;
   }
 
   switch (allocator) {
@@ -260,6 +290,8 @@ extern "C" int _heap_init() {
       return win_heap_init(false) ? 1 : 0;
     case WINLFH:
       return win_heap_init(true) ? 1 : 0;
+    case SIZECLASS:
+      return size_class_heap_init() ? 1 : 0;
     case TCMALLOC:
     default:
       // fall through
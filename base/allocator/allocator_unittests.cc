@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <algorithm>   // for min()
+#include "base/allocator/size_class_allocator.h"
 #include "base/atomicops.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -481,6 +482,76 @@ TEST(Allocators, Recalloc) {
 }
 #endif
 
+TEST(SizeClassAllocator, Malloc) {
+  ASSERT_TRUE(size_class_init());
+  for (int size = 0; size >= 0; size = NextSize(size)) {
+    unsigned char* ptr =
+        reinterpret_cast<unsigned char*>(size_class_malloc(size));
+    ASSERT_TRUE(ptr != NULL);
+    CheckAlignment(ptr, 16);
+    EXPECT_LE(static_cast<size_t>(size), size_class_msize(ptr));
+    Fill(ptr, size);
+    EXPECT_TRUE(Valid(ptr, size));
+    size_class_free(ptr);
+  }
+  EXPECT_EQ(NULL, size_class_malloc(kTooBig));
+}
+
+TEST(SizeClassAllocator, Realloc) {
+  ASSERT_TRUE(size_class_init());
+  for (int src_size = 0; src_size >= 0; src_size = NextSize(src_size)) {
+    for (int dst_size = 0; dst_size >= 0; dst_size = NextSize(dst_size)) {
+      unsigned char* src =
+          reinterpret_cast<unsigned char*>(size_class_malloc(src_size));
+      Fill(src, src_size);
+      unsigned char* dst =
+          reinterpret_cast<unsigned char*>(size_class_realloc(src, dst_size));
+      EXPECT_TRUE(Valid(dst, min(src_size, dst_size)));
+      if (dst != NULL)
+        size_class_free(dst);
+    }
+  }
+}
+
+TEST(SizeClassAllocator, Heaps) {
+  ASSERT_TRUE(size_class_init());
+  const int kHeap = 3;
+  size_t allocated = 0;
+  size_t committed = 0;
+  ASSERT_TRUE(size_class_get_heap_usage(kHeap, &allocated, &committed));
+  EXPECT_FALSE(size_class_get_heap_usage(kSizeClassNumHeaps, &allocated,
+                                         &committed));
+
+  int previous_heap = size_class_set_current_heap(kHeap);
+  void* small = size_class_malloc(100);
+  void* large = size_class_malloc(kNotTooBig);
+  EXPECT_EQ(kHeap, size_class_set_current_heap(previous_heap));
+
+  size_t heap_allocated = 0;
+  size_t heap_committed = 0;
+  ASSERT_TRUE(size_class_get_heap_usage(kHeap, &heap_allocated,
+                                        &heap_committed));
+  EXPECT_LE(allocated + kNotTooBig + 100, heap_allocated);
+  EXPECT_LE(heap_allocated, heap_committed);
+
+  // Reallocated memory stays in its heap.
+  large = size_class_realloc(large, 2 * kNotTooBig);
+  size_class_free(small);
+  size_class_release_free_memory();
+  ASSERT_TRUE(size_class_get_heap_usage(kHeap, &heap_allocated,
+                                        &heap_committed));
+  EXPECT_LE(allocated + 2 * kNotTooBig, heap_allocated);
+
+  size_class_free(large);
+  ASSERT_TRUE(size_class_get_heap_usage(kHeap, &heap_allocated,
+                                        &heap_committed));
+  EXPECT_EQ(allocated, heap_allocated);
+
+  char stats[1024];
+  size_class_get_stats(stats, sizeof(stats));
+  EXPECT_TRUE(strstr(stats, "Heap 3:") != NULL);
+}
+
 
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
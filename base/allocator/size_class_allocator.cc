@@ -0,0 +1,540 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This is the size-class allocator described in size_class_allocator.h.  It
+// gets all of its memory straight from the system, and, like the other
+// allocators here, can't use anything from base.
+
+#include "base/allocator/size_class_allocator.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+// Memory comes from the system in spans aligned to kSpanSize, so the span
+// holding any allocation is found by masking the allocation's address.  A
+// span holds either objects of a single size class from a single heap, or a
+// single large allocation.  On Windows, kSpanSize is the allocation
+// granularity of VirtualAlloc().
+const size_t kSpanSize = 64 * 1024;
+const size_t kPageSize = 4096;
+
+// Allocations are aligned as the system allocators' are.
+const size_t kAlignment = 16;
+
+// Bigger allocations get spans of their own.
+const size_t kMaxSmallSize = 8 * 1024;
+
+// Size classes go up in kAlignment steps to kMaxStepSize, and then in four
+// steps per power of two, so no more than a fifth of an allocation is
+// wasted on rounding.
+const size_t kMaxStepSize = 256;
+const int kNumSizeClasses = 16 + 5 * 4;
+
+// Above kMaxStepSize every size class is a multiple of this.
+const size_t kClassIndexStep = 64;
+
+const unsigned char kLargeSizeClass = 0xff;
+
+// A thread caches up to this many bytes of each size class of each heap.
+const size_t kMaxCachedBytes = 32 * 1024;
+
+struct Span {
+  size_t size;       // The object size, or the large allocation's size.
+  size_t span_size;  // The number of bytes taken from the system.
+  unsigned char size_class;
+  unsigned char heap_id;
+};
+
+// The first kSpanHeaderSize bytes of each span hold its Span, which leaves
+// the allocations after it aligned.
+const size_t kSpanHeaderSize = 64;
+
+struct FreeObject {
+  FreeObject* next;
+};
+
+struct FreeList {
+  FreeObject* head;
+  int length;
+};
+
+// Threads move objects in and out of a heap in batches, so its lock is
+// held rarely and briefly.
+struct Heap {
+  volatile long lock;
+  FreeObject* free_lists[kNumSizeClasses];
+  // The unused part of the newest span of each size class.
+  char* next_object[kNumSizeClasses];
+  char* span_end[kNumSizeClasses];
+  size_t allocated_bytes;
+  size_t committed_bytes;
+};
+
+struct ThreadCache {
+  int heap_id;
+  FreeList lists[kSizeClassNumHeaps][kNumSizeClasses];
+};
+
+bool g_initialized = false;
+size_t g_class_sizes[kNumSizeClasses];
+// The most objects of each size class a thread caches, and the number it
+// moves to or from a heap at once.
+int g_max_cached[kNumSizeClasses];
+int g_batch_sizes[kNumSizeClasses];
+// The size class of each size above kMaxStepSize, by the size divided by
+// kClassIndexStep and rounded up.
+unsigned char g_class_index[kMaxSmallSize / kClassIndexStep + 1];
+
+Heap g_heaps[kSizeClassNumHeaps];
+
+#if defined(_WIN32)
+DWORD g_tls_index = TLS_OUT_OF_INDEXES;
+#else
+pthread_key_t g_tls_key;
+#endif
+
+// The heaps' locks are spin locks, as the locks of whatever is beneath us
+// might allocate.
+
+#if defined(_WIN32)
+bool TryLock(volatile long* lock) {
+  return InterlockedCompareExchange(lock, 1, 0) == 0;
+}
+
+void Unlock(volatile long* lock) {
+  InterlockedExchange(lock, 0);
+}
+
+void YieldThread() {
+  SwitchToThread();
+}
+#else
+bool TryLock(volatile long* lock) {
+  return __sync_bool_compare_and_swap(lock, 0, 1);
+}
+
+void Unlock(volatile long* lock) {
+  __sync_lock_release(lock);
+}
+
+void YieldThread() {
+  sched_yield();
+}
+#endif
+
+void Lock(volatile long* lock) {
+  for (int tries = 0; !TryLock(lock); ++tries) {
+    if (tries >= 100)
+      YieldThread();
+  }
+}
+
+size_t RoundUp(size_t size, size_t alignment) {
+  return (size + alignment - 1) & ~(alignment - 1);
+}
+
+// Returns |size| bytes, a multiple of kPageSize, aligned to kSpanSize.
+char* AllocateSpanMemory(size_t size) {
+#if defined(_WIN32)
+  return static_cast<char*>(
+      VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+#else
+  // Map enough to find an aligned span inside it, then unmap the rest.
+  size_t mapped_size = size + kSpanSize;
+  char* mapped = static_cast<char*>(mmap(NULL, mapped_size,
+                                         PROT_READ | PROT_WRITE,
+                                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  if (mapped == MAP_FAILED)
+    return NULL;
+  char* span = mapped + (RoundUp(reinterpret_cast<size_t>(mapped), kSpanSize) -
+                         reinterpret_cast<size_t>(mapped));
+  if (span != mapped)
+    munmap(mapped, span - mapped);
+  if (span + size != mapped + mapped_size)
+    munmap(span + size, (mapped + mapped_size) - (span + size));
+  return span;
+#endif
+}
+
+void FreeSpanMemory(char* span, size_t size) {
+#if defined(_WIN32)
+  VirtualFree(span, 0, MEM_RELEASE);
+#else
+  munmap(span, size);
+#endif
+}
+
+Span* SpanOf(void* ptr) {
+  return reinterpret_cast<Span*>(
+      reinterpret_cast<size_t>(ptr) & ~(kSpanSize - 1));
+}
+
+void InitSizeClasses() {
+  int size_class = 0;
+  for (size_t size = kAlignment; size <= kMaxStepSize; size += kAlignment)
+    g_class_sizes[size_class++] = size;
+  for (size_t power = kMaxStepSize; power < kMaxSmallSize; power *= 2) {
+    for (size_t step = 1; step <= 4; ++step)
+      g_class_sizes[size_class++] = power + step * power / 4;
+  }
+
+  size_class = 0;
+  for (size_t i = 0; i < sizeof(g_class_index); ++i) {
+    while (g_class_sizes[size_class] < i * kClassIndexStep)
+      ++size_class;
+    g_class_index[i] = static_cast<unsigned char>(size_class);
+  }
+
+  for (int i = 0; i < kNumSizeClasses; ++i) {
+    int max_cached = static_cast<int>(kMaxCachedBytes / g_class_sizes[i]);
+    if (max_cached < 2)
+      max_cached = 2;
+    if (max_cached > 256)
+      max_cached = 256;
+    g_max_cached[i] = max_cached;
+    g_batch_sizes[i] = max_cached / 2;
+  }
+}
+
+int SizeClass(size_t size) {
+  if (size <= kMaxStepSize)
+    return size ? static_cast<int>((size - 1) / kAlignment) : 0;
+  return g_class_index[(size + kClassIndexStep - 1) / kClassIndexStep];
+}
+
+// Moves up to |count| objects of |size_class| from heap |heap_id| to the
+// front of |list|.  Returns false if none could be had.
+bool FetchObjects(int heap_id, int size_class, int count, FreeList* list) {
+  Heap* heap = &g_heaps[heap_id];
+  size_t size = g_class_sizes[size_class];
+  int fetched = 0;
+  Lock(&heap->lock);
+  while (fetched < count) {
+    FreeObject* object = heap->free_lists[size_class];
+    if (object) {
+      heap->free_lists[size_class] = object->next;
+    } else {
+      if (static_cast<size_t>(heap->span_end[size_class] -
+                              heap->next_object[size_class]) < size) {
+        // Don't go to the system for more than was asked for.
+        if (fetched)
+          break;
+        char* memory = AllocateSpanMemory(kSpanSize);
+        if (!memory)
+          break;
+        Span* span = reinterpret_cast<Span*>(memory);
+        span->size = size;
+        span->span_size = kSpanSize;
+        span->size_class = static_cast<unsigned char>(size_class);
+        span->heap_id = static_cast<unsigned char>(heap_id);
+        heap->next_object[size_class] = memory + kSpanHeaderSize;
+        heap->span_end[size_class] = memory + kSpanHeaderSize +
+            (kSpanSize - kSpanHeaderSize) / size * size;
+        heap->committed_bytes += kSpanSize;
+      }
+      object = reinterpret_cast<FreeObject*>(heap->next_object[size_class]);
+      heap->next_object[size_class] += size;
+    }
+    object->next = list->head;
+    list->head = object;
+    ++list->length;
+    ++fetched;
+  }
+  heap->allocated_bytes += fetched * size;
+  Unlock(&heap->lock);
+  return fetched > 0;
+}
+
+// Moves the first |count| objects of |list|, which are of |size_class|, back
+// to heap |heap_id|.
+void ReleaseObjects(int heap_id, int size_class, int count, FreeList* list) {
+  FreeObject* first = list->head;
+  FreeObject* last = first;
+  for (int i = 1; i < count; ++i)
+    last = last->next;
+  list->head = last->next;
+  list->length -= count;
+
+  Heap* heap = &g_heaps[heap_id];
+  Lock(&heap->lock);
+  last->next = heap->free_lists[size_class];
+  heap->free_lists[size_class] = first;
+  heap->allocated_bytes -= count * g_class_sizes[size_class];
+  Unlock(&heap->lock);
+}
+
+void FlushThreadCache(ThreadCache* cache) {
+  for (int heap_id = 0; heap_id < kSizeClassNumHeaps; ++heap_id) {
+    for (int size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+      FreeList* list = &cache->lists[heap_id][size_class];
+      if (list->length)
+        ReleaseObjects(heap_id, size_class, list->length, list);
+    }
+  }
+}
+
+// Thread caches are themselves allocated from heap 0, directly.
+int ThreadCacheSizeClass() {
+  return SizeClass(sizeof(ThreadCache));
+}
+
+#if defined(_WIN32)
+ThreadCache* GetThreadCache() {
+  // TlsGetValue() clears the last error, which malloc() must not change.
+  DWORD error = GetLastError();
+  ThreadCache* cache = static_cast<ThreadCache*>(TlsGetValue(g_tls_index));
+  SetLastError(error);
+  return cache;
+}
+
+bool SetThreadCache(ThreadCache* cache) {
+  return TlsSetValue(g_tls_index, cache) != 0;
+}
+#else
+ThreadCache* GetThreadCache() {
+  return static_cast<ThreadCache*>(pthread_getspecific(g_tls_key));
+}
+
+bool SetThreadCache(ThreadCache* cache) {
+  return pthread_setspecific(g_tls_key, cache) == 0;
+}
+#endif
+
+void DestroyThreadCache(void* thread_cache) {
+  ThreadCache* cache = static_cast<ThreadCache*>(thread_cache);
+  FlushThreadCache(cache);
+  FreeList list = { reinterpret_cast<FreeObject*>(cache), 1 };
+  list.head->next = NULL;
+  ReleaseObjects(0, ThreadCacheSizeClass(), 1, &list);
+}
+
+ThreadCache* GetOrCreateThreadCache() {
+  ThreadCache* cache = GetThreadCache();
+  if (cache)
+    return cache;
+
+  FreeList list = { NULL, 0 };
+  if (!FetchObjects(0, ThreadCacheSizeClass(), 1, &list))
+    return NULL;
+  cache = reinterpret_cast<ThreadCache*>(list.head);
+  memset(cache, 0, sizeof(*cache));
+  if (!SetThreadCache(cache)) {
+    DestroyThreadCache(cache);
+    return NULL;
+  }
+  return cache;
+}
+
+void* AllocateLarge(int heap_id, size_t size) {
+  if (size > ~static_cast<size_t>(0) - kSpanHeaderSize - kSpanSize)
+    return NULL;
+  size_t span_size = RoundUp(kSpanHeaderSize + size, kPageSize);
+  char* memory = AllocateSpanMemory(span_size);
+  if (!memory)
+    return NULL;
+  Span* span = reinterpret_cast<Span*>(memory);
+  span->size = size;
+  span->span_size = span_size;
+  span->size_class = kLargeSizeClass;
+  span->heap_id = static_cast<unsigned char>(heap_id);
+
+  Heap* heap = &g_heaps[heap_id];
+  Lock(&heap->lock);
+  heap->allocated_bytes += span_size;
+  heap->committed_bytes += span_size;
+  Unlock(&heap->lock);
+  return memory + kSpanHeaderSize;
+}
+
+void FreeLarge(Span* span) {
+  Heap* heap = &g_heaps[span->heap_id];
+  size_t span_size = span->span_size;
+  Lock(&heap->lock);
+  heap->allocated_bytes -= span_size;
+  heap->committed_bytes -= span_size;
+  Unlock(&heap->lock);
+  FreeSpanMemory(reinterpret_cast<char*>(span), span_size);
+}
+
+void* AllocateFromHeap(ThreadCache* cache, int heap_id, size_t size) {
+  if (size > kMaxSmallSize)
+    return AllocateLarge(heap_id, size);
+
+  int size_class = SizeClass(size);
+  FreeList* list = &cache->lists[heap_id][size_class];
+  if (!list->head &&
+      !FetchObjects(heap_id, size_class, g_batch_sizes[size_class], list)) {
+    return NULL;
+  }
+  FreeObject* object = list->head;
+  list->head = object->next;
+  --list->length;
+  return object;
+}
+
+}  // namespace
+
+extern "C" {
+
+bool size_class_init() {
+  if (g_initialized)
+    return true;
+  InitSizeClasses();
+#if defined(_WIN32)
+  // Windows has no destructors for TLS slots, so the objects cached by a
+  // thread that exits are lost; there are at most kMaxCachedBytes of each
+  // size class.
+  g_tls_index = TlsAlloc();
+  if (g_tls_index == TLS_OUT_OF_INDEXES)
+    return false;
+#else
+  if (pthread_key_create(&g_tls_key, DestroyThreadCache))
+    return false;
+#endif
+  g_initialized = true;
+  return true;
+}
+
+void* size_class_malloc(size_t size) {
+  ThreadCache* cache = GetOrCreateThreadCache();
+  if (!cache)
+    return NULL;
+  return AllocateFromHeap(cache, cache->heap_id, size);
+}
+
+void size_class_free(void* ptr) {
+  if (!ptr)
+    return;
+  Span* span = SpanOf(ptr);
+  if (span->size_class == kLargeSizeClass) {
+    FreeLarge(span);
+    return;
+  }
+
+  int heap_id = span->heap_id;
+  int size_class = span->size_class;
+  FreeObject* object = static_cast<FreeObject*>(ptr);
+  ThreadCache* cache = GetOrCreateThreadCache();
+  if (!cache) {
+    FreeList list = { object, 1 };
+    object->next = NULL;
+    ReleaseObjects(heap_id, size_class, 1, &list);
+    return;
+  }
+
+  FreeList* list = &cache->lists[heap_id][size_class];
+  object->next = list->head;
+  list->head = object;
+  if (++list->length > g_max_cached[size_class]) {
+    ReleaseObjects(heap_id, size_class,
+                   list->length - g_batch_sizes[size_class], list);
+  }
+}
+
+void* size_class_realloc(void* ptr, size_t size) {
+  if (!ptr)
+    return size_class_malloc(size);
+  if (!size) {
+    size_class_free(ptr);
+    return NULL;
+  }
+
+  // Stay put if the allocation would go in the same size class, or, for
+  // large allocations, if it still fits in at least half of its pages.
+  Span* span = SpanOf(ptr);
+  if (span->size_class != kLargeSizeClass) {
+    if (size <= kMaxSmallSize && SizeClass(size) == span->size_class)
+      return ptr;
+  } else {
+    size_t capacity = span->span_size - kSpanHeaderSize;
+    if (size > kMaxSmallSize && size <= capacity && size >= capacity / 2) {
+      span->size = size;
+      return ptr;
+    }
+  }
+
+  // The memory stays in the heap it was allocated from.
+  ThreadCache* cache = GetOrCreateThreadCache();
+  if (!cache)
+    return NULL;
+  void* new_ptr = AllocateFromHeap(cache, span->heap_id, size);
+  if (!new_ptr)
+    return NULL;
+  size_t old_size = size_class_msize(ptr);
+  memcpy(new_ptr, ptr, old_size < size ? old_size : size);
+  size_class_free(ptr);
+  return new_ptr;
+}
+
+size_t size_class_msize(void* ptr) {
+  Span* span = SpanOf(ptr);
+  if (span->size_class == kLargeSizeClass)
+    return span->size;
+  return g_class_sizes[span->size_class];
+}
+
+int size_class_set_current_heap(int heap_id) {
+  ThreadCache* cache = GetOrCreateThreadCache();
+  if (!cache)
+    return 0;
+  int previous_heap_id = cache->heap_id;
+  if (heap_id >= 0 && heap_id < kSizeClassNumHeaps)
+    cache->heap_id = heap_id;
+  return previous_heap_id;
+}
+
+bool size_class_get_heap_usage(int heap_id,
+                               size_t* allocated_bytes,
+                               size_t* committed_bytes) {
+  if (heap_id < 0 || heap_id >= kSizeClassNumHeaps)
+    return false;
+  Heap* heap = &g_heaps[heap_id];
+  Lock(&heap->lock);
+  *allocated_bytes = heap->allocated_bytes;
+  *committed_bytes = heap->committed_bytes;
+  Unlock(&heap->lock);
+  return true;
+}
+
+void size_class_get_stats(char* buffer, int buffer_length) {
+  buffer[0] = '\0';
+  int written = 0;
+  for (int heap_id = 0; heap_id < kSizeClassNumHeaps; ++heap_id) {
+    size_t allocated_bytes = 0;
+    size_t committed_bytes = 0;
+    size_class_get_heap_usage(heap_id, &allocated_bytes, &committed_bytes);
+#if defined(_WIN32)
+    int length = _snprintf(
+#else
+    int length = snprintf(
+#endif
+        buffer + written, buffer_length - written,
+        "Heap %d: %lu bytes allocated, %lu bytes committed\n", heap_id,
+        static_cast<unsigned long>(allocated_bytes),
+        static_cast<unsigned long>(committed_bytes));
+    if (length < 0 || length >= buffer_length - written)
+      break;
+    written += length;
+  }
+  // _snprintf() doesn't terminate what it truncates.
+  buffer[buffer_length - 1] = '\0';
+}
+
+void size_class_release_free_memory() {
+  ThreadCache* cache = GetThreadCache();
+  if (cache)
+    FlushThreadCache(cache);
+}
+
+}  // extern "C"
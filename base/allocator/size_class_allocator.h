@@ -0,0 +1,61 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// A size-class allocator with per-thread caches and a separate heap for each
+// of a few subsystems.  Small allocations are rounded up to one of a fixed
+// set of sizes, and each heap keeps the objects of each size in spans of
+// their own, so that short-lived allocations of one size do not fragment
+// the memory used for others, and one subsystem's allocations do not
+// fragment another's.  Each thread caches a few freed objects of each size,
+// so most allocations and frees take no lock.
+//
+// The heap a thread allocates from is chosen with
+// size_class_set_current_heap(), which base::allocator::ScopedHeap wraps.
+// Memory is always freed back to the heap it came from, whichever thread
+// frees it.
+//
+// Select it with CHROME_ALLOCATOR=sizeclass; see README.
+
+#ifndef BASE_ALLOCATOR_SIZE_CLASS_ALLOCATOR_H_
+#define BASE_ALLOCATOR_SIZE_CLASS_ALLOCATOR_H_
+#pragma once
+
+#include <stddef.h>
+
+extern "C" {
+
+// The number of heaps.  Threads allocate from heap 0 until they choose
+// another.
+enum { kSizeClassNumHeaps = 8 };
+
+// Must be called, on a single thread, before anything else.  Returns false
+// if the allocator can't be used.
+bool size_class_init();
+
+void* size_class_malloc(size_t size);
+void size_class_free(void* ptr);
+void* size_class_realloc(void* ptr, size_t size);
+size_t size_class_msize(void* ptr);
+
+// Makes later allocations on the calling thread come from heap |heap_id|,
+// and returns the heap they came from before.  An invalid |heap_id| is
+// ignored.
+int size_class_set_current_heap(int heap_id);
+
+// Returns the number of bytes heap |heap_id| has handed out, including
+// freed objects still held in thread caches, and the number of bytes it has
+// taken from the system.  Returns false if |heap_id| is invalid.
+bool size_class_get_heap_usage(int heap_id,
+                               size_t* allocated_bytes,
+                               size_t* committed_bytes);
+
+// Writes the usage of each heap into |buffer| as a null-terminated string.
+void size_class_get_stats(char* buffer, int buffer_length);
+
+// Returns the objects cached by the calling thread to their heaps.
+void size_class_release_free_memory();
+
+}  // extern "C"
+
+#endif  // BASE_ALLOCATOR_SIZE_CLASS_ALLOCATOR_H_
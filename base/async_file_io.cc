@@ -0,0 +1,77 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/async_file_io.h"
+
+#include "base/logging.h"
+#include "base/task_runner.h"
+
+namespace base {
+
+bool AsyncFileIO::Read(int64 offset,
+                       int bytes_to_read,
+                       const FileUtilProxy::ReadCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  if (bytes_to_read < 0)
+    return false;
+  if (native_ && StartNativeRead(offset, bytes_to_read, callback))
+    return true;
+  return FileUtilProxy::Read(fallback_task_runner_, file_, offset,
+                             bytes_to_read, callback);
+}
+
+bool AsyncFileIO::Write(int64 offset,
+                        const char* buffer,
+                        int bytes_to_write,
+                        const FileUtilProxy::WriteCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  if (bytes_to_write <= 0)
+    return false;
+  if (native_ && StartNativeWrite(offset, buffer, bytes_to_write, callback))
+    return true;
+  return FileUtilProxy::Write(fallback_task_runner_, file_, offset, buffer,
+                              bytes_to_write, callback);
+}
+
+#if !defined(OS_LINUX) && !defined(OS_WIN)
+
+// No native backend; every request goes to FileUtilProxy.
+AsyncFileIO::AsyncFileIO(PlatformFile file,
+                         int file_flags,
+                         TaskRunner* fallback_task_runner)
+    : file_(file),
+      fallback_task_runner_(fallback_task_runner),
+      native_(false) {
+}
+
+AsyncFileIO::~AsyncFileIO() {
+}
+
+bool AsyncFileIO::StartNativeRead(int64 offset,
+                                  int bytes_to_read,
+                                  const FileUtilProxy::ReadCallback& callback) {
+  NOTREACHED();
+  return false;
+}
+
+bool AsyncFileIO::StartNativeWrite(
+    int64 offset,
+    const char* buffer,
+    int bytes_to_write,
+    const FileUtilProxy::WriteCallback& callback) {
+  NOTREACHED();
+  return false;
+}
+
+void AsyncFileIO::OnFileCanReadWithoutBlocking(int fd) {
+  NOTREACHED();
+}
+
+void AsyncFileIO::OnFileCanWriteWithoutBlocking(int fd) {
+  NOTREACHED();
+}
+
+#endif  // !defined(OS_LINUX) && !defined(OS_WIN)
+
+}  // namespace base
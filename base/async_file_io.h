@@ -0,0 +1,127 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_ASYNC_FILE_IO_H_
+#define BASE_ASYNC_FILE_IO_H_
+#pragma once
+
+#include <set>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/file_util_proxy.h"
+#include "base/memory/ref_counted.h"
+#include "base/message_loop.h"
+#include "base/platform_file.h"
+#include "base/threading/non_thread_safe.h"
+
+#if defined(OS_LINUX)
+#include <linux/aio_abi.h>
+#endif
+
+namespace base {
+
+class TaskRunner;
+
+// Reads and writes a file without blocking the calling thread, using the
+// kernel's asynchronous I/O where it can, and FileUtilProxy otherwise.
+//
+// FileUtilProxy::Read() and Write() run each request as a blocking call on
+// a worker thread, so each one costs two thread hops and a parked worker.
+// AsyncFileIO instead hands the request to the kernel and is told of the
+// completion by the thread's MessageLoopForIO:
+//  - On Windows, through the I/O completion port, if the file was opened
+//    with PLATFORM_FILE_ASYNC.
+//  - On Linux, through Linux AIO (io_submit) and an eventfd watched by
+//    MessagePumpLibevent, if the file was opened with O_DIRECT and the
+//    request's offset and size are multiples of kDirectIOAlignment. Linux
+//    AIO completes buffered I/O synchronously inside io_submit(), which
+//    would block the IO thread on the disk, so other requests go to the
+//    worker thread.
+// Everything else, including every request on other platforms, falls back
+// to FileUtilProxy on |fallback_task_runner|.
+//
+// Callbacks are the same as FileUtilProxy's, and run on the thread that
+// made the request. An AsyncFileIO must be used on a single thread, which
+// must have a MessageLoopForIO, and must be destroyed before the file is
+// closed. Destroying it waits for native requests in flight and drops
+// their callbacks; requests that fell back to FileUtilProxy still complete.
+class BASE_EXPORT AsyncFileIO
+    : NON_EXPORTED_BASE(public NonThreadSafe),
+#if defined(OS_WIN)
+      public MessageLoopForIO::IOHandler {
+#elif defined(OS_POSIX)
+      public MessageLoopForIO::Watcher {
+#endif
+ public:
+  // The alignment O_DIRECT needs on Linux, in bytes.
+  enum { kDirectIOAlignment = 512 };
+
+  // |file_flags| are the PlatformFileFlags |file| was opened with.
+  AsyncFileIO(PlatformFile file,
+              int file_flags,
+              TaskRunner* fallback_task_runner);
+  virtual ~AsyncFileIO();
+
+  // Like FileUtilProxy::Read() and Write(). Return false if the request
+  // could not be started, in which case the callback is not called.
+  bool Read(int64 offset,
+            int bytes_to_read,
+            const FileUtilProxy::ReadCallback& callback);
+  bool Write(int64 offset,
+             const char* buffer,
+             int bytes_to_write,
+             const FileUtilProxy::WriteCallback& callback);
+
+  // Returns true if at least some requests can use the kernel's
+  // asynchronous I/O.
+  bool is_native() const { return native_; }
+
+ private:
+  // A request in flight. Defined by each platform's implementation.
+  struct Operation;
+
+  // Try to start a native read or write. Return false if the request should
+  // go to FileUtilProxy instead.
+  bool StartNativeRead(int64 offset,
+                       int bytes_to_read,
+                       const FileUtilProxy::ReadCallback& callback);
+  bool StartNativeWrite(int64 offset,
+                        const char* buffer,
+                        int bytes_to_write,
+                        const FileUtilProxy::WriteCallback& callback);
+
+#if defined(OS_WIN)
+  // MessageLoopForIO::IOHandler implementation.
+  virtual void OnIOCompleted(MessageLoopForIO::IOContext* context,
+                             DWORD bytes_transfered,
+                             DWORD error) OVERRIDE;
+#elif defined(OS_POSIX)
+  // MessageLoopForIO::Watcher implementation.
+  virtual void OnFileCanReadWithoutBlocking(int fd) OVERRIDE;
+  virtual void OnFileCanWriteWithoutBlocking(int fd) OVERRIDE;
+#endif
+
+  PlatformFile file_;
+  scoped_refptr<TaskRunner> fallback_task_runner_;
+  bool native_;
+
+  // Requests handed to the kernel and not yet completed.
+  std::set<Operation*> pending_;
+
+#if defined(OS_WIN)
+  // Set while the destructor waits for |pending_| to drain.
+  bool destroying_;
+#elif defined(OS_LINUX)
+  aio_context_t aio_context_;
+  int event_fd_;
+  MessageLoopForIO::FileDescriptorWatcher event_fd_watcher_;
+#endif
+
+  DISALLOW_COPY_AND_ASSIGN(AsyncFileIO);
+};
+
+}  // namespace base
+
+#endif  // BASE_ASYNC_FILE_IO_H_
@@ -0,0 +1,222 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/async_file_io.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "base/eintr_wrapper.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/stl_util.h"
+#include "base/task_runner.h"
+
+namespace base {
+
+namespace {
+
+// The most requests handed to the kernel at once; more go to the worker
+// thread.
+const int kMaxPendingOperations = 64;
+
+// glibc has no wrappers for the AIO system calls, and libaio is not worth
+// a dependency for four of them.
+int IoSetup(unsigned nr_events, aio_context_t* context) {
+  return syscall(__NR_io_setup, nr_events, context);
+}
+
+int IoDestroy(aio_context_t context) {
+  return syscall(__NR_io_destroy, context);
+}
+
+int IoSubmit(aio_context_t context, long nr, struct iocb** iocbs) {
+  return syscall(__NR_io_submit, context, nr, iocbs);
+}
+
+int IoGetEvents(aio_context_t context, long min_nr, long nr,
+                struct io_event* events, struct timespec* timeout) {
+  return syscall(__NR_io_getevents, context, min_nr, nr, events, timeout);
+}
+
+bool IsAligned(int64 value) {
+  return value % AsyncFileIO::kDirectIOAlignment == 0;
+}
+
+}  // namespace
+
+struct AsyncFileIO::Operation {
+  Operation() : size(0) {
+    memset(&control_block, 0, sizeof(control_block));
+  }
+
+  struct iocb control_block;
+  // Aligned for O_DIRECT, so it can't come from new[].
+  scoped_ptr_malloc<char> buffer;
+  int size;
+  FileUtilProxy::ReadCallback read_callback;
+  FileUtilProxy::WriteCallback write_callback;
+};
+
+AsyncFileIO::AsyncFileIO(PlatformFile file,
+                         int file_flags,
+                         TaskRunner* fallback_task_runner)
+    : file_(file),
+      fallback_task_runner_(fallback_task_runner),
+      native_(false),
+      aio_context_(0),
+      event_fd_(-1) {
+  // O_DIRECT is not one of the PlatformFileFlags, so ask the file itself.
+  int status_flags = fcntl(file_, F_GETFL);
+  if (status_flags == -1 || !(status_flags & O_DIRECT))
+    return;
+
+  if (IoSetup(kMaxPendingOperations, &aio_context_) != 0) {
+    DPLOG(WARNING) << "io_setup failed; using the worker thread";
+    aio_context_ = 0;
+    return;
+  }
+  event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (event_fd_ < 0) {
+    DPLOG(WARNING) << "eventfd failed; using the worker thread";
+    return;
+  }
+  if (!MessageLoopForIO::current()->WatchFileDescriptor(
+          event_fd_, true, MessageLoopForIO::WATCH_READ, &event_fd_watcher_,
+          this)) {
+    return;
+  }
+  native_ = true;
+}
+
+AsyncFileIO::~AsyncFileIO() {
+  DCHECK(CalledOnValidThread());
+  event_fd_watcher_.StopWatchingFileDescriptor();
+  // io_destroy() cancels what it can and waits for the rest, so the buffers
+  // are no longer in use once it returns.
+  if (aio_context_ && IoDestroy(aio_context_) != 0)
+    DPLOG(ERROR) << "io_destroy";
+  STLDeleteElements(&pending_);
+  if (event_fd_ >= 0 && HANDLE_EINTR(close(event_fd_)) < 0)
+    DPLOG(ERROR) << "close";
+}
+
+bool AsyncFileIO::StartNativeRead(int64 offset,
+                                  int bytes_to_read,
+                                  const FileUtilProxy::ReadCallback& callback) {
+  if (bytes_to_read == 0 || !IsAligned(offset) || !IsAligned(bytes_to_read) ||
+      pending_.size() >= static_cast<size_t>(kMaxPendingOperations)) {
+    return false;
+  }
+  void* buffer = NULL;
+  if (posix_memalign(&buffer, kDirectIOAlignment, bytes_to_read) != 0)
+    return false;
+
+  scoped_ptr<Operation> operation(new Operation);
+  operation->buffer.reset(static_cast<char*>(buffer));
+  operation->size = bytes_to_read;
+  operation->read_callback = callback;
+  operation->control_block.aio_lio_opcode = IOCB_CMD_PREAD;
+  operation->control_block.aio_offset = offset;
+
+  struct iocb* control_block = &operation->control_block;
+  control_block->aio_data = reinterpret_cast<uintptr_t>(operation.get());
+  control_block->aio_fildes = file_;
+  control_block->aio_buf = reinterpret_cast<uintptr_t>(buffer);
+  control_block->aio_nbytes = bytes_to_read;
+  control_block->aio_flags = IOCB_FLAG_RESFD;
+  control_block->aio_resfd = event_fd_;
+  if (IoSubmit(aio_context_, 1, &control_block) != 1) {
+    DPLOG(WARNING) << "io_submit failed; using the worker thread";
+    return false;
+  }
+  pending_.insert(operation.release());
+  return true;
+}
+
+bool AsyncFileIO::StartNativeWrite(
+    int64 offset,
+    const char* buffer,
+    int bytes_to_write,
+    const FileUtilProxy::WriteCallback& callback) {
+  if (!IsAligned(offset) || !IsAligned(bytes_to_write) ||
+      pending_.size() >= static_cast<size_t>(kMaxPendingOperations)) {
+    return false;
+  }
+  void* copy = NULL;
+  if (posix_memalign(&copy, kDirectIOAlignment, bytes_to_write) != 0)
+    return false;
+  memcpy(copy, buffer, bytes_to_write);
+
+  scoped_ptr<Operation> operation(new Operation);
+  operation->buffer.reset(static_cast<char*>(copy));
+  operation->size = bytes_to_write;
+  operation->write_callback = callback;
+  operation->control_block.aio_lio_opcode = IOCB_CMD_PWRITE;
+  operation->control_block.aio_offset = offset;
+
+  struct iocb* control_block = &operation->control_block;
+  control_block->aio_data = reinterpret_cast<uintptr_t>(operation.get());
+  control_block->aio_fildes = file_;
+  control_block->aio_buf = reinterpret_cast<uintptr_t>(copy);
+  control_block->aio_nbytes = bytes_to_write;
+  control_block->aio_flags = IOCB_FLAG_RESFD;
+  control_block->aio_resfd = event_fd_;
+  if (IoSubmit(aio_context_, 1, &control_block) != 1) {
+    DPLOG(WARNING) << "io_submit failed; using the worker thread";
+    return false;
+  }
+  pending_.insert(operation.release());
+  return true;
+}
+
+void AsyncFileIO::OnFileCanReadWithoutBlocking(int fd) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_EQ(event_fd_, fd);
+  uint64 completions = 0;
+  if (HANDLE_EINTR(read(event_fd_, &completions, sizeof(completions))) < 0 &&
+      errno != EAGAIN) {
+    DPLOG(ERROR) << "read";
+  }
+
+  struct io_event events[kMaxPendingOperations];
+  struct timespec no_wait = { 0, 0 };
+  int count = IoGetEvents(aio_context_, 0, kMaxPendingOperations, events,
+                          &no_wait);
+  if (count <= 0)
+    return;
+
+  ScopedVector<Operation> completed;
+  for (int i = 0; i < count; ++i) {
+    Operation* operation = reinterpret_cast<Operation*>(events[i].data);
+    pending_.erase(operation);
+    completed.push_back(operation);
+  }
+
+  // A callback may delete |this|, so don't touch the members from here on.
+  for (int i = 0; i < count; ++i) {
+    Operation* operation = completed[i];
+    int result = static_cast<int>(events[i].res);
+    PlatformFileError error =
+        result < 0 ? PLATFORM_FILE_ERROR_FAILED : PLATFORM_FILE_OK;
+    if (!operation->read_callback.is_null()) {
+      operation->read_callback.Run(error, operation->buffer.get(), result);
+    } else if (!operation->write_callback.is_null()) {
+      operation->write_callback.Run(error, result);
+    }
+  }
+}
+
+void AsyncFileIO::OnFileCanWriteWithoutBlocking(int fd) {
+  NOTREACHED();
+}
+
+}  // namespace base
@@ -0,0 +1,137 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/async_file_io.h"
+
+#include <string>
+
+#if defined(OS_LINUX)
+#include <fcntl.h>
+#endif
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/message_loop.h"
+#include "base/platform_file.h"
+#include "base/scoped_temp_dir.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+class AsyncFileIOTest : public testing::Test {
+ public:
+  AsyncFileIOTest()
+      : message_loop_(MessageLoop::TYPE_IO),
+        file_thread_("AsyncFileIOTestFileThread"),
+        file_(kInvalidPlatformFileValue),
+        error_(PLATFORM_FILE_OK),
+        bytes_(-1) {}
+
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(dir_.CreateUniqueTempDir());
+    ASSERT_TRUE(file_thread_.Start());
+  }
+
+  virtual void TearDown() OVERRIDE {
+    if (file_ != kInvalidPlatformFileValue)
+      ClosePlatformFile(file_);
+  }
+
+  void DidRead(PlatformFileError error, const char* data, int bytes_read) {
+    error_ = error;
+    bytes_ = bytes_read;
+    buffer_.assign(data, bytes_read > 0 ? bytes_read : 0);
+    MessageLoop::current()->Quit();
+  }
+
+  void DidWrite(PlatformFileError error, int bytes_written) {
+    error_ = error;
+    bytes_ = bytes_written;
+    MessageLoop::current()->Quit();
+  }
+
+ protected:
+  void OpenFile(int flags) {
+    flags_ = PLATFORM_FILE_CREATE_ALWAYS | PLATFORM_FILE_READ |
+             PLATFORM_FILE_WRITE | flags;
+    file_ = CreatePlatformFile(dir_.path().AppendASCII("test"), flags_, NULL,
+                               NULL);
+    ASSERT_NE(kInvalidPlatformFileValue, file_);
+  }
+
+  // Writes |data| at |offset| and reads it back through |io|.
+  void WriteAndRead(AsyncFileIO* io, int64 offset, const std::string& data) {
+    ASSERT_TRUE(io->Write(offset, data.data(), data.size(),
+                          Bind(&AsyncFileIOTest::DidWrite, Unretained(this))));
+    MessageLoop::current()->Run();
+    EXPECT_EQ(PLATFORM_FILE_OK, error_);
+    EXPECT_EQ(static_cast<int>(data.size()), bytes_);
+
+    ASSERT_TRUE(io->Read(offset, data.size(),
+                         Bind(&AsyncFileIOTest::DidRead, Unretained(this))));
+    MessageLoop::current()->Run();
+    EXPECT_EQ(PLATFORM_FILE_OK, error_);
+    EXPECT_EQ(data, buffer_);
+  }
+
+  MessageLoop message_loop_;
+  Thread file_thread_;
+  ScopedTempDir dir_;
+  PlatformFile file_;
+  int flags_;
+
+  PlatformFileError error_;
+  int bytes_;
+  std::string buffer_;
+};
+
+TEST_F(AsyncFileIOTest, WorkerThreadFallback) {
+  OpenFile(0);
+  AsyncFileIO io(file_, flags_, file_thread_.message_loop_proxy());
+  // Without O_DIRECT on Linux, or PLATFORM_FILE_ASYNC on Windows, every
+  // request goes to the file thread.
+  EXPECT_FALSE(io.is_native());
+  WriteAndRead(&io, 0, "hello, world");
+  WriteAndRead(&io, 7, "there");
+
+  // Reading past the end succeeds with no data.
+  ASSERT_TRUE(io.Read(1000, 10,
+                      Bind(&AsyncFileIOTest::DidRead, Unretained(this))));
+  MessageLoop::current()->Run();
+  EXPECT_EQ(PLATFORM_FILE_OK, error_);
+  EXPECT_EQ(0, bytes_);
+}
+
+#if defined(OS_WIN)
+TEST_F(AsyncFileIOTest, Overlapped) {
+  OpenFile(PLATFORM_FILE_ASYNC);
+  AsyncFileIO io(file_, flags_, file_thread_.message_loop_proxy());
+  EXPECT_TRUE(io.is_native());
+  WriteAndRead(&io, 0, "hello, world");
+  WriteAndRead(&io, 1 << 20, "far away");
+}
+#endif
+
+#if defined(OS_LINUX)
+TEST_F(AsyncFileIOTest, DirectIO) {
+  OpenFile(0);
+  // Not every file system supports O_DIRECT; tmpfs does not.
+  int status_flags = fcntl(file_, F_GETFL);
+  if (fcntl(file_, F_SETFL, status_flags | O_DIRECT) != 0) {
+    LOG(WARNING) << "O_DIRECT is not supported here; skipping";
+    return;
+  }
+  AsyncFileIO io(file_, flags_, file_thread_.message_loop_proxy());
+  EXPECT_TRUE(io.is_native());
+
+  std::string block(AsyncFileIO::kDirectIOAlignment * 2, 'a');
+  for (size_t i = 0; i < block.size(); ++i)
+    block[i] = static_cast<char>('a' + i % 26);
+  WriteAndRead(&io, 0, block);
+  WriteAndRead(&io, AsyncFileIO::kDirectIOAlignment * 8, block);
+}
+#endif
+
+}  // namespace base
@@ -0,0 +1,165 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/async_file_io.h"
+
+#include <windows.h>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop_proxy.h"
+#include "base/task_runner.h"
+
+namespace base {
+
+namespace {
+
+// Runs a callback for a request that finished, or failed, without going
+// through the completion port.
+void RunReadCallback(const FileUtilProxy::ReadCallback& callback,
+                     PlatformFileError error,
+                     int bytes_read) {
+  if (!callback.is_null())
+    callback.Run(error, NULL, bytes_read);
+}
+
+void RunWriteCallback(const FileUtilProxy::WriteCallback& callback,
+                      PlatformFileError error,
+                      int bytes_written) {
+  if (!callback.is_null())
+    callback.Run(error, bytes_written);
+}
+
+}  // namespace
+
+struct AsyncFileIO::Operation {
+  Operation() : size(0) {
+    memset(&context, 0, sizeof(context));
+  }
+
+  // Must come first: the completion port hands back a pointer to it.
+  MessageLoopForIO::IOContext context;
+  scoped_array<char> buffer;
+  int size;
+  FileUtilProxy::ReadCallback read_callback;
+  FileUtilProxy::WriteCallback write_callback;
+};
+
+AsyncFileIO::AsyncFileIO(PlatformFile file,
+                         int file_flags,
+                         TaskRunner* fallback_task_runner)
+    : file_(file),
+      fallback_task_runner_(fallback_task_runner),
+      native_((file_flags & PLATFORM_FILE_ASYNC) != 0),
+      destroying_(false) {
+  // A handle can only be bound to one completion port, and only if it was
+  // opened with FILE_FLAG_OVERLAPPED, which PLATFORM_FILE_ASYNC selects.
+  if (native_)
+    MessageLoopForIO::current()->RegisterIOHandler(file_, this);
+}
+
+AsyncFileIO::~AsyncFileIO() {
+  DCHECK(CalledOnValidThread());
+  if (pending_.empty())
+    return;
+  destroying_ = true;
+  CancelIo(file_);
+  // The kernel owns the buffers until it reports each request done, even if
+  // it was cancelled.
+  while (!pending_.empty())
+    MessageLoopForIO::current()->WaitForIOCompletion(INFINITE, this);
+}
+
+bool AsyncFileIO::StartNativeRead(int64 offset,
+                                  int bytes_to_read,
+                                  const FileUtilProxy::ReadCallback& callback) {
+  if (bytes_to_read == 0)
+    return false;
+  scoped_ptr<Operation> operation(new Operation);
+  operation->context.handler = this;
+  operation->context.overlapped.Offset = static_cast<DWORD>(offset);
+  operation->context.overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+  operation->buffer.reset(new char[bytes_to_read]);
+  operation->size = bytes_to_read;
+  operation->read_callback = callback;
+
+  if (!ReadFile(file_, operation->buffer.get(), bytes_to_read, NULL,
+                &operation->context.overlapped)) {
+    DWORD error = GetLastError();
+    if (error == ERROR_HANDLE_EOF) {
+      // Reading past the end succeeds with no data, as it does elsewhere.
+      MessageLoopProxy::current()->PostTask(
+          FROM_HERE,
+          Bind(&RunReadCallback, callback, PLATFORM_FILE_OK, 0));
+      return true;
+    }
+    if (error != ERROR_IO_PENDING) {
+      DLOG(WARNING) << "ReadFile failed: " << error;
+      MessageLoopProxy::current()->PostTask(
+          FROM_HERE,
+          Bind(&RunReadCallback, callback, PLATFORM_FILE_ERROR_FAILED, -1));
+      return true;
+    }
+  }
+  // Even a request that completed at once is reported through the port.
+  pending_.insert(operation.release());
+  return true;
+}
+
+bool AsyncFileIO::StartNativeWrite(
+    int64 offset,
+    const char* buffer,
+    int bytes_to_write,
+    const FileUtilProxy::WriteCallback& callback) {
+  scoped_ptr<Operation> operation(new Operation);
+  operation->context.handler = this;
+  operation->context.overlapped.Offset = static_cast<DWORD>(offset);
+  operation->context.overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+  operation->buffer.reset(new char[bytes_to_write]);
+  memcpy(operation->buffer.get(), buffer, bytes_to_write);
+  operation->size = bytes_to_write;
+  operation->write_callback = callback;
+
+  if (!WriteFile(file_, operation->buffer.get(), bytes_to_write, NULL,
+                 &operation->context.overlapped)) {
+    DWORD error = GetLastError();
+    if (error != ERROR_IO_PENDING) {
+      DLOG(WARNING) << "WriteFile failed: " << error;
+      MessageLoopProxy::current()->PostTask(
+          FROM_HERE,
+          Bind(&RunWriteCallback, callback, PLATFORM_FILE_ERROR_FAILED, -1));
+      return true;
+    }
+  }
+  pending_.insert(operation.release());
+  return true;
+}
+
+void AsyncFileIO::OnIOCompleted(MessageLoopForIO::IOContext* context,
+                                DWORD bytes_transfered,
+                                DWORD error) {
+  DCHECK(CalledOnValidThread());
+  scoped_ptr<Operation> operation(reinterpret_cast<Operation*>(context));
+  DCHECK(pending_.count(operation.get()));
+  pending_.erase(operation.get());
+  if (destroying_)
+    return;
+
+  PlatformFileError file_error = PLATFORM_FILE_OK;
+  int result = static_cast<int>(bytes_transfered);
+  if (error != ERROR_SUCCESS && error != ERROR_HANDLE_EOF) {
+    file_error = PLATFORM_FILE_ERROR_FAILED;
+    result = -1;
+  }
+  // The callback may delete |this|; |operation| is ours now, so that's fine.
+  if (!operation->read_callback.is_null()) {
+    operation->read_callback.Run(file_error, operation->buffer.get(), result);
+  } else if (!operation->write_callback.is_null()) {
+    operation->write_callback.Run(file_error, result);
+  }
+}
+
+}  // namespace base
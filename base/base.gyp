@@ -134,6 +134,7 @@
         'android/jni_android_unittest.cc',
         'android/path_utils_unittest.cc',
         'android/scoped_java_ref_unittest.cc',
+        'async_file_io_unittest.cc',
         'at_exit_unittest.cc',
         'atomicops_unittest.cc',
         'base64_unittest.cc',
@@ -146,11 +147,13 @@
         'callback_unittest.nc',
         'cancelable_callback_unittest.cc',
         'command_line_unittest.cc',
+        'compact_value_unittest.cc',
         'cpu_unittest.cc',
         'debug/leak_tracker_unittest.cc',
         'debug/stack_trace_unittest.cc',
         'debug/trace_event_unittest.cc',
         'debug/trace_event_win_unittest.cc',
+        'debug/trace_ring_buffer_unittest.cc',
         'dir_reader_posix_unittest.cc',
         'environment_unittest.cc',
         'file_descriptor_shuffle_unittest.cc',
@@ -158,6 +161,8 @@
         'file_util_proxy_unittest.cc',
         'file_util_unittest.cc',
         'file_version_info_unittest.cc',
+        'files/batch_file_path_watcher_unittest.cc',
+        'flat_hash_map_unittest.cc',
         'gmock_unittest.cc',
         'id_map_unittest.cc',
         'i18n/break_iterator_unittest.cc',
@@ -210,12 +215,14 @@
         'process_util_unittest.cc',
         'process_util_unittest_mac.h',
         'process_util_unittest_mac.mm',
+        'profiler/thread_data_arena_unittest.cc',
         'profiler/tracked_time_unittest.cc',
         'property_bag_unittest.cc',
         'rand_util_unittest.cc',
         'scoped_native_library_unittest.cc',
         'scoped_temp_dir_unittest.cc',
         'sha1_unittest.cc',
+        'shared_memory_ring_unittest.cc',
         'shared_memory_unittest.cc',
         'stack_container_unittest.cc',
         'string16_unittest.cc',
@@ -255,6 +262,7 @@
         'time_unittest.cc',
         'time_win_unittest.cc',
         'timer_unittest.cc',
+        'timer_wheel_unittest.cc',
         'tools_sanity_unittest.cc',
         'tracked_objects_unittest.cc',
         'tuple_unittest.cc',
@@ -500,6 +508,26 @@
         },
       ],
     },
+    {
+      'target_name': 'base_perftests',
+      'type': 'executable',
+      'dependencies': [
+        'base',
+        'test_support_base',
+        'test_support_perf',
+        '../testing/gtest.gyp:gtest',
+      ],
+      'sources': [
+        'flat_hash_map_perftest.cc',
+        'json/json_reader_perftest.cc',
+        'metrics/histogram_perftest.cc',
+        'test/sequenced_worker_pool_owner.cc',
+        'test/sequenced_worker_pool_owner.h',
+        'threading/sequenced_worker_pool_perftest.cc',
+        'timer_wheel_perftest.cc',
+        'utf_string_conversions_perftest.cc',
+      ],
+    },
     {
       'target_name': 'test_support_perf',
       'type': 'static_library',
@@ -0,0 +1,569 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/compact_value.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <new>
+
+#include "base/logging.h"
+
+namespace base {
+
+namespace {
+
+// |inline_length_| of a string or binary value kept in |string_|.
+const uint8 kNotInline = 0xff;
+
+}  // namespace
+
+// A growable array kept in a single allocation, directly after its header.
+// Elements are moved around with memmove() and realloc() rather than being
+// copied, which is safe because neither CompactValue nor Entry ever points
+// into itself, and which means growing a list of dictionaries doesn't deep
+// copy every dictionary.
+template <typename T>
+struct CompactValue::Array {
+  size_t size;
+  size_t capacity;
+
+  T* items() { return reinterpret_cast<T*>(this + 1); }
+  const T* items() const { return reinterpret_cast<const T*>(this + 1); }
+
+  static Array* Create(size_t capacity) {
+    Array* array = static_cast<Array*>(malloc(AllocationSize(capacity)));
+    CHECK(array);
+    array->size = 0;
+    array->capacity = capacity;
+    return array;
+  }
+
+  static Array* Copy(const Array* other) {
+    Array* array = Create(other->size);
+    for (size_t i = 0; i < other->size; ++i)
+      new (array->items() + i) T(other->items()[i]);
+    array->size = other->size;
+    return array;
+  }
+
+  static void Destroy(Array* array) {
+    for (size_t i = 0; i < array->size; ++i)
+      array->items()[i].~T();
+    free(array);
+  }
+
+  // Inserts a default-constructed element at |index| and returns it.
+  // |*array| may move.
+  static T* Insert(Array** array, size_t index) {
+    Array* a = *array;
+    DCHECK_LE(index, a->size);
+    if (a->size == a->capacity) {
+      size_t capacity = a->capacity ? a->capacity * 2 : 4;
+      a = static_cast<Array*>(realloc(a, AllocationSize(capacity)));
+      CHECK(a);
+      a->capacity = capacity;
+      *array = a;
+    }
+    T* item = a->items() + index;
+    memmove(item + 1, item, (a->size - index) * sizeof(T));
+    new (item) T();
+    ++a->size;
+    return item;
+  }
+
+  static void Erase(Array* array, size_t index) {
+    DCHECK_LT(index, array->size);
+    T* item = array->items() + index;
+    item->~T();
+    memmove(item, item + 1, (array->size - index - 1) * sizeof(T));
+    --array->size;
+  }
+
+  static size_t AllocationSize(size_t capacity) {
+    return sizeof(Array) + capacity * sizeof(T);
+  }
+};
+
+struct CompactValue::Entry {
+  CompactValue key;
+  CompactValue value;
+};
+
+CompactValue::CompactValue()
+    : type_(Value::TYPE_NULL),
+      inline_length_(0) {
+  double_value_ = 0;
+}
+
+CompactValue::CompactValue(bool value)
+    : type_(Value::TYPE_BOOLEAN),
+      inline_length_(0) {
+  double_value_ = 0;
+  bool_value_ = value;
+}
+
+CompactValue::CompactValue(int value)
+    : type_(Value::TYPE_INTEGER),
+      inline_length_(0) {
+  double_value_ = 0;
+  int_value_ = value;
+}
+
+CompactValue::CompactValue(double value)
+    : type_(Value::TYPE_DOUBLE),
+      inline_length_(0) {
+  double_value_ = value;
+}
+
+CompactValue::CompactValue(const char* value)
+    : type_(Value::TYPE_NULL),
+      inline_length_(0) {
+  SetString(value, Value::TYPE_STRING);
+}
+
+CompactValue::CompactValue(const StringPiece& value)
+    : type_(Value::TYPE_NULL),
+      inline_length_(0) {
+  SetString(value, Value::TYPE_STRING);
+}
+
+CompactValue::CompactValue(const Value& value)
+    : type_(Value::TYPE_NULL),
+      inline_length_(0) {
+  double_value_ = 0;
+  switch (value.GetType()) {
+    case Value::TYPE_NULL:
+      break;
+    case Value::TYPE_BOOLEAN:
+      type_ = Value::TYPE_BOOLEAN;
+      value.GetAsBoolean(&bool_value_);
+      break;
+    case Value::TYPE_INTEGER:
+      type_ = Value::TYPE_INTEGER;
+      value.GetAsInteger(&int_value_);
+      break;
+    case Value::TYPE_DOUBLE:
+      type_ = Value::TYPE_DOUBLE;
+      value.GetAsDouble(&double_value_);
+      break;
+    case Value::TYPE_STRING: {
+      std::string string_value;
+      value.GetAsString(&string_value);
+      SetString(string_value, Value::TYPE_STRING);
+      break;
+    }
+    case Value::TYPE_BINARY: {
+      const BinaryValue& binary = static_cast<const BinaryValue&>(value);
+      SetString(StringPiece(binary.GetBuffer(), binary.GetSize()),
+                Value::TYPE_BINARY);
+      break;
+    }
+    case Value::TYPE_DICTIONARY: {
+      const DictionaryValue& dictionary =
+          static_cast<const DictionaryValue&>(value);
+      type_ = Value::TYPE_DICTIONARY;
+      dictionary_ = DictionaryArray::Create(dictionary.size());
+      // DictionaryValue iterates in key order, so every entry is appended.
+      for (DictionaryValue::Iterator it(dictionary); it.HasNext();
+           it.Advance()) {
+        CompactValue converted(it.value());
+        SetKey(it.key())->Swap(&converted);
+      }
+      break;
+    }
+    case Value::TYPE_LIST: {
+      const ListValue& list = static_cast<const ListValue&>(value);
+      type_ = Value::TYPE_LIST;
+      list_ = ListArray::Create(list.GetSize());
+      for (ListValue::const_iterator it = list.begin(); it != list.end();
+           ++it) {
+        CompactValue converted(**it);
+        Append()->Swap(&converted);
+      }
+      break;
+    }
+    default:
+      NOTREACHED();
+  }
+}
+
+CompactValue::CompactValue(const CompactValue& other)
+    : type_(Value::TYPE_NULL),
+      inline_length_(0) {
+  double_value_ = 0;
+  *this = other;
+}
+
+CompactValue::~CompactValue() {
+  Clear();
+}
+
+CompactValue& CompactValue::operator=(const CompactValue& other) {
+  if (this == &other)
+    return *this;
+  Clear();
+  switch (other.type_) {
+    case Value::TYPE_STRING:
+    case Value::TYPE_BINARY: {
+      StringPiece value;
+      if (other.inline_length_ == kNotInline)
+        value = *other.string_;
+      else
+        value.set(other.inline_string_, other.inline_length_);
+      SetString(value, other.type());
+      break;
+    }
+    case Value::TYPE_DICTIONARY:
+      dictionary_ = DictionaryArray::Copy(other.dictionary_);
+      type_ = other.type_;
+      break;
+    case Value::TYPE_LIST:
+      list_ = ListArray::Copy(other.list_);
+      type_ = other.type_;
+      break;
+    default:
+      // Fundamental types only need the union copied.
+      memcpy(inline_string_, other.inline_string_, sizeof(inline_string_));
+      type_ = other.type_;
+      inline_length_ = other.inline_length_;
+      break;
+  }
+  return *this;
+}
+
+// static
+CompactValue CompactValue::CreateList() {
+  CompactValue value;
+  value.type_ = Value::TYPE_LIST;
+  value.list_ = ListArray::Create(0);
+  return value;
+}
+
+// static
+CompactValue CompactValue::CreateDictionary() {
+  CompactValue value;
+  value.type_ = Value::TYPE_DICTIONARY;
+  value.dictionary_ = DictionaryArray::Create(0);
+  return value;
+}
+
+// static
+CompactValue CompactValue::CreateBinary(const char* buffer, size_t size) {
+  CompactValue value;
+  value.SetString(StringPiece(buffer, size), Value::TYPE_BINARY);
+  return value;
+}
+
+bool CompactValue::GetAsBoolean(bool* out_value) const {
+  if (type_ != Value::TYPE_BOOLEAN)
+    return false;
+  *out_value = bool_value_;
+  return true;
+}
+
+bool CompactValue::GetAsInteger(int* out_value) const {
+  if (type_ != Value::TYPE_INTEGER)
+    return false;
+  *out_value = int_value_;
+  return true;
+}
+
+bool CompactValue::GetAsDouble(double* out_value) const {
+  if (type_ == Value::TYPE_DOUBLE) {
+    *out_value = double_value_;
+    return true;
+  }
+  if (type_ == Value::TYPE_INTEGER) {
+    *out_value = int_value_;
+    return true;
+  }
+  return false;
+}
+
+bool CompactValue::GetAsString(StringPiece* out_value) const {
+  if (type_ != Value::TYPE_STRING)
+    return false;
+  if (inline_length_ == kNotInline)
+    *out_value = *string_;
+  else
+    out_value->set(inline_string_, inline_length_);
+  return true;
+}
+
+bool CompactValue::GetAsString(std::string* out_value) const {
+  StringPiece value;
+  if (!GetAsString(&value))
+    return false;
+  value.CopyToString(out_value);
+  return true;
+}
+
+bool CompactValue::GetAsBinary(StringPiece* out_value) const {
+  if (type_ != Value::TYPE_BINARY)
+    return false;
+  if (inline_length_ == kNotInline)
+    *out_value = *string_;
+  else
+    out_value->set(inline_string_, inline_length_);
+  return true;
+}
+
+size_t CompactValue::size() const {
+  if (type_ == Value::TYPE_LIST)
+    return list_->size;
+  if (type_ == Value::TYPE_DICTIONARY)
+    return dictionary_->size;
+  return 0;
+}
+
+const CompactValue* CompactValue::GetItem(size_t index) const {
+  DCHECK_EQ(Value::TYPE_LIST, type_);
+  if (index >= list_->size)
+    return NULL;
+  return list_->items() + index;
+}
+
+CompactValue* CompactValue::GetItem(size_t index) {
+  return const_cast<CompactValue*>(
+      static_cast<const CompactValue*>(this)->GetItem(index));
+}
+
+CompactValue* CompactValue::Append() {
+  DCHECK_EQ(Value::TYPE_LIST, type_);
+  return ListArray::Insert(&list_, list_->size);
+}
+
+void CompactValue::Append(const CompactValue& value) {
+  *Append() = value;
+}
+
+const CompactValue* CompactValue::FindKey(const StringPiece& key) const {
+  DCHECK_EQ(Value::TYPE_DICTIONARY, type_);
+  size_t index = LowerBound(key);
+  if (index == dictionary_->size || GetKeyAt(index) != key)
+    return NULL;
+  return &dictionary_->items()[index].value;
+}
+
+CompactValue* CompactValue::FindKey(const StringPiece& key) {
+  return const_cast<CompactValue*>(
+      static_cast<const CompactValue*>(this)->FindKey(key));
+}
+
+StringPiece CompactValue::GetKeyAt(size_t index) const {
+  DCHECK_EQ(Value::TYPE_DICTIONARY, type_);
+  DCHECK_LT(index, dictionary_->size);
+  StringPiece key;
+  dictionary_->items()[index].key.GetAsString(&key);
+  return key;
+}
+
+const CompactValue* CompactValue::GetValueAt(size_t index) const {
+  DCHECK_EQ(Value::TYPE_DICTIONARY, type_);
+  if (index >= dictionary_->size)
+    return NULL;
+  return &dictionary_->items()[index].value;
+}
+
+CompactValue* CompactValue::SetKey(const StringPiece& key) {
+  DCHECK_EQ(Value::TYPE_DICTIONARY, type_);
+  // Check the end first, so that keys added in order don't need a search.
+  size_t size = dictionary_->size;
+  size_t index = size;
+  if (size && GetKeyAt(size - 1) >= key) {
+    index = LowerBound(key);
+    if (GetKeyAt(index) == key)
+      return &dictionary_->items()[index].value;
+  }
+  Entry* entry = DictionaryArray::Insert(&dictionary_, index);
+  entry->key.SetString(key, Value::TYPE_STRING);
+  return &entry->value;
+}
+
+void CompactValue::SetKey(const StringPiece& key, const CompactValue& value) {
+  *SetKey(key) = value;
+}
+
+bool CompactValue::RemoveKey(const StringPiece& key) {
+  DCHECK_EQ(Value::TYPE_DICTIONARY, type_);
+  size_t index = LowerBound(key);
+  if (index == dictionary_->size || GetKeyAt(index) != key)
+    return false;
+  DictionaryArray::Erase(dictionary_, index);
+  return true;
+}
+
+Value* CompactValue::ToValue() const {
+  switch (type_) {
+    case Value::TYPE_NULL:
+      return Value::CreateNullValue();
+    case Value::TYPE_BOOLEAN:
+      return Value::CreateBooleanValue(bool_value_);
+    case Value::TYPE_INTEGER:
+      return Value::CreateIntegerValue(int_value_);
+    case Value::TYPE_DOUBLE:
+      return Value::CreateDoubleValue(double_value_);
+    case Value::TYPE_STRING: {
+      StringPiece value;
+      GetAsString(&value);
+      return Value::CreateStringValue(value.as_string());
+    }
+    case Value::TYPE_BINARY: {
+      StringPiece value;
+      GetAsBinary(&value);
+      return BinaryValue::CreateWithCopiedBuffer(value.data(), value.size());
+    }
+    case Value::TYPE_DICTIONARY: {
+      DictionaryValue* dictionary = new DictionaryValue;
+      for (size_t i = 0; i < dictionary_->size; ++i) {
+        dictionary->SetWithoutPathExpansion(GetKeyAt(i).as_string(),
+                                            GetValueAt(i)->ToValue());
+      }
+      return dictionary;
+    }
+    case Value::TYPE_LIST: {
+      ListValue* list = new ListValue;
+      for (size_t i = 0; i < list_->size; ++i)
+        list->Append(list_->items()[i].ToValue());
+      return list;
+    }
+    default:
+      NOTREACHED();
+      return NULL;
+  }
+}
+
+bool CompactValue::Equals(const CompactValue& other) const {
+  if (type_ != other.type_)
+    return false;
+  switch (type_) {
+    case Value::TYPE_NULL:
+      return true;
+    case Value::TYPE_BOOLEAN:
+      return bool_value_ == other.bool_value_;
+    case Value::TYPE_INTEGER:
+      return int_value_ == other.int_value_;
+    case Value::TYPE_DOUBLE:
+      return double_value_ == other.double_value_;
+    case Value::TYPE_STRING:
+    case Value::TYPE_BINARY: {
+      // GetAsBinary() would do for both, but checks the type.
+      StringPiece value;
+      StringPiece other_value;
+      if (type_ == Value::TYPE_STRING) {
+        GetAsString(&value);
+        other.GetAsString(&other_value);
+      } else {
+        GetAsBinary(&value);
+        other.GetAsBinary(&other_value);
+      }
+      return value == other_value;
+    }
+    case Value::TYPE_DICTIONARY:
+      if (dictionary_->size != other.dictionary_->size)
+        return false;
+      for (size_t i = 0; i < dictionary_->size; ++i) {
+        if (GetKeyAt(i) != other.GetKeyAt(i) ||
+            !GetValueAt(i)->Equals(*other.GetValueAt(i))) {
+          return false;
+        }
+      }
+      return true;
+    case Value::TYPE_LIST:
+      if (list_->size != other.list_->size)
+        return false;
+      for (size_t i = 0; i < list_->size; ++i) {
+        if (!list_->items()[i].Equals(other.list_->items()[i]))
+          return false;
+      }
+      return true;
+    default:
+      NOTREACHED();
+      return false;
+  }
+}
+
+void CompactValue::Swap(CompactValue* other) {
+  // Values never point into themselves, so swapping the bytes is enough.
+  char temp[sizeof(CompactValue)];
+  memcpy(temp, this, sizeof(CompactValue));
+  memcpy(this, other, sizeof(CompactValue));
+  memcpy(other, temp, sizeof(CompactValue));
+}
+
+size_t CompactValue::EstimateHeapUsage() const {
+  switch (type_) {
+    case Value::TYPE_STRING:
+    case Value::TYPE_BINARY:
+      if (inline_length_ == kNotInline)
+        return sizeof(std::string) + string_->capacity();
+      return 0;
+    case Value::TYPE_DICTIONARY: {
+      size_t usage = DictionaryArray::AllocationSize(dictionary_->capacity);
+      for (size_t i = 0; i < dictionary_->size; ++i) {
+        usage += dictionary_->items()[i].key.EstimateHeapUsage() +
+            dictionary_->items()[i].value.EstimateHeapUsage();
+      }
+      return usage;
+    }
+    case Value::TYPE_LIST: {
+      size_t usage = ListArray::AllocationSize(list_->capacity);
+      for (size_t i = 0; i < list_->size; ++i)
+        usage += list_->items()[i].EstimateHeapUsage();
+      return usage;
+    }
+    default:
+      return 0;
+  }
+}
+
+void CompactValue::Clear() {
+  switch (type_) {
+    case Value::TYPE_STRING:
+    case Value::TYPE_BINARY:
+      if (inline_length_ == kNotInline)
+        delete string_;
+      break;
+    case Value::TYPE_DICTIONARY:
+      DictionaryArray::Destroy(dictionary_);
+      break;
+    case Value::TYPE_LIST:
+      ListArray::Destroy(list_);
+      break;
+    default:
+      break;
+  }
+  type_ = Value::TYPE_NULL;
+  inline_length_ = 0;
+  double_value_ = 0;
+}
+
+void CompactValue::SetString(const StringPiece& value, Value::Type type) {
+  DCHECK_EQ(Value::TYPE_NULL, type_);
+  type_ = type;
+  if (value.size() <= kInlineStringCapacity) {
+    memcpy(inline_string_, value.data(), value.size());
+    inline_length_ = static_cast<uint8>(value.size());
+  } else {
+    string_ = new std::string(value.data(), value.size());
+    inline_length_ = kNotInline;
+  }
+}
+
+size_t CompactValue::LowerBound(const StringPiece& key) const {
+  size_t begin = 0;
+  size_t end = dictionary_->size;
+  while (begin < end) {
+    size_t middle = begin + (end - begin) / 2;
+    if (GetKeyAt(middle) < key)
+      begin = middle + 1;
+    else
+      end = middle;
+  }
+  return begin;
+}
+
+}  // namespace base
@@ -0,0 +1,149 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// CompactValue holds the same data as a tree of base::Values, laid out for
+// trees with very many small nodes, such as pref and sync payloads.  Where a
+// Value tree spends a heap allocation (and a vtable pointer) on every node,
+// and a std::map node on every dictionary entry, a CompactValue is a tagged
+// union that is stored inline in its parent:
+//
+// - Booleans, integers, doubles and strings of up to kInlineStringCapacity
+//   bytes need no allocation at all.
+// - A list or dictionary is a single allocation holding its children.
+//   Dictionary entries are kept sorted by key, so lookups are binary
+//   searches, and building a dictionary from keys that arrive in order (as
+//   JSONWriter writes them) appends each entry in constant time.
+//
+// CompactValue is a value type: copying one deep copies it.  It does not do
+// the "path" expansion that DictionaryValue does; keys are used as given.
+// Code can move over to it one piece at a time by converting at the edges
+// with the CompactValue(const Value&) constructor and ToValue(), or by
+// parsing JSON directly with JSONReader::ReadToCompactValue().
+
+#ifndef BASE_COMPACT_VALUE_H_
+#define BASE_COMPACT_VALUE_H_
+#pragma once
+
+#include <string>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/string_piece.h"
+#include "base/values.h"
+
+namespace base {
+
+class BASE_EXPORT CompactValue {
+ public:
+  enum { kInlineStringCapacity = 16 };
+
+  // Creates a null value.
+  CompactValue();
+  explicit CompactValue(bool value);
+  explicit CompactValue(int value);
+  explicit CompactValue(double value);
+  explicit CompactValue(const char* value);
+  explicit CompactValue(const StringPiece& value);
+
+  // Deep copies |value|, whatever its type.
+  explicit CompactValue(const Value& value);
+
+  CompactValue(const CompactValue& other);
+  ~CompactValue();
+  CompactValue& operator=(const CompactValue& other);
+
+  // Create empty containers.
+  static CompactValue CreateList();
+  static CompactValue CreateDictionary();
+
+  static CompactValue CreateBinary(const char* buffer, size_t size);
+
+  Value::Type type() const { return static_cast<Value::Type>(type_); }
+  bool IsType(Value::Type type) const { return type == type_; }
+
+  // As for Value: if this value can be converted to the given type, it is
+  // returned through |out_value| and true is returned.  Strings and binary
+  // data are returned as pieces of this value, so they are only valid until
+  // it changes.
+  bool GetAsBoolean(bool* out_value) const;
+  bool GetAsInteger(int* out_value) const;
+  bool GetAsDouble(double* out_value) const;
+  bool GetAsString(StringPiece* out_value) const;
+  bool GetAsString(std::string* out_value) const;
+  bool GetAsBinary(StringPiece* out_value) const;
+
+  // Returns the number of items in a list or entries in a dictionary, or 0
+  // for any other type.
+  size_t size() const;
+  bool empty() const { return size() == 0; }
+
+  // List access.  The pointers returned are only valid until the list is
+  // next modified.
+  const CompactValue* GetItem(size_t index) const;
+  CompactValue* GetItem(size_t index);
+
+  // Appends a null value to a list and returns it, to be filled in.
+  CompactValue* Append();
+  void Append(const CompactValue& value);
+
+  // Dictionary access, by key or by index in key order.  The pointers
+  // returned are only valid until the dictionary is next modified.
+  const CompactValue* FindKey(const StringPiece& key) const;
+  CompactValue* FindKey(const StringPiece& key);
+  StringPiece GetKeyAt(size_t index) const;
+  const CompactValue* GetValueAt(size_t index) const;
+
+  // Returns the value for |key|, adding a null one if there isn't one yet.
+  CompactValue* SetKey(const StringPiece& key);
+  void SetKey(const StringPiece& key, const CompactValue& value);
+
+  // Returns false if there was no entry for |key|.
+  bool RemoveKey(const StringPiece& key);
+
+  // Converts to a new Value tree, owned by the caller.
+  Value* ToValue() const;
+
+  // Compares contents, as Value::Equals() does.
+  bool Equals(const CompactValue& other) const;
+
+  void Swap(CompactValue* other);
+
+  // Approximate number of heap bytes owned by this value and its children.
+  size_t EstimateHeapUsage() const;
+
+ private:
+  template <typename T> struct Array;
+  struct Entry;
+
+  typedef Array<CompactValue> ListArray;
+  typedef Array<Entry> DictionaryArray;
+
+  // Frees whatever this value owns and makes it null.
+  void Clear();
+
+  // Sets this null value to a copy of |value|.
+  void SetString(const StringPiece& value, Value::Type type);
+
+  // Returns the index of the first entry whose key is not less than |key|.
+  size_t LowerBound(const StringPiece& key) const;
+
+  // The member in use is chosen by |type_|, except for strings and binary
+  // data, which are in |string_| when |inline_length_| is a sentinel that no
+  // inline string can have.
+  union {
+    bool bool_value_;
+    int int_value_;
+    double double_value_;
+    char inline_string_[kInlineStringCapacity];
+    std::string* string_;
+    ListArray* list_;
+    DictionaryArray* dictionary_;
+  };
+  uint8 type_;
+  uint8 inline_length_;
+};
+
+}  // namespace base
+
+#endif  // BASE_COMPACT_VALUE_H_
@@ -0,0 +1,171 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/compact_value.h"
+
+#include <string>
+
+#include "base/json/json_reader.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/stringprintf.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+TEST(CompactValueTest, FundamentalValues) {
+  CompactValue null_value;
+  EXPECT_TRUE(null_value.IsType(Value::TYPE_NULL));
+
+  bool bool_value = false;
+  int int_value = 0;
+  double double_value = 0;
+  EXPECT_TRUE(CompactValue(true).GetAsBoolean(&bool_value));
+  EXPECT_TRUE(bool_value);
+  EXPECT_FALSE(CompactValue(true).GetAsInteger(&int_value));
+
+  EXPECT_TRUE(CompactValue(42).GetAsInteger(&int_value));
+  EXPECT_EQ(42, int_value);
+  // Integers convert to doubles, as for Value.
+  EXPECT_TRUE(CompactValue(42).GetAsDouble(&double_value));
+  EXPECT_EQ(42.0, double_value);
+
+  EXPECT_TRUE(CompactValue(0.5).GetAsDouble(&double_value));
+  EXPECT_EQ(0.5, double_value);
+  EXPECT_FALSE(CompactValue(0.5).GetAsInteger(&int_value));
+}
+
+TEST(CompactValueTest, Strings) {
+  std::string short_string("short");
+  std::string long_string(100, 'x');
+  CompactValue short_value(short_string);
+  CompactValue long_value(long_string);
+  CompactValue literal_value("literal");
+  EXPECT_TRUE(literal_value.IsType(Value::TYPE_STRING));
+
+  // Short strings are kept inline.
+  EXPECT_EQ(0u, short_value.EstimateHeapUsage());
+  EXPECT_LT(long_string.size(), long_value.EstimateHeapUsage());
+
+  std::string out;
+  EXPECT_TRUE(short_value.GetAsString(&out));
+  EXPECT_EQ(short_string, out);
+  EXPECT_TRUE(long_value.GetAsString(&out));
+  EXPECT_EQ(long_string, out);
+
+  // Copies are deep.
+  CompactValue copy(long_value);
+  long_value = short_value;
+  EXPECT_TRUE(copy.GetAsString(&out));
+  EXPECT_EQ(long_string, out);
+  EXPECT_TRUE(long_value.Equals(short_value));
+  EXPECT_FALSE(copy.Equals(short_value));
+
+  // A string with an embedded NUL fits exactly.
+  std::string binary_string("0123456789\0abcde", 16);
+  CompactValue binary(CompactValue::CreateBinary(binary_string.data(),
+                                                 binary_string.size()));
+  StringPiece piece;
+  EXPECT_FALSE(binary.GetAsString(&piece));
+  EXPECT_TRUE(binary.GetAsBinary(&piece));
+  EXPECT_EQ(binary_string, piece.as_string());
+  EXPECT_FALSE(binary.Equals(CompactValue(binary_string)));
+}
+
+TEST(CompactValueTest, List) {
+  CompactValue list(CompactValue::CreateList());
+  EXPECT_TRUE(list.empty());
+  const int kNumItems = 1000;
+  for (int i = 0; i < kNumItems; ++i) {
+    CompactValue* item = list.Append();
+    *item = CompactValue::CreateDictionary();
+    item->SetKey("index", CompactValue(i));
+    item->SetKey("name", CompactValue(StringPrintf("item number %d", i)));
+  }
+  ASSERT_EQ(static_cast<size_t>(kNumItems), list.size());
+  // Growing the list moves the dictionaries without copying them.
+  for (int i = 0; i < kNumItems; ++i) {
+    int index = -1;
+    std::string name;
+    ASSERT_TRUE(list.GetItem(i)->FindKey("index")->GetAsInteger(&index));
+    EXPECT_EQ(i, index);
+    ASSERT_TRUE(list.GetItem(i)->FindKey("name")->GetAsString(&name));
+    EXPECT_EQ(StringPrintf("item number %d", i), name);
+  }
+  EXPECT_FALSE(list.GetItem(kNumItems));
+}
+
+TEST(CompactValueTest, Dictionary) {
+  CompactValue dictionary(CompactValue::CreateDictionary());
+  // Out of order, with an overwrite.
+  dictionary.SetKey("b", CompactValue(2));
+  dictionary.SetKey("c", CompactValue(3));
+  dictionary.SetKey("a", CompactValue(1));
+  dictionary.SetKey("b", CompactValue("two"));
+  ASSERT_EQ(3u, dictionary.size());
+
+  EXPECT_EQ("a", dictionary.GetKeyAt(0));
+  EXPECT_EQ("b", dictionary.GetKeyAt(1));
+  EXPECT_EQ("c", dictionary.GetKeyAt(2));
+  std::string string_value;
+  EXPECT_TRUE(dictionary.FindKey("b")->GetAsString(&string_value));
+  EXPECT_EQ("two", string_value);
+  EXPECT_FALSE(dictionary.FindKey("d"));
+  EXPECT_FALSE(dictionary.FindKey(""));
+
+  // SetKey(key) returns the existing value.
+  EXPECT_TRUE(dictionary.SetKey("c")->IsType(Value::TYPE_INTEGER));
+  EXPECT_EQ(3u, dictionary.size());
+  EXPECT_TRUE(dictionary.SetKey("d")->IsType(Value::TYPE_NULL));
+  EXPECT_EQ(4u, dictionary.size());
+
+  EXPECT_TRUE(dictionary.RemoveKey("a"));
+  EXPECT_FALSE(dictionary.RemoveKey("a"));
+  ASSERT_EQ(3u, dictionary.size());
+  EXPECT_EQ("b", dictionary.GetKeyAt(0));
+  EXPECT_EQ("d", dictionary.GetKeyAt(2));
+}
+
+TEST(CompactValueTest, ConvertsToAndFromValue) {
+  scoped_ptr<Value> value(JSONReader::Read(
+      "{\"list\": [1, 2.5, true, null, \"a string that is not short\"],"
+      " \"nested\": {\"z\": {}, \"a\": []}, \"\": \"empty key\"}"));
+  ASSERT_TRUE(value.get());
+  DictionaryValue* dictionary = static_cast<DictionaryValue*>(value.get());
+  dictionary->SetWithoutPathExpansion(
+      "binary", BinaryValue::CreateWithCopiedBuffer("\x01\x02", 2));
+
+  CompactValue compact(*value);
+  EXPECT_TRUE(compact.IsType(Value::TYPE_DICTIONARY));
+  EXPECT_EQ(4u, compact.size());
+  ASSERT_TRUE(compact.FindKey("list"));
+  EXPECT_EQ(5u, compact.FindKey("list")->size());
+
+  scoped_ptr<Value> round_trip(compact.ToValue());
+  EXPECT_TRUE(value->Equals(round_trip.get()));
+}
+
+TEST(CompactValueTest, ReadFromJSON) {
+  const std::string json(
+      "{\"list\": [1, 2.5, true, null, \"with \\\"escapes\\\"\"],"
+      " \"nested\": {\"z\": {\"y\": [[], {}]}, \"a\": []}}");
+  CompactValue compact;
+  ASSERT_TRUE(JSONReader::ReadToCompactValue(json, JSON_PARSE_RFC, &compact));
+  scoped_ptr<Value> expected(JSONReader::Read(json));
+  scoped_ptr<Value> converted(compact.ToValue());
+  EXPECT_TRUE(expected->Equals(converted.get()));
+  EXPECT_TRUE(compact.Equals(CompactValue(*expected)));
+
+  // Invalid JSON leaves the value alone.
+  EXPECT_FALSE(JSONReader::ReadToCompactValue("[1, 2", JSON_PARSE_RFC,
+                                              &compact));
+  EXPECT_TRUE(compact.IsType(Value::TYPE_DICTIONARY));
+
+  CompactValue scalar;
+  ASSERT_TRUE(JSONReader::ReadToCompactValue("\"a\"", JSON_PARSE_RFC,
+                                             &scalar));
+  EXPECT_TRUE(scalar.Equals(CompactValue("a")));
+}
+
+}  // namespace base
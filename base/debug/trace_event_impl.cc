@@ -8,6 +8,7 @@
 
 #include "base/bind.h"
 #include "base/debug/trace_event.h"
+#include "base/debug/trace_ring_buffer.h"
 #include "base/file_util.h"
 #include "base/format_macros.h"
 #include "base/lazy_instance.h"
@@ -42,6 +43,9 @@ namespace debug {
 // before throwing them away.
 const size_t kTraceEventBufferSize = 500000;
 const size_t kTraceEventBatchSize = 1000;
+// Size of each thread's buffer in RECORD_CONTINUOUSLY mode, enough for several
+// thousand events.
+const size_t kTraceRingBufferSize = 512 * 1024;
 
 #define TRACE_EVENT_MAX_CATEGORIES 100
 
@@ -323,7 +327,10 @@ TraceLog* TraceLog::GetInstance() {
 
 TraceLog::TraceLog()
     : enabled_(false)
-    , dispatching_to_observer_list_(false) {
+    , recording_mode_(RECORD_UNTIL_FULL)
+    , recording_continuously_(false)
+    , dispatching_to_observer_list_(false)
+    , thread_ring_buffer_(&TraceLog::OnThreadExit) {
   // Trace is enabled or disabled on one thread while other threads are
   // accessing the enabled flag. We don't care whether edge-case events are
   // traced or not, so we allow races on the enabled flag to keep the trace
@@ -343,6 +350,14 @@ TraceLog::TraceLog()
 }
 
 TraceLog::~TraceLog() {
+  // Stops OnThreadExit() from being called with buffers that are about to be
+  // deleted.
+  thread_ring_buffer_.Free();
+}
+
+void TraceLog::SetRecordingMode(RecordingMode mode) {
+  AutoLock lock(lock_);
+  recording_mode_ = mode;
 }
 
 const unsigned char* TraceLog::GetCategoryEnabled(const char* name) {
@@ -447,7 +462,9 @@ void TraceLog::SetEnabled(const std::vector<std::string>& included_categories,
                     OnTraceLogWillEnable());
   dispatching_to_observer_list_ = false;
 
-  logged_events_.reserve(1024);
+  recording_continuously_ = (recording_mode_ == RECORD_CONTINUOUSLY);
+  if (!recording_continuously_)
+    logged_events_.reserve(1024);
   enabled_ = true;
   included_categories_ = included_categories;
   excluded_categories_ = excluded_categories;
@@ -554,6 +571,8 @@ void TraceLog::Flush() {
   {
     AutoLock lock(lock_);
     previous_logged_events.swap(logged_events_);
+    for (size_t i = 0; i < ring_buffers_.size(); ++i)
+      ring_buffers_[i]->Drain(&previous_logged_events);
     output_callback_copy = output_callback_;
   }  // release lock
 
@@ -586,6 +605,27 @@ int TraceLog::AddTraceEvent(char phase,
                             unsigned char flags) {
   DCHECK(name);
   TimeTicks now = TimeTicks::NowFromSystemTraceTime();
+
+  if (recording_continuously_) {
+    if (!*category_enabled)
+      return -1;
+    int thread_id = static_cast<int>(PlatformThread::CurrentId());
+    const char* new_name = PlatformThread::GetName();
+    // Only take the lock if the thread name needs recording; see below.
+    if (new_name != g_current_thread_name.Get().Get() &&
+        new_name && *new_name) {
+      AutoLock lock(lock_);
+      UpdateThreadName(thread_id, new_name);
+    }
+    if (flags & TRACE_EVENT_FLAG_MANGLE_ID)
+      id ^= process_id_hash_;
+    GetThreadRingBuffer()->AddEvent(thread_id,
+                                    now, phase, category_enabled, name, id,
+                                    num_args, arg_names, arg_types, arg_values,
+                                    flags);
+    return -1;
+  }
+
   BufferFullCallback buffer_full_callback_copy;
   int ret_begin_id = -1;
   {
@@ -604,25 +644,7 @@ int TraceLog::AddTraceEvent(char phase,
     // favor common case performance over corner case correctness.
     if (new_name != g_current_thread_name.Get().Get() &&
         new_name && *new_name) {
-      g_current_thread_name.Get().Set(new_name);
-      base::hash_map<int, std::string>::iterator existing_name =
-          thread_names_.find(thread_id);
-      if (existing_name == thread_names_.end()) {
-        // This is a new thread id, and a new name.
-        thread_names_[thread_id] = new_name;
-      } else {
-        // This is a thread id that we've seen before, but potentially with a
-        // new name.
-        std::vector<base::StringPiece> existing_names;
-        Tokenize(existing_name->second, ",", &existing_names);
-        bool found = std::find(existing_names.begin(),
-                               existing_names.end(),
-                               new_name) != existing_names.end();
-        if (!found) {
-          existing_name->second.push_back(',');
-          existing_name->second.append(new_name);
-        }
-      }
+      UpdateThreadName(thread_id, new_name);
     }
 
     if (threshold_begin_id > -1) {
@@ -663,6 +685,60 @@ int TraceLog::AddTraceEvent(char phase,
   return ret_begin_id;
 }
 
+void TraceLog::UpdateThreadName(int thread_id, const char* new_name) {
+  lock_.AssertAcquired();
+  g_current_thread_name.Get().Set(new_name);
+  base::hash_map<int, std::string>::iterator existing_name =
+      thread_names_.find(thread_id);
+  if (existing_name == thread_names_.end()) {
+    // This is a new thread id, and a new name.
+    thread_names_[thread_id] = new_name;
+  } else {
+    // This is a thread id that we've seen before, but potentially with a
+    // new name.
+    std::vector<base::StringPiece> existing_names;
+    Tokenize(existing_name->second, ",", &existing_names);
+    bool found = std::find(existing_names.begin(),
+                           existing_names.end(),
+                           new_name) != existing_names.end();
+    if (!found) {
+      existing_name->second.push_back(',');
+      existing_name->second.append(new_name);
+    }
+  }
+}
+
+TraceRingBuffer* TraceLog::GetThreadRingBuffer() {
+  TraceRingBuffer* buffer =
+      static_cast<TraceRingBuffer*>(thread_ring_buffer_.Get());
+  if (buffer)
+    return buffer;
+
+  {
+    AutoLock lock(lock_);
+    if (!idle_ring_buffers_.empty()) {
+      buffer = idle_ring_buffers_.back();
+      idle_ring_buffers_.pop_back();
+    } else {
+      buffer = new TraceRingBuffer(kTraceRingBufferSize);
+      ring_buffers_.push_back(buffer);
+    }
+  }  // release lock
+  thread_ring_buffer_.Set(buffer);
+  return buffer;
+}
+
+// static
+void TraceLog::OnThreadExit(void* ring_buffer) {
+  // The slot is freed before the TraceLog goes away, so it is still alive.
+  TraceLog* trace_log = GetInstance();
+  if (!trace_log)
+    return;
+  AutoLock lock(trace_log->lock_);
+  trace_log->idle_ring_buffers_.push_back(
+      static_cast<TraceRingBuffer*>(ring_buffer));
+}
+
 void TraceLog::AddTraceEventEtw(char phase,
                                 const char* name,
                                 const void* id,
@@ -15,9 +15,11 @@
 #include "base/callback.h"
 #include "base/hash_tables.h"
 #include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_vector.h"
 #include "base/observer_list.h"
 #include "base/string_util.h"
 #include "base/synchronization/lock.h"
+#include "base/threading/thread_local_storage.h"
 #include "base/timer.h"
 
 // Older style trace macros with explicit id and extra data
@@ -44,6 +46,8 @@ namespace base {
 
 namespace debug {
 
+class TraceRingBuffer;
+
 const int kTraceMaxNumArgs = 2;
 
 // Output records are "Events" and can be obtained via the
@@ -155,8 +159,27 @@ class BASE_EXPORT TraceResultBuffer {
 
 class BASE_EXPORT TraceLog {
  public:
+  // How events are buffered between flushes.
+  enum RecordingMode {
+    // Events are appended to a single buffer until it holds
+    // kTraceEventBufferSize events; later events are dropped and the buffer
+    // full callback is run.
+    RECORD_UNTIL_FULL,
+
+    // Each thread records into its own fixed-size ring buffer, overwriting
+    // its oldest events once the buffer is full, so tracing can be left on
+    // indefinitely. Events are only converted to TraceEvents on Flush().
+    // Threshold events (TRACE_EVENT_IF_LONGER_THAN*) are always recorded in
+    // this mode.
+    RECORD_CONTINUOUSLY
+  };
+
   static TraceLog* GetInstance();
 
+  // Sets the mode used from the next call to SetEnabled(). The default is
+  // RECORD_UNTIL_FULL.
+  void SetRecordingMode(RecordingMode mode);
+
   // Get set of known categories. This can change as new code paths are reached.
   // The known categories are inserted into |categories|.
   void GetKnownCategories(std::vector<std::string>* categories);
@@ -291,13 +314,22 @@ class BASE_EXPORT TraceLog {
   TraceLog();
   ~TraceLog();
   const unsigned char* GetCategoryEnabledInternal(const char* name);
+  void UpdateThreadName(int thread_id, const char* new_name);
   void AddThreadNameMetadataEvents();
   void AddClockSyncMetadataEvents();
 
+  // Returns the current thread's ring buffer, creating it if need be.
+  TraceRingBuffer* GetThreadRingBuffer();
+  static void OnThreadExit(void* ring_buffer);
+
   // TODO(nduca): switch to per-thread trace buffers to reduce thread
-  // synchronization.
+  // synchronization in RECORD_UNTIL_FULL mode too.
   Lock lock_;
   bool enabled_;
+  RecordingMode recording_mode_;
+  // Whether the current (or most recent) trace is RECORD_CONTINUOUSLY. Read
+  // without the lock by AddTraceEvent(), like the category enabled flags.
+  bool recording_continuously_;
   OutputCallback output_callback_;
   BufferFullCallback buffer_full_callback_;
   std::vector<TraceEvent> logged_events_;
@@ -308,6 +340,13 @@ class BASE_EXPORT TraceLog {
 
   base::hash_map<int, std::string> thread_names_;
 
+  // Every ring buffer handed out to a thread. When a thread exits its buffer
+  // keeps its events until the next Flush() and is reused by the next thread
+  // that needs one, so memory is bounded by the peak number of threads.
+  ScopedVector<TraceRingBuffer> ring_buffers_;
+  std::vector<TraceRingBuffer*> idle_ring_buffers_;
+  ThreadLocalStorage::Slot thread_ring_buffer_;
+
   // XORed with TraceID to make it unlikely to collide with other processes.
   unsigned long long process_id_hash_;
 
@@ -1107,6 +1107,65 @@ TEST_F(TraceEventTestFixture, DataCapturedManyThreads) {
                                            num_threads, num_events);
 }
 
+// Test that per-thread ring buffers gather data from multiple threads,
+// including threads that have exited before the flush.
+TEST_F(TraceEventTestFixture, ContinuousRecordingManyThreads) {
+  ManualTestSetUp();
+  TraceLog::GetInstance()->SetRecordingMode(TraceLog::RECORD_CONTINUOUSLY);
+  TraceLog::GetInstance()->SetEnabled(true);
+
+  const int num_threads = 4;
+  const int num_events = 1000;
+  Thread* threads[num_threads];
+  WaitableEvent* task_complete_events[num_threads];
+  for (int i = 0; i < num_threads; i++) {
+    threads[i] = new Thread(StringPrintf("Thread %d", i).c_str());
+    task_complete_events[i] = new WaitableEvent(false, false);
+    threads[i]->Start();
+    threads[i]->message_loop()->PostTask(
+        FROM_HERE, base::Bind(&TraceManyInstantEvents,
+                              i, num_events, task_complete_events[i]));
+  }
+
+  for (int i = 0; i < num_threads; i++) {
+    task_complete_events[i]->Wait();
+  }
+
+  for (int i = 0; i < num_threads; i++) {
+    threads[i]->Stop();
+    delete threads[i];
+    delete task_complete_events[i];
+  }
+
+  // Nothing goes through the bounded buffer in this mode.
+  EXPECT_EQ(0u, TraceLog::GetInstance()->GetEventsSize());
+  TraceLog::GetInstance()->SetEnabled(false);
+
+  ValidateInstantEventPresentOnEveryThread(trace_parsed_,
+                                           num_threads, num_events);
+  EXPECT_TRUE(FindNamePhaseKeyValue("thread_name", "M", "name", "Thread 0"));
+}
+
+// Test that continuous recording keeps the most recent events once the ring
+// buffer fills up, and that copied strings survive the trip through it.
+TEST_F(TraceEventTestFixture, ContinuousRecordingOverwritesOldest) {
+  ManualTestSetUp();
+  TraceLog::GetInstance()->SetRecordingMode(TraceLog::RECORD_CONTINUOUSLY);
+  TraceLog::GetInstance()->SetEnabled(true);
+
+  const int num_events = 100000;
+  for (int i = 0; i < num_events; i++) {
+    std::string name = StringPrintf("event %d", i);
+    TRACE_EVENT_COPY_INSTANT1("all", name.c_str(), "event", i);
+  }
+
+  TraceLog::GetInstance()->SetEnabled(false);
+
+  EXPECT_FALSE(FindNamePhase("event 0", "I"));
+  EXPECT_TRUE(FindNamePhase("event 99999", "I"));
+  EXPECT_LT(trace_parsed_.GetSize(), static_cast<size_t>(num_events));
+}
+
 // Test that thread and process names show up in the trace
 TEST_F(TraceEventTestFixture, ThreadNames) {
   ManualTestSetUp();
@@ -0,0 +1,230 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/debug/trace_ring_buffer.h"
+
+#include <string.h>
+
+#include "base/debug/trace_event.h"
+#include "base/logging.h"
+
+namespace base {
+namespace debug {
+
+// A record of phase 0 pads out the end of the buffer when the next record
+// does not fit there; only |size| and |phase| of a padding record are valid.
+struct TraceRingBuffer::Record {
+  uint32 size;
+  char phase;
+  unsigned char flags;
+  unsigned char arg_types[kTraceMaxNumArgs];
+  int thread_id;
+  int num_args;
+  int64 timestamp;
+  unsigned long long id;
+  unsigned long long arg_values[kTraceMaxNumArgs];
+  // Copied strings point into the payload that follows the record.
+  const char* arg_names[kTraceMaxNumArgs];
+  const unsigned char* category_enabled;
+  const char* name;
+};
+
+namespace {
+
+const char kPaddingPhase = 0;
+
+size_t AlignUp(size_t size) {
+  return (size + TraceRingBuffer::kAlignment - 1) &
+      ~(TraceRingBuffer::kAlignment - 1);
+}
+
+size_t GetCopyLength(const char* str) { return str ? strlen(str) + 1 : 0; }
+
+// Copies |*str| to |*payload|, points |*str| at the copy and advances
+// |*payload| past it.
+void CopyToPayload(char** payload, const char** str) {
+  if (!*str)
+    return;
+  size_t length = strlen(*str) + 1;
+  memcpy(*payload, *str, length);
+  *str = *payload;
+  *payload += length;
+}
+
+}  // namespace
+
+TraceRingBuffer::TraceRingBuffer(size_t capacity_bytes)
+    : capacity_(AlignUp(capacity_bytes)),
+      head_(0),
+      tail_(0),
+      used_(0),
+      num_events_(0),
+      overwritten_count_(0) {
+  COMPILE_ASSERT(sizeof(Record) % kAlignment == 0, record_must_be_aligned);
+  DCHECK_GE(capacity_, 4 * sizeof(Record));
+  buffer_.reset(new uint64[capacity_ / sizeof(uint64)]);
+}
+
+TraceRingBuffer::~TraceRingBuffer() {
+}
+
+void TraceRingBuffer::AddEvent(int thread_id,
+                               TimeTicks timestamp,
+                               char phase,
+                               const unsigned char* category_enabled,
+                               const char* name,
+                               unsigned long long id,
+                               int num_args,
+                               const char** arg_names,
+                               const unsigned char* arg_types,
+                               const unsigned long long* arg_values,
+                               unsigned char flags) {
+  DCHECK_NE(kPaddingPhase, phase);
+  // Clamp num_args since it may have been set by a third_party library.
+  num_args = (num_args > kTraceMaxNumArgs) ? kTraceMaxNumArgs : num_args;
+
+  // Work out which strings need copying, the same way TraceEvent does.
+  bool copy = !!(flags & TRACE_EVENT_FLAG_COPY);
+  size_t payload_size = 0;
+  if (copy) {
+    payload_size += GetCopyLength(name);
+    for (int i = 0; i < num_args; ++i)
+      payload_size += GetCopyLength(arg_names[i]);
+  }
+  for (int i = 0; i < num_args; ++i) {
+    if (arg_types[i] == TRACE_VALUE_TYPE_COPY_STRING ||
+        (copy && arg_types[i] == TRACE_VALUE_TYPE_STRING)) {
+      TraceEvent::TraceValue value;
+      value.as_uint = arg_values[i];
+      payload_size += GetCopyLength(value.as_string);
+    }
+  }
+
+  size_t size = AlignUp(sizeof(Record) + payload_size);
+
+  AutoLock lock(lock_);
+  if (size > capacity_ / 4) {
+    ++overwritten_count_;
+    return;
+  }
+
+  // Records never wrap, so pad out the end of the buffer if need be.
+  if (capacity_ - tail_ < size) {
+    size_t padding = capacity_ - tail_;
+    Reserve(padding);
+    Record* pad = RecordAt(tail_);
+    pad->size = static_cast<uint32>(padding);
+    pad->phase = kPaddingPhase;
+    used_ += padding;
+    tail_ = 0;
+  }
+  Reserve(size);
+
+  Record* record = RecordAt(tail_);
+  record->size = static_cast<uint32>(size);
+  record->phase = phase;
+  record->flags = flags;
+  record->thread_id = thread_id;
+  record->num_args = num_args;
+  record->timestamp = timestamp.ToInternalValue();
+  record->id = id;
+  record->category_enabled = category_enabled;
+  record->name = name;
+  int i = 0;
+  for (; i < num_args; ++i) {
+    record->arg_names[i] = arg_names[i];
+    record->arg_types[i] = arg_types[i];
+    record->arg_values[i] = arg_values[i];
+  }
+  for (; i < kTraceMaxNumArgs; ++i) {
+    record->arg_names[i] = NULL;
+    record->arg_types[i] = TRACE_VALUE_TYPE_UINT;
+    record->arg_values[i] = 0u;
+  }
+
+  if (payload_size) {
+    char* payload = reinterpret_cast<char*>(record + 1);
+    if (copy) {
+      CopyToPayload(&payload, &record->name);
+      for (i = 0; i < num_args; ++i)
+        CopyToPayload(&payload, &record->arg_names[i]);
+    }
+    for (i = 0; i < num_args; ++i) {
+      if (record->arg_types[i] == TRACE_VALUE_TYPE_COPY_STRING ||
+          (copy && record->arg_types[i] == TRACE_VALUE_TYPE_STRING)) {
+        TraceEvent::TraceValue value;
+        value.as_uint = record->arg_values[i];
+        CopyToPayload(&payload, &value.as_string);
+        record->arg_values[i] = value.as_uint;
+      }
+    }
+    DCHECK_LE(payload, reinterpret_cast<char*>(record) + size);
+  }
+
+  tail_ += size;
+  if (tail_ == capacity_)
+    tail_ = 0;
+  used_ += size;
+  ++num_events_;
+}
+
+void TraceRingBuffer::Drain(std::vector<TraceEvent>* events) {
+  AutoLock lock(lock_);
+  events->reserve(events->size() + num_events_);
+  size_t offset = head_;
+  for (size_t drained = 0; drained < used_; ) {
+    const Record* record = RecordAt(offset);
+    if (record->phase != kPaddingPhase) {
+      // TraceEvent makes its own copies of the strings in the payload.
+      events->push_back(
+          TraceEvent(record->thread_id,
+                     TimeTicks::FromInternalValue(record->timestamp),
+                     record->phase, record->category_enabled, record->name,
+                     record->id, record->num_args,
+                     const_cast<const char**>(record->arg_names),
+                     record->arg_types, record->arg_values, record->flags));
+    }
+    drained += record->size;
+    offset += record->size;
+    if (offset == capacity_)
+      offset = 0;
+  }
+  head_ = tail_ = used_ = 0;
+  num_events_ = 0;
+}
+
+size_t TraceRingBuffer::size() const {
+  AutoLock lock(lock_);
+  return num_events_;
+}
+
+size_t TraceRingBuffer::overwritten_count() const {
+  AutoLock lock(lock_);
+  return overwritten_count_;
+}
+
+void TraceRingBuffer::Reserve(size_t size) {
+  lock_.AssertAcquired();
+  DCHECK_LE(tail_ + size, capacity_);
+  while (capacity_ - used_ < size) {
+    const Record* oldest = RecordAt(head_);
+    if (oldest->phase != kPaddingPhase) {
+      --num_events_;
+      ++overwritten_count_;
+    }
+    head_ += oldest->size;
+    if (head_ == capacity_)
+      head_ = 0;
+    used_ -= oldest->size;
+  }
+}
+
+TraceRingBuffer::Record* TraceRingBuffer::RecordAt(size_t offset) const {
+  DCHECK_EQ(0u, offset % kAlignment);
+  return reinterpret_cast<Record*>(
+      reinterpret_cast<char*>(buffer_.get()) + offset);
+}
+
+}  // namespace debug
+}  // namespace base
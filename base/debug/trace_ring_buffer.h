@@ -0,0 +1,94 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_DEBUG_TRACE_RING_BUFFER_H_
+#define BASE_DEBUG_TRACE_RING_BUFFER_H_
+#pragma once
+
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/debug/trace_event_impl.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/time.h"
+
+namespace base {
+namespace debug {
+
+// A fixed-size buffer of trace events in a compact binary form, used by
+// TraceLog when recording continuously. Each record holds the same fields as
+// a TraceEvent, but category and name are kept as the pointers the trace
+// macros pass in (they are static strings) and only the strings a TraceEvent
+// would deep copy are packed in after the record. Once the buffer is full the
+// oldest records are overwritten, so memory use stays constant no matter how
+// long tracing runs; TraceEvents are only built when the buffer is drained.
+//
+// TraceLog gives each thread its own buffer, so the lock is only ever
+// contended while a buffer is being drained.
+class BASE_EXPORT TraceRingBuffer {
+ public:
+  explicit TraceRingBuffer(size_t capacity_bytes);
+  ~TraceRingBuffer();
+
+  // Records an event; the arguments are as for the TraceEvent constructor.
+  // Events too large to fit in a quarter of the buffer are dropped.
+  void AddEvent(int thread_id,
+                TimeTicks timestamp,
+                char phase,
+                const unsigned char* category_enabled,
+                const char* name,
+                unsigned long long id,
+                int num_args,
+                const char** arg_names,
+                const unsigned char* arg_types,
+                const unsigned long long* arg_values,
+                unsigned char flags);
+
+  // Appends the recorded events to |events|, oldest first, and empties the
+  // buffer.
+  void Drain(std::vector<TraceEvent>* events);
+
+  // Number of events currently recorded.
+  size_t size() const;
+
+  // Number of events overwritten or dropped since the buffer was created.
+  size_t overwritten_count() const;
+
+  size_t capacity_bytes() const { return capacity_; }
+
+  static const size_t kAlignment = 8;
+
+ private:
+  struct Record;
+
+  // Drops the oldest records until |size| contiguous bytes are free at
+  // |tail_|.
+  void Reserve(size_t size);
+
+  Record* RecordAt(size_t offset) const;
+
+  mutable Lock lock_;
+
+  // Allocated as uint64s to get kAlignment.
+  scoped_array<uint64> buffer_;
+  const size_t capacity_;
+
+  // Offsets of the oldest record and of the next free byte, and the number of
+  // bytes in use between them (which tells a full buffer from an empty one).
+  size_t head_;
+  size_t tail_;
+  size_t used_;
+
+  size_t num_events_;
+  size_t overwritten_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(TraceRingBuffer);
+};
+
+}  // namespace debug
+}  // namespace base
+
+#endif  // BASE_DEBUG_TRACE_RING_BUFFER_H_
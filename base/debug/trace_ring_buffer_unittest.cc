@@ -0,0 +1,124 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/debug/trace_ring_buffer.h"
+
+#include <string>
+#include <vector>
+
+#include "base/debug/trace_event.h"
+#include "base/stringprintf.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace debug {
+
+namespace {
+
+void AddInstantEvent(TraceRingBuffer* buffer, const char* name,
+                     unsigned long long value, unsigned char flags) {
+  const char* arg_name = "value";
+  unsigned char arg_type = TRACE_VALUE_TYPE_UINT;
+  buffer->AddEvent(1, TimeTicks::FromInternalValue(value),
+                   TRACE_EVENT_PHASE_INSTANT,
+                   TraceLog::GetCategoryEnabled("test"), name, value,
+                   1, &arg_name, &arg_type, &value, flags);
+}
+
+}  // namespace
+
+TEST(TraceRingBufferTest, DrainReturnsEventsInOrder) {
+  TraceRingBuffer buffer(4096);
+  static const char* const kNames[] = { "a", "b", "c" };
+  for (size_t i = 0; i < arraysize(kNames); ++i)
+    AddInstantEvent(&buffer, kNames[i], i, TRACE_EVENT_FLAG_NONE);
+  EXPECT_EQ(3u, buffer.size());
+
+  std::vector<TraceEvent> events;
+  buffer.Drain(&events);
+  ASSERT_EQ(3u, events.size());
+  for (size_t i = 0; i < arraysize(kNames); ++i) {
+    // Names that aren't copied are stored as the caller's pointer.
+    EXPECT_EQ(kNames[i], events[i].name());
+    EXPECT_EQ(static_cast<int64>(i), events[i].timestamp().ToInternalValue());
+    EXPECT_TRUE(events[i].parameter_copy_storage() == NULL);
+  }
+  EXPECT_EQ(0u, buffer.size());
+  EXPECT_EQ(0u, buffer.overwritten_count());
+
+  // The buffer is reusable after a drain.
+  AddInstantEvent(&buffer, "d", 3, TRACE_EVENT_FLAG_NONE);
+  events.clear();
+  buffer.Drain(&events);
+  ASSERT_EQ(1u, events.size());
+  EXPECT_STREQ("d", events[0].name());
+}
+
+TEST(TraceRingBufferTest, OverwritesOldestEvents) {
+  TraceRingBuffer buffer(4096);
+  const int kNumEvents = 1000;
+  for (int i = 0; i < kNumEvents; ++i)
+    AddInstantEvent(&buffer, "event", i, TRACE_EVENT_FLAG_NONE);
+
+  size_t kept = buffer.size();
+  EXPECT_GT(kept, 0u);
+  EXPECT_LT(kept, static_cast<size_t>(kNumEvents));
+  EXPECT_EQ(kNumEvents - kept, buffer.overwritten_count());
+
+  // What is left is the most recent events, oldest first.
+  std::vector<TraceEvent> events;
+  buffer.Drain(&events);
+  ASSERT_EQ(kept, events.size());
+  for (size_t i = 0; i < kept; ++i) {
+    EXPECT_EQ(static_cast<int64>(kNumEvents - kept + i),
+              events[i].timestamp().ToInternalValue());
+  }
+}
+
+// Records of varying size force padding at the end of the buffer.
+TEST(TraceRingBufferTest, CopiesStringsAcrossWraparound) {
+  TraceRingBuffer buffer(4096);
+  const int kNumEvents = 500;
+  for (int i = 0; i < kNumEvents; ++i) {
+    std::string name = StringPrintf("event %d %s", i,
+                                    std::string(i % 37, 'x').c_str());
+    std::string value = StringPrintf("value %d", i);
+    const char* arg_name = "arg";
+    unsigned char arg_type;
+    unsigned long long arg_value;
+    trace_event_internal::SetTraceValue(value, &arg_type, &arg_value);
+    buffer.AddEvent(1, TimeTicks::FromInternalValue(i),
+                    TRACE_EVENT_PHASE_INSTANT,
+                    TraceLog::GetCategoryEnabled("test"), name.c_str(), 0,
+                    1, &arg_name, &arg_type, &arg_value,
+                    TRACE_EVENT_FLAG_COPY);
+  }
+
+  std::vector<TraceEvent> events;
+  buffer.Drain(&events);
+  ASSERT_FALSE(events.empty());
+  size_t first = kNumEvents - events.size();
+  for (size_t i = 0; i < events.size(); ++i) {
+    int n = static_cast<int>(first + i);
+    EXPECT_EQ(StringPrintf("event %d %s", n, std::string(n % 37, 'x').c_str()),
+              events[i].name());
+    EXPECT_TRUE(events[i].parameter_copy_storage() != NULL);
+
+    std::string json;
+    events[i].AppendAsJSON(&json);
+    EXPECT_NE(std::string::npos,
+              json.find(StringPrintf("\"arg\":\"value %d\"", n)));
+  }
+}
+
+TEST(TraceRingBufferTest, DropsOversizedEvents) {
+  TraceRingBuffer buffer(4096);
+  std::string name(2048, 'x');
+  AddInstantEvent(&buffer, name.c_str(), 0, TRACE_EVENT_FLAG_COPY);
+  EXPECT_EQ(0u, buffer.size());
+  EXPECT_EQ(1u, buffer.overwritten_count());
+}
+
+}  // namespace debug
+}  // namespace base
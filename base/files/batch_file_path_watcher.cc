@@ -0,0 +1,129 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/batch_file_path_watcher.h"
+
+#include "base/files/file_path_watcher.h"
+#include "base/location.h"
+#include "base/logging.h"
+
+namespace base {
+namespace files {
+
+// Forwards every watcher's notifications to the BatchFilePathWatcher, until
+// it is cancelled. FilePathWatcher calls it on the thread Watch() ran on.
+class BatchFilePathWatcher::WatcherDelegate : public FilePathWatcher::Delegate {
+ public:
+  explicit WatcherDelegate(BatchFilePathWatcher* watcher)
+      : watcher_(watcher) {}
+
+  void Cancel() {
+    watcher_ = NULL;
+  }
+
+  virtual void OnFilePathChanged(const FilePath& path) OVERRIDE {
+    if (watcher_)
+      watcher_->OnPathChanged(path);
+  }
+
+  virtual void OnFilePathError(const FilePath& path) OVERRIDE {
+    if (watcher_)
+      watcher_->OnPathError(path);
+  }
+
+ private:
+  virtual ~WatcherDelegate() {}
+
+  BatchFilePathWatcher* watcher_;
+
+  DISALLOW_COPY_AND_ASSIGN(WatcherDelegate);
+};
+
+BatchFilePathWatcher::BatchFilePathWatcher(TimeDelta delay)
+    : delay_(delay) {
+  // No need to restrict the thread until the state is created in Watch.
+  DetachFromThread();
+}
+
+BatchFilePathWatcher::~BatchFilePathWatcher() {
+  Cancel();
+}
+
+bool BatchFilePathWatcher::Watch(const std::vector<FilePath>& paths,
+                                 const ChangeCallback& callback) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(!callback.is_null());
+  Cancel();
+
+  callback_ = callback;
+  delegate_ = new WatcherDelegate(this);
+  for (size_t i = 0; i < paths.size(); ++i) {
+    linked_ptr<FilePathWatcher> watcher(new FilePathWatcher());
+    if (!watcher->Watch(paths[i], delegate_.get())) {
+      DLOG(WARNING) << "Failed to watch " << paths[i].value();
+      Cancel();
+      return false;
+    }
+    watchers_.push_back(watcher);
+  }
+  return true;
+}
+
+void BatchFilePathWatcher::Cancel() {
+  DCHECK(CalledOnValidThread());
+  if (delegate_) {
+    delegate_->Cancel();
+    delegate_ = NULL;
+  }
+  watchers_.clear();
+  timer_.Stop();
+  changed_.clear();
+  failed_.clear();
+  callback_.Reset();
+  // All state is gone so it's okay to detach from thread.
+  DetachFromThread();
+}
+
+bool BatchFilePathWatcher::IsWatching() const {
+  DCHECK(CalledOnValidThread());
+  return delegate_.get() != NULL;
+}
+
+void BatchFilePathWatcher::Flush() {
+  DCHECK(CalledOnValidThread());
+  timer_.Stop();
+  if (changed_.empty() && failed_.empty())
+    return;
+
+  // The callback may delete |this|, so don't touch the members after it runs.
+  PathSet changed;
+  PathSet failed;
+  changed.swap(changed_);
+  failed.swap(failed_);
+  ChangeCallback callback = callback_;
+  callback.Run(changed, failed);
+}
+
+void BatchFilePathWatcher::OnPathChanged(const FilePath& path) {
+  DCHECK(CalledOnValidThread());
+  if (failed_.count(path))
+    return;
+  changed_.insert(path);
+  StartTimer();
+}
+
+void BatchFilePathWatcher::OnPathError(const FilePath& path) {
+  DCHECK(CalledOnValidThread());
+  changed_.erase(path);
+  failed_.insert(path);
+  StartTimer();
+}
+
+void BatchFilePathWatcher::StartTimer() {
+  if (!timer_.IsRunning())
+    timer_.Start(FROM_HERE, delay_, this, &BatchFilePathWatcher::Flush);
+}
+
+}  // namespace files
+}  // namespace base
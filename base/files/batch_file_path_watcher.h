@@ -0,0 +1,100 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This module watches a set of files and directories and reports their
+// changes in batches.
+
+#ifndef BASE_FILES_BATCH_FILE_PATH_WATCHER_H_
+#define BASE_FILES_BATCH_FILE_PATH_WATCHER_H_
+#pragma once
+
+#include <set>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/file_path.h"
+#include "base/memory/linked_ptr.h"
+#include "base/memory/ref_counted.h"
+#include "base/threading/non_thread_safe.h"
+#include "base/time.h"
+#include "base/timer.h"
+
+namespace base {
+namespace files {
+
+class FilePathWatcher;
+
+// Watches several paths with a single registration, and coalesces their
+// changes. Editors, installers and config daemons tend to touch a file
+// several times in a row, and to touch several related files at once; rather
+// than one callback per inotify (or kqueue, or FSEvents) event, the client
+// gets one callback per |delay| naming every path that changed in that time.
+//
+// The window starts at the first change after a callback, and is not
+// extended by later changes, so a steady stream of writes still produces a
+// callback every |delay|.
+//
+// The paths are watched with FilePathWatcher, so they have its semantics on
+// each platform. On Linux all watches already share the one inotify
+// descriptor, and paths in the same directory share the directory's watch.
+//
+// Must be used on a thread with a MessageLoop of TYPE_IO; the callback runs
+// on that thread.
+class BASE_EXPORT BatchFilePathWatcher : public NonThreadSafe {
+ public:
+  typedef std::set<FilePath> PathSet;
+
+  // |changed| holds the paths that changed since the last callback. |failed|
+  // holds the paths whose watches failed since the last callback; they are
+  // no longer watched. A path is in at most one of the two.
+  typedef base::Callback<void(const PathSet& changed,
+                              const PathSet& failed)> ChangeCallback;
+
+  explicit BatchFilePathWatcher(TimeDelta delay);
+  // Cancels the watches. Pending changes are dropped.
+  ~BatchFilePathWatcher();
+
+  // Starts watching |paths|, which must be absolute, replacing any earlier
+  // watches. Returns false, and watches nothing, if any of them can't be
+  // watched.
+  bool Watch(const std::vector<FilePath>& paths,
+             const ChangeCallback& callback);
+
+  // Stops watching and drops pending changes.
+  void Cancel();
+
+  bool IsWatching() const;
+
+  // Runs the callback now with the changes seen so far, if there are any,
+  // rather than waiting for the window to close.
+  void Flush();
+
+ private:
+  class WatcherDelegate;
+
+  void OnPathChanged(const FilePath& path);
+  void OnPathError(const FilePath& path);
+
+  // Starts the window if it isn't open yet.
+  void StartTimer();
+
+  const TimeDelta delay_;
+  ChangeCallback callback_;
+
+  std::vector<linked_ptr<FilePathWatcher> > watchers_;
+  scoped_refptr<WatcherDelegate> delegate_;
+
+  PathSet changed_;
+  PathSet failed_;
+  OneShotTimer<BatchFilePathWatcher> timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(BatchFilePathWatcher);
+};
+
+}  // namespace files
+}  // namespace base
+
+#endif  // BASE_FILES_BATCH_FILE_PATH_WATCHER_H_
@@ -0,0 +1,124 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/files/batch_file_path_watcher.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/message_loop.h"
+#include "base/scoped_temp_dir.h"
+#include "base/test/test_timeouts.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace files {
+
+namespace {
+
+TimeDelta TinyTimeout() {
+  return TimeDelta::FromMilliseconds(TestTimeouts::tiny_timeout_ms());
+}
+
+TimeDelta ActionTimeout() {
+  return TimeDelta::FromMilliseconds(TestTimeouts::action_timeout_ms());
+}
+
+class BatchFilePathWatcherTest : public testing::Test {
+ public:
+  BatchFilePathWatcherTest()
+      : loop_(MessageLoop::TYPE_IO),
+        callbacks_(0) {}
+
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+  }
+
+ protected:
+  FilePath GetPath(const char* name) {
+    return temp_dir_.path().AppendASCII(name);
+  }
+
+  bool WriteFile(const FilePath& path, const std::string& content) {
+    int written = file_util::WriteFile(path, content.data(), content.size());
+    return written == static_cast<int>(content.size());
+  }
+
+  void OnChange(const BatchFilePathWatcher::PathSet& changed,
+                const BatchFilePathWatcher::PathSet& failed) {
+    ++callbacks_;
+    changed_.insert(changed.begin(), changed.end());
+    EXPECT_TRUE(failed.empty());
+    if (changed_.size() == expected_changes_)
+      MessageLoop::current()->Quit();
+  }
+
+  // Runs the loop until |count| distinct paths have been reported, or the
+  // test times out.
+  void WaitForChanges(size_t count) {
+    expected_changes_ = count;
+    loop_.PostDelayedTask(FROM_HERE, MessageLoop::QuitClosure(),
+                          ActionTimeout());
+    loop_.Run();
+  }
+
+  BatchFilePathWatcher::ChangeCallback GetCallback() {
+    return Bind(&BatchFilePathWatcherTest::OnChange, Unretained(this));
+  }
+
+  MessageLoop loop_;
+  ScopedTempDir temp_dir_;
+
+  int callbacks_;
+  size_t expected_changes_;
+  BatchFilePathWatcher::PathSet changed_;
+};
+
+}  // namespace
+
+// Several writes to several files come back as one batch.
+TEST_F(BatchFilePathWatcherTest, CoalescesChanges) {
+  BatchFilePathWatcher watcher(TinyTimeout());
+  std::vector<FilePath> paths;
+  paths.push_back(GetPath("a"));
+  paths.push_back(GetPath("b"));
+  paths.push_back(GetPath("c"));
+  ASSERT_TRUE(watcher.Watch(paths, GetCallback()));
+  EXPECT_TRUE(watcher.IsWatching());
+
+  const int kWrites = 5;
+  for (int i = 0; i < kWrites; ++i) {
+    ASSERT_TRUE(WriteFile(paths[0], "content"));
+    ASSERT_TRUE(WriteFile(paths[1], "content"));
+  }
+  WaitForChanges(2);
+
+  EXPECT_EQ(2U, changed_.size());
+  EXPECT_EQ(1U, changed_.count(paths[0]));
+  EXPECT_EQ(1U, changed_.count(paths[1]));
+  // The inotify events may straddle the end of a window, but they should not
+  // come back one by one.
+  EXPECT_LT(callbacks_, kWrites);
+}
+
+// Cancelling drops changes that haven't been reported yet.
+TEST_F(BatchFilePathWatcherTest, CancelDropsChanges) {
+  BatchFilePathWatcher watcher(ActionTimeout());
+  std::vector<FilePath> paths;
+  paths.push_back(GetPath("a"));
+  ASSERT_TRUE(watcher.Watch(paths, GetCallback()));
+  ASSERT_TRUE(WriteFile(paths[0], "content"));
+  watcher.Cancel();
+  EXPECT_FALSE(watcher.IsWatching());
+  watcher.Flush();
+
+  loop_.PostDelayedTask(FROM_HERE, MessageLoop::QuitClosure(), TinyTimeout());
+  loop_.Run();
+  EXPECT_EQ(0, callbacks_);
+}
+
+}  // namespace files
+}  // namespace base
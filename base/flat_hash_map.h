@@ -0,0 +1,459 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// base::flat_hash_map and base::flat_hash_set are drop-in replacements for
+// base::hash_map and base::hash_set for small keys and values on hot paths.
+//
+// base::hash_map is a node-based table: every insert allocates a node and
+// every lookup follows a bucket pointer and then a chain of node pointers.
+// The flat tables keep their elements in a single array, found by linear
+// probing, next to an array with a byte per slot that records whether it is
+// in use along with seven bits of the element's hash.  A lookup usually
+// touches one cache line of each array, and only compares keys whose hash
+// bits match.  Hashes are remixed first, so the identity hashes that
+// BASE_HASH_NAMESPACE::hash gives integers spread evenly over the table.
+//
+//   base::flat_hash_map<int, std::string> names;
+//   names[1] = "one";
+//   base::flat_hash_set<int> ids;
+//   ids.insert(1);
+//
+// The interface is the subset of hash_map's in common use, with these
+// differences:
+// - Inserting into a table can move its elements, so pointers, references
+//   and iterators into a table are invalidated by any insertion (but not by
+//   erasure, so "erase(it++)" works).
+// - Elements are copied when the table grows, so they should be cheap to
+//   copy.  Store large values by pointer.
+// - Erasing an element leaves a marker in its slot, for later probes to
+//   step over, until an insertion reuses it or the table is rehashed.  A
+//   table never shrinks, except when it is cleared.
+
+#ifndef BASE_FLAT_HASH_MAP_H_
+#define BASE_FLAT_HASH_MAP_H_
+#pragma once
+
+#include <stddef.h>
+#include <string.h>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <utility>
+
+#include "base/basictypes.h"
+#include "base/hash_tables.h"
+#include "base/logging.h"
+
+namespace base {
+namespace internal {
+
+// Mixes the bits of |hash| so that hashes which differ in only a few bits
+// land in different parts of the table, and have different tags.
+inline size_t MixFlatHash(size_t hash) {
+#if defined(ARCH_CPU_64_BITS)
+  // The finalizer of MurmurHash3.
+  uint64 mixed = hash;
+  mixed ^= mixed >> 33;
+  mixed *= GG_UINT64_C(0xff51afd7ed558ccd);
+  mixed ^= mixed >> 33;
+  mixed *= GG_UINT64_C(0xc4ceb9fe1a85ec53);
+  mixed ^= mixed >> 33;
+  return static_cast<size_t>(mixed);
+#else
+  uint32 mixed = hash;
+  mixed ^= mixed >> 16;
+  mixed *= 0x85ebca6b;
+  mixed ^= mixed >> 13;
+  mixed *= 0xc2b2ae35;
+  mixed ^= mixed >> 16;
+  return mixed;
+#endif
+}
+
+// Gets the key of an element of a flat_hash_set.
+template <typename Value>
+struct FlatHashIdentity {
+  const Value& operator()(const Value& value) const { return value; }
+};
+
+// Gets the key of an element of a flat_hash_map.
+template <typename Pair>
+struct FlatHashSelectFirst {
+  const typename Pair::first_type& operator()(const Pair& value) const {
+    return value.first;
+  }
+};
+
+template <typename Value, typename Key, typename KeyOf, typename Hash,
+          typename Equal>
+class FlatHashTable;
+
+// Iterates over the slots of a FlatHashTable that are in use.  |T| is the
+// table's value_type for an iterator, or a const one for a const_iterator.
+template <typename T>
+class FlatHashIterator {
+ public:
+  typedef std::forward_iterator_tag iterator_category;
+  typedef T value_type;
+  typedef ptrdiff_t difference_type;
+  typedef T* pointer;
+  typedef T& reference;
+
+  FlatHashIterator() : control_(NULL), control_end_(NULL), slot_(NULL) {}
+
+  // Lets an iterator convert to a const_iterator.
+  template <typename U>
+  FlatHashIterator(const FlatHashIterator<U>& other)
+      : control_(other.control_),
+        control_end_(other.control_end_),
+        slot_(other.slot_) {
+  }
+
+  T& operator*() const { return *slot_; }
+  T* operator->() const { return slot_; }
+
+  FlatHashIterator& operator++() {
+    ++control_;
+    ++slot_;
+    SkipUnusedSlots();
+    return *this;
+  }
+
+  FlatHashIterator operator++(int) {
+    FlatHashIterator previous(*this);
+    ++*this;
+    return previous;
+  }
+
+  template <typename U>
+  bool operator==(const FlatHashIterator<U>& other) const {
+    return control_ == other.control_;
+  }
+
+  template <typename U>
+  bool operator!=(const FlatHashIterator<U>& other) const {
+    return control_ != other.control_;
+  }
+
+ private:
+  template <typename U> friend class FlatHashIterator;
+  template <typename Value, typename Key, typename KeyOf, typename Hash,
+            typename Equal>
+  friend class FlatHashTable;
+
+  FlatHashIterator(const uint8* control, const uint8* control_end, T* slot)
+      : control_(control),
+        control_end_(control_end),
+        slot_(slot) {
+  }
+
+  void SkipUnusedSlots();
+
+  const uint8* control_;
+  const uint8* control_end_;
+  T* slot_;
+};
+
+// The open-addressing table behind flat_hash_map and flat_hash_set.
+template <typename Value, typename Key, typename KeyOf, typename Hash,
+          typename Equal>
+class FlatHashTable {
+ public:
+  typedef Key key_type;
+  typedef Value value_type;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  typedef Hash hasher;
+  typedef Equal key_equal;
+  typedef Value& reference;
+  typedef const Value& const_reference;
+  typedef Value* pointer;
+  typedef const Value* const_pointer;
+  typedef FlatHashIterator<Value> iterator;
+  typedef FlatHashIterator<const Value> const_iterator;
+
+  // The values of a slot's control byte.  A slot in use has its top bit set
+  // and the top seven bits of its element's mixed hash below that.
+  enum {
+    kEmpty = 0,
+    kErased = 1,
+    kInUse = 0x80
+  };
+
+  FlatHashTable()
+      : control_(NULL),
+        slots_(NULL),
+        capacity_(0),
+        size_(0),
+        erased_(0) {
+  }
+
+  FlatHashTable(const FlatHashTable& other)
+      : control_(NULL),
+        slots_(NULL),
+        capacity_(0),
+        size_(0),
+        erased_(0),
+        hasher_(other.hasher_),
+        key_equal_(other.key_equal_) {
+    insert(other.begin(), other.end());
+  }
+
+  ~FlatHashTable() {
+    DestroyAll();
+  }
+
+  FlatHashTable& operator=(const FlatHashTable& other) {
+    FlatHashTable copy(other);
+    swap(copy);
+    return *this;
+  }
+
+  iterator begin() { return IteratorAt(0); }
+  iterator end() { return IteratorAt(capacity_); }
+  const_iterator begin() const { return IteratorAt(0); }
+  const_iterator end() const { return IteratorAt(capacity_); }
+
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+
+  // The number of elements the table can hold before it next grows.
+  size_type capacity() const { return capacity_ / 4 * 3; }
+
+  void clear() {
+    DestroyAll();
+    control_ = NULL;
+    slots_ = NULL;
+    capacity_ = 0;
+    size_ = 0;
+    erased_ = 0;
+  }
+
+  void swap(FlatHashTable& other) {
+    std::swap(control_, other.control_);
+    std::swap(slots_, other.slots_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(size_, other.size_);
+    std::swap(erased_, other.erased_);
+    std::swap(hasher_, other.hasher_);
+    std::swap(key_equal_, other.key_equal_);
+  }
+
+  // Makes room for |count| elements in all, so that inserting them will
+  // not have to grow the table again.
+  void reserve(size_type count) {
+    if (count > capacity() - erased_)
+      Rehash(CapacityFor(count));
+  }
+
+  iterator find(const key_type& key) {
+    size_t index;
+    return Find(key, MixFlatHash(hasher_(key)), &index) ? IteratorAt(index)
+                                                        : end();
+  }
+
+  const_iterator find(const key_type& key) const {
+    size_t index;
+    return Find(key, MixFlatHash(hasher_(key)), &index) ? IteratorAt(index)
+                                                        : end();
+  }
+
+  size_type count(const key_type& key) const {
+    size_t index;
+    return Find(key, MixFlatHash(hasher_(key)), &index) ? 1 : 0;
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    const key_type& key = KeyOf()(value);
+    size_t hash = MixFlatHash(hasher_(key));
+    size_t index;
+    if (Find(key, hash, &index))
+      return std::make_pair(IteratorAt(index), false);
+    if (size_ + erased_ >= capacity())
+      Rehash(CapacityFor(size_ + 1));
+    index = Insert(hash, value);
+    return std::make_pair(IteratorAt(index), true);
+  }
+
+  template <typename InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    for (; first != last; ++first)
+      insert(*first);
+  }
+
+  // Does not move any other element, so iterators stay valid.
+  void erase(const_iterator position) {
+    EraseAt(position.control_ - control_);
+  }
+
+  size_type erase(const key_type& key) {
+    size_t index;
+    if (!Find(key, MixFlatHash(hasher_(key)), &index))
+      return 0;
+    EraseAt(index);
+    return 1;
+  }
+
+  hasher hash_funct() const { return hasher_; }
+  key_equal key_eq() const { return key_equal_; }
+
+ private:
+  enum { kMinCapacity = 8 };
+
+  static uint8 Tag(size_t hash) {
+    return static_cast<uint8>(kInUse | (hash >> (sizeof(size_t) * 8 - 7)));
+  }
+
+  // Returns the smallest capacity that keeps the table no more than three
+  // quarters full with |count| elements.
+  static size_t CapacityFor(size_t count) {
+    size_t capacity = kMinCapacity;
+    while (capacity / 4 * 3 < count)
+      capacity *= 2;
+    return capacity;
+  }
+
+  iterator IteratorAt(size_t index) {
+    iterator it(control_ + index, control_ + capacity_, slots_ + index);
+    it.SkipUnusedSlots();
+    return it;
+  }
+
+  const_iterator IteratorAt(size_t index) const {
+    const_iterator it(control_ + index, control_ + capacity_, slots_ + index);
+    it.SkipUnusedSlots();
+    return it;
+  }
+
+  // Probes for |key|, whose mixed hash is |hash|.  The table always has an
+  // empty slot, which ends the probe.
+  bool Find(const key_type& key, size_t hash, size_t* index) const {
+    if (!capacity_)
+      return false;
+    uint8 tag = Tag(hash);
+    size_t mask = capacity_ - 1;
+    for (size_t i = hash & mask; control_[i] != kEmpty; i = (i + 1) & mask) {
+      if (control_[i] == tag && key_equal_(KeyOf()(slots_[i]), key)) {
+        *index = i;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Constructs |value|, which is not in the table, in the first free slot
+  // for |hash|.  The table must have room for it.
+  size_t Insert(size_t hash, const value_type& value) {
+    size_t mask = capacity_ - 1;
+    size_t i = hash & mask;
+    while (control_[i] & kInUse)
+      i = (i + 1) & mask;
+    new (&slots_[i]) value_type(value);
+    if (control_[i] == kErased)
+      --erased_;
+    control_[i] = Tag(hash);
+    ++size_;
+    return i;
+  }
+
+  void EraseAt(size_t index) {
+    DCHECK(control_[index] & kInUse);
+    slots_[index].~value_type();
+    // With linear probing, a slot followed by an empty one can't be part of
+    // any other element's probe, so it can be made empty too.
+    if (control_[(index + 1) & (capacity_ - 1)] == kEmpty) {
+      control_[index] = kEmpty;
+    } else {
+      control_[index] = kErased;
+      ++erased_;
+    }
+    --size_;
+  }
+
+  void Rehash(size_t new_capacity) {
+    uint8* old_control = control_;
+    value_type* old_slots = slots_;
+    size_t old_capacity = capacity_;
+
+    control_ = new uint8[new_capacity];
+    memset(control_, kEmpty, new_capacity);
+    slots_ = static_cast<value_type*>(
+        ::operator new(new_capacity * sizeof(value_type)));
+    capacity_ = new_capacity;
+    size_ = 0;
+    erased_ = 0;
+
+    for (size_t i = 0; i < old_capacity; ++i) {
+      if (old_control[i] & kInUse) {
+        Insert(MixFlatHash(hasher_(KeyOf()(old_slots[i]))), old_slots[i]);
+        old_slots[i].~value_type();
+      }
+    }
+    delete[] old_control;
+    ::operator delete(old_slots);
+  }
+
+  void DestroyAll() {
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (control_[i] & kInUse)
+        slots_[i].~value_type();
+    }
+    delete[] control_;
+    ::operator delete(slots_);
+  }
+
+  // A control byte and a slot for each of |capacity_| slots.  Both are NULL
+  // until the first insertion.
+  uint8* control_;
+  value_type* slots_;
+  size_t capacity_;
+  size_t size_;
+  // The number of slots marked kErased.
+  size_t erased_;
+  hasher hasher_;
+  key_equal key_equal_;
+};
+
+template <typename T>
+void FlatHashIterator<T>::SkipUnusedSlots() {
+  while (control_ != control_end_ && !(*control_ & 0x80)) {
+    ++control_;
+    ++slot_;
+  }
+}
+
+}  // namespace internal
+
+template <typename Key, typename Value,
+          typename Hash = BASE_HASH_NAMESPACE::hash<Key>,
+          typename Equal = std::equal_to<Key> >
+class flat_hash_map
+    : public internal::FlatHashTable<
+          std::pair<const Key, Value>, Key,
+          internal::FlatHashSelectFirst<std::pair<const Key, Value> >,
+          Hash, Equal> {
+ public:
+  typedef Value mapped_type;
+
+  Value& operator[](const Key& key) {
+    typename flat_hash_map::iterator it = this->find(key);
+    if (it != this->end())
+      return it->second;
+    return this->insert(std::make_pair(key, Value())).first->second;
+  }
+};
+
+template <typename Key,
+          typename Hash = BASE_HASH_NAMESPACE::hash<Key>,
+          typename Equal = std::equal_to<Key> >
+class flat_hash_set
+    : public internal::FlatHashTable<Key, Key, internal::FlatHashIdentity<Key>,
+                                     Hash, Equal> {
+};
+
+}  // namespace base
+
+#endif  // BASE_FLAT_HASH_MAP_H_
@@ -0,0 +1,109 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/flat_hash_map.h"
+
+#include <string>
+#include <vector>
+
+#include "base/hash_tables.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const int kNumKeys = 100000;
+const int kIterations = 10;
+
+// Inserts |keys| into a |Map|, looks each of them up, looks up as many
+// missing keys, and erases them all again, timing each step.
+template <typename Map>
+void RunMapTest(const char* name,
+                const std::vector<typename Map::key_type>& keys,
+                const std::vector<typename Map::key_type>& missing) {
+  std::string prefix(name);
+  Map map;
+  {
+    PerfTimeLogger timer((prefix + "_insert").c_str());
+    for (int i = 0; i < kIterations; ++i) {
+      map.clear();
+      for (size_t j = 0; j < keys.size(); ++j)
+        map[keys[j]] = static_cast<int>(j);
+    }
+  }
+  EXPECT_EQ(keys.size(), map.size());
+
+  {
+    PerfTimeLogger timer((prefix + "_find_hit").c_str());
+    size_t found = 0;
+    for (int i = 0; i < kIterations; ++i) {
+      for (size_t j = 0; j < keys.size(); ++j)
+        found += map.count(keys[j]);
+    }
+    timer.Done();
+    EXPECT_EQ(keys.size() * kIterations, found);
+  }
+
+  {
+    PerfTimeLogger timer((prefix + "_find_miss").c_str());
+    size_t found = 0;
+    for (int i = 0; i < kIterations; ++i) {
+      for (size_t j = 0; j < missing.size(); ++j)
+        found += map.count(missing[j]);
+    }
+    timer.Done();
+    EXPECT_EQ(0U, found);
+  }
+
+  {
+    PerfTimeLogger timer((prefix + "_iterate").c_str());
+    int sum = 0;
+    for (int i = 0; i < kIterations; ++i) {
+      for (typename Map::const_iterator it = map.begin(); it != map.end();
+           ++it) {
+        sum += it->second;
+      }
+    }
+    timer.Done();
+    EXPECT_NE(0, sum);
+  }
+
+  {
+    PerfTimeLogger timer((prefix + "_erase").c_str());
+    for (size_t j = 0; j < keys.size(); ++j)
+      map.erase(keys[j]);
+  }
+  EXPECT_TRUE(map.empty());
+}
+
+}  // namespace
+
+TEST(FlatHashMapPerfTest, IntKeys) {
+  std::vector<int> keys;
+  std::vector<int> missing;
+  for (int i = 0; i < kNumKeys; ++i) {
+    // Spread out, as GL and PP_Var ids are.
+    keys.push_back(i * 16);
+    missing.push_back(i * 16 + 1);
+  }
+  RunMapTest<hash_map<int, int> >("hash_map_int", keys, missing);
+  RunMapTest<flat_hash_map<int, int> >("flat_hash_map_int", keys, missing);
+}
+
+TEST(FlatHashMapPerfTest, StringKeys) {
+  std::vector<std::string> keys;
+  std::vector<std::string> missing;
+  for (int i = 0; i < kNumKeys; ++i) {
+    keys.push_back(StringPrintf("www.host%d.example.com", i));
+    missing.push_back(StringPrintf("www.missing%d.example.com", i));
+  }
+  RunMapTest<hash_map<std::string, int> >("hash_map_string", keys, missing);
+  RunMapTest<flat_hash_map<std::string, int> >("flat_hash_map_string", keys,
+                                               missing);
+}
+
+}  // namespace base
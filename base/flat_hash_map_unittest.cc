@@ -0,0 +1,186 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/flat_hash_map.h"
+
+#include <map>
+#include <string>
+
+#include "base/stringprintf.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Counts live instances, to check that the table destroys what it builds.
+class Counted {
+ public:
+  Counted() : value_(0) { ++live_; }
+  explicit Counted(int value) : value_(value) { ++live_; }
+  Counted(const Counted& other) : value_(other.value_) { ++live_; }
+  ~Counted() { --live_; }
+
+  int value() const { return value_; }
+
+  static int live() { return live_; }
+
+ private:
+  int value_;
+  static int live_;
+};
+
+int Counted::live_ = 0;
+
+// Sends every key to the same place, so that every lookup probes.
+struct CollidingHash {
+  size_t operator()(int key) const { return 0; }
+};
+
+}  // namespace
+
+TEST(FlatHashMapTest, Basic) {
+  flat_hash_map<int, std::string> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.begin() == map.end());
+  EXPECT_TRUE(map.find(1) == map.end());
+  EXPECT_EQ(0U, map.erase(1));
+
+  EXPECT_TRUE(map.insert(std::make_pair(1, std::string("one"))).second);
+  EXPECT_FALSE(map.insert(std::make_pair(1, std::string("uno"))).second);
+  map[2] = "two";
+  EXPECT_EQ(2U, map.size());
+  EXPECT_EQ("one", map[1]);
+  EXPECT_EQ("two", map.find(2)->second);
+  EXPECT_EQ(1U, map.count(2));
+  EXPECT_EQ(0U, map.count(3));
+
+  EXPECT_EQ(1U, map.erase(1));
+  EXPECT_EQ(1U, map.size());
+  EXPECT_TRUE(map.find(1) == map.end());
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.find(2) == map.end());
+}
+
+TEST(FlatHashMapTest, ManyElements) {
+  flat_hash_map<std::string, int> map;
+  std::map<std::string, int> expected;
+  const int kCount = 10000;
+  for (int i = 0; i < kCount; ++i) {
+    std::string key = StringPrintf("key%d", i);
+    map[key] = i;
+    expected[key] = i;
+  }
+  // Erase every third element and put back half of them.
+  for (int i = 0; i < kCount; i += 3) {
+    std::string key = StringPrintf("key%d", i);
+    EXPECT_EQ(1U, map.erase(key));
+    expected.erase(key);
+  }
+  for (int i = 0; i < kCount; i += 6) {
+    std::string key = StringPrintf("key%d", i);
+    map[key] = -i;
+    expected[key] = -i;
+  }
+
+  ASSERT_EQ(expected.size(), map.size());
+  size_t visited = 0;
+  for (flat_hash_map<std::string, int>::const_iterator it = map.begin();
+       it != map.end(); ++it) {
+    EXPECT_EQ(expected[it->first], it->second);
+    ++visited;
+  }
+  EXPECT_EQ(expected.size(), visited);
+  for (int i = 0; i < kCount; ++i) {
+    std::string key = StringPrintf("key%d", i);
+    EXPECT_EQ(expected.count(key), map.count(key)) << key;
+  }
+}
+
+TEST(FlatHashMapTest, EraseWhileIterating) {
+  flat_hash_map<int, int, CollidingHash> map;
+  for (int i = 0; i < 100; ++i)
+    map[i] = i;
+  for (flat_hash_map<int, int, CollidingHash>::iterator it = map.begin();
+       it != map.end(); ) {
+    if (it->first % 2)
+      map.erase(it++);
+    else
+      ++it;
+  }
+  EXPECT_EQ(50U, map.size());
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(i % 2 ? 0U : 1U, map.count(i));
+
+  // Erased slots are reused.
+  for (int i = 1; i < 100; i += 2)
+    map[i] = i;
+  EXPECT_EQ(100U, map.size());
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(i, map[i]);
+}
+
+TEST(FlatHashMapTest, CopyAndSwap) {
+  flat_hash_map<int, int> map;
+  for (int i = 0; i < 100; ++i)
+    map[i] = i * i;
+  flat_hash_map<int, int> copy(map);
+  flat_hash_map<int, int> assigned;
+  assigned[-1] = 1;
+  assigned = copy;
+  map.clear();
+  EXPECT_EQ(100U, copy.size());
+  EXPECT_EQ(100U, assigned.size());
+  EXPECT_EQ(0U, assigned.count(-1));
+  EXPECT_EQ(81, copy[9]);
+  EXPECT_EQ(81, assigned[9]);
+
+  map.swap(copy);
+  EXPECT_TRUE(copy.empty());
+  EXPECT_EQ(81, map[9]);
+}
+
+TEST(FlatHashMapTest, Reserve) {
+  flat_hash_map<int, int> map;
+  map.reserve(1000);
+  size_t capacity = map.capacity();
+  EXPECT_LE(1000U, capacity);
+  for (int i = 0; i < 1000; ++i)
+    map[i] = i;
+  EXPECT_EQ(capacity, map.capacity());
+}
+
+TEST(FlatHashMapTest, DestroysElements) {
+  {
+    flat_hash_map<int, Counted> map;
+    for (int i = 0; i < 100; ++i)
+      map.insert(std::make_pair(i, Counted(i)));
+    EXPECT_EQ(100, Counted::live());
+    map.erase(5);
+    EXPECT_EQ(99, Counted::live());
+    EXPECT_EQ(7, map[7].value());
+    flat_hash_map<int, Counted> copy(map);
+    EXPECT_EQ(198, Counted::live());
+    copy.clear();
+    EXPECT_EQ(99, Counted::live());
+  }
+  EXPECT_EQ(0, Counted::live());
+}
+
+TEST(FlatHashSetTest, Basic) {
+  flat_hash_set<std::string> set;
+  EXPECT_TRUE(set.insert("a").second);
+  EXPECT_TRUE(set.insert("b").second);
+  EXPECT_FALSE(set.insert("a").second);
+  EXPECT_EQ(2U, set.size());
+  EXPECT_EQ("b", *set.find("b"));
+  EXPECT_TRUE(set.find("c") == set.end());
+  set.erase(set.find("a"));
+  EXPECT_EQ(0U, set.count("a"));
+  EXPECT_EQ(1U, set.size());
+}
+
+}  // namespace base
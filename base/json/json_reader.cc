@@ -4,6 +4,10 @@
 
 #include "base/json/json_reader.h"
 
+#include <vector>
+
+#include "base/compact_value.h"
+#include "base/compiler_specific.h"
 #include "base/float_util.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
@@ -65,6 +69,293 @@ bool ReadHexDigits(base::JSONReader::Token& token, int digits) {
 
 namespace base {
 
+namespace {
+
+// Builds a Value tree from the events of a parse.
+class ValueBuilder : public JSONReader::Delegate {
+ public:
+  ValueBuilder() {}
+  virtual ~ValueBuilder() {}
+
+  // Returns the root, which the caller takes ownership of.
+  Value* Release() { return root_.release(); }
+
+  virtual bool OnNull() OVERRIDE {
+    return Add(Value::CreateNullValue());
+  }
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    return Add(Value::CreateBooleanValue(value));
+  }
+  virtual bool OnInteger(int value) OVERRIDE {
+    return Add(Value::CreateIntegerValue(value));
+  }
+  virtual bool OnDouble(double value) OVERRIDE {
+    return Add(Value::CreateDoubleValue(value));
+  }
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    return Add(Value::CreateStringValue(value.as_string()));
+  }
+
+  virtual bool OnListBegin() OVERRIDE {
+    ListValue* list = new ListValue;
+    Add(list);
+    containers_.push_back(list);
+    return true;
+  }
+  virtual bool OnListEnd() OVERRIDE {
+    containers_.pop_back();
+    return true;
+  }
+
+  virtual bool OnDictionaryBegin() OVERRIDE {
+    DictionaryValue* dictionary = new DictionaryValue;
+    Add(dictionary);
+    containers_.push_back(dictionary);
+    return true;
+  }
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    key.CopyToString(&key_);
+    return true;
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE {
+    containers_.pop_back();
+    return true;
+  }
+
+ private:
+  // Adds |value| to the innermost open container, or makes it the root.
+  // Containers are linked into the tree as soon as they are begun, so a
+  // failed parse only has to delete |root_|.
+  bool Add(Value* value) {
+    if (containers_.empty()) {
+      DCHECK(!root_.get());
+      root_.reset(value);
+    } else if (containers_.back()->IsType(Value::TYPE_LIST)) {
+      static_cast<ListValue*>(containers_.back())->Append(value);
+    } else {
+      static_cast<DictionaryValue*>(containers_.back())->
+          SetWithoutPathExpansion(key_, value);
+    }
+    return true;
+  }
+
+  scoped_ptr<Value> root_;
+  std::vector<Value*> containers_;
+
+  // The key for the next value added to a dictionary.
+  std::string key_;
+
+  DISALLOW_COPY_AND_ASSIGN(ValueBuilder);
+};
+
+// Builds a CompactValue from the events of a parse.
+class CompactValueBuilder : public JSONReader::Delegate {
+ public:
+  explicit CompactValueBuilder(CompactValue* root) : next_(root) {}
+  virtual ~CompactValueBuilder() {}
+
+  virtual bool OnNull() OVERRIDE {
+    return Add(CompactValue());
+  }
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    return Add(CompactValue(value));
+  }
+  virtual bool OnInteger(int value) OVERRIDE {
+    return Add(CompactValue(value));
+  }
+  virtual bool OnDouble(double value) OVERRIDE {
+    return Add(CompactValue(value));
+  }
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    return Add(CompactValue(value));
+  }
+
+  virtual bool OnListBegin() OVERRIDE {
+    containers_.push_back(Add(CompactValue::CreateList()));
+    return true;
+  }
+  virtual bool OnListEnd() OVERRIDE {
+    containers_.pop_back();
+    return true;
+  }
+
+  virtual bool OnDictionaryBegin() OVERRIDE {
+    containers_.push_back(Add(CompactValue::CreateDictionary()));
+    return true;
+  }
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    next_ = containers_.back()->SetKey(key);
+    return true;
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE {
+    containers_.pop_back();
+    return true;
+  }
+
+ private:
+  // Moves |value| into the slot for the next value: the root, the slot for
+  // the last dictionary key, or a new list item.  A container's children are
+  // only added while it is the innermost open container, so the pointers in
+  // |containers_| stay valid.
+  CompactValue* Add(CompactValue value) {
+    CompactValue* slot = next_;
+    if (!slot)
+      slot = containers_.back()->Append();
+    next_ = NULL;
+    slot->Swap(&value);
+    return slot;
+  }
+
+  CompactValue* next_;
+  std::vector<CompactValue*> containers_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompactValueBuilder);
+};
+
+// Builds a Value from only the part of a parse found at a path of dictionary
+// keys, ignoring the events for everything else.
+class SubtreeBuilder : public JSONReader::Delegate {
+ public:
+  explicit SubtreeBuilder(const std::string& path)
+      : depth_(0),
+        path_depth_(0),
+        next_value_on_path_(true),
+        subtree_depth_(0) {
+    if (!path.empty())
+      Tokenize(path, ".", &path_);
+  }
+  virtual ~SubtreeBuilder() {}
+
+  // Returns the subtree, if one was found.
+  Value* Release() { return subtree_.release(); }
+
+  virtual bool OnNull() OVERRIDE {
+    if (BeginValue())
+      builder_->OnNull();
+    return EndValue();
+  }
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    if (BeginValue())
+      builder_->OnBoolean(value);
+    return EndValue();
+  }
+  virtual bool OnInteger(int value) OVERRIDE {
+    if (BeginValue())
+      builder_->OnInteger(value);
+    return EndValue();
+  }
+  virtual bool OnDouble(double value) OVERRIDE {
+    if (BeginValue())
+      builder_->OnDouble(value);
+    return EndValue();
+  }
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    if (BeginValue())
+      builder_->OnString(value);
+    return EndValue();
+  }
+
+  virtual bool OnListBegin() OVERRIDE {
+    if (BeginValue()) {
+      builder_->OnListBegin();
+      ++subtree_depth_;
+    } else {
+      ++depth_;
+    }
+    next_value_on_path_ = false;
+    return true;
+  }
+  virtual bool OnListEnd() OVERRIDE {
+    return EndContainer(&ValueBuilder::OnListEnd);
+  }
+
+  virtual bool OnDictionaryBegin() OVERRIDE {
+    bool on_path = next_value_on_path_;
+    if (BeginValue()) {
+      builder_->OnDictionaryBegin();
+      ++subtree_depth_;
+    } else {
+      if (on_path && depth_ == path_depth_)
+        ++path_depth_;
+      ++depth_;
+    }
+    next_value_on_path_ = false;
+    return true;
+  }
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    if (subtree_depth_) {
+      builder_->OnDictionaryKey(key);
+    } else if (depth_ == path_depth_) {
+      DCHECK_GT(path_depth_, 0u);
+      next_value_on_path_ = (key == path_[path_depth_ - 1]);
+    }
+    return true;
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE {
+    return EndContainer(&ValueBuilder::OnDictionaryEnd);
+  }
+
+ private:
+  typedef bool (ValueBuilder::*EndMethod)();
+
+  // Returns true if the value being begun belongs in the subtree, starting a
+  // new subtree if it is the value at the end of the path.
+  bool BeginValue() {
+    if (subtree_depth_)
+      return true;
+    if (!next_value_on_path_ || path_depth_ != path_.size())
+      return false;
+    // A later duplicate key replaces an earlier one, as in DictionaryValue.
+    builder_.reset(new ValueBuilder);
+    return true;
+  }
+
+  // Called after each scalar value.
+  bool EndValue() {
+    next_value_on_path_ = false;
+    if (!subtree_depth_ && builder_.get()) {
+      subtree_.reset(builder_->Release());
+      builder_.reset();
+    }
+    return true;
+  }
+
+  bool EndContainer(EndMethod end) {
+    if (subtree_depth_) {
+      (builder_.get()->*end)();
+      if (--subtree_depth_ == 0) {
+        subtree_.reset(builder_->Release());
+        builder_.reset();
+      }
+      return true;
+    }
+    if (depth_ == path_depth_)
+      --path_depth_;
+    --depth_;
+    return true;
+  }
+
+  std::vector<std::string> path_;
+
+  // The number of containers currently open outside the subtree, and how
+  // many of those (from the root down) are the dictionaries along |path_|.
+  size_t depth_;
+  size_t path_depth_;
+
+  // Whether the next value is the one for the next key on |path_|.
+  bool next_value_on_path_;
+
+  // Builds the subtree while |subtree_depth_| containers of it are open.
+  scoped_ptr<ValueBuilder> builder_;
+  size_t subtree_depth_;
+
+  scoped_ptr<Value> subtree_;
+
+  DISALLOW_COPY_AND_ASSIGN(SubtreeBuilder);
+};
+
+}  // namespace
+
 const char* JSONReader::kBadRootElementType =
     "Root value must be an array or object.";
 const char* JSONReader::kInvalidEscape =
@@ -88,6 +379,8 @@ JSONReader::JSONReader()
       end_pos_(NULL),
       stack_depth_(0),
       allow_trailing_comma_(false),
+      delegate_(NULL),
+      stopped_(false),
       error_code_(JSON_NO_ERROR),
       error_line_(0),
       error_col_(0) {}
@@ -122,6 +415,34 @@ Value* JSONReader::ReadAndReturnError(const std::string& json,
   return NULL;
 }
 
+// static
+Value* JSONReader::ReadPath(const std::string& json,
+                            const std::string& path,
+                            int options) {
+  JSONReader reader = JSONReader();
+  SubtreeBuilder builder(path);
+  if (!reader.Parse(json, false, (options & JSON_ALLOW_TRAILING_COMMAS) != 0,
+                    &builder)) {
+    return NULL;
+  }
+  return builder.Release();
+}
+
+// static
+bool JSONReader::ReadToCompactValue(const std::string& json,
+                                    int options,
+                                    CompactValue* value) {
+  JSONReader reader = JSONReader();
+  CompactValue root;
+  CompactValueBuilder builder(&root);
+  if (!reader.Parse(json, false, (options & JSON_ALLOW_TRAILING_COMMAS) != 0,
+                    &builder)) {
+    return false;
+  }
+  value->Swap(&root);
+  return true;
+}
+
 // static
 std::string JSONReader::ErrorCodeToString(JsonParseError error_code) {
   switch (error_code) {
@@ -156,10 +477,18 @@ std::string JSONReader::GetErrorMessage() const {
 
 Value* JSONReader::JsonToValue(const std::string& json, bool check_root,
                                bool allow_trailing_comma) {
+  ValueBuilder builder;
+  if (!Parse(json, check_root, allow_trailing_comma, &builder))
+    return NULL;
+  return builder.Release();
+}
+
+bool JSONReader::Parse(const std::string& json, bool check_root,
+                       bool allow_trailing_comma, Delegate* delegate) {
   // The input must be in UTF-8.
   if (!IsStringUTF8(json.data())) {
     error_code_ = JSON_UNSUPPORTED_ENCODING;
-    return NULL;
+    return false;
   }
 
   start_pos_ = json.data();
@@ -167,8 +496,8 @@ Value* JSONReader::JsonToValue(const std::string& json, bool check_root,
 
   // When the input JSON string starts with a UTF-8 Byte-Order-Mark (U+FEFF)
   // or <0xEF 0xBB 0xBF>, advance the start position to avoid the
-  // JSONReader::BuildValue() function from mis-treating a Unicode BOM as an
-  // invalid character and returning NULL.
+  // JSONReader::ParseValue() function from mis-treating a Unicode BOM as an
+  // invalid character and failing.
   if (json.size() >= 3 && static_cast<uint8>(start_pos_[0]) == 0xEF &&
       static_cast<uint8>(start_pos_[1]) == 0xBB &&
       static_cast<uint8>(start_pos_[2]) == 0xBF) {
@@ -178,22 +507,27 @@ Value* JSONReader::JsonToValue(const std::string& json, bool check_root,
   json_pos_ = start_pos_;
   allow_trailing_comma_ = allow_trailing_comma;
   stack_depth_ = 0;
+  delegate_ = delegate;
+  stopped_ = false;
   error_code_ = JSON_NO_ERROR;
 
-  scoped_ptr<Value> root(BuildValue(check_root));
-  if (root.get()) {
-    if (ParseToken().type == Token::END_OF_INPUT) {
-      return root.release();
-    } else {
-      SetErrorCode(JSON_UNEXPECTED_DATA_AFTER_ROOT, json_pos_);
-    }
+  bool success = ParseValue(check_root);
+  delegate_ = NULL;
+  if (success) {
+    if (ParseToken().type == Token::END_OF_INPUT)
+      return true;
+    SetErrorCode(JSON_UNEXPECTED_DATA_AFTER_ROOT, json_pos_);
   }
 
+  // A delegate stopping the parse is not an error in the input.
+  if (stopped_)
+    return false;
+
   // Default to calling errors "syntax errors".
   if (error_code_ == 0)
     SetErrorCode(JSON_SYNTAX_ERROR, json_pos_);
 
-  return NULL;
+  return false;
 }
 
 // static
@@ -206,11 +540,11 @@ std::string JSONReader::FormatErrorMessage(int line, int column,
   return description;
 }
 
-Value* JSONReader::BuildValue(bool is_root) {
+bool JSONReader::ParseValue(bool is_root) {
   ++stack_depth_;
   if (stack_depth_ > kStackLimit) {
     SetErrorCode(JSON_TOO_MUCH_NESTING, json_pos_);
-    return NULL;
+    return false;
   }
 
   Token token = ParseToken();
@@ -218,51 +552,53 @@ Value* JSONReader::BuildValue(bool is_root) {
   if (is_root && token.type != Token::OBJECT_BEGIN &&
       token.type != Token::ARRAY_BEGIN) {
     SetErrorCode(JSON_BAD_ROOT_ELEMENT_TYPE, json_pos_);
-    return NULL;
+    return false;
   }
 
-  scoped_ptr<Value> node;
-
   switch (token.type) {
     case Token::END_OF_INPUT:
     case Token::INVALID_TOKEN:
-      return NULL;
+      return false;
 
     case Token::NULL_TOKEN:
-      node.reset(Value::CreateNullValue());
+      if (!delegate_->OnNull())
+        return Stop();
       break;
 
     case Token::BOOL_TRUE:
-      node.reset(Value::CreateBooleanValue(true));
+      if (!delegate_->OnBoolean(true))
+        return Stop();
       break;
 
     case Token::BOOL_FALSE:
-      node.reset(Value::CreateBooleanValue(false));
+      if (!delegate_->OnBoolean(false))
+        return Stop();
       break;
 
     case Token::NUMBER:
-      node.reset(DecodeNumber(token));
-      if (!node.get())
-        return NULL;
+      if (!DecodeNumber(token))
+        return false;
       break;
 
-    case Token::STRING:
-      node.reset(DecodeString(token));
-      if (!node.get())
-        return NULL;
+    case Token::STRING: {
+      StringPiece value;
+      if (!DecodeString(token, &value))
+        return false;
+      if (!delegate_->OnString(value))
+        return Stop();
       break;
+    }
 
     case Token::ARRAY_BEGIN:
       {
         json_pos_ += token.length;
         token = ParseToken();
 
-        node.reset(new ListValue());
+        if (!delegate_->OnListBegin())
+          return Stop();
         while (token.type != Token::ARRAY_END) {
-          Value* array_node = BuildValue(false);
-          if (!array_node)
-            return NULL;
-          static_cast<ListValue*>(node.get())->Append(array_node);
+          if (!ParseValue(false))
+            return false;
 
           // After a list value, we expect a comma or the end of the list.
           token = ParseToken();
@@ -274,19 +610,21 @@ Value* JSONReader::BuildValue(bool is_root) {
             if (token.type == Token::ARRAY_END) {
               if (!allow_trailing_comma_) {
                 SetErrorCode(JSON_TRAILING_COMMA, json_pos_);
-                return NULL;
+                return false;
               }
               // Trailing comma OK, stop parsing the Array.
               break;
             }
           } else if (token.type != Token::ARRAY_END) {
             // Unexpected value after list value.  Bail out.
-            return NULL;
+            return false;
           }
         }
         if (token.type != Token::ARRAY_END) {
-          return NULL;
+          return false;
         }
+        if (!delegate_->OnListEnd())
+          return Stop();
         break;
       }
 
@@ -295,33 +633,31 @@ Value* JSONReader::BuildValue(bool is_root) {
         json_pos_ += token.length;
         token = ParseToken();
 
-        node.reset(new DictionaryValue);
+        if (!delegate_->OnDictionaryBegin())
+          return Stop();
         while (token.type != Token::OBJECT_END) {
           if (token.type != Token::STRING) {
             SetErrorCode(JSON_UNQUOTED_DICTIONARY_KEY, json_pos_);
-            return NULL;
+            return false;
           }
-          scoped_ptr<Value> dict_key_value(DecodeString(token));
-          if (!dict_key_value.get())
-            return NULL;
-
-          // Convert the key into a wstring.
-          std::string dict_key;
-          bool success = dict_key_value->GetAsString(&dict_key);
-          DCHECK(success);
+          StringPiece dict_key;
+          if (!DecodeString(token, &dict_key))
+            return false;
 
           json_pos_ += token.length;
           token = ParseToken();
           if (token.type != Token::OBJECT_PAIR_SEPARATOR)
-            return NULL;
+            return false;
+
+          // Report the key only once it is known to be followed by a value,
+          // and before the value overwrites |decoded_string_|.
+          if (!delegate_->OnDictionaryKey(dict_key))
+            return Stop();
 
           json_pos_ += token.length;
           token = ParseToken();
-          Value* dict_value = BuildValue(false);
-          if (!dict_value)
-            return NULL;
-          static_cast<DictionaryValue*>(node.get())->SetWithoutPathExpansion(
-              dict_key, dict_value);
+          if (!ParseValue(false))
+            return false;
 
           // After a key/value pair, we expect a comma or the end of the
           // object.
@@ -334,30 +670,37 @@ Value* JSONReader::BuildValue(bool is_root) {
             if (token.type == Token::OBJECT_END) {
               if (!allow_trailing_comma_) {
                 SetErrorCode(JSON_TRAILING_COMMA, json_pos_);
-                return NULL;
+                return false;
               }
               // Trailing comma OK, stop parsing the Object.
               break;
             }
           } else if (token.type != Token::OBJECT_END) {
             // Unexpected value after last object value.  Bail out.
-            return NULL;
+            return false;
           }
         }
         if (token.type != Token::OBJECT_END)
-          return NULL;
+          return false;
+        if (!delegate_->OnDictionaryEnd())
+          return Stop();
 
         break;
       }
 
     default:
       // We got a token that's not a value.
-      return NULL;
+      return false;
   }
   json_pos_ += token.length;
 
   --stack_depth_;
-  return node.release();
+  return true;
+}
+
+bool JSONReader::Stop() {
+  stopped_ = true;
+  return false;
 }
 
 JSONReader::Token JSONReader::ParseNumberToken() {
@@ -397,18 +740,25 @@ JSONReader::Token JSONReader::ParseNumberToken() {
   return token;
 }
 
-Value* JSONReader::DecodeNumber(const Token& token) {
-  const std::string num_string(token.begin, token.length);
+bool JSONReader::DecodeNumber(const Token& token) {
+  const StringPiece num_string(token.begin, token.length);
 
   int num_int;
-  if (StringToInt(num_string, &num_int))
-    return Value::CreateIntegerValue(num_int);
+  if (StringToInt(num_string, &num_int)) {
+    if (!delegate_->OnInteger(num_int))
+      return Stop();
+    return true;
+  }
 
   double num_double;
-  if (StringToDouble(num_string, &num_double) && base::IsFinite(num_double))
-    return Value::CreateDoubleValue(num_double);
+  if (StringToDouble(num_string.as_string(), &num_double) &&
+      base::IsFinite(num_double)) {
+    if (!delegate_->OnDouble(num_double))
+      return Stop();
+    return true;
+  }
 
-  return NULL;
+  return false;
 }
 
 JSONReader::Token JSONReader::ParseStringToken() {
@@ -456,8 +806,16 @@ JSONReader::Token JSONReader::ParseStringToken() {
   return Token::CreateInvalidToken();
 }
 
-Value* JSONReader::DecodeString(const Token& token) {
-  std::string decoded_str;
+bool JSONReader::DecodeString(const Token& token, StringPiece* value) {
+  // Most strings have no escapes, and can be handed out in place.
+  StringPiece contents(token.begin + 1, token.length - 2);
+  if (contents.find('\\') == StringPiece::npos) {
+    *value = contents;
+    return true;
+  }
+
+  std::string& decoded_str = decoded_string_;
+  decoded_str.clear();
   decoded_str.reserve(token.length - 2);
 
   for (int i = 1; i < token.length - 1; ++i) {
@@ -492,31 +850,32 @@ Value* JSONReader::DecodeString(const Token& token) {
 
         case 'x': {
           if (i + 2 >= token.length)
-            return NULL;
+            return false;
           int hex_digit = 0;
           if (!HexStringToInt(StringPiece(token.begin + i + 1, 2), &hex_digit))
-            return NULL;
+            return false;
           decoded_str.push_back(hex_digit);
           i += 2;
           break;
         }
         case 'u':
           if (!ConvertUTF16Units(token, &i, &decoded_str))
-            return NULL;
+            return false;
           break;
 
         default:
           // We should only have valid strings at this point.  If not,
           // ParseStringToken didn't do its job.
           NOTREACHED();
-          return NULL;
+          return false;
       }
     } else {
       // Not escaped
       decoded_str.push_back(c);
     }
   }
-  return Value::CreateStringValue(decoded_str);
+  *value = decoded_str;
+  return true;
 }
 
 bool JSONReader::ConvertUTF16Units(const Token& token,
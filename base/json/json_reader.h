@@ -3,7 +3,8 @@
 // found in the LICENSE file.
 //
 // A JSON parser.  Converts strings of JSON into a Value object (see
-// base/values.h).
+// base/values.h), or reports them piece by piece to a JSONReader::Delegate
+// without building any Values at all.
 // http://www.ietf.org/rfc/rfc4627.txt?number=4627
 //
 // Known limitations/deviations from the RFC:
@@ -33,6 +34,7 @@
 
 #include "base/base_export.h"
 #include "base/basictypes.h"
+#include "base/string_piece.h"
 
 // Chromium and Chromium OS check out gtest to different places, so we're
 // unable to compile on both if we include gtest_prod.h here.  Instead, include
@@ -48,6 +50,7 @@ friend class test_case_name##_##test_name##_Test
 
 namespace base {
 
+class CompactValue;
 class Value;
 
 enum JSONParserOptions {
@@ -101,6 +104,33 @@ class BASE_EXPORT JSONReader {
     int length;
   };
 
+  // Receives a JSON document from Parse() as a stream of events, in document
+  // order, so that callers which only need part of a document (or which
+  // convert it to something other than Values) don't pay for building and
+  // then discarding a whole Value tree.  Each method returns false to stop
+  // parsing.  The StringPieces point into the input, except for strings
+  // that contain escape sequences, which are decoded into a buffer that is
+  // only valid for the duration of the call.
+  class BASE_EXPORT Delegate {
+   public:
+    virtual bool OnNull() = 0;
+    virtual bool OnBoolean(bool value) = 0;
+    virtual bool OnInteger(int value) = 0;
+    virtual bool OnDouble(double value) = 0;
+    virtual bool OnString(const StringPiece& value) = 0;
+
+    virtual bool OnListBegin() = 0;
+    virtual bool OnListEnd() = 0;
+
+    // Each value in a dictionary is preceded by its key.
+    virtual bool OnDictionaryBegin() = 0;
+    virtual bool OnDictionaryKey(const StringPiece& key) = 0;
+    virtual bool OnDictionaryEnd() = 0;
+
+   protected:
+    virtual ~Delegate() {}
+  };
+
   // Error codes during parsing.
   enum JsonParseError {
     JSON_NO_ERROR = 0,
@@ -144,6 +174,21 @@ class BASE_EXPORT JSONReader {
                                    int* error_code_out,
                                    std::string* error_msg_out);
 
+  // Reads and parses |json| like Read(), but only builds the Value found at
+  // |path| (a series of dictionary keys separated by '.', as for
+  // DictionaryValue::Get()), skipping over everything else without any
+  // allocations.  Returns NULL if |json| is not properly formed or if there
+  // is nothing at |path|.
+  static Value* ReadPath(const std::string& json,
+                         const std::string& path,
+                         int options);  // JSONParserOptions
+
+  // Reads and parses |json| like Read(), but into a CompactValue.  Returns
+  // false, leaving |value| unchanged, if |json| is not properly formed.
+  static bool ReadToCompactValue(const std::string& json,
+                                 int options,  // JSONParserOptions
+                                 CompactValue* value);
+
   // Converts a JSON parse error code into a human readable message.
   // Returns an empty string if error_code is JSON_NO_ERROR.
   static std::string ErrorCodeToString(JsonParseError error_code);
@@ -166,6 +211,13 @@ class BASE_EXPORT JSONReader {
   Value* JsonToValue(const std::string& json, bool check_root,
                      bool allow_trailing_comma);
 
+  // Parses |json| as JsonToValue() does, but reports its contents to
+  // |delegate| instead of building a Value.  Returns true if |json| is
+  // properly formed and the delegate never stopped parsing.
+  // |json| must outlive the call, since the delegate is handed pieces of it.
+  bool Parse(const std::string& json, bool check_root,
+             bool allow_trailing_comma, Delegate* delegate);
+
  private:
   FRIEND_TEST_ALL_PREFIXES(JSONReaderTest, Reading);
   FRIEND_TEST_ALL_PREFIXES(JSONReaderTest, ErrorMessages);
@@ -173,10 +225,14 @@ class BASE_EXPORT JSONReader {
   static std::string FormatErrorMessage(int line, int column,
                                         const std::string& description);
 
-  // Recursively build Value.  Returns NULL if we don't have a valid JSON
-  // string.  If |is_root| is true, we verify that the root element is either
-  // an object or an array.
-  Value* BuildValue(bool is_root);
+  // Recursively parse a value, reporting it to |delegate_|.  Returns false if
+  // we don't have a valid JSON string or the delegate stopped parsing.  If
+  // |is_root| is true, we verify that the root element is either an object or
+  // an array.
+  bool ParseValue(bool is_root);
+
+  // Records that |delegate_| asked to stop parsing and returns false.
+  bool Stop();
 
   // Parses a sequence of characters into a Token::NUMBER. If the sequence of
   // characters is not a valid number, returns a Token::INVALID_TOKEN. Note
@@ -185,8 +241,9 @@ class BASE_EXPORT JSONReader {
   Token ParseNumberToken();
 
   // Try and convert the substring that token holds into an int or a double. If
-  // we can (ie., no overflow), return the value, else return NULL.
-  Value* DecodeNumber(const Token& token);
+  // we can (ie., no overflow), report it to |delegate_| and return true, else
+  // return false.
+  bool DecodeNumber(const Token& token);
 
   // Parses a sequence of characters into a Token::STRING. If the sequence of
   // characters is not a valid string, returns a Token::INVALID_TOKEN. Note
@@ -194,9 +251,10 @@ class BASE_EXPORT JSONReader {
   // actual wstring.
   Token ParseStringToken();
 
-  // Convert the substring into a value string.  This should always succeed
-  // (otherwise ParseStringToken would have failed).
-  Value* DecodeString(const Token& token);
+  // Convert the substring into a value string, which points either into the
+  // input or, if there were escape sequences, into |decoded_string_|.  This
+  // should always succeed (otherwise ParseStringToken would have failed).
+  bool DecodeString(const Token& token, StringPiece* value);
 
   // Helper function for DecodeString that consumes UTF16 [0,2] code units and
   // convers them to UTF8 code untis.  |token| is the string token in which the
@@ -242,6 +300,15 @@ class BASE_EXPORT JSONReader {
   // A parser flag that allows trailing commas in objects and arrays.
   bool allow_trailing_comma_;
 
+  // Receives the values being parsed.
+  Delegate* delegate_;
+
+  // True once |delegate_| has asked to stop parsing.
+  bool stopped_;
+
+  // Holds the most recently decoded string that contained escape sequences.
+  std::string decoded_string_;
+
   // Contains the error code for the last call to JsonToValue(), if any.
   JsonParseError error_code_;
   int error_line_;
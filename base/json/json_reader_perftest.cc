@@ -0,0 +1,131 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_reader.h"
+
+#include <string>
+
+#include "base/compiler_specific.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const int kNumFolders = 200;
+const int kBookmarksPerFolder = 100;
+const int kIterations = 5;
+
+// Builds a document shaped like a Bookmarks file, with "roots.bookmark_bar"
+// holding most of the bookmarks and a small "roots.other" at the end.
+std::string CreateBookmarksJSON() {
+  std::string json("{\n   \"checksum\": \"0123456789abcdef\",\n"
+                   "   \"roots\": {\n      \"bookmark_bar\": {\n"
+                   "         \"children\": [ ");
+  int id = 1;
+  for (int folder = 0; folder < kNumFolders; ++folder) {
+    if (folder)
+      json += ", ";
+    json += "{\n            \"children\": [ ";
+    for (int i = 0; i < kBookmarksPerFolder; ++i, ++id) {
+      if (i)
+        json += ", ";
+      StringAppendF(&json,
+          "{\n               \"date_added\": \"129%014d\",\n"
+          "               \"id\": \"%d\",\n"
+          "               \"name\": \"Bookmark %d \\u2014 \\\"title\\\"\",\n"
+          "               \"type\": \"url\",\n"
+          "               \"url\": \"http://www.example.com/%d/path?q=%d\"\n"
+          "            }", id, id, id, folder, i);
+    }
+    StringAppendF(&json,
+        " ],\n            \"date_added\": \"129%014d\",\n"
+        "            \"date_modified\": \"0\",\n"
+        "            \"id\": \"%d\",\n"
+        "            \"name\": \"Folder %d\",\n"
+        "            \"type\": \"folder\"\n         }", id, id, folder);
+    ++id;
+  }
+  json += " ],\n         \"date_added\": \"0\",\n"
+          "         \"date_modified\": \"0\",\n"
+          "         \"id\": \"1\",\n         \"name\": \"Bookmarks bar\",\n"
+          "         \"type\": \"folder\"\n      },\n"
+          "      \"other\": {\n         \"children\": [ ],\n"
+          "         \"date_added\": \"0\",\n"
+          "         \"date_modified\": \"0\",\n"
+          "         \"id\": \"2\",\n         \"name\": \"Other bookmarks\",\n"
+          "         \"type\": \"folder\"\n      }\n   },\n"
+          "   \"version\": 1\n}\n";
+  return json;
+}
+
+// Counts events without building anything.
+class CountingDelegate : public JSONReader::Delegate {
+ public:
+  CountingDelegate() : count_(0) {}
+  virtual ~CountingDelegate() {}
+
+  int count() const { return count_; }
+
+  virtual bool OnNull() OVERRIDE { return Count(); }
+  virtual bool OnBoolean(bool value) OVERRIDE { return Count(); }
+  virtual bool OnInteger(int value) OVERRIDE { return Count(); }
+  virtual bool OnDouble(double value) OVERRIDE { return Count(); }
+  virtual bool OnString(const StringPiece& value) OVERRIDE { return Count(); }
+  virtual bool OnListBegin() OVERRIDE { return Count(); }
+  virtual bool OnListEnd() OVERRIDE { return Count(); }
+  virtual bool OnDictionaryBegin() OVERRIDE { return Count(); }
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    return Count();
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE { return Count(); }
+
+ private:
+  bool Count() {
+    ++count_;
+    return true;
+  }
+
+  int count_;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingDelegate);
+};
+
+}  // namespace
+
+TEST(JSONReaderPerfTest, Bookmarks) {
+  const std::string json(CreateBookmarksJSON());
+  LOG(INFO) << "Bookmarks JSON is " << json.size() << " bytes";
+
+  PerfTimeLogger read_timer("JSONReader_Read");
+  for (int i = 0; i < kIterations; ++i) {
+    scoped_ptr<Value> root(JSONReader::Read(json));
+    ASSERT_TRUE(root.get());
+  }
+  read_timer.Done();
+
+  PerfTimeLogger parse_timer("JSONReader_Parse");
+  for (int i = 0; i < kIterations; ++i) {
+    CountingDelegate delegate;
+    ASSERT_TRUE(JSONReader().Parse(json, false, false, &delegate));
+    EXPECT_LT(0, delegate.count());
+  }
+  parse_timer.Done();
+
+  PerfTimeLogger read_path_timer("JSONReader_ReadPath");
+  for (int i = 0; i < kIterations; ++i) {
+    scoped_ptr<Value> other(
+        JSONReader::ReadPath(json, "roots.other", JSON_PARSE_RFC));
+    ASSERT_TRUE(other.get());
+    ASSERT_TRUE(other->IsType(Value::TYPE_DICTIONARY));
+  }
+  read_path_timer.Done();
+}
+
+}  // namespace base
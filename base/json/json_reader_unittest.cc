@@ -4,10 +4,13 @@
 
 #include "base/json/json_reader.h"
 
+#include <vector>
+
 #include "base/base_paths.h"
 #include "base/file_util.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/path_service.h"
+#include "base/string_number_conversions.h"
 #include "base/string_piece.h"
 #include "base/utf_string_conversions.h"
 #include "base/values.h"
@@ -16,6 +19,58 @@
 
 namespace base {
 
+namespace {
+
+// Records the events of a parse as a string, and stops parsing after a given
+// number of events.
+class RecordingDelegate : public JSONReader::Delegate {
+ public:
+  explicit RecordingDelegate(int max_events) : max_events_(max_events) {}
+  virtual ~RecordingDelegate() {}
+
+  const std::string& events() const { return events_; }
+  const std::vector<StringPiece>& strings() const { return strings_; }
+
+  virtual bool OnNull() OVERRIDE { return Record("null"); }
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    return Record(value ? "true" : "false");
+  }
+  virtual bool OnInteger(int value) OVERRIDE {
+    return Record("i" + IntToString(value));
+  }
+  virtual bool OnDouble(double value) OVERRIDE {
+    return Record("d" + DoubleToString(value));
+  }
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    strings_.push_back(value);
+    return Record("s" + value.as_string());
+  }
+  virtual bool OnListBegin() OVERRIDE { return Record("["); }
+  virtual bool OnListEnd() OVERRIDE { return Record("]"); }
+  virtual bool OnDictionaryBegin() OVERRIDE { return Record("{"); }
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    strings_.push_back(key);
+    return Record("k" + key.as_string());
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE { return Record("}"); }
+
+ private:
+  bool Record(const std::string& event) {
+    if (!events_.empty())
+      events_ += " ";
+    events_ += event;
+    return --max_events_ > 0;
+  }
+
+  int max_events_;
+  std::string events_;
+  std::vector<StringPiece> strings_;
+
+  DISALLOW_COPY_AND_ASSIGN(RecordingDelegate);
+};
+
+}  // namespace
+
 TEST(JSONReaderTest, Reading) {
   // some whitespace checking
   scoped_ptr<Value> root;
@@ -607,4 +662,83 @@ TEST(JSONReaderTest, ErrorMessages) {
   EXPECT_EQ(JSONReader::JSON_INVALID_ESCAPE, error_code);
 }
 
+TEST(JSONReaderTest, Delegate) {
+  const std::string json(
+      "{\"a\": [1, 2.5, true, null], \"b\": {\"c\": \"d\"}, \"e\": false}");
+  RecordingDelegate delegate(1000);
+  EXPECT_TRUE(JSONReader().Parse(json, false, false, &delegate));
+  EXPECT_EQ("{ ka [ i1 d2.5 true null ] kb { kc sd } ke false }",
+            delegate.events());
+
+  // Strings without escapes are handed out in place.
+  ASSERT_EQ(5u, delegate.strings().size());
+  for (size_t i = 0; i < delegate.strings().size(); ++i) {
+    const char* data = delegate.strings()[i].data();
+    EXPECT_TRUE(data > json.data() && data < json.data() + json.size());
+  }
+
+  // Strings with escapes are decoded.
+  RecordingDelegate escaped_delegate(1000);
+  EXPECT_TRUE(JSONReader().Parse("[\"a\\tb\", \"\\u00e9\"]", false, false,
+                                 &escaped_delegate));
+  EXPECT_EQ("[ sa\tb s\xc3\xa9 ]", escaped_delegate.events());
+
+  // Errors are reported as for JsonToValue().
+  JSONReader reader;
+  RecordingDelegate error_delegate(1000);
+  EXPECT_FALSE(reader.Parse("[1, 2,]", false, false, &error_delegate));
+  EXPECT_EQ(JSONReader::JSON_TRAILING_COMMA, reader.error_code());
+  EXPECT_EQ("[ i1 i2", error_delegate.events());
+}
+
+TEST(JSONReaderTest, DelegateStops) {
+  JSONReader reader;
+  RecordingDelegate delegate(3);
+  EXPECT_FALSE(reader.Parse("[1, 2, 3, 4]", false, false, &delegate));
+  EXPECT_EQ("[ i1 i2", delegate.events());
+  // Stopping is not a parse error.
+  EXPECT_EQ(JSONReader::JSON_NO_ERROR, reader.error_code());
+}
+
+TEST(JSONReaderTest, ReadPath) {
+  const std::string json(
+      "{\"a\": {\"b\": [1, {\"c\": 2}], \"c\": 3}, \"b\": {\"x\": 4},"
+      " \"d\": {\"a\": {\"b\": 5}}}");
+
+  scoped_ptr<Value> value(JSONReader::ReadPath(json, "a.b", JSON_PARSE_RFC));
+  ASSERT_TRUE(value.get());
+  scoped_ptr<Value> expected(JSONReader::Read("[1, {\"c\": 2}]"));
+  EXPECT_TRUE(value->Equals(expected.get()));
+
+  value.reset(JSONReader::ReadPath(json, "a.c", JSON_PARSE_RFC));
+  int result = 0;
+  ASSERT_TRUE(value.get());
+  EXPECT_TRUE(value->GetAsInteger(&result));
+  EXPECT_EQ(3, result);
+
+  value.reset(JSONReader::ReadPath(json, "d.a.b", JSON_PARSE_RFC));
+  ASSERT_TRUE(value.get());
+  EXPECT_TRUE(value->GetAsInteger(&result));
+  EXPECT_EQ(5, result);
+
+  // The empty path is the whole document.
+  value.reset(JSONReader::ReadPath(json, "", JSON_PARSE_RFC));
+  expected.reset(JSONReader::Read(json));
+  ASSERT_TRUE(value.get());
+  EXPECT_TRUE(value->Equals(expected.get()));
+
+  // Keys at the wrong depth, or inside lists, don't match.
+  EXPECT_FALSE(JSONReader::ReadPath(json, "b.c", JSON_PARSE_RFC));
+  EXPECT_FALSE(JSONReader::ReadPath(json, "a.b.c", JSON_PARSE_RFC));
+  EXPECT_FALSE(JSONReader::ReadPath(json, "x", JSON_PARSE_RFC));
+
+  // The whole document must still be valid.
+  EXPECT_FALSE(JSONReader::ReadPath("{\"a\": 1, \"b\": [}", "a",
+                                    JSON_PARSE_RFC));
+  EXPECT_FALSE(JSONReader::ReadPath("{\"a\": 1,}", "a", JSON_PARSE_RFC));
+  value.reset(JSONReader::ReadPath("{\"a\": 1,}", "a",
+                                   JSON_ALLOW_TRAILING_COMMAS));
+  EXPECT_TRUE(value.get());
+}
+
 }  // namespace base
@@ -16,6 +16,7 @@
 #include "base/message_loop_proxy_impl.h"
 #include "base/message_pump_default.h"
 #include "base/metrics/histogram.h"
+#include "base/metrics/stats_counters.h"
 #include "base/third_party/dynamic_annotations/dynamic_annotations.h"
 #include "base/threading/thread_local.h"
 #include "base/time.h"
@@ -363,8 +364,7 @@ void MessageLoop::RemoveTaskObserver(TaskObserver* task_observer) {
 
 void MessageLoop::AssertIdle() const {
   // We only check |incoming_queue_|, since we don't want to lock |work_queue_|.
-  base::AutoLock lock(incoming_queue_lock_);
-  DCHECK(incoming_queue_.empty());
+  DCHECK(incoming_queue_.IsEmpty());
 }
 
 bool MessageLoop::is_running() const {
@@ -405,6 +405,7 @@ void MessageLoop::RunInternal() {
   DCHECK_EQ(this, current());
 
   StartHistogrammer();
+  StartStatsCounters();
 
 #if !defined(OS_MACOSX) && !defined(OS_ANDROID)
   if (state_->dispatcher && type() == TYPE_UI) {
@@ -453,12 +454,26 @@ void MessageLoop::RunTask(const PendingTask& pending_task) {
   tracked_objects::TrackedTime start_time =
       tracked_objects::ThreadData::NowForStartOfRun(pending_task.birth_tally);
 
+  const bool record_stats =
+      queue_depth_counter_.get() && queue_depth_counter_->Enabled();
+  base::TimeTicks run_start_time;
+  if (record_stats) {
+    run_start_time = base::TimeTicks::Now();
+    // A delayed task only starts waiting once it is due.
+    base::TimeTicks ready_time = pending_task.delayed_run_time.is_null() ?
+        pending_task.time_posted : pending_task.delayed_run_time;
+    queueing_delay_rate_->AddTime(run_start_time - ready_time);
+  }
+
   FOR_EACH_OBSERVER(TaskObserver, task_observers_,
                     WillProcessTask(pending_task.time_posted));
   pending_task.task.Run();
   FOR_EACH_OBSERVER(TaskObserver, task_observers_,
                     DidProcessTask(pending_task.time_posted));
 
+  if (record_stats)
+    run_time_rate_->AddTime(base::TimeTicks::Now() - run_start_time);
+
   tracked_objects::ThreadData::TallyRunOnNamedThreadIfTracking(pending_task,
       start_time, tracked_objects::ThreadData::NowForEndOfRun());
 
@@ -492,19 +507,16 @@ void MessageLoop::AddToDelayedWorkQueue(const PendingTask& pending_task) {
 void MessageLoop::ReloadWorkQueue() {
   // We can improve performance of our loading tasks from incoming_queue_ to
   // work_queue_ by waiting until the last minute (work_queue_ is empty) to
-  // load.  That reduces the number of locks-per-task significantly when our
-  // queues get large.
+  // load.  That reduces the number of atomic operations per task
+  // significantly when our queues get large.
   if (!work_queue_.empty())
-    return;  // Wait till we *really* need to lock and load.
+    return;  // Wait till we *really* need to load.
 
-  // Acquire all we can from the inter-thread queue with one lock acquisition.
-  {
-    base::AutoLock lock(incoming_queue_lock_);
-    if (incoming_queue_.empty())
-      return;
-    incoming_queue_.Swap(&work_queue_);  // Constant time
-    DCHECK(incoming_queue_.empty());
-  }
+  // Acquire all we can from the inter-thread queue in one go.
+  incoming_queue_.ReloadWorkQueue(&work_queue_);
+
+  if (queue_depth_counter_.get())
+    queue_depth_counter_->Set(static_cast<int>(work_queue_.size()));
 }
 
 bool MessageLoop::DeletePendingTasks() {
@@ -581,22 +593,16 @@ void MessageLoop::AddToIncomingQueue(PendingTask* pending_task) {
   // directly, as it could starve handling of foreign threads.  Put every task
   // into this queue.
 
-  scoped_refptr<base::MessagePump> pump;
-  {
-    base::AutoLock locked(incoming_queue_lock_);
-
-    bool was_empty = incoming_queue_.empty();
-    incoming_queue_.push(*pending_task);
-    pending_task->task.Reset();
-    if (!was_empty)
-      return;  // Someone else should have started the sub-pump.
-
-    pump = pump_;
-  }
   // Since the incoming_queue_ may contain a task that destroys this message
-  // loop, we cannot exit incoming_queue_lock_ until we are done with |this|.
-  // We use a stack-based reference to the message pump so that we can call
-  // ScheduleWork outside of incoming_queue_lock_.
+  // loop, we cannot touch |this| once the task is pushed. We take a
+  // stack-based reference to the message pump beforehand so that we can call
+  // ScheduleWork afterwards.
+  scoped_refptr<base::MessagePump> pump(pump_);
+
+  bool was_empty = incoming_queue_.Push(*pending_task);
+  pending_task->task.Reset();
+  if (!was_empty)
+    return;  // Someone else should have started the sub-pump.
 
   pump->ScheduleWork();
 }
@@ -623,6 +629,15 @@ void MessageLoop::HistogramEvent(int event) {
     message_histogram_->Add(event);
 }
 
+void MessageLoop::StartStatsCounters() {
+  if (thread_name_.empty() || queue_depth_counter_.get())
+    return;
+  const std::string prefix = "MessageLoop." + thread_name_;
+  queue_depth_counter_.reset(new base::StatsCounter(prefix + ".QueueDepth"));
+  queueing_delay_rate_.reset(new base::StatsRate(prefix + ".QueueingDelay"));
+  run_time_rate_.reset(new base::StatsRate(prefix + ".RunTime"));
+}
+
 bool MessageLoop::DoWork() {
   if (!nestable_tasks_allowed_) {
     // Task can't be executed right now.
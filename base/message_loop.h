@@ -14,6 +14,7 @@
 #include "base/callback_forward.h"
 #include "base/location.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/message_loop_proxy.h"
 #include "base/message_pump.h"
 #include "base/observer_list.h"
@@ -42,6 +43,8 @@
 
 namespace base {
 class Histogram;
+class StatsCounter;
+class StatsRate;
 }
 
 // A MessageLoop is used to process events for a particular thread.  There is
@@ -438,8 +441,8 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   void AddToIncomingQueue(base::PendingTask* pending_task);
 
   // Load tasks from the incoming_queue_ into work_queue_ if the latter is
-  // empty.  The former requires a lock to access, while the latter is directly
-  // accessible on this thread.
+  // empty.  The former is shared with posting threads, while the latter is
+  // directly accessible on this thread.
   void ReloadWorkQueue();
 
   // Delete tasks that haven't run yet without running them.  Used in the
@@ -459,6 +462,10 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // If message_histogram_ is NULL, this is a no-op.
   void HistogramEvent(int event);
 
+  // Creates the StatsTable counters of this thread, if it has a name. They
+  // record nothing unless a StatsTable is in use.
+  void StartStatsCounters();
+
   // base::MessagePump::Delegate methods:
   virtual bool DoWork() OVERRIDE;
   virtual bool DoDelayedWork(base::TimeTicks* next_delayed_work_time) OVERRIDE;
@@ -495,13 +502,17 @@ class BASE_EXPORT MessageLoop : public base::MessagePump::Delegate {
   // A profiling histogram showing the counts of various messages and events.
   base::Histogram* message_histogram_;
 
-  // A null terminated list which creates an incoming_queue of tasks that are
-  // acquired under a mutex for processing on this instance's thread. These
-  // tasks have not yet been sorted out into items for our work_queue_ vs items
-  // that will be handled by the TimerManager.
-  base::TaskQueue incoming_queue_;
-  // Protect access to incoming_queue_.
-  mutable base::Lock incoming_queue_lock_;
+  // StatsTable counters of how many tasks were waiting each time the work
+  // queue was reloaded, of how long tasks waited to run once they were due,
+  // and of how long they ran. NULL until StartStatsCounters().
+  scoped_ptr<base::StatsCounter> queue_depth_counter_;
+  scoped_ptr<base::StatsRate> queueing_delay_rate_;
+  scoped_ptr<base::StatsRate> run_time_rate_;
+
+  // A lock-free queue of tasks posted from any thread for processing on this
+  // instance's thread. These tasks have not yet been sorted out into items
+  // for our work_queue_ vs items that will be handled by the TimerManager.
+  base::IncomingTaskQueue incoming_queue_;
 
   RunState* state_;
 
@@ -11,6 +11,8 @@
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
 #include "base/message_loop.h"
+#include "base/metrics/stats_table.h"
+#include "base/shared_memory.h"
 #include "base/threading/platform_thread.h"
 #include "base/threading/thread.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -1689,3 +1691,126 @@ TEST(MessageLoopTest, DestructionObserverTest) {
   EXPECT_TRUE(task_destroyed);
   EXPECT_TRUE(destruction_observer_called);
 }
+
+namespace {
+
+const int kThroughputProducers = 4;
+const int kThroughputTasksPerProducer = 25000;
+
+struct ThroughputState {
+  ThroughputState()
+      : tasks_run(0),
+        last_sequence(kThroughputProducers, -1),
+        out_of_order(false) {}
+
+  int tasks_run;
+  std::vector<int> last_sequence;
+  bool out_of_order;
+};
+
+void RecordThroughputTask(ThroughputState* state,
+                          int producer,
+                          int sequence) {
+  if (state->last_sequence[producer] + 1 != sequence)
+    state->out_of_order = true;
+  state->last_sequence[producer] = sequence;
+  if (++state->tasks_run ==
+      kThroughputProducers * kThroughputTasksPerProducer) {
+    MessageLoop::current()->Quit();
+  }
+}
+
+void PostThroughputTasks(MessageLoop* target,
+                         ThroughputState* state,
+                         int producer) {
+  for (int i = 0; i < kThroughputTasksPerProducer; ++i) {
+    target->PostTask(FROM_HERE,
+                     base::Bind(&RecordThroughputTask, state, producer, i));
+  }
+}
+
+}  // namespace
+
+// Posts from several threads at once into one loop. Every task must run
+// exactly once and tasks from one producer must keep their order. The
+// elapsed time is logged as a post/run throughput benchmark.
+TEST(MessageLoopTest, PostTaskThroughputFromManyThreads) {
+  MessageLoop loop;
+  ThroughputState state;
+
+  std::vector<Thread*> producers;
+  for (int i = 0; i < kThroughputProducers; ++i) {
+    producers.push_back(new Thread("ThroughputProducer"));
+    ASSERT_TRUE(producers.back()->Start());
+  }
+
+  TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kThroughputProducers; ++i) {
+    producers[i]->message_loop()->PostTask(
+        FROM_HERE, base::Bind(&PostThroughputTasks, &loop, &state, i));
+  }
+  loop.Run();
+  TimeDelta elapsed = TimeTicks::Now() - start;
+
+  for (int i = 0; i < kThroughputProducers; ++i) {
+    producers[i]->Stop();
+    delete producers[i];
+  }
+
+  EXPECT_EQ(kThroughputProducers * kThroughputTasksPerProducer,
+            state.tasks_run);
+  EXPECT_FALSE(state.out_of_order);
+  loop.AssertIdle();
+  VLOG(1) << "Posted and ran "
+          << kThroughputProducers * kThroughputTasksPerProducer
+          << " tasks from " << kThroughputProducers << " threads in "
+          << elapsed.InMillisecondsF() << " ms";
+}
+
+namespace {
+
+const char kStatsTableName[] = "MessageLoopStatsTable";
+
+void SleepTask(int ms) {
+  PlatformThread::Sleep(TimeDelta::FromMilliseconds(ms));
+}
+
+void GetCounterValueTask(base::StatsTable* table,
+                         const std::string& name,
+                         int* value) {
+  *value = table->GetCounterValue(name);
+}
+
+}  // namespace
+
+// A named loop records its queue depth, and how long its tasks waited and
+// ran, in the current StatsTable.
+TEST(MessageLoopTest, StatsCounters) {
+  base::SharedMemory().Delete(kStatsTableName);
+  base::StatsTable table(kStatsTableName, 10, 20);
+  base::StatsTable::set_current(&table);
+
+  int queue_depth = 0;
+  {
+    MessageLoop loop;
+    loop.set_thread_name("StatsTest");
+    loop.PostTask(FROM_HERE,
+                  base::Bind(&GetCounterValueTask, &table,
+                             "c:MessageLoop.StatsTest.QueueDepth",
+                             &queue_depth));
+    loop.PostTask(FROM_HERE, base::Bind(&SleepTask, 20));
+    loop.PostTask(FROM_HERE, base::Bind(&SleepTask, 20));
+    loop.PostTask(FROM_HERE, MessageLoop::QuitClosure());
+    loop.Run();
+  }
+
+  EXPECT_EQ(4, queue_depth);
+  EXPECT_EQ(4, table.GetCounterValue("c:MessageLoop.StatsTest.RunTime"));
+  EXPECT_LE(40, table.GetCounterValue("t:MessageLoop.StatsTest.RunTime"));
+  // The last two tasks waited for at least one sleep each.
+  EXPECT_LE(40,
+            table.GetCounterValue("t:MessageLoop.StatsTest.QueueingDelay"));
+
+  base::StatsTable::set_current(NULL);
+  base::SharedMemory().Delete(kStatsTableName);
+}
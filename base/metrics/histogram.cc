@@ -10,18 +10,49 @@
 #include "base/metrics/histogram.h"
 
 #include <math.h>
+#include <string.h>
 
 #include <algorithm>
 #include <string>
 
 #include "base/debug/leak_annotations.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/pickle.h"
 #include "base/stringprintf.h"
 #include "base/synchronization/lock.h"
+#include "base/threading/thread_local.h"
 
 namespace base {
 
+namespace {
+
+// One plus the index of the shard the current thread accumulates into, or
+// zero if the thread hasn't added a sample yet.  Threads are dealt out to the
+// shards round robin.
+LazyInstance<ThreadLocalPointer<void> >::Leaky g_shard_index =
+    LAZY_INSTANCE_INITIALIZER;
+subtle::Atomic32 g_next_shard_index = 0;
+
+// Shard sums are kept in AtomicWords, which are only 32 bits on some
+// platforms.  A shard's sum is moved to spilled_sum_ once it reaches
+// kMaxShardSum, and samples that are large enough to overflow it in one go
+// are added to spilled_sum_ directly.
+const int64 kMaxShardSum = 1 << 30;
+const int64 kMaxShardedSample = 1 << 20;
+
+// Shards are padded out to a whole number of cache lines so that threads
+// accumulating into different shards don't share any.
+const size_t kCacheLineSize = 64;
+
+}  // namespace
+
+struct Histogram::Shard {
+  subtle::AtomicWord sum;
+  subtle::Atomic32 redundant_count;
+  subtle::Atomic32 counts[1];  // Actually bucket_count_ long.
+};
+
 // Static table of checksums for all possible 8 bit bytes.
 const uint32 Histogram::kCrcTable[256] = {0x0, 0x77073096L, 0xee0e612cL,
 0x990951baL, 0x76dc419L, 0x706af48fL, 0xe963a535L, 0x9e6495a3L, 0xedb8832L,
@@ -393,11 +424,24 @@ size_t Histogram::bucket_count() const {
   return bucket_count_;
 }
 
-// Do a safe atomic snapshot of sample data.
-// This implementation assumes we are on a safe single thread.
+// Merge the shards into a snapshot of the sample data.  The shards are read
+// without stopping writers, so the bucket counts may not quite add up to the
+// redundant count; FindCorruption() allows for that.
 void Histogram::SnapshotSample(SampleSet* sample) const {
-  // Note locking not done in this version!!!
   *sample = sample_;
+  DCHECK_EQ(bucket_count_, sample->counts_.size());
+  for (int i = 0; i < kNumShards; ++i) {
+    const Shard* shard =
+        reinterpret_cast<const Shard*>(subtle::Acquire_Load(&shards_[i]));
+    if (!shard)
+      continue;
+    sample->redundant_count_ += subtle::NoBarrier_Load(&shard->redundant_count);
+    for (size_t index = 0; index < bucket_count_; ++index)
+      sample->counts_[index] += subtle::NoBarrier_Load(&shard->counts[index]);
+    sample->sum_ += subtle::NoBarrier_Load(&shard->sum);
+  }
+  AutoLock lock(spilled_sum_lock_);
+  sample->sum_ += spilled_sum_;
 }
 
 bool Histogram::HasConstructorArguments(Sample minimum,
@@ -428,7 +472,8 @@ Histogram::Histogram(const std::string& name, Sample minimum,
     flags_(kNoFlags),
     cached_ranges_(new CachedRanges(bucket_count + 1, 0)),
     range_checksum_(0),
-    sample_() {
+    sample_(),
+    spilled_sum_(0) {
   Initialize();
 }
 
@@ -441,7 +486,8 @@ Histogram::Histogram(const std::string& name, TimeDelta minimum,
     flags_(kNoFlags),
     cached_ranges_(new CachedRanges(bucket_count + 1, 0)),
     range_checksum_(0),
-    sample_() {
+    sample_(),
+    spilled_sum_(0) {
   Initialize();
 }
 
@@ -454,6 +500,9 @@ Histogram::~Histogram() {
 
   // Just to make sure most derived class did this properly...
   DCHECK(ValidateBucketRanges());
+
+  for (int i = 0; i < kNumShards; ++i)
+    delete[] reinterpret_cast<subtle::AtomicWord*>(shards_[i]);
 }
 
 bool Histogram::SerializeRanges(Pickle* pickle) const {
@@ -553,8 +602,54 @@ const std::string Histogram::GetAsciiBucketRange(size_t i) const {
 
 // Update histogram data with new sample.
 void Histogram::Accumulate(Sample value, Count count, size_t index) {
-  // Note locking not done in this version!!!
-  sample_.Accumulate(value, count, index);
+  DCHECK(count == 1 || count == -1);
+  DCHECK_LT(index, bucket_count_);
+  Shard* shard = GetShard();
+  subtle::NoBarrier_AtomicIncrement(&shard->counts[index], count);
+  int64 amount = static_cast<int64>(value) * count;
+  if (amount < kMaxShardedSample && amount > -kMaxShardedSample) {
+    subtle::AtomicWord sum = subtle::NoBarrier_AtomicIncrement(
+        &shard->sum, static_cast<subtle::AtomicWord>(amount));
+    if (sum >= kMaxShardSum || sum <= -kMaxShardSum)
+      SpillSum(subtle::NoBarrier_AtomicExchange(&shard->sum, 0));
+  } else {
+    SpillSum(amount);
+  }
+  subtle::NoBarrier_AtomicIncrement(&shard->redundant_count, count);
+}
+
+Histogram::Shard* Histogram::GetShard() {
+  intptr_t index = reinterpret_cast<intptr_t>(g_shard_index.Get().Get());
+  if (!index) {
+    uint32 next = static_cast<uint32>(
+        subtle::NoBarrier_AtomicIncrement(&g_next_shard_index, 1));
+    index = 1 + next % kNumShards;
+    g_shard_index.Get().Set(reinterpret_cast<void*>(index));
+  }
+
+  subtle::AtomicWord* slot = &shards_[index - 1];
+  Shard* shard = reinterpret_cast<Shard*>(subtle::Acquire_Load(slot));
+  if (shard)
+    return shard;
+
+  // First sample on this shard.  Racing threads may both allocate it, in
+  // which case the loser frees its copy.
+  size_t bytes = sizeof(Shard) + (bucket_count_ - 1) * sizeof(subtle::Atomic32);
+  bytes = (bytes + kCacheLineSize - 1) & ~(kCacheLineSize - 1);
+  size_t words = bytes / sizeof(subtle::AtomicWord);
+  subtle::AtomicWord* storage = new subtle::AtomicWord[words];
+  memset(storage, 0, words * sizeof(subtle::AtomicWord));
+  if (subtle::Release_CompareAndSwap(
+          slot, 0, reinterpret_cast<subtle::AtomicWord>(storage))) {
+    delete[] storage;
+    return reinterpret_cast<Shard*>(subtle::Acquire_Load(slot));
+  }
+  return reinterpret_cast<Shard*>(storage);
+}
+
+void Histogram::SpillSum(int64 amount) {
+  AutoLock lock(spilled_sum_lock_);
+  spilled_sum_ += amount;
 }
 
 void Histogram::SetBucketRange(size_t i, Sample value) {
@@ -584,6 +679,8 @@ uint32 Histogram::CalculateRangeChecksum() const {
 
 void Histogram::Initialize() {
   sample_.Resize(*this);
+  for (int i = 0; i < kNumShards; ++i)
+    shards_[i] = 0;
   if (declared_min_ < 1)
     declared_min_ = 1;
   if (declared_max_ > kSampleType_MAX - 1)
@@ -765,8 +862,19 @@ bool Histogram::SampleSet::Serialize(Pickle* pickle) const {
   pickle->WriteInt64(redundant_count_);
   pickle->WriteUInt64(counts_.size());
 
+  // Snapshots sent over IPC are deltas, which usually touch only a few of
+  // the buckets, so only the non-empty ones are written, with their index.
+  uint64 nonzero_count = 0;
+  for (size_t index = 0; index < counts_.size(); ++index) {
+    if (counts_[index])
+      ++nonzero_count;
+  }
+  pickle->WriteUInt64(nonzero_count);
   for (size_t index = 0; index < counts_.size(); ++index) {
-    pickle->WriteInt(counts_[index]);
+    if (counts_[index]) {
+      pickle->WriteUInt64(index);
+      pickle->WriteInt(counts_[index]);
+    }
   }
 
   return true;
@@ -778,23 +886,36 @@ bool Histogram::SampleSet::Deserialize(PickleIterator* iter) {
   DCHECK_EQ(redundant_count_, 0);
 
   uint64 counts_size;
+  uint64 nonzero_count;
 
   if (!iter->ReadInt64(&sum_) ||
       !iter->ReadInt64(&redundant_count_) ||
-      !iter->ReadUInt64(&counts_size)) {
+      !iter->ReadUInt64(&counts_size) ||
+      !iter->ReadUInt64(&nonzero_count)) {
     return false;
   }
 
-  if (counts_size == 0)
+  // The counts may come from an untrusted renderer, so check the sizes
+  // before allocating the buckets.
+  if (counts_size == 0 || counts_size > kBucketCount_MAX ||
+      nonzero_count > counts_size) {
     return false;
+  }
 
+  counts_.resize(counts_size, 0);
   int count = 0;
-  for (uint64 index = 0; index < counts_size; ++index) {
-    int i;
-    if (!iter->ReadInt(&i))
+  uint64 next_index = 0;
+  for (uint64 i = 0; i < nonzero_count; ++i) {
+    uint64 index;
+    int bucket_count;
+    if (!iter->ReadUInt64(&index) ||
+        !iter->ReadInt(&bucket_count) ||
+        index < next_index || index >= counts_size) {
       return false;
-    counts_.push_back(i);
-    count += i;
+    }
+    counts_[index] = bucket_count;
+    count += bucket_count;
+    next_index = index + 1;
   }
   DCHECK_EQ(count, redundant_count_);
   return count == redundant_count_;
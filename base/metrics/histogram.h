@@ -51,6 +51,7 @@
 #include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
 #include "base/logging.h"
+#include "base/synchronization/lock.h"
 #include "base/time.h"
 
 class Pickle;
@@ -58,7 +59,6 @@ class PickleIterator;
 
 namespace base {
 
-class Lock;
 //------------------------------------------------------------------------------
 // Histograms are often put in areas where they are called many many times, and
 // performance is critical.  As a result, they are designed to have a very low
@@ -67,7 +67,10 @@ class Lock;
 // take a "slow path" to construct (or find) the histogram on the first run
 // through the macro.  We leak the histograms at shutdown time so that we don't
 // have to validate using the pointers at any time during the running of the
-// process.
+// process.  Samples are counted with atomic increments into one of a few
+// per-histogram shards, chosen per thread, so histograms that are hit from
+// many threads at once don't all contend for the same cache lines; the shards
+// are only merged when the histogram is snapshotted.
 
 // The following code is generally what a thread-safe static pointer
 // initializaion looks like for a histogram (after a macro is expanded).  This
@@ -417,6 +420,9 @@ class BASE_EXPORT Histogram {
     int64 sum_;         // sum of samples.
 
    private:
+    // To merge in the shards when snapshotting.
+    friend class Histogram;
+
     // Allow tests to corrupt our innards for testing purposes.
     FRIEND_TEST_ALL_PREFIXES(HistogramTest, CorruptSampleCounts);
 
@@ -518,8 +524,8 @@ class BASE_EXPORT Histogram {
   void set_cached_ranges(CachedRanges* cached_ranges) {
     cached_ranges_ = cached_ranges;
   }
-  // Snapshot the current complete set of sample data.
-  // Override with atomic/locked snapshot if needed.
+  // Snapshot the current complete set of sample data.  Samples added by other
+  // threads while the snapshot is taken may be partially included.
   virtual void SnapshotSample(SampleSet* sample) const;
 
   virtual bool HasConstructorArguments(Sample minimum, Sample maximum,
@@ -569,7 +575,8 @@ class BASE_EXPORT Histogram {
   virtual const std::string GetAsciiBucketRange(size_t it) const;
 
   //----------------------------------------------------------------------------
-  // Methods to override to create thread safe histogram.
+  // Methods to override to change how samples are stored.  The default
+  // implementation is thread safe.
   //----------------------------------------------------------------------------
   // Update all our internal data, including histogram
   virtual void Accumulate(Sample value, Count count, size_t index);
@@ -595,9 +602,22 @@ class BASE_EXPORT Histogram {
 
   friend class StatisticsRecorder;  // To allow it to delete duplicates.
 
+  // Per-thread slice of the sample data; see GetShard().
+  struct Shard;
+
+  // Enough to spread out the handful of threads (IO, UI, DB, ...) that
+  // usually record into the same histogram.
+  enum { kNumShards = 8 };
+
   // Post constructor initialization.
   void Initialize();
 
+  // Returns the calling thread's shard, allocating it on first use.
+  Shard* GetShard();
+
+  // Moves |amount| into spilled_sum_.
+  void SpillSum(int64 amount);
+
   // Checksum function for accumulating range values into a checksum.
   static uint32 Crc32(uint32 sum, Sample range);
 
@@ -654,8 +674,15 @@ class BASE_EXPORT Histogram {
   uint32 range_checksum_;
 
   // Finally, provide the state that changes with the addition of each new
-  // sample.
+  // sample.  Samples merged in with AddSampleSet() go into |sample_|, while
+  // Add() accumulates into |shards_| (which hold NULL or a Shard*); a snapshot
+  // is the sum of all of them.
   SampleSet sample_;
+  base::subtle::AtomicWord shards_[kNumShards];
+
+  // The part of the sum of samples that doesn't fit in the shards' counters.
+  mutable base::Lock spilled_sum_lock_;
+  int64 spilled_sum_;
 
   DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
@@ -0,0 +1,103 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/histogram.h"
+
+#include "base/memory/scoped_vector.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const int kNumThreads = 8;
+const int kSamplesPerThread = 1000000;
+
+// Accumulates into a single SampleSet shared by every thread, as all
+// histograms did before samples were sharded.  Concurrent Add()s lose
+// samples, and every one of them writes to the same cache lines.
+class UnshardedHistogram : public Histogram {
+ public:
+  UnshardedHistogram()
+      : Histogram("UnshardedHistogram", 1, 10000, 50) {
+    InitializeBucketRange();
+    unsharded_sample_.Resize(*this);
+  }
+
+  virtual void SnapshotSample(SampleSet* sample) const OVERRIDE {
+    *sample = unsharded_sample_;
+  }
+
+ protected:
+  virtual void Accumulate(Sample value, Count count, size_t index) OVERRIDE {
+    unsharded_sample_.Accumulate(value, count, index);
+  }
+
+ private:
+  SampleSet unsharded_sample_;
+
+  DISALLOW_COPY_AND_ASSIGN(UnshardedHistogram);
+};
+
+class AddSamplesDelegate : public DelegateSimpleThread::Delegate {
+ public:
+  explicit AddSamplesDelegate(Histogram* histogram) : histogram_(histogram) {}
+
+  virtual void Run() OVERRIDE {
+    for (int i = 0; i < kSamplesPerThread; ++i)
+      histogram_->Add(i % 10000);
+  }
+
+ private:
+  Histogram* histogram_;
+
+  DISALLOW_COPY_AND_ASSIGN(AddSamplesDelegate);
+};
+
+// Adds kSamplesPerThread samples from each of |num_threads| threads at once.
+void RunContendedAdds(const char* name, Histogram* histogram,
+                      int num_threads) {
+  ScopedVector<AddSamplesDelegate> delegates;
+  ScopedVector<DelegateSimpleThread> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    delegates.push_back(new AddSamplesDelegate(histogram));
+    threads.push_back(new DelegateSimpleThread(delegates[i], "histogram"));
+  }
+
+  PerfTimeLogger timer(StringPrintf("%s_%d_threads", name,
+                                    num_threads).c_str());
+  for (int i = 0; i < num_threads; ++i)
+    threads[i]->Start();
+  for (int i = 0; i < num_threads; ++i)
+    threads[i]->Join();
+  timer.Done();
+
+  Histogram::SampleSet sample;
+  histogram->SnapshotSample(&sample);
+  LOG(INFO) << name << ": counted " << sample.TotalCount() << " of "
+            << num_threads * kSamplesPerThread << " samples";
+}
+
+}  // namespace
+
+TEST(HistogramPerfTest, UncontendedAdd) {
+  UnshardedHistogram unsharded;
+  RunContendedAdds("Histogram_add_unsharded", &unsharded, 1);
+  Histogram* sharded = Histogram::FactoryGet("HistogramPerfTest.Uncontended",
+                                             1, 10000, 50, Histogram::kNoFlags);
+  RunContendedAdds("Histogram_add_sharded", sharded, 1);
+}
+
+TEST(HistogramPerfTest, ContendedAdd) {
+  UnshardedHistogram unsharded;
+  RunContendedAdds("Histogram_add_unsharded", &unsharded, kNumThreads);
+  Histogram* sharded = Histogram::FactoryGet("HistogramPerfTest.Contended",
+                                             1, 10000, 50, Histogram::kNoFlags);
+  RunContendedAdds("Histogram_add_sharded", sharded, kNumThreads);
+}
+
+}  // namespace base
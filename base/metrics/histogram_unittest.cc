@@ -8,7 +8,10 @@
 #include <vector>
 
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/metrics/histogram.h"
+#include "base/pickle.h"
+#include "base/threading/simple_thread.h"
 #include "base/time.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -18,6 +21,25 @@ namespace {
 class HistogramTest : public testing::Test {
 };
 
+// Adds |count| samples of |value| to |histogram|.
+class AddSamplesDelegate : public DelegateSimpleThread::Delegate {
+ public:
+  AddSamplesDelegate(Histogram* histogram, int value, int count)
+      : histogram_(histogram), value_(value), count_(count) {}
+
+  virtual void Run() OVERRIDE {
+    for (int i = 0; i < count_; ++i)
+      histogram_->Add(value_);
+  }
+
+ private:
+  Histogram* histogram_;
+  const int value_;
+  const int count_;
+
+  DISALLOW_COPY_AND_ASSIGN(AddSamplesDelegate);
+};
+
 // Check for basic syntax and use.
 TEST(HistogramTest, StartupShutdownTest) {
   // Try basic construction
@@ -347,6 +369,82 @@ TEST(HistogramTest, BucketPlacementTest) {
     EXPECT_EQ(i + 1, sample.counts(i));
 }
 
+// Samples added concurrently from many threads (more threads than shards)
+// must all be counted.
+TEST(HistogramTest, MultithreadedAddTest) {
+  Histogram* histogram(Histogram::FactoryGet(
+      "MultithreadedHistogram", 1, 64, 8, Histogram::kNoFlags));
+
+  const int kNumThreads = 20;
+  const int kSamplesPerThread = 10000;
+  ScopedVector<AddSamplesDelegate> delegates;
+  ScopedVector<DelegateSimpleThread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    // Thread i adds 2^(i % 6), which lands in bucket (i % 6) + 1.
+    delegates.push_back(
+        new AddSamplesDelegate(histogram, 1 << (i % 6), kSamplesPerThread));
+    threads.push_back(new DelegateSimpleThread(delegates[i], "histogram"));
+    threads[i]->Start();
+  }
+  for (int i = 0; i < kNumThreads; ++i)
+    threads[i]->Join();
+
+  Histogram::SampleSet sample;
+  histogram->SnapshotSample(&sample);
+  EXPECT_EQ(kNumThreads * kSamplesPerThread, sample.TotalCount());
+  EXPECT_EQ(kNumThreads * kSamplesPerThread, sample.redundant_count());
+  int64 expected_sum = 0;
+  for (int i = 0; i < kNumThreads; ++i)
+    expected_sum += static_cast<int64>(1 << (i % 6)) * kSamplesPerThread;
+  EXPECT_EQ(expected_sum, sample.sum());
+  for (int bucket = 1; bucket <= 6; ++bucket) {
+    int threads_in_bucket = (kNumThreads + 6 - bucket) / 6;
+    EXPECT_EQ(threads_in_bucket * kSamplesPerThread, sample.counts(bucket));
+  }
+  EXPECT_EQ(Histogram::NO_INCONSISTENCIES,
+            histogram->FindCorruption(sample));
+}
+
+// The sum of samples must not overflow, even with 32 bit atomic counters.
+TEST(HistogramTest, LargeSampleSumTest) {
+  Histogram* histogram(Histogram::FactoryGet(
+      "LargeSampleHistogram", 1, 1000000, 50, Histogram::kNoFlags));
+
+  const int kNumSamples = 5000;
+  for (int i = 0; i < kNumSamples; ++i) {
+    histogram->Add(999999);  // Added to the shard's sum.
+    histogram->Add(INT_MAX - 1);  // Added to the spilled sum.
+  }
+
+  Histogram::SampleSet sample;
+  histogram->SnapshotSample(&sample);
+  EXPECT_EQ(2 * kNumSamples, sample.redundant_count());
+  EXPECT_EQ((static_cast<int64>(999999) + INT_MAX - 1) * kNumSamples,
+            sample.sum());
+}
+
+// Only the non-empty buckets are serialized, and the others come back empty.
+TEST(HistogramTest, SampleSetSerializationTest) {
+  Histogram* histogram(Histogram::FactoryGet(
+      "SerializedHistogram", 1, 1000, 50, Histogram::kNoFlags));
+  histogram->Add(5);
+  histogram->Add(5);
+  histogram->Add(700);
+
+  Histogram::SampleSet sample;
+  histogram->SnapshotSample(&sample);
+  Pickle pickle;
+  ASSERT_TRUE(sample.Serialize(&pickle));
+
+  Histogram::SampleSet deserialized;
+  PickleIterator iter(pickle);
+  ASSERT_TRUE(deserialized.Deserialize(&iter));
+  EXPECT_EQ(sample.sum(), deserialized.sum());
+  EXPECT_EQ(3, deserialized.redundant_count());
+  for (size_t i = 0; i < histogram->bucket_count(); ++i)
+    EXPECT_EQ(sample.counts(i), deserialized.counts(i));
+}
+
 }  // namespace
 
 //------------------------------------------------------------------------------
@@ -357,12 +455,12 @@ TEST(HistogramTest, CorruptSampleCounts) {
   Histogram* histogram(Histogram::FactoryGet(
       "Histogram", 1, 64, 8, Histogram::kNoFlags));  // As per header file.
 
-  EXPECT_EQ(0, histogram->sample_.redundant_count());
+  Histogram::SampleSet snapshot;
+  histogram->SnapshotSample(&snapshot);
+  EXPECT_EQ(0, snapshot.redundant_count());
   histogram->Add(20);  // Add some samples.
   histogram->Add(40);
-  EXPECT_EQ(2, histogram->sample_.redundant_count());
 
-  Histogram::SampleSet snapshot;
   histogram->SnapshotSample(&snapshot);
   EXPECT_EQ(Histogram::NO_INCONSISTENCIES, 0);
   EXPECT_EQ(0, histogram->FindCorruption(snapshot));  // No default corruption.
@@ -4,6 +4,7 @@
 
 #include "base/pending_task.h"
 
+#include "base/threading/platform_thread.h"
 #include "base/tracked_objects.h"
 
 namespace base {
@@ -51,4 +52,107 @@ void TaskQueue::Swap(TaskQueue* queue) {
   c.swap(queue->c);  // Calls std::deque::swap.
 }
 
+struct IncomingTaskQueue::Node {
+  Node() : next(0) {}
+
+  volatile subtle::AtomicWord next;
+};
+
+struct IncomingTaskQueue::TaskNode : public IncomingTaskQueue::Node {
+  explicit TaskNode(const PendingTask& pending_task)
+      : pending_task(pending_task) {}
+
+  PendingTask pending_task;
+};
+
+IncomingTaskQueue::IncomingTaskQueue()
+    : head_(0),
+      tail_(NULL),
+      stub_(new Node),
+      size_(0) {
+  head_ = reinterpret_cast<subtle::AtomicWord>(stub_.get());
+  tail_ = stub_.get();
+}
+
+IncomingTaskQueue::~IncomingTaskQueue() {
+  while (TaskNode* node = PopNode())
+    delete node;
+}
+
+bool IncomingTaskQueue::Push(const PendingTask& pending_task) {
+  PushNode(new TaskNode(pending_task));
+  // Count the task only once it is linked in, so that a consumer woken up
+  // by this push is guaranteed to find it.
+  return subtle::Barrier_AtomicIncrement(&size_, 1) == 1;
+}
+
+void IncomingTaskQueue::ReloadWorkQueue(TaskQueue* work_queue) {
+  subtle::Atomic32 count = subtle::Acquire_Load(&size_);
+  if (!count)
+    return;
+
+  for (subtle::Atomic32 i = 0; i < count; ++i) {
+    TaskNode* node = PopNode();
+    // All |count| tasks are fully pushed, but one may be queued behind a
+    // producer that has exchanged |head_| and not yet linked its node. That
+    // window is a couple of instructions long.
+    while (!node) {
+      PlatformThread::YieldCurrentThread();
+      node = PopNode();
+    }
+    work_queue->push(node->pending_task);
+    delete node;
+  }
+  // Producers that pushed in the meantime saw a non-zero size and didn't
+  // schedule work. They don't need to: the owner keeps calling us until the
+  // size reads zero.
+  subtle::Barrier_AtomicIncrement(&size_, -count);
+}
+
+bool IncomingTaskQueue::IsEmpty() const {
+  return subtle::Acquire_Load(&size_) == 0;
+}
+
+void IncomingTaskQueue::PushNode(Node* node) {
+  subtle::NoBarrier_Store(&node->next, 0);
+  subtle::MemoryBarrier();
+  Node* previous = reinterpret_cast<Node*>(subtle::NoBarrier_AtomicExchange(
+      &head_, reinterpret_cast<subtle::AtomicWord>(node)));
+  // Publishes |node| (and the task inside it) to the consumer.
+  subtle::Release_Store(&previous->next,
+                        reinterpret_cast<subtle::AtomicWord>(node));
+}
+
+IncomingTaskQueue::TaskNode* IncomingTaskQueue::PopNode() {
+  Node* tail = tail_;
+  Node* next = reinterpret_cast<Node*>(subtle::Acquire_Load(&tail->next));
+  if (tail == stub_.get()) {
+    if (!next)
+      return NULL;
+    tail_ = next;
+    tail = next;
+    next = reinterpret_cast<Node*>(subtle::Acquire_Load(&next->next));
+  }
+
+  if (next) {
+    tail_ = next;
+    return static_cast<TaskNode*>(tail);
+  }
+
+  // |tail| is the last linked node. If it isn't also the head, a producer
+  // is in the middle of pushing after it.
+  Node* head = reinterpret_cast<Node*>(subtle::Acquire_Load(&head_));
+  if (tail != head)
+    return NULL;
+
+  // Put the stub back behind the last node so that it can be handed out.
+  PushNode(stub_.get());
+  next = reinterpret_cast<Node*>(subtle::Acquire_Load(&tail->next));
+  if (next) {
+    tail_ = next;
+    return static_cast<TaskNode*>(tail);
+  }
+  return NULL;
+}
+
 }  // namespace base
@@ -8,9 +8,12 @@
 
 #include <queue>
 
+#include "base/atomicops.h"
 #include "base/base_export.h"
+#include "base/basictypes.h"
 #include "base/callback.h"
 #include "base/location.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/time.h"
 #include "base/tracking_info.h"
 
@@ -53,6 +56,57 @@ class BASE_EXPORT TaskQueue : public std::queue<PendingTask> {
 // PendingTasks are sorted by their |delayed_run_time| property.
 typedef std::priority_queue<base::PendingTask> DelayedTaskQueue;
 
+// A multi-producer, single-consumer queue of PendingTasks that doesn't take
+// a lock. Any thread may Push(); only the owning thread may call
+// ReloadWorkQueue() and IsEmpty(). Tasks pushed from one thread are handed
+// to the consumer in the order they were pushed.
+//
+// Each task lives in its own heap-allocated node, and the nodes form an
+// intrusive singly-linked list (Dmitry Vyukov's MPSC queue): a producer
+// publishes its node with one atomic exchange of |head_|, and the consumer
+// walks from |tail_| without touching shared state other than the links.
+class BASE_EXPORT IncomingTaskQueue {
+ public:
+  IncomingTaskQueue();
+  ~IncomingTaskQueue();
+
+  // Appends a copy of |pending_task|. Returns true if the queue was empty,
+  // in which case the caller is responsible for waking the consumer.
+  bool Push(const PendingTask& pending_task);
+
+  // Moves every task pushed so far to the back of |work_queue|.
+  void ReloadWorkQueue(TaskQueue* work_queue);
+
+  // Returns true if nothing has been pushed since the last reload.
+  bool IsEmpty() const;
+
+ private:
+  struct Node;
+  struct TaskNode;
+
+  void PushNode(Node* node);
+
+  // Returns the oldest node or NULL if the queue is empty or a producer is
+  // in the middle of a push that the oldest node depends on.
+  TaskNode* PopNode();
+
+  // The most recently pushed node. Producers exchange this.
+  volatile subtle::AtomicWord head_;
+
+  // The oldest node not yet consumed. Only used by the consumer.
+  Node* tail_;
+
+  // Placeholder that keeps the list non-empty, so producers never have to
+  // touch |tail_|.
+  scoped_ptr<Node> stub_;
+
+  // Number of tasks completely pushed and not yet reloaded. Decides which
+  // producer has to wake the consumer, and how many nodes a reload waits for.
+  volatile subtle::Atomic32 size_;
+
+  DISALLOW_COPY_AND_ASSIGN(IncomingTaskQueue);
+};
+
 }  // namespace base
 
 #endif  // PENDING_TASK_H_
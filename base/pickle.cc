@@ -5,6 +5,7 @@
 #include "base/pickle.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 #include <algorithm>  // for max()
 
@@ -18,6 +19,7 @@ static const size_t kCapacityReadOnly = static_cast<size_t>(-1);
 PickleIterator::PickleIterator(const Pickle& pickle)
     : read_ptr_(pickle.payload()),
       read_end_ptr_(pickle.end_of_payload()) {
+  DCHECK(!pickle.has_references()) << "Flatten() the Pickle first";
 }
 
 template <typename Type>
@@ -150,7 +152,8 @@ Pickle::Pickle()
     : header_(NULL),
       header_size_(sizeof(Header)),
       capacity_(0),
-      variable_buffer_offset_(0) {
+      variable_buffer_offset_(0),
+      referenced_size_(0) {
   Resize(kPayloadUnit);
   header_->payload_size = 0;
 }
@@ -159,7 +162,8 @@ Pickle::Pickle(int header_size)
     : header_(NULL),
       header_size_(AlignInt(header_size, sizeof(uint32))),
       capacity_(0),
-      variable_buffer_offset_(0) {
+      variable_buffer_offset_(0),
+      referenced_size_(0) {
   DCHECK_GE(static_cast<size_t>(header_size), sizeof(Header));
   DCHECK_LE(header_size, kPayloadUnit);
   Resize(kPayloadUnit);
@@ -170,7 +174,8 @@ Pickle::Pickle(const char* data, int data_len)
     : header_(reinterpret_cast<Header*>(const_cast<char*>(data))),
       header_size_(0),
       capacity_(kCapacityReadOnly),
-      variable_buffer_offset_(0) {
+      variable_buffer_offset_(0),
+      referenced_size_(0) {
   if (data_len >= static_cast<int>(sizeof(Header)))
     header_size_ = data_len - header_->payload_size;
 
@@ -189,11 +194,15 @@ Pickle::Pickle(const Pickle& other)
     : header_(NULL),
       header_size_(other.header_size_),
       capacity_(0),
-      variable_buffer_offset_(other.variable_buffer_offset_) {
-  size_t payload_size = header_size_ + other.header_->payload_size;
-  bool resized = Resize(payload_size);
+      variable_buffer_offset_(other.variable_buffer_offset_),
+      referenced_size_(other.referenced_size_) {
+  size_t buffer_size = header_size_ + other.buffer_payload_size();
+  bool resized = Resize(buffer_size);
   CHECK(resized);  // Realloc failed.
-  memcpy(header_, other.header_, payload_size);
+  memcpy(header_, other.header_, buffer_size);
+  // Data written by reference is immutable, so the copy can share it.
+  if (other.references_.get())
+    references_.reset(new References(*other.references_));
 }
 
 Pickle::~Pickle() {
@@ -215,11 +224,14 @@ Pickle& Pickle::operator=(const Pickle& other) {
     header_ = NULL;
     header_size_ = other.header_size_;
   }
-  bool resized = Resize(other.header_size_ + other.header_->payload_size);
+  size_t buffer_size = other.header_size_ + other.buffer_payload_size();
+  bool resized = Resize(buffer_size);
   CHECK(resized);  // Realloc failed.
-  memcpy(header_, other.header_,
-         other.header_size_ + other.header_->payload_size);
+  memcpy(header_, other.header_, buffer_size);
   variable_buffer_offset_ = other.variable_buffer_offset_;
+  references_.reset(
+      other.references_.get() ? new References(*other.references_) : NULL);
+  referenced_size_ = other.referenced_size_;
   return *this;
 }
 
@@ -300,12 +312,93 @@ void Pickle::TrimWriteData(int new_length) {
   *cur_length = new_length;
 }
 
+bool Pickle::WriteDataByReference(base::RefCountedMemory* data) {
+  DCHECK_NE(kCapacityReadOnly, capacity_) << "oops: pickle is readonly";
+  if (data->size() > static_cast<size_t>(kint32max))
+    return false;
+  int length = static_cast<int>(data->size());
+  if (!WriteInt(length))
+    return false;
+  if (!length)
+    return true;
+
+  if (!references_.get())
+    references_.reset(new References);
+  Reference reference;
+  reference.offset = header_size_ + buffer_payload_size();
+  reference.data = data;
+  references_->push_back(reference);
+  header_->payload_size += length;
+  referenced_size_ += length;
+  return true;
+}
+
+void Pickle::Flatten() {
+  if (!references_.get())
+    return;
+
+  std::vector<Segment> segments;
+  GetSegments(&segments);
+  size_t new_capacity = AlignInt(size(), kPayloadUnit);
+  char* buffer = static_cast<char*>(malloc(new_capacity));
+  CHECK(buffer);  // Malloc failed.
+  char* dest = buffer;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    memcpy(dest, segments[i].data, segments[i].size);
+    dest += segments[i].size;
+  }
+
+  // The variable buffer moves along by whatever was written by reference
+  // ahead of it.
+  size_t variable_buffer_offset = variable_buffer_offset_;
+  for (size_t i = 0; variable_buffer_offset && i < references_->size(); ++i) {
+    if ((*references_)[i].offset <= variable_buffer_offset)
+      variable_buffer_offset_ += (*references_)[i].data->size();
+  }
+
+  free(header_);
+  header_ = reinterpret_cast<Header*>(buffer);
+  capacity_ = new_capacity;
+  references_.reset();
+  referenced_size_ = 0;
+}
+
+void Pickle::GetSegments(std::vector<Segment>* segments) const {
+  const char* buffer = reinterpret_cast<const char*>(header_);
+  size_t buffer_size = header_size_ + buffer_payload_size();
+  size_t offset = 0;
+  if (references_.get()) {
+    for (size_t i = 0; i < references_->size(); ++i) {
+      const Reference& reference = (*references_)[i];
+      if (reference.offset > offset) {
+        Segment segment = { buffer + offset, reference.offset - offset };
+        segments->push_back(segment);
+        offset = reference.offset;
+      }
+      Segment segment = {
+        reinterpret_cast<const char*>(reference.data->front()),
+        reference.data->size()
+      };
+      segments->push_back(segment);
+    }
+  }
+  if (buffer_size > offset) {
+    Segment segment = { buffer + offset, buffer_size - offset };
+    segments->push_back(segment);
+  }
+}
+
 char* Pickle::BeginWrite(size_t length) {
   // write at a uint32-aligned offset from the beginning of the header
   size_t offset = AlignInt(header_->payload_size, sizeof(uint32));
 
+  // Data written by reference is part of the payload but not of the buffer,
+  // so the write goes that much further back in the buffer.
+  size_t buffer_end = buffer_payload_size();
+  size_t buffer_offset = offset - referenced_size_;
+
   size_t new_size = offset + length;
-  size_t needed_size = header_size_ + new_size;
+  size_t needed_size = header_size_ + buffer_offset + length;
   if (needed_size > capacity_ && !Resize(std::max(capacity_ * 2, needed_size)))
     return NULL;
 
@@ -313,8 +406,12 @@ char* Pickle::BeginWrite(size_t length) {
   DCHECK_LE(length, kuint32max);
 #endif
 
+  // Nothing pads out data written by reference, so pad it here.
+  if (buffer_offset != buffer_end)
+    memset(payload() + buffer_end, 0, buffer_offset - buffer_end);
+
   header_->payload_size = static_cast<uint32>(new_size);
-  return payload() + offset;
+  return payload() + buffer_offset;
 }
 
 void Pickle::EndWrite(char* dest, int length) {
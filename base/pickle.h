@@ -7,12 +7,16 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "base/base_export.h"
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/string16.h"
 
 class Pickle;
@@ -132,8 +136,12 @@ class BASE_EXPORT Pickle {
   // Returns the size of the Pickle's data.
   size_t size() const { return header_size_ + header_->payload_size; }
 
-  // Returns the data for this Pickle.
-  const void* data() const { return header_; }
+  // Returns the data for this Pickle.  Not for use while the Pickle holds data
+  // written by reference; see WriteDataByReference().
+  const void* data() const {
+    DCHECK(!has_references());
+    return header_;
+  }
 
   // For compatibility, these older style read methods pass through to the
   // PickleIterator methods.
@@ -238,6 +246,33 @@ class BASE_EXPORT Pickle {
   // not been changed.
   void TrimWriteData(int length);
 
+  // Same as WriteData, but instead of being copied into the Pickle, |data| is
+  // kept by reference until the Pickle is destroyed, so that large blobs can
+  // be sent without a copy.  Its contents must not change in the meantime.
+  // Use ReadData to get the data.
+  //
+  // Once data has been written by reference the Pickle's data is in pieces:
+  // data() may not be used, and the Pickle may not be read, until Flatten()
+  // is called.  Use GetSegments() to write the Pickle out without
+  // flattening it.
+  bool WriteDataByReference(base::RefCountedMemory* data);
+
+  // Returns true if the Pickle holds data written by reference.
+  bool has_references() const { return references_.get() != NULL; }
+
+  // Copies any data written by reference into the Pickle's own buffer.
+  void Flatten();
+
+  // A contiguous piece of the Pickle's data.
+  struct Segment {
+    const char* data;
+    size_t size;
+  };
+
+  // Appends the pieces that make up the Pickle's data to |segments|, in
+  // order.  Without data written by reference there is only one.
+  void GetSegments(std::vector<Segment>* segments) const;
+
   // Payload follows after allocation of Header (header size is customizable).
   struct Header {
     uint32 payload_size;  // Specifies the size of the payload.
@@ -269,14 +304,14 @@ class BASE_EXPORT Pickle {
   }
 
   // Returns the address of the byte immediately following the currently valid
-  // header + payload.
+  // header + payload in the Pickle's buffer.
   char* end_of_payload() {
     // We must have a valid header_.
-    return payload() + payload_size();
+    return payload() + buffer_payload_size();
   }
   const char* end_of_payload() const {
     // This object may be invalid.
-    return header_ ? payload() + payload_size() : NULL;
+    return header_ ? payload() + buffer_payload_size() : NULL;
   }
 
   size_t capacity() const {
@@ -317,12 +352,30 @@ class BASE_EXPORT Pickle {
  private:
   friend class PickleIterator;
 
+  // Data written by reference, which belongs |offset| bytes into the buffer
+  // (from the start of the header).
+  struct Reference {
+    size_t offset;
+    scoped_refptr<base::RefCountedMemory> data;
+  };
+  typedef std::vector<Reference> References;
+
+  // The number of payload bytes in the Pickle's own buffer.
+  size_t buffer_payload_size() const {
+    return header_->payload_size - referenced_size_;
+  }
+
   Header* header_;
   size_t header_size_;  // Supports extra data between header and payload.
   // Allocation size of payload (or -1 if allocation is const).
   size_t capacity_;
   size_t variable_buffer_offset_;  // IF non-zero, then offset to a buffer.
 
+  // Data written by reference, in order, or NULL if there is none, and its
+  // total size.
+  scoped_ptr<References> references_;
+  size_t referenced_size_;
+
   FRIEND_TEST_ALL_PREFIXES(PickleTest, Resize);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNext);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNextWithIncompleteHeader);
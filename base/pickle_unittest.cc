@@ -3,8 +3,10 @@
 // found in the LICENSE file.
 
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/pickle.h"
 #include "base/string16.h"
@@ -334,3 +336,96 @@ TEST(PickleTest, ReadBytes) {
   memcpy(&outdata, outdata_char, sizeof(outdata));
   EXPECT_EQ(data, outdata);
 }
+
+TEST(PickleTest, WriteDataByReference) {
+  std::vector<unsigned char> bytes(1000, 'x');
+  scoped_refptr<base::RefCountedBytes> blob(
+      base::RefCountedBytes::TakeVector(&bytes));
+  // An odd length, so that what follows needs padding.
+  scoped_refptr<base::RefCountedBytes> odd_blob(new base::RefCountedBytes(
+      std::vector<unsigned char>(testdata, testdata + testdatalen - 1)));
+
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteInt(testint));
+  EXPECT_TRUE(pickle.WriteDataByReference(blob));
+  EXPECT_TRUE(pickle.WriteDataByReference(odd_blob));
+  EXPECT_TRUE(pickle.WriteString(teststr));
+  EXPECT_TRUE(pickle.WriteDataByReference(odd_blob));
+  EXPECT_TRUE(pickle.has_references());
+
+  // The referenced data is not copied.
+  std::vector<Pickle::Segment> segments;
+  pickle.GetSegments(&segments);
+  ASSERT_EQ(6U, segments.size());
+  EXPECT_EQ(reinterpret_cast<const char*>(blob->front()), segments[1].data);
+  EXPECT_EQ(blob->size(), segments[1].size);
+  EXPECT_EQ(reinterpret_cast<const char*>(odd_blob->front()),
+            segments[5].data);
+  std::string joined;
+  for (size_t i = 0; i < segments.size(); ++i)
+    joined.append(segments[i].data, segments[i].size);
+  EXPECT_EQ(pickle.size(), joined.size());
+
+  // Copies share the referenced data.
+  Pickle copy(pickle);
+  Pickle assigned;
+  assigned = pickle;
+  EXPECT_TRUE(copy.has_references());
+
+  pickle.Flatten();
+  EXPECT_FALSE(pickle.has_references());
+  EXPECT_EQ(joined, std::string(static_cast<const char*>(pickle.data()),
+                                pickle.size()));
+  copy.Flatten();
+  assigned.Flatten();
+  EXPECT_EQ(joined, std::string(static_cast<const char*>(copy.data()),
+                                copy.size()));
+  EXPECT_EQ(joined, std::string(static_cast<const char*>(assigned.data()),
+                                assigned.size()));
+
+  // The flattened data reads back as though it had been written by WriteData.
+  Pickle written(joined.data(), static_cast<int>(joined.size()));
+  PickleIterator iter(written);
+  int outint;
+  EXPECT_TRUE(written.ReadInt(&iter, &outint));
+  EXPECT_EQ(testint, outint);
+  const char* outdata;
+  int outdatalen;
+  EXPECT_TRUE(written.ReadData(&iter, &outdata, &outdatalen));
+  EXPECT_EQ(std::string(1000, 'x'), std::string(outdata, outdatalen));
+  EXPECT_TRUE(written.ReadData(&iter, &outdata, &outdatalen));
+  EXPECT_EQ(std::string(testdata, testdatalen - 1),
+            std::string(outdata, outdatalen));
+  std::string outstr;
+  EXPECT_TRUE(written.ReadString(&iter, &outstr));
+  EXPECT_EQ(teststr, outstr);
+  EXPECT_TRUE(written.ReadData(&iter, &outdata, &outdatalen));
+  EXPECT_EQ(std::string(testdata, testdatalen - 1),
+            std::string(outdata, outdatalen));
+  EXPECT_FALSE(written.ReadInt(&iter, &outint));
+}
+
+// The variable buffer can still be trimmed after data is written by
+// reference ahead of it.
+TEST(PickleTest, WriteDataByReferenceBeforeVariableBuffer) {
+  scoped_refptr<base::RefCountedBytes> blob(new base::RefCountedBytes(
+      std::vector<unsigned char>(testdata, testdata + testdatalen)));
+
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteDataByReference(blob));
+  char* dest = pickle.BeginWriteData(10);
+  ASSERT_TRUE(dest);
+  memcpy(dest, "0123456789", 10);
+  pickle.TrimWriteData(5);
+  pickle.Flatten();
+  pickle.TrimWriteData(2);
+
+  PickleIterator iter(pickle);
+  const char* outdata;
+  int outdatalen;
+  EXPECT_TRUE(pickle.ReadData(&iter, &outdata, &outdatalen));
+  EXPECT_EQ(std::string(testdata, testdatalen),
+            std::string(outdata, outdatalen));
+  EXPECT_TRUE(pickle.ReadData(&iter, &outdata, &outdatalen));
+  EXPECT_EQ("01", std::string(outdata, outdatalen));
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/profiler/thread_data_arena.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace tracked_objects {
+
+namespace {
+
+size_t RoundUpToAlignment(size_t size) {
+  return (size + ThreadDataArena::kAlignment - 1) &
+      ~(ThreadDataArena::kAlignment - 1);
+}
+
+}  // namespace
+
+// static
+const size_t ThreadDataArena::kAlignment;
+// static
+const size_t ThreadDataArena::kChunkSize;
+
+ThreadDataArena::ThreadDataArena()
+    : chunks_(NULL),
+      free_(NULL),
+      end_(NULL),
+      allocated_bytes_(0) {
+}
+
+ThreadDataArena::~ThreadDataArena() {
+  while (chunks_) {
+    Chunk* next = chunks_->next;
+    delete [] reinterpret_cast<char*>(chunks_);
+    chunks_ = next;
+  }
+}
+
+void* ThreadDataArena::Allocate(size_t size) {
+  size = RoundUpToAlignment(std::max<size_t>(size, 1));
+  if (static_cast<size_t>(end_ - free_) < size) {
+    // Oversized requests get a chunk of their own. The unused tail of the
+    // current chunk is abandoned either way; records are small, so little is
+    // wasted.
+    const size_t header = RoundUpToAlignment(sizeof(Chunk));
+    size_t chunk_size = std::max<size_t>(kChunkSize, header + size);
+    char* memory = new char[chunk_size];
+    Chunk* chunk = reinterpret_cast<Chunk*>(memory);
+    chunk->next = chunks_;
+    chunks_ = chunk;
+    free_ = memory + header;
+    end_ = memory + chunk_size;
+  }
+
+  void* result = free_;
+  free_ += size;
+  allocated_bytes_ += size;
+  memset(result, 0, size);
+  DCHECK_EQ(0u, reinterpret_cast<uintptr_t>(result) & (kAlignment - 1));
+  return result;
+}
+
+}  // namespace tracked_objects
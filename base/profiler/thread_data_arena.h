@@ -0,0 +1,178 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_PROFILER_THREAD_DATA_ARENA_H_
+#define BASE_PROFILER_THREAD_DATA_ARENA_H_
+
+#include <vector>
+
+#include "base/atomicops.h"
+#include "base/base_export.h"
+#include "base/basictypes.h"
+
+namespace tracked_objects {
+
+//------------------------------------------------------------------------------
+// A bump allocator for the birth and death records of a single ThreadData.
+// Records are only ever added (never individually freed), and they live as long
+// as their ThreadData, so carving them out of large chunks avoids a heap
+// allocation per new Location and keeps each thread's records close together.
+// The destructor releases all chunks without running any destructors, so only
+// trivially destructible objects may be placed in an arena.
+
+class BASE_EXPORT ThreadDataArena {
+ public:
+  ThreadDataArena();
+  ~ThreadDataArena();
+
+  // Returns |size| bytes of zeroed memory aligned to kAlignment.
+  void* Allocate(size_t size);
+
+  // Total bytes handed out by Allocate() (including alignment padding).
+  size_t allocated_bytes() const { return allocated_bytes_; }
+
+  static const size_t kAlignment = 8;
+  static const size_t kChunkSize = 16 * 1024;
+
+ private:
+  struct Chunk {
+    Chunk* next;
+  };
+
+  // Most recently allocated chunk, heading a list of all chunks.
+  Chunk* chunks_;
+
+  // Free space in the current chunk.
+  char* free_;
+  char* end_;
+
+  size_t allocated_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadDataArena);
+};
+
+//------------------------------------------------------------------------------
+// An open-addressed hash table of pointers to records in a ThreadDataArena,
+// which replaces the per-thread std::map<>s that used to be keyed by Location.
+// Only the owning thread may call Find() and Insert(), but any thread may call
+// GetRecords() at any time without a lock: slots are published with release
+// stores once the record they point to is fully constructed, and when the table
+// grows the old array is left in the arena, so a concurrent reader always walks
+// a valid (if possibly slightly stale) array.
+//
+// |Traits| must provide:
+//   typedef ... Key;
+//   static Key KeyOf(const Record& record);
+//   static size_t Hash(const Key& key);
+//   static bool Equals(const Key& a, const Key& b);
+
+template <typename Record, typename Traits>
+class ArenaHashTable {
+ public:
+  typedef typename Traits::Key Key;
+
+  ArenaHashTable() : table_(0), size_(0) {}
+
+  // Returns the record for |key|, or NULL. Owning thread only.
+  Record* Find(const Key& key) const {
+    const Table* table =
+        reinterpret_cast<const Table*>(base::subtle::NoBarrier_Load(&table_));
+    if (!table)
+      return NULL;
+    size_t i = Traits::Hash(key) & table->mask;
+    while (true) {
+      Record* record = reinterpret_cast<Record*>(
+          base::subtle::NoBarrier_Load(&table->slots[i]));
+      if (!record)
+        return NULL;
+      if (Traits::Equals(Traits::KeyOf(*record), key))
+        return record;
+      i = (i + 1) & table->mask;
+    }
+  }
+
+  // Adds |record|, whose key must not already be present. Owning thread only.
+  void Insert(Record* record, ThreadDataArena* arena) {
+    Table* table =
+        reinterpret_cast<Table*>(base::subtle::NoBarrier_Load(&table_));
+    if (!table || (size_ + 1) * 2 > table->mask + 1)
+      table = Grow(table, arena);
+    Store(table, record);
+    ++size_;
+  }
+
+  // Appends every record to |records|. May be called on any thread.
+  void GetRecords(std::vector<Record*>* records) const {
+    const Table* table =
+        reinterpret_cast<const Table*>(base::subtle::Acquire_Load(&table_));
+    if (!table)
+      return;
+    for (size_t i = 0; i <= table->mask; ++i) {
+      Record* record = reinterpret_cast<Record*>(
+          base::subtle::Acquire_Load(&table->slots[i]));
+      if (record)
+        records->push_back(record);
+    }
+  }
+
+  // Number of records. Owning thread only.
+  size_t size() const { return size_; }
+
+ private:
+  enum { kInitialCapacity = 16 };
+
+  struct Table {
+    size_t mask;
+    base::subtle::AtomicWord slots[1];
+  };
+
+  // Links |record| into the first free slot of its probe sequence, making it
+  // visible to readers.
+  static void Store(Table* table, Record* record) {
+    size_t i = Traits::Hash(Traits::KeyOf(*record)) & table->mask;
+    while (base::subtle::NoBarrier_Load(&table->slots[i]))
+      i = (i + 1) & table->mask;
+    base::subtle::Release_Store(&table->slots[i],
+        reinterpret_cast<base::subtle::AtomicWord>(record));
+  }
+
+  // Publishes a table twice the size of |old_table| (which may be NULL),
+  // holding all of its records.
+  Table* Grow(Table* old_table, ThreadDataArena* arena) {
+    size_t capacity = old_table ? (old_table->mask + 1) * 2 : kInitialCapacity;
+    Table* table = static_cast<Table*>(arena->Allocate(
+        sizeof(Table) + (capacity - 1) * sizeof(base::subtle::AtomicWord)));
+    table->mask = capacity - 1;
+    if (old_table) {
+      for (size_t i = 0; i <= old_table->mask; ++i) {
+        Record* record = reinterpret_cast<Record*>(
+            base::subtle::NoBarrier_Load(&old_table->slots[i]));
+        if (record)
+          Store(table, record);
+      }
+    }
+    base::subtle::Release_Store(&table_,
+        reinterpret_cast<base::subtle::AtomicWord>(table));
+    return table;
+  }
+
+  // The current Table. Written only by the owning thread.
+  base::subtle::AtomicWord table_;
+
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArenaHashTable);
+};
+
+// Mixes the bits of a pointer for use in ArenaHashTable traits.
+inline size_t HashPointer(const void* pointer) {
+  // The low bits of an aligned pointer carry no entropy, and the table masks
+  // off everything but the low bits, so fold the higher bits down.
+  uintptr_t value = reinterpret_cast<uintptr_t>(pointer) >> 3;
+  return static_cast<size_t>(value ^ (value >> 9) ^ (value >> 19));
+}
+
+}  // namespace tracked_objects
+
+#endif  // BASE_PROFILER_THREAD_DATA_ARENA_H_
@@ -0,0 +1,133 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/profiler/thread_data_arena.h"
+
+#include <new>
+
+#include "base/compiler_specific.h"
+#include "base/synchronization/cancellation_flag.h"
+#include "base/threading/platform_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace tracked_objects {
+
+namespace {
+
+struct TestRecord {
+  TestRecord(int key, int value) : key(key), value(value) {}
+
+  const int key;
+  int value;
+};
+
+struct TestTraits {
+  typedef int Key;
+  static int KeyOf(const TestRecord& record) { return record.key; }
+  static size_t Hash(int key) { return static_cast<size_t>(key); }
+  static bool Equals(int a, int b) { return a == b; }
+};
+
+typedef ArenaHashTable<TestRecord, TestTraits> TestTable;
+
+TestRecord* NewRecord(ThreadDataArena* arena, int key) {
+  return new(arena->Allocate(sizeof(TestRecord))) TestRecord(key, key * 2);
+}
+
+// Repeatedly walks a table that another thread is inserting into, checking
+// that every record it sees is fully constructed.
+class TableReader : public base::PlatformThread::Delegate {
+ public:
+  explicit TableReader(const TestTable* table)
+      : table_(table), passes_(0), bad_records_(0) {}
+
+  virtual void ThreadMain() OVERRIDE {
+    while (!stop_.IsSet()) {
+      std::vector<TestRecord*> records;
+      table_->GetRecords(&records);
+      for (size_t i = 0; i < records.size(); ++i) {
+        if (records[i]->value != records[i]->key * 2)
+          ++bad_records_;
+      }
+      ++passes_;
+    }
+  }
+
+  void Stop() { stop_.Set(); }
+  int passes() const { return passes_; }
+  int bad_records() const { return bad_records_; }
+
+ private:
+  const TestTable* table_;
+  base::CancellationFlag stop_;
+  int passes_;
+  int bad_records_;
+};
+
+}  // namespace
+
+TEST(ThreadDataArenaTest, Allocate) {
+  ThreadDataArena arena;
+  EXPECT_EQ(0u, arena.allocated_bytes());
+
+  char* first = static_cast<char*>(arena.Allocate(1));
+  char* second = static_cast<char*>(arena.Allocate(13));
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(first) %
+                ThreadDataArena::kAlignment);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(second) %
+                ThreadDataArena::kAlignment);
+  EXPECT_EQ(first + ThreadDataArena::kAlignment, second);
+  for (int i = 0; i < 13; ++i)
+    EXPECT_EQ(0, second[i]);
+  EXPECT_EQ(ThreadDataArena::kAlignment * 3, arena.allocated_bytes());
+
+  // Requests larger than a chunk still succeed.
+  char* big = static_cast<char*>(
+      arena.Allocate(ThreadDataArena::kChunkSize * 3));
+  big[ThreadDataArena::kChunkSize * 3 - 1] = 1;
+  EXPECT_EQ(ThreadDataArena::kAlignment * 3 + ThreadDataArena::kChunkSize * 3,
+            arena.allocated_bytes());
+}
+
+TEST(ThreadDataArenaTest, InsertAndFind) {
+  const int kNumRecords = 1000;
+  ThreadDataArena arena;
+  TestTable table;
+  EXPECT_EQ(NULL, table.Find(1));
+
+  for (int i = 0; i < kNumRecords; ++i)
+    table.Insert(NewRecord(&arena, i), &arena);
+  EXPECT_EQ(static_cast<size_t>(kNumRecords), table.size());
+
+  for (int i = 0; i < kNumRecords; ++i) {
+    TestRecord* record = table.Find(i);
+    ASSERT_TRUE(record);
+    EXPECT_EQ(i, record->key);
+  }
+  EXPECT_EQ(NULL, table.Find(kNumRecords));
+
+  std::vector<TestRecord*> records;
+  table.GetRecords(&records);
+  EXPECT_EQ(static_cast<size_t>(kNumRecords), records.size());
+}
+
+TEST(ThreadDataArenaTest, ConcurrentSnapshot) {
+  const int kNumRecords = 20000;
+  ThreadDataArena arena;
+  TestTable table;
+  TableReader reader(&table);
+  base::PlatformThreadHandle handle;
+  ASSERT_TRUE(base::PlatformThread::Create(0, &reader, &handle));
+
+  // Spread the keys out so that the probe sequences collide.
+  for (int i = 0; i < kNumRecords; ++i)
+    table.Insert(NewRecord(&arena, i * 64), &arena);
+
+  reader.Stop();
+  base::PlatformThread::Join(handle);
+  EXPECT_GT(reader.passes(), 0);
+  EXPECT_EQ(0, reader.bad_records());
+}
+
+}  // namespace tracked_objects
@@ -0,0 +1,243 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/shared_memory_ring.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "base/logging.h"
+#include "base/threading/platform_thread.h"
+
+namespace base {
+
+namespace {
+
+const uint32 kMagic = 0x52696e67;  // "Ring"
+
+// Keeps the fields each side writes on cache lines of their own.
+const size_t kCacheLineSize = 64;
+
+#if !defined(OS_LINUX) && !defined(OS_ANDROID)
+// Without a futex, the receiver yields this many times before it starts
+// sleeping.
+const int kSpinCount = 100;
+#endif
+
+bool IsPowerOfTwo(size_t value) {
+  return value && !(value & (value - 1));
+}
+
+}  // namespace
+
+// Lives at the start of the shared memory; the data follows it. The indices
+// run freely and are reduced modulo the capacity when used, so that
+// write_index - read_index is the number of bytes in the ring.
+struct SharedMemoryRing::Header {
+  uint32 magic;
+  uint32 capacity;
+  // Set by Shutdown().
+  subtle::Atomic32 shut_down;
+  char padding0[kCacheLineSize - 3 * sizeof(uint32)];
+
+  // Written only by the sender.
+  subtle::Atomic32 write_index;
+  // Bumped by every Send() and Shutdown(); the receiver sleeps on it.
+  subtle::Atomic32 sequence;
+  char padding1[kCacheLineSize - 2 * sizeof(uint32)];
+
+  // Written only by the receiver.
+  subtle::Atomic32 read_index;
+  // Non-zero while the receiver is, or is about to be, asleep.
+  subtle::Atomic32 receiver_waiting;
+  char padding2[kCacheLineSize - 2 * sizeof(uint32)];
+};
+
+SharedMemoryRing::SharedMemoryRing()
+    : header_(NULL),
+      data_(NULL),
+      capacity_(0),
+      corrupted_(false) {
+}
+
+SharedMemoryRing::~SharedMemoryRing() {
+  Close();
+}
+
+bool SharedMemoryRing::Create(size_t capacity) {
+  DCHECK(!header_);
+  if (!IsPowerOfTwo(capacity) || capacity > kMaxCapacity)
+    return false;
+  memory_.reset(new SharedMemory());
+  if (!memory_->CreateAndMapAnonymous(sizeof(Header) + capacity)) {
+    memory_.reset();
+    return false;
+  }
+  header_ = static_cast<Header*>(memory_->memory());
+  memset(header_, 0, sizeof(Header));
+  header_->magic = kMagic;
+  header_->capacity = capacity;
+  data_ = reinterpret_cast<char*>(header_ + 1);
+  capacity_ = capacity;
+  return true;
+}
+
+bool SharedMemoryRing::Open(SharedMemoryHandle handle) {
+  DCHECK(!header_);
+  memory_.reset(new SharedMemory(handle, false));
+  // The capacity is only known once the header is mapped.
+  if (!memory_->Map(sizeof(Header))) {
+    memory_.reset();
+    return false;
+  }
+  const Header* header = static_cast<const Header*>(memory_->memory());
+  uint32 magic = header->magic;
+  size_t capacity = header->capacity;
+  memory_->Unmap();
+  if (magic != kMagic || !IsPowerOfTwo(capacity) ||
+      capacity > kMaxCapacity || !memory_->Map(sizeof(Header) + capacity)) {
+    memory_.reset();
+    return false;
+  }
+  header_ = static_cast<Header*>(memory_->memory());
+  data_ = reinterpret_cast<char*>(header_ + 1);
+  capacity_ = capacity;
+  return true;
+}
+
+bool SharedMemoryRing::ShareToProcess(ProcessHandle process,
+                                      SharedMemoryHandle* new_handle) {
+  return memory_.get() && memory_->ShareToProcess(process, new_handle);
+}
+
+void SharedMemoryRing::Close() {
+  memory_.reset();
+  header_ = NULL;
+  data_ = NULL;
+  capacity_ = 0;
+}
+
+int64 SharedMemoryRing::Available() const {
+  uint32 write_index = subtle::Acquire_Load(&header_->write_index);
+  uint32 read_index = subtle::Acquire_Load(&header_->read_index);
+  uint32 available = write_index - read_index;
+  if (available > capacity_)
+    return -1;
+  return available;
+}
+
+size_t SharedMemoryRing::Send(const void* buffer, size_t length) {
+  DCHECK_GT(length, 0u);
+  if (!header_ || corrupted_ || length > capacity_ ||
+      subtle::Acquire_Load(&header_->shut_down)) {
+    return 0;
+  }
+  int64 available = Available();
+  if (available < 0) {
+    corrupted_ = true;
+    return 0;
+  }
+  if (length > capacity_ - available)
+    return 0;
+
+  uint32 write_index = subtle::NoBarrier_Load(&header_->write_index);
+  size_t offset = write_index & (capacity_ - 1);
+  size_t first = std::min(length, capacity_ - offset);
+  const char* bytes = static_cast<const char*>(buffer);
+  memcpy(data_ + offset, bytes, first);
+  memcpy(data_, bytes + first, length - first);
+  subtle::Release_Store(&header_->write_index, write_index + length);
+  WakeReceiver();
+  return length;
+}
+
+size_t SharedMemoryRing::Receive(void* buffer, size_t length) {
+  DCHECK_GT(length, 0u);
+  if (!header_ || corrupted_ || length > capacity_)
+    return 0;
+
+  while (true) {
+    int64 available = Available();
+    if (available < 0) {
+      corrupted_ = true;
+      return 0;
+    }
+    if (available >= static_cast<int64>(length))
+      break;
+    if (subtle::Acquire_Load(&header_->shut_down))
+      return 0;
+
+    // Announce the wait before sampling the sequence number, and check for
+    // data once more after, so a Send() in between is not missed: either it
+    // sees |receiver_waiting| and wakes us, or we see its data.
+    subtle::Barrier_AtomicIncrement(&header_->receiver_waiting, 1);
+    subtle::Atomic32 sequence = subtle::Acquire_Load(&header_->sequence);
+    available = Available();
+    if (available >= 0 && available < static_cast<int64>(length) &&
+        !subtle::Acquire_Load(&header_->shut_down)) {
+      Wait(sequence);
+    }
+    subtle::Barrier_AtomicIncrement(&header_->receiver_waiting, -1);
+  }
+
+  uint32 read_index = subtle::NoBarrier_Load(&header_->read_index);
+  size_t offset = read_index & (capacity_ - 1);
+  size_t first = std::min(length, capacity_ - offset);
+  char* bytes = static_cast<char*>(buffer);
+  memcpy(bytes, data_ + offset, first);
+  memcpy(bytes + first, data_, length - first);
+  subtle::Release_Store(&header_->read_index, read_index + length);
+  return length;
+}
+
+size_t SharedMemoryRing::Peek() {
+  if (!header_ || corrupted_)
+    return 0;
+  int64 available = Available();
+  return available < 0 ? 0 : static_cast<size_t>(available);
+}
+
+bool SharedMemoryRing::Shutdown() {
+  if (!header_)
+    return false;
+  subtle::Release_Store(&header_->shut_down, 1);
+  WakeReceiver();
+  return true;
+}
+
+void SharedMemoryRing::WakeReceiver() {
+  // The full barrier orders the caller's stores before the load of
+  // |receiver_waiting|; see Receive().
+  subtle::Barrier_AtomicIncrement(&header_->sequence, 1);
+  if (!subtle::NoBarrier_Load(&header_->receiver_waiting))
+    return;
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  // Not FUTEX_PRIVATE_FLAG: the receiver is in another process.
+  syscall(__NR_futex, &header_->sequence, FUTEX_WAKE, 1, NULL, NULL, 0);
+#endif
+}
+
+void SharedMemoryRing::Wait(subtle::Atomic32 sequence) {
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  // Returns at once if |sequence| is already stale.
+  syscall(__NR_futex, &header_->sequence, FUTEX_WAIT, sequence, NULL, NULL,
+          0);
+#else
+  for (int i = 0; i < kSpinCount; ++i) {
+    if (subtle::Acquire_Load(&header_->sequence) != sequence)
+      return;
+    PlatformThread::YieldCurrentThread();
+  }
+  PlatformThread::Sleep(1);
+#endif
+}
+
+}  // namespace base
@@ -0,0 +1,102 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_SHARED_MEMORY_RING_H_
+#define BASE_SHARED_MEMORY_RING_H_
+#pragma once
+
+// A single-producer, single-consumer byte ring in shared memory, with the
+// same Send()/Receive()/Shutdown() interface as CancelableSyncSocket.
+//
+// CancelableSyncSocket costs a send() and a recv() system call per message.
+// The ring moves the data through shared memory with no locks, and only
+// enters the kernel when the receiver has to sleep: on Linux and Android
+// the receiver sleeps on a futex in the shared memory, so a Send() to a
+// receiver that is already awake is a couple of memcpy()s and atomic
+// stores. Other platforms have no futex that works across processes, so
+// there the receiver polls, briefly spinning and then sleeping a
+// millisecond at a time.
+//
+// One process Create()s the ring and passes a handle from ShareToProcess()
+// to the other, which Open()s it. One side only sends, the other only
+// receives. The two sides don't trust each other: the indices in shared
+// memory are checked before every use, and a ring found corrupted fails
+// every later call.
+
+#include "base/atomicops.h"
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/process.h"
+#include "base/shared_memory.h"
+
+namespace base {
+
+class BASE_EXPORT SharedMemoryRing {
+ public:
+  SharedMemoryRing();
+  ~SharedMemoryRing();
+
+  // Creates a ring that holds |capacity| bytes, which must be a power of two
+  // no larger than kMaxCapacity.
+  bool Create(size_t capacity);
+
+  // Maps a ring another process created. Takes ownership of |handle|.
+  bool Open(SharedMemoryHandle handle);
+
+  // Duplicates the handle for |process|, which should Open() it.
+  bool ShareToProcess(ProcessHandle process, SharedMemoryHandle* new_handle);
+
+  // Unmaps the ring. The other side is not told; call Shutdown() first if
+  // it may be blocked in Receive().
+  void Close();
+
+  // Copies |length| bytes into the ring and wakes the receiver. Never
+  // blocks. Returns |length|, or 0 if the ring doesn't have room for all of
+  // it, has been shut down, or is corrupted.
+  size_t Send(const void* buffer, size_t length);
+
+  // Waits until |length| bytes are available, and copies them to |buffer|.
+  // Returns |length|, or 0 if the ring was shut down, or is corrupted.
+  size_t Receive(void* buffer, size_t length);
+
+  // Returns the number of bytes Receive() can take without waiting.
+  size_t Peek();
+
+  // Makes the receiver's pending and later Receive()s, and every later
+  // Send(), fail. Either side may call it, from any thread.
+  bool Shutdown();
+
+  size_t capacity() const { return capacity_; }
+
+  enum { kMaxCapacity = 1 << 24 };
+
+ private:
+  struct Header;
+
+  // Maps the header and data of a ring whose shared memory is |memory_|.
+  bool MapRing();
+
+  // Returns the bytes waiting in the ring, or -1 if it is corrupted.
+  int64 Available() const;
+
+  // Blocks until the sequence number moves past |sequence| or a spurious
+  // wakeup, whichever comes first.
+  void Wait(subtle::Atomic32 sequence);
+  void WakeReceiver();
+
+  scoped_ptr<SharedMemory> memory_;
+  Header* header_;
+  char* data_;
+  // A private copy, so the other side can't change it under us.
+  size_t capacity_;
+  // Set once the shared indices were found inconsistent.
+  bool corrupted_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedMemoryRing);
+};
+
+}  // namespace base
+
+#endif  // BASE_SHARED_MEMORY_RING_H_
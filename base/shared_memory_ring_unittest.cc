@@ -0,0 +1,111 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/shared_memory_ring.h"
+
+#include <string.h>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/process_util.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const size_t kCapacity = 64;
+
+// Creates a ring in |sender| and opens it, as another process would, in
+// |receiver|.
+void CreatePair(SharedMemoryRing* sender, SharedMemoryRing* receiver) {
+  ASSERT_TRUE(sender->Create(kCapacity));
+  SharedMemoryHandle handle;
+  ASSERT_TRUE(sender->ShareToProcess(GetCurrentProcessHandle(), &handle));
+  ASSERT_TRUE(receiver->Open(handle));
+  EXPECT_EQ(kCapacity, receiver->capacity());
+}
+
+void SendUint32s(SharedMemoryRing* ring, uint32 count) {
+  for (uint32 i = 0; i < count; ) {
+    if (ring->Send(&i, sizeof(i)))
+      ++i;
+    else
+      PlatformThread::YieldCurrentThread();
+  }
+}
+
+void ShutdownRing(SharedMemoryRing* ring) {
+  ring->Shutdown();
+}
+
+}  // namespace
+
+TEST(SharedMemoryRingTest, CreateRejectsBadCapacities) {
+  SharedMemoryRing ring;
+  EXPECT_FALSE(ring.Create(0));
+  EXPECT_FALSE(ring.Create(100));
+  EXPECT_FALSE(ring.Create(SharedMemoryRing::kMaxCapacity * 2));
+}
+
+TEST(SharedMemoryRingTest, SendAndReceive) {
+  SharedMemoryRing sender;
+  SharedMemoryRing receiver;
+  CreatePair(&sender, &receiver);
+  EXPECT_EQ(0U, receiver.Peek());
+
+  char buffer[kCapacity];
+  // Go around the ring a few times, so messages straddle the end.
+  for (int i = 0; i < 10; ++i) {
+    const char kMessage[] = "twenty-one bytes long";
+    EXPECT_EQ(sizeof(kMessage), sender.Send(kMessage, sizeof(kMessage)));
+    EXPECT_EQ(sizeof(kMessage), receiver.Peek());
+    EXPECT_EQ(sizeof(kMessage), receiver.Receive(buffer, sizeof(kMessage)));
+    EXPECT_EQ(0, memcmp(kMessage, buffer, sizeof(kMessage)));
+  }
+
+  // Send() never blocks: it fails when the ring has no room.
+  memset(buffer, 'x', sizeof(buffer));
+  EXPECT_EQ(kCapacity - 1, sender.Send(buffer, kCapacity - 1));
+  EXPECT_EQ(0U, sender.Send(buffer, 2));
+  EXPECT_EQ(1U, sender.Send(buffer, 1));
+  EXPECT_EQ(kCapacity, receiver.Receive(buffer, kCapacity));
+}
+
+TEST(SharedMemoryRingTest, ReceiveWaitsForSender) {
+  SharedMemoryRing sender;
+  SharedMemoryRing receiver;
+  CreatePair(&sender, &receiver);
+
+  Thread thread("SharedMemoryRingSender");
+  ASSERT_TRUE(thread.Start());
+  const uint32 kCount = 10000;
+  thread.message_loop()->PostTask(
+      FROM_HERE, Bind(&SendUint32s, Unretained(&sender), kCount));
+  for (uint32 i = 0; i < kCount; ++i) {
+    uint32 value = 0;
+    ASSERT_EQ(sizeof(value), receiver.Receive(&value, sizeof(value)));
+    ASSERT_EQ(i, value);
+  }
+  thread.Stop();
+}
+
+TEST(SharedMemoryRingTest, ShutdownWakesReceiver) {
+  SharedMemoryRing sender;
+  SharedMemoryRing receiver;
+  CreatePair(&sender, &receiver);
+
+  Thread thread("SharedMemoryRingShutdown");
+  ASSERT_TRUE(thread.Start());
+  thread.message_loop()->PostDelayedTask(
+      FROM_HERE, Bind(&ShutdownRing, Unretained(&sender)),
+      TimeDelta::FromMilliseconds(10));
+  uint32 value = 0;
+  EXPECT_EQ(0U, receiver.Receive(&value, sizeof(value)));
+  thread.Stop();
+  EXPECT_EQ(0U, sender.Send(&value, sizeof(value)));
+}
+
+}  // namespace base
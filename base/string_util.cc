@@ -443,28 +443,18 @@ bool WideToLatin1(const std::wstring& wide, std::string* latin1) {
   return true;
 }
 
-template<class STR>
-static bool DoIsStringASCII(const STR& str) {
-  for (size_t i = 0; i < str.length(); i++) {
-    typename ToUnsigned<typename STR::value_type>::Unsigned c = str[i];
-    if (c > 0x7F)
-      return false;
-  }
-  return true;
-}
-
 bool IsStringASCII(const std::wstring& str) {
-  return DoIsStringASCII(str);
+  return base::CountLeadingASCII(str.data(), str.length()) == str.length();
 }
 
 #if !defined(WCHAR_T_IS_UTF16)
 bool IsStringASCII(const string16& str) {
-  return DoIsStringASCII(str);
+  return base::CountLeadingASCII(str.data(), str.length()) == str.length();
 }
 #endif
 
 bool IsStringASCII(const base::StringPiece& str) {
-  return DoIsStringASCII(str);
+  return base::CountLeadingASCII(str.data(), str.length()) == str.length();
 }
 
 bool IsStringUTF8(const std::string& str) {
@@ -473,6 +463,13 @@ bool IsStringUTF8(const std::string& str) {
   int32 char_index = 0;
 
   while (char_index < src_len) {
+    // ASCII characters are always valid, so skip over runs of them at once.
+    if (static_cast<unsigned char>(src[char_index]) < 0x80) {
+      char_index += static_cast<int32>(
+          base::CountLeadingASCII(src + char_index, src_len - char_index));
+      continue;
+    }
+
     int32 code_point;
     CBU8_NEXT(src, char_index, src_len, code_point);
     if (!base::IsValidCharacter(code_point))
@@ -402,6 +402,40 @@ TEST(StringUtilTest, IsStringUTF8) {
   EXPECT_FALSE(IsStringUTF8("embedded\xc0\x80U+0000"));
 }
 
+// IsStringASCII() and IsStringUTF8() check blocks of characters at a time,
+// so put a non-ASCII character at every position of strings of various
+// lengths.
+TEST(StringUtilTest, IsStringASCIIAndUTF8Runs) {
+  for (size_t length = 0; length < 40; ++length) {
+    std::string ascii(length, 'a');
+    EXPECT_TRUE(IsStringASCII(ascii));
+    EXPECT_TRUE(IsStringASCII(string16(length, 'a')));
+    EXPECT_TRUE(IsStringASCII(std::wstring(length, L'a')));
+    EXPECT_TRUE(IsStringUTF8(ascii));
+
+    for (size_t position = 0; position < length; ++position) {
+      std::string utf8(ascii);
+      utf8.replace(position, 1, "\xc3\xa9");
+      EXPECT_FALSE(IsStringASCII(utf8)) << length << " " << position;
+      EXPECT_TRUE(IsStringUTF8(utf8)) << length << " " << position;
+
+      string16 utf16(length, 'a');
+      utf16[position] = 0x100;
+      EXPECT_FALSE(IsStringASCII(utf16)) << length << " " << position;
+      utf16[position] = 0x80;
+      EXPECT_FALSE(IsStringASCII(utf16)) << length << " " << position;
+
+      std::wstring wide(length, L'a');
+      wide[position] = 0x80;
+      EXPECT_FALSE(IsStringASCII(wide));
+
+      std::string invalid(ascii);
+      invalid[position] = '\xff';
+      EXPECT_FALSE(IsStringUTF8(invalid)) << length << " " << position;
+    }
+  }
+}
+
 TEST(StringUtilTest, ConvertASCII) {
   static const char* char_cases[] = {
     "Google Video",
@@ -4,6 +4,8 @@
 
 #include "base/threading/sequenced_worker_pool.h"
 
+#include <algorithm>
+#include <deque>
 #include <list>
 #include <map>
 #include <set>
@@ -23,6 +25,7 @@
 #include "base/synchronization/lock.h"
 #include "base/threading/platform_thread.h"
 #include "base/threading/simple_thread.h"
+#include "base/threading/thread_local.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/time.h"
 #include "base/tracked_objects.h"
@@ -35,6 +38,10 @@ namespace base {
 
 namespace {
 
+// Number of independently locked buckets the per-sequence queues are spread
+// over in WORK_STEALING mode.
+const int kNumSequenceShards = 16;
+
 struct SequencedTask {
   SequencedTask()
       : sequence_token_id(0),
@@ -283,8 +290,11 @@ class SequencedWorkerPool::Worker : public SimpleThread {
     return running_sequence_;
   }
 
+  int thread_number() const { return thread_number_; }
+
  private:
   scoped_refptr<SequencedWorkerPool> worker_pool_;
+  const int thread_number_;
   SequenceToken running_sequence_;
 
   DISALLOW_COPY_AND_ASSIGN(Worker);
@@ -298,6 +308,7 @@ class SequencedWorkerPool::Inner {
   // by it).
   Inner(SequencedWorkerPool* worker_pool, size_t max_threads,
         const std::string& thread_name_prefix,
+        SchedulingMode mode,
         TestingObserver* observer);
 
   ~Inner();
@@ -383,6 +394,50 @@ class SequencedWorkerPool::Inner {
   // called inside the lock.
   bool CanShutdown() const;
 
+  // WORK_STEALING counterparts of the functions above. None of these take
+  // |lock_| on the per-task path; see the comment above |worker_queues_|.
+  bool WorkStealingPostTask(const std::string* optional_token_name,
+                            SequenceToken sequence_token,
+                            WorkerShutdown shutdown_behavior,
+                            const tracked_objects::Location& from_here,
+                            const Closure& task);
+  void WorkStealingThreadLoop(Worker* this_worker);
+  void WorkStealingFlushForTesting();
+  void WorkStealingShutdown();
+
+  // Appends |item| to the deque of the calling worker, or to a round-robin
+  // chosen deque when called from outside the pool. |item| is either an
+  // unsequenced task, or a placeholder carrying only the sequence token id
+  // which means "run the head of that sequence's queue".
+  void EnqueueWorkItem(const SequencedTask& item);
+
+  // Pops from the front of the deque at |queue_index|, or steals from the
+  // back of another worker's deque if that one is empty. Returns false if
+  // no work item was found.
+  bool TakeWorkItem(size_t queue_index, SequencedTask* item);
+
+  // Runs (or, when shutting down, discards) the task described by |item| on
+  // |this_worker| and reschedules its sequence if it has more tasks.
+  void RunWorkItem(Worker* this_worker, const SequencedTask& item);
+
+  // Wakes a sleeping worker, or starts a new one if all of them are busy.
+  void WakeOrStartWorker();
+
+  // Blocks the calling worker until work is enqueued or it should exit.
+  void WaitForWork();
+
+  // Returns true once shutdown has started and nothing that blocks shutdown
+  // remains queued, so that worker threads may exit.
+  bool WorkStealingShouldExit() const;
+
+  // Decrements one of the blocking-shutdown counters, waking Shutdown() and
+  // the sleeping workers if it reached zero while shutting down.
+  void DecrementBlockingShutdownCount(volatile subtle::Atomic32* count);
+
+  // Checks whether there is work left that's blocking shutdown in
+  // WORK_STEALING mode. Must be called inside the lock.
+  bool WorkStealingCanShutdown() const;
+
   SequencedWorkerPool* const worker_pool_;
 
   // The last sequence number used. Managed by GetSequenceToken, since this
@@ -453,6 +508,57 @@ class SequencedWorkerPool::Inner {
 
   TestingObserver* const testing_observer_;
 
+  const SchedulingMode mode_;
+
+  // Everything below is only used in WORK_STEALING mode. There |lock_| only
+  // guards |threads_|, |named_sequence_tokens_| and |shutdown_called_|, and
+  // is taken per task only on the transitions waited on by Shutdown() and
+  // FlushForTesting().
+
+  // A deque of pending work items, one per potential worker thread. Indexed
+  // by thread number minus one.
+  struct WorkerQueue {
+    Lock lock;
+    std::deque<SequencedTask> items;
+  };
+  std::vector<linked_ptr<WorkerQueue> > worker_queues_;
+
+  // Pending tasks of every sequence that has a task queued or running,
+  // keyed by sequence token id and sharded by id. A sequence is scheduled
+  // (has a placeholder in some deque or is being run) exactly when its
+  // queue is non-empty; the running task stays at the front of its queue
+  // until it has finished.
+  struct SequenceShard {
+    Lock lock;
+    std::map<int, std::deque<SequencedTask> > sequences;
+  };
+  SequenceShard sequence_shards_[kNumSequenceShards];
+
+  // The worker running on the current thread, if it belongs to this pool.
+  ThreadLocalPointer<Worker> current_worker_;
+
+  // Workers with nothing to do wait on |sleep_cv_|. Posters only take
+  // |sleep_lock_| when |sleeping_thread_count_| says someone is waiting.
+  Lock sleep_lock_;
+  ConditionVariable sleep_cv_;
+
+  volatile subtle::Atomic32 started_thread_count_;
+  volatile subtle::Atomic32 sleeping_thread_count_;
+  volatile subtle::Atomic32 round_robin_index_;
+
+  // Number of items currently sitting in |worker_queues_|.
+  volatile subtle::Atomic32 queued_item_count_;
+
+  // Number of tasks posted and not yet run or discarded.
+  volatile subtle::Atomic32 outstanding_task_count_;
+
+  // BLOCK_SHUTDOWN tasks that are queued, and that are running.
+  volatile subtle::Atomic32 blocking_shutdown_pending_count_;
+  volatile subtle::Atomic32 blocking_shutdown_running_count_;
+
+  // Lock-free mirror of |shutdown_called_|.
+  volatile subtle::Atomic32 shutdown_flag_;
+
   DISALLOW_COPY_AND_ASSIGN(Inner);
 };
 
@@ -464,7 +570,8 @@ SequencedWorkerPool::Worker::Worker(
     const std::string& prefix)
     : SimpleThread(
           prefix + StringPrintf("Worker%d", thread_number).c_str()),
-      worker_pool_(worker_pool) {
+      worker_pool_(worker_pool),
+      thread_number_(thread_number) {
   Start();
 }
 
@@ -488,6 +595,7 @@ SequencedWorkerPool::Inner::Inner(
     SequencedWorkerPool* worker_pool,
     size_t max_threads,
     const std::string& thread_name_prefix,
+    SchedulingMode mode,
     TestingObserver* observer)
     : worker_pool_(worker_pool),
       last_sequence_number_(0),
@@ -503,7 +611,22 @@ SequencedWorkerPool::Inner::Inner(
       pending_task_count_(0),
       blocking_shutdown_pending_task_count_(0),
       shutdown_called_(false),
-      testing_observer_(observer) {}
+      testing_observer_(observer),
+      mode_(mode),
+      sleep_cv_(&sleep_lock_),
+      started_thread_count_(0),
+      sleeping_thread_count_(0),
+      round_robin_index_(0),
+      queued_item_count_(0),
+      outstanding_task_count_(0),
+      blocking_shutdown_pending_count_(0),
+      blocking_shutdown_running_count_(0),
+      shutdown_flag_(0) {
+  if (mode_ == WORK_STEALING) {
+    for (size_t i = 0; i < max_threads_; ++i)
+      worker_queues_.push_back(make_linked_ptr(new WorkerQueue));
+  }
+}
 
 SequencedWorkerPool::Inner::~Inner() {
   // You must call Shutdown() before destroying the pool.
@@ -538,6 +661,11 @@ bool SequencedWorkerPool::Inner::PostTask(
     WorkerShutdown shutdown_behavior,
     const tracked_objects::Location& from_here,
     const Closure& task) {
+  if (mode_ == WORK_STEALING) {
+    return WorkStealingPostTask(optional_token_name, sequence_token,
+                                shutdown_behavior, from_here, task);
+  }
+
   SequencedTask sequenced;
   sequenced.sequence_token_id = sequence_token.id_;
   sequenced.shutdown_behavior = shutdown_behavior;
@@ -587,6 +715,10 @@ bool SequencedWorkerPool::Inner::IsRunningSequenceOnCurrentThread(
 }
 
 void SequencedWorkerPool::Inner::FlushForTesting() {
+  if (mode_ == WORK_STEALING) {
+    WorkStealingFlushForTesting();
+    return;
+  }
   AutoLock lock(lock_);
   while (!IsIdle())
     is_idle_cv_.Wait();
@@ -601,6 +733,10 @@ void SequencedWorkerPool::Inner::Shutdown() {
   // required to run on shutdown. Since no new tasks will get posted once the
   // terminated flag is set, this ensures that all remaining tasks are required
   // for shutdown whenever the termianted_ flag is set.
+  if (mode_ == WORK_STEALING) {
+    WorkStealingShutdown();
+    return;
+  }
   {
     AutoLock lock(lock_);
 
@@ -636,6 +772,10 @@ void SequencedWorkerPool::Inner::Shutdown() {
 }
 
 void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
+  if (mode_ == WORK_STEALING) {
+    WorkStealingThreadLoop(this_worker);
+    return;
+  }
   {
     AutoLock lock(lock_);
     DCHECK(thread_being_created_);
@@ -916,7 +1056,14 @@ void SequencedWorkerPool::Inner::FinishStartingAdditionalThread(
 }
 
 void SequencedWorkerPool::Inner::SignalHasWork() {
-  has_work_cv_.Signal();
+  if (mode_ == WORK_STEALING) {
+    // Taking |sleep_lock_| pairs with the check in WaitForWork() so that a
+    // worker about to sleep can't miss this signal.
+    AutoLock lock(sleep_lock_);
+    sleep_cv_.Signal();
+  } else {
+    has_work_cv_.Signal();
+  }
   if (testing_observer_) {
     testing_observer_->OnHasWork();
   }
@@ -930,6 +1077,324 @@ bool SequencedWorkerPool::Inner::CanShutdown() const {
          blocking_shutdown_pending_task_count_ == 0;
 }
 
+bool SequencedWorkerPool::Inner::WorkStealingPostTask(
+    const std::string* optional_token_name,
+    SequenceToken sequence_token,
+    WorkerShutdown shutdown_behavior,
+    const tracked_objects::Location& from_here,
+    const Closure& task) {
+  SequencedTask sequenced;
+  sequenced.sequence_token_id = sequence_token.id_;
+  sequenced.shutdown_behavior = shutdown_behavior;
+  sequenced.location = from_here;
+  sequenced.task = task;
+
+  // Count the task as blocking shutdown before checking the flag. Paired
+  // with the barrier in WorkStealingShutdown(), either Shutdown() sees this
+  // task or we see that shutdown has started.
+  if (shutdown_behavior == BLOCK_SHUTDOWN)
+    subtle::Barrier_AtomicIncrement(&blocking_shutdown_pending_count_, 1);
+  if (subtle::Acquire_Load(&shutdown_flag_)) {
+    if (shutdown_behavior == BLOCK_SHUTDOWN)
+      DecrementBlockingShutdownCount(&blocking_shutdown_pending_count_);
+    return false;
+  }
+
+  if (optional_token_name) {
+    AutoLock lock(lock_);
+    sequenced.sequence_token_id = LockedGetNamedTokenID(*optional_token_name);
+  }
+
+  subtle::NoBarrier_AtomicIncrement(&outstanding_task_count_, 1);
+
+  if (!sequenced.sequence_token_id) {
+    EnqueueWorkItem(sequenced);
+    WakeOrStartWorker();
+    return true;
+  }
+
+  SequenceShard* shard =
+      &sequence_shards_[sequenced.sequence_token_id % kNumSequenceShards];
+  {
+    AutoLock lock(shard->lock);
+    std::deque<SequencedTask>& sequence =
+        shard->sequences[sequenced.sequence_token_id];
+    sequence.push_back(sequenced);
+    // Something is already queued or running for this sequence; whoever
+    // runs it will pick this task up afterwards.
+    if (sequence.size() > 1)
+      return true;
+  }
+
+  SequencedTask placeholder;
+  placeholder.sequence_token_id = sequenced.sequence_token_id;
+  EnqueueWorkItem(placeholder);
+  WakeOrStartWorker();
+  return true;
+}
+
+void SequencedWorkerPool::Inner::WorkStealingThreadLoop(Worker* this_worker) {
+  {
+    AutoLock lock(lock_);
+    std::pair<ThreadMap::iterator, bool> result =
+        threads_.insert(
+            std::make_pair(this_worker->tid(), make_linked_ptr(this_worker)));
+    DCHECK(result.second);
+  }
+  current_worker_.Set(this_worker);
+
+  const size_t queue_index = this_worker->thread_number() - 1;
+  while (true) {
+#if defined(OS_MACOSX)
+    base::mac::ScopedNSAutoreleasePool autorelease_pool;
+#endif
+
+    SequencedTask item;
+    if (TakeWorkItem(queue_index, &item)) {
+      // Work is still queued behind this item and every worker is busy, so
+      // another thread may help.
+      if (subtle::Acquire_Load(&queued_item_count_) > 0)
+        WakeOrStartWorker();
+      RunWorkItem(this_worker, item);
+      continue;
+    }
+
+    if (WorkStealingShouldExit())
+      break;
+    WaitForWork();
+  }
+
+  current_worker_.Set(NULL);
+}
+
+void SequencedWorkerPool::Inner::WorkStealingFlushForTesting() {
+  AutoLock lock(lock_);
+  while (subtle::Acquire_Load(&outstanding_task_count_) != 0)
+    is_idle_cv_.Wait();
+}
+
+void SequencedWorkerPool::Inner::WorkStealingShutdown() {
+  {
+    AutoLock lock(lock_);
+    if (shutdown_called_)
+      return;
+    shutdown_called_ = true;
+  }
+  subtle::NoBarrier_Store(&shutdown_flag_, 1);
+  subtle::MemoryBarrier();
+
+  // Let the sleeping workers either exit or drain what is left.
+  {
+    AutoLock lock(sleep_lock_);
+    sleep_cv_.Broadcast();
+  }
+  if (testing_observer_)
+    testing_observer_->OnHasWork();
+
+  {
+    AutoLock lock(lock_);
+    if (WorkStealingCanShutdown())
+      return;
+  }
+
+  if (testing_observer_)
+    testing_observer_->WillWaitForShutdown();
+
+  TimeTicks shutdown_wait_begin = TimeTicks::Now();
+
+  {
+    base::ThreadRestrictions::ScopedAllowWait allow_wait;
+    AutoLock lock(lock_);
+    while (!WorkStealingCanShutdown())
+      can_shutdown_cv_.Wait();
+  }
+  UMA_HISTOGRAM_TIMES("SequencedWorkerPool.ShutdownDelayTime",
+                      TimeTicks::Now() - shutdown_wait_begin);
+}
+
+void SequencedWorkerPool::Inner::EnqueueWorkItem(const SequencedTask& item) {
+  size_t queue_index;
+  Worker* worker = current_worker_.Get();
+  if (worker) {
+    queue_index = worker->thread_number() - 1;
+  } else {
+    // Spread the work over the workers that exist (or are being started),
+    // so that a burst of posts from one thread doesn't pile up in a single
+    // deque waiting to be stolen.
+    uint32 started = static_cast<uint32>(
+        subtle::Acquire_Load(&started_thread_count_));
+    started = std::max(1u, std::min(started,
+                                    static_cast<uint32>(max_threads_)));
+    uint32 ticket = static_cast<uint32>(
+        subtle::NoBarrier_AtomicIncrement(&round_robin_index_, 1));
+    queue_index = ticket % started;
+  }
+
+  WorkerQueue* queue = worker_queues_[queue_index].get();
+  {
+    AutoLock lock(queue->lock);
+    queue->items.push_back(item);
+  }
+  subtle::Barrier_AtomicIncrement(&queued_item_count_, 1);
+}
+
+bool SequencedWorkerPool::Inner::TakeWorkItem(size_t queue_index,
+                                              SequencedTask* item) {
+  if (subtle::Acquire_Load(&queued_item_count_) == 0)
+    return false;
+
+  const size_t queue_count = worker_queues_.size();
+  for (size_t i = 0; i < queue_count; ++i) {
+    WorkerQueue* queue = worker_queues_[(queue_index + i) % queue_count].get();
+    AutoLock lock(queue->lock);
+    if (queue->items.empty())
+      continue;
+    // The owner takes the oldest item so that tasks posted from one thread
+    // roughly keep their order. Thieves take the newest, which is the work
+    // the owner would reach last.
+    if (i == 0) {
+      *item = queue->items.front();
+      queue->items.pop_front();
+    } else {
+      *item = queue->items.back();
+      queue->items.pop_back();
+    }
+    subtle::NoBarrier_AtomicIncrement(&queued_item_count_, -1);
+    return true;
+  }
+  return false;
+}
+
+void SequencedWorkerPool::Inner::RunWorkItem(Worker* this_worker,
+                                             const SequencedTask& item) {
+  const int sequence_token_id = item.sequence_token_id;
+  SequenceShard* shard =
+      &sequence_shards_[sequence_token_id % kNumSequenceShards];
+
+  SequencedTask task;
+  if (sequence_token_id) {
+    AutoLock lock(shard->lock);
+    std::map<int, std::deque<SequencedTask> >::iterator found =
+        shard->sequences.find(sequence_token_id);
+    DCHECK(found != shard->sequences.end());
+    DCHECK(!found->second.empty());
+    task = found->second.front();
+  } else {
+    task = item;
+  }
+
+  // Same rule as GetWork(): once shutting down, only BLOCK_SHUTDOWN tasks
+  // still run. Since only the head of a sequence is ever looked at, we never
+  // discard a task that is ordered after one that's still running.
+  if (!subtle::Acquire_Load(&shutdown_flag_) ||
+      task.shutdown_behavior == BLOCK_SHUTDOWN) {
+    if (task.shutdown_behavior == BLOCK_SHUTDOWN) {
+      // Increment the running count first so that the two counts are never
+      // both zero while the task moves from one to the other.
+      subtle::Barrier_AtomicIncrement(&blocking_shutdown_running_count_, 1);
+      DecrementBlockingShutdownCount(&blocking_shutdown_pending_count_);
+    }
+
+    this_worker->set_running_sequence(SequenceToken(sequence_token_id));
+    task.task.Run();
+    this_worker->set_running_sequence(SequenceToken());
+
+    if (task.shutdown_behavior == BLOCK_SHUTDOWN)
+      DecrementBlockingShutdownCount(&blocking_shutdown_running_count_);
+  }
+  task.task = Closure();
+
+  if (sequence_token_id) {
+    // Keep the queue's copy of the closure alive until the shard lock is
+    // released, in case its destruction posts more tasks.
+    Closure delete_outside_lock;
+    bool has_more_tasks = false;
+    {
+      AutoLock lock(shard->lock);
+      std::map<int, std::deque<SequencedTask> >::iterator found =
+          shard->sequences.find(sequence_token_id);
+      delete_outside_lock = found->second.front().task;
+      found->second.pop_front();
+      if (found->second.empty())
+        shard->sequences.erase(found);
+      else
+        has_more_tasks = true;
+    }
+    // The placeholder goes back to our own deque. Any idle worker may steal
+    // it, but nobody else can run this sequence concurrently since there is
+    // only ever one placeholder per sequence.
+    if (has_more_tasks)
+      EnqueueWorkItem(item);
+  }
+
+  if (subtle::Barrier_AtomicIncrement(&outstanding_task_count_, -1) == 0) {
+    AutoLock lock(lock_);
+    is_idle_cv_.Broadcast();
+  }
+}
+
+void SequencedWorkerPool::Inner::WakeOrStartWorker() {
+  if (subtle::Acquire_Load(&sleeping_thread_count_) > 0) {
+    SignalHasWork();
+    return;
+  }
+
+  // Every started worker is busy. Reserve the next thread number, if any;
+  // the new worker will find the work in its own or in a busy worker's deque.
+  subtle::Atomic32 started = subtle::NoBarrier_Load(&started_thread_count_);
+  while (!subtle::Acquire_Load(&shutdown_flag_) &&
+         static_cast<size_t>(started) < max_threads_) {
+    subtle::Atomic32 previous = subtle::NoBarrier_CompareAndSwap(
+        &started_thread_count_, started, started + 1);
+    if (previous == started) {
+      FinishStartingAdditionalThread(static_cast<int>(started + 1));
+      return;
+    }
+    started = previous;
+  }
+}
+
+void SequencedWorkerPool::Inner::WaitForWork() {
+  AutoLock lock(sleep_lock_);
+  // Advertise that we're about to sleep before looking at the queues one
+  // last time. Paired with the barrier in EnqueueWorkItem(), either we see
+  // the new item or the poster sees us and signals under |sleep_lock_|.
+  subtle::Barrier_AtomicIncrement(&sleeping_thread_count_, 1);
+  if (subtle::Acquire_Load(&queued_item_count_) == 0 &&
+      !WorkStealingShouldExit()) {
+    sleep_cv_.Wait();
+  }
+  subtle::Barrier_AtomicIncrement(&sleeping_thread_count_, -1);
+}
+
+bool SequencedWorkerPool::Inner::WorkStealingShouldExit() const {
+  // BLOCK_SHUTDOWN tasks may still be queued behind a running task of the
+  // same sequence. The worker running it will reschedule them, but keep
+  // everybody around until they are done to be safe.
+  return subtle::Acquire_Load(&shutdown_flag_) &&
+         subtle::Acquire_Load(&blocking_shutdown_pending_count_) == 0;
+}
+
+void SequencedWorkerPool::Inner::DecrementBlockingShutdownCount(
+    volatile subtle::Atomic32* count) {
+  if (subtle::Barrier_AtomicIncrement(count, -1) != 0 ||
+      !subtle::Acquire_Load(&shutdown_flag_)) {
+    return;
+  }
+  {
+    AutoLock lock(lock_);
+    can_shutdown_cv_.Broadcast();
+  }
+  AutoLock lock(sleep_lock_);
+  sleep_cv_.Broadcast();
+}
+
+bool SequencedWorkerPool::Inner::WorkStealingCanShutdown() const {
+  lock_.AssertAcquired();
+  return subtle::Acquire_Load(&blocking_shutdown_pending_count_) == 0 &&
+         subtle::Acquire_Load(&blocking_shutdown_running_count_) == 0;
+}
+
 // SequencedWorkerPool --------------------------------------------------------
 
 SequencedWorkerPool::SequencedWorkerPool(
@@ -937,16 +1402,37 @@ SequencedWorkerPool::SequencedWorkerPool(
     const std::string& thread_name_prefix)
     : constructor_message_loop_(MessageLoopProxy::current()),
       inner_(new Inner(ALLOW_THIS_IN_INITIALIZER_LIST(this),
-                       max_threads, thread_name_prefix, NULL)) {
+                       max_threads, thread_name_prefix, SINGLE_QUEUE,
+                       NULL)) {
+}
+
+SequencedWorkerPool::SequencedWorkerPool(
+    size_t max_threads,
+    const std::string& thread_name_prefix,
+    TestingObserver* observer)
+    : constructor_message_loop_(MessageLoopProxy::current()),
+      inner_(new Inner(ALLOW_THIS_IN_INITIALIZER_LIST(this),
+                       max_threads, thread_name_prefix, SINGLE_QUEUE,
+                       observer)) {
+}
+
+SequencedWorkerPool::SequencedWorkerPool(
+    size_t max_threads,
+    const std::string& thread_name_prefix,
+    SchedulingMode mode)
+    : constructor_message_loop_(MessageLoopProxy::current()),
+      inner_(new Inner(ALLOW_THIS_IN_INITIALIZER_LIST(this),
+                       max_threads, thread_name_prefix, mode, NULL)) {
 }
 
 SequencedWorkerPool::SequencedWorkerPool(
     size_t max_threads,
     const std::string& thread_name_prefix,
+    SchedulingMode mode,
     TestingObserver* observer)
     : constructor_message_loop_(MessageLoopProxy::current()),
       inner_(new Inner(ALLOW_THIS_IN_INITIALIZER_LIST(this),
-                       max_threads, thread_name_prefix, observer)) {
+                       max_threads, thread_name_prefix, mode, observer)) {
 }
 
 SequencedWorkerPool::~SequencedWorkerPool() {}
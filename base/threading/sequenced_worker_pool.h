@@ -101,6 +101,25 @@ class BASE_EXPORT SequencedWorkerPool : public TaskRunner {
     BLOCK_SHUTDOWN,
   };
 
+  // Defines how pending tasks are handed out to the worker threads.
+  enum SchedulingMode {
+    // All pending tasks live in a single list protected by one lock, and
+    // workers scan it in posting order for the next runnable task. This is
+    // the default and is cheapest for pools with few threads and little
+    // traffic.
+    SINGLE_QUEUE,
+
+    // Each worker owns a deque of pending work. Tasks posted from a worker
+    // go to that worker's deque, tasks posted from other threads are spread
+    // round-robin, and a worker that runs dry steals from the others. Tasks
+    // sharing a sequence token are held in a per-sequence queue and only one
+    // of them is ever in a deque at a time, so the ordering guarantees and
+    // the shutdown behaviors are the same as SINGLE_QUEUE. Use this for
+    // pools with many threads and a high posting rate, where the single
+    // lock becomes contended.
+    WORK_STEALING,
+  };
+
   // Opaque identifier that defines sequencing of tasks posted to the worker
   // pool.
   class SequenceToken {
@@ -144,6 +163,18 @@ class BASE_EXPORT SequencedWorkerPool : public TaskRunner {
                       const std::string& thread_name_prefix,
                       TestingObserver* observer);
 
+  // Like the two-argument constructor, but with an explicit |mode|.
+  SequencedWorkerPool(size_t max_threads,
+                      const std::string& thread_name_prefix,
+                      SchedulingMode mode);
+
+  // Like above, but with |observer| for testing.  Does not take
+  // ownership of |observer|.
+  SequencedWorkerPool(size_t max_threads,
+                      const std::string& thread_name_prefix,
+                      SchedulingMode mode,
+                      TestingObserver* observer);
+
   // Returns a unique token that can be used to sequence tasks posted to
   // PostSequencedWorkerTask(). Valid tokens are alwys nonzero.
   SequenceToken GetSequenceToken();
@@ -0,0 +1,138 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/threading/sequenced_worker_pool.h"
+
+#include <vector>
+
+#include "base/atomicops.h"
+#include "base/bind.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "base/test/sequenced_worker_pool_owner.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const size_t kNumWorkerThreads = 32;
+const int kNumTasks = 100000;
+const int kNumSequences = 64;
+const int kFanOut = 16;
+
+const char* ModeName(SequencedWorkerPool::SchedulingMode mode) {
+  return mode == SequencedWorkerPool::WORK_STEALING ?
+      "work_stealing" : "single_queue";
+}
+
+void CountTask(volatile subtle::Atomic32* counter) {
+  subtle::NoBarrier_AtomicIncrement(counter, 1);
+}
+
+// Posts |kFanOut| children from the worker it runs on, |depth| levels deep,
+// which is the pattern blocking FILE/DB-style work tends to produce.
+void FanOutTask(SequencedWorkerPool* pool,
+                volatile subtle::Atomic32* counter,
+                int depth) {
+  subtle::NoBarrier_AtomicIncrement(counter, 1);
+  if (depth == 0)
+    return;
+  for (int i = 0; i < kFanOut; ++i) {
+    pool->PostWorkerTaskWithShutdownBehavior(
+        FROM_HERE, Bind(&FanOutTask, Unretained(pool), counter, depth - 1),
+        SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+  }
+}
+
+class SequencedWorkerPoolPerfTest
+    : public testing::TestWithParam<SequencedWorkerPool::SchedulingMode> {
+ public:
+  SequencedWorkerPoolPerfTest()
+      : pool_owner_(kNumWorkerThreads, "perf", GetParam()),
+        counter_(0) {
+  }
+
+  virtual void TearDown() OVERRIDE {
+    pool()->Shutdown();
+  }
+
+  const scoped_refptr<SequencedWorkerPool>& pool() {
+    return pool_owner_.pool();
+  }
+
+  // Runs one task on every worker so that thread creation isn't measured.
+  void WarmUp() {
+    for (size_t i = 0; i < kNumWorkerThreads * 4; ++i)
+      pool()->PostWorkerTask(FROM_HERE, Bind(&CountTask, &counter_));
+    pool()->FlushForTesting();
+    counter_ = 0;
+  }
+
+  std::string TestName(const char* test) const {
+    return StringPrintf("SequencedWorkerPool_%s_%s", test,
+                        ModeName(GetParam()));
+  }
+
+ protected:
+  MessageLoop message_loop_;
+  SequencedWorkerPoolOwner pool_owner_;
+  volatile subtle::Atomic32 counter_;
+};
+
+// Posts independent tasks from outside the pool.
+TEST_P(SequencedWorkerPoolPerfTest, Unsequenced) {
+  WarmUp();
+  PerfTimeLogger timer(TestName("unsequenced").c_str());
+  for (int i = 0; i < kNumTasks; ++i)
+    pool()->PostWorkerTask(FROM_HERE, Bind(&CountTask, &counter_));
+  pool()->FlushForTesting();
+  timer.Done();
+  EXPECT_EQ(kNumTasks, subtle::NoBarrier_Load(&counter_));
+}
+
+// Posts tasks spread over a fixed set of sequence tokens.
+TEST_P(SequencedWorkerPoolPerfTest, Sequenced) {
+  std::vector<SequencedWorkerPool::SequenceToken> tokens;
+  for (int i = 0; i < kNumSequences; ++i)
+    tokens.push_back(pool()->GetSequenceToken());
+  WarmUp();
+
+  PerfTimeLogger timer(TestName("sequenced").c_str());
+  for (int i = 0; i < kNumTasks; ++i) {
+    pool()->PostSequencedWorkerTask(tokens[i % kNumSequences], FROM_HERE,
+                                    Bind(&CountTask, &counter_));
+  }
+  pool()->FlushForTesting();
+  timer.Done();
+  EXPECT_EQ(kNumTasks, subtle::NoBarrier_Load(&counter_));
+}
+
+// Tasks posted from the workers themselves.
+TEST_P(SequencedWorkerPoolPerfTest, FanOut) {
+  WarmUp();
+  PerfTimeLogger timer(TestName("fan_out").c_str());
+  for (int i = 0; i < kFanOut; ++i) {
+    pool()->PostWorkerTask(FROM_HERE,
+                           Bind(&FanOutTask, Unretained(pool().get()), &counter_, 3));
+  }
+  pool()->FlushForTesting();
+  timer.Done();
+  // kFanOut * (1 + kFanOut + kFanOut^2 + kFanOut^3) tasks in total.
+  EXPECT_EQ(kFanOut * (1 + kFanOut + kFanOut * kFanOut +
+                       kFanOut * kFanOut * kFanOut),
+            subtle::NoBarrier_Load(&counter_));
+}
+
+INSTANTIATE_TEST_CASE_P(
+    SingleQueue, SequencedWorkerPoolPerfTest,
+    testing::Values(SequencedWorkerPool::SINGLE_QUEUE));
+INSTANTIATE_TEST_CASE_P(
+    WorkStealing, SequencedWorkerPoolPerfTest,
+    testing::Values(SequencedWorkerPool::WORK_STEALING));
+
+}  // namespace
+
+}  // namespace base
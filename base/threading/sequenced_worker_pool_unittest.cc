@@ -522,6 +522,120 @@ TEST_F(SequencedWorkerPoolTest, IsRunningOnCurrentThread) {
   unused_pool->Shutdown();
 }
 
+class SequencedWorkerPoolWorkStealingTest : public testing::Test {
+ public:
+  SequencedWorkerPoolWorkStealingTest()
+      : pool_owner_(kNumWorkerThreads, "test",
+                    SequencedWorkerPool::WORK_STEALING),
+        tracker_(new TestTracker) {
+  }
+
+  virtual ~SequencedWorkerPoolWorkStealingTest() {}
+
+  virtual void TearDown() OVERRIDE {
+    pool()->Shutdown();
+  }
+
+  const scoped_refptr<SequencedWorkerPool>& pool() {
+    return pool_owner_.pool();
+  }
+  TestTracker* tracker() { return tracker_.get(); }
+
+  void SetWillWaitForShutdownCallback(const Closure& callback) {
+    pool_owner_.SetWillWaitForShutdownCallback(callback);
+  }
+
+ private:
+  MessageLoop message_loop_;
+  SequencedWorkerPoolOwner pool_owner_;
+  const scoped_refptr<TestTracker> tracker_;
+};
+
+// Tests that many more tasks than workers all get run.
+TEST_F(SequencedWorkerPoolWorkStealingTest, LotsOfTasks) {
+  pool()->PostWorkerTask(FROM_HERE,
+                         base::Bind(&TestTracker::SlowTask, tracker(), 0));
+
+  const size_t kNumTasks = 200;
+  for (size_t i = 1; i < kNumTasks; i++) {
+    pool()->PostWorkerTask(FROM_HERE,
+                           base::Bind(&TestTracker::FastTask, tracker(), i));
+  }
+
+  std::vector<int> result = tracker()->WaitUntilTasksComplete(kNumTasks);
+  EXPECT_EQ(kNumTasks, result.size());
+}
+
+// Tests that tasks sharing a token run in posting order even though their
+// placeholders migrate between the workers' deques.
+TEST_F(SequencedWorkerPoolWorkStealingTest, SequencesKeepOrder) {
+  const int kNumSequences = 5;
+  const int kTasksPerSequence = 50;
+  std::vector<SequencedWorkerPool::SequenceToken> tokens;
+  for (int i = 0; i < kNumSequences; i++)
+    tokens.push_back(pool()->GetSequenceToken());
+
+  for (int task = 0; task < kTasksPerSequence; task++) {
+    for (int sequence = 0; sequence < kNumSequences; sequence++) {
+      pool()->PostSequencedWorkerTask(
+          tokens[sequence], FROM_HERE,
+          base::Bind(&TestTracker::FastTask, tracker(),
+                     sequence * 1000 + task));
+    }
+  }
+  pool()->FlushForTesting();
+
+  std::vector<int> result =
+      tracker()->WaitUntilTasksComplete(kNumSequences * kTasksPerSequence);
+  ASSERT_EQ(static_cast<size_t>(kNumSequences * kTasksPerSequence),
+            result.size());
+  std::vector<int> last_seen(kNumSequences, -1);
+  for (size_t i = 0; i < result.size(); i++) {
+    int sequence = result[i] / 1000;
+    int task = result[i] % 1000;
+    EXPECT_EQ(last_seen[sequence] + 1, task);
+    last_seen[sequence] = task;
+  }
+}
+
+// Tests that unrun tasks are discarded according to their shutdown mode.
+TEST_F(SequencedWorkerPoolWorkStealingTest, DiscardOnShutdown) {
+  ThreadBlocker blocker;
+  for (size_t i = 0; i < kNumWorkerThreads; i++) {
+    pool()->PostWorkerTask(FROM_HERE,
+                           base::Bind(&TestTracker::BlockTask,
+                                      tracker(), i, &blocker));
+  }
+  tracker()->WaitUntilTasksBlocked(kNumWorkerThreads);
+
+  pool()->PostWorkerTaskWithShutdownBehavior(
+      FROM_HERE,
+      base::Bind(&TestTracker::FastTask, tracker(), 100),
+      SequencedWorkerPool::CONTINUE_ON_SHUTDOWN);
+  pool()->PostWorkerTaskWithShutdownBehavior(
+      FROM_HERE,
+      base::Bind(&TestTracker::FastTask, tracker(), 101),
+      SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+  pool()->PostWorkerTaskWithShutdownBehavior(
+      FROM_HERE,
+      base::Bind(&TestTracker::FastTask, tracker(), 102),
+      SequencedWorkerPool::BLOCK_SHUTDOWN);
+
+  SetWillWaitForShutdownCallback(
+      base::Bind(&EnsureTasksToCompleteCountAndUnblock,
+                 scoped_refptr<TestTracker>(tracker()), 0,
+                 &blocker, kNumWorkerThreads));
+  pool()->Shutdown();
+
+  std::vector<int> result = tracker()->WaitUntilTasksComplete(4);
+  ASSERT_EQ(4u, result.size());
+  for (size_t i = 0; i < kNumWorkerThreads; i++) {
+    EXPECT_TRUE(std::find(result.begin(), result.end(), static_cast<int>(i)) !=
+                result.end());
+  }
+  EXPECT_TRUE(std::find(result.begin(), result.end(), 102) != result.end());
+}
+
 class SequencedWorkerPoolTaskRunnerTestDelegate {
  public:
   SequencedWorkerPoolTaskRunnerTestDelegate() {}
@@ -644,6 +758,51 @@ INSTANTIATE_TYPED_TEST_CASE_P(
     SequencedWorkerPoolSequencedTaskRunner, SequencedTaskRunnerTest,
     SequencedWorkerPoolSequencedTaskRunnerTestDelegate);
 
+class SequencedWorkerPoolWorkStealingSequencedTaskRunnerTestDelegate {
+ public:
+  SequencedWorkerPoolWorkStealingSequencedTaskRunnerTestDelegate() {}
+
+  ~SequencedWorkerPoolWorkStealingSequencedTaskRunnerTestDelegate() {
+  }
+
+  void StartTaskRunner() {
+    pool_owner_.reset(new SequencedWorkerPoolOwner(
+        10, "SequencedWorkerPoolWorkStealingSequencedTaskRunnerTest",
+        SequencedWorkerPool::WORK_STEALING));
+    task_runner_ = pool_owner_->pool()->GetSequencedTaskRunner(
+        pool_owner_->pool()->GetSequenceToken());
+  }
+
+  scoped_refptr<SequencedTaskRunner> GetTaskRunner() {
+    return task_runner_;
+  }
+
+  void StopTaskRunner() {
+    pool_owner_->pool()->FlushForTesting();
+    pool_owner_->pool()->Shutdown();
+    // Don't reset |pool_owner_| here, as the test may still hold a
+    // reference to the pool.
+  }
+
+  bool TaskRunnerHandlesNonZeroDelays() const {
+    return false;
+  }
+
+ private:
+  MessageLoop message_loop_;
+  scoped_ptr<SequencedWorkerPoolOwner> pool_owner_;
+  scoped_refptr<SequencedTaskRunner> task_runner_;
+};
+
+INSTANTIATE_TYPED_TEST_CASE_P(
+    SequencedWorkerPoolWorkStealingSequencedTaskRunner, TaskRunnerTest,
+    SequencedWorkerPoolWorkStealingSequencedTaskRunnerTestDelegate);
+
+INSTANTIATE_TYPED_TEST_CASE_P(
+    SequencedWorkerPoolWorkStealingSequencedTaskRunner,
+    SequencedTaskRunnerTest,
+    SequencedWorkerPoolWorkStealingSequencedTaskRunnerTestDelegate);
+
 }  // namespace
 
 }  // namespace base
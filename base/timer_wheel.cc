@@ -0,0 +1,338 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/timer_wheel.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/logging.h"
+
+namespace base {
+
+namespace {
+
+const int64 kNoTick = -1;
+
+// Returns the index of the lowest set bit of |bits|, which must be non-zero.
+int LowestSetBit(uint64 bits) {
+  DCHECK(bits);
+  int index = 0;
+  for (int shift = 32; shift > 0; shift >>= 1) {
+    uint64 mask = (GG_UINT64_C(1) << shift) - 1;
+    if (!(bits & mask)) {
+      bits >>= shift;
+      index += shift;
+    }
+  }
+  return index;
+}
+
+// Rotates |bits| right by |count|, which must be in [0, 64).
+uint64 RotateRight(uint64 bits, int count) {
+  if (!count)
+    return bits;
+  return (bits >> count) | (bits << (64 - count));
+}
+
+template <typename T>
+bool IsEmpty(const LinkedList<T>& list) {
+  return list.head() == list.end();
+}
+
+}  // namespace
+
+WheelTimer::WheelTimer(TimerWheel* wheel)
+    : wheel_(wheel),
+      tick_(0),
+      level_(0),
+      slot_(0),
+      is_running_(false) {
+  DCHECK(wheel_);
+}
+
+WheelTimer::~WheelTimer() {
+  Stop();
+}
+
+void WheelTimer::Start(const tracked_objects::Location& posted_from,
+                       TimeDelta delay,
+                       const Closure& user_task) {
+  DCHECK(!user_task.is_null());
+  DCHECK_GE(delay.InMicroseconds(), 0);
+  Stop();
+  posted_from_ = posted_from;
+  user_task_ = user_task;
+  desired_run_time_ = TimeTicks::Now() + delay;
+  wheel_->Add(this);
+}
+
+void WheelTimer::Stop() {
+  if (!is_running_)
+    return;
+  wheel_->Remove(this);
+  user_task_.Reset();
+}
+
+TimerWheel::TimerWheel(TimeDelta tolerance)
+    : tolerance_(tolerance),
+      origin_(TimeTicks::Now()),
+      current_tick_(0),
+      overflow_min_tick_(kint64max),
+      size_(0),
+      wakeup_timer_(false, false),
+      scheduled_tick_(kNoTick),
+      wakeup_count_(0),
+      weak_factory_(ALLOW_THIS_IN_INITIALIZER_LIST(this)) {
+  DCHECK_GT(tolerance_.InMicroseconds(), 0);
+  for (int level = 0; level < kNumLevels; ++level)
+    occupied_[level] = 0;
+}
+
+TimerWheel::~TimerWheel() {
+  for (int level = 0; level < kNumLevels; ++level) {
+    for (int slot = 0; slot < kSlotsPerLevel; ++slot)
+      StopAll(&slots_[level][slot]);
+  }
+  StopAll(&overflow_);
+  StopAll(&expired_);
+}
+
+void TimerWheel::Add(WheelTimer* timer) {
+  DCHECK(!timer->is_running_);
+  timer->tick_ = TickFor(timer->desired_run_time_);
+  timer->is_running_ = true;
+  ++size_;
+  Link(timer);
+
+  // The wheel needs to wake up when the timer's slot is expired or, for the
+  // higher levels, cascaded; both happen at the first tick the slot covers.
+  int64 event_tick = kint64max;
+  if (timer->level_ < kNumLevels) {
+    int shift = timer->level_ * kSlotBits;
+    event_tick = std::max(current_tick_, (timer->tick_ >> shift) << shift);
+  }
+  if (scheduled_tick_ == kNoTick || event_tick < scheduled_tick_)
+    ScheduleWakeup();
+}
+
+void TimerWheel::Remove(WheelTimer* timer) {
+  DCHECK(timer->is_running_);
+  Unlink(timer);
+  timer->is_running_ = false;
+  --size_;
+
+  // An early wakeup is harmless, so the MessageLoop timer is only stopped
+  // once there is nothing left to wake up for.
+  if (!size_ && scheduled_tick_ != kNoTick) {
+    wakeup_timer_.Stop();
+    scheduled_tick_ = kNoTick;
+  }
+}
+
+void TimerWheel::Link(WheelTimer* timer) {
+  if (timer->tick_ < current_tick_)
+    timer->tick_ = current_tick_;
+
+  int64 delta = timer->tick_ - current_tick_;
+  int level = 0;
+  while (level < kNumLevels &&
+         delta >= (GG_INT64_C(1) << ((level + 1) * kSlotBits))) {
+    ++level;
+  }
+
+  timer->level_ = level;
+  if (level == kOverflowLevel) {
+    timer->slot_ = 0;
+    overflow_.Append(timer);
+    overflow_min_tick_ = std::min(overflow_min_tick_, timer->tick_);
+    return;
+  }
+
+  int slot = static_cast<int>((timer->tick_ >> (level * kSlotBits)) &
+                              kSlotMask);
+  timer->slot_ = slot;
+  slots_[level][slot].Append(timer);
+  occupied_[level] |= GG_UINT64_C(1) << slot;
+}
+
+void TimerWheel::Unlink(WheelTimer* timer) {
+  timer->RemoveFromList();
+  // overflow_min_tick_ is left alone; a stale lower bound just means the
+  // overflow list gets re-examined a little early.
+  int level = timer->level_;
+  if (level < kNumLevels && IsEmpty(slots_[level][timer->slot_]))
+    occupied_[level] &= ~(GG_UINT64_C(1) << timer->slot_);
+}
+
+int64 TimerWheel::TickFor(TimeTicks time) const {
+  int64 elapsed = (time - origin_).InMicroseconds();
+  if (elapsed <= 0)
+    return 0;
+  int64 tolerance = tolerance_.InMicroseconds();
+  return (elapsed + tolerance - 1) / tolerance;
+}
+
+TimeTicks TimerWheel::TimeFor(int64 tick) const {
+  return origin_ + tolerance_ * tick;
+}
+
+bool TimerWheel::GetNextEventTick(int64* tick) const {
+  bool found = false;
+  int64 next = kint64max;
+
+  for (int level = 0; level < kNumLevels; ++level) {
+    if (!occupied_[level])
+      continue;
+    int shift = level * kSlotBits;
+    int64 slot_ticks = GG_INT64_C(1) << shift;
+    int64 current_slot_start = (current_tick_ >> shift) << shift;
+    int current_slot = static_cast<int>((current_tick_ >> shift) & kSlotMask);
+
+    // Bit k of |ahead| is the slot k slots after the current one. The current
+    // slot itself only still needs processing if current_tick_ is its first
+    // tick; otherwise anything in it belongs to the next rotation.
+    uint64 ahead = RotateRight(occupied_[level], current_slot);
+    int offset;
+    if ((ahead & 1) && current_slot_start == current_tick_) {
+      offset = 0;
+    } else {
+      ahead &= ~GG_UINT64_C(1);
+      offset = ahead ? LowestSetBit(ahead) : kSlotsPerLevel;
+    }
+
+    next = std::min(next, current_slot_start + offset * slot_ticks);
+    found = true;
+  }
+
+  if (!IsEmpty(overflow_)) {
+    const int64 kWheelTicks = GG_INT64_C(1) << (kNumLevels * kSlotBits);
+    next = std::min(next, std::max(current_tick_,
+                                   overflow_min_tick_ - kWheelTicks + 1));
+    found = true;
+  }
+
+  if (found)
+    *tick = next;
+  return found;
+}
+
+void TimerWheel::AdvanceTo(int64 tick) {
+  const int64 kWheelTicks = GG_INT64_C(1) << (kNumLevels * kSlotBits);
+  int64 next;
+  while (GetNextEventTick(&next) && next <= tick) {
+    current_tick_ = next;
+
+    // Cascade from the top down so that timers can fall all the way to level
+    // 0 at this tick, then expire whatever is due now.
+    if (!IsEmpty(overflow_) && next > overflow_min_tick_ - kWheelTicks)
+      Cascade(kOverflowLevel, 0);
+    for (int level = kNumLevels - 1; level > 0; --level) {
+      int shift = level * kSlotBits;
+      if (next & ((GG_INT64_C(1) << shift) - 1))
+        continue;
+      int slot = static_cast<int>((next >> shift) & kSlotMask);
+      if (occupied_[level] & (GG_UINT64_C(1) << slot))
+        Cascade(level, slot);
+    }
+
+    int slot = static_cast<int>(next & kSlotMask);
+    LinkedList<WheelTimer>* list = &slots_[0][slot];
+    while (!IsEmpty(*list)) {
+      WheelTimer* timer = list->head()->value();
+      timer->RemoveFromList();
+      timer->level_ = kExpiredLevel;
+      expired_.Append(timer);
+    }
+    occupied_[0] &= ~(GG_UINT64_C(1) << slot);
+
+    current_tick_ = next + 1;
+  }
+
+  if (current_tick_ <= tick)
+    current_tick_ = tick + 1;
+}
+
+void TimerWheel::Cascade(int level, int slot) {
+  LinkedList<WheelTimer>* list;
+  if (level == kOverflowLevel) {
+    list = &overflow_;
+    overflow_min_tick_ = kint64max;
+  } else {
+    list = &slots_[level][slot];
+    occupied_[level] &= ~(GG_UINT64_C(1) << slot);
+  }
+
+  // Move everything aside first: timers from the overflow list may be linked
+  // straight back into it.
+  LinkedList<WheelTimer> pending;
+  while (!IsEmpty(*list)) {
+    LinkNode<WheelTimer>* node = list->head();
+    node->RemoveFromList();
+    pending.Append(node);
+  }
+  while (!IsEmpty(pending)) {
+    WheelTimer* timer = pending.head()->value();
+    timer->RemoveFromList();
+    Link(timer);
+  }
+}
+
+void TimerWheel::StopAll(LinkedList<WheelTimer>* list) {
+  while (!IsEmpty(*list)) {
+    WheelTimer* timer = list->head()->value();
+    timer->RemoveFromList();
+    timer->is_running_ = false;
+    timer->user_task_.Reset();
+    --size_;
+  }
+}
+
+void TimerWheel::ScheduleWakeup() {
+  int64 next;
+  if (!GetNextEventTick(&next)) {
+    if (scheduled_tick_ != kNoTick) {
+      wakeup_timer_.Stop();
+      scheduled_tick_ = kNoTick;
+    }
+    return;
+  }
+  if (next == scheduled_tick_)
+    return;
+
+  scheduled_tick_ = next;
+  TimeDelta delay = TimeFor(next) - TimeTicks::Now();
+  if (delay < TimeDelta())
+    delay = TimeDelta();
+  wakeup_timer_.Start(FROM_HERE, delay,
+                      Bind(&TimerWheel::OnWakeup, Unretained(this)));
+}
+
+void TimerWheel::OnWakeup() {
+  ++wakeup_count_;
+  scheduled_tick_ = kNoTick;
+
+  // Every tick whose start time has been reached is due.
+  int64 elapsed = (TimeTicks::Now() - origin_).InMicroseconds();
+  AdvanceTo(elapsed / tolerance_.InMicroseconds());
+
+  // A user task may stop other expired timers, start new ones, or delete
+  // the wheel altogether.
+  WeakPtr<TimerWheel> self = weak_factory_.GetWeakPtr();
+  while (!IsEmpty(expired_)) {
+    WheelTimer* timer = expired_.head()->value();
+    timer->RemoveFromList();
+    timer->is_running_ = false;
+    --size_;
+    Closure task = timer->user_task_;
+    timer->user_task_.Reset();
+    task.Run();
+    if (!self)
+      return;
+  }
+
+  ScheduleWakeup();
+}
+
+}  // namespace base
@@ -0,0 +1,221 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// TimerWheel is a hierarchical timing wheel for code that keeps large numbers
+// of one-shot timers which are mostly stopped or restarted before they fire
+// (network timeouts, idle detection, and so on).
+//
+// Every base::Timer owns its own delayed task in the MessageLoop's delayed
+// work queue, which is a heap: each Start costs O(log n), and a stopped timer
+// leaves its task behind until its original deadline passes. A TimerWheel
+// instead keeps its timers in intrusive lists bucketed by deadline, so Start
+// and Stop are O(1), and uses a single base::Timer to wake up for the nearest
+// non-empty bucket. Deadlines are rounded up to a multiple of the wheel's
+// |tolerance|, so all timers due within the same tolerance window are run by
+// the same wakeup.
+//
+// A WheelTimer never fires before its requested delay has passed, and fires at
+// most |tolerance| late (plus whatever latency the MessageLoop adds).
+//
+// Sample usage:
+//
+//   class ConnectionPool {
+//    public:
+//     ConnectionPool() : wheel_(TimeDelta::FromMilliseconds(10)) {}
+//     TimerWheel* wheel() { return &wheel_; }
+//    private:
+//     base::TimerWheel wheel_;
+//   };
+//
+//   class Connection {
+//    public:
+//     explicit Connection(ConnectionPool* pool) : timeout_(pool->wheel()) {}
+//     void OnActivity() {
+//       timeout_.Start(FROM_HERE, TimeDelta::FromSeconds(30),
+//                      base::Bind(&Connection::OnTimeout,
+//                                 base::Unretained(this)));
+//     }
+//    private:
+//     void OnTimeout();
+//     base::WheelTimer timeout_;
+//   };
+//
+// NOTE: These APIs are not thread safe. A TimerWheel and all of its timers
+// must be used on the thread that runs the wheel's MessageLoop, and the wheel
+// must outlive its timers.
+
+#ifndef BASE_TIMER_WHEEL_H_
+#define BASE_TIMER_WHEEL_H_
+#pragma once
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/linked_list.h"
+#include "base/location.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time.h"
+#include "base/timer.h"
+
+namespace base {
+
+class TimerWheel;
+
+//-----------------------------------------------------------------------------
+// A one-shot timer scheduled on a TimerWheel. Like OneShotTimer, the timer is
+// stopped when it goes out of scope.
+class BASE_EXPORT WheelTimer : public LinkNode<WheelTimer> {
+ public:
+  explicit WheelTimer(TimerWheel* wheel);
+  ~WheelTimer();
+
+  // Returns true if the timer is running (i.e., not stopped).
+  bool IsRunning() const { return is_running_; }
+
+  // Start the timer to run |user_task| once |delay| has passed. If the timer
+  // is already running, it is rescheduled to call the given |user_task|.
+  void Start(const tracked_objects::Location& posted_from,
+             TimeDelta delay,
+             const Closure& user_task);
+
+  // Stops the timer. It is a no-op if the timer is not running.
+  void Stop();
+
+  const TimeTicks& desired_run_time() const { return desired_run_time_; }
+
+ private:
+  friend class TimerWheel;
+
+  TimerWheel* const wheel_;
+
+  // Location in user code.
+  tracked_objects::Location posted_from_;
+
+  // The task to run, and when the user asked for it to run.
+  Closure user_task_;
+  TimeTicks desired_run_time_;
+
+  // The wheel tick at (or after) desired_run_time_, and the bucket the timer
+  // is linked into. Only meaningful while is_running_ is true.
+  int64 tick_;
+  int level_;
+  int slot_;
+
+  bool is_running_;
+
+  DISALLOW_COPY_AND_ASSIGN(WheelTimer);
+};
+
+//-----------------------------------------------------------------------------
+class BASE_EXPORT TimerWheel {
+ public:
+  // Deadlines are rounded up to the next multiple of |tolerance|, which must
+  // be positive.
+  explicit TimerWheel(TimeDelta tolerance);
+
+  // Stops all timers that are still running on this wheel.
+  ~TimerWheel();
+
+  TimeDelta tolerance() const { return tolerance_; }
+
+  // Returns the number of running timers.
+  size_t size() const { return size_; }
+
+  // Returns how many times the wheel has been woken up by the MessageLoop.
+  // Exposed for tests and benchmarks to measure coalescing.
+  int wakeup_count() const { return wakeup_count_; }
+
+ private:
+  friend class WheelTimer;
+
+  // The wheel has kNumLevels levels of kSlotsPerLevel slots. A slot on level
+  // L covers kSlotsPerLevel^L ticks, so the whole wheel spans
+  // kSlotsPerLevel^kNumLevels ticks; timers further out than that wait in
+  // |overflow_|.
+  enum {
+    kSlotBits = 6,
+    kSlotsPerLevel = 1 << kSlotBits,
+    kSlotMask = kSlotsPerLevel - 1,
+    kNumLevels = 4,
+    // Pseudo-levels for timers linked into overflow_ and expired_.
+    kOverflowLevel = kNumLevels,
+    kExpiredLevel
+  };
+
+  // Called by WheelTimer::Start() and Stop().
+  void Add(WheelTimer* timer);
+  void Remove(WheelTimer* timer);
+
+  // Links |timer| into the bucket for its tick_, relative to current_tick_.
+  void Link(WheelTimer* timer);
+
+  // Unlinks |timer| from whichever bucket it is in.
+  void Unlink(WheelTimer* timer);
+
+  // Converts between TimeTicks and wheel ticks. TickFor rounds up, so a timer
+  // never runs before its desired run time.
+  int64 TickFor(TimeTicks time) const;
+  TimeTicks TimeFor(int64 tick) const;
+
+  // Finds the first tick at or after current_tick_ at which a slot needs to
+  // be expired or cascaded. Returns false if the wheel is empty.
+  bool GetNextEventTick(int64* tick) const;
+
+  // Processes every slot whose tick is <= |tick|, moving due timers onto
+  // |expired_|.
+  void AdvanceTo(int64 tick);
+
+  // Moves the timers out of a higher-level slot (or the overflow list) and
+  // re-links them relative to current_tick_.
+  void Cascade(int level, int slot);
+
+  // Unlinks every timer in |list| and marks it stopped.
+  void StopAll(LinkedList<WheelTimer>* list);
+
+  // Makes sure |wakeup_timer_| fires at the next event tick, or stops it if
+  // the wheel is empty.
+  void ScheduleWakeup();
+
+  // Called by |wakeup_timer_|.
+  void OnWakeup();
+
+  const TimeDelta tolerance_;
+
+  // Tick 0 starts at origin_.
+  const TimeTicks origin_;
+
+  // All slots for ticks before current_tick_ have been processed.
+  int64 current_tick_;
+
+  LinkedList<WheelTimer> slots_[kNumLevels][kSlotsPerLevel];
+
+  // Bit N of occupied_[L] is set iff slots_[L][N] is non-empty.
+  uint64 occupied_[kNumLevels];
+
+  // Timers that are too far out for the wheel, and the smallest tick_ among
+  // them.
+  LinkedList<WheelTimer> overflow_;
+  int64 overflow_min_tick_;
+
+  // Timers that are due and about to be run by OnWakeup().
+  LinkedList<WheelTimer> expired_;
+
+  size_t size_;
+
+  // The single MessageLoop timer that drives this wheel, and the tick it is
+  // currently scheduled for (-1 if it is not running).
+  Timer wakeup_timer_;
+  int64 scheduled_tick_;
+
+  int wakeup_count_;
+
+  // Lets OnWakeup() notice if a user task deletes the wheel.
+  WeakPtrFactory<TimerWheel> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+}  // namespace base
+
+#endif  // BASE_TIMER_WHEEL_H_
@@ -0,0 +1,124 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/timer_wheel.h"
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/logging.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/timer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const int kNumTimers = 10000;
+const int kNumRestarts = 20;
+const int kNumFiringTimers = 100000;
+
+class FireCounter {
+ public:
+  explicit FireCounter(int expected) : expected_(expected), count_(0) {}
+
+  void Fire() {
+    if (++count_ == expected_)
+      MessageLoop::current()->Quit();
+  }
+
+  int count() const { return count_; }
+
+ private:
+  const int expected_;
+  int count_;
+};
+
+// Delays spread over a second, in the order a busy network stack would restart
+// its timeouts.
+TimeDelta DelayFor(int i, int restart) {
+  return TimeDelta::FromMilliseconds(1000 + (i * 7 + restart * 13) % 1000);
+}
+
+}  // namespace
+
+// Start/restart/stop churn, as from per-connection idle timeouts that are
+// pushed back on every read. Each base::Timer restart with an earlier deadline
+// posts another delayed task to the MessageLoop.
+TEST(TimerWheelPerfTest, ChurnTimer) {
+  MessageLoop loop;
+  ScopedVector<Timer> timers;
+  for (int i = 0; i < kNumTimers; ++i)
+    timers.push_back(new Timer(false, false));
+
+  PerfTimeLogger timer("TimerWheel_churn_timer");
+  for (int restart = 0; restart < kNumRestarts; ++restart) {
+    for (int i = 0; i < kNumTimers; ++i) {
+      timers[i]->Start(FROM_HERE, DelayFor(i, restart), Bind(&DoNothing));
+    }
+  }
+  for (int i = 0; i < kNumTimers; ++i)
+    timers[i]->Stop();
+  timer.Done();
+}
+
+TEST(TimerWheelPerfTest, ChurnWheel) {
+  MessageLoop loop;
+  TimerWheel wheel(TimeDelta::FromMilliseconds(4));
+  ScopedVector<WheelTimer> timers;
+  for (int i = 0; i < kNumTimers; ++i)
+    timers.push_back(new WheelTimer(&wheel));
+
+  PerfTimeLogger timer("TimerWheel_churn_wheel");
+  for (int restart = 0; restart < kNumRestarts; ++restart) {
+    for (int i = 0; i < kNumTimers; ++i) {
+      timers[i]->Start(FROM_HERE, DelayFor(i, restart), Bind(&DoNothing));
+    }
+  }
+  for (int i = 0; i < kNumTimers; ++i)
+    timers[i]->Stop();
+  timer.Done();
+}
+
+// Many timers firing within a short window.
+TEST(TimerWheelPerfTest, FireTimer) {
+  MessageLoop loop;
+  FireCounter counter(kNumFiringTimers);
+  ScopedVector<Timer> timers;
+
+  PerfTimeLogger timer("TimerWheel_fire_timer");
+  for (int i = 0; i < kNumFiringTimers; ++i) {
+    Timer* t = new Timer(false, false);
+    timers.push_back(t);
+    t->Start(FROM_HERE, TimeDelta::FromMicroseconds(i % 50000),
+             Bind(&FireCounter::Fire, Unretained(&counter)));
+  }
+  MessageLoop::current()->Run();
+  timer.Done();
+  EXPECT_EQ(kNumFiringTimers, counter.count());
+}
+
+TEST(TimerWheelPerfTest, FireWheel) {
+  MessageLoop loop;
+  FireCounter counter(kNumFiringTimers);
+  TimerWheel wheel(TimeDelta::FromMilliseconds(4));
+  ScopedVector<WheelTimer> timers;
+
+  PerfTimeLogger timer("TimerWheel_fire_wheel");
+  for (int i = 0; i < kNumFiringTimers; ++i) {
+    WheelTimer* t = new WheelTimer(&wheel);
+    timers.push_back(t);
+    t->Start(FROM_HERE, TimeDelta::FromMicroseconds(i % 50000),
+             Bind(&FireCounter::Fire, Unretained(&counter)));
+  }
+  MessageLoop::current()->Run();
+  timer.Done();
+  EXPECT_EQ(kNumFiringTimers, counter.count());
+  LOG(INFO) << "TimerWheel_fire_wheel: " << wheel.wakeup_count()
+            << " wakeups for " << kNumFiringTimers << " timers";
+}
+
+}  // namespace base
@@ -0,0 +1,207 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/timer_wheel.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+// Records the order timers run in and checks that none of them runs early.
+class Recorder {
+ public:
+  Recorder() : expected_(0) {}
+
+  // Quits the MessageLoop once |count| timers have run.
+  void set_expected(size_t count) { expected_ = count; }
+
+  void Run(int id, TimeTicks desired_run_time) {
+    EXPECT_GE(TimeTicks::Now(), desired_run_time);
+    order_.push_back(id);
+    if (order_.size() == expected_)
+      MessageLoop::current()->Quit();
+  }
+
+  void Start(WheelTimer* timer, int id, int delay_ms) {
+    TimeDelta delay = TimeDelta::FromMilliseconds(delay_ms);
+    timer->Start(FROM_HERE, delay,
+                 Bind(&Recorder::Run, Unretained(this), id,
+                      TimeTicks::Now() + delay));
+  }
+
+  const std::vector<int>& order() const { return order_; }
+
+ private:
+  size_t expected_;
+  std::vector<int> order_;
+};
+
+void StopTimer(WheelTimer* timer) {
+  timer->Stop();
+}
+
+void DeleteWheel(scoped_ptr<TimerWheel>* wheel, scoped_ptr<WheelTimer>* timer,
+                 bool* did_run) {
+  *did_run = true;
+  timer->reset();
+  wheel->reset();
+  MessageLoop::current()->Quit();
+}
+
+void SetFlag(bool* flag) {
+  *flag = true;
+}
+
+}  // namespace
+
+TEST(TimerWheelTest, RunsInDeadlineOrder) {
+  MessageLoop loop;
+  TimerWheel wheel(TimeDelta::FromMilliseconds(1));
+  Recorder recorder;
+  WheelTimer a(&wheel), b(&wheel), c(&wheel);
+
+  recorder.Start(&a, 3, 30);
+  recorder.Start(&b, 1, 10);
+  recorder.Start(&c, 2, 20);
+  EXPECT_EQ(3u, wheel.size());
+  EXPECT_TRUE(a.IsRunning());
+
+  recorder.set_expected(3);
+  MessageLoop::current()->Run();
+
+  ASSERT_EQ(3u, recorder.order().size());
+  EXPECT_EQ(1, recorder.order()[0]);
+  EXPECT_EQ(2, recorder.order()[1]);
+  EXPECT_EQ(3, recorder.order()[2]);
+  EXPECT_EQ(0u, wheel.size());
+  EXPECT_FALSE(a.IsRunning());
+}
+
+TEST(TimerWheelTest, Stop) {
+  MessageLoop loop;
+  TimerWheel wheel(TimeDelta::FromMilliseconds(1));
+  Recorder recorder;
+  WheelTimer a(&wheel), b(&wheel);
+
+  recorder.Start(&a, 1, 10);
+  recorder.Start(&b, 2, 20);
+  a.Stop();
+  EXPECT_FALSE(a.IsRunning());
+  EXPECT_EQ(1u, wheel.size());
+
+  recorder.set_expected(1);
+  MessageLoop::current()->Run();
+
+  ASSERT_EQ(1u, recorder.order().size());
+  EXPECT_EQ(2, recorder.order()[0]);
+}
+
+TEST(TimerWheelTest, Restart) {
+  MessageLoop loop;
+  TimerWheel wheel(TimeDelta::FromMilliseconds(1));
+  Recorder recorder;
+  WheelTimer a(&wheel), b(&wheel);
+
+  recorder.Start(&a, 1, 10);
+  recorder.Start(&b, 2, 20);
+  // Pushing |a| out past |b| replaces its first deadline.
+  recorder.Start(&a, 3, 30);
+  EXPECT_EQ(2u, wheel.size());
+
+  recorder.set_expected(2);
+  MessageLoop::current()->Run();
+
+  ASSERT_EQ(2u, recorder.order().size());
+  EXPECT_EQ(2, recorder.order()[0]);
+  EXPECT_EQ(3, recorder.order()[1]);
+}
+
+// Timers due within the same tolerance window share a single wakeup.
+TEST(TimerWheelTest, CoalescesDeadlines) {
+  MessageLoop loop;
+  TimerWheel wheel(TimeDelta::FromMilliseconds(100));
+  Recorder recorder;
+  const int kNumTimers = 20;
+  std::vector<WheelTimer*> timers;
+  for (int i = 0; i < kNumTimers; ++i) {
+    timers.push_back(new WheelTimer(&wheel));
+    recorder.Start(timers.back(), i, i + 1);
+  }
+
+  recorder.set_expected(kNumTimers);
+  MessageLoop::current()->Run();
+
+  EXPECT_EQ(static_cast<size_t>(kNumTimers), recorder.order().size());
+  // Normally exactly one; allow for the test thread being descheduled across
+  // a tick boundary while starting the timers.
+  EXPECT_LE(wheel.wakeup_count(), 2);
+  for (int i = 0; i < kNumTimers; ++i)
+    delete timers[i];
+}
+
+// With a 1us tolerance these deadlines land on the second and third levels of
+// the wheel and have to cascade down before they run.
+TEST(TimerWheelTest, Cascades) {
+  MessageLoop loop;
+  TimerWheel wheel(TimeDelta::FromMicroseconds(1));
+  Recorder recorder;
+  WheelTimer a(&wheel), b(&wheel), c(&wheel), d(&wheel);
+
+  recorder.Start(&a, 4, 150);
+  recorder.Start(&b, 2, 5);
+  recorder.Start(&c, 3, 70);
+  recorder.Start(&d, 1, 0);
+
+  recorder.set_expected(4);
+  MessageLoop::current()->Run();
+
+  ASSERT_EQ(4u, recorder.order().size());
+  for (int i = 0; i < 4; ++i)
+    EXPECT_EQ(i + 1, recorder.order()[i]);
+}
+
+// A timer may stop another timer that is due in the same wakeup.
+TEST(TimerWheelTest, StopFromCallback) {
+  MessageLoop loop;
+  TimerWheel wheel(TimeDelta::FromMilliseconds(50));
+  Recorder recorder;
+  WheelTimer a(&wheel), b(&wheel), c(&wheel);
+
+  a.Start(FROM_HERE, TimeDelta::FromMilliseconds(1), Bind(&StopTimer, &b));
+  recorder.Start(&b, 1, 2);
+  recorder.Start(&c, 2, 60);
+
+  recorder.set_expected(1);
+  MessageLoop::current()->Run();
+
+  ASSERT_EQ(1u, recorder.order().size());
+  EXPECT_EQ(2, recorder.order()[0]);
+}
+
+TEST(TimerWheelTest, DeleteWheelFromCallback) {
+  MessageLoop loop;
+  scoped_ptr<TimerWheel> wheel(new TimerWheel(TimeDelta::FromMilliseconds(50)));
+  scoped_ptr<WheelTimer> a(new WheelTimer(wheel.get()));
+  WheelTimer b(wheel.get());
+  bool a_ran = false;
+  bool b_ran = false;
+
+  a->Start(FROM_HERE, TimeDelta::FromMilliseconds(1),
+           Bind(&DeleteWheel, &wheel, &a, &a_ran));
+  b.Start(FROM_HERE, TimeDelta::FromMilliseconds(2), Bind(&SetFlag, &b_ran));
+  MessageLoop::current()->Run();
+
+  EXPECT_TRUE(a_ran);
+  EXPECT_FALSE(b_ran);
+  EXPECT_FALSE(b.IsRunning());
+}
+
+}  // namespace base
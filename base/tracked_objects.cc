@@ -367,17 +367,13 @@ void ThreadData::Snapshot(bool reset_max, ProcessDataSnapshot* process_data) {
 }
 
 Births* ThreadData::TallyABirth(const Location& location) {
-  BirthMap::iterator it = birth_map_.find(location);
-  Births* child;
-  if (it != birth_map_.end()) {
-    child =  it->second;
+  Births* child = birth_table_.Find(location);
+  if (child) {
     child->RecordBirth();
   } else {
-    child = new Births(location, *this);  // Leak this.
-    // Lock since the map may get relocated now, and other threads sometimes
-    // snapshot it (but they lock before copying it).
-    base::AutoLock lock(map_lock_);
-    birth_map_[location] = child;
+    // The record lives as long as this ThreadData, in our arena.
+    child = new(arena_.Allocate(sizeof(Births))) Births(location, *this);
+    birth_table_.Insert(child, &arena_);
   }
 
   if (kTrackParentChildLinks && status_ > PROFILING_ACTIVE &&
@@ -410,15 +406,12 @@ void ThreadData::TallyADeath(const Births& birth,
   if (kAllowAlternateTimeSourceHandling && now_function_)
     queue_duration = 0;
 
-  DeathMap::iterator it = death_map_.find(&birth);
-  DeathData* death_data;
-  if (it != death_map_.end()) {
-    death_data = &it->second;
-  } else {
-    base::AutoLock lock(map_lock_);  // Lock as the map may get relocated now.
-    death_data = &death_map_[&birth];
-  }  // Release lock ASAP.
-  death_data->RecordDeath(queue_duration, run_duration, random_number_);
+  DeathRecord* record = death_table_.Find(&birth);
+  if (!record) {
+    record = new(arena_.Allocate(sizeof(DeathRecord))) DeathRecord(&birth);
+    death_table_.Insert(record, &arena_);
+  }
+  record->death_data.RecordDeath(queue_duration, run_duration, random_number_);
 
   if (!kTrackParentChildLinks)
     return;
@@ -608,20 +601,25 @@ void ThreadData::SnapshotMaps(bool reset_max,
                               BirthMap* birth_map,
                               DeathMap* death_map,
                               ParentChildSet* parent_child_set) {
-  base::AutoLock lock(map_lock_);
-  for (BirthMap::const_iterator it = birth_map_.begin();
-       it != birth_map_.end(); ++it)
-    (*birth_map)[it->first] = it->second;
-  for (DeathMap::iterator it = death_map_.begin();
-       it != death_map_.end(); ++it) {
-    (*death_map)[it->first] = it->second;
+  // The tables are walked without a lock; records that are added while we
+  // walk may or may not be seen.
+  std::vector<Births*> births;
+  birth_table_.GetRecords(&births);
+  for (size_t i = 0; i < births.size(); ++i)
+    (*birth_map)[births[i]->location()] = births[i];
+
+  std::vector<DeathRecord*> deaths;
+  death_table_.GetRecords(&deaths);
+  for (size_t i = 0; i < deaths.size(); ++i) {
+    (*death_map)[deaths[i]->birth] = deaths[i]->death_data;
     if (reset_max)
-      it->second.ResetMax();
+      deaths[i]->death_data.ResetMax();
   }
 
   if (!kTrackParentChildLinks)
     return;
 
+  base::AutoLock lock(map_lock_);
   for (ParentChildSet::iterator it = parent_child_set_.begin();
        it != parent_child_set_.end(); ++it)
     parent_child_set->insert(*it);
@@ -638,13 +636,15 @@ void ThreadData::ResetAllThreadData() {
 }
 
 void ThreadData::Reset() {
-  base::AutoLock lock(map_lock_);
-  for (DeathMap::iterator it = death_map_.begin();
-       it != death_map_.end(); ++it)
-    it->second.Clear();
-  for (BirthMap::iterator it = birth_map_.begin();
-       it != birth_map_.end(); ++it)
-    it->second->Clear();
+  std::vector<DeathRecord*> deaths;
+  death_table_.GetRecords(&deaths);
+  for (size_t i = 0; i < deaths.size(); ++i)
+    deaths[i]->death_data.Clear();
+
+  std::vector<Births*> births;
+  birth_table_.GetRecords(&births);
+  for (size_t i = 0; i < births.size(); ++i)
+    births[i]->Clear();
 }
 
 static void OptionallyInitializeAlternateTimer() {
@@ -814,11 +814,7 @@ void ThreadData::ShutdownSingleThreadedCleanup(bool leak) {
   while (thread_data_list) {
     ThreadData* next_thread_data = thread_data_list;
     thread_data_list = thread_data_list->next();
-
-    for (BirthMap::iterator it = next_thread_data->birth_map_.begin();
-         next_thread_data->birth_map_.end() != it; ++it)
-      delete it->second;  // Delete the Birth Records.
-    delete next_thread_data;  // Includes all Death Records.
+    delete next_thread_data;  // Includes its arena of Birth and Death Records.
   }
 }
 
@@ -18,6 +18,7 @@
 #include "base/lazy_instance.h"
 #include "base/location.h"
 #include "base/profiler/alternate_timer.h"
+#include "base/profiler/thread_data_arena.h"
 #include "base/profiler/tracked_time.h"
 #include "base/time.h"
 #include "base/synchronization/lock.h"
@@ -101,11 +102,15 @@
 //
 // Each thread maintains a list of data items specific to that thread in a
 // ThreadData instance (for that specific thread only).  The two critical items
-// are lists of DeathData and Births instances.  These lists are maintained in
-// STL maps, which are indexed by Location. As noted earlier, we can compare
-// locations very efficiently as we consider the underlying data (file,
-// function, line) to be atoms, and hence pointer comparison is used rather than
-// (slow) string comparisons.
+// are lists of DeathData and Births instances.  These records are carved out of
+// a per-thread ThreadDataArena, and are indexed by open-addressed hash tables
+// keyed by Location (for Births) and by Births pointer (for DeathData).  As
+// noted earlier, we can compare locations very efficiently as we consider the
+// underlying data (file, function, line) to be atoms, and hence pointer
+// hashing and comparison is used rather than (slow) string comparisons.  Only
+// the owning thread adds records, and it publishes each one with a release
+// store, so other threads can walk the tables to take a snapshot without
+// taking a lock or stopping the thread.
 //
 // To provide a mechanism for iterating over all "known threads," which means
 // threads that have recorded a birth or a death, we create a singly linked list
@@ -496,6 +501,43 @@ class BASE_EXPORT ThreadData {
 
   typedef std::map<const BirthOnThread*, int> BirthCountMap;
 
+  // The per-thread tally of deaths for one Births instance.
+  struct DeathRecord {
+    explicit DeathRecord(const Births* birth) : birth(birth) {}
+
+    const Births* const birth;
+    DeathData death_data;
+  };
+
+  // ArenaHashTable traits for Births keyed by birth Location.
+  struct BirthTableTraits {
+    typedef Location Key;
+    static Location KeyOf(const Births& births) { return births.location(); }
+    static size_t Hash(const Location& location) {
+      return HashPointer(location.file_name()) ^
+          (HashPointer(location.function_name()) * 31) ^
+          static_cast<size_t>(location.line_number());
+    }
+    static bool Equals(const Location& a, const Location& b) {
+      return a.line_number() == b.line_number() &&
+          a.file_name() == b.file_name() &&
+          a.function_name() == b.function_name();
+    }
+  };
+
+  // ArenaHashTable traits for DeathRecords keyed by their Births.
+  struct DeathTableTraits {
+    typedef const Births* Key;
+    static const Births* KeyOf(const DeathRecord& record) {
+      return record.birth;
+    }
+    static size_t Hash(const Births* birth) { return HashPointer(birth); }
+    static bool Equals(const Births* a, const Births* b) { return a == b; }
+  };
+
+  typedef ArenaHashTable<Births, BirthTableTraits> BirthTable;
+  typedef ArenaHashTable<DeathRecord, DeathTableTraits> DeathTable;
+
   // Worker thread construction creates a name since there is none.
   explicit ThreadData(int thread_number);
 
@@ -543,17 +585,17 @@ class BASE_EXPORT ThreadData {
                              ProcessDataSnapshot* process_data,
                              BirthCountMap* birth_counts);
 
-  // Using our lock, make a copy of the specified maps.  This call may be made
-  // on  non-local threads, which necessitate the use of the lock to prevent
-  // the map(s) from being reallocaed while they are copied. If |reset_max| is
-  // true, then, just after we copy the DeathMap, we will set the max values to
-  // zero in the active DeathMap (not the snapshot).
+  // Make a copy of the birth and death tables into the specified maps, and
+  // (using our lock) of the parent-child set.  This call may be made on
+  // non-local threads; the tables can be walked while this thread keeps adding
+  // to them.  If |reset_max| is true, then, just after we copy each DeathData,
+  // we will set its max values to zero in the active table (not the snapshot).
   void SnapshotMaps(bool reset_max,
                     BirthMap* birth_map,
                     DeathMap* death_map,
                     ParentChildSet* parent_child_set);
 
-  // Using our lock to protect the iteration, Clear all birth and death data.
+  // Clear all birth and death data.
   void Reset();
 
   // This method is called by the TLS system when a thread terminates.
@@ -636,29 +678,30 @@ class BASE_EXPORT ThreadData {
   // corresponding to the created thread name if it is a worker thread.
   int worker_thread_number_;
 
-  // A map used on each thread to keep track of Births on this thread.
-  // This map should only be accessed on the thread it was constructed on.
-  // When a snapshot is needed, this structure can be locked in place for the
-  // duration of the snapshotting activity.
-  BirthMap birth_map_;
+  // Backing store for the Births and DeathRecord instances of this thread.
+  // Records are never freed before the ThreadData itself.
+  ThreadDataArena arena_;
+
+  // A table used on each thread to keep track of Births on this thread.
+  // Records are only added on the thread it was constructed on, but the table
+  // may be read from any thread without a lock.
+  BirthTable birth_table_;
 
-  // Similar to birth_map_, this records informations about death of tracked
+  // Similar to birth_table_, this records informations about death of tracked
   // instances (i.e., when a tracked instance was destroyed on this thread).
-  // It is locked before changing, and hence other threads may access it by
-  // locking before reading it.
-  DeathMap death_map_;
+  DeathTable death_table_;
 
   // A set of parents that created children tasks on this thread. Each pair
   // corresponds to potentially non-local Births (location and thread), and a
   // local Births (that took place on this thread).
   ParentChildSet parent_child_set_;
 
-  // Lock to protect *some* access to BirthMap and DeathMap.  The maps are
-  // regularly read and written on this thread, but may only be read from other
-  // threads.  To support this, we acquire this lock if we are writing from this
-  // thread, or reading from another thread.  For reading from this thread we
-  // don't need a lock, as there is no potential for a conflict since the
-  // writing is only done from this thread.
+  // Lock to protect *some* access to parent_child_set_.  The set is regularly
+  // read and written on this thread, but may only be read from other threads.
+  // To support this, we acquire this lock if we are writing from this thread,
+  // or reading from another thread.  For reading from this thread we don't
+  // need a lock, as there is no potential for a conflict since the writing is
+  // only done from this thread.
   mutable base::Lock map_lock_;
 
   // The stack of parents that are currently being profiled. This includes only
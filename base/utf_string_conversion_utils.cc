@@ -4,7 +4,127 @@
 
 #include "base/utf_string_conversion_utils.h"
 
+#include "base/logging.h"
 #include "base/third_party/icu/icu_utf.h"
+#include "build/build_config.h"
+
+// SSE2 is part of x86-64, and is what 32-bit x86 builds target too, but only
+// use it when the compiler says it may.
+#if defined(ARCH_CPU_X86_FAMILY) && (defined(__SSE2__) || \
+    defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define ASCII_FAST_PATH_SSE2 1
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+#define ASCII_FAST_PATH_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// The number of characters the vector fast paths handle at a time.
+const size_t kASCIIBlockSize = 16;
+
+template<typename CHAR>
+inline bool IsASCII(CHAR c) {
+  return static_cast<uint32>(c) < 0x80;
+}
+
+#if defined(ASCII_FAST_PATH_SSE2)
+
+// Each of these returns true if the 16 characters at |src| are all ASCII.
+inline bool IsASCIIBlock(const char* src) {
+  __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  return _mm_movemask_epi8(chars) == 0;
+}
+
+inline bool IsASCIIBlock(const char16* src) {
+  const __m128i* block = reinterpret_cast<const __m128i*>(src);
+  __m128i chars = _mm_or_si128(_mm_loadu_si128(block),
+                               _mm_loadu_si128(block + 1));
+  // Only ASCII characters have none of the top nine bits set.
+  __m128i high_bits = _mm_and_si128(chars, _mm_set1_epi16(0xFF80));
+  return _mm_movemask_epi8(_mm_cmpeq_epi16(high_bits,
+                                           _mm_setzero_si128())) == 0xFFFF;
+}
+
+// Each of these converts 16 ASCII characters.
+inline void WidenASCIIBlock(const char* src, char16* dest) {
+  __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  __m128i zero = _mm_setzero_si128();
+  __m128i* out = reinterpret_cast<__m128i*>(dest);
+  _mm_storeu_si128(out, _mm_unpacklo_epi8(chars, zero));
+  _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(chars, zero));
+}
+
+inline void NarrowASCIIBlock(const char16* src, char* dest) {
+  const __m128i* block = reinterpret_cast<const __m128i*>(src);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                   _mm_packus_epi16(_mm_loadu_si128(block),
+                                    _mm_loadu_si128(block + 1)));
+}
+
+#elif defined(ASCII_FAST_PATH_NEON)
+
+inline bool IsASCIIBlock(const char* src) {
+  uint8x16_t chars = vld1q_u8(reinterpret_cast<const uint8*>(src));
+  uint64x2_t words = vreinterpretq_u64_u8(chars);
+  uint64 high_bits = vgetq_lane_u64(words, 0) | vgetq_lane_u64(words, 1);
+  return (high_bits & 0x8080808080808080ULL) == 0;
+}
+
+inline bool IsASCIIBlock(const char16* src) {
+  const uint16* block = reinterpret_cast<const uint16*>(src);
+  uint16x8_t chars = vorrq_u16(vld1q_u16(block), vld1q_u16(block + 8));
+  uint64x2_t words = vreinterpretq_u64_u16(chars);
+  uint64 high_bits = vgetq_lane_u64(words, 0) | vgetq_lane_u64(words, 1);
+  return (high_bits & 0xFF80FF80FF80FF80ULL) == 0;
+}
+
+inline void WidenASCIIBlock(const char* src, char16* dest) {
+  uint8x16_t chars = vld1q_u8(reinterpret_cast<const uint8*>(src));
+  uint16* out = reinterpret_cast<uint16*>(dest);
+  vst1q_u16(out, vmovl_u8(vget_low_u8(chars)));
+  vst1q_u16(out + 8, vmovl_u8(vget_high_u8(chars)));
+}
+
+inline void NarrowASCIIBlock(const char16* src, char* dest) {
+  const uint16* block = reinterpret_cast<const uint16*>(src);
+  vst1q_u8(reinterpret_cast<uint8*>(dest),
+           vcombine_u8(vmovn_u16(vld1q_u16(block)),
+                       vmovn_u16(vld1q_u16(block + 8))));
+}
+
+#endif
+
+// Returns the index of the first non-ASCII character in |src| at or after
+// |i|, or |src_len|.
+template<typename CHAR>
+size_t FindNonASCII(const CHAR* src, size_t src_len, size_t i) {
+  while (i < src_len && IsASCII(src[i]))
+    ++i;
+  return i;
+}
+
+// The same, finding the first block with a non-ASCII character in it first.
+template<typename CHAR>
+size_t FindNonASCIIByBlocks(const CHAR* src, size_t src_len) {
+  size_t i = 0;
+#if defined(ASCII_FAST_PATH_SSE2) || defined(ASCII_FAST_PATH_NEON)
+  while (i + kASCIIBlockSize <= src_len && IsASCIIBlock(src + i))
+    i += kASCIIBlockSize;
+#endif
+  return FindNonASCII(src, src_len, i);
+}
+
+template<typename SRC_CHAR, typename DEST_CHAR>
+void CopyASCIIT(const SRC_CHAR* src, size_t src_len, DEST_CHAR* dest) {
+  for (size_t i = 0; i < src_len; ++i) {
+    DCHECK(IsASCII(src[i]));
+    dest[i] = static_cast<DEST_CHAR>(src[i]);
+  }
+}
+
+}  // namespace
 
 namespace base {
 
@@ -102,6 +222,56 @@ size_t WriteUnicodeCharacter(uint32 code_point, string16* output) {
   return CBU16_MAX_LENGTH;
 }
 
+// ASCII fast paths ------------------------------------------------------------
+
+size_t CountLeadingASCII(const char* src, size_t src_len) {
+  return FindNonASCIIByBlocks(src, src_len);
+}
+
+size_t CountLeadingASCII(const char16* src, size_t src_len) {
+  return FindNonASCIIByBlocks(src, src_len);
+}
+
+void CopyASCII(const char* src, size_t src_len, char16* dest) {
+  size_t i = 0;
+#if defined(ASCII_FAST_PATH_SSE2) || defined(ASCII_FAST_PATH_NEON)
+  for (; i + kASCIIBlockSize <= src_len; i += kASCIIBlockSize)
+    WidenASCIIBlock(src + i, dest + i);
+#endif
+  CopyASCIIT(src + i, src_len - i, dest + i);
+}
+
+void CopyASCII(const char16* src, size_t src_len, char* dest) {
+  size_t i = 0;
+#if defined(ASCII_FAST_PATH_SSE2) || defined(ASCII_FAST_PATH_NEON)
+  for (; i + kASCIIBlockSize <= src_len; i += kASCIIBlockSize)
+    NarrowASCIIBlock(src + i, dest + i);
+#endif
+  CopyASCIIT(src + i, src_len - i, dest + i);
+}
+
+#if defined(WCHAR_T_IS_UTF32)
+size_t CountLeadingASCII(const wchar_t* src, size_t src_len) {
+  return FindNonASCII(src, src_len, 0);
+}
+
+void CopyASCII(const char* src, size_t src_len, wchar_t* dest) {
+  CopyASCIIT(src, src_len, dest);
+}
+
+void CopyASCII(const wchar_t* src, size_t src_len, char* dest) {
+  CopyASCIIT(src, src_len, dest);
+}
+
+void CopyASCII(const char16* src, size_t src_len, wchar_t* dest) {
+  CopyASCIIT(src, src_len, dest);
+}
+
+void CopyASCII(const wchar_t* src, size_t src_len, char16* dest) {
+  CopyASCIIT(src, src_len, dest);
+}
+#endif  // defined(WCHAR_T_IS_UTF32)
+
 // Generalized Unicode converter -----------------------------------------------
 
 template<typename CHAR>
@@ -79,6 +79,30 @@ inline size_t WriteUnicodeCharacter(uint32 code_point, std::wstring* output) {
 }
 #endif  // defined(WCHAR_T_IS_UTF32)
 
+// ASCII fast paths ------------------------------------------------------------
+
+// Returns the number of ASCII characters at the start of |src|.  The 8- and
+// 16-bit versions examine 16 characters at a time with SSE2 or NEON where
+// the build allows it.
+BASE_EXPORT size_t CountLeadingASCII(const char* src, size_t src_len);
+BASE_EXPORT size_t CountLeadingASCII(const char16* src, size_t src_len);
+
+#if defined(WCHAR_T_IS_UTF32)
+BASE_EXPORT size_t CountLeadingASCII(const wchar_t* src, size_t src_len);
+#endif  // defined(WCHAR_T_IS_UTF32)
+
+// Copies the |src_len| characters of |src|, which must all be ASCII, to
+// |dest|, widening or narrowing each one.
+BASE_EXPORT void CopyASCII(const char* src, size_t src_len, char16* dest);
+BASE_EXPORT void CopyASCII(const char16* src, size_t src_len, char* dest);
+
+#if defined(WCHAR_T_IS_UTF32)
+BASE_EXPORT void CopyASCII(const char* src, size_t src_len, wchar_t* dest);
+BASE_EXPORT void CopyASCII(const wchar_t* src, size_t src_len, char* dest);
+BASE_EXPORT void CopyASCII(const char16* src, size_t src_len, wchar_t* dest);
+BASE_EXPORT void CopyASCII(const wchar_t* src, size_t src_len, char16* dest);
+#endif  // defined(WCHAR_T_IS_UTF32)
+
 // Generalized Unicode converter -----------------------------------------------
 
 // Guesses the length of the output in UTF-8 in bytes, clears that output
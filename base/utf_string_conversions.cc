@@ -8,6 +8,8 @@
 #include "base/string_util.h"
 #include "base/utf_string_conversion_utils.h"
 
+using base::CopyASCII;
+using base::CountLeadingASCII;
 using base::PrepareForUTF8Output;
 using base::PrepareForUTF16Or32Output;
 using base::ReadUnicodeCharacter;
@@ -29,6 +31,16 @@ bool ConvertUnicode(const SRC_CHAR* src,
   bool success = true;
   int32 src_len32 = static_cast<int32>(src_len);
   for (int32 i = 0; i < src_len32; i++) {
+    // Most text is mostly ASCII, so copy whole runs of it at once.
+    if (static_cast<uint32>(src[i]) < 0x80) {
+      size_t run = CountLeadingASCII(src + i, src_len32 - i);
+      size_t offset = output->size();
+      output->resize(offset + run);
+      CopyASCII(src + i, run, &(*output)[offset]);
+      i += static_cast<int32>(run) - 1;
+      continue;
+    }
+
     uint32 code_point;
     if (ReadUnicodeCharacter(src, src_len32, &i, &code_point)) {
       WriteUnicodeCharacter(code_point, output);
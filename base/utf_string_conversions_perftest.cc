@@ -0,0 +1,145 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/utf_string_conversions.h"
+
+#include <string>
+
+#include "base/perftimer.h"
+#include "base/string16.h"
+#include "base/string_util.h"
+#include "base/third_party/icu/icu_utf.h"
+#include "base/utf_string_conversion_utils.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+const int kIterations = 200;
+
+// The conversions as they were before the ASCII fast paths, one code point
+// at a time.
+template<typename SRC_CHAR, typename DEST_STRING>
+bool ConvertPerCodePoint(const SRC_CHAR* src, size_t src_len,
+                         DEST_STRING* output) {
+  bool success = true;
+  int32 src_len32 = static_cast<int32>(src_len);
+  for (int32 i = 0; i < src_len32; i++) {
+    uint32 code_point;
+    if (ReadUnicodeCharacter(src, src_len32, &i, &code_point)) {
+      WriteUnicodeCharacter(code_point, output);
+    } else {
+      WriteUnicodeCharacter(0xFFFD, output);
+      success = false;
+    }
+  }
+  return success;
+}
+
+bool IsStringASCIIPerCharacter(const std::string& str) {
+  for (size_t i = 0; i < str.length(); i++) {
+    if (static_cast<unsigned char>(str[i]) > 0x7F)
+      return false;
+  }
+  return true;
+}
+
+bool IsStringUTF8PerCodePoint(const std::string& str) {
+  const char *src = str.data();
+  int32 src_len = static_cast<int32>(str.length());
+  int32 char_index = 0;
+  while (char_index < src_len) {
+    int32 code_point;
+    CBU8_NEXT(src, char_index, src_len, code_point);
+    if (!IsValidCharacter(code_point))
+      return false;
+  }
+  return true;
+}
+
+// Roughly 64KB of URL-like ASCII text; with |accents|, about one character in
+// sixty is U+00E9 instead.
+std::string CreateText(bool accents) {
+  std::string text;
+  for (int i = 0; text.size() < 64 * 1024; ++i) {
+    text += "http://www.example.com/path/to/some/page.html?query=value&n=";
+    text += static_cast<char>('0' + i % 10);
+    if (accents)
+      text += "\xc3\xa9";
+    text += " ";
+  }
+  return text;
+}
+
+void RunConversions(const char* name, const std::string& utf8) {
+  string16 utf16 = UTF8ToUTF16(utf8);
+  std::string name_string(name);
+
+  {
+    PerfTimeLogger timer(("UTF8ToUTF16_per_code_point_" + name_string).c_str());
+    for (int i = 0; i < kIterations; ++i) {
+      string16 output;
+      PrepareForUTF16Or32Output(utf8.data(), utf8.size(), &output);
+      ConvertPerCodePoint(utf8.data(), utf8.size(), &output);
+      ASSERT_EQ(utf16, output);
+    }
+  }
+  {
+    PerfTimeLogger timer(("UTF8ToUTF16_" + name_string).c_str());
+    for (int i = 0; i < kIterations; ++i)
+      ASSERT_EQ(utf16, UTF8ToUTF16(utf8));
+  }
+  {
+    PerfTimeLogger timer(("UTF16ToUTF8_per_code_point_" + name_string).c_str());
+    for (int i = 0; i < kIterations; ++i) {
+      std::string output;
+      PrepareForUTF8Output(utf16.data(), utf16.size(), &output);
+      ConvertPerCodePoint(utf16.data(), utf16.size(), &output);
+      ASSERT_EQ(utf8, output);
+    }
+  }
+  {
+    PerfTimeLogger timer(("UTF16ToUTF8_" + name_string).c_str());
+    for (int i = 0; i < kIterations; ++i)
+      ASSERT_EQ(utf8, UTF16ToUTF8(utf16));
+  }
+  {
+    PerfTimeLogger timer(
+        ("IsStringUTF8_per_code_point_" + name_string).c_str());
+    for (int i = 0; i < kIterations; ++i)
+      ASSERT_TRUE(IsStringUTF8PerCodePoint(utf8));
+  }
+  {
+    PerfTimeLogger timer(("IsStringUTF8_" + name_string).c_str());
+    for (int i = 0; i < kIterations; ++i)
+      ASSERT_TRUE(IsStringUTF8(utf8));
+  }
+}
+
+}  // namespace
+
+TEST(UTFStringConversionsPerfTest, ASCII) {
+  RunConversions("ascii", CreateText(false));
+}
+
+TEST(UTFStringConversionsPerfTest, MostlyASCII) {
+  RunConversions("mostly_ascii", CreateText(true));
+}
+
+TEST(UTFStringConversionsPerfTest, IsStringASCII) {
+  const std::string text(CreateText(false));
+  {
+    PerfTimeLogger timer("IsStringASCII_per_character");
+    for (int i = 0; i < kIterations; ++i)
+      ASSERT_TRUE(IsStringASCIIPerCharacter(text));
+  }
+  {
+    PerfTimeLogger timer("IsStringASCII");
+    for (int i = 0; i < kIterations; ++i)
+      ASSERT_TRUE(IsStringASCII(text));
+  }
+}
+
+}  // namespace base
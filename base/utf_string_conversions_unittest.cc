@@ -208,4 +208,40 @@ TEST(UTFStringConversionsTest, ConvertMultiString) {
   EXPECT_EQ(expected, converted);
 }
 
+// The ASCII fast paths work on blocks of characters, so put a non-ASCII
+// character at every position of strings of various lengths.
+TEST(UTFStringConversionsTest, ConvertASCIIRuns) {
+  for (size_t length = 0; length < 40; ++length) {
+    for (size_t position = 0; position <= length; ++position) {
+      std::string utf8(length, 'a');
+      string16 utf16(length, 'a');
+      std::wstring wide(length, L'a');
+      if (position < length) {
+        // U+00E9, which is 2 bytes in UTF-8.
+        utf8.replace(position, 1, "\xc3\xa9");
+        utf16[position] = 0xE9;
+        wide[position] = 0xE9;
+      }
+
+      EXPECT_EQ(utf16, UTF8ToUTF16(utf8)) << length << " " << position;
+      EXPECT_EQ(utf8, UTF16ToUTF8(utf16)) << length << " " << position;
+      EXPECT_EQ(wide, UTF8ToWide(utf8)) << length << " " << position;
+      EXPECT_EQ(utf8, WideToUTF8(wide)) << length << " " << position;
+      EXPECT_EQ(wide, UTF16ToWide(utf16)) << length << " " << position;
+      EXPECT_EQ(utf16, WideToUTF16(wide)) << length << " " << position;
+
+      // Invalid UTF-8 after a run of ASCII is still replaced.
+      if (position < length) {
+        std::string invalid(length, 'a');
+        invalid[position] = '\xff';
+        string16 converted;
+        EXPECT_FALSE(UTF8ToUTF16(invalid.data(), invalid.size(), &converted));
+        string16 expected(length, 'a');
+        expected[position] = 0xFFFD;
+        EXPECT_EQ(expected, converted);
+      }
+    }
+  }
+}
+
 }  // base
@@ -167,6 +167,9 @@ static char* my_strncat(char *dest, const char* src, size_t len) {
 
 namespace {
 
+// The size of the chunks a dump is copied into an upload in.
+const size_t kDumpChunkSize = 64 * 1024;
+
 // MIME substrings.
 const char g_rn[] = "\r\n";
 const char g_form_data_msg[] = "Content-Disposition: form-data; name=\"";
@@ -217,6 +220,12 @@ class MimeWriter {
   void AddFileDump(uint8_t* file_data,
                    size_t file_size);
 
+  // Like AddFileDump(), but copies the dump from |file_fd| to the end of the
+  // file through |buffer|, |buffer_size| bytes at a time.
+  void AddFileDumpFromFd(int file_fd,
+                         uint8_t* buffer,
+                         size_t buffer_size);
+
   // Flush any pending iovecs to the output file.
   void Flush() {
     IGNORE_RET(sys_writev(fd_, iov_, iov_index_));
@@ -230,6 +239,7 @@ class MimeWriter {
     AddItem(str, my_strlen(str));
   }
   void AddItemWithoutTrailingSpaces(const void* base, size_t size);
+  void AddFileDumpHeader();
 
   struct kernel_iovec iov_[kIovCapacity];
   int iov_index_;
@@ -316,14 +326,35 @@ void MimeWriter::AddPairDataInChunks(const char* msg_type,
 
 void MimeWriter::AddFileDump(uint8_t* file_data,
                              size_t file_size) {
+  AddFileDumpHeader();
+  AddItem(file_data, file_size);
+  AddString(g_rn);
+}
+
+void MimeWriter::AddFileDumpFromFd(int file_fd,
+                                   uint8_t* buffer,
+                                   size_t buffer_size) {
+  AddFileDumpHeader();
+  for (;;) {
+    // |buffer| is reused for every chunk, so each is written out before the
+    // next is read.
+    Flush();
+    const ssize_t bytes_read =
+        HANDLE_EINTR(sys_read(file_fd, buffer, buffer_size));
+    if (bytes_read <= 0)
+      break;
+    AddItem(buffer, bytes_read);
+  }
+  AddString(g_rn);
+}
+
+void MimeWriter::AddFileDumpHeader() {
   AddString(g_form_data_msg);
   AddString(g_dump_msg);
   AddString(g_rn);
   AddString(g_content_type_msg);
   AddString(g_rn);
   AddString(g_rn);
-  AddItem(file_data, file_size);
-  AddString(g_rn);
 }
 
 void MimeWriter::AddItem(const void* base, size_t size) {
@@ -383,7 +414,15 @@ void HandleCrashDump(const BreakpadInfo& info) {
 
   google_breakpad::PageAllocator allocator;
 
-  uint8_t* dump_data = reinterpret_cast<uint8_t*>(allocator.Alloc(st.st_size));
+  // When uploading, the MIME block is written to a temp file, so the dump is
+  // copied into it a chunk at a time rather than held in memory whole. When
+  // not, the MIME block replaces the dump in its own file, which needs all of
+  // the dump read first.
+  size_t dump_buffer_size = st.st_size;
+  if (info.upload && dump_buffer_size > kDumpChunkSize)
+    dump_buffer_size = kDumpChunkSize;
+  uint8_t* dump_data =
+      reinterpret_cast<uint8_t*>(allocator.Alloc(dump_buffer_size));
   if (!dump_data) {
     static const char msg[] = "Cannot upload crash dump: cannot alloc\n";
     WriteLog(msg, sizeof(msg));
@@ -391,8 +430,10 @@ void HandleCrashDump(const BreakpadInfo& info) {
     return;
   }
 
-  sys_read(dumpfd, dump_data, st.st_size);
-  IGNORE_RET(sys_close(dumpfd));
+  if (!info.upload) {
+    sys_read(dumpfd, dump_data, st.st_size);
+    IGNORE_RET(sys_close(dumpfd));
+  }
 
   // We need to build a MIME block for uploading to the server. Since we are
   // going to fork and run wget, it needs to be written to a temp file.
@@ -402,6 +443,8 @@ void HandleCrashDump(const BreakpadInfo& info) {
     static const char msg[] = "Cannot upload crash dump because /dev/urandom"
                               " is missing\n";
     WriteLog(msg, sizeof(msg) - 1);
+    if (info.upload)
+      IGNORE_RET(sys_close(dumpfd));
     return;
   }
 
@@ -427,6 +470,7 @@ void HandleCrashDump(const BreakpadInfo& info) {
           "cannot upload crash dump\n";
       WriteLog(msg, sizeof(msg) - 1);
       IGNORE_RET(sys_close(ufd));
+      IGNORE_RET(sys_close(dumpfd));
       return;
     }
   } else {
@@ -726,7 +770,12 @@ void HandleCrashDump(const BreakpadInfo& info) {
     writer.Flush();
   }
 
-  writer.AddFileDump(dump_data, st.st_size);
+  if (info.upload) {
+    writer.AddFileDumpFromFd(dumpfd, dump_data, dump_buffer_size);
+    IGNORE_RET(sys_close(dumpfd));
+  } else {
+    writer.AddFileDump(dump_data, st.st_size);
+  }
   writer.AddEnd();
   writer.Flush();
 
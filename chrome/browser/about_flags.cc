@@ -420,11 +420,11 @@ const Experiment kExperiments[] = {
     SINGLE_VALUE_TYPE(switches::kEnableSpdy3)
   },
   {
-    "enable-async-dns",
-    IDS_FLAGS_ENABLE_ASYNC_DNS_NAME,
-    IDS_FLAGS_ENABLE_ASYNC_DNS_DESCRIPTION,
+    "disable-async-dns",
+    IDS_FLAGS_DISABLE_ASYNC_DNS_NAME,
+    IDS_FLAGS_DISABLE_ASYNC_DNS_DESCRIPTION,
     kOsWin | kOsMac | kOsLinux | kOsCrOS,
-    SINGLE_VALUE_TYPE(switches::kEnableAsyncDns)
+    SINGLE_VALUE_TYPE(switches::kDisableAsyncDns)
   },
   {
     "enable-video-track",
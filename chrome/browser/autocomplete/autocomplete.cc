@@ -924,9 +924,20 @@ void AutocompleteController::Start(
   base::TimeTicks start_time = base::TimeTicks::Now();
   for (ACProviders::iterator i(providers_.begin()); i != providers_.end();
        ++i) {
+    base::TimeTicks provider_start_time = base::TimeTicks::Now();
     (*i)->Start(input_, minimal_changes);
-    if (matches_requested != AutocompleteInput::ALL_MATCHES)
+    if (matches_requested != AutocompleteInput::ALL_MATCHES) {
       DCHECK((*i)->done());
+    } else {
+      // Record how long the synchronous pass of each provider holds up the
+      // keystroke, so that the slow ones can be found.
+      base::Histogram* counter = base::Histogram::FactoryTimeGet(
+          std::string("Omnibox.ProviderTime.") + (*i)->name(),
+          base::TimeDelta::FromMilliseconds(1),
+          base::TimeDelta::FromSeconds(1), 50,
+          base::Histogram::kUmaTargetedHistogramFlag);
+      counter->AddTime(base::TimeTicks::Now() - provider_start_time);
+    }
   }
   if (matches_requested == AutocompleteInput::ALL_MATCHES &&
       (text.length() < 6)) {
@@ -116,8 +116,12 @@ void BookmarkIndex::SortMatches(const Matches& matches,
   history::URLDatabase* url_db = history_service ?
       history_service->InMemoryDatabase() : NULL;
 
+  // A node matches more than once if several words of its title start with
+  // a prefix term. Look it up and return it only once.
+  NodeSet nodes;
   for (Matches::const_iterator i = matches.begin(); i != matches.end(); ++i)
-    ExtractBookmarkNodePairs(url_db, *i, node_typed_counts);
+    nodes.insert(i->nodes_begin(), i->nodes_end());
+  ExtractBookmarkNodePairs(url_db, nodes, node_typed_counts);
 
   std::sort(node_typed_counts->begin(), node_typed_counts->end(),
             &NodeTypedCountPairSortFunc);
@@ -125,11 +129,10 @@ void BookmarkIndex::SortMatches(const Matches& matches,
 
 void BookmarkIndex::ExtractBookmarkNodePairs(
     history::URLDatabase* url_db,
-    const Match& match,
+    const NodeSet& nodes,
     NodeTypedCountPairs* node_typed_counts) const {
-
-  for (NodeSet::const_iterator i = match.nodes_begin();
-       i != match.nodes_end(); ++i) {
+  node_typed_counts->reserve(node_typed_counts->size() + nodes.size());
+  for (NodeSet::const_iterator i = nodes.begin(); i != nodes.end(); ++i) {
     history::URLRow url;
     if (url_db)
       url_db->GetRowForURL((*i)->url(), &url);
@@ -131,6 +131,9 @@ TEST_F(BookmarkIndexTest, Tests) {
     // Title with term multiple times.
     { "ab ab",                      "ab",       "ab ab"},
 
+    // Title with several words starting with the term.
+    { "abcd abcde",                 "abc",      "abcd abcde"},
+
     // Make sure quotes don't do a prefix match.
     { "think",                      "\"thi\"",  ""},
   };
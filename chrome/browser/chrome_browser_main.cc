@@ -116,6 +116,7 @@
 #include "net/http/http_stream_factory.h"
 #include "net/socket/client_socket_pool_base.h"
 #include "net/socket/client_socket_pool_manager.h"
+#include "net/socket/ssl_host_info.h"
 #include "net/spdy/spdy_session.h"
 #include "net/spdy/spdy_session_pool.h"
 #include "net/url_request/url_request.h"
@@ -424,8 +425,10 @@ Profile* CreateProfile(const content::MainFunctionParams& parameters,
 
 // Load GPU Blacklist, collect preliminary gpu info, and compute preliminary
 // gpu feature flags.
-void InitializeGpuDataManager(const CommandLine& parsed_command_line) {
-  content::GpuDataManager::GetInstance();
+void InitializeGpuDataManager(const CommandLine& parsed_command_line,
+                              const FilePath& user_data_dir) {
+  content::GpuDataManager::GetInstance()->SetProgramCacheDirectory(
+      user_data_dir.Append(FILE_PATH_LITERAL("GPUCache")));
   if (parsed_command_line.HasSwitch(switches::kSkipGpuDataLoading) ||
       parsed_command_line.HasSwitch(switches::kIgnoreGpuBlacklist)) {
     return;
@@ -842,6 +845,9 @@ void ChromeBrowserMainParts::SpdyFieldTrial() {
 // warmest socket.
 void ChromeBrowserMainParts::WarmConnectionFieldTrial() {
   const CommandLine& command_line = parsed_command_line();
+  if (command_line.HasSwitch(switches::kEnableWarmSocketPool))
+    net::internal::ClientSocketPoolBaseHelper::set_warm_pool_enabled(true);
+
   if (command_line.HasSwitch(switches::kSocketReusePolicy)) {
     std::string socket_reuse_policy_str = command_line.GetSwitchValueASCII(
         switches::kSocketReusePolicy);
@@ -1719,6 +1725,9 @@ int ChromeBrowserMainParts::PreMainMessageLoopRunImpl() {
       net::SdchManager::EnableSdchSupport(false);
   }
 
+  if (parsed_command_line().HasSwitch(switches::kEnablePersistentSSLSessions))
+    net::SSLHostInfo::set_persistent_sessions_enabled(true);
+
   if (parsed_command_line().HasSwitch(switches::kEnableWatchdog))
     InstallJankometer(parsed_command_line());
 
@@ -1774,7 +1783,7 @@ int ChromeBrowserMainParts::PreMainMessageLoopRunImpl() {
 #endif
 
   // Load GPU Blacklist.
-  InitializeGpuDataManager(parsed_command_line());
+  InitializeGpuDataManager(parsed_command_line(), user_data_dir_);
 
   // Start watching all browser threads for responsiveness.
   ThreadWatcherList::StartWatchingAll(parsed_command_line());
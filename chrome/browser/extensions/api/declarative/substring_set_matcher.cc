@@ -78,12 +78,18 @@ bool SubstringSetMatcher::Match(const std::string& text,
   int current_node = 0;
   size_t text_length = text.length();
   for (size_t i = 0; i < text_length; ++i) {
-    while (!tree_[current_node].HasEdge(text[i]) && current_node != 0)
+    int edge = tree_[current_node].GetEdge(text[i]);
+    while (edge == -1 && current_node != 0) {
       current_node = tree_[current_node].failure();
-    if (tree_[current_node].HasEdge(text[i])) {
-      current_node = tree_[current_node].GetEdge(text[i]);
-      matches->insert(tree_[current_node].matches().begin(),
-                      tree_[current_node].matches().end());
+      edge = tree_[current_node].GetEdge(text[i]);
+    }
+    if (edge != -1) {
+      current_node = edge;
+      for (int node = current_node; node != 0;
+           node = tree_[node].output_link()) {
+        matches->insert(tree_[node].matches().begin(),
+                        tree_[node].matches().end());
+      }
     } else {
       DCHECK_EQ(0, current_node);
     }
@@ -155,6 +161,7 @@ void SubstringSetMatcher::CreateFailureEdges() {
        ++e) {
     int leads_to = e->second;
     tree_[leads_to].set_failure(0);
+    tree_[leads_to].set_output_link(0);
     queue.push(leads_to);
   }
 
@@ -168,19 +175,27 @@ void SubstringSetMatcher::CreateFailureEdges() {
       queue.push(leads_to);
 
       int failure = current_node.failure();
-      while (!tree_[failure].HasEdge(edge_label) && failure != 0)
+      int follow_in_case_of_failure = tree_[failure].GetEdge(edge_label);
+      while (follow_in_case_of_failure == -1 && failure != 0) {
         failure = tree_[failure].failure();
-
-      int follow_in_case_of_failure = tree_[failure].HasEdge(e->first) ?
-          tree_[failure].GetEdge(edge_label) : 0;
+        follow_in_case_of_failure = tree_[failure].GetEdge(edge_label);
+      }
+      if (follow_in_case_of_failure == -1)
+        follow_in_case_of_failure = 0;
       tree_[leads_to].set_failure(follow_in_case_of_failure);
-      tree_[leads_to].AddMatches(tree_[follow_in_case_of_failure].matches());
+
+      // The failure node is closer to the root, so its output link is
+      // already known.
+      const AhoCorasickNode& failure_node = tree_[follow_in_case_of_failure];
+      tree_[leads_to].set_output_link(failure_node.matches().empty() ?
+          failure_node.output_link() : follow_in_case_of_failure);
     }
   }
 }
 
 SubstringSetMatcher::AhoCorasickNode::AhoCorasickNode()
-    : failure_(-1) {}
+    : failure_(-1),
+      output_link_(0) {}
 
 SubstringSetMatcher::AhoCorasickNode::~AhoCorasickNode() {}
 
@@ -188,6 +203,7 @@ SubstringSetMatcher::AhoCorasickNode::AhoCorasickNode(
     const SubstringSetMatcher::AhoCorasickNode& other)
     : edges_(other.edges_),
       failure_(other.failure_),
+      output_link_(other.output_link_),
       matches_(other.matches_) {}
 
 SubstringSetMatcher::AhoCorasickNode&
@@ -195,6 +211,7 @@ SubstringSetMatcher::AhoCorasickNode::operator=(
     const SubstringSetMatcher::AhoCorasickNode& other) {
   edges_ = other.edges_;
   failure_ = other.failure_;
+  output_link_ = other.output_link_;
   matches_ = other.matches_;
   return *this;
 }
@@ -216,9 +233,4 @@ void SubstringSetMatcher::AhoCorasickNode::AddMatch(SubstringPattern::ID id) {
   matches_.insert(id);
 }
 
-void SubstringSetMatcher::AhoCorasickNode::AddMatches(
-    const SubstringSetMatcher::AhoCorasickNode::Matches& matches) {
-  matches_.insert(matches.begin(), matches.end());
-}
-
 }  // namespace extensions
@@ -99,6 +99,11 @@ class SubstringSetMatcher {
   // corresponds to the longest proper suffix of text[i, ..., i + k - 1] that
   // is a prefix of any registered pattern.
   //
+  // A node only stores the IDs of the patterns that end at it. The matches
+  // of the nodes on its failure path are reached through |output_link|,
+  // which skips the nodes without matches, so that no ID is stored more than
+  // once no matter how many suffixes the patterns share.
+  //
   // If your brain thinks "Forget it, let's go shopping.", don't worry.
   // Take a nap and read an introductory text on the Aho Corasick algorithm.
   // It will make sense. Eventually.
@@ -114,6 +119,7 @@ class SubstringSetMatcher {
     AhoCorasickNode& operator=(const AhoCorasickNode& other);
 
     bool HasEdge(char c) const;
+    // Returns -1 if there is no edge labeled |c|.
     int GetEdge(char c) const;
     void SetEdge(char c, int node);
     const Edges& edges() const { return edges_; }
@@ -121,8 +127,12 @@ class SubstringSetMatcher {
     int failure() const { return failure_; }
     void set_failure(int failure) { failure_ = failure; }
 
+    // Index of the nearest node on the failure path with matches, or 0 if
+    // there is none. The matches of the root are only reported once.
+    int output_link() const { return output_link_; }
+    void set_output_link(int output_link) { output_link_ = output_link; }
+
     void AddMatch(SubstringPattern::ID id);
-    void AddMatches(const Matches& matches);
     const Matches& matches() const { return matches_; }
 
    private:
@@ -132,6 +142,9 @@ class SubstringSetMatcher {
     // Node index that failure edge leads to.
     int failure_;
 
+    // Node index of the next node with matches on the failure path.
+    int output_link_;
+
     // Identifiers of matches.
     Matches matches_;
   };
@@ -132,6 +132,35 @@ TEST(SubstringSetMatcherTest, TestMatcher) {
   TestTwoPatterns("abcde", "", "abcdef", true, false);
 }
 
+// Patterns that are suffixes of each other are all reported, also when the
+// nodes between them on the failure path have no matches.
+TEST(SubstringSetMatcherTest, TestSuffixes) {
+  SubstringPattern pattern_1("xabcd", 1);
+  SubstringPattern pattern_2("bcd", 2);
+  SubstringPattern pattern_3("d", 3);
+  SubstringPattern pattern_4("abcdy", 4);
+  std::vector<const SubstringPattern*> patterns;
+  patterns.push_back(&pattern_1);
+  patterns.push_back(&pattern_2);
+  patterns.push_back(&pattern_3);
+  patterns.push_back(&pattern_4);
+  SubstringSetMatcher matcher;
+  matcher.RegisterPatterns(patterns);
+
+  std::set<int> matches;
+  matcher.Match("xabcd", &matches);
+  EXPECT_EQ(3u, matches.size());
+  EXPECT_TRUE(matches.end() != matches.find(1));
+  EXPECT_TRUE(matches.end() != matches.find(2));
+  EXPECT_TRUE(matches.end() != matches.find(3));
+
+  matches.clear();
+  matcher.Match("abcd", &matches);
+  EXPECT_EQ(2u, matches.size());
+  EXPECT_TRUE(matches.end() != matches.find(2));
+  EXPECT_TRUE(matches.end() != matches.find(3));
+}
+
 TEST(SubstringSetMatcherTest, RegisterAndRemove) {
   SubstringSetMatcher matcher;
 
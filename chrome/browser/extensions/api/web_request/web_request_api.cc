@@ -1080,8 +1080,8 @@ void ExtensionWebRequestEventRouter::GetMatchingListenersImpl(
       continue;
     }
 
-    if (!it->filter.urls.is_empty() && !it->filter.urls.MatchesURL(url))
-      continue;
+    // Check the URL patterns last, as they are by far the most expensive
+    // part of the filter.
     if (it->filter.tab_id != -1 && tab_id != it->filter.tab_id)
       continue;
     if (it->filter.window_id != -1 && window_id != it->filter.window_id)
@@ -1090,6 +1090,8 @@ void ExtensionWebRequestEventRouter::GetMatchingListenersImpl(
         std::find(it->filter.types.begin(), it->filter.types.end(),
                   resource_type) == it->filter.types.end())
       continue;
+    if (!it->filter.urls.is_empty() && !it->filter.urls.MatchesURL(url))
+      continue;
 
     // extension_info_map can be NULL if this is a system-level request.
     if (extension_info_map) {
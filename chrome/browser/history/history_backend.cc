@@ -207,6 +207,7 @@ HistoryBackend::HistoryBackend(const FilePath& history_dir,
       id_(id),
       history_dir_(history_dir),
       ALLOW_THIS_IN_INITIALIZER_LIST(expirer_(this, bookmark_service)),
+      uncommitted_visit_count_(0),
       recent_redirects_(kMaxRedirectCount),
       backend_destroy_message_loop_(NULL),
       segment_queried_(false),
@@ -777,6 +778,7 @@ std::pair<URLID, VisitID> HistoryBackend::AddPageVisit(
 
   // Broadcast a notification of the visit.
   if (visit_id) {
+    ++uncommitted_visit_count_;
     URLVisitedDetails* details = new URLVisitedDetails;
     details->transition = transition;
     details->row = url_info;
@@ -2059,6 +2061,12 @@ void HistoryBackend::Commit() {
   // some cases) but it hasn't been important yet.
   CancelScheduledCommit();
 
+  // The visits of each commit share one write of the database pages they
+  // touch, so this shows how much the commit interval batches them.
+  UMA_HISTOGRAM_COUNTS_10000("History.VisitsPerCommit",
+                             uncommitted_visit_count_);
+  uncommitted_visit_count_ = 0;
+
   db_->CommitTransaction();
   DCHECK(db_->transaction_nesting() == 0) << "Somebody left a transaction open";
   db_->BeginTransaction();
@@ -631,6 +631,10 @@ class HistoryBackend : public base::RefCountedThreadSafe<HistoryBackend>,
   // scheduled commit at a time (see ScheduleCommit).
   scoped_refptr<CommitLaterTask> scheduled_commit_;
 
+  // The number of visits added since the last commit, which are all written
+  // to disk together by the commit.
+  int uncommitted_visit_count_;
+
   // Maps recent redirect destination pages to the chain of redirects that
   // brought us to there. Pages that did not have redirects or were not the
   // final redirect in a chain will not be in this list, as well as pages that
@@ -276,6 +276,30 @@ void TextDatabase::DeletePageData(base::Time time, const std::string& url) {
   }
 }
 
+bool TextDatabase::MovePageDataIfUnchanged(base::Time old_time,
+                                           base::Time new_time,
+                                           const std::string& url,
+                                           const std::string& title,
+                                           const std::string& contents) {
+  sql::Statement select_page(db_.GetCachedStatement(SQL_FROM_HERE,
+      "SELECT info.rowid, pages.title, pages.body "
+      "FROM info JOIN pages ON info.rowid = pages.rowid "
+      "WHERE info.time=? AND pages.url=?"));
+  select_page.BindInt64(0, old_time.ToInternalValue());
+  select_page.BindString(1, url);
+  if (!select_page.Step() || select_page.ColumnString(1) != title ||
+      select_page.ColumnString(2) != contents)
+    return false;
+  int64 rowid = select_page.ColumnInt64(0);
+
+  // Only the info table needs to change, the full text index stays as it is.
+  sql::Statement update_info(db_.GetCachedStatement(SQL_FROM_HERE,
+      "UPDATE info SET time=? WHERE rowid=?"));
+  update_info.BindInt64(0, new_time.ToInternalValue());
+  update_info.BindInt64(1, rowid);
+  return update_info.Run();
+}
+
 void TextDatabase::Optimize() {
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
       "SELECT OPTIMIZE(pages) FROM pages LIMIT 1"));
@@ -110,6 +110,16 @@ class TextDatabase {
   // Deletes the indexed data exactly matching the given URL/time pair.
   void DeletePageData(base::Time time, const std::string& url);
 
+  // If the data indexed for the given URL at |old_time| is |title| and
+  // |contents|, moves it to |new_time| and returns true. This avoids
+  // tokenizing pages again when they are revisited unchanged. The data should
+  // already be converted to UTF-8.
+  bool MovePageDataIfUnchanged(base::Time old_time,
+                               base::Time new_time,
+                               const std::string& url,
+                               const std::string& title,
+                               const std::string& contents);
+
   // Optimizes the tree inside the database. This will, in addition to making
   // access faster, remove any deleted data from the database (normally it is
   // added again as "removed" and it is manually cleaned up when it decides to
@@ -278,14 +278,27 @@ bool TextDatabaseManager::AddPageData(const GURL& url,
 
   TimeTicks beginning_time = TimeTicks::Now();
 
+  std::string url_str = URLDatabase::GURLToDatabaseURL(url);
+  std::string indexed_title = ConvertStringForIndexer(title);
+  std::string indexed_body = ConvertStringForIndexer(body);
+
   // First delete any recently-indexed data for this page. This will delete
   // anything in the main database, but we don't bother looking through the
-  // archived database.
+  // archived database. When an earlier visit in the same database indexed the
+  // same text, that data is moved to this visit instead, since adding it
+  // again would tokenize the whole page.
+  bool moved = false;
   VisitVector visits;
   visit_database_->GetIndexedVisitsForURL(url_id, &visits);
   for (size_t i = 0; i < visits.size(); i++) {
     visits[i].is_indexed = false;
     visit_database_->UpdateVisitRow(visits[i]);
+    if (!moved && TimeToID(visits[i].visit_time) == TimeToID(visit_time) &&
+        db->MovePageDataIfUnchanged(visits[i].visit_time, visit_time,
+                                    url_str, indexed_title, indexed_body)) {
+      moved = true;
+      continue;
+    }
     DeletePageData(visits[i].visit_time, url, NULL);
   }
 
@@ -298,6 +311,8 @@ bool TextDatabaseManager::AddPageData(const GURL& url,
       // updates have been completely performed.  In this case, a stale update
       // to the database is attempted, leading to the warning below.
       DLOG(WARNING) << "Could not find requested visit #" << visit_id;
+      if (moved)
+        db->DeletePageData(visit_time, url_str);
       return false;
     }
 
@@ -310,10 +325,8 @@ bool TextDatabaseManager::AddPageData(const GURL& url,
   }
 
   // Now index the data.
-  std::string url_str = URLDatabase::GURLToDatabaseURL(url);
-  bool success = db->AddPageData(visit_time, url_str,
-                                 ConvertStringForIndexer(title),
-                                 ConvertStringForIndexer(body));
+  bool success = moved ||
+      db->AddPageData(visit_time, url_str, indexed_title, indexed_body);
 
   UMA_HISTOGRAM_TIMES("History.AddFTSData",
                       TimeTicks::Now() - beginning_time);
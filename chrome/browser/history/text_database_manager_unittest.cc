@@ -266,6 +266,61 @@ TEST_F(TextDatabaseManagerTest, InsertCompleteVisit) {
   EXPECT_TRUE(out_visit.is_indexed);
 }
 
+// Tests that indexing a page again moves the data of its earlier visit when
+// the page did not change, and replaces it when it did.
+TEST_F(TextDatabaseManagerTest, InsertAgain) {
+  ASSERT_TRUE(Init());
+  InMemDB visit_db;
+  TextDatabaseManager manager(dir_, &visit_db, &visit_db);
+  ASSERT_TRUE(manager.Init(NULL));
+
+  Time::Exploded exploded;
+  memset(&exploded, 0, sizeof(Time::Exploded));
+  exploded.year = 2008;
+  exploded.month = 1;
+  exploded.day_of_month = 3;
+
+  VisitRow visits[3];
+  for (size_t i = 0; i < arraysize(visits); i++) {
+    visits[i].url_id = 1;
+    visits[i].visit_time = Time::FromUTCExploded(exploded);
+    visits[i].referring_visit = 0;
+    visits[i].transition = content::PAGE_TRANSITION_LINK;
+    visits[i].segment_id = 0;
+    visits[i].is_indexed = false;
+    visit_db.AddVisit(&visits[i], SOURCE_BROWSED);
+    exploded.day_of_month++;
+  }
+
+  const GURL url(kURL1);
+  manager.AddPageData(url, 1, visits[0].visit_id, visits[0].visit_time,
+                      UTF8ToUTF16(kTitle1), UTF8ToUTF16(kBody1));
+  manager.AddPageData(url, 1, visits[1].visit_id, visits[1].visit_time,
+                      UTF8ToUTF16(kTitle1), UTF8ToUTF16(kBody1));
+
+  QueryOptions options;
+  std::vector<TextDatabase::Match> results;
+  Time first_time_searched;
+  manager.GetTextMatches(UTF8ToUTF16("FOO"), options,
+                         &results, &first_time_searched);
+  ASSERT_EQ(1U, results.size());
+  EXPECT_TRUE(results[0].time == visits[1].visit_time);
+
+  VisitRow out_visit;
+  ASSERT_TRUE(visit_db.GetRowForVisit(visits[0].visit_id, &out_visit));
+  EXPECT_FALSE(out_visit.is_indexed);
+  ASSERT_TRUE(visit_db.GetRowForVisit(visits[1].visit_id, &out_visit));
+  EXPECT_TRUE(out_visit.is_indexed);
+
+  manager.AddPageData(url, 1, visits[2].visit_id, visits[2].visit_time,
+                      UTF8ToUTF16(kTitle2), UTF8ToUTF16(kBody2));
+  manager.GetTextMatches(UTF8ToUTF16("FOO"), options,
+                         &results, &first_time_searched);
+  ASSERT_EQ(1U, results.size());
+  EXPECT_TRUE(results[0].time == visits[2].visit_time);
+  EXPECT_EQ(kTitle2, UTF16ToUTF8(results[0].title));
+}
+
 // Tests that partial inserts that expire are added to the database.
 TEST_F(TextDatabaseManagerTest, InsertPartial) {
   ASSERT_TRUE(Init());
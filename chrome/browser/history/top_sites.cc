@@ -534,8 +534,18 @@ bool TopSites::SetPageThumbnailNoDB(const GURL& url,
 bool TopSites::SetPageThumbnailEncoded(const GURL& url,
                                        const base::RefCountedBytes* thumbnail,
                                        const ThumbnailScore& score) {
+  // Pages that don't change often give the same thumbnail again. The row of
+  // the thumbnail is rewritten with its image on every update, so then only
+  // the new score is kept, in memory.
+  const Images* old_image =
+      cache_->IsKnownURL(url) ? cache_->GetImage(url) : NULL;
+  bool same_thumbnail = old_image && old_image->thumbnail.get() &&
+      old_image->thumbnail->data() == thumbnail->data();
+
   if (!SetPageThumbnailNoDB(url, thumbnail, score))
     return false;
+  if (same_thumbnail)
+    return true;
 
   // Update the database.
   if (!cache_->IsKnownURL(url))
@@ -81,6 +81,35 @@ bool LengthGreater(const string16& string_a, const string16& string_b) {
   return string_a.length() > string_b.length();
 }
 
+// When one set is at least this many times smaller than the other, looking
+// its elements up in the larger set is cheaper than walking both sets.
+const size_t kSetLookupRatio = 16;
+
+// Returns the intersection of |set_a| and |set_b|.
+template <typename T>
+std::set<T> IntersectSets(const std::set<T>& set_a, const std::set<T>& set_b) {
+  const std::set<T>& smaller = set_a.size() < set_b.size() ? set_a : set_b;
+  const std::set<T>& larger = set_a.size() < set_b.size() ? set_b : set_a;
+  std::set<T> result;
+  if (smaller.size() * kSetLookupRatio < larger.size()) {
+    for (typename std::set<T>::const_iterator iter = smaller.begin();
+         iter != smaller.end(); ++iter) {
+      if (larger.count(*iter))
+        result.insert(result.end(), *iter);
+    }
+  } else {
+    std::set_intersection(smaller.begin(), smaller.end(),
+                          larger.begin(), larger.end(),
+                          std::inserter(result, result.begin()));
+  }
+  return result;
+}
+
+// Comparison function for sorting sets by ascending size.
+bool SizeLess(const WordIDSet* set_a, const WordIDSet* set_b) {
+  return set_a->size() < set_b->size();
+}
+
 // std::accumulate helper function to add up TermMatches' lengths.
 int AccumulateMatchLength(int total, const TermMatch& match) {
   return total + match.length;
@@ -325,8 +354,10 @@ void URLIndexPrivateData::AddToHistoryIDWordMap(HistoryID history_id,
                                                 WordID word_id) {
   HistoryIDWordMap::iterator iter = history_id_word_map_.find(history_id);
   if (iter != history_id_word_map_.end()) {
+    // Word IDs mostly arrive in increasing order, see
+    // RestoreWordIDHistoryMap.
     WordIDSet& word_id_set(iter->second);
-    word_id_set.insert(word_id);
+    word_id_set.insert(word_id_set.end(), word_id);
   } else {
     WordIDSet word_id_set;
     word_id_set.insert(word_id);
@@ -773,11 +804,8 @@ HistoryIDSet URLIndexPrivateData::HistoryIDSetFromWords(
     if (iter == words.begin()) {
       history_id_set.swap(term_history_set);
     } else {
-      HistoryIDSet new_history_id_set;
-      std::set_intersection(history_id_set.begin(), history_id_set.end(),
-                            term_history_set.begin(), term_history_set.end(),
-                            std::inserter(new_history_id_set,
-                                          new_history_id_set.begin()));
+      HistoryIDSet new_history_id_set(
+          IntersectSets(history_id_set, term_history_set));
       history_id_set.swap(new_history_id_set);
     }
   }
@@ -850,11 +878,7 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
       if (prefix_chars.empty()) {
         word_id_set.swap(leftover_set);
       } else {
-        WordIDSet new_word_id_set;
-        std::set_intersection(word_id_set.begin(), word_id_set.end(),
-                              leftover_set.begin(), leftover_set.end(),
-                              std::inserter(new_word_id_set,
-                                            new_word_id_set.begin()));
+        WordIDSet new_word_id_set(IntersectSets(word_id_set, leftover_set));
         word_id_set.swap(new_word_id_set);
       }
     }
@@ -898,35 +922,32 @@ HistoryIDSet URLIndexPrivateData::HistoryIDsForTerm(
 
 WordIDSet URLIndexPrivateData::WordIDSetForTermChars(
     const Char16Set& term_chars) {
-  WordIDSet word_id_set;
+  std::vector<const WordIDSet*> char_word_id_sets;
   for (Char16Set::const_iterator c_iter = term_chars.begin();
        c_iter != term_chars.end(); ++c_iter) {
     CharWordIDMap::iterator char_iter = char_word_map_.find(*c_iter);
     if (char_iter == char_word_map_.end()) {
       // A character was not found so there are no matching results: bail.
-      word_id_set.clear();
-      break;
+      return WordIDSet();
     }
-    WordIDSet& char_word_id_set(char_iter->second);
     // It is possible for there to no longer be any words associated with
     // a particular character. Give up in that case.
-    if (char_word_id_set.empty()) {
-      word_id_set.clear();
-      break;
-    }
-
-    if (c_iter == term_chars.begin()) {
-      // First character results becomes base set of results.
-      word_id_set = char_word_id_set;
-    } else {
-      // Subsequent character results get intersected in.
-      WordIDSet new_word_id_set;
-      std::set_intersection(word_id_set.begin(), word_id_set.end(),
-                            char_word_id_set.begin(), char_word_id_set.end(),
-                            std::inserter(new_word_id_set,
-                                          new_word_id_set.begin()));
-      word_id_set.swap(new_word_id_set);
-    }
+    if (char_iter->second.empty())
+      return WordIDSet();
+    char_word_id_sets.push_back(&char_iter->second);
+  }
+  if (char_word_id_sets.empty())
+    return WordIDSet();
+
+  // Start from the rarest character, so that only its few words are looked up
+  // in the sets of the common ones.
+  std::sort(char_word_id_sets.begin(), char_word_id_sets.end(), SizeLess);
+  WordIDSet word_id_set(*char_word_id_sets[0]);
+  for (size_t i = 1; i < char_word_id_sets.size() && !word_id_set.empty();
+       ++i) {
+    WordIDSet new_word_id_set(
+        IntersectSets(word_id_set, *char_word_id_sets[i]));
+    word_id_set.swap(new_word_id_set);
   }
   return word_id_set;
 }
@@ -1199,10 +1220,14 @@ bool URLIndexPrivateData::RestoreWordMap(
   uint32 actual_item_count = list_item.word_map_entry_size();
   if (actual_item_count == 0 || actual_item_count != expected_item_count)
     return false;
+  // The maps and sets were saved in order, so hinting each insertion at the
+  // end rebuilds them in linear time rather than searching for every item.
   const RepeatedPtrField<WordMapEntry>& entries(list_item.word_map_entry());
   for (RepeatedPtrField<WordMapEntry>::const_iterator iter = entries.begin();
-       iter != entries.end(); ++iter)
-    word_map_[UTF8ToUTF16(iter->word())] = iter->word_id();
+       iter != entries.end(); ++iter) {
+    word_map_.insert(word_map_.end(),
+        WordMap::value_type(UTF8ToUTF16(iter->word()), iter->word_id()));
+  }
   return true;
 }
 
@@ -1224,12 +1249,12 @@ bool URLIndexPrivateData::RestoreCharWordMap(
     if (actual_item_count == 0 || actual_item_count != expected_item_count)
       return false;
     char16 uni_char = static_cast<char16>(iter->char_16());
-    WordIDSet word_id_set;
+    WordIDSet& word_id_set(char_word_map_.insert(char_word_map_.end(),
+        CharWordIDMap::value_type(uni_char, WordIDSet()))->second);
     const RepeatedField<int32>& word_ids(iter->word_id());
     for (RepeatedField<int32>::const_iterator jiter = word_ids.begin();
          jiter != word_ids.end(); ++jiter)
-      word_id_set.insert(*jiter);
-    char_word_map_[uni_char] = word_id_set;
+      word_id_set.insert(word_id_set.end(), *jiter);
   }
   return true;
 }
@@ -1252,14 +1277,15 @@ bool URLIndexPrivateData::RestoreWordIDHistoryMap(
     if (actual_item_count == 0 || actual_item_count != expected_item_count)
       return false;
     WordID word_id = iter->word_id();
-    HistoryIDSet history_id_set;
+    HistoryIDSet& history_id_set(word_id_history_map_.insert(
+        word_id_history_map_.end(),
+        WordIDHistoryMap::value_type(word_id, HistoryIDSet()))->second);
     const RepeatedField<int64>& history_ids(iter->history_id());
     for (RepeatedField<int64>::const_iterator jiter = history_ids.begin();
          jiter != history_ids.end(); ++jiter) {
-      history_id_set.insert(*jiter);
+      history_id_set.insert(history_id_set.end(), *jiter);
       AddToHistoryIDWordMap(*jiter, word_id);
     }
-    word_id_history_map_[word_id] = history_id_set;
   }
   return true;
 }
@@ -139,7 +139,7 @@ net::HostResolver* CreateGlobalHostResolver(net::NetLog* net_log) {
   }
 
   net::HostResolver* global_host_resolver = NULL;
-  if (command_line.HasSwitch(switches::kEnableAsyncDns)) {
+  if (!command_line.HasSwitch(switches::kDisableAsyncDns)) {
     global_host_resolver =
         net::CreateAsyncHostResolver(parallelism, retry_attempts, net_log);
   }
@@ -149,6 +149,20 @@ net::HostResolver* CreateGlobalHostResolver(net::NetLog* net_log) {
       net::CreateSystemHostResolver(parallelism, retry_attempts, net_log);
   }
 
+  // Serve stale cache entries, such as those restored from the last session,
+  // while they are refreshed.
+  if (command_line.HasSwitch(switches::kHostResolverMaxStaleness)) {
+    std::string s =
+        command_line.GetSwitchValueASCII(switches::kHostResolverMaxStaleness);
+    int n;
+    if (base::StringToInt(s, &n) && n >= 0) {
+      global_host_resolver->SetMaxCacheStaleness(
+          base::TimeDelta::FromSeconds(n));
+    } else {
+      LOG(ERROR) << "Invalid switch for host resolver max staleness: " << s;
+    }
+  }
+
   // Determine if we should disable IPv6 support.
   if (!command_line.HasSwitch(switches::kEnableIPv6)) {
     if (command_line.HasSwitch(switches::kDisableIPv6)) {
@@ -15,6 +15,7 @@
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/oom_priority_manager.h"
 #include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_widget_host.h"
 #include "content/public/browser/zygote_host_linux.h"
 
 #if !defined(OS_CHROMEOS)
@@ -90,10 +91,12 @@ class LowMemoryObserverImpl
       owner_->ScheduleNextObservation();
     }
 
-    // Sends off a discard request to the OomPriorityManager.  Must be run on
-    // the UI thread.
+    // Drops the backing stores, which are cheap to repaint, and sends off a
+    // discard request to the OomPriorityManager.  Must be run on the UI
+    // thread.
     static void DiscardTab() {
       CHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+      content::RenderWidgetHost::RemoveAllBackingStores();
       if (g_browser_process && g_browser_process->oom_priority_manager())
         g_browser_process->oom_priority_manager()->LogMemoryAndDiscardTab();
     }
@@ -30,6 +30,32 @@ const size_t kMaxInitialLogsPersisted = 20;
 // ongoing_log_ at startup).
 const size_t kMaxOngoingLogsPersisted = 8;
 
+// The number of bytes of compressed logs of each type we're willing to save
+// in Local State, on top of the most recent log, which is always saved. Local
+// State is rewritten as a whole, so a backlog of large logs makes every write
+// of it slower.
+const size_t kMaxLogBytesPersisted = 300 * 1024;
+
+// Returns how many of the most recent |logs| fit in |max_count| logs and,
+// apart from the most recent one, in |kMaxLogBytesPersisted| bytes. The XML
+// and protobuf versions of a log are counted together, since they are kept in
+// step.
+size_t CountLogsToPersist(
+    const std::vector<MetricsLogManager::SerializedLog>& logs,
+    size_t max_count) {
+  size_t count = 0;
+  size_t bytes = 0;
+  for (std::vector<MetricsLogManager::SerializedLog>::const_reverse_iterator
+           it = logs.rbegin();
+       it != logs.rend() && count < max_count; ++it) {
+    bytes += it->xml.size() + it->proto.size();
+    if (count > 0 && bytes > kMaxLogBytesPersisted)
+      break;
+    ++count;
+  }
+  return count;
+}
+
 // We append (2) more elements to persisted lists: the size of the list and a
 // checksum of the elements.
 const size_t kChecksumEntryCount = 2;
@@ -91,6 +117,7 @@ void MetricsLogSerializer::SerializeLogs(
       NOTREACHED();
       return;
   };
+  max_store_count = CountLogsToPersist(logs, max_store_count);
 
   // Write the XML version.
   ListPrefUpdate update_xml(local_state, pref_xml);
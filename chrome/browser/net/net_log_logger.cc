@@ -42,6 +42,11 @@ void NetLogLogger::OnAddEntry(net::NetLog::EventType type,
                               const net::NetLog::Source& source,
                               net::NetLog::EventPhase phase,
                               net::NetLog::EventParameters* params) {
+  // Without a file, the entries only go to the verbose log, so don't build
+  // them when nothing would print them.
+  if (!file_.get() && !VLOG_IS_ON(1))
+    return;
+
   scoped_ptr<Value> value(
       net::NetLog::EntryToDictionaryValue(
           type, time, source, phase, params, false));
@@ -54,6 +59,7 @@ void NetLogLogger::OnAddEntry(net::NetLog::EventType type,
   if (!file_.get()) {
     VLOG(1) << json;
   } else {
-    fprintf(file_.get(), "%s,\n", json.c_str());
+    json.append(",\n");
+    fwrite(json.data(), 1, json.size(), file_.get());
   }
 }
@@ -31,6 +31,7 @@
 #include "content/public/browser/browser_thread.h"
 #include "net/base/address_list.h"
 #include "net/base/completion_callback.h"
+#include "net/base/host_cache.h"
 #include "net/base/host_port_pair.h"
 #include "net/base/host_resolver.h"
 #include "net/base/net_errors.h"
@@ -157,6 +158,8 @@ void Predictor::RegisterUserPrefs(PrefService* user_prefs) {
                                PrefService::UNSYNCABLE_PREF);
   user_prefs->RegisterListPref(prefs::kDnsPrefetchingHostReferralList,
                                PrefService::UNSYNCABLE_PREF);
+  user_prefs->RegisterListPref(prefs::kDnsPrefetchingHostCache,
+                               PrefService::UNSYNCABLE_PREF);
 }
 
 // --------------------- Start UI methods. ------------------------------------
@@ -178,6 +181,9 @@ void Predictor::InitNetworkPredictor(PrefService* user_prefs,
   base::ListValue* referral_list =
       static_cast<base::ListValue*>(user_prefs->GetList(
           prefs::kDnsPrefetchingHostReferralList)->DeepCopy());
+  base::ListValue* host_cache_list =
+      static_cast<base::ListValue*>(user_prefs->GetList(
+          prefs::kDnsPrefetchingHostCache)->DeepCopy());
 
   BrowserThread::PostTask(
       BrowserThread::IO,
@@ -185,7 +191,7 @@ void Predictor::InitNetworkPredictor(PrefService* user_prefs,
       base::Bind(
           &Predictor::FinalizeInitializationOnIOThread,
           base::Unretained(this),
-          urls, referral_list,
+          urls, referral_list, host_cache_list,
           io_thread, predictor_enabled));
 }
 
@@ -641,6 +647,14 @@ void Predictor::DeserializeReferrersThenDelete(
   delete referral_list;
 }
 
+void Predictor::RestoreHostCacheThenDelete(base::ListValue* host_cache_list) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  net::HostCache* host_cache = host_resolver_->GetHostCache();
+  if (host_cache)
+    host_cache->Deserialize(*host_cache_list, base::TimeTicks::Now());
+  delete host_cache_list;
+}
+
 void Predictor::DiscardInitialNavigationHistory() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   if (initial_observer_.get())
@@ -650,6 +664,7 @@ void Predictor::DiscardInitialNavigationHistory() {
 void Predictor::FinalizeInitializationOnIOThread(
     const UrlList& startup_urls,
     base::ListValue* referral_list,
+    base::ListValue* host_cache_list,
     IOThread* io_thread,
     bool predictor_enabled) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
@@ -665,6 +680,10 @@ void Predictor::FinalizeInitializationOnIOThread(
   // TODO(groby): Check if WeakPtrFactory has the same constraint.
   weak_factory_.reset(new base::WeakPtrFactory<Predictor>(this));
 
+  // Restore the last session's resolutions first, so that the startup
+  // prefetches below can be answered from the cache.
+  RestoreHostCacheThenDelete(host_cache_list);
+
   // Prefetch these hostnames on startup.
   DnsPrefetchMotivatedList(startup_urls, UrlInfo::STARTUP_LIST_MOTIVATED);
   DeserializeReferrersThenDelete(referral_list);
@@ -728,6 +747,7 @@ void Predictor::DnsPrefetchMotivatedList(
 static void SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread(
     base::ListValue* startup_list,
     base::ListValue* referral_list,
+    base::ListValue* host_cache_list,
     base::WaitableEvent* completion,
     Predictor* predictor) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
@@ -737,7 +757,7 @@ static void SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread(
     return;
   }
   predictor->SaveDnsPrefetchStateForNextStartupAndTrim(
-      startup_list, referral_list, completion);
+      startup_list, referral_list, host_cache_list, completion);
 }
 
 void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
@@ -749,10 +769,13 @@ void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
   ListPrefUpdate update_startup_list(prefs, prefs::kDnsPrefetchingStartupList);
   ListPrefUpdate update_referral_list(prefs,
                                       prefs::kDnsPrefetchingHostReferralList);
+  ListPrefUpdate update_host_cache_list(prefs,
+                                        prefs::kDnsPrefetchingHostCache);
   if (BrowserThread::CurrentlyOn(BrowserThread::IO)) {
     SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread(
         update_startup_list.Get(),
         update_referral_list.Get(),
+        update_host_cache_list.Get(),
         &completion,
         this);
   } else {
@@ -763,6 +786,7 @@ void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
             &SaveDnsPrefetchStateForNextStartupAndTrimOnIOThread,
             update_startup_list.Get(),
             update_referral_list.Get(),
+            update_host_cache_list.Get(),
             &completion,
             this));
 
@@ -780,6 +804,7 @@ void Predictor::SaveStateForNextStartupAndTrim(PrefService* prefs) {
 void Predictor::SaveDnsPrefetchStateForNextStartupAndTrim(
     base::ListValue* startup_list,
     base::ListValue* referral_list,
+    base::ListValue* host_cache_list,
     base::WaitableEvent* completion) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
   if (initial_observer_.get())
@@ -790,6 +815,11 @@ void Predictor::SaveDnsPrefetchStateForNextStartupAndTrim(
   TrimReferrersNow();
   SerializeReferrers(referral_list);
 
+  net::HostCache* host_cache =
+      host_resolver_ ? host_resolver_->GetHostCache() : NULL;
+  if (host_cache)
+    host_cache->Serialize(base::TimeTicks::Now(), host_cache_list);
+
   completion->Signal();
 }
 
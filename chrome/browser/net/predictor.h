@@ -185,9 +185,15 @@ class Predictor {
 
   void DiscardInitialNavigationHistory();
 
+  // Adds the entries of a host cache snapshot, as saved by
+  // SaveDnsPrefetchStateForNextStartupAndTrim(), to the resolver's cache,
+  // then deletes |host_cache_list|.
+  void RestoreHostCacheThenDelete(base::ListValue* host_cache_list);
+
   void FinalizeInitializationOnIOThread(
       const std::vector<GURL>& urls_to_prefetch,
       base::ListValue* referral_list,
+      base::ListValue* host_cache_list,
       IOThread* io_thread,
       bool predictor_enabled);
 
@@ -211,6 +217,7 @@ class Predictor {
   void SaveDnsPrefetchStateForNextStartupAndTrim(
       base::ListValue* startup_list,
       base::ListValue* referral_list,
+      base::ListValue* host_cache_list,
       base::WaitableEvent* completion);
 
   // May be called from either the IO or UI thread and will PostTask
@@ -34,6 +34,11 @@
 using base::Time;
 using content::BrowserThread;
 
+// Commit every 30 seconds.
+static const int kDefaultCommitIntervalMs = 30 * 1000;
+// Commit right away if we have more than 512 outstanding operations.
+static const size_t kDefaultCommitBatchSize = 512;
+
 // This class is designed to be shared between any calling threads and the
 // database thread. It batches operations and commits them on a timer.
 //
@@ -55,7 +60,9 @@ using content::BrowserThread;
 // Subsequent to loading, mutations may be queued by any thread using
 // AddCookie, UpdateCookieAccessTime, and DeleteCookie. These are flushed to
 // disk on the DB thread every 30 seconds, 512 operations, or call to Flush(),
-// whichever occurs first.
+// whichever occurs first; SetCommitPolicy() changes the first two limits.
+// Operations that a later one makes redundant are dropped from the batch
+// before they reach the database.
 class SQLitePersistentCookieStore::Backend
     : public base::RefCountedThreadSafe<SQLitePersistentCookieStore::Backend> {
  public:
@@ -63,6 +70,9 @@ class SQLitePersistentCookieStore::Backend
       : path_(path),
         db_(NULL),
         num_pending_(0),
+        commit_interval_(
+            base::TimeDelta::FromMilliseconds(kDefaultCommitIntervalMs)),
+        commit_batch_size_(kDefaultCommitBatchSize),
         clear_local_state_on_exit_(false),
         initialized_(false),
         restore_old_session_cookies_(restore_old_session_cookies),
@@ -96,6 +106,8 @@ class SQLitePersistentCookieStore::Backend
 
   void SetClearLocalStateOnExit(bool clear_local_state);
 
+  void SetCommitPolicy(const base::TimeDelta& interval, size_t batch_size);
+
  private:
   friend class base::RefCountedThreadSafe<SQLitePersistentCookieStore::Backend>;
 
@@ -122,6 +134,9 @@ class SQLitePersistentCookieStore::Backend
 
     OperationType op() const { return op_; }
     const net::CookieMonster::CanonicalCookie& cc() const { return cc_; }
+    void set_last_access_date(const base::Time& date) {
+      cc_.SetLastAccessDate(date);
+    }
 
    private:
     OperationType op_;
@@ -176,6 +191,11 @@ class SQLitePersistentCookieStore::Backend
   // Batch a cookie operation (add or delete)
   void BatchOperation(PendingOperation::OperationType op,
                       const net::CookieMonster::CanonicalCookie& cc);
+  // Folds |op| for |cc| into the pending operation for the same cookie, if
+  // there is one that makes this possible. Returns true if it did, in which
+  // case |op| need not be queued. Called with |lock_| held.
+  bool CoalesceOperation(PendingOperation::OperationType op,
+                         const net::CookieMonster::CanonicalCookie& cc);
   // Commit our pending operations to the database.
   void Commit();
   // Close() executed on the background thread.
@@ -190,9 +210,18 @@ class SQLitePersistentCookieStore::Backend
   typedef std::list<PendingOperation*> PendingOperationsList;
   PendingOperationsList pending_;
   PendingOperationsList::size_type num_pending_;
+  // The last add or access time update in |pending_| for each cookie, keyed
+  // by creation time, which the database uses as the cookie's identity.
+  typedef std::map<int64, PendingOperationsList::iterator> PendingCookieMap;
+  PendingCookieMap pending_by_cookie_;
+  // How long the first operation of a batch may wait to be committed, and
+  // how many operations trigger a commit at once.
+  base::TimeDelta commit_interval_;
+  size_t commit_batch_size_;
   // True if the persistent store should be deleted upon destruction.
   bool clear_local_state_on_exit_;
-  // Guard |cookies_|, |pending_|, |num_pending_|, |clear_local_state_on_exit_|
+  // Guard |cookies_|, |pending_|, |num_pending_|, |pending_by_cookie_|,
+  // |commit_interval_|, |commit_batch_size_|, |clear_local_state_on_exit_|
   base::Lock lock_;
 
   // Temporary buffer for cookies loaded from DB. Accumulates cookies to reduce
@@ -479,6 +508,7 @@ bool SQLitePersistentCookieStore::Backend::InitializeDatabase() {
   }
 
   db_.reset(new sql::Connection);
+  db_->set_write_ahead_log();
   if (!db_->Open(path_)) {
     NOTREACHED() << "Unable to open cookie DB.";
     db_.reset();
@@ -721,6 +751,7 @@ bool SQLitePersistentCookieStore::Backend::EnsureDatabaseVersion() {
 
     meta_table_.Reset();
     db_.reset(new sql::Connection);
+    db_->set_write_ahead_log();
     if (!file_util::Delete(path_, false) ||
         !db_->Open(path_) ||
         !meta_table_.Init(
@@ -754,20 +785,24 @@ void SQLitePersistentCookieStore::Backend::DeleteCookie(
 void SQLitePersistentCookieStore::Backend::BatchOperation(
     PendingOperation::OperationType op,
     const net::CookieMonster::CanonicalCookie& cc) {
-  // Commit every 30 seconds.
-  static const int kCommitIntervalMs = 30 * 1000;
-  // Commit right away if we have more than 512 outstanding operations.
-  static const size_t kCommitAfterBatchSize = 512;
   DCHECK(!BrowserThread::CurrentlyOn(BrowserThread::DB));
 
-  // We do a full copy of the cookie here, and hopefully just here.
-  scoped_ptr<PendingOperation> po(new PendingOperation(op, cc));
-
   PendingOperationsList::size_type num_pending;
+  base::TimeDelta commit_interval;
+  size_t commit_batch_size;
   {
     base::AutoLock locked(lock_);
-    pending_.push_back(po.release());
+    if (CoalesceOperation(op, cc))
+      return;
+    // We do a full copy of the cookie here, and hopefully just here.
+    pending_.push_back(new PendingOperation(op, cc));
+    if (op != PendingOperation::COOKIE_DELETE) {
+      pending_by_cookie_[cc.CreationDate().ToInternalValue()] =
+          --pending_.end();
+    }
     num_pending = ++num_pending_;
+    commit_interval = commit_interval_;
+    commit_batch_size = commit_batch_size_;
   }
 
   if (num_pending == 1) {
@@ -775,8 +810,9 @@ void SQLitePersistentCookieStore::Backend::BatchOperation(
     BrowserThread::PostDelayedTask(
         BrowserThread::DB, FROM_HERE,
         base::Bind(&Backend::Commit, this),
-        base::TimeDelta::FromMilliseconds(kCommitIntervalMs));
-  } else if (num_pending == kCommitAfterBatchSize) {
+        commit_interval);
+  }
+  if (num_pending == commit_batch_size) {
     // We've reached a big enough batch, fire off a commit now.
     BrowserThread::PostTask(
         BrowserThread::DB, FROM_HERE,
@@ -784,6 +820,36 @@ void SQLitePersistentCookieStore::Backend::BatchOperation(
   }
 }
 
+bool SQLitePersistentCookieStore::Backend::CoalesceOperation(
+    PendingOperation::OperationType op,
+    const net::CookieMonster::CanonicalCookie& cc) {
+  lock_.AssertAcquired();
+  if (op == PendingOperation::COOKIE_ADD)
+    return false;
+  PendingCookieMap::iterator it =
+      pending_by_cookie_.find(cc.CreationDate().ToInternalValue());
+  if (it == pending_by_cookie_.end())
+    return false;
+  PendingOperation* pending = *it->second;
+
+  if (op == PendingOperation::COOKIE_UPDATEACCESS) {
+    // Only the latest access time matters.
+    pending->set_last_access_date(cc.LastAccessDate());
+    return true;
+  }
+
+  DCHECK_EQ(PendingOperation::COOKIE_DELETE, op);
+  // Whatever was pending for the cookie is moot once it is deleted. A
+  // cookie that was never written to the database need not be deleted
+  // from it either.
+  bool was_add = pending->op() == PendingOperation::COOKIE_ADD;
+  delete pending;
+  pending_.erase(it->second);
+  pending_by_cookie_.erase(it);
+  --num_pending_;
+  return was_add;
+}
+
 void SQLitePersistentCookieStore::Backend::Commit() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::DB));
 
@@ -791,6 +857,7 @@ void SQLitePersistentCookieStore::Backend::Commit() {
   {
     base::AutoLock locked(lock_);
     pending_.swap(ops);
+    pending_by_cookie_.clear();
     num_pending_ = 0;
   }
 
@@ -913,6 +980,14 @@ void SQLitePersistentCookieStore::Backend::SetClearLocalStateOnExit(
   clear_local_state_on_exit_ = clear_local_state;
 }
 
+void SQLitePersistentCookieStore::Backend::SetCommitPolicy(
+    const base::TimeDelta& interval, size_t batch_size) {
+  DCHECK_GT(batch_size, 0u);
+  base::AutoLock locked(lock_);
+  commit_interval_ = interval;
+  commit_batch_size_ = batch_size;
+}
+
 void SQLitePersistentCookieStore::Backend::DeleteSessionCookies() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::DB));
   if (!db_->Execute("DELETE FROM cookies WHERE persistent == 0"))
@@ -959,6 +1034,12 @@ void SQLitePersistentCookieStore::SetClearLocalStateOnExit(
     backend_->SetClearLocalStateOnExit(clear_local_state);
 }
 
+void SQLitePersistentCookieStore::SetCommitPolicy(
+    const base::TimeDelta& interval, size_t batch_size) {
+  if (backend_.get())
+    backend_->SetCommitPolicy(interval, batch_size);
+}
+
 void SQLitePersistentCookieStore::Flush(const base::Closure& callback) {
   if (backend_.get())
     backend_->Flush(callback);
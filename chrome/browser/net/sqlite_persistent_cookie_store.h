@@ -19,6 +19,10 @@
 class FilePath;
 class Task;
 
+namespace base {
+class TimeDelta;
+}
+
 // Implements the PersistentCookieStore interface in terms of a SQLite database.
 // For documentation about the actual member functions consult the documentation
 // of the parent class |net::CookieMonster::PersistentCookieStore|.
@@ -41,6 +45,11 @@ class SQLitePersistentCookieStore
   virtual void SetClearLocalStateOnExit(bool clear_local_state) OVERRIDE;
   virtual void Flush(const base::Closure& callback) OVERRIDE;
 
+  // Pending changes are committed once the first of them has waited
+  // |interval|, or once there are |batch_size| of them, whichever comes
+  // first. The defaults are 30 seconds and 512 operations.
+  void SetCommitPolicy(const base::TimeDelta& interval, size_t batch_size);
+
  protected:
    virtual ~SQLitePersistentCookieStore();
 
@@ -6,6 +6,7 @@
 #include "base/message_loop.h"
 #include "base/perftimer.h"
 #include "base/scoped_temp_dir.h"
+#include "base/stl_util.h"
 #include "base/stringprintf.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/test/thread_test_helper.h"
@@ -38,6 +39,13 @@ class SQLitePersistentCookieStorePerfTest : public testing::Test {
     key_loaded_event_.Signal();
   }
 
+  void WaitForDBThread() {
+    scoped_refptr<base::ThreadTestHelper> helper(
+      new base::ThreadTestHelper(
+        BrowserThread::GetMessageLoopProxyForThread(BrowserThread::DB)));
+    ASSERT_TRUE(helper->Run());
+  }
+
   void Load() {
     store_->Load(base::Bind(&SQLitePersistentCookieStorePerfTest::OnLoaded,
                                 base::Unretained(this)));
@@ -49,7 +57,7 @@ class SQLitePersistentCookieStorePerfTest : public testing::Test {
     io_thread_.Start();
     ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
     store_ = new SQLitePersistentCookieStore(
-      temp_dir_.path().Append(chrome::kCookieFilename));
+      temp_dir_.path().Append(chrome::kCookieFilename), false);
     std::vector<net::CookieMonster::CanonicalCookie*> cookies;
     Load();
     ASSERT_EQ(0u, cookies_.size());
@@ -64,7 +72,7 @@ class SQLitePersistentCookieStorePerfTest : public testing::Test {
           net::CookieMonster::CanonicalCookie(gurl,
             base::StringPrintf("Cookie_%d", cookie_num), "1",
             domain_name, "/", std::string(), std::string(),
-            t, t, t, false, false, true));
+            t, t, t, false, false, true, true));
       }
     }
     // Replace the store effectively destroying the current one and forcing it
@@ -77,7 +85,7 @@ class SQLitePersistentCookieStorePerfTest : public testing::Test {
     ASSERT_TRUE(helper->Run());
 
     store_ = new SQLitePersistentCookieStore(
-      temp_dir_.path().Append(chrome::kCookieFilename));
+      temp_dir_.path().Append(chrome::kCookieFilename), false);
   }
 
  protected:
@@ -114,3 +122,26 @@ TEST_F(SQLitePersistentCookieStorePerfTest, TestLoadPerformance) {
 
   ASSERT_EQ(15000U, cookies_.size());
 }
+
+// Test the performance of committing access time updates, several per cookie,
+// the way a session that keeps revisiting the same sites produces them.
+TEST_F(SQLitePersistentCookieStorePerfTest, TestCommitAccessTimeUpdates) {
+  Load();
+  ASSERT_EQ(15000U, cookies_.size());
+  store_->SetCommitPolicy(base::TimeDelta::FromDays(1), 100000);
+
+  PerfTimeLogger timer("Commit access time updates");
+  base::Time t = base::Time::Now();
+  for (int pass = 0; pass < 4; ++pass) {
+    t += base::TimeDelta::FromMinutes(1);
+    for (size_t i = 0; i < cookies_.size(); ++i) {
+      cookies_[i]->SetLastAccessDate(t);
+      store_->UpdateCookieAccessTime(*cookies_[i]);
+    }
+  }
+  store_->Flush(base::Closure());
+  WaitForDBThread();
+  timer.Done();
+
+  STLDeleteElements(&cookies_);
+}
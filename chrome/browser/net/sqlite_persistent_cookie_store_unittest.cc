@@ -208,6 +208,69 @@ TEST_F(SQLitePersistentCookieStoreTest, TestPersistance) {
   ASSERT_EQ(0U, cookies.size());
 }
 
+// Test that operations made redundant by later ones in the same batch still
+// leave the database as if they had all been applied.
+TEST_F(SQLitePersistentCookieStoreTest, TestCoalescedOperations) {
+  InitializeStore(false);
+  base::Time t = base::Time::Now();
+  net::CookieMonster::CanonicalCookie a(
+      GURL(), "A", "B", "http://foo.bar", "/", std::string(), std::string(),
+      t, t, t, false, false, true, true);
+  t += base::TimeDelta::FromInternalValue(10);
+  net::CookieMonster::CanonicalCookie c(
+      GURL(), "C", "D", "http://foo.bar", "/", std::string(), std::string(),
+      t, t, t, false, false, true, true);
+  store_->AddCookie(a);
+  store_->AddCookie(c);
+  base::Time last_access = t + base::TimeDelta::FromMinutes(1);
+  a.SetLastAccessDate(last_access);
+  store_->UpdateCookieAccessTime(a);
+  store_->DeleteCookie(c);
+  DestroyStore();
+
+  std::vector<net::CookieMonster::CanonicalCookie*> cookies;
+  CreateAndLoad(false, &cookies);
+  ASSERT_EQ(1U, cookies.size());
+  EXPECT_EQ("A", cookies[0]->Name());
+  EXPECT_EQ(last_access, cookies[0]->LastAccessDate());
+
+  // An access time update followed by a deletion of a stored cookie still
+  // deletes it.
+  cookies[0]->SetLastAccessDate(last_access + base::TimeDelta::FromMinutes(1));
+  store_->UpdateCookieAccessTime(*cookies[0]);
+  store_->DeleteCookie(*cookies[0]);
+  DestroyStore();
+  STLDeleteContainerPointers(cookies.begin(), cookies.end());
+  cookies.clear();
+
+  CreateAndLoad(false, &cookies);
+  ASSERT_EQ(0U, cookies.size());
+}
+
+// Test that a batch is committed as soon as it reaches the configured size.
+TEST_F(SQLitePersistentCookieStoreTest, TestCommitBatchSize) {
+  InitializeStore(false);
+  store_->SetCommitPolicy(base::TimeDelta::FromDays(1), 2);
+  FilePath path = temp_dir_.path().Append(chrome::kCookieFilename);
+  base::PlatformFileInfo info;
+  ASSERT_TRUE(file_util::GetFileInfo(path, &info));
+  int64 base_size = info.size;
+
+  base::Time t = base::Time::Now();
+  AddCookie("A", std::string(5000, 'a'), "http://foo.bar", "/", t);
+  t += base::TimeDelta::FromInternalValue(10);
+  AddCookie("B", std::string(5000, 'b'), "http://foo.bar", "/", t);
+
+  // Wait until the DB thread is idle; no Flush() is needed.
+  scoped_refptr<base::ThreadTestHelper> helper(
+      new base::ThreadTestHelper(
+          BrowserThread::GetMessageLoopProxyForThread(BrowserThread::DB)));
+  ASSERT_TRUE(helper->Run());
+
+  ASSERT_TRUE(file_util::GetFileInfo(path, &info));
+  ASSERT_GT(info.size, base_size);
+}
+
 // Test that priority load of cookies for a specfic domain key could be
 // completed before the entire store is loaded
 TEST_F(SQLitePersistentCookieStoreTest, TestLoadCookiesForKey) {
@@ -91,15 +91,17 @@ void PrefNotifierImpl::OnInitializationCompleted(bool succeeded) {
 void PrefNotifierImpl::FireObservers(const std::string& path) {
   DCHECK(CalledOnValidThread());
 
-  // Only send notifications for registered preferences.
-  if (!pref_service_->FindPreference(path.c_str()))
-    return;
-
+  // Most preferences have no observers, so look for them before the more
+  // expensive preference lookup.
   const PrefObserverMap::iterator observer_iterator =
       pref_observers_.find(path);
   if (observer_iterator == pref_observers_.end())
     return;
 
+  // Only send notifications for registered preferences.
+  if (!pref_service_->FindPreference(path.c_str()))
+    return;
+
   NotificationObserverList::Iterator it(*(observer_iterator->second));
   content::NotificationObserver* observer;
   while ((observer = it.GetNext()) != NULL) {
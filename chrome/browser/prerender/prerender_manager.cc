@@ -925,15 +925,19 @@ bool PrerenderManager::AddPrerender(
 
   last_prerender_start_time_ = GetCurrentTimeTicks();
 
+  // Evict the oldest prerenders before starting this one, so that the
+  // renderers over the limit are torn down rather than competing with the
+  // new one for memory and CPU while it starts.
+  while (prerender_list_.size() > config_.max_elements) {
+    PrerenderContents* evicted_contents = prerender_list_.front().contents_;
+    prerender_list_.pop_front();
+    evicted_contents->Destroy(FINAL_STATUS_EVICTED);
+  }
+
   if (!IsControlGroup()) {
     data.contents_->StartPrerendering(source_render_view_host,
                                       session_storage_namespace);
   }
-  while (prerender_list_.size() > config_.max_elements) {
-    data = prerender_list_.front();
-    prerender_list_.pop_front();
-    data.contents_->Destroy(FINAL_STATUS_EVICTED);
-  }
   StartSchedulingPeriodicCleanups();
   return true;
 }
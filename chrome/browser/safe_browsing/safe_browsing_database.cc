@@ -229,6 +229,35 @@ bool SBAddFullHashPrefixLess(const SBAddFullHash& a, const SBAddFullHash& b) {
   return a.full_hash.prefix < b.full_hash.prefix;
 }
 
+// Removes one copy of each item of |removed| from |hashes|.  Both must be
+// sorted by prefix, and |hashes| must contain all of |removed|.
+void RemoveAddFullHashes(const std::vector<SBAddFullHash>& removed,
+                         std::vector<SBAddFullHash>* hashes) {
+  std::vector<bool> matched(removed.size(), false);
+  std::vector<SBAddFullHash> kept;
+  for (std::vector<SBAddFullHash>::const_iterator iter = hashes->begin();
+       iter != hashes->end(); ++iter) {
+    std::pair<std::vector<SBAddFullHash>::const_iterator,
+              std::vector<SBAddFullHash>::const_iterator> range =
+        std::equal_range(removed.begin(), removed.end(), *iter,
+                         SBAddFullHashPrefixLess);
+    bool found = false;
+    for (std::vector<SBAddFullHash>::const_iterator match = range.first;
+         match != range.second && !found; ++match) {
+      const size_t index = match - removed.begin();
+      if (!matched[index] && match->chunk_id == iter->chunk_id &&
+          match->received == iter->received &&
+          match->full_hash == iter->full_hash) {
+        matched[index] = true;
+        found = true;
+      }
+    }
+    if (!found)
+      kept.push_back(*iter);
+  }
+  hashes->swap(kept);
+}
+
 // As compared to the bloom filter, PrefixSet should have these
 // properties:
 // - Any bloom filter miss should be a prefix set miss.
@@ -1284,12 +1313,10 @@ void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
     base::AutoLock locked(lookup_lock_);
     full_browse_hashes_.swap(add_full_hashes);
 
-    // TODO(shess): If |CacheHashResults()| is posted between the
-    // earlier lock and this clear, those pending hashes will be lost.
-    // It could be fixed by only removing hashes which were collected
-    // at the earlier point.  I believe that is fail-safe as-is (the
-    // hash will be fetched again).
-    pending_browse_hashes_.clear();
+    // Only the pending hashes which went into the update are now in
+    // |full_browse_hashes_|.  Those cached by |CacheHashResults()|
+    // since they were copied out are kept for the next update.
+    RemoveAddFullHashes(pending_add_hashes, &pending_browse_hashes_);
     prefix_miss_cache_.clear();
     browse_bloom_filter_.swap(filter);
     prefix_set_.swap(prefix_set);
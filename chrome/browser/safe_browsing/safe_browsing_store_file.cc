@@ -4,6 +4,8 @@
 
 #include "chrome/browser/safe_browsing/safe_browsing_store_file.h"
 
+#include <algorithm>
+
 #include "base/md5.h"
 #include "base/metrics/histogram.h"
 
@@ -22,6 +24,11 @@ struct FileHeader {
   uint32 add_hash_count, sub_hash_count;
 };
 
+// Reading, writing and checksumming the items one at a time is slow for
+// the large lists of prefixes and hashes, so they go through a buffer of
+// about this many bytes instead.
+const size_t kIOBufferSize = 64 * 1024;
+
 // Header for each chunk in the chunk-accumulation file.
 struct ChunkHeader {
   uint32 add_prefix_count, sub_prefix_count;
@@ -48,55 +55,77 @@ bool FileSkip(size_t bytes, FILE* fp) {
   return rv == 0;
 }
 
-// Read from |fp| into |item|, and fold the input data into the
-// checksum in |context|, if non-NULL.  Return true on success.
+// Read |count| items from |fp| into |items|, and fold the input data
+// into the checksum in |context|, if non-NULL.  Return true on success.
 template <class T>
-bool ReadItem(T* item, FILE* fp, base::MD5Context* context) {
-  const size_t ret = fread(item, sizeof(T), 1, fp);
-  if (ret != 1)
+bool ReadArray(T* items, size_t count, FILE* fp, base::MD5Context* context) {
+  const size_t ret = fread(items, sizeof(T), count, fp);
+  if (ret != count)
     return false;
 
   if (context) {
     base::MD5Update(context,
-                    base::StringPiece(reinterpret_cast<char*>(item),
-                                      sizeof(T)));
+                    base::StringPiece(reinterpret_cast<char*>(items),
+                                      sizeof(T) * count));
   }
   return true;
 }
 
-// Write |item| to |fp|, and fold the output data into the checksum in
-// |context|, if non-NULL.  Return true on success.
+// Write |count| items from |items| to |fp|, and fold the output data
+// into the checksum in |context|, if non-NULL.  Return true on success.
 template <class T>
-bool WriteItem(const T& item, FILE* fp, base::MD5Context* context) {
-  const size_t ret = fwrite(&item, sizeof(T), 1, fp);
-  if (ret != 1)
+bool WriteArray(const T* items, size_t count, FILE* fp,
+                base::MD5Context* context) {
+  const size_t ret = fwrite(items, sizeof(T), count, fp);
+  if (ret != count)
     return false;
 
   if (context) {
     base::MD5Update(context,
-                    base::StringPiece(reinterpret_cast<const char*>(&item),
-                                      sizeof(T)));
+                    base::StringPiece(reinterpret_cast<const char*>(items),
+                                      sizeof(T) * count));
   }
 
   return true;
 }
 
+// Read from |fp| into |item|, and fold the input data into the
+// checksum in |context|, if non-NULL.  Return true on success.
+template <class T>
+bool ReadItem(T* item, FILE* fp, base::MD5Context* context) {
+  return ReadArray(item, 1, fp, context);
+}
+
+// Write |item| to |fp|, and fold the output data into the checksum in
+// |context|, if non-NULL.  Return true on success.
+template <class T>
+bool WriteItem(const T& item, FILE* fp, base::MD5Context* context) {
+  return WriteArray(&item, 1, fp, context);
+}
+
+// Returns how many items of type |T| are read or written at once.
+template <class T>
+size_t ItemsPerBuffer() {
+  return std::max(kIOBufferSize / sizeof(T), static_cast<size_t>(1));
+}
+
 // Read |count| items into |values| from |fp|, and fold them into the
 // checksum in |context|.  Returns true on success.
 template <typename CT>
 bool ReadToContainer(CT* values, size_t count, FILE* fp,
                      base::MD5Context* context) {
-  if (!count)
-    return true;
-
-  for (size_t i = 0; i < count; ++i) {
-    typename CT::value_type value;
-    if (!ReadItem(&value, fp, context))
+  typedef typename CT::value_type T;
+  std::vector<T> buffer;
+  while (count) {
+    buffer.resize(std::min(count, ItemsPerBuffer<T>()));
+    if (!ReadArray(&buffer[0], buffer.size(), fp, context))
       return false;
 
     // push_back() is more obvious, but coded this way std::set can
     // also be read.
-    values->insert(values->end(), value);
+    for (size_t i = 0; i < buffer.size(); ++i)
+      values->insert(values->end(), buffer[i]);
+    count -= buffer.size();
   }
 
   return true;
@@ -107,15 +136,21 @@ bool ReadToContainer(CT* values, size_t count, FILE* fp,
 template <typename CT>
 bool WriteContainer(const CT& values, FILE* fp,
                     base::MD5Context* context) {
-  if (values.empty())
-    return true;
-
+  typedef typename CT::value_type T;
+  const size_t items_per_buffer = ItemsPerBuffer<T>();
+  std::vector<T> buffer;
   for (typename CT::const_iterator iter = values.begin();
        iter != values.end(); ++iter) {
-    if (!WriteItem(*iter, fp, context))
-      return false;
+    buffer.push_back(*iter);
+    if (buffer.size() == items_per_buffer) {
+      if (!WriteArray(&buffer[0], buffer.size(), fp, context))
+        return false;
+      buffer.clear();
+    }
   }
-  return true;
+  if (buffer.empty())
+    return true;
+  return WriteArray(&buffer[0], buffer.size(), fp, context);
 }
 
 // Delete the chunks in |deleted| from |chunks|.
@@ -309,36 +309,37 @@ bool SessionBackend::ReadCurrentSessionCommandsImpl(
 
 bool SessionBackend::AppendCommandsToFile(net::FileStream* file,
     const std::vector<SessionCommand*>& commands) {
+  // The commands are laid out in memory first so that they are written with
+  // one call rather than three per command.
+  size_t buffer_size = 0;
+  for (std::vector<SessionCommand*>::const_iterator i = commands.begin();
+       i != commands.end(); ++i) {
+    buffer_size += sizeof(size_type) + sizeof(id_type) + (*i)->size();
+  }
+  std::string buffer;
+  buffer.reserve(buffer_size);
   for (std::vector<SessionCommand*>::const_iterator i = commands.begin();
        i != commands.end(); ++i) {
-    int wrote;
     const size_type content_size = static_cast<size_type>((*i)->size());
     const size_type total_size =  content_size + sizeof(id_type);
     if (type_ == BaseSessionService::TAB_RESTORE)
       UMA_HISTOGRAM_COUNTS("TabRestore.command_size", total_size);
     else
       UMA_HISTOGRAM_COUNTS("SessionRestore.command_size", total_size);
-    wrote = file->WriteSync(reinterpret_cast<const char*>(&total_size),
-                            sizeof(total_size));
-    if (wrote != sizeof(total_size)) {
-      NOTREACHED() << "error writing";
-      return false;
-    }
+    buffer.append(reinterpret_cast<const char*>(&total_size),
+                  sizeof(total_size));
     id_type command_id = (*i)->id();
-    wrote = file->WriteSync(reinterpret_cast<char*>(&command_id),
-                            sizeof(command_id));
-    if (wrote != sizeof(command_id)) {
+    buffer.append(reinterpret_cast<const char*>(&command_id),
+                  sizeof(command_id));
+    if (content_size > 0)
+      buffer.append((*i)->contents(), content_size);
+  }
+  if (!buffer.empty()) {
+    int wrote = file->WriteSync(buffer.data(), static_cast<int>(buffer.size()));
+    if (wrote != static_cast<int>(buffer.size())) {
       NOTREACHED() << "error writing";
       return false;
     }
-    if (content_size > 0) {
-      wrote = file->WriteSync(reinterpret_cast<char*>((*i)->contents()),
-                              content_size);
-      if (wrote != content_size) {
-        NOTREACHED() << "error writing";
-        return false;
-      }
-    }
   }
   file->Flush();
   return true;
@@ -66,11 +66,17 @@ std::set<SessionRestoreImpl*>* active_session_restorers = NULL;
 // Initial delay (see class decription for details).
 static const int kInitialDelayTimerMS = 100;
 
+// Number of tabs loading at once past which the delay no longer starts more
+// (see class decription for details).
+static const size_t kMaxParallelTabLoads = 4;
+
 // TabLoader is responsible for loading tabs after session restore creates
 // tabs. New tabs are loaded after the current tab finishes loading, or a delay
 // is reached (initially kInitialDelayTimerMS). If the delay is reached before
 // a tab finishes loading a new tab is loaded and the time of the delay
-// doubled.
+// doubled, unless kMaxParallelTabLoads tabs are loading already. Then the
+// next tab waits for one of them to finish, so that a slow network or
+// machine isn't swamped by the whole session at once.
 //
 // TabLoader keeps a reference to itself when it's loading. When it has finished
 // loading, it drops the reference. If another profile is restored while the
@@ -400,7 +406,8 @@ void TabLoader::RemoveTab(NavigationController* tab) {
 
 void TabLoader::ForceLoadTimerFired() {
   force_load_delay_ *= 2;
-  LoadNextTab();
+  if (tabs_loading_.size() < kMaxParallelTabLoads)
+    LoadNextTab();
 }
 
 RenderWidgetHost* TabLoader::GetRenderWidgetHost(NavigationController* tab) {
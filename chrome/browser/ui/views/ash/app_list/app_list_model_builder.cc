@@ -151,14 +151,21 @@ void AppListModelBuilder::InsertItemByTitle(ash::AppListItemModel* item) {
 
   l10n_util::StringComparator<string16> c(collator.get());
   ModelItemSortData data(item);
-  for (int i = special_items_count_; i < model_->item_count(); ++i) {
-    ModelItemSortData current(model_->GetItem(i));
-    if (!c(current.key, data.key)) {
-      model_->AddItemAt(i, item);
-      return;
-    }
+
+  // The items after the special ones are sorted by title, so binary search for
+  // the first one that doesn't sort before |item| rather than building the sort
+  // key of every app.
+  int begin = special_items_count_;
+  int end = model_->item_count();
+  while (begin < end) {
+    int middle = begin + (end - begin) / 2;
+    ModelItemSortData current(model_->GetItem(middle));
+    if (c(current.key, data.key))
+      begin = middle + 1;
+    else
+      end = middle;
   }
-  model_->AddItem(item);
+  model_->AddItemAt(begin, item);
 }
 
 void AppListModelBuilder::GetExtensionApps(const string16& query,
@@ -174,7 +181,7 @@ void AppListModelBuilder::GetExtensionApps(const string16& query,
        app != extensions->end(); ++app) {
     if ((*app)->ShouldDisplayInLauncher() &&
         !IsSpecialApp((*app)->id()) &&
-        MatchesQuery(query, UTF8ToUTF16((*app)->name()))) {
+        (query.empty() || MatchesQuery(query, UTF8ToUTF16((*app)->name())))) {
       items->push_back(new ExtensionAppItem(profile_, *app));
     }
   }
@@ -10,8 +10,7 @@
 #define CHROME_BROWSER_VISITEDLINK_VISITEDLINK_EVENT_LISTENER_H_
 #pragma once
 
-#include <map>
-
+#include "base/flat_hash_map.h"
 #include "base/memory/linked_ptr.h"
 #include "base/timer.h"
 #include "chrome/browser/visitedlink/visitedlink_master.h"
@@ -49,7 +48,7 @@ class VisitedLinkEventListener : public VisitedLinkMaster::Listener,
   content::NotificationRegistrar registrar_;
 
   // Map between renderer child ids and their VisitedLinkUpdater.
-  typedef std::map<int, linked_ptr<VisitedLinkUpdater> > Updaters;
+  typedef base::flat_hash_map<int, linked_ptr<VisitedLinkUpdater> > Updaters;
   Updaters updaters_;
 
   Profile* profile_;
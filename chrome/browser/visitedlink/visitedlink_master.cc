@@ -54,6 +54,13 @@ const size_t VisitedLinkMaster::kBigDeleteThreshold = 64;
 
 namespace {
 
+// Load limits for good performance/space. We are pretty conservative about
+// keeping the table not very full. This is because we use linear probing
+// which increases the likelihood of clumps of entries which will reduce
+// performance.
+const float kMaxTableLoad = 0.5f;  // Grow when we're > this full.
+const float kMinTableLoad = 0.2f;  // Shrink when we're < this full.
+
 // Fills the given salt structure with some quasi-random values
 // It is not necessary to generate a cryptographically strong random string,
 // only that it be reasonably different for different users.
@@ -260,16 +267,26 @@ void VisitedLinkMaster::AddURL(const GURL& url) {
 }
 
 void VisitedLinkMaster::AddURLs(const std::vector<GURL>& url) {
-  for (std::vector<GURL>::const_iterator i = url.begin();
-       i != url.end(); ++i) {
-    Hash index = TryToAddURL(*i);
-    if (!table_builder_ && index != null_hash_)
-      ResizeTableIfNecessary();
+  // Grow the table once for all the URLs rather than every time it fills up
+  // while they are added, since each resize sends a new table to every
+  // renderer and writes the whole file.
+  if (!table_builder_) {
+    int32 max_items = used_items_ + static_cast<int32>(url.size());
+    if (max_items > kMaxTableLoad * table_length_)
+      ResizeTable(NewTableSizeForCount(max_items));
   }
 
-  // Keeps the file on disk up-to-date.
-  if (!table_builder_)
+  for (std::vector<GURL>::const_iterator i = url.begin();
+       i != url.end(); ++i)
+    TryToAddURL(*i);
+
+  if (!table_builder_) {
+    // Some of the URLs may have been in the table already.
+    ResizeTableIfNecessary();
+
+    // Keeps the file on disk up-to-date.
     WriteFullTable();
+  }
 }
 
 void VisitedLinkMaster::DeleteAllURLs() {
@@ -687,23 +704,16 @@ void VisitedLinkMaster::FreeURLTable() {
 bool VisitedLinkMaster::ResizeTableIfNecessary() {
   DCHECK(table_length_ > 0) << "Must have a table";
 
-  // Load limits for good performance/space. We are pretty conservative about
-  // keeping the table not very full. This is because we use linear probing
-  // which increases the likelihood of clumps of entries which will reduce
-  // performance.
-  const float max_table_load = 0.5f;  // Grow when we're > this full.
-  const float min_table_load = 0.2f;  // Shrink when we're < this full.
-
   float load = ComputeTableLoad();
-  if (load < max_table_load &&
+  if (load < kMaxTableLoad &&
       (table_length_ <= static_cast<float>(kDefaultTableSize) ||
-       load > min_table_load))
+       load > kMinTableLoad))
     return false;
 
   // Table needs to grow or shrink.
   int new_size = NewTableSizeForCount(used_items_);
   DCHECK(new_size > used_items_);
-  DCHECK(load <= min_table_load || new_size > table_length_);
+  DCHECK(load <= kMinTableLoad || new_size > table_length_);
   ResizeTable(new_size);
   return true;
 }
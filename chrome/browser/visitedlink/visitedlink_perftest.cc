@@ -106,6 +106,27 @@ TEST_F(VisitedLink, TestAddAndQuery) {
   CheckVisited(master, unadded_prefix, 0, add_count);
 }
 
+// Tests how long it takes to add many URLs at once to a table that already
+// holds a large history, so that the table has to grow.
+TEST_F(VisitedLink, TestAddURLsGrowth) {
+  VisitedLinkMaster master(DummyVisitedLinkEventListener::GetInstance(),
+                           NULL, true, db_path_, 0);
+  ASSERT_TRUE(master.Init());
+
+  std::vector<GURL> urls;
+  for (int i = 0; i < load_test_add_count; i++)
+    urls.push_back(TestURL(added_prefix, i));
+  master.AddURLs(urls);
+
+  urls.clear();
+  for (int i = 0; i < load_test_add_count; i++)
+    urls.push_back(TestURL(unadded_prefix, i));
+
+  PerfTimeLogger timer("Visited_link_add_urls_growth");
+  master.AddURLs(urls);
+  timer.Done();
+}
+
 // Tests how long it takes to write and read a large database to and from disk.
 TEST_F(VisitedLink, TestLoad) {
   // create a big DB
@@ -373,6 +373,27 @@ TEST_F(VisitedLinkTest, Resizing) {
   Reload();
 }
 
+// Tests that adding URLs all at once grows the table enough for them.
+TEST_F(VisitedLinkTest, ResizingAddURLs) {
+  const int32 initial_size = 17;
+  ASSERT_TRUE(InitHistory());
+  ASSERT_TRUE(InitVisited(initial_size, true));
+
+  std::vector<GURL> urls;
+  for (int i = 0; i < g_test_count; i++)
+    urls.push_back(TestURL(i));
+  master_->AddURLs(urls);
+  ASSERT_EQ(g_test_count, master_->GetUsedCount());
+
+  int32 table_size;
+  VisitedLinkCommon::Fingerprint* table;
+  master_->GetUsageStatistics(&table_size, &table);
+  EXPECT_GE(table_size, 2 * g_test_count);
+
+  master_->DebugValidate();
+  Reload();
+}
+
 // Tests that if the database doesn't exist, it will be rebuilt from history.
 TEST_F(VisitedLinkTest, Rebuild) {
   ASSERT_TRUE(InitHistory());
@@ -230,6 +230,10 @@ const char kDeviceManagementUrl[]           = "device-management-url";
 // Triggers a plethora of diagnostic modes.
 const char kDiagnostics[]                   = "diagnostics";
 
+// Disables the built-in asynchronous DNS client, so that host names are
+// resolved with the system resolver.
+const char kDisableAsyncDns[]               = "disable-async-dns";
+
 // Replaces the audio IPC layer for <audio> and <video> with a mock audio
 // device, useful when using remote desktop or machines without sound cards.
 // This is temporary until we fix the underlying problem.
@@ -452,9 +456,6 @@ const char kEnableActionBox[]               = "enable-action-box";
 // Enables AeroPeek for each tab. (This switch only works on Windows 7).
 const char kEnableAeroPeekTabs[]            = "enable-aero-peek-tabs";
 
-// Enables the experimental asynchronous DNS client.
-const char kEnableAsyncDns[]                = "enable-async-dns";
-
 // Enables the inclusion of non-standard ports when generating the Kerberos SPN
 // in response to a Negotiate challenge. See
 // HttpAuthHandlerNegotiate::CreateSPN for more background.
@@ -571,6 +572,10 @@ const char kEnablePanels[]                  = "enable-panels";
 // account creation.
 const char kEnablePasswordGeneration[]      = "enable-password-generation";
 
+// Persists TLS sessions in the disk cache alongside the server's certificates
+// so that connections made after a restart can resume them.
+const char kEnablePersistentSSLSessions[]   = "enable-persistent-ssl-sessions";
+
 // Enables advanced app capabilities.
 const char kEnablePlatformApps[]            = "enable-platform-apps";
 
@@ -620,6 +625,10 @@ const char kEnableSyncTabsForOtherClients[] =
 // Enables context menu for selecting groups of tabs.
 const char kEnableTabGroupsContextMenu[]    = "enable-tab-groups-context-menu";
 
+// Keeps preconnected sockets warm for as long as demand for them lasts, and
+// adapts idle socket timeouts to how often each host's sockets get reused.
+const char kEnableWarmSocketPool[]          = "enable-warm-socket-pool";
+
 // Spawns threads to watch for excessive delays in specified message loops.
 // User should set breakpoints on Alarm() to examine problematic thread.
 //
@@ -744,6 +753,10 @@ const char kHomePage[]                      = "homepage";
 // proxy connection, and the endpoint host in a SOCKS proxy connection).
 const char kHostRules[]                     = "host-rules";
 
+// How many seconds after expiring a cached host resolution may still be used,
+// while it is refreshed in the background. Zero, the default, disables this.
+const char kHostResolverMaxStaleness[]      = "host-resolver-max-staleness";
+
 // The maximum number of concurrent host resolve requests (i.e. DNS) to allow
 // (not counting backup attempts which would also consume threads).
 // --host-resolver-retry-attempts must be set to zero for this to be exact.
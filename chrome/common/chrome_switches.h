@@ -74,6 +74,7 @@ extern const char kDebugEnableFrameToggle[];
 extern const char kDebugPrint[];
 extern const char kDeviceManagementUrl[];
 extern const char kDiagnostics[];
+extern const char kDisableAsyncDns[];
 extern const char kDisableAsynchronousSpellChecking[];
 extern const char kDisableAuthNegotiateCnameLookup[];
 extern const char kDisableBackgroundMode[];
@@ -133,7 +134,6 @@ extern const char kDownloadsNewUI[];
 extern const char kDumpHistogramsOnExit[];
 extern const char kEnableActionBox[];
 extern const char kEnableAeroPeekTabs[];
-extern const char kEnableAsyncDns[];
 extern const char kEnableAuthNegotiatePort[];
 extern const char kEnableAutofillFeedback[];
 extern const char kEnableAutologin[];
@@ -164,6 +164,7 @@ extern const char kEnableNpn[];
 extern const char kEnableNpnHttpOnly[];
 extern const char kEnablePanels[];
 extern const char kEnablePasswordGeneration[];
+extern const char kEnablePersistentSSLSessions[];
 extern const char kEnablePlatformApps[];
 extern const char kEnablePnacl[];
 extern const char kEnableProfiling[];
@@ -178,6 +179,7 @@ extern const char kEnableSyncTabs[];
 extern const char kDisableSyncTabs[];
 extern const char kEnableSyncTabsForOtherClients[];
 extern const char kEnableTabGroupsContextMenu[];
+extern const char kEnableWarmSocketPool[];
 extern const char kEnableWatchdog[];
 extern const char kEnableWebsiteSettings[];
 extern const char kEnableWebSocketOverSpdy[];
@@ -205,6 +207,7 @@ extern const char kHelpShort[];
 extern const char kHideIcons[];
 extern const char kHomePage[];
 extern const char kHostRules[];
+extern const char kHostResolverMaxStaleness[];
 extern const char kHostResolverParallelism[];
 extern const char kHostResolverRetryAttempts[];
 extern const char kHostResolverRules[];
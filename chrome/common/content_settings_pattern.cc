@@ -428,6 +428,15 @@ bool ContentSettingsPattern::Matches(
     local_url = url.inner_url();
   }
 
+  // Rules are matched one after the other against each URL, and most of them
+  // fail on the host. Reject those before copying any part of the URL; the
+  // host of a matching URL is always the pattern's host or a subdomain of it.
+  if (!parts_.host.empty() && parts_.scheme != chrome::kFileScheme &&
+      !local_url->DomainIs(parts_.host.c_str(),
+                           static_cast<int>(parts_.host.length()))) {
+    return false;
+  }
+
   // Match the scheme part.
   const std::string scheme(local_url->scheme());
   if (!parts_.is_scheme_wildcard &&
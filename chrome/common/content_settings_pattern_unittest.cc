@@ -208,6 +208,21 @@ TEST(ContentSettingsPatternTest, TrimEndingDotFromHost) {
   EXPECT_TRUE(Pattern("www.example.com.") == Pattern("www.example.com"));
 }
 
+TEST(ContentSettingsPatternTest, HostsMatchOnLabelBoundaries) {
+  EXPECT_TRUE(Pattern("[*.]example.com").Matches(
+      GURL("http://www.example.com.")));
+  EXPECT_TRUE(Pattern("[*.]example.com").Matches(
+      GURL("http://example.com")));
+  EXPECT_FALSE(Pattern("[*.]example.com").Matches(
+      GURL("http://notexample.com")));
+  EXPECT_FALSE(Pattern("www.example.com").Matches(
+      GURL("http://foo.www.example.com")));
+  EXPECT_FALSE(Pattern("www.example.com").Matches(
+      GURL("http://example.com")));
+  EXPECT_TRUE(Pattern("[::1]").Matches(GURL("http://[::1]")));
+  EXPECT_FALSE(Pattern("[::1]").Matches(GURL("http://[::2]")));
+}
+
 TEST(ContentSettingsPatternTest, FromString_WithNoWildcards) {
   // HTTP patterns with default port.
   EXPECT_TRUE(Pattern("http://www.example.com:80").IsValid());
@@ -353,8 +353,11 @@ bool URLPattern::MatchesHost(const std::string& host) const {
 }
 
 bool URLPattern::MatchesHost(const GURL& test) const {
+  // GURL::host() returns a copy, so only make it once.
+  const std::string test_host(test.host());
+
   // If the hosts are exactly equal, we have a match.
-  if (test.host() == host_)
+  if (test_host == host_)
     return true;
 
   // If we're matching subdomains, and we have no host in the match pattern,
@@ -373,14 +376,14 @@ bool URLPattern::MatchesHost(const GURL& test) const {
     return false;
 
   // Check if the test host is a subdomain of our host.
-  if (test.host().length() <= (host_.length() + 1))
+  if (test_host.length() <= (host_.length() + 1))
     return false;
 
-  if (test.host().compare(test.host().length() - host_.length(),
-                          host_.length(), host_) != 0)
+  if (test_host.compare(test_host.length() - host_.length(),
+                        host_.length(), host_) != 0)
     return false;
 
-  return test.host()[test.host().length() - host_.length() - 1] == '.';
+  return test_host[test_host.length() - host_.length() - 1] == '.';
 }
 
 bool URLPattern::MatchesPath(const std::string& test) const {
@@ -383,6 +383,10 @@ const char kDnsHostReferralList[] = "HostReferralList";
 const char kDnsPrefetchingHostReferralList[] =
     "dns_prefetching.host_referral_list";
 
+// A snapshot of the host resolver's cache, restored at startup so that the
+// first requests of a session need not wait for DNS.
+const char kDnsPrefetchingHostCache[] = "dns_prefetching.host_cache";
+
 // Disables the SPDY protocol.
 const char kDisableSpdy[] = "spdy.disabled";
 
@@ -146,6 +146,7 @@ extern const char kDnsStartupPrefetchList[];  // OBSOLETE
 extern const char kDnsPrefetchingStartupList[];
 extern const char kDnsHostReferralList[];  // OBSOLETE
 extern const char kDnsPrefetchingHostReferralList[];
+extern const char kDnsPrefetchingHostCache[];
 extern const char kDisableSpdy[];
 extern const char kHttpServerProperties[];
 extern const char kSpdyServers[];
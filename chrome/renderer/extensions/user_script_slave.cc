@@ -266,6 +266,14 @@ void UserScriptSlave::InjectScripts(WebFrame* frame,
     if (frame->parent() && !script->match_all_frames())
       continue;  // Only match subframes if the script declared it wanted to.
 
+    // Scripts that have nothing to inject at |location| are skipped before
+    // their URL patterns are matched, as this runs for each location of each
+    // frame load.
+    bool counts_css = location == UserScript::DOCUMENT_START &&
+        !script->css_scripts().empty();
+    if (script->run_location() != location && !counts_css)
+      continue;
+
     const Extension* extension = extensions_->GetByID(script->extension_id());
 
     // Since extension info is sent separately from user script info, they can
@@ -72,13 +72,29 @@ Scorer* Scorer::Create(const base::StringPiece& model_str) {
   for (int i = 0; i < model.page_word_size(); ++i) {
     scorer->page_words_.insert(model.page_word(i));
   }
+  for (int i = 0; i < model.hashes_size(); ++i) {
+    scorer->hash_indices_.insert(std::make_pair(model.hashes(i), i));
+  }
   return scorer.release();
 }
 
 double Scorer::ComputeScore(const FeatureMap& features) const {
+  // Look up each feature of the page once, rather than once for every rule
+  // that uses it.
+  std::vector<double> feature_values(model_.hashes_size(), 0.0);
+  const base::hash_map<std::string, double>& feature_map = features.features();
+  for (base::hash_map<std::string, double>::const_iterator it =
+           feature_map.begin();
+       it != feature_map.end(); ++it) {
+    base::hash_map<std::string, int>::const_iterator index =
+        hash_indices_.find(it->first);
+    if (index != hash_indices_.end())
+      feature_values[index->second] = it->second;
+  }
+
   double logodds = 0.0;
   for (int i = 0; i < model_.rule_size(); ++i) {
-    logodds += ComputeRuleScore(model_.rule(i), features);
+    logodds += ComputeRuleScore(model_.rule(i), feature_values);
   }
   return LogOdds2Prob(logodds);
 }
@@ -103,20 +119,19 @@ uint32 Scorer::murmurhash3_seed() const {
   return model_.murmur_hash_seed();
 }
 
-double Scorer::ComputeRuleScore(const ClientSideModel::Rule& rule,
-                                const FeatureMap& features) const {
-  const base::hash_map<std::string, double>& feature_map = features.features();
+double Scorer::ComputeRuleScore(
+    const ClientSideModel::Rule& rule,
+    const std::vector<double>& feature_values) const {
   double rule_score = 1.0;
   for (int i = 0; i < rule.feature_size(); ++i) {
-    base::hash_map<std::string, double>::const_iterator it = feature_map.find(
-        model_.hashes(rule.feature(i)));
-    if (it == feature_map.end() || it->second == 0.0) {
+    double value = feature_values[rule.feature(i)];
+    if (value == 0.0) {
       // If the feature of the rule does not exist in the given feature map the
       // feature weight is considered to be zero.  If the feature weight is zero
       // we leave early since we know that the rule score will be zero.
       return 0.0;
     }
-    rule_score *= it->second;
+    rule_score *= value;
   }
   return rule_score * rule.weight();
 }
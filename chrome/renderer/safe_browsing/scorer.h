@@ -16,6 +16,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/hash_tables.h"
@@ -66,18 +67,21 @@ class Scorer {
  private:
   friend class PhishingScorerTest;
 
-  // Computes the score for a given rule and feature map.  The score is computed
-  // by multiplying the rule weight with the product of feature weights for the
-  // given rule.  The feature weights are stored in the feature map.  If a
-  // particular feature does not exist in the feature map we set its weight to
-  // zero.
+  // Computes the score for a given rule and feature values.  The score is
+  // computed by multiplying the rule weight with the product of feature
+  // weights for the given rule.  The weight of the feature with hash index i
+  // in the model is |feature_values[i]|, which is zero for the features that
+  // are not in the feature map.
   double ComputeRuleScore(const ClientSideModel::Rule& rule,
-                          const FeatureMap& features) const;
+                          const std::vector<double>& feature_values) const;
 
   ClientSideModel model_;
   base::hash_set<std::string> page_terms_;
   base::hash_set<uint32> page_words_;
 
+  // Maps each hash of the model, which are all distinct, to its index.
+  base::hash_map<std::string, int> hash_indices_;
+
   DISALLOW_COPY_AND_ASSIGN(Scorer);
 };
 }  // namepsace safe_browsing
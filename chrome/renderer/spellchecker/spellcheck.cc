@@ -25,6 +25,13 @@ using WebKit::WebVector;
 using WebKit::WebTextCheckingResult;
 using WebKit::WebTextCheckingType;
 
+namespace {
+
+// The most words whose spelling is remembered.
+const size_t kMaxCheckedWords = 4096;
+
+}  // namespace
+
 namespace spellcheck {
 void ToWebResultList(
     int offset,
@@ -146,6 +153,7 @@ void SpellCheck::Init(base::PlatformFile file,
   initialized_ = true;
   hunspell_.reset();
   bdict_file_.reset();
+  checked_words_.clear();
   file_ = file;
   is_using_platform_spelling_engine_ =
       file == base::kInvalidPlatformFileValue && !language.empty();
@@ -371,8 +379,10 @@ void SpellCheck::InitializeHunspell() {
 }
 
 void SpellCheck::AddWordToHunspell(const std::string& word) {
-  if (!word.empty() && word.length() < MAXWORDUTF8LEN)
+  if (!word.empty() && word.length() < MAXWORDUTF8LEN) {
     hunspell_->add(word.c_str());
+    checked_words_.clear();
+  }
 }
 
 bool SpellCheck::InitializeIfNeeded() {
@@ -405,6 +415,10 @@ bool SpellCheck::CheckSpelling(const string16& word_to_check, int tag) {
         word_to_check, tag, &word_correct));
 #endif
   } else {
+    CheckedWordMap::const_iterator it = checked_words_.find(word_to_check);
+    if (it != checked_words_.end())
+      return it->second;
+
     std::string word_to_check_utf8(UTF16ToUTF8(word_to_check));
     // Hunspell shouldn't let us exceed its max, but check just in case
     if (word_to_check_utf8.length() < MAXWORDUTF8LEN) {
@@ -412,6 +426,9 @@ bool SpellCheck::CheckSpelling(const string16& word_to_check, int tag) {
         // |hunspell_->spell| returns 0 if the word is spelled correctly and
         // non-zero otherwsie.
         word_correct = (hunspell_->spell(word_to_check_utf8.c_str()) != 0);
+        if (checked_words_.size() >= kMaxCheckedWords)
+          checked_words_.clear();
+        checked_words_[word_to_check] = word_correct;
       } else {
         // If |hunspell_| is NULL here, an error has occurred, but it's better
         // to check rather than crash.
@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "base/gtest_prod_util.h"
+#include "base/hash_tables.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
@@ -107,9 +108,12 @@ class SpellCheck : public content::RenderProcessObserver,
   FRIEND_TEST_ALL_PREFIXES(SpellCheckTest, GetAutoCorrectionWord_EN_US);
   FRIEND_TEST_ALL_PREFIXES(SpellCheckTest,
       RequestSpellCheckMultipleTimesWithoutInitialization);
+  FRIEND_TEST_ALL_PREFIXES(SpellCheckTest, CachedWordsSeeAddedWords);
 
   class SpellCheckRequestParam;
 
+  typedef base::hash_map<string16, bool> CheckedWordMap;
+
   // RenderProcessObserver implementation:
   virtual bool OnControlMessageReceived(const IPC::Message& message) OVERRIDE;
 
@@ -164,6 +168,10 @@ class SpellCheck : public content::RenderProcessObserver,
   base::PlatformFile file_;
   std::vector<std::string> custom_words_;
 
+  // Whether |hunspell_| found each of the words it recently checked to be
+  // spelled correctly, as text is checked again every time it is edited.
+  CheckedWordMap checked_words_;
+
   // Represents character attributes used for filtering out characters which
   // are not supported by this SpellCheck object.
   SpellcheckCharAttribute character_attributes_;
@@ -759,6 +759,25 @@ TEST_F(SpellCheckTest, GetAutoCorrectionWord_EN_US) {
   }
 }
 
+// Make sure a word checked before it was added to the custom dictionary is
+// not still reported as misspelled.
+TEST_F(SpellCheckTest, CachedWordsSeeAddedWords) {
+  const string16 word(ASCIIToUTF16("zzxqvw"));
+  int misspelling_start;
+  int misspelling_length;
+  EXPECT_FALSE(spell_check()->SpellCheckWord(
+      word.c_str(), static_cast<int>(word.length()), 0,
+      &misspelling_start, &misspelling_length, NULL));
+  EXPECT_FALSE(spell_check()->SpellCheckWord(
+      word.c_str(), static_cast<int>(word.length()), 0,
+      &misspelling_start, &misspelling_length, NULL));
+
+  spell_check()->OnWordAdded("zzxqvw");
+  EXPECT_TRUE(spell_check()->SpellCheckWord(
+      word.c_str(), static_cast<int>(word.length()), 0,
+      &misspelling_start, &misspelling_length, NULL));
+}
+
 // Since SpellCheck::SpellCheckParagraph is not implemented on Mac,
 // we skip these SpellCheckParagraph tests on Mac.
 #if !defined(OS_MACOSX)
@@ -16,7 +16,8 @@ using content::UserMetricsAction;
 AppCacheDispatcherHost::AppCacheDispatcherHost(
     ChromeAppCacheService* appcache_service,
     int process_id)
-    : appcache_service_(appcache_service),
+    : BrowserMessageFilter(AppCacheMsgStart),
+      appcache_service_(appcache_service),
       ALLOW_THIS_IN_INITIALIZER_LIST(frontend_proxy_(this)),
       process_id_(process_id) {
 }
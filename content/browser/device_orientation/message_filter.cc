@@ -15,7 +15,9 @@ using content::BrowserThread;
 
 namespace device_orientation {
 
-MessageFilter::MessageFilter() : provider_(NULL) {
+MessageFilter::MessageFilter()
+    : BrowserMessageFilter(DeviceOrientationMsgStart),
+      provider_(NULL) {
 }
 
 MessageFilter::~MessageFilter() {
@@ -25,7 +25,8 @@ using WebKit::WebStorageArea;
 DOMStorageMessageFilter::DOMStorageMessageFilter(
     int unused,
     DOMStorageContextImpl* context)
-    : context_(context->context()),
+    : BrowserMessageFilter(DOMStorageMsgStart),
+      context_(context->context()),
       connection_dispatching_message_for_(0) {
 }
 
@@ -186,44 +186,50 @@ void DownloadFileManager::UpdateDownload(
 
   download_stats::RecordFileThreadReceiveBuffers(contents->size());
 
+  // The buffers are written with a single call, since every write to the
+  // file also goes through the hash, the net log and the write stats.
+  scoped_refptr<net::IOBuffer> data;
+  size_t data_len = 0;
+  if (contents->size() == 1) {
+    data = (*contents)[0].first;
+    data_len = (*contents)[0].second;
+  } else {
+    data = content::AssembleData(*contents, &data_len);
+  }
+  for (size_t i = 0; i < contents->size(); ++i)
+    (*contents)[i].first->Release();
+
   DownloadFile* download_file = GetDownloadFile(global_id);
-  bool had_error = false;
-  for (size_t i = 0; i < contents->size(); ++i) {
-    net::IOBuffer* data = (*contents)[i].first;
-    const int data_len = (*contents)[i].second;
-    if (!had_error && download_file) {
-      net::Error write_result =
-          download_file->AppendDataToFile(data->data(), data_len);
-      if (write_result != net::OK) {
-        // Write failed: interrupt the download.
-        DownloadManager* download_manager =
-            download_file->GetDownloadManager();
-        had_error = true;
-
-        int64 bytes_downloaded = download_file->BytesSoFar();
-        std::string hash_state(download_file->GetHashState());
-
-        // Calling this here in case we get more data, to avoid
-        // processing data after an error.  That could lead to
-        // files that are corrupted if the later processing succeeded.
-        CancelDownload(global_id);
-        download_file = NULL;  // Was deleted in |CancelDownload|.
-
-        if (download_manager) {
-          BrowserThread::PostTask(
-              BrowserThread::UI, FROM_HERE,
-              base::Bind(&DownloadManager::OnDownloadInterrupted,
-                         download_manager,
-                         global_id.local(),
-                         bytes_downloaded,
-                         hash_state,
-                         content::ConvertNetErrorToInterruptReason(
-                             write_result,
-                             content::DOWNLOAD_INTERRUPT_FROM_DISK)));
-        }
-      }
-    }
-    data->Release();
+  if (!data || !download_file)
+    return;
+
+  net::Error write_result =
+      download_file->AppendDataToFile(data->data(), data_len);
+  if (write_result == net::OK)
+    return;
+
+  // Write failed: interrupt the download.
+  DownloadManager* download_manager = download_file->GetDownloadManager();
+  int64 bytes_downloaded = download_file->BytesSoFar();
+  std::string hash_state(download_file->GetHashState());
+
+  // Calling this here in case we get more data, to avoid
+  // processing data after an error.  That could lead to
+  // files that are corrupted if the later processing succeeded.
+  CancelDownload(global_id);
+  download_file = NULL;  // Was deleted in |CancelDownload|.
+
+  if (download_manager) {
+    BrowserThread::PostTask(
+        BrowserThread::UI, FROM_HERE,
+        base::Bind(&DownloadManager::OnDownloadInterrupted,
+                   download_manager,
+                   global_id.local(),
+                   bytes_downloaded,
+                   hash_state,
+                   content::ConvertNetErrorToInterruptReason(
+                       write_result,
+                       content::DOWNLOAD_INTERRUPT_FROM_DISK)));
   }
 }
 
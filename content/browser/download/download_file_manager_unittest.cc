@@ -494,6 +494,28 @@ TEST_F(DownloadFileManagerTest, CancelBeforeFinished) {
   CleanUp(dummy_id);
 }
 
+TEST_F(DownloadFileManagerTest, WriteQueuedBuffersAtOnce) {
+  DownloadCreateInfo* info = new DownloadCreateInfo;
+  DownloadId dummy_id(download_manager_.get(), kDummyDownloadId);
+
+  StartDownload(info, dummy_id);
+
+  // The buffers queued before the FILE thread got to them are written with
+  // a single call.
+  EXPECT_TRUE(UpdateBuffer(kTestData1, strlen(kTestData1)));
+  EXPECT_TRUE(UpdateBuffer(kTestData2, strlen(kTestData2)));
+  MockDownloadFile* file = download_file_factory_->GetExistingFile(dummy_id);
+  ASSERT_TRUE(file != NULL);
+  size_t length = strlen(kTestData1) + strlen(kTestData2);
+  byte_count_[dummy_id] += length;
+  EXPECT_CALL(*file, AppendDataToFile(_, length))
+      .Times(1)
+      .WillOnce(Return(net::OK));
+  download_file_manager_->UpdateDownload(dummy_id, download_buffer_.get());
+
+  CleanUp(dummy_id);
+}
+
 TEST_F(DownloadFileManagerTest, DownloadWithError) {
   // Same as StartDownload, at first.
   DownloadCreateInfo* info = new DownloadCreateInfo;
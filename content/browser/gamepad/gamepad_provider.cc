@@ -24,6 +24,7 @@ GamepadProvider::GamepadProvider(GamepadDataFetcher* fetcher)
     : is_paused_(false),
       devices_changed_(true),
       provided_fetcher_(fetcher),
+      idle_polls_(0),
       ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
   size_t data_size = sizeof(GamepadHardwareBuffer);
   base::SystemMonitor* monitor = base::SystemMonitor::Get();
@@ -33,6 +34,7 @@ GamepadProvider::GamepadProvider(GamepadDataFetcher* fetcher)
   CHECK(res);
   GamepadHardwareBuffer* hwbuf = SharedMemoryAsHardwareBuffer();
   memset(hwbuf, 0, sizeof(GamepadHardwareBuffer));
+  memset(&pad_state_, 0, sizeof(pad_state_));
 
   polling_thread_.reset(new base::Thread("Gamepad polling thread"));
   polling_thread_->StartWithOptions(
@@ -119,11 +121,23 @@ void GamepadProvider::DoPoll() {
     devices_changed_ = false;
   }
 
-  // Acquire the SeqLock. There is only ever one writer to this data.
-  // See gamepad_hardware_buffer.h.
-  hwbuf->sequence.WriteBegin();
-  data_fetcher_->GetGamepadData(&hwbuf->buffer, changed);
-  hwbuf->sequence.WriteEnd();
+  data_fetcher_->GetGamepadData(&pad_state_, changed);
+
+  // This is the only writer of the shared memory, so it can be compared
+  // with without taking the SeqLock. Leaving it alone when nothing changed
+  // spares the renderers retried reads.
+  if (memcmp(&pad_state_, &hwbuf->buffer, sizeof(pad_state_)) != 0) {
+    // Acquire the SeqLock. There is only ever one writer to this data.
+    // See gamepad_hardware_buffer.h.
+    hwbuf->sequence.WriteBegin();
+    memcpy(&hwbuf->buffer, &pad_state_, sizeof(pad_state_));
+    hwbuf->sequence.WriteEnd();
+    idle_polls_ = 0;
+  } else if (changed) {
+    idle_polls_ = 0;
+  } else if (idle_polls_ < kIdlePollsBeforeSlowing) {
+    ++idle_polls_;
+  }
 
   // Schedule our next interval of polling.
   ScheduleDoPoll();
@@ -138,10 +152,12 @@ void GamepadProvider::ScheduleDoPoll() {
       return;
   }
 
+  int interval_ms = idle_polls_ < kIdlePollsBeforeSlowing ?
+      kDesiredSamplingIntervalMs : kIdleSamplingIntervalMs;
   MessageLoop::current()->PostDelayedTask(
       FROM_HERE,
       base::Bind(&GamepadProvider::DoPoll, weak_factory_.GetWeakPtr()),
-      base::TimeDelta::FromMilliseconds(kDesiredSamplingIntervalMs));
+      base::TimeDelta::FromMilliseconds(interval_ms));
 }
 
 GamepadHardwareBuffer* GamepadProvider::SharedMemoryAsHardwareBuffer() {
@@ -12,6 +12,7 @@
 #include "base/synchronization/lock.h"
 #include "base/system_monitor/system_monitor.h"
 #include "content/common/content_export.h"
+#include "third_party/WebKit/Source/WebKit/chromium/public/platform/WebGamepads.h"
 
 namespace base {
 class Thread;
@@ -53,7 +54,13 @@ class CONTENT_EXPORT GamepadProvider :
 
   GamepadHardwareBuffer* SharedMemoryAsHardwareBuffer();
 
-  enum { kDesiredSamplingIntervalMs = 16 };
+  // Once the pads haven't changed for kIdlePollsBeforeSlowing polls, they
+  // are polled at kIdleSamplingIntervalMs until they change again.
+  enum {
+    kDesiredSamplingIntervalMs = 16,
+    kIdleSamplingIntervalMs = 50,
+    kIdlePollsBeforeSlowing = 120
+  };
 
   // Keeps track of when the background thread is paused. Access to is_paused_
   // must be guarded by is_paused_lock_.
@@ -77,6 +84,13 @@ class CONTENT_EXPORT GamepadProvider :
   scoped_ptr<GamepadDataFetcher> data_fetcher_;
   base::SharedMemory gamepad_shared_memory_;
 
+  // The pads as last read from |data_fetcher_|. They are only copied into
+  // the shared memory, under its SeqLock, when they have changed.
+  WebKit::WebGamepads pad_state_;
+
+  // The number of polls in a row that found no change.
+  int idle_polls_;
+
   // Polling is done on this background thread.
   scoped_ptr<base::Thread> polling_thread_;
 
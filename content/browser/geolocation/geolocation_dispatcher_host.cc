@@ -214,3 +214,7 @@ GeolocationDispatcherHost* GeolocationDispatcherHost::New(
       render_process_id,
       geolocation_permission_context);
 }
+
+GeolocationDispatcherHost::GeolocationDispatcherHost()
+    : BrowserMessageFilter(GeolocationMsgStart) {
+}
@@ -21,7 +21,7 @@ class GeolocationDispatcherHost : public content::BrowserMessageFilter {
       content::GeolocationPermissionContext* geolocation_permission_context);
 
  protected:
-  GeolocationDispatcherHost() {}
+  GeolocationDispatcherHost();
   virtual ~GeolocationDispatcherHost() {}
 
   DISALLOW_COPY_AND_ASSIGN(GeolocationDispatcherHost);
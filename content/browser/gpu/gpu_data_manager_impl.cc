@@ -13,6 +13,7 @@
 #include "base/values.h"
 #include "base/version.h"
 #include "content/browser/gpu/gpu_process_host.h"
+#include "content/browser/gpu/gpu_program_disk_cache.h"
 #include "content/common/gpu/gpu_messages.h"
 #include "content/gpu/gpu_info_collector.h"
 #include "content/public/browser/browser_thread.h"
@@ -253,6 +254,14 @@ void GpuDataManagerImpl::RegisterSwiftShaderPath(const FilePath& path) {
   EnableSoftwareRenderingIfNecessary();
 }
 
+void GpuDataManagerImpl::SetProgramCacheDirectory(const FilePath& path) {
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&GpuProgramDiskCache::SetCacheDirectory,
+                 base::Unretained(GpuProgramDiskCache::GetInstance()),
+                 path));
+}
+
 const base::ListValue& GpuDataManagerImpl::GetLogMessages() const {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   return log_messages_;
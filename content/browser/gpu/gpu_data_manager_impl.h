@@ -35,6 +35,7 @@ class CONTENT_EXPORT GpuDataManagerImpl
   virtual bool IsCompleteGPUInfoAvailable() const OVERRIDE;
   virtual bool ShouldUseSoftwareRendering() OVERRIDE;
   virtual void RegisterSwiftShaderPath(const FilePath& path) OVERRIDE;
+  virtual void SetProgramCacheDirectory(const FilePath& path) OVERRIDE;
   virtual const base::ListValue& GetLogMessages() const OVERRIDE;
   virtual void AddObserver(content::GpuDataManagerObserver* observer) OVERRIDE;
   virtual void RemoveObserver(
@@ -17,6 +17,7 @@
 #include "content/browser/browser_child_process_host_impl.h"
 #include "content/browser/gpu/gpu_data_manager_impl.h"
 #include "content/browser/gpu/gpu_process_host_ui_shim.h"
+#include "content/browser/gpu/gpu_program_disk_cache.h"
 #include "content/browser/gpu/gpu_surface_tracker.h"
 #include "content/browser/renderer_host/render_widget_helper.h"
 #include "content/browser/renderer_host/render_widget_host_impl.h"
@@ -120,6 +121,18 @@ void AcceleratedSurfaceBuffersSwappedCompleted(int host_id,
   }
 }
 
+// Gives the GPU process the program binaries cached by earlier ones.
+void SendCachedPrograms(int host_id,
+                        const GpuProgramDiskCache::EntryList& entries) {
+  GpuProcessHost* host = GpuProcessHost::FromID(host_id);
+  if (!host)
+    return;
+  for (size_t ii = 0; ii < entries.size(); ++ii) {
+    host->Send(new GpuMsg_LoadedProgram(entries[ii].first,
+                                        entries[ii].second));
+  }
+}
+
 }  // anonymous namespace
 
 #if defined(TOOLKIT_GTK)
@@ -386,7 +399,15 @@ bool GpuProcessHost::Init() {
     return false;
   }
 
-  return Send(new GpuMsg_Initialize());
+  if (!Send(new GpuMsg_Initialize()))
+    return false;
+
+  if (!CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kDisableGpuProgramCache)) {
+    GpuProgramDiskCache::GetInstance()->GetEntries(
+        base::Bind(&SendCachedPrograms, host_id_));
+  }
+  return true;
 }
 
 void GpuProcessHost::RouteOnUIThread(const IPC::Message& message) {
@@ -412,6 +433,7 @@ bool GpuProcessHost::OnMessageReceived(const IPC::Message& message) {
     IPC_MESSAGE_HANDLER(GpuHostMsg_ChannelEstablished, OnChannelEstablished)
     IPC_MESSAGE_HANDLER(GpuHostMsg_CommandBufferCreated, OnCommandBufferCreated)
     IPC_MESSAGE_HANDLER(GpuHostMsg_DestroyCommandBuffer, OnDestroyCommandBuffer)
+    IPC_MESSAGE_HANDLER(GpuHostMsg_CacheProgram, OnCacheProgram)
 #if defined(OS_MACOSX)
     IPC_MESSAGE_HANDLER(GpuHostMsg_AcceleratedSurfaceBuffersSwapped,
                         OnAcceleratedSurfaceBuffersSwapped)
@@ -541,6 +563,11 @@ void GpuProcessHost::OnDestroyCommandBuffer(int32 surface_id) {
 #endif  // defined(TOOLKIT_GTK)
 }
 
+void GpuProcessHost::OnCacheProgram(const std::string& key,
+                                    const std::string& program) {
+  GpuProgramDiskCache::GetInstance()->StoreEntry(key, program);
+}
+
 #if defined(OS_MACOSX)
 void GpuProcessHost::OnAcceleratedSurfaceBuffersSwapped(
     const GpuHostMsg_AcceleratedSurfaceBuffersSwapped_Params& params) {
@@ -725,6 +752,7 @@ bool GpuProcessHost::LaunchGpuProcess(const std::string& channel_id) {
     switches::kDisableBreakpad,
     switches::kDisableGLMultisampling,
     switches::kDisableGpuDriverBugWorkarounds,
+    switches::kDisableGpuProgramCache,
     switches::kDisableGpuSandbox,
     switches::kReduceGpuSandbox,
     switches::kDisableSeccompFilterSandbox,
@@ -733,11 +761,14 @@ bool GpuProcessHost::LaunchGpuProcess(const std::string& channel_id) {
     switches::kDisableImageTransportSurface,
     switches::kDisableLogging,
     switches::kEnableGPUServiceLogging,
+    switches::kEnableGpuContextScheduling,
     switches::kEnableLogging,
 #if defined(OS_MACOSX)
     switches::kEnableSandboxLogging,
 #endif
+    switches::kGpuMemoryBudgetMb,
     switches::kGpuNoContextLost,
+    switches::kGpuRecordCommandBuffers,
     switches::kGpuStartupDialog,
     switches::kLoggingLevel,
     switches::kNoSandbox,
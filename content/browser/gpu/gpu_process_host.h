@@ -116,6 +116,7 @@ class GpuProcessHost : public content::BrowserChildProcessHostDelegate,
   void OnChannelEstablished(const IPC::ChannelHandle& channel_handle);
   void OnCommandBufferCreated(const int32 route_id);
   void OnDestroyCommandBuffer(int32 surface_id);
+  void OnCacheProgram(const std::string& key, const std::string& program);
 
 #if defined(OS_MACOSX)
   void OnAcceleratedSurfaceBuffersSwapped(
@@ -0,0 +1,208 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/gpu/gpu_program_disk_cache.h"
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/memory/singleton.h"
+#include "base/pickle.h"
+#include "content/public/browser/browser_thread.h"
+
+using content::BrowserThread;
+
+namespace {
+
+// Bumped whenever the layout of the file changes.
+const uint32 kFileVersion = 1;
+
+// The GPU process keeps as much in memory.
+const size_t kMaxCacheSize = 6 * 1024 * 1024;
+
+// How long to wait after an entry is added before writing the file, so that
+// the programs a page links together are written at once.
+const int kWriteDelaySeconds = 10;
+
+void ReadCacheFile(const FilePath& path, std::string* contents) {
+  if (!file_util::ReadFileToString(path, contents))
+    contents->clear();
+}
+
+void WriteCacheFile(const FilePath& path, const std::string& contents) {
+  if (!file_util::CreateDirectory(path.DirName()))
+    return;
+  // Write next to the file first so that a crash never leaves half of it.
+  FilePath temp_path = path.AddExtension(FILE_PATH_LITERAL("tmp"));
+  int size = static_cast<int>(contents.size());
+  if (file_util::WriteFile(temp_path, contents.data(), size) != size ||
+      !file_util::ReplaceFile(temp_path, path)) {
+    file_util::Delete(temp_path, false);
+  }
+}
+
+}  // namespace
+
+// static
+GpuProgramDiskCache* GpuProgramDiskCache::GetInstance() {
+  return Singleton<GpuProgramDiskCache,
+                   LeakySingletonTraits<GpuProgramDiskCache> >::get();
+}
+
+GpuProgramDiskCache::GpuProgramDiskCache()
+    : load_state_(NOT_LOADED),
+      size_(0),
+      write_scheduled_(false) {
+}
+
+GpuProgramDiskCache::~GpuProgramDiskCache() {
+}
+
+void GpuProgramDiskCache::SetCacheDirectory(const FilePath& directory) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  DCHECK_EQ(NOT_LOADED, load_state_);
+  file_path_ = directory.Append(FILE_PATH_LITERAL("Programs"));
+}
+
+void GpuProgramDiskCache::GetEntries(const EntriesCallback& callback) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (file_path_.empty())
+    return;
+
+  if (load_state_ != LOADED) {
+    pending_callbacks_.push_back(callback);
+    Load();
+    return;
+  }
+
+  EntryList entries;
+  for (KeyList::const_iterator it = lru_keys_.begin();
+       it != lru_keys_.end(); ++it) {
+    entries.push_back(std::make_pair(*it, entries_[*it].program));
+  }
+  callback.Run(entries);
+}
+
+void GpuProgramDiskCache::StoreEntry(const std::string& key,
+                                     const std::string& program) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (file_path_.empty() || program.size() > kMaxCacheSize)
+    return;
+
+  EntryMap::iterator it = entries_.find(key);
+  if (it != entries_.end()) {
+    size_ -= it->second.program.size();
+    lru_keys_.erase(it->second.lru_position);
+    entries_.erase(it);
+  }
+  lru_keys_.push_front(key);
+  Entry& entry = entries_[key];
+  entry.program = program;
+  entry.lru_position = lru_keys_.begin();
+  size_ += program.size();
+
+  while (size_ > kMaxCacheSize) {
+    it = entries_.find(lru_keys_.back());
+    size_ -= it->second.program.size();
+    entries_.erase(it);
+    lru_keys_.pop_back();
+  }
+
+  ScheduleWrite();
+}
+
+void GpuProgramDiskCache::Load() {
+  if (load_state_ != NOT_LOADED)
+    return;
+  load_state_ = LOADING;
+  std::string* contents = new std::string;
+  BrowserThread::PostTaskAndReply(
+      BrowserThread::FILE, FROM_HERE,
+      base::Bind(&ReadCacheFile, file_path_, contents),
+      base::Bind(&GpuProgramDiskCache::OnFileRead, base::Unretained(this),
+                 base::Owned(contents)));
+}
+
+void GpuProgramDiskCache::OnFileRead(std::string* contents) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  DCHECK_EQ(LOADING, load_state_);
+  load_state_ = LOADED;
+
+  Pickle pickle(contents->data(), static_cast<int>(contents->size()));
+  PickleIterator iter(pickle);
+  uint32 version;
+  int count;
+  if (pickle.ReadUInt32(&iter, &version) && version == kFileVersion &&
+      pickle.ReadInt(&iter, &count)) {
+    for (int ii = 0; ii < count; ++ii) {
+      std::string key;
+      std::string program;
+      if (!pickle.ReadString(&iter, &key) ||
+          !pickle.ReadString(&iter, &program))
+        break;
+      AddEntry(key, program);
+    }
+  }
+
+  std::vector<EntriesCallback> callbacks;
+  callbacks.swap(pending_callbacks_);
+  for (size_t ii = 0; ii < callbacks.size(); ++ii)
+    GetEntries(callbacks[ii]);
+
+  // Entries that were stored while the file was being read are not in it yet.
+  if (write_scheduled_) {
+    write_scheduled_ = false;
+    ScheduleWrite();
+  }
+}
+
+void GpuProgramDiskCache::AddEntry(const std::string& key,
+                                   const std::string& program) {
+  // The file lists the entries from most to least recently added, and any
+  // entry stored since it was read is more recent still.
+  if (entries_.count(key) || size_ + program.size() > kMaxCacheSize)
+    return;
+  lru_keys_.push_back(key);
+  Entry& entry = entries_[key];
+  entry.program = program;
+  entry.lru_position = --lru_keys_.end();
+  size_ += program.size();
+}
+
+void GpuProgramDiskCache::ScheduleWrite() {
+  if (write_scheduled_)
+    return;
+  write_scheduled_ = true;
+
+  // The file must be read before it is rewritten, or its entries would be
+  // lost. OnFileRead() schedules the write again.
+  if (load_state_ != LOADED) {
+    Load();
+    return;
+  }
+
+  BrowserThread::PostDelayedTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&GpuProgramDiskCache::Write, base::Unretained(this)),
+      base::TimeDelta::FromSeconds(kWriteDelaySeconds));
+}
+
+void GpuProgramDiskCache::Write() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  DCHECK_EQ(LOADED, load_state_);
+  write_scheduled_ = false;
+
+  Pickle pickle;
+  pickle.WriteUInt32(kFileVersion);
+  pickle.WriteInt(static_cast<int>(lru_keys_.size()));
+  for (KeyList::const_iterator it = lru_keys_.begin();
+       it != lru_keys_.end(); ++it) {
+    pickle.WriteString(*it);
+    pickle.WriteString(entries_[*it].program);
+  }
+  std::string contents(static_cast<const char*>(pickle.data()), pickle.size());
+  BrowserThread::PostTask(
+      BrowserThread::FILE, FROM_HERE,
+      base::Bind(&WriteCacheFile, file_path_, contents));
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_GPU_GPU_PROGRAM_DISK_CACHE_H_
+#define CONTENT_BROWSER_GPU_GPU_PROGRAM_DISK_CACHE_H_
+#pragma once
+
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/file_path.h"
+
+template <typename T> struct DefaultSingletonTraits;
+
+// Keeps the program binaries that GPU processes cache on disk, so that a GPU
+// process launched later, even by a later run of the browser, does not have
+// to link them again. The file is read the first time the entries are asked
+// for and is rewritten a little while after entries are added, both on the
+// FILE thread. Once the entries take up more than the maximum size, the least
+// recently added ones are dropped.
+//
+// Everything else happens on the IO thread.
+class GpuProgramDiskCache {
+ public:
+  typedef std::vector<std::pair<std::string, std::string> > EntryList;
+  typedef base::Callback<void(const EntryList&)> EntriesCallback;
+
+  static GpuProgramDiskCache* GetInstance();
+
+  // Sets the directory the cache is kept in. Nothing is cached until it is
+  // set.
+  void SetCacheDirectory(const FilePath& directory);
+
+  // Runs |callback| with the cached entries once they are read.
+  void GetEntries(const EntriesCallback& callback);
+
+  // Adds an entry that a GPU process cached.
+  void StoreEntry(const std::string& key, const std::string& program);
+
+ private:
+  friend struct DefaultSingletonTraits<GpuProgramDiskCache>;
+
+  enum LoadState {
+    NOT_LOADED,
+    LOADING,
+    LOADED
+  };
+
+  typedef std::list<std::string> KeyList;
+
+  struct Entry {
+    std::string program;
+    // Where the key is in |lru_keys_|.
+    KeyList::iterator lru_position;
+  };
+
+  typedef std::map<std::string, Entry> EntryMap;
+
+  GpuProgramDiskCache();
+  ~GpuProgramDiskCache();
+
+  // Starts reading the file unless it is read already.
+  void Load();
+  void OnFileRead(std::string* contents);
+
+  // Adds the entry unless there already is one for |key|.
+  void AddEntry(const std::string& key, const std::string& program);
+
+  void ScheduleWrite();
+  void Write();
+
+  FilePath file_path_;
+  LoadState load_state_;
+  std::vector<EntriesCallback> pending_callbacks_;
+
+  EntryMap entries_;
+  size_t size_;
+
+  // From most to least recently added.
+  KeyList lru_keys_;
+
+  bool write_scheduled_;
+
+  DISALLOW_COPY_AND_ASSIGN(GpuProgramDiskCache);
+};
+
+#endif  // CONTENT_BROWSER_GPU_GPU_PROGRAM_DISK_CACHE_H_
@@ -74,23 +74,20 @@ void IndexedDBCallbacks<WebKit::WebIDBCursor>::onSuccessWithPrefetch(
     const WebKit::WebVector<WebKit::WebSerializedScriptValue>& values) {
   DCHECK(cursor_id_ != -1);
 
-  std::vector<IndexedDBKey> msgKeys;
-  std::vector<IndexedDBKey> msgPrimaryKeys;
-  std::vector<content::SerializedScriptValue> msgValues;
-
-  for (size_t i = 0; i < keys.size(); ++i) {
-    msgKeys.push_back(IndexedDBKey(keys[i]));
-    msgPrimaryKeys.push_back(IndexedDBKey(primaryKeys[i]));
-    msgValues.push_back(content::SerializedScriptValue(values[i]));
-  }
-
+  // Convert the entries straight into the message params, since the values
+  // can be large and there can be up to a hundred of them.
   IndexedDBMsg_CallbacksSuccessCursorPrefetch_Params params;
   params.thread_id = thread_id();
   params.response_id = response_id();
   params.cursor_id = cursor_id_;
-  params.keys = msgKeys;
-  params.primary_keys = msgPrimaryKeys;
-  params.values = msgValues;
+  params.keys.reserve(keys.size());
+  params.primary_keys.reserve(keys.size());
+  params.values.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    params.keys.push_back(IndexedDBKey(keys[i]));
+    params.primary_keys.push_back(IndexedDBKey(primaryKeys[i]));
+    params.values.push_back(content::SerializedScriptValue(values[i]));
+  }
   dispatcher_host()->Send(
       new IndexedDBMsg_CallbacksSuccessCursorPrefetch(params));
 }
@@ -66,7 +66,8 @@ void DeleteOnWebKitThread(T* obj) {
 
 IndexedDBDispatcherHost::IndexedDBDispatcherHost(
     int process_id, IndexedDBContextImpl* indexed_db_context)
-    : indexed_db_context_(indexed_db_context),
+    : BrowserMessageFilter(IndexedDBMsgStart),
+      indexed_db_context_(indexed_db_context),
       ALLOW_THIS_IN_INITIALIZER_LIST(database_dispatcher_host_(
           new DatabaseDispatcherHost(this))),
       ALLOW_THIS_IN_INITIALIZER_LIST(index_dispatcher_host_(
@@ -9,7 +9,8 @@
 
 using content::BrowserThread;
 
-MimeRegistryMessageFilter::MimeRegistryMessageFilter() {
+MimeRegistryMessageFilter::MimeRegistryMessageFilter()
+    : BrowserMessageFilter(MimeRegistryMsgStart) {
 }
 
 MimeRegistryMessageFilter::~MimeRegistryMessageFilter() {
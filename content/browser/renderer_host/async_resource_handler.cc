@@ -13,8 +13,10 @@
 #include "base/shared_memory.h"
 #include "content/browser/debugger/devtools_netlog_observer.h"
 #include "content/browser/host_zoom_map_impl.h"
+#include "content/browser/renderer_host/resource_buffer.h"
 #include "content/browser/renderer_host/resource_dispatcher_host_impl.h"
 #include "content/browser/renderer_host/resource_message_filter.h"
+#include "content/browser/renderer_host/resource_request_info_impl.h"
 #include "content/browser/resource_context_impl.h"
 #include "content/common/resource_messages.h"
 #include "content/common/view_messages.h"
@@ -35,49 +37,40 @@ namespace {
 
 // When reading, we don't know if we are going to get EOF (0 bytes read), so
 // we typically have a buffer that we allocated but did not use.  We keep
-// this buffer around for the next read as a small optimization.
-SharedIOBuffer* g_spare_read_buffer = NULL;
+// this buffer around for the next request as a small optimization, as long
+// as it was never shared with a renderer.
+ResourceBuffer* g_spare_read_buffer = NULL;
 
-// The initial size of the shared memory buffer. (32 kilobytes).
-const int kInitialReadBufSize = 32768;
+// The initial size of the shared memory buffer. (128 kilobytes).
+const int kInitialBufferSize = 131072;
 
-// The maximum size of the shared memory buffer. (512 kilobytes).
-const int kMaxReadBufSize = 524288;
+// The maximum size of the shared memory buffer. (2 megabytes).
+const int kMaxBufferSize = 2097152;
 
-}  // namespace
+// The smallest read that is made into the buffer. (4 kilobytes).
+const int kMinReadSize = 4096;
+
+// A read takes at most this fraction of the buffer, so that the network can
+// keep filling it while the renderer works through the data already sent.
+// Reads start at 32 kilobytes, and grow with the buffer up to 512 kilobytes.
+const int kBufferToReadSizeRatio = 4;
 
-// Our version of IOBuffer that uses shared memory.
-class SharedIOBuffer : public net::IOBuffer {
+// An IOBuffer that points into a ResourceBuffer, and keeps it alive.
+class DependentIOBuffer : public net::WrappedIOBuffer {
  public:
-  explicit SharedIOBuffer(int buffer_size)
-      : net::IOBuffer(),
-        ok_(false),
-        buffer_size_(buffer_size) {}
-
-  bool Init() {
-    if (shared_memory_.CreateAndMapAnonymous(buffer_size_)) {
-      data_ = reinterpret_cast<char*>(shared_memory_.memory());
-      DCHECK(data_);
-      ok_ = true;
-    }
-    return ok_;
+  DependentIOBuffer(ResourceBuffer* backing, char* memory)
+      : net::WrappedIOBuffer(memory),
+        backing_(backing) {
   }
 
-  base::SharedMemory* shared_memory() { return &shared_memory_; }
-  bool ok() { return ok_; }
-  int buffer_size() { return buffer_size_; }
-
  private:
-  ~SharedIOBuffer() {
-    DCHECK(g_spare_read_buffer != this);
-    data_ = NULL;
-  }
+  virtual ~DependentIOBuffer() {}
 
-  base::SharedMemory shared_memory_;
-  bool ok_;
-  int buffer_size_;
+  scoped_refptr<ResourceBuffer> backing_;
 };
 
+}  // namespace
+
 AsyncResourceHandler::AsyncResourceHandler(
     ResourceMessageFilter* filter,
     int routing_id,
@@ -86,7 +79,13 @@ AsyncResourceHandler::AsyncResourceHandler(
     : filter_(filter),
       routing_id_(routing_id),
       rdh_(rdh),
-      next_buffer_size_(kInitialReadBufSize),
+      next_buffer_size_(kInitialBufferSize),
+      has_pending_read_(false),
+      sent_buffer_(false),
+      grow_buffer_(false),
+      old_buffer_messages_(0),
+      waiting_for_buffer_(false),
+      sent_paused_data_(false),
       url_(url) {
 }
 
@@ -173,70 +172,100 @@ bool AsyncResourceHandler::OnWillRead(int request_id, net::IOBuffer** buf,
                                       int* buf_size, int min_size) {
   DCHECK_EQ(-1, min_size);
 
-  if (g_spare_read_buffer) {
-    DCHECK(!read_buffer_);
-    read_buffer_.swap(&g_spare_read_buffer);
-    DCHECK(read_buffer_->data());
-
-    *buf = read_buffer_.get();
-    *buf_size = read_buffer_->buffer_size();
-  } else {
-    read_buffer_ = new SharedIOBuffer(next_buffer_size_);
-    if (!read_buffer_->Init()) {
-      DLOG(ERROR) << "Couldn't allocate shared io buffer";
-      read_buffer_ = NULL;
-      return false;
-    }
-    DCHECK(read_buffer_->data());
-    *buf = read_buffer_.get();
-    *buf_size = next_buffer_size_;
+  // Give back the previous read if it was never filled.
+  if (has_pending_read_) {
+    buffer_->ShrinkLastAllocation(0);
+    has_pending_read_ = false;
   }
 
+  if (!EnsureResourceBufferIsInitialized(request_id))
+    return false;
+
+  DCHECK(buffer_->CanAllocate());
+  char* memory = buffer_->Allocate(buf_size);
+  has_pending_read_ = true;
+
+  *buf = new DependentIOBuffer(buffer_, memory);
   return true;
 }
 
 bool AsyncResourceHandler::OnReadCompleted(int request_id, int* bytes_read) {
+  if (sent_paused_data_) {
+    // This read went out before the request was paused to wait for room in
+    // the buffer, and comes back now that the request is resumed.
+    sent_paused_data_ = false;
+    return true;
+  }
+
+  if (has_pending_read_) {
+    buffer_->ShrinkLastAllocation(*bytes_read);
+    has_pending_read_ = false;
+  }
+
   if (!*bytes_read)
     return true;
-  DCHECK(read_buffer_.get());
+  DCHECK(buffer_.get());
 
-  if (read_buffer_->buffer_size() == *bytes_read) {
-    // The network layer has saturated our buffer. Next time, we should give it
-    // a bigger buffer for it to fill, to minimize the number of round trips we
-    // do with the renderer process.
-    next_buffer_size_ = std::min(next_buffer_size_ * 2, kMaxReadBufSize);
+  if (!sent_buffer_) {
+    base::SharedMemoryHandle handle;
+    int size;
+    if (!buffer_->ShareToProcess(filter_->peer_handle(), &handle, &size))
+      return false;
+    filter_->Send(new ResourceMsg_SetDataBuffer(
+        routing_id_, request_id, handle, size));
+    sent_buffer_ = true;
   }
 
   if (!rdh_->WillSendData(filter_->child_id(), request_id)) {
     // We should not send this data now, we have too many pending requests.
+    // It stays in the buffer until then.
     return true;
   }
 
-  base::SharedMemoryHandle handle;
-  if (!read_buffer_->shared_memory()->GiveToProcess(
-          filter_->peer_handle(), &handle)) {
-    // We wrongfully incremented the pending data count. Fake an ACK message
-    // to fix this. We can't move this call above the WillSendData because
-    // it's killing our read_buffer_, and we don't want that when we pause
-    // the request.
-    rdh_->DataReceivedACK(filter_->child_id(), request_id);
-    // We just unmapped the memory.
-    read_buffer_ = NULL;
-    return false;
-  }
-  // We just unmapped the memory.
-  read_buffer_ = NULL;
-
   net::URLRequest* request = rdh_->GetURLRequest(
       GlobalRequestID(filter_->child_id(), request_id));
   int encoded_data_length =
       DevToolsNetLogObserver::GetAndResetEncodedDataLength(request);
   filter_->Send(new ResourceMsg_DataReceived(
-      routing_id_, request_id, handle, *bytes_read, encoded_data_length));
+      routing_id_, request_id, buffer_->GetLastAllocationOffset(),
+      *bytes_read, encoded_data_length));
+
+  if (!buffer_->CanAllocate()) {
+    if (buffer_->buffer_size() < kMaxBufferSize) {
+      // The network filled the buffer before the renderer could give any of
+      // it back. The next read goes into a bigger one, to minimize the number
+      // of round trips we wait for.
+      grow_buffer_ = true;
+    } else {
+      // Wait for the renderer to make room.
+      rdh_->PauseRequest(filter_->child_id(), request_id, true);
+      waiting_for_buffer_ = true;
+      sent_paused_data_ = true;
+    }
+  }
 
   return true;
 }
 
+void AsyncResourceHandler::OnDataReceivedACK(int request_id) {
+  if (old_buffer_messages_) {
+    // The data came from a buffer that was replaced by a bigger one.
+    old_buffer_messages_--;
+    return;
+  }
+
+  if (!buffer_.get() || buffer_->IsEmpty()) {
+    DLOG(WARNING) << "Unexpected DataReceived ACK";
+    return;
+  }
+  buffer_->RecycleLeastRecentlyAllocated();
+
+  if (waiting_for_buffer_ && buffer_->CanAllocate()) {
+    waiting_for_buffer_ = false;
+    rdh_->PauseRequest(filter_->child_id(), request_id, false);
+  }
+}
+
 void AsyncResourceHandler::OnDataDownloaded(
     int request_id, int bytes_downloaded) {
   filter_->Send(new ResourceMsg_DataDownloaded(
@@ -260,15 +289,16 @@ bool AsyncResourceHandler::OnResponseCompleted(
                                                 security_info,
                                                 completion_time));
 
-  // If we still have a read buffer, then see about caching it for later...
-  // Note that we have to make sure the buffer is not still being used, so we
-  // have to perform an explicit check on the status code.
-  if (g_spare_read_buffer ||
-      net::URLRequestStatus::SUCCESS != status.status()) {
-    read_buffer_ = NULL;
-  } else if (read_buffer_.get()) {
-    DCHECK(read_buffer_->data());
-    read_buffer_.swap(&g_spare_read_buffer);
+  // If we still have a buffer that the renderer never saw, then see about
+  // caching it for later... Note that we have to make sure the buffer is not
+  // still being used, so we have to perform an explicit check on the status
+  // code.
+  if (g_spare_read_buffer || sent_buffer_ || !buffer_.get() ||
+      net::URLRequestStatus::SUCCESS != status.status() ||
+      buffer_->buffer_size() != kInitialBufferSize || !buffer_->IsEmpty()) {
+    buffer_ = NULL;
+  } else {
+    buffer_.swap(&g_spare_read_buffer);
   }
   return true;
 }
@@ -279,11 +309,47 @@ void AsyncResourceHandler::OnRequestClosed() {
 // static
 void AsyncResourceHandler::GlobalCleanup() {
   if (g_spare_read_buffer) {
-    // Avoid the CHECK in SharedIOBuffer::~SharedIOBuffer().
-    SharedIOBuffer* tmp = g_spare_read_buffer;
+    ResourceBuffer* tmp = g_spare_read_buffer;
     g_spare_read_buffer = NULL;
     tmp->Release();
   }
 }
 
+bool AsyncResourceHandler::EnsureResourceBufferIsInitialized(int request_id) {
+  if (buffer_.get() && !grow_buffer_)
+    return true;
+
+  if (!buffer_.get() && !grow_buffer_) {
+    // Let the ResourceDispatcherHost tell us about the ACKs of our data.
+    net::URLRequest* request = rdh_->GetURLRequest(
+        GlobalRequestID(filter_->child_id(), request_id));
+    ResourceRequestInfoImpl::ForRequest(request)->set_async_handler(this);
+
+    if (g_spare_read_buffer) {
+      buffer_.swap(&g_spare_read_buffer);
+      return true;
+    }
+  }
+
+  if (grow_buffer_) {
+    // The renderer keeps the old buffer until it gets the new one, after the
+    // data still in flight; only the ACKs of that data need telling apart.
+    DCHECK(!has_pending_read_);
+    old_buffer_messages_ += buffer_->allocation_count();
+    next_buffer_size_ = std::min(buffer_->buffer_size() * 2, kMaxBufferSize);
+    buffer_ = NULL;
+    sent_buffer_ = false;
+    grow_buffer_ = false;
+  }
+
+  buffer_ = new ResourceBuffer();
+  if (!buffer_->Initialize(next_buffer_size_, kMinReadSize,
+                           next_buffer_size_ / kBufferToReadSizeRatio)) {
+    DLOG(ERROR) << "Couldn't allocate shared io buffer";
+    buffer_ = NULL;
+    return false;
+  }
+  return true;
+}
+
 }  // namespace content
@@ -14,11 +14,17 @@
 class ResourceMessageFilter;
 
 namespace content {
+class ResourceBuffer;
 class ResourceDispatcherHostImpl;
-class SharedIOBuffer;
 
 // Used to complete an asynchronous resource request in response to resource
 // load events from the resource dispatcher host.
+//
+// The response body is read into a ring of shared memory that the renderer
+// maps once, and each ResourceMsg_DataReceived points into it. The space that
+// the renderer gives back with its ACKs is what the following reads can use,
+// so the browser stays several reads ahead of the renderer, and only waits
+// once the whole ring is in flight.
 class AsyncResourceHandler : public ResourceHandler {
  public:
   AsyncResourceHandler(ResourceMessageFilter* filter,
@@ -52,23 +58,51 @@ class AsyncResourceHandler : public ResourceHandler {
   virtual void OnDataDownloaded(int request_id,
                                 int bytes_downloaded) OVERRIDE;
 
+  // Called when the renderer is done with the data of one
+  // ResourceMsg_DataReceived.
+  void OnDataReceivedACK(int request_id);
+
   static void GlobalCleanup();
 
  private:
   virtual ~AsyncResourceHandler();
 
-  scoped_refptr<SharedIOBuffer> read_buffer_;
+  // Makes sure |buffer_| is ready for the next read, replacing it with a
+  // bigger one if it was outgrown.
+  bool EnsureResourceBufferIsInitialized(int request_id);
+
+  scoped_refptr<ResourceBuffer> buffer_;
   scoped_refptr<ResourceMessageFilter> filter_;
   int routing_id_;
   ResourceDispatcherHostImpl* rdh_;
 
-  // |next_buffer_size_| is the size of the buffer to be allocated on the next
-  // OnWillRead() call.  We exponentially grow the size of the buffer allocated
-  // when our owner fills our buffers. On the first OnWillRead() call, we
-  // allocate a buffer of 32k and double it in OnReadCompleted() if the buffer
-  // was filled, up to a maximum size of 512k.
+  // |next_buffer_size_| is the size of the buffer to be allocated when we
+  // need a new one. We exponentially grow the size of the buffer when the
+  // network fills it up before the renderer gives any room back, which is
+  // what a high throughput looks like from here. We start with a buffer of
+  // 128k, and double it up to a maximum size of 2M.
   int next_buffer_size_;
 
+  // Whether the network is reading into the last allocation of |buffer_|.
+  bool has_pending_read_;
+
+  // Whether the renderer was sent |buffer_|.
+  bool sent_buffer_;
+
+  // Whether the next read should go into a bigger buffer.
+  bool grow_buffer_;
+
+  // The number of data messages sent out of buffers that were replaced and
+  // that are not acknowledged yet. Their ACKs don't make room in |buffer_|.
+  int old_buffer_messages_;
+
+  // Whether the request is paused until the renderer makes room in |buffer_|.
+  bool waiting_for_buffer_;
+
+  // Whether the read that filled |buffer_| was sent before the request was
+  // paused; the ResourceDispatcherHost completes it again once resumed.
+  bool sent_paused_data_;
+
   // TODO(battre): Remove url. This is only for debugging
   // http://crbug.com/107692.
   GURL url_;
@@ -44,7 +44,7 @@ const size_t kSmallThreshold = 4 * 32 * 1920;
 // TODO(erikkay) 32bpp assumption isn't great.
 const size_t kMemoryMultiplier = 4 * 1920 * 1200;  // ~9MB
 
-// The maximum number of large BackingStoreCache objects (tabs) to use.
+// The number of large monitors' worth of backing stores (tabs) to keep.
 // Use a minimum of 2, and add one for each 256MB of physical memory you have.
 // Cap at 5, the thinking being that even if you have a gigantic amount of
 // RAM, there's a limit to how much caching helps beyond a certain number
@@ -135,18 +135,11 @@ BackingStore* CreateBackingStore(RenderWidgetHost* host,
   }
   DCHECK((BackingStoreManager::MemorySize() + new_mem) <= max_mem);
 
-  BackingStoreCache* cache;
-  if (new_mem > kSmallThreshold) {
-    // Limit the number of large backing stores (tabs) to the memory tier number
-    // (between 2-5). While we allow a larger amount of memory for people who
-    // have large windows, this means that those who use small browser windows
-    // won't ever cache more than 5 tabs, so they pay a smaller memory cost.
-    if (large_cache->size() >= MaxNumberOfBackingStores())
-      ExpireLastBackingStore(large_cache);
-    cache = large_cache;
-  } else {
-    cache = small_cache;
-  }
+  // Only the memory used is limited, not the number of backing stores, so
+  // people who use small browser windows get more tabs cached in the same
+  // amount of memory and don't have to wait for them to repaint.
+  BackingStoreCache* cache =
+      new_mem > kSmallThreshold ? large_cache : small_cache;
   BackingStore* backing_store = content::RenderWidgetHostImpl::From(
       host)->AllocBackingStore(backing_store_size);
   if (backing_store)
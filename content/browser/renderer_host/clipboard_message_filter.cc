@@ -34,7 +34,8 @@ void WriteObjectsHelper(const ui::Clipboard::ObjectMap* objects) {
 
 }  // namespace
 
-ClipboardMessageFilter::ClipboardMessageFilter() {
+ClipboardMessageFilter::ClipboardMessageFilter()
+    : BrowserMessageFilter(ClipboardMsgStart) {
 }
 
 void ClipboardMessageFilter::OverrideThreadForMessage(
@@ -11,7 +11,8 @@
 using content::BrowserThread;
 
 FileUtilitiesMessageFilter::FileUtilitiesMessageFilter(int process_id)
-    : process_id_(process_id) {
+    : BrowserMessageFilter(FileUtilitiesMsgStart),
+      process_id_(process_id) {
 }
 
 FileUtilitiesMessageFilter::~FileUtilitiesMessageFilter() {
@@ -13,7 +13,8 @@ namespace content {
 
 GamepadBrowserMessageFilter::GamepadBrowserMessageFilter(
     content::RenderProcessHost* render_process_host)
-    : render_process_host_(render_process_host) {
+    : BrowserMessageFilter(GamepadMsgStart),
+      render_process_host_(render_process_host) {
 }
 
 GamepadBrowserMessageFilter::~GamepadBrowserMessageFilter() {
@@ -36,7 +36,8 @@ struct GpuMessageFilter::CreateViewCommandBufferRequest {
 
 GpuMessageFilter::GpuMessageFilter(int render_process_id,
                                    RenderWidgetHelper* render_widget_helper)
-    : gpu_process_id_(0),
+    : BrowserMessageFilter(GpuMsgStart),
+      gpu_process_id_(0),
       render_process_id_(render_process_id),
       share_contexts_(false),
       render_widget_helper_(render_widget_helper) {
@@ -26,7 +26,8 @@ AudioInputRendererHost::AudioEntry::~AudioEntry() {}
 AudioInputRendererHost::AudioInputRendererHost(
     content::ResourceContext* resource_context,
     media::AudioManager* audio_manager)
-    : resource_context_(resource_context),
+    : BrowserMessageFilter(AudioMsgStart),
+      resource_context_(resource_context),
       audio_manager_(audio_manager) {
 }
 
@@ -29,7 +29,8 @@ AudioRendererHost::AudioEntry::~AudioEntry() {}
 AudioRendererHost::AudioRendererHost(
     media::AudioManager* audio_manager,
     content::MediaObserver* media_observer)
-    : audio_manager_(audio_manager),
+    : BrowserMessageFilter(AudioMsgStart),
+      audio_manager_(audio_manager),
       media_observer_(media_observer) {
 }
 
@@ -27,7 +27,8 @@ MediaStreamDispatcherHost::MediaStreamDispatcherHost(
     content::ResourceContext* resource_context,
     int render_process_id,
     media::AudioManager* audio_manager)
-    : resource_context_(resource_context),
+    : BrowserMessageFilter(MediaStreamMsgStart),
+      resource_context_(resource_context),
       render_process_id_(render_process_id),
       audio_manager_(audio_manager) {
 }
@@ -39,7 +39,8 @@ struct VideoCaptureHost::Entry {
 
 VideoCaptureHost::VideoCaptureHost(content::ResourceContext* resource_context,
                                    media::AudioManager* audio_manager)
-    : resource_context_(resource_context),
+    : BrowserMessageFilter(VideoCaptureMsgStart),
+      resource_context_(resource_context),
       audio_manager_(audio_manager) {
 }
 
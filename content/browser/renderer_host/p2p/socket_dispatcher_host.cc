@@ -102,7 +102,8 @@ class P2PSocketDispatcherHost::DnsRequest {
 
 P2PSocketDispatcherHost::P2PSocketDispatcherHost(
     content::ResourceContext* resource_context)
-    : resource_context_(resource_context),
+    : BrowserMessageFilter(P2PMsgStart),
+      resource_context_(resource_context),
       monitoring_networks_(false) {
 }
 
@@ -35,7 +35,11 @@ P2PSocketHostUdp::P2PSocketHostUdp(IPC::Message::Sender* message_sender,
     : P2PSocketHost(message_sender, routing_id, id),
       socket_(new net::UDPServerSocket(NULL, net::NetLog::Source())),
       send_queue_bytes_(0),
-      send_pending_(false) {
+      send_pending_(false),
+      ALLOW_THIS_IN_INITIALIZER_LIST(recv_callback_(
+          base::Bind(&P2PSocketHostUdp::OnRecv, base::Unretained(this)))),
+      ALLOW_THIS_IN_INITIALIZER_LIST(send_callback_(
+          base::Bind(&P2PSocketHostUdp::OnSend, base::Unretained(this)))) {
 }
 
 P2PSocketHostUdp::~P2PSocketHostUdp() {
@@ -90,8 +94,7 @@ void P2PSocketHostUdp::DoRead() {
   int result;
   do {
     result = socket_->RecvFrom(recv_buffer_, kReadBufferSize, &recv_address_,
-                               base::Bind(&P2PSocketHostUdp::OnRecv,
-                                          base::Unretained(this)));
+                               recv_callback_);
     DidCompleteRead(result);
   } while (result > 0);
 }
@@ -165,8 +168,7 @@ void P2PSocketHostUdp::Send(const net::IPEndPoint& to,
 
 void P2PSocketHostUdp::DoSend(const PendingPacket& packet) {
   int result = socket_->SendTo(packet.data, packet.size, packet.to,
-                               base::Bind(&P2PSocketHostUdp::OnSend,
-                                          base::Unretained(this)));
+                               send_callback_);
   if (result == net::ERR_IO_PENDING) {
     send_pending_ = true;
   } else if (result < 0) {
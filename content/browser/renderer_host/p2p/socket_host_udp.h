@@ -16,6 +16,7 @@
 #include "content/browser/renderer_host/p2p/socket_host.h"
 #include "content/common/content_export.h"
 #include "content/common/p2p_sockets.h"
+#include "net/base/completion_callback.h"
 #include "net/base/ip_endpoint.h"
 #include "net/udp/udp_server_socket.h"
 
@@ -69,6 +70,10 @@ class CONTENT_EXPORT P2PSocketHostUdp : public P2PSocketHost {
   // response or relay allocation request or response.
   ConnectedPeerSet connected_peers_;
 
+  // Bound once rather than for every packet.
+  net::CompletionCallback recv_callback_;
+  net::CompletionCallback send_callback_;
+
   DISALLOW_COPY_AND_ASSIGN(P2PSocketHostUdp);
 };
 
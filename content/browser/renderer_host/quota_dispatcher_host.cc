@@ -201,7 +201,8 @@ QuotaDispatcherHost::QuotaDispatcherHost(
     int process_id,
     QuotaManager* quota_manager,
     QuotaPermissionContext* permission_context)
-    : process_id_(process_id),
+    : BrowserMessageFilter(QuotaMsgStart),
+      process_id_(process_id),
       quota_manager_(quota_manager),
       permission_context_(permission_context) {
 }
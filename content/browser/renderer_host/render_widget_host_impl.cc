@@ -23,11 +23,13 @@
 #include "content/browser/renderer_host/render_process_host_impl.h"
 #include "content/browser/renderer_host/render_view_host_impl.h"
 #include "content/browser/renderer_host/render_widget_helper.h"
+#include "content/browser/renderer_host/resource_dispatcher_host_impl.h"
 #include "content/browser/renderer_host/tap_suppression_controller.h"
 #include "content/common/accessibility_messages.h"
 #include "content/common/gpu/gpu_messages.h"
 #include "content/common/view_messages.h"
 #include "content/port/browser/render_widget_host_view_port.h"
+#include "content/public/browser/browser_thread.h"
 #include "content/public/browser/native_web_keyboard_event.h"
 #include "content/public/browser/notification_service.h"
 #include "content/public/browser/notification_types.h"
@@ -81,6 +83,21 @@ bool ShouldCoalesceMouseWheelEvents(const WebMouseWheelEvent& last_event,
          last_event.momentumPhase == new_event.momentumPhase;
 }
 
+// Lets the ResourceDispatcherHostImpl schedule the requests of the widget
+// |child_id|, |route_id| according to its visibility.
+void NotifyResourceDispatcherOfVisibility(int child_id, int route_id,
+                                          bool visible) {
+  content::ResourceDispatcherHostImpl* rdh =
+      content::ResourceDispatcherHostImpl::Get();
+  if (!rdh)  // NULL in unittests.
+    return;
+
+  content::BrowserThread::PostTask(
+      content::BrowserThread::IO, FROM_HERE,
+      base::Bind(&content::ResourceDispatcherHostImpl::OnVisibilityChanged,
+                 base::Unretained(rdh), child_id, route_id, visible));
+}
+
 }  // namespace
 
 namespace content {
@@ -115,6 +132,7 @@ RenderWidgetHostImpl::RenderWidgetHostImpl(RenderProcessHost* process,
       should_auto_resize_(false),
       mouse_move_pending_(false),
       mouse_wheel_pending_(false),
+      gesture_scroll_update_pending_(false),
       needs_repainting_on_restore_(false),
       is_unresponsive_(false),
       in_flight_event_count_(0),
@@ -335,6 +353,7 @@ void RenderWidgetHostImpl::WasHidden() {
 
   // Tell the RenderProcessHost we were hidden.
   process_->WidgetHidden();
+  NotifyResourceDispatcherOfVisibility(process_->GetID(), routing_id_, false);
 
   bool is_visible = false;
   NotificationService::current()->Notify(
@@ -365,6 +384,7 @@ void RenderWidgetHostImpl::WasRestored() {
   Send(new ViewMsg_WasRestored(routing_id_, needs_repainting));
 
   process_->WidgetRestored();
+  NotifyResourceDispatcherOfVisibility(process_->GetID(), routing_id_, true);
 
   bool is_visible = true;
   NotificationService::current()->Notify(
@@ -841,6 +861,33 @@ void RenderWidgetHostImpl::ForwardGestureEvent(
   if (ignore_input_events_ || process_->IgnoreInputEvents())
     return;
 
+  // Like mouse wheel events, scroll updates that arrive while one is waiting
+  // for its ack are coalesced by accumulating their deltas. The other gesture
+  // events are queued behind them so that they keep their order.
+  if (gesture_scroll_update_pending_) {
+    if (gesture_event.type == WebInputEvent::GestureScrollUpdate &&
+        !coalesced_gesture_events_.empty() &&
+        coalesced_gesture_events_.back().type ==
+            WebInputEvent::GestureScrollUpdate &&
+        coalesced_gesture_events_.back().modifiers ==
+            gesture_event.modifiers) {
+      WebGestureEvent* last_gesture_event = &coalesced_gesture_events_.back();
+      last_gesture_event->deltaX += gesture_event.deltaX;
+      last_gesture_event->deltaY += gesture_event.deltaY;
+      DCHECK_GE(gesture_event.timeStampSeconds,
+                last_gesture_event->timeStampSeconds);
+      last_gesture_event->timeStampSeconds = gesture_event.timeStampSeconds;
+    } else {
+      coalesced_gesture_events_.push_back(gesture_event);
+    }
+    return;
+  }
+  if (gesture_event.type == WebInputEvent::GestureScrollUpdate) {
+    gesture_scroll_update_pending_ = true;
+    HISTOGRAM_COUNTS_100("MPArch.RWH_GestureQueueSize",
+                         coalesced_gesture_events_.size());
+  }
+
   if (gesture_event.type == WebInputEvent::GestureFlingCancel)
     tap_suppression_controller_->GestureFlingCancel(
         gesture_event.timeStampSeconds);
@@ -987,6 +1034,8 @@ void RenderWidgetHostImpl::RendererExited(base::TerminationStatus status,
   next_mouse_move_.reset();
   mouse_wheel_pending_ = false;
   coalesced_mouse_wheel_events_.clear();
+  gesture_scroll_update_pending_ = false;
+  coalesced_gesture_events_.clear();
 
   // Must reset these to ensure that keyboard events work with a new renderer.
   key_queue_.clear();
@@ -1423,6 +1472,8 @@ void RenderWidgetHostImpl::OnMsgInputEventAck(WebInputEvent::Type event_type,
     ProcessWheelAck(processed);
   } else if (WebInputEvent::isTouchEventType(type)) {
     ProcessTouchAck(event_type, processed);
+  } else if (type == WebInputEvent::GestureScrollUpdate) {
+    ProcessGestureScrollUpdateAck();
   } else if (type == WebInputEvent::GestureFlingCancel) {
     tap_suppression_controller_->GestureFlingCancelAck(processed);
   }
@@ -1455,6 +1506,19 @@ void RenderWidgetHostImpl::ProcessWheelAck(bool processed) {
     view_->UnhandledWheelEvent(current_wheel_event_);
 }
 
+void RenderWidgetHostImpl::ProcessGestureScrollUpdateAck() {
+  gesture_scroll_update_pending_ = false;
+
+  // Send the queued gesture events up to and including the next scroll
+  // update, which has to wait for its own ack.
+  while (!gesture_scroll_update_pending_ &&
+         !coalesced_gesture_events_.empty()) {
+    WebGestureEvent next_gesture_event = coalesced_gesture_events_.front();
+    coalesced_gesture_events_.pop_front();
+    ForwardGestureEvent(next_gesture_event);
+  }
+}
+
 void RenderWidgetHostImpl::ProcessTouchAck(
     WebInputEvent::Type type, bool processed) {
   if (view_)
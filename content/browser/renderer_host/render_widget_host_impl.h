@@ -555,6 +555,10 @@ class CONTENT_EXPORT RenderWidgetHostImpl : virtual public RenderWidgetHost,
   // input messages to be coalesced.
   void ProcessWheelAck(bool processed);
 
+  // Called by OnMsgInputEventAck() to process a gesture scroll update ack
+  // message. This sends the gesture events queued behind the scroll update.
+  void ProcessGestureScrollUpdateAck();
+
   // Called on OnMsgInputEventAck() to process a touch event ack message.
   // This can result in a gesture event being generated and sent back to the
   // renderer.
@@ -637,6 +641,17 @@ class CONTENT_EXPORT RenderWidgetHostImpl : virtual public RenderWidgetHost,
   // would be queued) results in very slow scrolling.
   WheelEventQueue coalesced_mouse_wheel_events_;
 
+  // (Similar to |mouse_wheel_pending_|.) True if a gesture scroll update was
+  // sent and we are waiting for a corresponding ack.
+  bool gesture_scroll_update_pending_;
+
+  typedef std::deque<WebKit::WebGestureEvent> GestureEventQueue;
+
+  // The gesture events received while a scroll update is pending. A scroll
+  // update is coalesced into the previous event if that is a scroll update
+  // with the same modifiers, the way mouse wheel events are.
+  GestureEventQueue coalesced_gesture_events_;
+
   // The time when an input event was sent to the RenderWidget.
   base::TimeTicks input_event_start_time_;
 
@@ -32,6 +32,7 @@ using content::BrowserThreadImpl;
 using content::MockRenderProcessHost;
 using content::RenderWidgetHost;
 using content::RenderWidgetHostImpl;
+using WebKit::WebGestureEvent;
 using WebKit::WebInputEvent;
 using WebKit::WebMouseWheelEvent;
 
@@ -316,6 +317,18 @@ class RenderWidgetHostTest : public testing::Test {
     host_->ForwardWheelEvent(wheel_event);
   }
 
+  void SimulateGestureEvent(WebInputEvent::Type type,
+                            float dX,
+                            float dY,
+                            int modifiers) {
+    WebGestureEvent gesture_event;
+    gesture_event.type = type;
+    gesture_event.deltaX = dX;
+    gesture_event.deltaY = dY;
+    gesture_event.modifiers = modifiers;
+    host_->ForwardGestureEvent(gesture_event);
+  }
+
   MessageLoopForUI message_loop_;
 
   scoped_ptr<TestBrowserContext> browser_context_;
@@ -746,6 +759,48 @@ TEST_F(RenderWidgetHostTest, CoalescesWheelEvents) {
   EXPECT_EQ(0U, process_->sink().message_count());
 }
 
+TEST_F(RenderWidgetHostTest, CoalescesGestureScrollUpdates) {
+  process_->sink().ClearMessages();
+
+  // Simulate gesture events. The first is sent directly, the third is
+  // coalesced into the second, the fourth has different modifiers and the
+  // scroll end is queued behind them.
+  SimulateGestureEvent(WebInputEvent::GestureScrollUpdate, 0, -5, 0);
+  SimulateGestureEvent(WebInputEvent::GestureScrollUpdate, 0, -10, 0);
+  SimulateGestureEvent(WebInputEvent::GestureScrollUpdate, 8, -6, 0);
+  SimulateGestureEvent(WebInputEvent::GestureScrollUpdate, 9, -7, 1);
+  SimulateGestureEvent(WebInputEvent::GestureScrollEnd, 0, 0, 0);
+
+  // Check that only the first event was sent.
+  EXPECT_EQ(1U, process_->sink().message_count());
+  EXPECT_TRUE(process_->sink().GetUniqueMessageMatching(
+                  ViewMsg_HandleInputEvent::ID));
+  process_->sink().ClearMessages();
+
+  // Check that the ACK sends the coalesced scroll update.
+  SendInputEventACK(WebInputEvent::GestureScrollUpdate, true);
+  EXPECT_EQ(1U, process_->sink().message_count());
+  EXPECT_TRUE(process_->sink().GetUniqueMessageMatching(
+                  ViewMsg_HandleInputEvent::ID));
+  process_->sink().ClearMessages();
+
+  // One more time.
+  SendInputEventACK(WebInputEvent::GestureScrollUpdate, true);
+  EXPECT_EQ(1U, process_->sink().message_count());
+  EXPECT_TRUE(process_->sink().GetUniqueMessageMatching(
+                  ViewMsg_HandleInputEvent::ID));
+  process_->sink().ClearMessages();
+
+  // The scroll end is sent once the last scroll update is acked.
+  SendInputEventACK(WebInputEvent::GestureScrollUpdate, true);
+  EXPECT_EQ(1U, process_->sink().message_count());
+  process_->sink().ClearMessages();
+
+  // After the final ack, the queue should be empty.
+  SendInputEventACK(WebInputEvent::GestureScrollEnd, true);
+  EXPECT_EQ(0U, process_->sink().message_count());
+}
+
 // Test that the hang monitor timer expires properly if a new timer is started
 // while one is in progress (see crbug.com/11007).
 TEST_F(RenderWidgetHostTest, DontPostponeHangMonitorTimeout) {
@@ -0,0 +1,139 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/resource_buffer.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace content {
+
+ResourceBuffer::ResourceBuffer()
+    : buf_size_(0),
+      min_alloc_size_(0),
+      max_alloc_size_(0),
+      alloc_start_(-1),
+      alloc_end_(-1) {
+}
+
+ResourceBuffer::~ResourceBuffer() {
+}
+
+bool ResourceBuffer::Initialize(int buffer_size,
+                                int min_allocation_size,
+                                int max_allocation_size) {
+  DCHECK(!IsInitialized());
+  DCHECK_GT(min_allocation_size, 0);
+  DCHECK_LE(min_allocation_size, max_allocation_size);
+  DCHECK_LE(max_allocation_size, buffer_size);
+
+  if (!shared_mem_.CreateAndMapAnonymous(buffer_size))
+    return false;
+
+  buf_size_ = buffer_size;
+  min_alloc_size_ = min_allocation_size;
+  max_alloc_size_ = max_allocation_size;
+  return true;
+}
+
+bool ResourceBuffer::IsInitialized() const {
+  return shared_mem_.memory() != NULL;
+}
+
+bool ResourceBuffer::ShareToProcess(
+    base::ProcessHandle process,
+    base::SharedMemoryHandle* shared_memory_handle,
+    int* shared_memory_size) {
+  DCHECK(IsInitialized());
+
+  if (!shared_mem_.ShareToProcess(process, shared_memory_handle))
+    return false;
+
+  *shared_memory_size = buf_size_;
+  return true;
+}
+
+bool ResourceBuffer::CanAllocate() const {
+  DCHECK(IsInitialized());
+
+  if (IsEmpty())
+    return true;
+
+  if (alloc_start_ < alloc_end_) {
+    // There is room either after the last allocation, or before the first.
+    return buf_size_ - alloc_end_ >= min_alloc_size_ ||
+           alloc_start_ >= min_alloc_size_;
+  }
+
+  // The allocations wrap around, so the free space is in the middle.
+  return alloc_start_ - alloc_end_ >= min_alloc_size_;
+}
+
+char* ResourceBuffer::Allocate(int* size) {
+  DCHECK(CanAllocate());
+
+  int offset;
+  if (IsEmpty()) {
+    alloc_start_ = 0;
+    offset = 0;
+    *size = buf_size_;
+  } else if (alloc_start_ < alloc_end_) {
+    if (buf_size_ - alloc_end_ >= min_alloc_size_) {
+      offset = alloc_end_;
+      *size = buf_size_ - alloc_end_;
+    } else {
+      // Wrap around. The tail is too small to be used, so it is given back
+      // together with the allocation before it.
+      alloc_sizes_.back() += buf_size_ - alloc_end_;
+      offset = 0;
+      *size = alloc_start_;
+    }
+  } else {
+    offset = alloc_end_;
+    *size = alloc_start_ - alloc_end_;
+  }
+
+  *size = std::min(*size, max_alloc_size_);
+  alloc_end_ = offset + *size;
+  alloc_sizes_.push_back(*size);
+
+  return static_cast<char*>(shared_mem_.memory()) + offset;
+}
+
+int ResourceBuffer::GetLastAllocationOffset() const {
+  DCHECK(!IsEmpty());
+  return alloc_end_ - alloc_sizes_.back();
+}
+
+void ResourceBuffer::ShrinkLastAllocation(int new_size) {
+  DCHECK(!IsEmpty());
+  DCHECK_GE(new_size, 0);
+  DCHECK_LE(new_size, alloc_sizes_.back());
+
+  alloc_end_ -= alloc_sizes_.back() - new_size;
+  alloc_sizes_.back() = new_size;
+
+  if (!new_size) {
+    alloc_sizes_.pop_back();
+    if (IsEmpty())
+      alloc_start_ = alloc_end_ = -1;
+  }
+}
+
+void ResourceBuffer::RecycleLeastRecentlyAllocated() {
+  DCHECK(!IsEmpty());
+
+  alloc_start_ += alloc_sizes_.front();
+  alloc_sizes_.pop_front();
+  DCHECK_LE(alloc_start_, buf_size_);
+
+  if (IsEmpty()) {
+    alloc_start_ = alloc_end_ = -1;
+  } else if (alloc_start_ == buf_size_) {
+    alloc_start_ = 0;
+  }
+}
+
+}  // namespace content
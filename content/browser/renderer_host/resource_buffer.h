@@ -0,0 +1,99 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_RENDERER_HOST_RESOURCE_BUFFER_H_
+#define CONTENT_BROWSER_RENDERER_HOST_RESOURCE_BUFFER_H_
+#pragma once
+
+#include <deque>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/process.h"
+#include "base/shared_memory.h"
+#include "content/common/content_export.h"
+
+namespace content {
+
+// A ring of shared memory that a response body is read into, and that is
+// shared with the renderer once for the whole request. Reads get the largest
+// contiguous piece of free memory, up to a limit, and the pieces are given
+// back in the order they were handed out, as the renderer acknowledges them:
+//
+//   Allocate()  -->  data is written  -->  ShrinkLastAllocation()
+//       ...                                  (sent to the renderer)
+//   RecycleLeastRecentlyAllocated()  <--  the renderer is done with it
+//
+// The free memory is the credit that the renderer hands back to the browser:
+// once there is no room for a read of at least the minimum size, the request
+// has to wait for the renderer to catch up. Lives on the IO thread; it is
+// reference counted so that the buffers given to the network stack can keep
+// it alive.
+class CONTENT_EXPORT ResourceBuffer : public base::RefCounted<ResourceBuffer> {
+ public:
+  ResourceBuffer();
+
+  // Creates a ring of |buffer_size| bytes. Allocations are at least
+  // |min_allocation_size| and at most |max_allocation_size| bytes long.
+  bool Initialize(int buffer_size,
+                  int min_allocation_size,
+                  int max_allocation_size);
+  bool IsInitialized() const;
+
+  // Shares the ring with |process|.
+  bool ShareToProcess(base::ProcessHandle process,
+                      base::SharedMemoryHandle* shared_memory_handle,
+                      int* shared_memory_size);
+
+  // Returns true if there is room for an allocation of the minimum size.
+  bool CanAllocate() const;
+
+  // Returns the next allocation, and sets |size| to its length. CanAllocate()
+  // must be true.
+  char* Allocate(int* size);
+
+  // Returns the offset of the last allocation from the start of the ring.
+  int GetLastAllocationOffset() const;
+
+  // Gives the tail of the last allocation back, keeping its first |new_size|
+  // bytes. The allocation goes away if |new_size| is zero.
+  void ShrinkLastAllocation(int new_size);
+
+  // Gives the oldest allocation back.
+  void RecycleLeastRecentlyAllocated();
+
+  // Returns true if the ring holds no allocations.
+  bool IsEmpty() const { return alloc_sizes_.empty(); }
+
+  int allocation_count() const { return static_cast<int>(alloc_sizes_.size()); }
+
+  int buffer_size() const { return buf_size_; }
+
+ private:
+  friend class base::RefCounted<ResourceBuffer>;
+  ~ResourceBuffer();
+
+  base::SharedMemory shared_mem_;
+
+  int buf_size_;
+  int min_alloc_size_;
+  int max_alloc_size_;
+
+  // The allocations live in [alloc_start_, alloc_end_), which wraps around
+  // the end of the ring when alloc_end_ <= alloc_start_. Both are -1 when the
+  // ring is empty.
+  int alloc_start_;
+  int alloc_end_;
+
+  // The size of each allocation, oldest first. When an allocation wraps
+  // around, the unused tail of the ring is counted as part of the previous
+  // one.
+  std::deque<int> alloc_sizes_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceBuffer);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_RENDERER_HOST_RESOURCE_BUFFER_H_
@@ -0,0 +1,99 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/resource_buffer.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+
+TEST(ResourceBufferTest, BasicAllocations) {
+  scoped_refptr<ResourceBuffer> buf = new ResourceBuffer();
+  EXPECT_TRUE(buf->Initialize(100, 5, 20));
+  EXPECT_TRUE(buf->CanAllocate());
+  EXPECT_TRUE(buf->IsEmpty());
+
+  for (int i = 0; i < 5; ++i) {
+    int size;
+    char* ptr = buf->Allocate(&size);
+    EXPECT_TRUE(ptr);
+    EXPECT_EQ(20, size);
+    EXPECT_EQ(i * 20, buf->GetLastAllocationOffset());
+  }
+
+  // The ring is full.
+  EXPECT_FALSE(buf->CanAllocate());
+  EXPECT_FALSE(buf->IsEmpty());
+
+  for (int i = 0; i < 5; ++i)
+    buf->RecycleLeastRecentlyAllocated();
+  EXPECT_TRUE(buf->IsEmpty());
+  EXPECT_TRUE(buf->CanAllocate());
+}
+
+TEST(ResourceBufferTest, ShrinkLastAllocation) {
+  scoped_refptr<ResourceBuffer> buf = new ResourceBuffer();
+  EXPECT_TRUE(buf->Initialize(100, 5, 20));
+
+  int size;
+  buf->Allocate(&size);
+  EXPECT_EQ(20, size);
+  buf->ShrinkLastAllocation(8);
+
+  buf->Allocate(&size);
+  EXPECT_EQ(20, size);
+  EXPECT_EQ(8, buf->GetLastAllocationOffset());
+
+  // An empty read gives the whole allocation back.
+  buf->ShrinkLastAllocation(0);
+  buf->Allocate(&size);
+  EXPECT_EQ(8, buf->GetLastAllocationOffset());
+
+  buf->ShrinkLastAllocation(0);
+  buf->RecycleLeastRecentlyAllocated();
+  EXPECT_TRUE(buf->IsEmpty());
+}
+
+TEST(ResourceBufferTest, WrapAround) {
+  scoped_refptr<ResourceBuffer> buf = new ResourceBuffer();
+  EXPECT_TRUE(buf->Initialize(100, 10, 40));
+
+  int size;
+  buf->Allocate(&size);  // [0, 40)
+  buf->Allocate(&size);  // [40, 80)
+  buf->Allocate(&size);  // [80, 100)
+  EXPECT_EQ(20, size);
+  buf->ShrinkLastAllocation(15);  // [80, 95)
+
+  // The 5 bytes at the end are too small, and there is nothing before the
+  // first allocation.
+  EXPECT_FALSE(buf->CanAllocate());
+
+  // Once the first allocation is given back, the next one wraps around.
+  buf->RecycleLeastRecentlyAllocated();
+  EXPECT_TRUE(buf->CanAllocate());
+  buf->Allocate(&size);
+  EXPECT_EQ(40, size);
+  EXPECT_EQ(0, buf->GetLastAllocationOffset());
+  EXPECT_FALSE(buf->CanAllocate());
+
+  buf->RecycleLeastRecentlyAllocated();
+  buf->Allocate(&size);
+  EXPECT_EQ(40, size);
+  EXPECT_EQ(40, buf->GetLastAllocationOffset());
+
+  // The unused tail is given back with the allocation before the wrap.
+  buf->RecycleLeastRecentlyAllocated();
+  EXPECT_TRUE(buf->CanAllocate());
+  buf->Allocate(&size);
+  EXPECT_EQ(20, size);
+  EXPECT_EQ(80, buf->GetLastAllocationOffset());
+
+  buf->RecycleLeastRecentlyAllocated();
+  buf->RecycleLeastRecentlyAllocated();
+  buf->RecycleLeastRecentlyAllocated();
+  EXPECT_TRUE(buf->IsEmpty());
+}
+
+}  // namespace content
@@ -326,7 +326,8 @@ ResourceDispatcherHostImpl::ResourceDispatcherHostImpl()
           kMaxOutstandingRequestsCostPerProcess),
       filter_(NULL),
       delegate_(NULL),
-      allow_cross_origin_auth_prompt_(false) {
+      allow_cross_origin_auth_prompt_(false),
+      scheduler_(new ResourceScheduler()) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
   DCHECK(!g_resource_dispatcher_host);
   g_resource_dispatcher_host = this;
@@ -978,6 +979,10 @@ void ResourceDispatcherHostImpl::DataReceivedACK(int child_id,
   // Decrement the number of pending data messages.
   info->DecrementPendingDataCount();
 
+  // Let the handler reuse the buffer space of the data.
+  if (info->async_handler())
+    info->async_handler()->OnDataReceivedACK(request_id);
+
   // If the pending data count was higher than the max, resume the request.
   if (info->pending_data_count() == kMaxPendingDataMessages) {
     // Decrement the pending data count one more time because we also
@@ -1371,6 +1376,8 @@ void ResourceDispatcherHostImpl::CancelRequestsForRoute(int child_id,
       CancelBlockedRequestsForRoute(child_id, *iter);
     }
   }
+
+  scheduler_->OnRouteDeleted(child_id, route_id);
 }
 
 // Cancels the request and removes it from the list.
@@ -1403,8 +1410,13 @@ void ResourceDispatcherHostImpl::RemovePendingRequest(
   transferred_navigations_.erase(
       GlobalRequestID(info->GetChildID(), info->GetRequestID()));
 
+  // Removing the request may let another one start.
+  ResourceScheduler::RequestList ready;
+  scheduler_->RemoveRequest(iter->second, &ready);
+
   delete iter->second;
   pending_requests_.erase(iter);
+  StartScheduledRequests(ready);
 
   // If we have no more pending requests, then stop the load state monitor
   if (pending_requests_.empty() && update_load_states_timer_.get())
@@ -1767,6 +1779,15 @@ void ResourceDispatcherHostImpl::BeginRequestInternal(
 }
 
 void ResourceDispatcherHostImpl::StartRequest(net::URLRequest* request) {
+  // Downloads and synchronous loads are never held back.
+  ResourceRequestInfoImpl* info = ResourceRequestInfoImpl::ForRequest(request);
+  if (!info->is_download() &&
+      !(request->load_flags() & net::LOAD_IGNORE_LIMITS) &&
+      !scheduler_->ScheduleRequest(info->GetChildID(), info->GetRouteID(),
+                                   request)) {
+    return;
+  }
+
   request->Start();
 
   // Make sure we have the load state monitor running
@@ -1777,6 +1798,23 @@ void ResourceDispatcherHostImpl::StartRequest(net::URLRequest* request) {
   }
 }
 
+void ResourceDispatcherHostImpl::StartScheduledRequests(
+    const ResourceScheduler::RequestList& requests) {
+  if (is_shutdown_)
+    return;
+
+  for (size_t i = 0; i < requests.size(); ++i) {
+    DCHECK(IsValidRequest(requests[i]));
+    requests[i]->Start();
+  }
+
+  if (!requests.empty() && !update_load_states_timer_->IsRunning()) {
+    update_load_states_timer_->Start(FROM_HERE,
+        TimeDelta::FromMilliseconds(kUpdateLoadStatesIntervalMsec),
+        this, &ResourceDispatcherHostImpl::UpdateLoadStates);
+  }
+}
+
 bool ResourceDispatcherHostImpl::PauseRequestIfNeeded(
     ResourceRequestInfoImpl* info) {
   if (info->pause_count() > 0)
@@ -2033,6 +2071,15 @@ void ResourceDispatcherHostImpl::OnUserGesture(WebContentsImpl* contents) {
   last_user_gesture_time_ = TimeTicks::Now();
 }
 
+void ResourceDispatcherHostImpl::OnVisibilityChanged(int child_id,
+                                                     int route_id,
+                                                     bool visible) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  ResourceScheduler::RequestList ready;
+  scheduler_->OnVisibilityChanged(child_id, route_id, visible, &ready);
+  StartScheduledRequests(ready);
+}
+
 net::URLRequest* ResourceDispatcherHostImpl::GetURLRequest(
     const GlobalRequestID& request_id) const {
   // This should be running in the IO loop.
@@ -25,6 +25,7 @@
 #include "base/time.h"
 #include "base/timer.h"
 #include "content/browser/download/download_resource_handler.h"
+#include "content/browser/renderer_host/resource_scheduler.h"
 #include "content/browser/ssl/ssl_error_handler.h"
 #include "content/common/content_export.h"
 #include "content/public/browser/child_process_data.h"
@@ -207,6 +208,10 @@ class CONTENT_EXPORT ResourceDispatcherHostImpl
 
   void OnUserGesture(WebContentsImpl* contents);
 
+  // Called when the widget |child_id|, |route_id| is hidden or shown, so that
+  // the requests of the visible widgets go first.
+  void OnVisibilityChanged(int child_id, int route_id, bool visible);
+
   // Retrieves a net::URLRequest.  Must be called from the IO thread.
   net::URLRequest* GetURLRequest(
       const GlobalRequestID& request_id) const;
@@ -286,8 +291,12 @@ class CONTENT_EXPORT ResourceDispatcherHostImpl
   // this method with the proper value for the timed_out parameter.
   void HandleSwapOutACK(const ViewMsg_SwapOut_Params& params, bool timed_out);
 
+  // Starts |request|, once the scheduler lets it.
   void StartRequest(net::URLRequest* request);
 
+  // Starts requests that the scheduler let go.
+  void StartScheduledRequests(const ResourceScheduler::RequestList& requests);
+
   // Returns true if the request is paused.
   bool PauseRequestIfNeeded(ResourceRequestInfoImpl* info);
 
@@ -516,6 +525,9 @@ class CONTENT_EXPORT ResourceDispatcherHostImpl
   // shutdown.
   std::set<const ResourceContext*> canceled_resource_contexts_;
 
+  // Holds back the requests of hidden widgets.
+  scoped_ptr<ResourceScheduler> scheduler_;
+
   DISALLOW_COPY_AND_ASSIGN(ResourceDispatcherHostImpl);
 };
 
@@ -101,6 +101,7 @@ ResourceRequestInfoImpl::ResourceRequestInfoImpl(
     ResourceContext* context)
     : resource_handler_(handler),
       cross_site_handler_(NULL),
+      async_handler_(NULL),
       process_type_(process_type),
       child_id_(child_id),
       route_id_(route_id),
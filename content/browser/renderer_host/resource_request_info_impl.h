@@ -27,6 +27,7 @@ class BlobData;
 }
 
 namespace content {
+class AsyncResourceHandler;
 class CrossSiteResourceHandler;
 class ResourceContext;
 class ResourceDispatcherHostImpl;
@@ -99,6 +100,13 @@ class ResourceRequestInfoImpl : public ResourceRequestInfo,
     cross_site_handler_ = h;
   }
 
+  // AsyncResourceHandler for this request, if it has one, which is told about
+  // the ACKs of the data it sends. (NULL otherwise.) This handler is part of
+  // the chain of ResourceHandlers pointed to by resource_handler, and is not
+  // owned by this class.
+  AsyncResourceHandler* async_handler() { return async_handler_; }
+  void set_async_handler(AsyncResourceHandler* h) { async_handler_ = h; }
+
   // Pointer to the login delegate, or NULL if there is none for this request.
   ResourceDispatcherHostLoginDelegate* login_delegate() const {
     return login_delegate_.get();
@@ -215,6 +223,9 @@ class ResourceRequestInfoImpl : public ResourceRequestInfo,
   // Non-owning, may be NULL.
   CrossSiteResourceHandler* cross_site_handler_;
 
+  // Non-owning, may be NULL.
+  AsyncResourceHandler* async_handler_;
+
   scoped_refptr<ResourceDispatcherHostLoginDelegate> login_delegate_;
   scoped_refptr<SSLClientAuthHandler> ssl_client_auth_handler_;
   ProcessType process_type_;
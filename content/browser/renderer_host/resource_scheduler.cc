@@ -0,0 +1,133 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/resource_scheduler.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "net/url_request/url_request.h"
+
+namespace content {
+
+ResourceScheduler::ResourceScheduler() : background_requests_(0) {
+}
+
+ResourceScheduler::~ResourceScheduler() {
+}
+
+bool ResourceScheduler::ScheduleRequest(int child_id, int route_id,
+                                        net::URLRequest* request) {
+  DCHECK(requests_.find(request) == requests_.end());
+  RequestInfo& info = requests_[request];
+  info.route = ProcessRouteIDs(child_id, route_id);
+  info.priority = request->priority();
+  info.started = true;
+  info.background = false;
+  if (!IsHidden(info.route))
+    return true;
+
+  request->set_priority(net::IDLE);
+  if (background_requests_ >= kMaxBackgroundRequests) {
+    info.started = false;
+    delayed_requests_.push_back(request);
+    return false;
+  }
+
+  info.background = true;
+  background_requests_++;
+  return true;
+}
+
+void ResourceScheduler::RemoveRequest(net::URLRequest* request,
+                                      RequestList* ready) {
+  RequestMap::iterator it = requests_.find(request);
+  if (it == requests_.end())
+    return;  // It didn't get to the scheduler.
+
+  if (!it->second.started) {
+    delayed_requests_.erase(std::find(delayed_requests_.begin(),
+                                      delayed_requests_.end(), request));
+  } else if (it->second.background) {
+    background_requests_--;
+  }
+  requests_.erase(it);
+
+  LoadDelayedRequests(ready);
+}
+
+void ResourceScheduler::OnVisibilityChanged(int child_id, int route_id,
+                                            bool visible, RequestList* ready) {
+  ProcessRouteIDs route(child_id, route_id);
+  if (visible == !IsHidden(route))
+    return;
+
+  if (visible) {
+    hidden_routes_.erase(route);
+  } else {
+    hidden_routes_.insert(route);
+  }
+
+  for (RequestMap::iterator it = requests_.begin(); it != requests_.end();
+       ++it) {
+    if (it->second.route != route)
+      continue;
+
+    net::URLRequest* request = it->first;
+    if (!visible) {
+      request->set_priority(net::IDLE);
+      // The requests that are already running are not delayed, but they count
+      // against the requests of hidden routes that can run.
+      if (it->second.started) {
+        it->second.background = true;
+        background_requests_++;
+      }
+      continue;
+    }
+
+    request->set_priority(it->second.priority);
+    if (it->second.background) {
+      it->second.background = false;
+      background_requests_--;
+    } else if (!it->second.started) {
+      it->second.started = true;
+      delayed_requests_.erase(std::find(delayed_requests_.begin(),
+                                        delayed_requests_.end(), request));
+      ready->push_back(request);
+    }
+  }
+
+  LoadDelayedRequests(ready);
+}
+
+void ResourceScheduler::OnRouteDeleted(int child_id, int route_id) {
+  // The requests of the route are gone by now, or are about to be. Any one
+  // that is left keeps its place until it goes away.
+  std::set<ProcessRouteIDs>::iterator it = hidden_routes_.begin();
+  while (it != hidden_routes_.end()) {
+    if (it->first == child_id && (route_id == -1 || it->second == route_id))
+      hidden_routes_.erase(it++);
+    else
+      ++it;
+  }
+}
+
+bool ResourceScheduler::IsHidden(const ProcessRouteIDs& route) const {
+  return hidden_routes_.find(route) != hidden_routes_.end();
+}
+
+void ResourceScheduler::LoadDelayedRequests(RequestList* ready) {
+  while (!delayed_requests_.empty() &&
+         background_requests_ < kMaxBackgroundRequests) {
+    net::URLRequest* request = delayed_requests_.front();
+    delayed_requests_.pop_front();
+    RequestInfo& info = requests_[request];
+    info.started = true;
+    info.background = true;
+    background_requests_++;
+    ready->push_back(request);
+  }
+}
+
+}  // namespace content
@@ -0,0 +1,88 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_RENDERER_HOST_RESOURCE_SCHEDULER_H_
+#define CONTENT_BROWSER_RENDERER_HOST_RESOURCE_SCHEDULER_H_
+#pragma once
+
+#include <deque>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "content/common/content_export.h"
+#include "net/base/request_priority.h"
+
+namespace net {
+class URLRequest;
+}
+
+namespace content {
+
+// Decides when the requests of each route start, so that the visible tabs get
+// the network first. The requests of hidden routes run at IDLE priority, and
+// only a few of them are started at once; the rest wait until a slot is free
+// or their route becomes visible again. Routes are visible until told
+// otherwise. Lives on the IO thread, and is owned by the
+// ResourceDispatcherHostImpl, which starts the requests.
+class CONTENT_EXPORT ResourceScheduler {
+ public:
+  typedef std::vector<net::URLRequest*> RequestList;
+
+  // The maximum number of requests of hidden routes that run at once.
+  static const int kMaxBackgroundRequests = 4;
+
+  ResourceScheduler();
+  ~ResourceScheduler();
+
+  // Returns true if |request|, from the route |child_id|, |route_id|, can
+  // start now. Otherwise the request is delayed and will be returned by a
+  // later call, on |ready|, once it can start.
+  bool ScheduleRequest(int child_id, int route_id, net::URLRequest* request);
+
+  // Forgets about |request|, that is about to be destroyed. Other requests
+  // may be able to start now: they are added to |ready|.
+  void RemoveRequest(net::URLRequest* request, RequestList* ready);
+
+  // Updates the visibility of the route |child_id|, |route_id|, and the
+  // priority of its requests. The requests that can start now are added to
+  // |ready|.
+  void OnVisibilityChanged(int child_id, int route_id, bool visible,
+                           RequestList* ready);
+
+  // Forgets about the route |child_id|, |route_id|, or about all the routes
+  // of |child_id| if |route_id| is -1.
+  void OnRouteDeleted(int child_id, int route_id);
+
+  int background_requests() const { return background_requests_; }
+
+ private:
+  typedef std::pair<int, int> ProcessRouteIDs;
+
+  struct RequestInfo {
+    ProcessRouteIDs route;
+    net::RequestPriority priority;  // The priority of a visible route.
+    bool started;
+    bool background;  // Counted by |background_requests_|.
+  };
+  typedef std::map<net::URLRequest*, RequestInfo> RequestMap;
+
+  bool IsHidden(const ProcessRouteIDs& route) const;
+
+  // Moves the oldest delayed requests to |ready| while there is room for them.
+  void LoadDelayedRequests(RequestList* ready);
+
+  RequestMap requests_;  // All the scheduled requests.
+  std::deque<net::URLRequest*> delayed_requests_;  // Waiting for a slot.
+  std::set<ProcessRouteIDs> hidden_routes_;
+  int background_requests_;  // Started requests of hidden routes.
+
+  DISALLOW_COPY_AND_ASSIGN(ResourceScheduler);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_RENDERER_HOST_RESOURCE_SCHEDULER_H_
@@ -0,0 +1,137 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/resource_scheduler.h"
+
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop.h"
+#include "googleurl/src/gurl.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+
+namespace {
+
+const int kChildId = 3;
+const int kRouteId = 7;
+const int kOtherRouteId = 8;
+
+class ResourceSchedulerTest : public testing::Test {
+ protected:
+  ResourceSchedulerTest() : message_loop_(MessageLoop::TYPE_IO) {}
+
+  virtual void TearDown() OVERRIDE {
+    ResourceScheduler::RequestList ready;
+    for (size_t i = 0; i < requests_.size(); ++i)
+      scheduler_.RemoveRequest(requests_[i], &ready);
+  }
+
+  net::URLRequest* NewRequest(net::RequestPriority priority) {
+    net::URLRequest* request =
+        new net::URLRequest(GURL("http://host/"), &delegate_);
+    request->set_priority(priority);
+    requests_.push_back(request);
+    return request;
+  }
+
+  MessageLoop message_loop_;
+  TestDelegate delegate_;
+  ScopedVector<net::URLRequest> requests_;
+  ResourceScheduler scheduler_;
+};
+
+}  // namespace
+
+TEST_F(ResourceSchedulerTest, VisibleRoutesAreNotDelayed) {
+  for (int i = 0; i < ResourceScheduler::kMaxBackgroundRequests * 2; ++i) {
+    net::URLRequest* request = NewRequest(net::MEDIUM);
+    EXPECT_TRUE(scheduler_.ScheduleRequest(kChildId, kRouteId, request));
+    EXPECT_EQ(net::MEDIUM, request->priority());
+  }
+  EXPECT_EQ(0, scheduler_.background_requests());
+}
+
+TEST_F(ResourceSchedulerTest, HiddenRoutesAreLimited) {
+  ResourceScheduler::RequestList ready;
+  scheduler_.OnVisibilityChanged(kChildId, kRouteId, false, &ready);
+  EXPECT_TRUE(ready.empty());
+
+  const int kMax = ResourceScheduler::kMaxBackgroundRequests;
+  for (int i = 0; i < kMax + 2; ++i) {
+    net::URLRequest* request = NewRequest(net::MEDIUM);
+    EXPECT_EQ(i < kMax,
+              scheduler_.ScheduleRequest(kChildId, kRouteId, request));
+    EXPECT_EQ(net::IDLE, request->priority());
+  }
+  EXPECT_EQ(kMax, scheduler_.background_requests());
+
+  // Another tab is not affected.
+  EXPECT_TRUE(scheduler_.ScheduleRequest(kChildId, kOtherRouteId,
+                                         NewRequest(net::MEDIUM)));
+
+  // When a request goes away, the oldest delayed one takes its place.
+  scheduler_.RemoveRequest(requests_[0], &ready);
+  ASSERT_EQ(1U, ready.size());
+  EXPECT_EQ(requests_[kMax], ready[0]);
+  EXPECT_EQ(kMax, scheduler_.background_requests());
+
+  // A delayed request can go away too.
+  ready.clear();
+  scheduler_.RemoveRequest(requests_[kMax + 1], &ready);
+  EXPECT_TRUE(ready.empty());
+}
+
+TEST_F(ResourceSchedulerTest, ShowingRouteStartsItsRequests) {
+  ResourceScheduler::RequestList ready;
+  scheduler_.OnVisibilityChanged(kChildId, kRouteId, false, &ready);
+
+  const int kMax = ResourceScheduler::kMaxBackgroundRequests;
+  for (int i = 0; i < kMax + 2; ++i)
+    scheduler_.ScheduleRequest(kChildId, kRouteId, NewRequest(net::HIGHEST));
+
+  scheduler_.OnVisibilityChanged(kChildId, kRouteId, true, &ready);
+  EXPECT_EQ(2U, ready.size());
+  EXPECT_EQ(0, scheduler_.background_requests());
+  for (size_t i = 0; i < requests_.size(); ++i)
+    EXPECT_EQ(net::HIGHEST, requests_[i]->priority());
+}
+
+TEST_F(ResourceSchedulerTest, HidingRouteLowersPriority) {
+  const int kMax = ResourceScheduler::kMaxBackgroundRequests;
+  for (int i = 0; i < kMax; ++i) {
+    EXPECT_TRUE(scheduler_.ScheduleRequest(kChildId, kRouteId,
+                                           NewRequest(net::LOW)));
+  }
+
+  // The requests that were running keep running, but use up the room for
+  // the requests of hidden routes.
+  ResourceScheduler::RequestList ready;
+  scheduler_.OnVisibilityChanged(kChildId, kRouteId, false, &ready);
+  EXPECT_TRUE(ready.empty());
+  EXPECT_EQ(kMax, scheduler_.background_requests());
+  EXPECT_EQ(net::IDLE, requests_[0]->priority());
+
+  scheduler_.OnVisibilityChanged(kChildId, kOtherRouteId, false, &ready);
+  EXPECT_FALSE(scheduler_.ScheduleRequest(kChildId, kOtherRouteId,
+                                          NewRequest(net::LOW)));
+
+  scheduler_.RemoveRequest(requests_[0], &ready);
+  EXPECT_EQ(1U, ready.size());
+}
+
+TEST_F(ResourceSchedulerTest, DeletedRoutesAreVisible) {
+  ResourceScheduler::RequestList ready;
+  scheduler_.OnVisibilityChanged(kChildId, kRouteId, false, &ready);
+  scheduler_.OnVisibilityChanged(kChildId, kOtherRouteId, false, &ready);
+
+  scheduler_.OnRouteDeleted(kChildId, -1);
+  net::URLRequest* request = NewRequest(net::MEDIUM);
+  EXPECT_TRUE(scheduler_.ScheduleRequest(kChildId, kOtherRouteId, request));
+  EXPECT_EQ(net::MEDIUM, request->priority());
+  EXPECT_EQ(0, scheduler_.background_requests());
+}
+
+}  // namespace content
@@ -40,7 +40,8 @@ InputTagSpeechDispatcherHost::InputTagSpeechDispatcherHost(
     int render_process_id,
     net::URLRequestContextGetter* url_request_context_getter,
     content::SpeechRecognitionPreferences* recognition_preferences)
-    : render_process_id_(render_process_id),
+    : BrowserMessageFilter(SpeechRecognitionMsgStart),
+      render_process_id_(render_process_id),
       may_have_pending_requests_(false),
       url_request_context_getter_(url_request_context_getter),
       recognition_preferences_(recognition_preferences) {
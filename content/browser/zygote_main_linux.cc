@@ -44,6 +44,7 @@
 #include "content/public/common/zygote_fork_delegate_linux.h"
 #include "skia/ext/SkFontHost_fontconfig_control.h"
 #include "unicode/timezone.h"
+#include "unicode/uclean.h"
 #include "ipc/ipc_channel.h"
 #include "ipc/ipc_switches.h"
 
@@ -839,6 +840,13 @@ static void PreSandboxInit() {
   // cached and there's no more need to access the file system.
   scoped_ptr<icu::TimeZone> zone(icu::TimeZone::createDefault());
 
+  // Load the ICU common data and converter alias tables here rather than in
+  // every renderer, so that the forked renderers share the pages holding
+  // them instead of each building a private copy.
+  UErrorCode icu_error = U_ZERO_ERROR;
+  u_init(&icu_error);
+  DCHECK(U_SUCCESS(icu_error));
+
 #if defined(USE_NSS)
   // NSS libraries are loaded before sandbox is activated. This is to allow
   // successful initialization of NSS which tries to load extra library files.
@@ -47,6 +47,7 @@ GpuChannel::GpuChannel(GpuChannelManager* gpu_channel_manager,
       software_(software),
       handle_messages_scheduled_(false),
       processed_get_state_fast_(false),
+      context_scheduling_enabled_(false),
       num_contexts_preferring_discrete_gpu_(0),
       weak_factory_(ALLOW_THIS_IN_INITIALIZER_LIST(this)) {
   DCHECK(gpu_channel_manager);
@@ -55,6 +56,8 @@ GpuChannel::GpuChannel(GpuChannelManager* gpu_channel_manager,
   channel_id_ = IPC::Channel::GenerateVerifiedChannelID("gpu");
   const CommandLine* command_line = CommandLine::ForCurrentProcess();
   log_messages_ = command_line->HasSwitch(switches::kLogPluginMessages);
+  context_scheduling_enabled_ =
+      command_line->HasSwitch(switches::kEnableGpuContextScheduling);
   disallowed_features_.multisampling =
       command_line->HasSwitch(switches::kDisableGLMultisampling);
   disallowed_features_.driver_bug_workarounds =
@@ -268,13 +271,14 @@ void GpuChannel::HandleMessage() {
   handle_messages_scheduled_ = false;
 
   if (!deferred_messages_.empty()) {
-    IPC::Message* m = deferred_messages_.front();
+    std::deque<IPC::Message*>::iterator next = GetNextMessage();
+    IPC::Message* m = *next;
     GpuCommandBufferStub* stub = stubs_.Lookup(m->routing_id());
 
     if (stub && !stub->IsScheduled()) {
       if (m->type() == GpuCommandBufferMsg_Echo::ID) {
         stub->DelayEcho(m);
-        deferred_messages_.pop_front();
+        deferred_messages_.erase(next);
         if (!deferred_messages_.empty())
           OnScheduled();
       }
@@ -282,7 +286,7 @@ void GpuChannel::HandleMessage() {
     }
 
     scoped_ptr<IPC::Message> message(m);
-    deferred_messages_.pop_front();
+    deferred_messages_.erase(next);
     processed_get_state_fast_ =
         (message->type() == GpuCommandBufferMsg_GetStateFast::ID);
     // Handle deferred control messages.
@@ -299,8 +303,13 @@ void GpuChannel::HandleMessage() {
       // message to flush that command buffer.
       if (stub) {
         if (stub->HasUnprocessedCommands()) {
-          deferred_messages_.push_front(new GpuCommandBufferMsg_Rescheduled(
-              stub->route_id()));
+          // A stub that is still scheduled stopped because it was preempted.
+          if (context_scheduling_enabled_ && stub->IsScheduled()) {
+            RequeuePreemptedStub(stub);
+          } else {
+            deferred_messages_.push_front(new GpuCommandBufferMsg_Rescheduled(
+                stub->route_id()));
+          }
         }
 
         ScheduleDelayedWork(stub, kHandleMoreWorkPeriodMs);
@@ -313,6 +322,69 @@ void GpuChannel::HandleMessage() {
   }
 }
 
+std::deque<IPC::Message*>::iterator GpuChannel::GetNextMessage() {
+  std::deque<IPC::Message*>::iterator front = deferred_messages_.begin();
+  if (!context_scheduling_enabled_)
+    return front;
+
+  GpuCommandBufferStub* stub = stubs_.Lookup((*front)->routing_id());
+  if (!stub || stub->priority() == GpuCommandBufferStub::PRIORITY_HIGH)
+    return front;
+
+  // Only messages for lower priority contexts may be overtaken, and the
+  // first message found for a high priority context is its oldest, so every
+  // context still sees its own messages in order.
+  std::deque<IPC::Message*>::iterator it = front;
+  for (++it; it != deferred_messages_.end(); ++it) {
+    GpuCommandBufferStub* other = stubs_.Lookup((*it)->routing_id());
+    if (!other)
+      break;
+    if (other->priority() == GpuCommandBufferStub::PRIORITY_HIGH) {
+      if (!other->IsScheduled())
+        break;
+      TRACE_EVENT_INSTANT2("gpu", "GpuChannel:Prioritized",
+                           "route_id", other->route_id(),
+                           "overtaken_route_id", stub->route_id());
+      return it;
+    }
+  }
+  return front;
+}
+
+void GpuChannel::RequeuePreemptedStub(GpuCommandBufferStub* stub) {
+  TRACE_EVENT1("gpu", "GpuChannel::RequeuePreemptedStub",
+               "route_id", stub->route_id());
+  std::deque<IPC::Message*>::iterator it = deferred_messages_.begin();
+  while (it != deferred_messages_.end() &&
+         (*it)->routing_id() != stub->route_id()) {
+    ++it;
+  }
+  deferred_messages_.insert(
+      it, new GpuCommandBufferMsg_Rescheduled(stub->route_id()));
+}
+
+bool GpuChannel::IsOtherStubWaiting(GpuCommandBufferStub* stub) {
+  // Contexts of the same priority take turns in the order their messages
+  // came in; higher priority ones can also overtake the next message of
+  // |stub|.
+  bool past_next_message = false;
+  for (std::deque<IPC::Message*>::iterator it = deferred_messages_.begin();
+       it != deferred_messages_.end(); ++it) {
+    GpuCommandBufferStub* other = stubs_.Lookup((*it)->routing_id());
+    if (other == stub) {
+      past_next_message = true;
+      continue;
+    }
+    if (!other || !other->IsScheduled())
+      continue;
+    if (other->priority() > stub->priority())
+      return true;
+    if (other->priority() == stub->priority() && !past_next_message)
+      return true;
+  }
+  return false;
+}
+
 void GpuChannel::PollWork(int route_id) {
   GpuCommandBufferStub* stub = stubs_.Lookup(route_id);
   if (stub) {
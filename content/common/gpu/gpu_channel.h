@@ -105,6 +105,17 @@ class GpuChannel : public IPC::Channel::Listener,
   // discrete GPU even if they would otherwise use the integrated GPU.
   bool ShouldPreferDiscreteGpu() const;
 
+  // Whether the contexts of this channel are scheduled by priority and
+  // preempted once their time slice is used up. Otherwise messages are
+  // handled strictly in the order they came in.
+  bool context_scheduling_enabled() const {
+    return context_scheduling_enabled_;
+  }
+
+  // Returns whether a message is waiting for another scheduled context that
+  // would be handled before |stub| gets to run again, if |stub| yielded now.
+  bool IsOtherStubWaiting(GpuCommandBufferStub* stub);
+
  protected:
   virtual ~GpuChannel();
 
@@ -117,6 +128,16 @@ class GpuChannel : public IPC::Channel::Listener,
 
   void HandleMessage();
   void PollWork(int route_id);
+
+  // Returns the deferred message to handle next. That is the one at the front
+  // of the queue, unless context scheduling is enabled and a higher priority
+  // context has a message further back that can go first.
+  std::deque<IPC::Message*>::iterator GetNextMessage();
+
+  // Requeues the remaining commands of |stub|, which was preempted, behind the
+  // messages of other contexts but ahead of its own next message.
+  void RequeuePreemptedStub(GpuCommandBufferStub* stub);
+
   void ScheduleDelayedWork(GpuCommandBufferStub *stub, int64 delay);
 
   // Message handlers.
@@ -169,6 +190,7 @@ class GpuChannel : public IPC::Channel::Listener,
   bool software_;
   bool handle_messages_scheduled_;
   bool processed_get_state_fast_;
+  bool context_scheduling_enabled_;
   int32 num_contexts_preferring_discrete_gpu_;
 
   base::WeakPtrFactory<GpuChannel> weak_factory_;
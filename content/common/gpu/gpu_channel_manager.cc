@@ -5,12 +5,23 @@
 #include "content/common/gpu/gpu_channel_manager.h"
 
 #include "base/bind.h"
+#include "base/command_line.h"
+#include "base/string_number_conversions.h"
 #include "content/common/child_thread.h"
 #include "content/common/gpu/gpu_channel.h"
 #include "content/common/gpu/gpu_messages.h"
 #include "content/common/gpu/gpu_memory_manager.h"
+#include "content/public/common/content_switches.h"
+#include "gpu/command_buffer/service/program_cache.h"
 #include "ui/gfx/gl/gl_share_group.h"
 
+namespace {
+
+// The most memory the binaries of linked programs may take up.
+const size_t kMaxProgramCacheSize = 6 * 1024 * 1024;
+
+}  // namespace
+
 GpuChannelManager::GpuChannelManager(ChildThread* gpu_child_thread,
                                      GpuWatchdog* watchdog,
                                      base::MessageLoopProxy* io_message_loop,
@@ -25,6 +36,21 @@ GpuChannelManager::GpuChannelManager(ChildThread* gpu_child_thread,
   DCHECK(gpu_child_thread);
   DCHECK(io_message_loop);
   DCHECK(shutdown_event);
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+  if (command_line->HasSwitch(switches::kGpuMemoryBudgetMb)) {
+    int budget_mb = 0;
+    if (base::StringToInt(
+            command_line->GetSwitchValueASCII(switches::kGpuMemoryBudgetMb),
+            &budget_mb) && budget_mb > 0) {
+      gpu_memory_manager_.set_max_memory_usage(
+          static_cast<size_t>(budget_mb) * 1024 * 1024);
+    }
+  }
+  if (!command_line->HasSwitch(switches::kDisableGpuProgramCache)) {
+    program_cache_.reset(new gpu::gles2::ProgramCache(kMaxProgramCacheSize));
+    program_cache_->set_entry_added_callback(
+        base::Bind(&GpuChannelManager::CacheProgram, base::Unretained(this)));
+  }
 }
 
 GpuChannelManager::~GpuChannelManager() {
@@ -74,6 +100,7 @@ bool GpuChannelManager::OnMessageReceived(const IPC::Message& msg) {
     IPC_MESSAGE_HANDLER(GpuMsg_CloseChannel, OnCloseChannel)
     IPC_MESSAGE_HANDLER(GpuMsg_CreateViewCommandBuffer,
                         OnCreateViewCommandBuffer)
+    IPC_MESSAGE_HANDLER(GpuMsg_LoadedProgram, OnLoadedProgram)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP_EX()
   return handled;
@@ -142,6 +169,17 @@ void GpuChannelManager::OnCreateViewCommandBuffer(
   Send(new GpuHostMsg_CommandBufferCreated(route_id));
 }
 
+void GpuChannelManager::OnLoadedProgram(const std::string& key,
+                                        const std::string& program) {
+  if (program_cache_.get())
+    program_cache_->AddEntry(key, program);
+}
+
+void GpuChannelManager::CacheProgram(const std::string& key,
+                                     const std::string& program) {
+  Send(new GpuHostMsg_CacheProgram(key, program));
+}
+
 void GpuChannelManager::LoseAllContexts() {
   MessageLoop::current()->PostTask(
       FROM_HERE,
@@ -8,6 +8,7 @@
 
 #include "base/hash_tables.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/message_loop_proxy.h"
 #include "build/build_config.h"
@@ -24,6 +25,12 @@ namespace gfx {
 class GLShareGroup;
 }
 
+namespace gpu {
+namespace gles2 {
+class ProgramCache;
+}
+}
+
 namespace IPC {
 struct ChannelHandle;
 }
@@ -78,6 +85,10 @@ class GpuChannelManager : public IPC::Channel::Listener,
 
   GpuChannel* LookupChannel(int32 client_id);
 
+  // The cache of linked program binaries shared by all the contexts. NULL if
+  // binaries are not cached.
+  gpu::gles2::ProgramCache* program_cache() { return program_cache_.get(); }
+
  private:
   // Message handlers.
   void OnEstablishChannel(int client_id, bool share_context);
@@ -90,14 +101,22 @@ class GpuChannelManager : public IPC::Channel::Listener,
       int32 client_id,
       const GPUCreateCommandBufferConfig& init_params);
 
+  void OnLoadedProgram(const std::string& key, const std::string& program);
+
   void OnLoseAllContexts();
 
+  // Sends the browser a program that was added to |program_cache_|.
+  void CacheProgram(const std::string& key, const std::string& program);
+
   scoped_refptr<base::MessageLoopProxy> io_message_loop_;
   base::WaitableEvent* shutdown_event_;
 
   // Used to send and receive IPC messages from the browser process.
   ChildThread* gpu_child_thread_;
 
+  // Declared before the channels so that it outlives their contexts.
+  scoped_ptr<gpu::gles2::ProgramCache> program_cache_;
+
   // These objects manage channels to individual renderer processes there is
   // one channel for each renderer process that has connected to this GPU
   // process.
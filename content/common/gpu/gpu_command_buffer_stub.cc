@@ -4,11 +4,16 @@
 
 #if defined(ENABLE_GPU)
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/command_line.h"
 #include "base/debug/trace_event.h"
+#include "base/file_path.h"
+#include "base/process_util.h"
 #include "base/shared_memory.h"
+#include "base/stringprintf.h"
 #include "base/time.h"
 #include "build/build_config.h"
 #include "content/common/gpu/gpu_channel.h"
@@ -18,8 +23,11 @@
 #include "content/common/gpu/gpu_messages.h"
 #include "content/common/gpu/gpu_watchdog.h"
 #include "content/common/gpu/image_transport_surface.h"
+#include "content/public/common/content_switches.h"
 #include "gpu/command_buffer/common/constants.h"
 #include "gpu/command_buffer/common/gles2_cmd_utils.h"
+#include "gpu/command_buffer/service/command_buffer_recorder.h"
+#include "gpu/command_buffer/service/texture_manager.h"
 #include "ui/gfx/gl/gl_bindings.h"
 #include "ui/gfx/gl/gl_switches.h"
 
@@ -27,6 +35,14 @@
 #include "content/public/common/sandbox_init.h"
 #endif
 
+namespace {
+
+// How long a context may process commands for while other contexts are
+// waiting to run.
+const int64 kTimeSliceMs = 4;
+
+}  // namespace
+
 GpuCommandBufferStub::SurfaceState::SurfaceState(int32 surface_id,
                                                  bool visible,
                                                  base::TimeTicks last_used_time)
@@ -63,13 +79,17 @@ GpuCommandBufferStub::GpuCommandBufferStub(
       allocation_(GpuMemoryAllocation::INVALID_RESOURCE_SIZE,
                   GpuMemoryAllocation::kHasFrontbuffer |
                   GpuMemoryAllocation::kHasBackbuffer),
+      last_memory_usage_(0),
       parent_stub_for_initialization_(),
       parent_texture_for_initialization_(0),
       watchdog_(watchdog) {
   if (share_group) {
     context_group_ = share_group->context_group_;
   } else {
-    context_group_ = new gpu::gles2::ContextGroup(mailbox_manager, true);
+    context_group_ = new gpu::gles2::ContextGroup(
+        mailbox_manager,
+        channel->gpu_channel_manager()->program_cache(),
+        true);
   }
   if (surface_id != 0)
     surface_state_.reset(new GpuCommandBufferStubBase::SurfaceState(
@@ -247,6 +267,19 @@ void GpuCommandBufferStub::OnInitialize(
     return;
   }
 
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+  if (command_line->HasSwitch(switches::kGpuRecordCommandBuffers)) {
+    FilePath path = command_line->GetSwitchValuePath(
+        switches::kGpuRecordCommandBuffers).AppendASCII(base::StringPrintf(
+            "commands_%d_%d.bin", base::GetCurrentProcId(), route_id_));
+    gpu::CommandBufferRecorder* recorder =
+        gpu::CommandBufferRecorder::Create(path);
+    if (recorder)
+      command_buffer_->SetRecorder(recorder);
+    else
+      DLOG(ERROR) << "Could not record the command buffer to " << path.value();
+  }
+
   decoder_.reset(::gpu::gles2::GLES2Decoder::Create(context_group_.get()));
 
   scheduler_.reset(new gpu::GpuScheduler(command_buffer_.get(),
@@ -312,8 +345,7 @@ void GpuCommandBufferStub::OnInitialize(
     return;
   }
 
-  if (CommandLine::ForCurrentProcess()->HasSwitch(
-      switches::kEnableGPUServiceLogging)) {
+  if (command_line->HasSwitch(switches::kEnableGPUServiceLogging)) {
     decoder_->set_log_commands(true);
   }
 
@@ -338,6 +370,12 @@ void GpuCommandBufferStub::OnInitialize(
                    base::Unretained(this)));
   }
 
+  if (channel_->context_scheduling_enabled()) {
+    scheduler_->SetPreemptionCallback(
+        base::Bind(&GpuCommandBufferStub::ShouldYield,
+                   base::Unretained(this)));
+  }
+
   if (parent_stub_for_initialization_) {
     decoder_->SetParent(parent_stub_for_initialization_->decoder_.get(),
                         parent_texture_for_initialization_);
@@ -442,6 +480,7 @@ void GpuCommandBufferStub::OnAsyncFlush(int32 put_offset,
   DCHECK(command_buffer_.get());
   if (flush_count - last_flush_count_ < 0x8000000U) {
     last_flush_count_ = flush_count;
+    time_slice_start_ = base::TimeTicks::Now();
     command_buffer_->Flush(put_offset);
   } else {
     // We received this message out-of-order. This should not happen but is here
@@ -450,10 +489,17 @@ void GpuCommandBufferStub::OnAsyncFlush(int32 put_offset,
   }
 
   ReportState();
+
+  size_t memory_usage = GetMemoryUsage();
+  if (memory_usage != last_memory_usage_) {
+    last_memory_usage_ = memory_usage;
+    channel_->gpu_channel_manager()->gpu_memory_manager()->ScheduleManage();
+  }
 }
 
 void GpuCommandBufferStub::OnRescheduled() {
   gpu::CommandBuffer::State pre_state = command_buffer_->GetLastState();
+  time_slice_start_ = base::TimeTicks::Now();
   command_buffer_->Flush(pre_state.put_offset);
   gpu::CommandBuffer::State post_state = command_buffer_->GetLastState();
 
@@ -541,6 +587,13 @@ void GpuCommandBufferStub::OnCommandProcessed() {
     watchdog_->CheckArmed();
 }
 
+bool GpuCommandBufferStub::ShouldYield() {
+  if (base::TimeTicks::Now() - time_slice_start_ <
+      base::TimeDelta::FromMilliseconds(kTimeSliceMs))
+    return false;
+  return channel_->IsOtherStubWaiting(this);
+}
+
 void GpuCommandBufferStub::ReportState() {
   gpu::CommandBuffer::State state = command_buffer_->GetState();
   if (state.error == gpu::error::kLostContext &&
@@ -656,4 +709,21 @@ void GpuCommandBufferStub::SetMemoryAllocation(
   SendMemoryAllocationToProxy(allocation);
 }
 
+size_t GpuCommandBufferStub::GetMemoryUsage() const {
+  return context_group_->GetMemRepresented();
+}
+
+size_t GpuCommandBufferStub::PurgeMemory(size_t bytes) {
+  if (!decoder_.get() || !context_group_->texture_manager())
+    return 0;
+  if (!decoder_->MakeCurrent()) {
+    DLOG(ERROR) << "Context lost because MakeCurrent failed.";
+    command_buffer_->SetContextLostReason(decoder_->GetContextLostReason());
+    command_buffer_->SetParseError(gpu::error::kLostContext);
+    return 0;
+  }
+  return context_group_->texture_manager()->PurgeTextures(
+      static_cast<uint32>(std::min<size_t>(bytes, kuint32max)));
+}
+
 #endif  // defined(ENABLE_GPU)
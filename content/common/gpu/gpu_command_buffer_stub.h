@@ -75,6 +75,15 @@ class CONTENT_EXPORT GpuCommandBufferStubBase {
 
   virtual void SetMemoryAllocation(
       const GpuMemoryAllocation& allocation) = 0;
+
+  // Returns the number of bytes the textures and renderbuffers of the context
+  // share group are estimated to take up.
+  virtual size_t GetMemoryUsage() const = 0;
+
+  // Evicts the purgeable textures of the context share group, least recently
+  // used first, until at least |bytes| are freed or none are left. Returns the
+  // number of bytes freed.
+  virtual size_t PurgeMemory(size_t bytes) = 0;
 };
 
 class GpuCommandBufferStub
@@ -132,6 +141,21 @@ class GpuCommandBufferStub
   virtual void SetMemoryAllocation(
       const GpuMemoryAllocation& allocation) OVERRIDE;
 
+  virtual size_t GetMemoryUsage() const OVERRIDE;
+
+  virtual size_t PurgeMemory(size_t bytes) OVERRIDE;
+
+  // When context scheduling is enabled, onscreen contexts, which the
+  // compositor draws with, run ahead of offscreen ones such as WebGL's.
+  enum Priority {
+    PRIORITY_NORMAL,
+    PRIORITY_HIGH
+  };
+
+  Priority priority() const {
+    return handle_.is_null() ? PRIORITY_NORMAL : PRIORITY_HIGH;
+  }
+
   // Whether this command buffer can currently handle IPC messages.
   bool IsScheduled();
 
@@ -214,6 +238,10 @@ class GpuCommandBufferStub
   void OnCommandProcessed();
   void OnParseError();
 
+  // Polled by the scheduler between commands. Returns true once this context
+  // has used up its time slice and another context is waiting.
+  bool ShouldYield();
+
   void ReportState();
 
   // The lifetime of objects of this class is managed by a GpuChannel. The
@@ -234,9 +262,15 @@ class GpuCommandBufferStub
   bool software_;
   bool client_has_memory_allocation_changed_callback_;
   uint32 last_flush_count_;
+  // When the commands of the current flush started to be processed.
+  base::TimeTicks time_slice_start_;
   scoped_ptr<GpuCommandBufferStubBase::SurfaceState> surface_state_;
   GpuMemoryAllocation allocation_;
 
+  // What GetMemoryUsage() returned after the last flush, so that the memory
+  // manager only runs again when it changes.
+  size_t last_memory_usage_;
+
   scoped_ptr<gpu::CommandBufferService> command_buffer_;
   scoped_ptr<gpu::gles2::GLES2Decoder> decoder_;
   scoped_ptr<gpu::GpuScheduler> scheduler_;
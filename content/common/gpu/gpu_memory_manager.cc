@@ -34,6 +34,21 @@ void AssignMemoryAllocations(std::vector<GpuCommandBufferStubBase*>& stubs,
   }
 }
 
+// Appends the stubs of |stubs| whose share group is not in |share_groups| yet
+// to it, each with |budget| appended to |budgets|.
+void AppendShareGroups(const std::vector<GpuCommandBufferStubBase*>& stubs,
+                       size_t budget,
+                       std::vector<GpuCommandBufferStubBase*>* share_groups,
+                       std::vector<size_t>* budgets) {
+  for (std::vector<GpuCommandBufferStubBase*>::const_iterator it =
+      stubs.begin(); it != stubs.end(); ++it) {
+    if (IsInSameContextShareGroupAsAnyOf(*it, *share_groups))
+      continue;
+    share_groups->push_back(*it);
+    budgets->push_back(budget);
+  }
+}
+
 }
 
 GpuMemoryManager::GpuMemoryManager(GpuMemoryManagerClient* client,
@@ -42,6 +57,7 @@ GpuMemoryManager::GpuMemoryManager(GpuMemoryManagerClient* client,
       manage_scheduled_(false),
       max_surfaces_with_frontbuffer_soft_limit_(
           max_surfaces_with_frontbuffer_soft_limit),
+      max_memory_usage_(kMaximumAllocationForTabs + kMinimumAllocationForTab),
       weak_factory_(ALLOW_THIS_IN_INITIALIZER_LIST(this)) {
 }
 
@@ -98,6 +114,9 @@ void GpuMemoryManager::ScheduleManage() {
 // As such, the rule for categorizing contexts without a surface is:
 //  1. Find the most visible context-with-a-surface within each
 //     context-without-a-surface's share group, and inherit its visibilty.
+//
+// Once the allocations are given out, the share groups that use more than
+// they were allocated have purgeable textures evicted, see PurgeMemory().
 void GpuMemoryManager::Manage() {
   manage_scheduled_ = false;
 
@@ -163,15 +182,20 @@ void GpuMemoryManager::Manage() {
   }
 
   // Calculate memory allocation size in bytes given to each stub, by sharing
-  // global limit equally among those that need it.
+  // global limit equally among those that need it. As with the default
+  // limits, one tab's worth is kept back for the time it takes renderers to
+  // respect new allocations.
+  size_t max_allocation_for_tabs = 0;
+  if (max_memory_usage_ > kMinimumAllocationForTab)
+    max_allocation_for_tabs = max_memory_usage_ - kMinimumAllocationForTab;
   size_t num_stubs_need_mem = stubs_with_surface_foreground.size() +
                               stubs_without_surface_foreground.size() +
                               stubs_without_surface_background.size();
   size_t base_allocation_size = kMinimumAllocationForTab * num_stubs_need_mem;
   size_t bonus_allocation = 0;
-  if (base_allocation_size < kMaximumAllocationForTabs &&
+  if (base_allocation_size < max_allocation_for_tabs &&
       !stubs_with_surface_foreground.empty())
-    bonus_allocation = (kMaximumAllocationForTabs - base_allocation_size) /
+    bonus_allocation = (max_allocation_for_tabs - base_allocation_size) /
                            stubs_with_surface_foreground.size();
 
   // Now give out allocations to everyone.
@@ -196,6 +220,56 @@ void GpuMemoryManager::Manage() {
 
   AssignMemoryAllocations(stubs_without_surface_hibernated,
       GpuMemoryAllocation(0, GpuMemoryAllocation::kHasNoBuffers));
+
+  // List the share groups from most to least important, each with the
+  // allocation of its most important stub.
+  std::vector<GpuCommandBufferStubBase*> share_groups;
+  std::vector<size_t> budgets;
+  AppendShareGroups(stubs_with_surface_foreground,
+                    kMinimumAllocationForTab + bonus_allocation,
+                    &share_groups, &budgets);
+  AppendShareGroups(stubs_without_surface_foreground,
+                    kMinimumAllocationForTab, &share_groups, &budgets);
+  AppendShareGroups(stubs_without_surface_background,
+                    kMinimumAllocationForTab, &share_groups, &budgets);
+  AppendShareGroups(stubs_with_surface_background, 0, &share_groups, &budgets);
+  AppendShareGroups(stubs_with_surface_hibernated, 0, &share_groups, &budgets);
+  AppendShareGroups(stubs_without_surface_hibernated, 0,
+                    &share_groups, &budgets);
+  PurgeMemory(share_groups, budgets);
+}
+
+// Textures are evicted in two tiers:
+//  1. Each share group is brought down to its budget. A group with a budget
+//     of 0, because it is in the background or hibernated, loses all its
+//     purgeable textures.
+//  2. If all the groups together still use more than max_memory_usage_, the
+//     remaining purgeable textures are evicted from the least important
+//     groups first until they fit.
+// Only purgeable textures are ever evicted, so a group can stay above its
+// budget if the rest of its memory is in use.
+void GpuMemoryManager::PurgeMemory(
+    const std::vector<GpuCommandBufferStubBase*>& stubs,
+    const std::vector<size_t>& budgets) {
+  DCHECK_EQ(stubs.size(), budgets.size());
+  std::vector<size_t> usages(stubs.size());
+  size_t total_usage = 0;
+  for (size_t i = 0; i < stubs.size(); ++i) {
+    usages[i] = stubs[i]->GetMemoryUsage();
+    if (usages[i] > budgets[i]) {
+      size_t freed = stubs[i]->PurgeMemory(usages[i] - budgets[i]);
+      usages[i] -= std::min(freed, usages[i]);
+    }
+    total_usage += usages[i];
+  }
+
+  for (size_t i = stubs.size(); i > 0 && total_usage > max_memory_usage_;
+       --i) {
+    if (!usages[i - 1])
+      continue;
+    size_t freed = stubs[i - 1]->PurgeMemory(total_usage - max_memory_usage_);
+    total_usage -= std::min(freed, total_usage);
+  }
 }
 
 #endif
@@ -51,10 +51,22 @@ class CONTENT_EXPORT GpuMemoryManager {
 
   void ScheduleManage();
 
+  // Sets how many bytes the textures and renderbuffers of all the contexts may
+  // take up together before purgeable textures are evicted to make room. The
+  // allocations handed out to the contexts are bounded by it too.
+  void set_max_memory_usage(size_t bytes) {
+    max_memory_usage_ = bytes;
+  }
+
  private:
   friend class GpuMemoryManagerTest;
   void Manage();
 
+  // Evicts purgeable textures from the share groups of |stubs|, which are
+  // ordered from most to least important and each given with their budget.
+  void PurgeMemory(const std::vector<GpuCommandBufferStubBase*>& stubs,
+                   const std::vector<size_t>& budgets);
+
   class CONTENT_EXPORT StubWithSurfaceComparator {
    public:
     bool operator()(GpuCommandBufferStubBase* lhs,
@@ -64,6 +76,7 @@ class CONTENT_EXPORT GpuMemoryManager {
   GpuMemoryManagerClient* client_;
   bool manage_scheduled_;
   size_t max_surfaces_with_frontbuffer_soft_limit_;
+  size_t max_memory_usage_;
   base::WeakPtrFactory<GpuMemoryManager> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(GpuMemoryManager);
@@ -2,16 +2,38 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
 #include "content/common/gpu/gpu_command_buffer_stub.h"
 #include "content/common/gpu/gpu_memory_allocation.h"
 #include "content/common/gpu/gpu_memory_manager.h"
 
 #include "testing/gtest/include/gtest/gtest.h"
 
+// Pretends that |purgeable_memory_| of |memory_usage_| can be purged.
+class FakeMemoryUsage {
+ public:
+  size_t memory_usage_;
+  size_t purgeable_memory_;
+
+  FakeMemoryUsage()
+      : memory_usage_(0),
+        purgeable_memory_(0) {
+  }
+
+  size_t Purge(size_t bytes) {
+    size_t freed = std::min(bytes, purgeable_memory_);
+    purgeable_memory_ -= freed;
+    memory_usage_ -= freed;
+    return freed;
+  }
+};
+
 class FakeCommandBufferStub : public GpuCommandBufferStubBase {
  public:
   SurfaceState surface_state_;
   GpuMemoryAllocation allocation_;
+  FakeMemoryUsage memory_;
 
   FakeCommandBufferStub()
       : surface_state_(0, false, base::TimeTicks()) {
@@ -42,12 +64,19 @@ class FakeCommandBufferStub : public GpuCommandBufferStubBase {
   virtual void SetMemoryAllocation(const GpuMemoryAllocation& alloc) {
     allocation_ = alloc;
   }
+  virtual size_t GetMemoryUsage() const {
+    return memory_.memory_usage_;
+  }
+  virtual size_t PurgeMemory(size_t bytes) {
+    return memory_.Purge(bytes);
+  }
 };
 
 class FakeCommandBufferStubWithoutSurface : public GpuCommandBufferStubBase {
  public:
   GpuMemoryAllocation allocation_;
   std::vector<GpuCommandBufferStubBase*> share_group_;
+  FakeMemoryUsage memory_;
 
   FakeCommandBufferStubWithoutSurface() {
   }
@@ -75,6 +104,12 @@ class FakeCommandBufferStubWithoutSurface : public GpuCommandBufferStubBase {
   virtual void SetMemoryAllocation(const GpuMemoryAllocation& alloc) {
     allocation_ = alloc;
   }
+  virtual size_t GetMemoryUsage() const {
+    return memory_.memory_usage_;
+  }
+  virtual size_t PurgeMemory(size_t bytes) {
+    return memory_.Purge(bytes);
+  }
 };
 
 class FakeClient : public GpuMemoryManagerClient {
@@ -523,6 +558,46 @@ TEST_F(GpuMemoryManagerTest, TestForegroundStubsGetBonusAllocation) {
             GpuMemoryManager::kMinimumAllocationForTab);
 }
 
+// Test GpuMemoryManager::Manage purges the purgeable memory of contexts that
+// use more than their allocation, and leaves the others alone.
+TEST_F(GpuMemoryManagerTest, TestContextsArePurgedToTheirAllocation) {
+  const size_t kMinimum = GpuMemoryManager::kMinimumAllocationForTab;
+  FakeCommandBufferStub stub1(GenerateUniqueSurfaceId(), true, newer_),
+                        stub2(GenerateUniqueSurfaceId(), false, older_);
+  stub1.memory_.memory_usage_ = kMinimum;
+  stub1.memory_.purgeable_memory_ = kMinimum;
+  stub2.memory_.memory_usage_ = kMinimum;
+  stub2.memory_.purgeable_memory_ = kMinimum / 2;
+  client_.stubs_.push_back(&stub1);
+  client_.stubs_.push_back(&stub2);
+
+  Manage();
+  EXPECT_EQ(kMinimum, stub1.memory_.memory_usage_);
+  // Background contexts with a surface are given nothing, so all that can be
+  // purged is.
+  EXPECT_EQ(kMinimum / 2, stub2.memory_.memory_usage_);
+  EXPECT_EQ(0u, stub2.memory_.purgeable_memory_);
+}
+
+// Test GpuMemoryManager::Manage purges the least important contexts first
+// when all of them together use more than the maximum.
+TEST_F(GpuMemoryManagerTest, TestLeastImportantContextsArePurgedFirst) {
+  const size_t kMinimum = GpuMemoryManager::kMinimumAllocationForTab;
+  memory_manager_.set_max_memory_usage(kMinimum * 3 / 2);
+  FakeCommandBufferStub stub1(GenerateUniqueSurfaceId(), true, older_),
+                        stub2(GenerateUniqueSurfaceId(), true, newer_);
+  stub1.memory_.memory_usage_ = kMinimum;
+  stub1.memory_.purgeable_memory_ = kMinimum;
+  stub2.memory_.memory_usage_ = kMinimum;
+  stub2.memory_.purgeable_memory_ = kMinimum;
+  client_.stubs_.push_back(&stub1);
+  client_.stubs_.push_back(&stub2);
+
+  Manage();
+  EXPECT_EQ(kMinimum / 2, stub1.memory_.memory_usage_);
+  EXPECT_EQ(kMinimum, stub2.memory_.memory_usage_);
+}
+
 // Test GpuMemoryAllocation comparison operators: Iterate over all possible
 // combinations of gpu_resource_size_in_bytes, suggest_have_backbuffer, and
 // suggest_have_frontbuffer, and make sure allocations with equal values test
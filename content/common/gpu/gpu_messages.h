@@ -209,6 +209,11 @@ IPC_MESSAGE_CONTROL0(GpuMsg_Crash)
 // Tells the GPU process to hang.
 IPC_MESSAGE_CONTROL0(GpuMsg_Hang)
 
+// Gives the GPU process a program binary that was cached in an earlier run.
+IPC_MESSAGE_CONTROL2(GpuMsg_LoadedProgram,
+                     std::string /* key */,
+                     std::string /* program */)
+
 //------------------------------------------------------------------------------
 // GPU Host Messages
 // These are messages to the browser.
@@ -237,6 +242,12 @@ IPC_MESSAGE_CONTROL1(GpuHostMsg_ChannelEstablished,
 IPC_MESSAGE_CONTROL1(GpuHostMsg_CommandBufferCreated,
                      int32 /* route_id */)
 
+// Sent by the GPU process when it caches a program binary, so that the browser
+// can keep it on disk for later runs.
+IPC_MESSAGE_CONTROL2(GpuHostMsg_CacheProgram,
+                     std::string /* key */,
+                     std::string /* program */)
+
 // Request from GPU to free the browser resources associated with the
 // command buffer.
 IPC_MESSAGE_CONTROL1(GpuHostMsg_DestroyCommandBuffer,
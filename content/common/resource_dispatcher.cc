@@ -382,27 +382,51 @@ void ResourceDispatcher::OnReceivedCachedMetadata(
     request_info->peer->OnReceivedCachedMetadata(&data.front(), data.size());
 }
 
+void ResourceDispatcher::OnSetDataBuffer(const IPC::Message& message,
+                                         int request_id,
+                                         base::SharedMemoryHandle shm_handle,
+                                         int shm_size) {
+  const bool shm_valid = base::SharedMemory::IsHandleValid(shm_handle);
+  DCHECK((shm_valid && shm_size > 0) || (!shm_valid && !shm_size));
+  linked_ptr<base::SharedMemory> shared_mem(
+      new base::SharedMemory(shm_handle, true));  // read only
+
+  PendingRequestInfo* request_info = GetPendingRequestInfo(request_id);
+  if (!request_info)
+    return;
+
+  // The data of the previous buffer, if any, has already been dispatched.
+  request_info->buffer.reset();
+  request_info->buffer_size = 0;
+  if (shm_size > 0 && shared_mem->Map(shm_size)) {
+    request_info->buffer = shared_mem;
+    request_info->buffer_size = shm_size;
+  }
+}
+
 void ResourceDispatcher::OnReceivedData(const IPC::Message& message,
                                         int request_id,
-                                        base::SharedMemoryHandle shm_handle,
-                                        int data_len,
+                                        int data_offset,
+                                        int data_length,
                                         int encoded_data_length) {
-  // Acknowledge the reception of this data.
+  // Acknowledge the reception of this data, so that the browser can reuse
+  // its part of the buffer.
   message_sender()->Send(
       new ResourceHostMsg_DataReceived_ACK(message.routing_id(), request_id));
 
-  const bool shm_valid = base::SharedMemory::IsHandleValid(shm_handle);
-  DCHECK((shm_valid && data_len > 0) || (!shm_valid && !data_len));
-  base::SharedMemory shared_mem(shm_handle, true);  // read only
-
   PendingRequestInfo* request_info = GetPendingRequestInfo(request_id);
-  if (!request_info)
+  if (!request_info || data_length <= 0 || !request_info->buffer.get())
     return;
 
-  if (data_len > 0 && shared_mem.Map(data_len)) {
-    const char* data = static_cast<char*>(shared_mem.memory());
-    request_info->peer->OnReceivedData(data, data_len, encoded_data_length);
+  if (data_offset < 0 ||
+      data_length > request_info->buffer_size - data_offset) {
+    NOTREACHED() << "data out of the buffer";
+    return;
   }
+
+  const char* data =
+      static_cast<char*>(request_info->buffer->memory()) + data_offset;
+  request_info->peer->OnReceivedData(data, data_length, encoded_data_length);
 }
 
 void ResourceDispatcher::OnDownloadedData(const IPC::Message& message,
@@ -556,6 +580,7 @@ void ResourceDispatcher::DispatchMessage(const IPC::Message& message) {
     IPC_MESSAGE_HANDLER(ResourceMsg_ReceivedCachedMetadata,
                         OnReceivedCachedMetadata)
     IPC_MESSAGE_HANDLER(ResourceMsg_ReceivedRedirect, OnReceivedRedirect)
+    IPC_MESSAGE_HANDLER(ResourceMsg_SetDataBuffer, OnSetDataBuffer)
     IPC_MESSAGE_HANDLER(ResourceMsg_DataReceived, OnReceivedData)
     IPC_MESSAGE_HANDLER(ResourceMsg_DataDownloaded, OnDownloadedData)
     IPC_MESSAGE_HANDLER(ResourceMsg_RequestComplete, OnRequestComplete)
@@ -664,6 +689,7 @@ bool ResourceDispatcher::IsResourceDispatcherMessage(
     case ResourceMsg_ReceivedResponse::ID:
     case ResourceMsg_ReceivedCachedMetadata::ID:
     case ResourceMsg_ReceivedRedirect::ID:
+    case ResourceMsg_SetDataBuffer::ID:
     case ResourceMsg_DataReceived::ID:
     case ResourceMsg_DataDownloaded::ID:
     case ResourceMsg_RequestComplete::ID:
@@ -688,7 +714,7 @@ void ResourceDispatcher::ReleaseResourcesInDataMessage(
 
   // If the message contains a shared memory handle, we should close the
   // handle or there will be a memory leak.
-  if (message.type() == ResourceMsg_DataReceived::ID) {
+  if (message.type() == ResourceMsg_SetDataBuffer::ID) {
     base::SharedMemoryHandle shm_handle;
     if (IPC::ParamTraits<base::SharedMemoryHandle>::Read(&message,
                                                          &iter,
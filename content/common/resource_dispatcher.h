@@ -73,7 +73,7 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Channel::Listener {
 
   typedef std::deque<IPC::Message*> MessageQueue;
   struct PendingRequestInfo {
-    PendingRequestInfo() { }
+    PendingRequestInfo() : buffer_size(0) { }
     PendingRequestInfo(webkit_glue::ResourceLoaderBridge::Peer* peer,
                        ResourceType::Type resource_type,
                        const GURL& request_url)
@@ -81,7 +81,8 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Channel::Listener {
           resource_type(resource_type),
           is_deferred(false),
           url(request_url),
-          request_start(base::TimeTicks::Now()) {
+          request_start(base::TimeTicks::Now()),
+          buffer_size(0) {
     }
     ~PendingRequestInfo() { }
     webkit_glue::ResourceLoaderBridge::Peer* peer;
@@ -93,6 +94,8 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Channel::Listener {
     base::TimeTicks request_start;
     base::TimeTicks response_start;
     base::TimeTicks completion_time;
+    linked_ptr<base::SharedMemory> buffer;  // The data of the request.
+    int buffer_size;
   };
   typedef base::hash_map<int, PendingRequestInfo> PendingRequestList;
 
@@ -116,11 +119,16 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Channel::Listener {
       int request_id,
       const GURL& new_url,
       const content::ResourceResponseHead& response_head);
+  void OnSetDataBuffer(
+      const IPC::Message& message,
+      int request_id,
+      base::SharedMemoryHandle shm_handle,
+      int shm_size);
   void OnReceivedData(
       const IPC::Message& message,
       int request_id,
-      base::SharedMemoryHandle data,
-      int data_len,
+      int data_offset,
+      int data_length,
       int encoded_data_length);
   void OnDownloadedData(
       const IPC::Message& message,
@@ -151,10 +159,10 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Channel::Listener {
   // Returns true if the message passed in is a resource related message.
   static bool IsResourceDispatcherMessage(const IPC::Message& message);
 
-  // ViewHostMsg_Resource_DataReceived is not POD, it has a shared memory
-  // handle in it that we should cleanup it up nicely. This method accepts any
-  // message and determine whether the message is
-  // ViewHostMsg_Resource_DataReceived and clean up the shared memory handle.
+  // ResourceMsg_SetDataBuffer is not POD, it has a shared memory handle in it
+  // that we should cleanup it up nicely. This method accepts any message and
+  // determine whether the message is ResourceMsg_SetDataBuffer and clean up
+  // the shared memory handle.
   static void ReleaseResourcesInDataMessage(const IPC::Message& message);
 
   // Iterate through a message queue and clean up the messages by calling
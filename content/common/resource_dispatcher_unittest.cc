@@ -130,10 +130,15 @@ class ResourceDispatcherTest : public testing::Test,
       base::SharedMemoryHandle dup_handle;
       EXPECT_TRUE(shared_mem.GiveToProcess(
           base::Process::Current().handle(), &dup_handle));
-      dispatcher_->OnReceivedData(
+      dispatcher_->OnSetDataBuffer(
           message_queue_[0],
           request_id,
           dup_handle,
+          test_page_contents_len);
+      dispatcher_->OnReceivedData(
+          message_queue_[0],
+          request_id,
+          0,
           test_page_contents_len,
           test_page_contents_len);
 
@@ -259,7 +264,13 @@ class DeferredResourceLoadingTest : public ResourceDispatcherTest,
                                               &duplicated_handle));
 
     response_message =
-        new ResourceMsg_DataReceived(0, 0, duplicated_handle, 100, 100);
+        new ResourceMsg_SetDataBuffer(0, 0, duplicated_handle, 100);
+
+    dispatcher_->OnMessageReceived(*response_message);
+
+    delete response_message;
+
+    response_message = new ResourceMsg_DataReceived(0, 0, 0, 100, 100);
 
     dispatcher_->OnMessageReceived(*response_message);
 
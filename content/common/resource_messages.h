@@ -153,12 +153,22 @@ IPC_MESSAGE_ROUTED3(ResourceMsg_ReceivedRedirect,
                     GURL /* new_url */,
                     content::ResourceResponseHead)
 
-// Sent when some data from a resource request is ready. The handle should
-// already be mapped into the process that receives this message.
+// Sent to hand the receiver the shared memory that the data of a request is
+// read into. It comes before the first ResourceMsg_DataReceived, and again
+// whenever the buffer is replaced. The handle should already be mapped into
+// the process that receives this message.
+IPC_MESSAGE_ROUTED3(ResourceMsg_SetDataBuffer,
+                    int /* request_id */,
+                    base::SharedMemoryHandle /* shm_handle */,
+                    int /* shm_size */)
+
+// Sent when some data from a resource request is ready. The data lives in the
+// buffer of the last ResourceMsg_SetDataBuffer, at |data_offset|, until the
+// receiver acknowledges it with ResourceHostMsg_DataReceived_ACK.
 IPC_MESSAGE_ROUTED4(ResourceMsg_DataReceived,
                     int /* request_id */,
-                    base::SharedMemoryHandle /* data */,
-                    int /* data_len */,
+                    int /* data_offset */,
+                    int /* data_length */,
                     int /* encoded_data_length */)
 
 // Sent when some data from a resource request has been downloaded to
@@ -22,6 +22,12 @@ BrowserMessageFilter::BrowserMessageFilter()
     : channel_(NULL), peer_handle_(base::kNullProcessHandle) {
 }
 
+BrowserMessageFilter::BrowserMessageFilter(uint32 message_class_to_filter)
+    : channel_(NULL),
+      peer_handle_(base::kNullProcessHandle),
+      message_classes_to_filter_(1, message_class_to_filter) {
+}
+
 BrowserMessageFilter::~BrowserMessageFilter() {
   base::CloseProcessHandle(peer_handle_);
 }
@@ -40,6 +46,14 @@ void BrowserMessageFilter::OnChannelConnected(int32 peer_pid) {
   }
 }
 
+bool BrowserMessageFilter::GetSupportedMessageClasses(
+    std::vector<uint32>* supported_message_classes) const {
+  if (message_classes_to_filter_.empty())
+    return false;
+  *supported_message_classes = message_classes_to_filter_;
+  return true;
+}
+
 bool BrowserMessageFilter::Send(IPC::Message* message) {
   if (message->is_sync()) {
     // We don't support sending synchronous messages from the browser.  If we
@@ -6,6 +6,8 @@
 #define CONTENT_PUBLIC_BROWSER_BROWSER_MESSAGE_FILTER_H_
 #pragma once
 
+#include <vector>
+
 #include "base/process.h"
 #include "content/common/content_export.h"
 #include "content/public/browser/browser_thread.h"
@@ -24,6 +26,10 @@ class CONTENT_EXPORT BrowserMessageFilter :
     public IPC::Message::Sender {
  public:
   BrowserMessageFilter();
+  // Only the messages of |message_class_to_filter| (an IPCMessageStart value)
+  // are passed to a filter created this way, which saves the channel from
+  // trying it on every message.
+  explicit BrowserMessageFilter(uint32 message_class_to_filter);
   virtual ~BrowserMessageFilter();
 
   // IPC::ChannelProxy::MessageFilter methods.  If you override them, make sure
@@ -33,6 +39,8 @@ class CONTENT_EXPORT BrowserMessageFilter :
   virtual void OnChannelConnected(int32 peer_pid) OVERRIDE;
   // DON'T OVERRIDE THIS!  Override the other version below.
   virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
+  virtual bool GetSupportedMessageClasses(
+      std::vector<uint32>* supported_message_classes) const OVERRIDE;
 
   // IPC::Message::Sender implementation.  Can be called on any thread.  Can't
   // send sync messages (since we don't want to block the browser on any other
@@ -83,6 +91,9 @@ class CONTENT_EXPORT BrowserMessageFilter :
 
   IPC::Channel* channel_;
   base::ProcessHandle peer_handle_;
+
+  // Empty if the filter sees every message.
+  std::vector<uint32> message_classes_to_filter_;
 };
 
 }  // namespace content
@@ -54,6 +54,10 @@ class GpuDataManager {
   // Register a path to the SwiftShader software renderer.
   virtual void RegisterSwiftShaderPath(const FilePath& path) = 0;
 
+  // Sets the directory the binaries of programs linked by the GPU process are
+  // cached in across runs. Nothing is cached on disk until it is set.
+  virtual void SetProgramCacheDirectory(const FilePath& path) = 0;
+
   virtual const base::ListValue& GetLogMessages() const = 0;
 
   // Registers/unregister |observer|.
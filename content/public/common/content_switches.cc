@@ -106,6 +106,10 @@ const char kDisableGLMultisampling[]        = "disable-gl-multisampling";
 const char kDisableGpuDriverBugWorkarounds[] =
     "disable-gpu-driver-bug-workarounds";
 
+// Disable caching the binaries of linked programs in the GPU process and on
+// disk.
+const char kDisableGpuProgramCache[]        = "disable-gpu-program-cache";
+
 // Disable the GPU process sandbox.
 const char kDisableGpuSandbox[]             = "disable-gpu-sandbox";
 
@@ -259,6 +263,11 @@ const char kEnablePointerLock[]             = "enable-pointer-lock";
 // Enable the Gamepad API
 const char kEnableGamepad[]                 = "enable-gamepad";
 
+// Schedule the contexts of a GPU channel by priority, so that onscreen
+// contexts run ahead of offscreen ones, and preempt contexts that have used up
+// their time slice while others are waiting.
+const char kEnableGpuContextScheduling[]    = "enable-gpu-context-scheduling";
+
 // Force logging to be enabled.  Logging is disabled by default in release
 // builds.
 const char kEnableLogging[]                 = "enable-logging";
@@ -380,9 +389,19 @@ const char kForceRendererAccessibility[]    = "force-renderer-accessibility";
 // for debugging). Use like renderer-cmd-prefix.
 const char kGpuLauncher[]                   = "gpu-launcher";
 
+// Limits the memory, in megabytes, that the textures and renderbuffers of all
+// GPU contexts may take up before purgeable textures are evicted.
+const char kGpuMemoryBudgetMb[]             = "gpu-memory-budget-mb";
+
 // Makes this process a GPU sub-process.
 const char kGpuProcess[]                    = "gpu-process";
 
+// Records the command buffers of all GPU contexts, and what the transfer
+// buffers they use hold, into files in the given directory, to be replayed by
+// command_buffer_replay. The GPU sandbox must be disabled for the files to be
+// written.
+const char kGpuRecordCommandBuffers[]       = "gpu-record-command-buffers";
+
 // Causes the GPU process to display a dialog on launch.
 const char kGpuStartupDialog[]              = "gpu-startup-dialog";
 
@@ -44,6 +44,7 @@ extern const char kDisableFileSystem[];
 extern const char kDisableGeolocation[];
 CONTENT_EXPORT extern const char kDisableGLMultisampling[];
 extern const char kDisableGpuDriverBugWorkarounds[];
+extern const char kDisableGpuProgramCache[];
 extern const char kDisableGpuSandbox[];
 extern const char kReduceGpuSandbox[];
 extern const char kDisableGpuWatchdog[];
@@ -89,6 +90,7 @@ CONTENT_EXPORT extern const char kEnableFixedLayout[];
 CONTENT_EXPORT extern const char kDisableFullScreen[];
 extern const char kEnablePointerLock[];
 extern const char kEnableGamepad[];
+extern const char kEnableGpuContextScheduling[];
 CONTENT_EXPORT extern const char kEnableLogging[];
 extern const char kEnableMediaSource[];
 extern const char kEnableMediaStream[];
@@ -119,7 +121,9 @@ CONTENT_EXPORT extern const char kForceCompositingMode[];
 extern const char kForceFieldTrials[];
 CONTENT_EXPORT extern const char kForceRendererAccessibility[];
 extern const char kGpuLauncher[];
+extern const char kGpuMemoryBudgetMb[];
 CONTENT_EXPORT extern const char kGpuProcess[];
+extern const char kGpuRecordCommandBuffers[];
 extern const char kGpuStartupDialog[];
 extern const char kInProcessGPU[];
 extern const char kInProcessPlugins[];
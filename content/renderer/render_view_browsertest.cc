@@ -61,6 +61,26 @@ TEST_F(RenderViewImplTest, OnNavStateChanged) {
       ViewHostMsg_UpdateState::ID));
 }
 
+// Test that the state of a page is only sent again once it has changed.
+TEST_F(RenderViewImplTest, UnchangedStateNotResent) {
+  LoadHTML("<input type=\"text\" id=\"elt_text\"></input>");
+  render_thread_->sink().ClearMessages();
+
+  view()->SyncNavigationState();
+  EXPECT_TRUE(render_thread_->sink().GetUniqueMessageMatching(
+      ViewHostMsg_UpdateState::ID));
+  render_thread_->sink().ClearMessages();
+
+  view()->SyncNavigationState();
+  EXPECT_FALSE(render_thread_->sink().GetFirstMessageMatching(
+      ViewHostMsg_UpdateState::ID));
+
+  ExecuteJavaScript("document.getElementById('elt_text').value = 'foo';");
+  view()->SyncNavigationState();
+  EXPECT_TRUE(render_thread_->sink().GetUniqueMessageMatching(
+      ViewHostMsg_UpdateState::ID));
+}
+
 TEST_F(RenderViewImplTest, DecideNavigationPolicy) {
   // Navigations to normal HTTP URLs can be handled locally.
   WebKit::WebURLRequest request(GURL("http://foo.com"));
@@ -452,6 +452,7 @@ RenderViewImpl::RenderViewImpl(
       navigation_gesture_(NavigationGestureUnknown),
       opened_by_user_gesture_(true),
       opener_suppressed_(false),
+      last_update_state_page_id_(-1),
       page_id_(-1),
       last_page_id_sent_to_browser_(-1),
       next_page_id_(next_page_id),
@@ -1266,6 +1267,8 @@ void RenderViewImpl::UpdateURL(WebFrame* frame) {
     params.content_state =
         webkit_glue::CreateHistoryStateForURL(GURL(request.url()));
   }
+  last_update_state_page_id_ = -1;
+  last_update_state_.clear();
 
   if (!frame->parent()) {
     // Top-level navigation.
@@ -1417,8 +1420,13 @@ void RenderViewImpl::SendUpdateState(const WebHistoryItem& item) {
   if (item.urlString() == WebString::fromUTF8(content::kSwappedOutURL))
     return;
 
-  Send(new ViewHostMsg_UpdateState(
-      routing_id_, page_id_, webkit_glue::HistoryItemToString(item)));
+  std::string state = webkit_glue::HistoryItemToString(item);
+  if (page_id_ == last_update_state_page_id_ && state == last_update_state_)
+    return;
+
+  Send(new ViewHostMsg_UpdateState(routing_id_, page_id_, state));
+  last_update_state_page_id_ = page_id_;
+  last_update_state_.swap(state);
 }
 
 void RenderViewImpl::OpenURL(WebFrame* frame,
@@ -726,6 +726,7 @@ class RenderViewImpl : public RenderWidget,
   FRIEND_TEST_ALL_PREFIXES(RenderViewImplTest, OnUpdateWebPreferences);
   FRIEND_TEST_ALL_PREFIXES(RenderViewImplTest, SendSwapOutACK);
   FRIEND_TEST_ALL_PREFIXES(RenderViewImplTest, StaleNavigationsIgnored);
+  FRIEND_TEST_ALL_PREFIXES(RenderViewImplTest, UnchangedStateNotResent);
   FRIEND_TEST_ALL_PREFIXES(RenderViewImplTest, UpdateTargetURLWithInvalidURL);
 #if defined(OS_MACOSX)
   FRIEND_TEST_ALL_PREFIXES(RenderViewTest, MacTestCmdUp);
@@ -1096,6 +1097,12 @@ class RenderViewImpl : public RenderWidget,
   // Timer used to delay the updating of nav state (see SyncNavigationState).
   base::OneShotTimer<RenderViewImpl> nav_state_sync_timer_;
 
+  // The page ID and state last sent with ViewHostMsg_UpdateState, so that an
+  // unchanged state isn't sent again. Forgotten whenever a FrameNavigate is
+  // sent, as committing also sets the browser's copy of the state.
+  int32 last_update_state_page_id_;
+  std::string last_update_state_;
+
   // Page IDs ------------------------------------------------------------------
   // See documentation in content::RenderView.
   int32 page_id_;
@@ -74,6 +74,11 @@ using content::RenderThread;
 
 namespace {
 
+// The refresh interval of a 60Hz display, which animations are paced at when
+// vsync is on. A whole 16ms would drift against the display, and drop or
+// repeat a frame every 400ms.
+const int64 kFrameIntervalUs = 16667;
+
 bool CanSendMessageWhileClosing(const IPC::Message* msg) {
   // We filter out most IPC messages when closing. However, some are
   // important for allowing pepper plugins to update their unsaved state
@@ -752,7 +757,8 @@ void RenderWidget::AnimationCallback() {
     // we posted the task to quantify how much the base::Time/base::TimeTicks
     // skew is affecting animations.
     base::TimeDelta animation_callback_delay = base::Time::Now() -
-        (animation_floor_time_ - base::TimeDelta::FromMilliseconds(16));
+        (animation_floor_time_ -
+         base::TimeDelta::FromMicroseconds(kFrameIntervalUs));
     UMA_HISTOGRAM_CUSTOM_TIMES("Renderer4.AnimationCallbackDelayTime",
                                animation_callback_delay,
                                base::TimeDelta::FromMilliseconds(0),
@@ -768,7 +774,7 @@ void RenderWidget::AnimateIfNeeded() {
 
   // Target 60FPS if vsync is on. Go as fast as we can if vsync is off.
   base::TimeDelta animationInterval = IsRenderingVSynced() ?
-      base::TimeDelta::FromMilliseconds(16) : base::TimeDelta();
+      base::TimeDelta::FromMicroseconds(kFrameIntervalUs) : base::TimeDelta();
 
   base::Time now = base::Time::Now();
 
@@ -1040,11 +1046,10 @@ void RenderWidget::didInvalidateRect(const WebRect& rect) {
       num_swapbuffers_complete_pending_ >= kMaxSwapBuffersPending)
     return;
 
-  // When GPU rendering, combine pending animations and invalidations into
-  // a single update.
-  if (is_accelerated_compositing_active_ &&
-      animation_update_pending_ &&
-      animation_timer_.IsRunning())
+  // Combine pending animations and invalidations into a single update, so
+  // that the damage is painted along with the next animation frame rather
+  // than in a frame of its own just before it.
+  if (animation_update_pending_ && animation_timer_.IsRunning())
     return;
 
   // Perform updating asynchronously.  This serves two purposes:
@@ -1080,11 +1085,10 @@ void RenderWidget::didScrollRect(int dx, int dy, const WebRect& clip_rect) {
       num_swapbuffers_complete_pending_ >= kMaxSwapBuffersPending)
     return;
 
-  // When GPU rendering, combine pending animations and invalidations into
-  // a single update.
-  if (is_accelerated_compositing_active_ &&
-      animation_update_pending_ &&
-      animation_timer_.IsRunning())
+  // Combine pending animations and invalidations into a single update, so
+  // that the damage is painted along with the next animation frame rather
+  // than in a frame of its own just before it.
+  if (animation_update_pending_ && animation_timer_.IsRunning())
     return;
 
   // Perform updating asynchronously.  This serves two purposes:
@@ -70,6 +70,7 @@
 #include "base/synchronization/lock.h"
 #include "content/common/child_process_sandbox_support_impl_linux.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/platform/linux/WebFontFamily.h"
+#include "third_party/WebKit/Source/WebKit/chromium/public/platform/linux/WebFontRenderStyle.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/platform/linux/WebSandboxSupport.h"
 #endif
 
@@ -154,6 +155,14 @@ class RendererWebKitPlatformSupportImpl::SandboxSupport
   // The value is a string containing the correct font family.
   base::Lock unicode_font_families_mutex_;
   std::map<string16, WebKit::WebFontFamily> unicode_font_families_;
+
+  // WebKit asks for the render style of every strike it creates, and each
+  // answer is a synchronous IPC to the browser, so those are cached too. The
+  // key is the font family and WebKit's packed size and style of the strike.
+  typedef std::map<std::pair<std::string, int>, WebKit::WebFontRenderStyle>
+      RenderStyleMap;
+  base::Lock render_styles_mutex_;
+  RenderStyleMap render_styles_;
 #endif
 };
 #endif  // defined(OS_ANDROID)
@@ -529,7 +538,16 @@ RendererWebKitPlatformSupportImpl::SandboxSupport::getFontFamilyForCharacters(
 void
 RendererWebKitPlatformSupportImpl::SandboxSupport::getRenderStyleForStrike(
     const char* family, int sizeAndStyle, WebKit::WebFontRenderStyle* out) {
+  base::AutoLock lock(render_styles_mutex_);
+  const std::pair<std::string, int> key(family, sizeAndStyle);
+  const RenderStyleMap::const_iterator iter = render_styles_.find(key);
+  if (iter != render_styles_.end()) {
+    *out = iter->second;
+    return;
+  }
+
   content::GetRenderStyleForStrike(family, sizeAndStyle, out);
+  render_styles_.insert(std::make_pair(key, *out));
 }
 
 #endif
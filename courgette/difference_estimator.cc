@@ -8,6 +8,8 @@
 
 #include "courgette/difference_estimator.h"
 
+#include <limits>
+
 #include "base/hash_tables.h"
 
 namespace courgette {
@@ -94,6 +96,11 @@ DifferenceEstimator::Subject* DifferenceEstimator::MakeSubject(
 }
 
 size_t DifferenceEstimator::Measure(Base* base, Subject* subject) {
+  return MeasureWithBound(base, subject, std::numeric_limits<size_t>::max());
+}
+
+size_t DifferenceEstimator::MeasureWithBound(Base* base, Subject* subject,
+                                             size_t bound) {
   size_t mismatches = 0;
   const uint8* start = subject->region().start();
   const uint8* end = subject->region().end() - (kTupleSize - 1);
@@ -103,6 +110,9 @@ size_t DifferenceEstimator::Measure(Base* base, Subject* subject) {
     size_t hash = HashTuple(p);
     if (base->hashes_.find(hash) == base->hashes_.end()) {
       ++mismatches;
+      // The result below is one more than the mismatches.
+      if (mismatches + 1 >= bound)
+        return mismatches + 1;
     }
     p += 1;
   }
@@ -47,6 +47,11 @@ class DifferenceEstimator {
   // are bytewise identical.
   size_t Measure(Base* base,  Subject* subject);
 
+  // Like Measure, but may stop early and return any value not less than
+  // |bound| once the difference is known to reach it.  Use this to find the
+  // best of many bases without measuring the poor matches in full.
+  size_t MeasureWithBound(Base* base,  Subject* subject, size_t bound);
+
  private:
   std::vector<Base*> owned_bases_;
   std::vector<Subject*> owned_subjects_;
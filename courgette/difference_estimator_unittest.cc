@@ -56,3 +56,18 @@ TEST(DifferenceEstimatorTest, TestDifferentSubstring) {
       difference_estimator.MakeSubject(Region(kString2, sizeof(kString2)-1));
   EXPECT_EQ(1U, difference_estimator.Measure(base, subject));
 }
+
+TEST(DifferenceEstimatorTest, TestBound) {
+  static const char kString1[] = "Hello world";
+  static const char kString2[] = "Hello universe";
+  DifferenceEstimator difference_estimator;
+  DifferenceEstimator::Base* base =
+      difference_estimator.MakeBase(Region(kString1, sizeof(kString1)));
+  DifferenceEstimator::Subject* subject =
+      difference_estimator.MakeSubject(Region(kString2, sizeof(kString2)));
+  // A bound above the difference doesn't change it.
+  EXPECT_EQ(10U, difference_estimator.MeasureWithBound(base, subject, 11));
+  // Otherwise the measure stops once it reaches the bound.
+  EXPECT_EQ(4U, difference_estimator.MeasureWithBound(base, subject, 4));
+  EXPECT_LE(10U, difference_estimator.MeasureWithBound(base, subject, 10));
+}
@@ -4,6 +4,8 @@
 
 #include "crypto/encryptor.h"
 
+#include <string.h>
+
 #include "base/logging.h"
 #include "base/sys_byteorder.h"
 
@@ -90,7 +92,18 @@ void Encryptor::MaskMessage(const void* plaintext,
   const uint8* mask_ptr = reinterpret_cast<const uint8*>(mask);
   uint8* ciphertext_ptr = reinterpret_cast<uint8*>(ciphertext);
 
-  for (size_t i = 0; i < plaintext_len; ++i)
+  // XOR a word at a time; the buffers needn't be aligned, and |mask| may be
+  // |ciphertext|, so the words are copied in and out.
+  size_t i = 0;
+  for (; i + sizeof(uint64) <= plaintext_len; i += sizeof(uint64)) {
+    uint64 plaintext_word;
+    uint64 mask_word;
+    memcpy(&plaintext_word, plaintext_ptr + i, sizeof(plaintext_word));
+    memcpy(&mask_word, mask_ptr + i, sizeof(mask_word));
+    plaintext_word ^= mask_word;
+    memcpy(ciphertext_ptr + i, &plaintext_word, sizeof(plaintext_word));
+  }
+  for (; i < plaintext_len; ++i)
     ciphertext_ptr[i] = plaintext_ptr[i] ^ mask_ptr[i];
 }
 
@@ -365,22 +365,16 @@ DBusHandlerResult ObjectProxy::HandleMessage(
   if (dbus_message_get_type(raw_message) != DBUS_MESSAGE_TYPE_SIGNAL)
     return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
 
-  // raw_message will be unrefed on exit of the function. Increment the
-  // reference so we can use it in Signal.
-  dbus_message_ref(raw_message);
-  scoped_ptr<Signal> signal(
-      Signal::FromRawMessage(raw_message));
-
   // Verify the signal comes from the object we're proxying for, this is
   // our last chance to return DBUS_HANDLER_RESULT_NOT_YET_HANDLED and
-  // allow other object proxies to handle instead.
-  const dbus::ObjectPath path = signal->GetPath();
-  if (path != object_path_) {
+  // allow other object proxies to handle instead. Every object proxy's
+  // filter sees every signal on the bus, so this is checked on the raw
+  // message, without copying anything out of it.
+  const char* path = dbus_message_get_path(raw_message);
+  const char* interface = dbus_message_get_interface(raw_message);
+  const char* member = dbus_message_get_member(raw_message);
+  if (!path || !interface || !member || object_path_.value() != path)
     return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
-  }
-
-  const std::string interface = signal->GetInterface();
-  const std::string member = signal->GetMember();
 
   // Check if we know about the signal.
   const std::string absolute_signal_name = GetAbsoluteSignalName(
@@ -390,6 +384,12 @@ DBusHandlerResult ObjectProxy::HandleMessage(
     // Don't know about the signal.
     return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
   }
+
+  // raw_message will be unrefed on exit of the function. Increment the
+  // reference so we can use it in Signal.
+  dbus_message_ref(raw_message);
+  scoped_ptr<Signal> signal(
+      Signal::FromRawMessage(raw_message));
   VLOG(1) << "Signal received: " << signal->ToString();
 
   const base::TimeTicks start_time = base::TimeTicks::Now();
@@ -405,7 +405,6 @@ DBusHandlerResult ObjectProxy::HandleMessage(
                                             iter->second,
                                             released_signal));
   } else {
-    const base::TimeTicks start_time = base::TimeTicks::Now();
     // If the D-Bus thread is not used, just call the callback on the
     // current thread. Transfer the ownership of |signal| to RunMethod().
     Signal* released_signal = signal.release();
@@ -363,6 +363,8 @@ class ClientSideBufferHelper {
 #if !defined(_MSC_VER)
 const size_t GLES2Implementation::kMaxSizeOfSimpleResult;
 const unsigned int GLES2Implementation::kStartingOffset;
+const uint32 GLES2Implementation::kMinMappedUploadSize;
+const size_t GLES2Implementation::kMaxMappedUploadMemory;
 #endif
 
 GLES2Implementation::SingleThreadChecker::SingleThreadChecker(
@@ -394,6 +396,7 @@ GLES2Implementation::GLES2Implementation(
       unpack_skip_pixels_(0),
       pack_reverse_row_order_(false),
       active_texture_unit_(0),
+      current_program_(0),
       bound_framebuffer_(0),
       bound_renderbuffer_(0),
       bound_array_buffer_id_(0),
@@ -1616,6 +1619,20 @@ void GLES2Implementation::TexImage2D(
         unpack_skip_pixels_ * group_size;
   }
 
+  int32 shm_id;
+  uint32 shm_offset;
+  void* mem = AllocMappedUpload(size, &shm_id, &shm_offset);
+  if (mem) {
+    CopyRectToBuffer(
+        pixels, height, unpadded_row_size, src_padded_row_size, unpack_flip_y_,
+        mem, padded_row_size);
+    helper_->TexImage2D(
+        target, level, internalformat, width, height, border, format, type,
+        shm_id, shm_offset);
+    mapped_memory_->FreePendingToken(mem, helper_->InsertToken());
+    return;
+  }
+
   // Check if we can send it all at once.
   ScopedTransferBufferPtr buffer(size, helper_, transfer_buffer_);
   if (!buffer.valid()) {
@@ -1694,6 +1711,20 @@ void GLES2Implementation::TexSubImage2D(
         unpack_skip_pixels_ * group_size;
   }
 
+  int32 shm_id;
+  uint32 shm_offset;
+  void* mem = AllocMappedUpload(temp_size, &shm_id, &shm_offset);
+  if (mem) {
+    CopyRectToBuffer(
+        pixels, height, unpadded_row_size, src_padded_row_size, unpack_flip_y_,
+        mem, padded_row_size);
+    helper_->TexSubImage2D(
+        target, level, xoffset, yoffset, width, height, format, type,
+        shm_id, shm_offset, GL_FALSE);
+    mapped_memory_->FreePendingToken(mem, helper_->InsertToken());
+    return;
+  }
+
   ScopedTransferBufferPtr buffer(temp_size, helper_, transfer_buffer_);
   TexSubImage2DImpl(
       target, level, xoffset, yoffset, width, height, format, type,
@@ -1752,6 +1783,15 @@ void GLES2Implementation::TexSubImage2DImpl(
   }
 }
 
+void* GLES2Implementation::AllocMappedUpload(
+    uint32 size, int32* shm_id, uint32* shm_offset) {
+  if (size < kMinMappedUploadSize) {
+    return NULL;
+  }
+  return mapped_memory_->AllocWithLimit(
+      size, kMaxMappedUploadMemory, shm_id, shm_offset);
+}
+
 bool GLES2Implementation::GetActiveAttribHelper(
     GLuint program, GLuint index, GLsizei bufsize, GLsizei* length, GLint* size,
     GLenum* type, char* name) {
@@ -2164,10 +2204,109 @@ void GLES2Implementation::ActiveTexture(GLenum texture) {
     return;
   }
 
+  if (active_texture_unit_ == texture_index)
+    return;
+
   active_texture_unit_ = texture_index;
   helper_->ActiveTexture(texture);
 }
 
+GLES2Implementation::Capabilities::Capabilities()
+    : blend(false),
+      cull_face(false),
+      depth_test(false),
+      dither(true),
+      polygon_offset_fill(false),
+      sample_alpha_to_coverage(false),
+      sample_coverage(false),
+      scissor_test(false),
+      stencil_test(false) {
+}
+
+bool* GLES2Implementation::GetCapabilityState(GLenum cap) {
+  switch (cap) {
+    case GL_BLEND:
+      return &capabilities_.blend;
+    case GL_CULL_FACE:
+      return &capabilities_.cull_face;
+    case GL_DEPTH_TEST:
+      return &capabilities_.depth_test;
+    case GL_DITHER:
+      return &capabilities_.dither;
+    case GL_POLYGON_OFFSET_FILL:
+      return &capabilities_.polygon_offset_fill;
+    case GL_SAMPLE_ALPHA_TO_COVERAGE:
+      return &capabilities_.sample_alpha_to_coverage;
+    case GL_SAMPLE_COVERAGE:
+      return &capabilities_.sample_coverage;
+    case GL_SCISSOR_TEST:
+      return &capabilities_.scissor_test;
+    case GL_STENCIL_TEST:
+      return &capabilities_.stencil_test;
+    default:
+      return NULL;
+  }
+}
+
+bool GLES2Implementation::SetCapabilityState(GLenum cap, bool enabled) {
+  // Invalid capabilities go to the service, which sets the error.
+  bool* state = GetCapabilityState(cap);
+  if (!state)
+    return true;
+  if (*state == enabled)
+    return false;
+  *state = enabled;
+  return true;
+}
+
+void GLES2Implementation::Enable(GLenum cap) {
+  GPU_CLIENT_SINGLE_THREAD_CHECK();
+  GPU_CLIENT_LOG("[" << this << "] glEnable("
+      << GLES2Util::GetStringCapability(cap) << ")");
+  if (SetCapabilityState(cap, true))
+    helper_->Enable(cap);
+}
+
+void GLES2Implementation::Disable(GLenum cap) {
+  GPU_CLIENT_SINGLE_THREAD_CHECK();
+  GPU_CLIENT_LOG("[" << this << "] glDisable("
+      << GLES2Util::GetStringCapability(cap) << ")");
+  if (SetCapabilityState(cap, false))
+    helper_->Disable(cap);
+}
+
+GLboolean GLES2Implementation::IsEnabled(GLenum cap) {
+  GPU_CLIENT_SINGLE_THREAD_CHECK();
+  GPU_CLIENT_LOG("[" << this << "] glIsEnabled("
+      << GLES2Util::GetStringCapability(cap) << ")");
+  const bool* state = GetCapabilityState(cap);
+  if (state) {
+    GPU_CLIENT_LOG("returned " << *state);
+    return *state;
+  }
+
+  typedef IsEnabled::Result Result;
+  Result* result = GetResultAs<Result*>();
+  if (!result) {
+    return GL_FALSE;
+  }
+  *result = 0;
+  helper_->IsEnabled(cap, GetResultShmId(), GetResultShmOffset());
+  WaitForCmd();
+  GPU_CLIENT_LOG("returned " << *result);
+  return *result;
+}
+
+void GLES2Implementation::UseProgram(GLuint program) {
+  GPU_CLIENT_SINGLE_THREAD_CHECK();
+  GPU_CLIENT_LOG("[" << this << "] glUseProgram(" << program << ")");
+  if (current_program_ == program)
+    return;
+
+  current_program_ = program;
+  helper_->UseProgram(program);
+}
+
 // NOTE #1: On old versions of OpenGL, calling glBindXXX with an unused id
 // generates a new resource. On newer versions of OpenGL they don't. The code
 // related to binding below will need to change if we switch to the new OpenGL
@@ -2175,14 +2314,26 @@ void GLES2Implementation::ActiveTexture(GLenum texture) {
 // the old model but possibly not true in the new model if another context has
 // deleted the resource.
 
-void GLES2Implementation::BindBufferHelper(
+bool GLES2Implementation::BindingsAreCached() const {
+  // Binds of ids the service doesn't know fail unless binding generates
+  // resources. When resources are shared, another context can delete an
+  // object that is bound here and its id be handed out again, and binding
+  // that id again has to pick up the new object.
+  return share_group_->bind_generates_resource() &&
+         !share_group_->sharing_resources();
+}
+
+bool GLES2Implementation::BindBufferHelper(
     GLenum target, GLuint buffer) {
   // TODO(gman): See note #1 above.
+  bool changed = true;
   switch (target) {
     case GL_ARRAY_BUFFER:
+      changed = bound_array_buffer_id_ != buffer;
       bound_array_buffer_id_ = buffer;
       break;
     case GL_ELEMENT_ARRAY_BUFFER:
+      changed = bound_element_array_buffer_id_ != buffer;
       bound_element_array_buffer_id_ = buffer;
       break;
     default:
@@ -2191,6 +2342,7 @@ void GLES2Implementation::BindBufferHelper(
   // TODO(gman): There's a bug here. If the target is invalid the ID will not be
   // used even though it's marked it as used here.
   GetIdHandler(id_namespaces::kBuffers)->MarkAsUsedForBind(buffer);
+  return changed || !BindingsAreCached();
 }
 
 void GLES2Implementation::BindFramebufferHelper(
@@ -2223,14 +2375,17 @@ void GLES2Implementation::BindRenderbufferHelper(
   GetIdHandler(id_namespaces::kRenderbuffers)->MarkAsUsedForBind(renderbuffer);
 }
 
-void GLES2Implementation::BindTextureHelper(GLenum target, GLuint texture) {
+bool GLES2Implementation::BindTextureHelper(GLenum target, GLuint texture) {
   // TODO(gman): See note #1 above.
   TextureUnit& unit = texture_units_[active_texture_unit_];
+  bool changed = true;
   switch (target) {
     case GL_TEXTURE_2D:
+      changed = unit.bound_texture_2d != texture;
       unit.bound_texture_2d = texture;
       break;
     case GL_TEXTURE_CUBE_MAP:
+      changed = unit.bound_texture_cube_map != texture;
       unit.bound_texture_cube_map = texture;
       break;
     default:
@@ -2239,6 +2394,7 @@ void GLES2Implementation::BindTextureHelper(GLenum target, GLuint texture) {
   // TODO(gman): There's a bug here. If the target is invalid the ID will not be
   // used. even though it's marked it as used here.
   GetIdHandler(id_namespaces::kTextures)->MarkAsUsedForBind(texture);
+  return changed || !BindingsAreCached();
 }
 
 #if defined(GLES2_SUPPORT_CLIENT_SIDE_ARRAYS)
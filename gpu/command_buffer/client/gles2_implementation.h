@@ -152,6 +152,15 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
   // Number of swap buffers allowed before waiting.
   static const size_t kMaxSwapBuffers = 2;
 
+  // Texture uploads at least this big are copied into mapped memory of their
+  // own rather than through the transfer buffer, so that they go in one
+  // command and don't wait for the transfer buffer to drain.
+  static const uint32 kMinMappedUploadSize = 256 * 1024;
+
+  // The most mapped memory texture uploads can hold at once. Past this,
+  // uploads go through the transfer buffer.
+  static const size_t kMaxMappedUploadMemory = 32 * 1024 * 1024;
+
   GLES2Implementation(
       GLES2CmdHelper* helper,
       ShareGroup* share_group,
@@ -314,6 +323,21 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
     GLuint bound_texture_cube_map;
   };
 
+  // The capabilities as last set by glEnable and glDisable.
+  struct Capabilities {
+    Capabilities();
+
+    bool blend;
+    bool cull_face;
+    bool depth_test;
+    bool dither;
+    bool polygon_offset_fill;
+    bool sample_alpha_to_coverage;
+    bool sample_coverage;
+    bool scissor_test;
+    bool stencil_test;
+  };
+
   // Checks for single threaded access.
   class SingleThreadChecker {
    public:
@@ -377,10 +401,24 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
   bool IsRenderbufferReservedId(GLuint id) { return false; }
   bool IsTextureReservedId(GLuint id) { return false; }
 
-  void BindBufferHelper(GLenum target, GLuint texture);
+  // These return false if the binding is known to be in place already, in
+  // which case the command doesn't need to be sent.
+  bool BindBufferHelper(GLenum target, GLuint texture);
+  bool BindTextureHelper(GLenum target, GLuint texture);
+
+  // Whether the cached buffer and texture bindings match the service's.
+  bool BindingsAreCached() const;
+
   void BindFramebufferHelper(GLenum target, GLuint texture);
   void BindRenderbufferHelper(GLenum target, GLuint texture);
-  void BindTextureHelper(GLenum target, GLuint texture);
+
+  // Returns the cached state of |cap|, or NULL if it isn't a capability that
+  // is cached.
+  bool* GetCapabilityState(GLenum cap);
+
+  // Records the new state of |cap|. Returns false if |cap| is known to be in
+  // that state already, in which case the command doesn't need to be sent.
+  bool SetCapabilityState(GLenum cap, bool enabled);
 
   void DeleteBuffersHelper(GLsizei n, const GLuint* buffers);
   void DeleteFramebuffersHelper(GLsizei n, const GLuint* framebuffers);
@@ -421,6 +459,12 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
       const void* pixels, uint32 pixels_padded_row_size, GLboolean internal,
       ScopedTransferBufferPtr* buffer, uint32 buffer_padded_row_size);
 
+  // Returns |size| bytes of mapped memory for a texture upload, or NULL if
+  // the upload is too small to be worth it or the memory isn't available.
+  // The memory must be passed to FreePendingToken once the command using it
+  // has been issued.
+  void* AllocMappedUpload(uint32 size, int32* shm_id, uint32* shm_offset);
+
   // Helpers for query functions.
   bool GetHelper(GLenum pname, GLint* params);
   bool GetBooleanvHelper(GLenum pname, GLboolean* params);
@@ -479,6 +523,12 @@ class GLES2_IMPL_EXPORT GLES2Implementation {
   // 0 to gl_state_.max_combined_texture_image_units.
   GLuint active_texture_unit_;
 
+  Capabilities capabilities_;
+
+  // The program last passed to glUseProgram. Program ids are never reused,
+  // so this stays right even if the program is deleted.
+  GLuint current_program_;
+
   GLuint bound_framebuffer_;
   GLuint bound_renderbuffer_;
 
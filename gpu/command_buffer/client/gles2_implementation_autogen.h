@@ -28,8 +28,8 @@ void BindBuffer(GLenum target, GLuint buffer) {
     SetGLError(GL_INVALID_OPERATION, "BindBuffer: buffer reserved id");
     return;
   }
-  BindBufferHelper(target, buffer);
-  helper_->BindBuffer(target, buffer);
+  if (BindBufferHelper(target, buffer))
+    helper_->BindBuffer(target, buffer);
 }
 
 void BindFramebuffer(GLenum target, GLuint framebuffer) {
@@ -63,8 +63,8 @@ void BindTexture(GLenum target, GLuint texture) {
     SetGLError(GL_INVALID_OPERATION, "BindTexture: texture reserved id");
     return;
   }
-  BindTextureHelper(target, texture);
-  helper_->BindTexture(target, texture);
+  if (BindTextureHelper(target, texture))
+    helper_->BindTexture(target, texture);
 }
 
 void BlendColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha) {
@@ -350,23 +350,14 @@ void DetachShader(GLuint program, GLuint shader) {
   helper_->DetachShader(program, shader);
 }
 
-void Disable(GLenum cap) {
-  GPU_CLIENT_SINGLE_THREAD_CHECK();
-  GPU_CLIENT_LOG("[" << this << "] glDisable(" << GLES2Util::GetStringCapability(cap) << ")");  // NOLINT
-  helper_->Disable(cap);
-}
+void Disable(GLenum cap);
 
 void DrawArrays(GLenum mode, GLint first, GLsizei count);
 
 void DrawElements(
     GLenum mode, GLsizei count, GLenum type, const void* indices);
 
-void Enable(GLenum cap) {
-  GPU_CLIENT_SINGLE_THREAD_CHECK();
-  GPU_CLIENT_LOG("[" << this << "] glEnable(" << GLES2Util::GetStringCapability(
-      cap) << ")");
-  helper_->Enable(cap);
-}
+void Enable(GLenum cap);
 
 void Finish();
 
@@ -828,20 +819,7 @@ GLboolean IsBuffer(GLuint buffer) {
   return *result;
 }
 
-GLboolean IsEnabled(GLenum cap) {
-  GPU_CLIENT_SINGLE_THREAD_CHECK();
-  GPU_CLIENT_LOG("[" << this << "] glIsEnabled(" << GLES2Util::GetStringCapability(cap) << ")");  // NOLINT
-  typedef IsEnabled::Result Result;
-  Result* result = GetResultAs<Result*>();
-  if (!result) {
-    return GL_FALSE;
-  }
-  *result = 0;
-  helper_->IsEnabled(cap, GetResultShmId(), GetResultShmOffset());
-  WaitForCmd();
-  GPU_CLIENT_LOG("returned " << *result);
-  return *result;
-}
+GLboolean IsEnabled(GLenum cap);
 
 GLboolean IsFramebuffer(GLuint framebuffer) {
   GPU_CLIENT_SINGLE_THREAD_CHECK();
@@ -1274,11 +1252,7 @@ void UniformMatrix4fv(
   helper_->UniformMatrix4fvImmediate(location, count, transpose, value);
 }
 
-void UseProgram(GLuint program) {
-  GPU_CLIENT_SINGLE_THREAD_CHECK();
-  GPU_CLIENT_LOG("[" << this << "] glUseProgram(" << program << ")");
-  helper_->UseProgram(program);
-}
+void UseProgram(GLuint program);
 
 void ValidateProgram(GLuint program) {
   GPU_CLIENT_SINGLE_THREAD_CHECK();
@@ -1836,6 +1836,50 @@ TEST_F(GLES2ImplementationTest, GetIntegerCacheWrite) {
   EXPECT_EQ(static_cast<GLenum>(GL_NO_ERROR), gl_->GetError());
 }
 
+TEST_F(GLES2ImplementationTest, RedundantStateChangesNotSent) {
+  struct Cmds {
+    Enable enable;
+    UseProgram use_program;
+    ActiveTexture active_texture;
+    BindTexture bind_texture;
+    BindBuffer bind_buffer;
+    Disable disable;
+  };
+  Cmds expected;
+  expected.enable.Init(GL_BLEND);
+  expected.use_program.Init(1);
+  expected.active_texture.Init(GL_TEXTURE1);
+  expected.bind_texture.Init(GL_TEXTURE_2D, 2);
+  expected.bind_buffer.Init(GL_ARRAY_BUFFER, 3);
+  expected.disable.Init(GL_BLEND);
+
+  const void* commands = GetPut();
+  for (int ii = 0; ii < 2; ++ii) {
+    gl_->Enable(GL_BLEND);
+    gl_->UseProgram(1);
+    gl_->ActiveTexture(GL_TEXTURE1);
+    gl_->BindTexture(GL_TEXTURE_2D, 2);
+    gl_->BindBuffer(GL_ARRAY_BUFFER, 3);
+  }
+  gl_->Disable(GL_BLEND);
+  gl_->Disable(GL_BLEND);
+  gl_->Disable(GL_SCISSOR_TEST);
+  EXPECT_EQ(0, memcmp(&expected, commands, sizeof(expected)));
+  EXPECT_EQ(static_cast<const void*>(
+                static_cast<const int8*>(commands) + sizeof(expected)),
+            GetPut());
+}
+
+TEST_F(GLES2ImplementationTest, IsEnabledCached) {
+  gl_->Enable(GL_SCISSOR_TEST);
+  gl_->Disable(GL_DITHER);
+  const void* commands = GetPut();
+  EXPECT_TRUE(gl_->IsEnabled(GL_SCISSOR_TEST));
+  EXPECT_FALSE(gl_->IsEnabled(GL_DITHER));
+  EXPECT_FALSE(gl_->IsEnabled(GL_BLEND));
+  EXPECT_EQ(commands, GetPut());
+}
+
 static bool CheckRect(
     int width, int height, GLenum format, GLenum type, int alignment,
     bool flip_y, const uint8* r1, const uint8* r2) {
@@ -2031,6 +2075,43 @@ TEST_F(GLES2ImplementationTest, TexImage2D2Writes) {
       pixels.get() + kHeight / 2 * padded_row_size, mem4.ptr));
 }
 
+TEST_F(GLES2ImplementationTest, TexImage2DLargeUsesMappedMemory) {
+  struct Cmds {
+    TexImage2D tex_image_2d;
+    cmd::SetToken set_token;
+  };
+  const GLenum kTarget = GL_TEXTURE_2D;
+  const GLint kLevel = 0;
+  const GLenum kFormat = GL_RGBA;
+  const GLint kBorder = 0;
+  const GLenum kType = GL_UNSIGNED_BYTE;
+  const GLint kPixelStoreUnpackAlignment = 4;
+  const GLsizei kWidth = 256;
+  const GLsizei kHeight = 256;
+
+  uint32 size = 0;
+  ASSERT_TRUE(GLES2Util::ComputeImageDataSizes(
+      kWidth, kHeight, kFormat, kType, kPixelStoreUnpackAlignment,
+      &size, NULL, NULL));
+  ASSERT_GE(size, GLES2Implementation::kMinMappedUploadSize);
+  scoped_array<uint8> pixels(new uint8[size]);
+  for (uint32 ii = 0; ii < size; ++ii) {
+    pixels[ii] = static_cast<uint8>(ii);
+  }
+
+  // The whole image goes in one command, from a new chunk of mapped memory.
+  Cmds expected;
+  expected.tex_image_2d.Init(
+      kTarget, kLevel, kFormat, kWidth, kHeight, kBorder, kFormat, kType,
+      command_buffer()->GetNextFreeTransferBufferId(), 0);
+  expected.set_token.Init(GetNextToken());
+
+  gl_->TexImage2D(
+      kTarget, kLevel, kFormat, kWidth, kHeight, kBorder, kFormat, kType,
+      pixels.get());
+  EXPECT_EQ(0, memcmp(&expected, commands_, sizeof(expected)));
+}
+
 // Test TexSubImage2D with GL_PACK_FLIP_Y set and partial multirow transfers
 TEST_F(GLES2ImplementationTest, TexSubImage2DFlipY) {
   const GLsizei kTextureWidth = MaxTransferBufferSize() / 4;
@@ -2252,6 +2333,24 @@ TEST_F(GLES2ImplementationStrictSharedTest, BindsNotCached) {
   }
 }
 
+TEST_F(GLES2ImplementationStrictSharedTest, RepeatedBindsSent) {
+  struct Cmds {
+    BindTexture bind1;
+    BindTexture bind2;
+  };
+  GLuint texture = 0;
+  gl_->GenTextures(1, &texture);
+  Cmds expected;
+  expected.bind1.Init(GL_TEXTURE_2D, texture);
+  expected.bind2.Init(GL_TEXTURE_2D, texture);
+
+  // Another context could have deleted the texture and had its id again.
+  const void* commands = GetPut();
+  gl_->BindTexture(GL_TEXTURE_2D, texture);
+  gl_->BindTexture(GL_TEXTURE_2D, texture);
+  EXPECT_EQ(0, memcmp(&expected, commands, sizeof(expected)));
+}
+
 TEST_F(GLES2ImplementationTest, CreateStreamTextureCHROMIUM) {
   const GLuint kTextureId = 123;
   const GLuint kResult = 456;
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <limits>
 
 #include "../client/mapped_memory.h"
 #include "../client/cmd_buffer_helper.h"
@@ -24,7 +25,8 @@ MemoryChunk::MemoryChunk(
 
 MappedMemoryManager::MappedMemoryManager(CommandBufferHelper* helper)
     : chunk_size_multiple_(1),
-      helper_(helper) {
+      helper_(helper),
+      allocated_memory_(0) {
 }
 
 MappedMemoryManager::~MappedMemoryManager() {
@@ -36,6 +38,13 @@ MappedMemoryManager::~MappedMemoryManager() {
 
 void* MappedMemoryManager::Alloc(
     unsigned int size, int32* shm_id, unsigned int* shm_offset) {
+  return AllocWithLimit(
+      size, std::numeric_limits<size_t>::max(), shm_id, shm_offset);
+}
+
+void* MappedMemoryManager::AllocWithLimit(
+    unsigned int size, size_t max_allocated_memory,
+    int32* shm_id, unsigned int* shm_offset) {
   GPU_DCHECK(shm_id);
   GPU_DCHECK(shm_offset);
   // See if any of the chucks can satisfy this request.
@@ -56,6 +65,10 @@ void* MappedMemoryManager::Alloc(
   unsigned int chunk_size =
       ((size + chunk_size_multiple_ - 1) / chunk_size_multiple_) *
       chunk_size_multiple_;
+  if (chunk_size > max_allocated_memory ||
+      allocated_memory_ > max_allocated_memory - chunk_size) {
+    return NULL;
+  }
   int32 id = cmd_buf->CreateTransferBuffer(chunk_size, -1);
   if (id == -1) {
     return NULL;
@@ -63,6 +76,7 @@ void* MappedMemoryManager::Alloc(
   gpu::Buffer shm = cmd_buf->GetTransferBuffer(id);
   MemoryChunk* mc = new MemoryChunk(id, shm, helper_);
   chunks_.push_back(mc);
+  allocated_memory_ += mc->GetSize();
   void* mem = mc->Alloc(size);
   GPU_DCHECK(mem);
   *shm_id = mc->shm_id();
@@ -100,6 +114,7 @@ void MappedMemoryManager::FreeUnused() {
     chunk->FreeUnused();
     if (!chunk->InUse()) {
       cmd_buf->DestroyTransferBuffer(chunk->shm_id());
+      allocated_memory_ -= chunk->GetSize();
       iter = chunks_.erase(iter);
     } else {
       ++iter;
@@ -129,6 +129,12 @@ class GPU_EXPORT MappedMemoryManager {
   void* Alloc(
       unsigned int size, int32* shm_id, unsigned int* shm_offset);
 
+  // Allocates a block of memory like Alloc, but fails rather than add a
+  // chunk that would take the allocated memory past |max_allocated_memory|.
+  void* AllocWithLimit(
+      unsigned int size, size_t max_allocated_memory,
+      int32* shm_id, unsigned int* shm_offset);
+
   // Frees a block of memory.
   //
   // Parameters:
@@ -146,6 +152,11 @@ class GPU_EXPORT MappedMemoryManager {
   // Free Any Shared memory that is not in use.
   void FreeUnused();
 
+  // The total size of the chunks.
+  size_t allocated_memory() const {
+    return allocated_memory_;
+  }
+
   // Used for testing
   size_t num_chunks() {
     return chunks_.size();
@@ -158,6 +169,7 @@ class GPU_EXPORT MappedMemoryManager {
   unsigned int chunk_size_multiple_;
   CommandBufferHelper* helper_;
   MemoryChunkVector chunks_;
+  size_t allocated_memory_;
 
   DISALLOW_COPY_AND_ASSIGN(MappedMemoryManager);
 };
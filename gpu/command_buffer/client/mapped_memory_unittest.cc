@@ -296,4 +296,31 @@ TEST_F(MappedMemoryManagerTest, ChunkSizeMultiple) {
   EXPECT_EQ(0u, offset3);
 }
 
+TEST_F(MappedMemoryManagerTest, AllocWithLimit) {
+  int32 id = -1;
+  unsigned int offset = 0xFFFFFFFFU;
+  void* m1 = manager_->AllocWithLimit(
+      kBufferSize, kBufferSize * 2, &id, &offset);
+  void* m2 = manager_->AllocWithLimit(
+      kBufferSize, kBufferSize * 2, &id, &offset);
+  ASSERT_TRUE(m1 != NULL);
+  ASSERT_TRUE(m2 != NULL);
+  EXPECT_EQ(kBufferSize * 2, manager_->allocated_memory());
+
+  // A third chunk would go past the limit.
+  EXPECT_TRUE(manager_->AllocWithLimit(
+      kBufferSize, kBufferSize * 2, &id, &offset) == NULL);
+  EXPECT_EQ(2u, manager_->num_chunks());
+
+  // Free memory in the chunks there are can still be had.
+  manager_->Free(m2);
+  m2 = manager_->AllocWithLimit(kBufferSize, kBufferSize * 2, &id, &offset);
+  EXPECT_TRUE(m2 != NULL);
+
+  manager_->Free(m1);
+  manager_->Free(m2);
+  manager_->FreeUnused();
+  EXPECT_EQ(0u, manager_->allocated_memory());
+}
+
 }  // namespace gpu
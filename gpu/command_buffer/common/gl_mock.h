@@ -214,6 +214,10 @@ class MockGLInterface : public GLInterface {
 
   MOCK_METHOD2(GetIntegerv, void(GLenum pname, GLint* params));
 
+  MOCK_METHOD5(GetProgramBinary, void(
+      GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat,
+      GLvoid* binary));
+
   MOCK_METHOD3(GetProgramiv, void(GLuint program, GLenum pname, GLint* params));
 
   MOCK_METHOD4(GetProgramInfoLog, void(
@@ -306,6 +310,13 @@ class MockGLInterface : public GLInterface {
 
   MOCK_METHOD2(PolygonOffset, void(GLfloat factor, GLfloat units));
 
+  MOCK_METHOD4(ProgramBinary, void(
+      GLuint program, GLenum binaryFormat, const GLvoid* binary,
+      GLsizei length));
+
+  MOCK_METHOD3(ProgramParameteri, void(
+      GLuint program, GLenum pname, GLint value));
+
   MOCK_METHOD2(QueryCounter, void(GLuint id, GLenum target));
 
   MOCK_METHOD1(ReadBuffer, void(GLenum src));
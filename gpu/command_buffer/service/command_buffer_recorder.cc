@@ -0,0 +1,197 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/command_buffer_recorder.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/file_path.h"
+#include "base/logging.h"
+#include "base/pickle.h"
+
+namespace gpu {
+
+namespace {
+
+// The granularity at which changes to the transfer buffers are looked for.
+const size_t kBlockSize = 4096;
+
+}  // namespace
+
+// static
+CommandBufferRecorder* CommandBufferRecorder::Create(const FilePath& path) {
+  FILE* file = file_util::OpenFile(path, "wb");
+  if (!file)
+    return NULL;
+  return new CommandBufferRecorder(file);
+}
+
+CommandBufferRecorder::CommandBufferRecorder(FILE* file)
+    : file_(file) {
+  Pickle pickle;
+  pickle.WriteInt(kRecordHeader);
+  pickle.WriteUInt32(kFileVersion);
+  WriteRecord(pickle);
+}
+
+CommandBufferRecorder::~CommandBufferRecorder() {
+  file_util::CloseFile(file_);
+}
+
+void CommandBufferRecorder::RecordRegisterTransferBuffer(
+    int32 id, const Buffer& buffer) {
+  Pickle pickle;
+  pickle.WriteInt(kRecordRegisterTransferBuffer);
+  pickle.WriteInt(id);
+  pickle.WriteUInt32(static_cast<uint32>(buffer.size));
+  WriteRecord(pickle);
+
+  // New transfer buffers are zero filled, both here and when they are
+  // replayed, so only what is written to them later needs to be recorded.
+  TransferBuffer& transfer_buffer = transfer_buffers_[id];
+  transfer_buffer.buffer = buffer;
+  transfer_buffer.contents.assign(buffer.size, 0);
+  RecordChanges(id, &transfer_buffer);
+}
+
+void CommandBufferRecorder::RecordDestroyTransferBuffer(int32 id) {
+  TransferBufferMap::iterator it = transfer_buffers_.find(id);
+  if (it == transfer_buffers_.end())
+    return;
+  transfer_buffers_.erase(it);
+
+  Pickle pickle;
+  pickle.WriteInt(kRecordDestroyTransferBuffer);
+  pickle.WriteInt(id);
+  WriteRecord(pickle);
+}
+
+void CommandBufferRecorder::RecordSetGetBuffer(int32 id) {
+  Pickle pickle;
+  pickle.WriteInt(kRecordSetGetBuffer);
+  pickle.WriteInt(id);
+  WriteRecord(pickle);
+}
+
+void CommandBufferRecorder::RecordFlush(int32 put_offset) {
+  for (TransferBufferMap::iterator it = transfer_buffers_.begin();
+       it != transfer_buffers_.end(); ++it) {
+    RecordChanges(it->first, &it->second);
+  }
+
+  Pickle pickle;
+  pickle.WriteInt(kRecordFlush);
+  pickle.WriteInt(put_offset);
+  WriteRecord(pickle);
+}
+
+void CommandBufferRecorder::RecordChanges(int32 id,
+                                          TransferBuffer* transfer_buffer) {
+  const char* memory = static_cast<const char*>(transfer_buffer->buffer.ptr);
+  char* contents = transfer_buffer->contents.empty() ?
+      NULL : &transfer_buffer->contents[0];
+  size_t size = transfer_buffer->contents.size();
+
+  // The client can be writing to the buffer while it is looked at, so each
+  // block is copied before it is compared, and what is written is the copy.
+  char block[kBlockSize];
+  size_t run_start = 0;
+  bool in_run = false;
+  for (size_t offset = 0; offset < size; offset += kBlockSize) {
+    size_t length = std::min(kBlockSize, size - offset);
+    memcpy(block, memory + offset, length);
+    bool changed = memcmp(block, contents + offset, length) != 0;
+    if (changed) {
+      memcpy(contents + offset, block, length);
+      if (!in_run) {
+        run_start = offset;
+        in_run = true;
+      }
+    } else if (in_run) {
+      RecordData(id, contents, run_start, offset);
+      in_run = false;
+    }
+  }
+  if (in_run)
+    RecordData(id, contents, run_start, size);
+}
+
+void CommandBufferRecorder::RecordData(int32 id,
+                                       const char* contents,
+                                       size_t start,
+                                       size_t end) {
+  Pickle pickle;
+  pickle.WriteInt(kRecordTransferBufferData);
+  pickle.WriteInt(id);
+  pickle.WriteUInt32(static_cast<uint32>(start));
+  pickle.WriteData(contents + start, static_cast<int>(end - start));
+  WriteRecord(pickle);
+}
+
+void CommandBufferRecorder::WriteRecord(const Pickle& pickle) {
+  if (fwrite(pickle.data(), 1, pickle.size(), file_) != pickle.size())
+    DLOG(ERROR) << "Could not write command buffer record";
+}
+
+CommandBufferRecordReader::CommandBufferRecordReader()
+    : position_(NULL),
+      end_(NULL) {
+}
+
+CommandBufferRecordReader::~CommandBufferRecordReader() {
+}
+
+bool CommandBufferRecordReader::Initialize(const FilePath& path) {
+  if (!file_.Initialize(path))
+    return false;
+  position_ = reinterpret_cast<const char*>(file_.data());
+  end_ = position_ + file_.length();
+
+  Record record;
+  return ReadRecord(&record) && record.type == kRecordHeader &&
+      record.size_or_offset == CommandBufferRecorder::kFileVersion;
+}
+
+bool CommandBufferRecordReader::ReadRecord(Record* record) {
+  uint32 payload_size;
+  if (static_cast<size_t>(end_ - position_) < sizeof(payload_size))
+    return false;
+  memcpy(&payload_size, position_, sizeof(payload_size));
+  if (payload_size > end_ - position_ - sizeof(payload_size))
+    return false;
+  int length = static_cast<int>(sizeof(payload_size) + payload_size);
+  Pickle pickle(position_, length);
+  position_ += length;
+
+  PickleIterator iter(pickle);
+  int type;
+  if (!pickle.ReadInt(&iter, &type))
+    return false;
+  record->type = static_cast<CommandBufferRecordType>(type);
+  record->value = 0;
+  record->size_or_offset = 0;
+  record->data = NULL;
+  record->data_length = 0;
+
+  switch (record->type) {
+    case kRecordHeader:
+      return pickle.ReadUInt32(&iter, &record->size_or_offset);
+    case kRecordRegisterTransferBuffer:
+      return pickle.ReadInt(&iter, &record->value) &&
+          pickle.ReadUInt32(&iter, &record->size_or_offset);
+    case kRecordTransferBufferData:
+      return pickle.ReadInt(&iter, &record->value) &&
+          pickle.ReadUInt32(&iter, &record->size_or_offset) &&
+          pickle.ReadData(&iter, &record->data, &record->data_length);
+    case kRecordDestroyTransferBuffer:
+    case kRecordSetGetBuffer:
+    case kRecordFlush:
+      return pickle.ReadInt(&iter, &record->value);
+  }
+  return false;
+}
+
+}  // namespace gpu
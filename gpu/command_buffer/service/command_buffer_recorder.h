@@ -0,0 +1,121 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GPU_COMMAND_BUFFER_SERVICE_COMMAND_BUFFER_RECORDER_H_
+#define GPU_COMMAND_BUFFER_SERVICE_COMMAND_BUFFER_RECORDER_H_
+
+#include <stdio.h>
+
+#include <map>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/file_util.h"
+#include "gpu/command_buffer/common/buffer.h"
+#include "gpu/gpu_export.h"
+
+class FilePath;
+class Pickle;
+
+namespace gpu {
+
+// The records of a recording, which is a sequence of Pickles that starts
+// with a kRecordHeader record.
+enum CommandBufferRecordType {
+  // The version of the file.
+  kRecordHeader,
+  // The id and size of a transfer buffer that was registered.
+  kRecordRegisterTransferBuffer,
+  // The id of a transfer buffer that was destroyed.
+  kRecordDestroyTransferBuffer,
+  // The id of a transfer buffer, an offset into it and the data there.
+  kRecordTransferBufferData,
+  // The id of the transfer buffer that became the command buffer.
+  kRecordSetGetBuffer,
+  // The put offset of a flush.
+  kRecordFlush
+};
+
+// Records what a CommandBufferService is given, so that its commands can be
+// replayed later along with the contents of the transfer buffers they use,
+// see gpu/tools/command_buffer_replay. The transfer buffers are copied on
+// every flush, and only the blocks of them that changed since the last flush
+// are written.
+class GPU_EXPORT CommandBufferRecorder {
+ public:
+  static const uint32 kFileVersion = 1;
+
+  // Returns NULL if |path| can't be written.
+  static CommandBufferRecorder* Create(const FilePath& path);
+
+  ~CommandBufferRecorder();
+
+  void RecordRegisterTransferBuffer(int32 id, const Buffer& buffer);
+
+  // Must be called before the memory of the buffer is released.
+  void RecordDestroyTransferBuffer(int32 id);
+
+  void RecordSetGetBuffer(int32 id);
+
+  // Records what changed in the transfer buffers, then the flush itself.
+  void RecordFlush(int32 put_offset);
+
+ private:
+  struct TransferBuffer {
+    Buffer buffer;
+    // The contents as of the last flush.
+    std::vector<char> contents;
+  };
+
+  typedef std::map<int32, TransferBuffer> TransferBufferMap;
+
+  // Takes ownership of |file|.
+  explicit CommandBufferRecorder(FILE* file);
+
+  void RecordChanges(int32 id, TransferBuffer* transfer_buffer);
+  void RecordData(int32 id, const char* contents, size_t start, size_t end);
+  void WriteRecord(const Pickle& pickle);
+
+  FILE* file_;
+  TransferBufferMap transfer_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(CommandBufferRecorder);
+};
+
+// Reads the records written by a CommandBufferRecorder back.
+class GPU_EXPORT CommandBufferRecordReader {
+ public:
+  struct Record {
+    CommandBufferRecordType type;
+    // The transfer buffer id or put offset, depending on the type.
+    int32 value;
+    // The size of a transfer buffer or the offset of its data.
+    uint32 size_or_offset;
+    // The data of a kRecordTransferBufferData record.
+    const char* data;
+    int data_length;
+  };
+
+  CommandBufferRecordReader();
+  ~CommandBufferRecordReader();
+
+  // Returns false if |path| can't be read or is not a recording of this
+  // version.
+  bool Initialize(const FilePath& path);
+
+  // Reads the next record. Returns false at the end of the recording or if
+  // the record is malformed.
+  bool ReadRecord(Record* record);
+
+ private:
+  file_util::MemoryMappedFile file_;
+  const char* position_;
+  const char* end_;
+
+  DISALLOW_COPY_AND_ASSIGN(CommandBufferRecordReader);
+};
+
+}  // namespace gpu
+
+#endif  // GPU_COMMAND_BUFFER_SERVICE_COMMAND_BUFFER_RECORDER_H_
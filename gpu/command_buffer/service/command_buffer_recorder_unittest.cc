@@ -0,0 +1,104 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/command_buffer_recorder.h"
+
+#include <string.h>
+
+#include "base/file_path.h"
+#include "base/scoped_temp_dir.h"
+#include "gpu/command_buffer/service/command_buffer_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace gpu {
+
+class CommandBufferRecorderTest : public testing::Test {
+ protected:
+  static const size_t kBlockSize = 4096;
+  static const size_t kBufferSize = 3 * kBlockSize + 100;
+
+  virtual void SetUp() {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.path().AppendASCII("commands.bin");
+  }
+
+  void ExpectRecord(CommandBufferRecordReader* reader,
+                    CommandBufferRecordType type,
+                    int32 value,
+                    uint32 size_or_offset) {
+    ASSERT_TRUE(reader->ReadRecord(&record_));
+    EXPECT_EQ(type, record_.type);
+    EXPECT_EQ(value, record_.value);
+    EXPECT_EQ(size_or_offset, record_.size_or_offset);
+  }
+
+  ScopedTempDir temp_dir_;
+  FilePath path_;
+  CommandBufferRecordReader::Record record_;
+};
+
+// GCC requires these declarations, but MSVC requires they not be present
+#ifndef COMPILER_MSVC
+const size_t CommandBufferRecorderTest::kBlockSize;
+const size_t CommandBufferRecorderTest::kBufferSize;
+#endif
+
+TEST_F(CommandBufferRecorderTest, RecordsChangedBlocks) {
+  {
+    CommandBufferService command_buffer;
+    CommandBufferRecorder* recorder = CommandBufferRecorder::Create(path_);
+    ASSERT_TRUE(recorder != NULL);
+    command_buffer.SetRecorder(recorder);
+
+    int32 id = command_buffer.CreateTransferBuffer(kBufferSize, -1);
+    ASSERT_NE(-1, id);
+    char* memory =
+        static_cast<char*>(command_buffer.GetTransferBuffer(id).ptr);
+    memory[kBlockSize + 1] = 1;
+    memory[kBufferSize - 1] = 2;
+    command_buffer.Flush(0);
+
+    // Nothing changed since the last flush.
+    command_buffer.Flush(0);
+
+    memory[0] = 3;
+    command_buffer.Flush(0);
+    command_buffer.DestroyTransferBuffer(id);
+  }
+
+  CommandBufferRecordReader reader;
+  ASSERT_TRUE(reader.Initialize(path_));
+  ExpectRecord(&reader, kRecordRegisterTransferBuffer, 1, kBufferSize);
+
+  // The second block, then the last two blocks, which are partly filled.
+  ExpectRecord(&reader, kRecordTransferBufferData, 1, kBlockSize);
+  ASSERT_EQ(static_cast<int>(kBlockSize), record_.data_length);
+  EXPECT_EQ(1, record_.data[1]);
+  ExpectRecord(&reader, kRecordTransferBufferData, 1, 3 * kBlockSize);
+  ASSERT_EQ(100, record_.data_length);
+  EXPECT_EQ(2, record_.data[99]);
+  ExpectRecord(&reader, kRecordFlush, 0, 0);
+
+  ExpectRecord(&reader, kRecordFlush, 0, 0);
+
+  ExpectRecord(&reader, kRecordTransferBufferData, 1, 0);
+  ASSERT_EQ(static_cast<int>(kBlockSize), record_.data_length);
+  EXPECT_EQ(3, record_.data[0]);
+  ExpectRecord(&reader, kRecordFlush, 0, 0);
+
+  ExpectRecord(&reader, kRecordDestroyTransferBuffer, 1, 0);
+  EXPECT_FALSE(reader.ReadRecord(&record_));
+}
+
+TEST_F(CommandBufferRecorderTest, RejectsOtherFiles) {
+  CommandBufferRecordReader reader;
+  EXPECT_FALSE(reader.Initialize(path_));
+
+  const char kGarbage[] = "garbage";
+  ASSERT_EQ(static_cast<int>(sizeof(kGarbage)),
+            file_util::WriteFile(path_, kGarbage, sizeof(kGarbage)));
+  EXPECT_FALSE(reader.Initialize(path_));
+}
+
+}  // namespace gpu
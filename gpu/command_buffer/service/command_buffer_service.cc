@@ -10,6 +10,7 @@
 #include "base/debug/trace_event.h"
 #include "gpu/command_buffer/common/cmd_buffer_common.h"
 #include "gpu/command_buffer/common/command_buffer_shared.h"
+#include "gpu/command_buffer/service/command_buffer_recorder.h"
 
 using ::base::SharedMemory;
 
@@ -76,6 +77,8 @@ CommandBufferService::State CommandBufferService::FlushSync(
   }
 
   put_offset_ = put_offset;
+  if (recorder_.get())
+    recorder_->RecordFlush(put_offset);
 
   if (!put_offset_change_callback_.is_null())
     put_offset_change_callback_.Run();
@@ -90,6 +93,8 @@ void CommandBufferService::Flush(int32 put_offset) {
   }
 
   put_offset_ = put_offset;
+  if (recorder_.get())
+    recorder_->RecordFlush(put_offset);
 
   if (!put_offset_change_callback_.is_null())
     put_offset_change_callback_.Run();
@@ -101,6 +106,8 @@ void CommandBufferService::SetGetBuffer(int32 transfer_buffer_id) {
   ring_buffer_ = GetTransferBuffer(transfer_buffer_id);
   DCHECK(ring_buffer_.ptr);
   ring_buffer_id_ = transfer_buffer_id;
+  if (recorder_.get())
+    recorder_->RecordSetGetBuffer(transfer_buffer_id);
   num_entries_ = ring_buffer_.size / sizeof(CommandBufferEntry);
   put_offset_ = 0;
   SetGetOffset(0);
@@ -168,6 +175,8 @@ int32 CommandBufferService::RegisterTransferBuffer(
   buffer.size = size;
   buffer.shared_memory = duped_shared_memory.release();
 
+  int32 handle = -1;
+
   // If caller requested specific id, first try to use id_request.
   if (id_request != -1) {
     int32 cur_size = static_cast<int32>(registered_objects_.size());
@@ -177,27 +186,31 @@ int32 CommandBufferService::RegisterTransferBuffer(
       for (int32 id = cur_size; id < id_request; ++id)
         unused_registered_object_elements_.insert(id);
       registered_objects_[id_request] = buffer;
-      return id_request;
+      handle = id_request;
     } else if (!registered_objects_[id_request].shared_memory) {
       // id_request is already in free list.
       registered_objects_[id_request] = buffer;
       unused_registered_object_elements_.erase(id_request);
-      return id_request;
+      handle = id_request;
     }
   }
 
-  if (unused_registered_object_elements_.empty()) {
-    int32 handle = static_cast<int32>(registered_objects_.size());
-    registered_objects_.push_back(buffer);
-    return handle;
-  } else {
-    int32 handle = *unused_registered_object_elements_.begin();
-    unused_registered_object_elements_.erase(
-        unused_registered_object_elements_.begin());
-    DCHECK(!registered_objects_[handle].shared_memory);
-    registered_objects_[handle] = buffer;
-    return handle;
+  if (handle == -1) {
+    if (unused_registered_object_elements_.empty()) {
+      handle = static_cast<int32>(registered_objects_.size());
+      registered_objects_.push_back(buffer);
+    } else {
+      handle = *unused_registered_object_elements_.begin();
+      unused_registered_object_elements_.erase(
+          unused_registered_object_elements_.begin());
+      DCHECK(!registered_objects_[handle].shared_memory);
+      registered_objects_[handle] = buffer;
+    }
   }
+
+  if (recorder_.get())
+    recorder_->RecordRegisterTransferBuffer(handle, buffer);
+  return handle;
 }
 
 void CommandBufferService::DestroyTransferBuffer(int32 handle) {
@@ -211,6 +224,8 @@ void CommandBufferService::DestroyTransferBuffer(int32 handle) {
   TRACE_COUNTER_ID1(
       "CommandBuffer", "SharedMemory", this, shared_memory_bytes_allocated_);
 
+  if (recorder_.get())
+    recorder_->RecordDestroyTransferBuffer(handle);
   delete registered_objects_[handle].shared_memory;
   registered_objects_[handle] = Buffer();
   unused_registered_object_elements_.insert(handle);
@@ -261,6 +276,20 @@ void CommandBufferService::SetContextLostReason(
   context_lost_reason_ = reason;
 }
 
+void CommandBufferService::SetRecorder(CommandBufferRecorder* recorder) {
+  // The commands already in the command buffer could not be replayed.
+  DCHECK_EQ(-1, ring_buffer_id_);
+  recorder_.reset(recorder);
+  if (!recorder_.get())
+    return;
+  for (size_t i = 1; i < registered_objects_.size(); ++i) {
+    if (registered_objects_[i].shared_memory) {
+      recorder_->RecordRegisterTransferBuffer(static_cast<int32>(i),
+                                              registered_objects_[i]);
+    }
+  }
+}
+
 void CommandBufferService::SetPutOffsetChangeCallback(
     const base::Closure& callback) {
   put_offset_change_callback_ = callback;
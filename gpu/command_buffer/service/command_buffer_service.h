@@ -17,6 +17,8 @@
 
 namespace gpu {
 
+class CommandBufferRecorder;
+
 // An object that implements a shared memory command buffer and a synchronous
 // API to manage the put and get pointers.
 class GPU_EXPORT CommandBufferService : public CommandBuffer {
@@ -63,6 +65,11 @@ class GPU_EXPORT CommandBufferService : public CommandBuffer {
   // Copy the current state into the shared state transfer buffer.
   void UpdateState();
 
+  // Records everything the command buffer is given from now on with
+  // |recorder|, which it takes ownership of. Must be called before the get
+  // buffer is set.
+  void SetRecorder(CommandBufferRecorder* recorder);
+
  private:
   int32 ring_buffer_id_;
   Buffer ring_buffer_;
@@ -80,6 +87,7 @@ class GPU_EXPORT CommandBufferService : public CommandBuffer {
   error::Error error_;
   error::ContextLostReason context_lost_reason_;
   size_t shared_memory_bytes_allocated_;
+  scoped_ptr<CommandBufferRecorder> recorder_;
 };
 
 }  // namespace gpu
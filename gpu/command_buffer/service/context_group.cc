@@ -24,8 +24,10 @@ namespace gpu {
 namespace gles2 {
 
 ContextGroup::ContextGroup(MailboxManager* mailbox_manager,
+                           ProgramCache* program_cache,
                            bool bind_generates_resource)
     : mailbox_manager_(mailbox_manager ? mailbox_manager : new MailboxManager),
+      program_cache_(program_cache),
       num_contexts_(0),
       enforce_gl_minimums_(CommandLine::ForCurrentProcess()->HasSwitch(
           switches::kEnforceGLMinimums)),
@@ -124,7 +126,9 @@ bool ContextGroup::Initialize(const DisallowedFeatures& disallowed_features,
   renderbuffer_manager_.reset(new RenderbufferManager(
       max_renderbuffer_size, max_samples));
   shader_manager_.reset(new ShaderManager());
-  program_manager_.reset(new ProgramManager());
+  program_manager_.reset(new ProgramManager(
+      feature_info_->feature_flags().native_program_binary ?
+          program_cache_ : NULL));
 
   // Lookup GL things we need to know.
   const GLint kGLES2RequiredMinimumVertexAttribs = 8u;
@@ -276,6 +280,15 @@ IdAllocatorInterface* ContextGroup::GetIdAllocator(unsigned namespace_id) {
   return id_namespaces_[namespace_id].get();
 }
 
+size_t ContextGroup::GetMemRepresented() const {
+  size_t total = 0;
+  if (texture_manager_ != NULL)
+    total += texture_manager_->mem_represented();
+  if (renderbuffer_manager_ != NULL)
+    total += renderbuffer_manager_->mem_represented();
+  return total;
+}
+
 }  // namespace gles2
 }  // namespace gpu
 
@@ -27,6 +27,7 @@ class GLES2Decoder;
 class FramebufferManager;
 class MailboxManager;
 class RenderbufferManager;
+class ProgramCache;
 class ProgramManager;
 class ShaderManager;
 class TextureManager;
@@ -38,8 +39,10 @@ class GPU_EXPORT ContextGroup : public base::RefCounted<ContextGroup> {
  public:
   typedef scoped_refptr<ContextGroup> Ref;
 
-  explicit ContextGroup(MailboxManager* mailbox_manager,
-                        bool bind_generates_resource);
+  // |program_cache| may be NULL. If it isn't, it must outlive the group.
+  ContextGroup(MailboxManager* mailbox_manager,
+               ProgramCache* program_cache,
+               bool bind_generates_resource);
   ~ContextGroup();
 
   // This should only be called by GLES2Decoder. This must be paired with a
@@ -117,6 +120,10 @@ class GPU_EXPORT ContextGroup : public base::RefCounted<ContextGroup> {
 
   IdAllocatorInterface* GetIdAllocator(unsigned namespace_id);
 
+  // Returns the number of bytes the textures and renderbuffers of the group
+  // are estimated to take up.
+  size_t GetMemRepresented() const;
+
  private:
   bool CheckGLFeature(GLint min_required, GLint* v);
   bool CheckGLFeatureU(GLint min_required, uint32* v);
@@ -124,6 +131,7 @@ class GPU_EXPORT ContextGroup : public base::RefCounted<ContextGroup> {
   bool QueryGLFeatureU(GLenum pname, GLint min_required, uint32* v);
 
   scoped_refptr<MailboxManager> mailbox_manager_;
+  ProgramCache* program_cache_;
 
   // Whether or not this context is initialized.
   int num_contexts_;
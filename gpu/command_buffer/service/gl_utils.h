@@ -55,6 +55,9 @@
 #define GL_TEXTURE_USAGE_ANGLE                 0x93A2
 #define GL_FRAMEBUFFER_ATTACHMENT_ANGLE        0x93A3
 
+// GL_CHROMIUM_purgeable_texture
+#define GL_TEXTURE_PURGEABLE_CHROMIUM          0x6000
+
 // GL_EXT_texture_storage
 #define GL_TEXTURE_IMMUTABLE_FORMAT_EXT        0x912F
 #define GL_ALPHA8_EXT                          0x803C
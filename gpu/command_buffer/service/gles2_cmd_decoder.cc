@@ -3406,6 +3406,7 @@ void GLES2DecoderImpl::DoBindTexture(GLenum target, GLuint client_id) {
     texture_manager()->SetInfoTarget(info, target);
   }
   glBindTexture(target, info->service_id());
+  texture_manager()->MarkTextureUsed(info);
   TextureUnit& unit = texture_units_[active_texture_unit_];
   unit.bind_target = target;
   switch (target) {
@@ -4503,7 +4504,8 @@ void GLES2DecoderImpl::DoTexParameterf(
     SetGLError(GL_INVALID_ENUM, "glTexParameterf: param GL_INVALID_ENUM");
     return;
   }
-  glTexParameterf(target, pname, param);
+  if (pname != GL_TEXTURE_PURGEABLE_CHROMIUM)
+    glTexParameterf(target, pname, param);
 }
 
 void GLES2DecoderImpl::DoTexParameteri(
@@ -4518,7 +4520,9 @@ void GLES2DecoderImpl::DoTexParameteri(
     SetGLError(GL_INVALID_ENUM, "glTexParameteri: param GL_INVALID_ENUM");
     return;
   }
-  glTexParameteri(target, pname, param);
+  // Purgeability is only known to the texture manager.
+  if (pname != GL_TEXTURE_PURGEABLE_CHROMIUM)
+    glTexParameteri(target, pname, param);
 }
 
 void GLES2DecoderImpl::DoTexParameterfv(
@@ -4534,7 +4538,8 @@ void GLES2DecoderImpl::DoTexParameterfv(
     SetGLError(GL_INVALID_ENUM, "glTexParameterfv: param GL_INVALID_ENUM");
     return;
   }
-  glTexParameterfv(target, pname, params);
+  if (pname != GL_TEXTURE_PURGEABLE_CHROMIUM)
+    glTexParameterfv(target, pname, params);
 }
 
 void GLES2DecoderImpl::DoTexParameteriv(
@@ -4549,7 +4554,8 @@ void GLES2DecoderImpl::DoTexParameteriv(
     SetGLError(GL_INVALID_ENUM, "glTexParameteriv: param GL_INVALID_ENUM");
     return;
   }
-  glTexParameteriv(target, pname, params);
+  if (pname != GL_TEXTURE_PURGEABLE_CHROMIUM)
+    glTexParameteriv(target, pname, params);
 }
 
 bool GLES2DecoderImpl::CheckCurrentProgram(const char* function_name) {
@@ -15,7 +15,9 @@
 namespace gpu {
 namespace gles2 {
 
-// ValueValidator returns true if a value is valid.
+// ValueValidator returns true if a value is valid. The decoder checks most
+// enums of every command it runs, so the values are also kept sorted to be
+// binary searched.
 template <typename T>
 class ValueValidator {
  public:
@@ -28,14 +30,17 @@ class ValueValidator {
   }
 
   void AddValue(const T value) {
-    if (!IsValid(value)) {
+    typename std::vector<T>::iterator it = std::lower_bound(
+        sorted_values_.begin(), sorted_values_.end(), value);
+    if (it == sorted_values_.end() || *it != value) {
+      sorted_values_.insert(it, value);
       valid_values_.push_back(value);
     }
   }
 
   bool IsValid(const T value) const {
-    return std::find(valid_values_.begin(), valid_values_.end(), value) !=
-           valid_values_.end();
+    return std::binary_search(sorted_values_.begin(), sorted_values_.end(),
+                              value);
   }
 
   const std::vector<T>& GetValues() const {
@@ -43,7 +48,9 @@ class ValueValidator {
   }
 
  private:
+  // In the order they were added, which is the order GetValues() returns.
   std::vector<T> valid_values_;
+  std::vector<T> sorted_values_;
 };
 
 struct Validators {
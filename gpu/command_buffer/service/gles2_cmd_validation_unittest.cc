@@ -0,0 +1,42 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/gles2_cmd_validation.h"
+
+#include "gpu/command_buffer/service/gl_utils.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace gpu {
+namespace gles2 {
+
+TEST(ValueValidatorTest, IsValid) {
+  static const GLenum kValues[] = {
+    GL_TEXTURE_2D,
+    GL_FRONT,
+    GL_TEXTURE_CUBE_MAP,
+  };
+  ValueValidator<GLenum> validator(kValues, arraysize(kValues));
+  for (size_t ii = 0; ii < arraysize(kValues); ++ii)
+    EXPECT_TRUE(validator.IsValid(kValues[ii]));
+  EXPECT_FALSE(validator.IsValid(GL_BACK));
+  EXPECT_FALSE(validator.IsValid(0));
+
+  validator.AddValue(GL_BACK);
+  EXPECT_TRUE(validator.IsValid(GL_BACK));
+}
+
+TEST(ValueValidatorTest, GetValuesKeepsTheOrderValuesWereAdded) {
+  ValueValidator<GLint> validator;
+  validator.AddValue(3);
+  validator.AddValue(1);
+  validator.AddValue(3);
+  validator.AddValue(2);
+  ASSERT_EQ(3u, validator.GetValues().size());
+  EXPECT_EQ(3, validator.GetValues()[0]);
+  EXPECT_EQ(1, validator.GetValues()[1]);
+  EXPECT_EQ(2, validator.GetValues()[2]);
+}
+
+}  // namespace gles2
+}  // namespace gpu
@@ -86,6 +86,12 @@ void GpuScheduler::PutChanged() {
 
     if (unscheduled_count_ > 0)
       return;
+
+    if (!parser_->IsEmpty() && !preemption_callback_.is_null() &&
+        preemption_callback_.Run()) {
+      TRACE_EVENT_INSTANT1("gpu", "GpuScheduler:Preempted", "this", this);
+      return;
+    }
   }
 }
 
@@ -191,6 +197,11 @@ void GpuScheduler::SetCommandProcessedCallback(
   command_processed_callback_ = callback;
 }
 
+void GpuScheduler::SetPreemptionCallback(
+    const base::Callback<bool(void)>& callback) {
+  preemption_callback_ = callback;
+}
+
 void GpuScheduler::DeferToFence(base::Closure task) {
   unschedule_fences_.push(make_linked_ptr(
        new UnscheduleFence(gfx::GLFence::Create(), task)));
@@ -65,6 +65,12 @@ class GPU_EXPORT GpuScheduler
 
   void SetCommandProcessedCallback(const base::Closure& callback);
 
+  // Sets a callback that is run between commands. If it returns true, the
+  // scheduler is preempted: PutChanged returns and leaves the remaining
+  // commands in the buffer for a later call, so that other command buffers
+  // get to run. Each call processes at least one command.
+  void SetPreemptionCallback(const base::Callback<bool(void)>& callback);
+
   void DeferToFence(base::Closure task);
 
   // Polls the fences, invoking callbacks that were waiting to be triggered
@@ -122,6 +128,7 @@ class GPU_EXPORT GpuScheduler
 
   base::Closure scheduled_callback_;
   base::Closure command_processed_callback_;
+  base::Callback<bool(void)> preemption_callback_;
 
   DISALLOW_COPY_AND_ASSIGN(GpuScheduler);
 };
@@ -0,0 +1,185 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/program_cache.h"
+
+#include "base/debug/trace_event.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/pickle.h"
+#include "base/sha1.h"
+#include "ui/gfx/gl/gl_implementation.h"
+
+namespace gpu {
+namespace gles2 {
+
+namespace {
+
+// Part of the key, so that the entries of builds that lay them out
+// differently are never loaded.
+const uint32 kEntryVersion = 1;
+
+std::string GetString(GLenum name) {
+  const char* str = reinterpret_cast<const char*>(glGetString(name));
+  return str ? std::string(str) : std::string();
+}
+
+bool ParseEntry(const std::string& data,
+                GLenum* format,
+                const char** binary,
+                int* length) {
+  Pickle pickle(data.data(), static_cast<int>(data.size()));
+  PickleIterator iter(pickle);
+  uint32 binary_format;
+  if (!pickle.ReadUInt32(&iter, &binary_format) ||
+      !pickle.ReadData(&iter, binary, length) ||
+      *length <= 0)
+    return false;
+  *format = binary_format;
+  return true;
+}
+
+}  // namespace
+
+ProgramCache::ProgramCache(size_t max_size)
+    : max_size_(max_size),
+      size_(0) {
+}
+
+ProgramCache::~ProgramCache() {
+}
+
+bool ProgramCache::LoadLinkedProgram(
+    GLuint program,
+    const std::string& vertex_source,
+    const std::string& fragment_source,
+    const LocationMap& bind_attrib_location_map) {
+  std::string key = ComputeKey(
+      vertex_source, fragment_source, bind_attrib_location_map);
+  EntryMap::iterator it = entries_.find(key);
+  if (it == entries_.end())
+    return false;
+  TRACE_EVENT0("gpu", "ProgramCache::LoadLinkedProgram");
+
+  GLenum format;
+  const char* binary;
+  int length;
+  if (!ParseEntry(it->second.data, &format, &binary, &length)) {
+    RemoveEntry(it);
+    return false;
+  }
+  glProgramBinary(program, format, binary, length);
+  GLint success = 0;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  if (success != GL_TRUE) {
+    // The driver doesn't take the binary any more, for instance because it
+    // was updated without its version string changing.
+    RemoveEntry(it);
+    return false;
+  }
+
+  lru_keys_.splice(lru_keys_.begin(), lru_keys_, it->second.lru_position);
+  return true;
+}
+
+void ProgramCache::WillLinkProgram(GLuint program) {
+  // Desktop GL only hands out the binary of programs that ask for it.
+  if (gfx::HasDesktopGLFeatures())
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void ProgramCache::SaveLinkedProgram(
+    GLuint program,
+    const std::string& vertex_source,
+    const std::string& fragment_source,
+    const LocationMap& bind_attrib_location_map) {
+  TRACE_EVENT0("gpu", "ProgramCache::SaveLinkedProgram");
+  GLint length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0 || static_cast<size_t>(length) > max_size_)
+    return;
+
+  scoped_array<char> binary(new char[length]);
+  GLsizei written = 0;
+  GLenum format = 0;
+  glGetProgramBinary(program, length, &written, &format, binary.get());
+  if (written <= 0 || written > length)
+    return;
+
+  Pickle pickle;
+  pickle.WriteUInt32(format);
+  pickle.WriteData(binary.get(), written);
+  std::string data(static_cast<const char*>(pickle.data()), pickle.size());
+
+  std::string key = ComputeKey(
+      vertex_source, fragment_source, bind_attrib_location_map);
+  StoreEntry(key, data);
+  if (!entry_added_callback_.is_null())
+    entry_added_callback_.Run(key, data);
+}
+
+void ProgramCache::AddEntry(const std::string& key, const std::string& entry) {
+  GLenum format;
+  const char* binary;
+  int length;
+  if (key.size() != base::kSHA1Length ||
+      !ParseEntry(entry, &format, &binary, &length))
+    return;
+  StoreEntry(key, entry);
+}
+
+std::string ProgramCache::ComputeKey(
+    const std::string& vertex_source,
+    const std::string& fragment_source,
+    const LocationMap& bind_attrib_location_map) {
+  if (driver_key_.empty()) {
+    driver_key_ = GetString(GL_VENDOR) + '\n' + GetString(GL_RENDERER) +
+        '\n' + GetString(GL_VERSION);
+  }
+
+  Pickle pickle;
+  pickle.WriteUInt32(kEntryVersion);
+  pickle.WriteString(driver_key_);
+  pickle.WriteString(vertex_source);
+  pickle.WriteString(fragment_source);
+  for (LocationMap::const_iterator it = bind_attrib_location_map.begin();
+       it != bind_attrib_location_map.end(); ++it) {
+    pickle.WriteString(it->first);
+    pickle.WriteInt(it->second);
+  }
+  return base::SHA1HashString(
+      std::string(static_cast<const char*>(pickle.data()), pickle.size()));
+}
+
+void ProgramCache::StoreEntry(const std::string& key,
+                              const std::string& data) {
+  if (data.size() > max_size_)
+    return;
+
+  EntryMap::iterator it = entries_.find(key);
+  if (it != entries_.end())
+    RemoveEntry(it);
+
+  while (size_ + data.size() > max_size_) {
+    DCHECK(!lru_keys_.empty());
+    RemoveEntry(entries_.find(lru_keys_.back()));
+  }
+
+  lru_keys_.push_front(key);
+  Entry& entry = entries_[key];
+  entry.data = data;
+  entry.lru_position = lru_keys_.begin();
+  size_ += data.size();
+}
+
+void ProgramCache::RemoveEntry(EntryMap::iterator it) {
+  DCHECK(it != entries_.end());
+  DCHECK_GE(size_, it->second.data.size());
+  size_ -= it->second.data.size();
+  lru_keys_.erase(it->second.lru_position);
+  entries_.erase(it);
+}
+
+}  // namespace gles2
+}  // namespace gpu
@@ -0,0 +1,116 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GPU_COMMAND_BUFFER_SERVICE_PROGRAM_CACHE_H_
+#define GPU_COMMAND_BUFFER_SERVICE_PROGRAM_CACHE_H_
+
+#include <list>
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "gpu/command_buffer/service/gl_utils.h"
+#include "gpu/gpu_export.h"
+
+namespace gpu {
+namespace gles2 {
+
+// Keeps the binaries of linked programs so that a program that was linked
+// before, in this process or in an earlier run, can be loaded with
+// glProgramBinary instead of being linked again. Entries are keyed by a hash
+// of the driver, the translated sources of the shaders and the attrib
+// location bindings. Once the entries take up more than the maximum size,
+// the least recently used ones are evicted.
+//
+// One ProgramCache is shared by all the context groups of a process, on the
+// thread their decoders run on. It should only be given to a ProgramManager
+// when the driver supports program binaries.
+class GPU_EXPORT ProgramCache {
+ public:
+  typedef std::map<std::string, GLint> LocationMap;
+
+  // Called with the key and the contents of each entry that is added, so
+  // that it can be kept for later runs and given back with AddEntry().
+  typedef base::Callback<void(const std::string&, const std::string&)>
+      EntryAddedCallback;
+
+  explicit ProgramCache(size_t max_size);
+  ~ProgramCache();
+
+  // Loads the binary of the program linked from the given shaders with the
+  // given bindings into |program|, if there is one. Returns true if
+  // |program| is linked as a result.
+  bool LoadLinkedProgram(GLuint program,
+                         const std::string& vertex_source,
+                         const std::string& fragment_source,
+                         const LocationMap& bind_attrib_location_map);
+
+  // Must be called before |program| is linked for SaveLinkedProgram() to be
+  // able to get its binary.
+  void WillLinkProgram(GLuint program);
+
+  // Saves the binary of |program|, which must just have been linked.
+  void SaveLinkedProgram(GLuint program,
+                         const std::string& vertex_source,
+                         const std::string& fragment_source,
+                         const LocationMap& bind_attrib_location_map);
+
+  // Adds an entry that was saved by an earlier run.
+  void AddEntry(const std::string& key, const std::string& entry);
+
+  void set_entry_added_callback(const EntryAddedCallback& callback) {
+    entry_added_callback_ = callback;
+  }
+
+  // The total size of the entries.
+  size_t size() const {
+    return size_;
+  }
+
+  size_t num_entries() const {
+    return entries_.size();
+  }
+
+ private:
+  typedef std::list<std::string> KeyList;
+
+  struct Entry {
+    std::string data;
+    // Where the key is in |lru_keys_|.
+    KeyList::iterator lru_position;
+  };
+
+  typedef std::map<std::string, Entry> EntryMap;
+
+  std::string ComputeKey(const std::string& vertex_source,
+                         const std::string& fragment_source,
+                         const LocationMap& bind_attrib_location_map);
+
+  // Replaces the entry for |key| if there is one, and evicts entries until
+  // the cache fits in |max_size_|.
+  void StoreEntry(const std::string& key, const std::string& data);
+
+  void RemoveEntry(EntryMap::iterator it);
+
+  size_t max_size_;
+  size_t size_;
+
+  // Identifies the driver. It is filled in the first time a key is needed.
+  std::string driver_key_;
+
+  EntryMap entries_;
+
+  // From most to least recently used.
+  KeyList lru_keys_;
+
+  EntryAddedCallback entry_added_callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProgramCache);
+};
+
+}  // namespace gles2
+}  // namespace gpu
+
+#endif  // GPU_COMMAND_BUFFER_SERVICE_PROGRAM_CACHE_H_
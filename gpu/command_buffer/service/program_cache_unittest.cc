@@ -0,0 +1,189 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/program_cache.h"
+
+#include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "gpu/command_buffer/common/gl_mock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+using ::testing::SetArgumentPointee;
+using ::testing::StrictMock;
+
+namespace gpu {
+namespace gles2 {
+
+namespace {
+
+// Copies |binary| to the binary argument of glGetProgramBinary.
+ACTION_P(CopyProgramBinary, binary) {
+  memcpy(arg4, binary.data(), binary.size());
+}
+
+void RecordEntry(std::string* key_out, std::string* entry_out,
+                 const std::string& key, const std::string& entry) {
+  *key_out = key;
+  *entry_out = entry;
+}
+
+}  // namespace
+
+class ProgramCacheTest : public testing::Test {
+ public:
+  ProgramCacheTest()
+      : cache_(new ProgramCache(kMaxCacheSize)) {
+  }
+
+ protected:
+  static const size_t kMaxCacheSize = 1024;
+  static const GLuint kServiceProgramId = 10;
+  static const GLenum kBinaryFormat = 0x1234;
+  static const char* kVertexSource;
+  static const char* kFragmentSource;
+
+  virtual void SetUp() {
+    gl_.reset(new StrictMock<gfx::MockGLInterface>());
+    ::gfx::GLInterface::SetGLInterface(gl_.get());
+    EXPECT_CALL(*gl_, GetString(_))
+        .WillRepeatedly(Return(reinterpret_cast<const GLubyte*>("driver")));
+  }
+
+  virtual void TearDown() {
+    ::gfx::GLInterface::SetGLInterface(NULL);
+    gl_.reset();
+  }
+
+  void SaveProgram(const std::string& binary,
+                   const ProgramCache::LocationMap& bindings) {
+    EXPECT_CALL(*gl_, GetProgramiv(kServiceProgramId,
+                                   GL_PROGRAM_BINARY_LENGTH, _))
+        .WillOnce(SetArgumentPointee<2>(static_cast<GLint>(binary.size())))
+        .RetiresOnSaturation();
+    EXPECT_CALL(*gl_, GetProgramBinary(kServiceProgramId,
+                                       static_cast<GLsizei>(binary.size()),
+                                       _, _, _))
+        .WillOnce(DoAll(
+            SetArgumentPointee<2>(static_cast<GLsizei>(binary.size())),
+            SetArgumentPointee<3>(kBinaryFormat),
+            CopyProgramBinary(binary)))
+        .RetiresOnSaturation();
+    cache_->SaveLinkedProgram(
+        kServiceProgramId, kVertexSource, kFragmentSource, bindings);
+  }
+
+  void ExpectProgramBinary(size_t length, GLint link_status) {
+    EXPECT_CALL(*gl_, ProgramBinary(kServiceProgramId, kBinaryFormat, _,
+                                    static_cast<GLsizei>(length)))
+        .Times(1)
+        .RetiresOnSaturation();
+    EXPECT_CALL(*gl_, GetProgramiv(kServiceProgramId, GL_LINK_STATUS, _))
+        .WillOnce(SetArgumentPointee<2>(link_status))
+        .RetiresOnSaturation();
+  }
+
+  bool LoadProgram(const ProgramCache::LocationMap& bindings) {
+    return cache_->LoadLinkedProgram(
+        kServiceProgramId, kVertexSource, kFragmentSource, bindings);
+  }
+
+  scoped_ptr<StrictMock<gfx::MockGLInterface> > gl_;
+  scoped_ptr<ProgramCache> cache_;
+  ProgramCache::LocationMap bindings_;
+};
+
+const char* ProgramCacheTest::kVertexSource = "vertex";
+const char* ProgramCacheTest::kFragmentSource = "fragment";
+
+// GCC requires these declarations, but MSVC requires they not be present
+#ifndef COMPILER_MSVC
+const size_t ProgramCacheTest::kMaxCacheSize;
+const GLuint ProgramCacheTest::kServiceProgramId;
+const GLenum ProgramCacheTest::kBinaryFormat;
+#endif
+
+TEST_F(ProgramCacheTest, SaveAndLoad) {
+  EXPECT_FALSE(LoadProgram(bindings_));
+  SaveProgram("binary", bindings_);
+  EXPECT_EQ(1u, cache_->num_entries());
+  EXPECT_LT(0u, cache_->size());
+
+  ExpectProgramBinary(6, GL_TRUE);
+  EXPECT_TRUE(LoadProgram(bindings_));
+}
+
+TEST_F(ProgramCacheTest, BindingsArePartOfTheKey) {
+  SaveProgram("binary", bindings_);
+  ProgramCache::LocationMap other_bindings;
+  other_bindings["a"] = 1;
+  EXPECT_FALSE(LoadProgram(other_bindings));
+  EXPECT_FALSE(cache_->LoadLinkedProgram(
+      kServiceProgramId, kFragmentSource, kVertexSource, bindings_));
+}
+
+TEST_F(ProgramCacheTest, RejectedBinaryIsRemoved) {
+  SaveProgram("binary", bindings_);
+  ExpectProgramBinary(6, GL_FALSE);
+  EXPECT_FALSE(LoadProgram(bindings_));
+  EXPECT_EQ(0u, cache_->num_entries());
+  EXPECT_EQ(0u, cache_->size());
+}
+
+TEST_F(ProgramCacheTest, LeastRecentlyUsedIsEvicted) {
+  ProgramCache::LocationMap bindings[3];
+  for (int ii = 0; ii < 3; ++ii)
+    bindings[ii]["a"] = ii;
+
+  const std::string binary(kMaxCacheSize / 3, 'x');
+  SaveProgram(binary, bindings[0]);
+  SaveProgram(binary, bindings[1]);
+  EXPECT_EQ(2u, cache_->num_entries());
+
+  // Using the first one makes the second one the least recently used.
+  ExpectProgramBinary(binary.size(), GL_TRUE);
+  EXPECT_TRUE(LoadProgram(bindings[0]));
+
+  SaveProgram(binary, bindings[2]);
+  EXPECT_EQ(2u, cache_->num_entries());
+  EXPECT_GE(kMaxCacheSize, cache_->size());
+  EXPECT_FALSE(LoadProgram(bindings[1]));
+  ExpectProgramBinary(binary.size(), GL_TRUE);
+  EXPECT_TRUE(LoadProgram(bindings[0]));
+}
+
+TEST_F(ProgramCacheTest, TooBigIsNotSaved) {
+  EXPECT_CALL(*gl_, GetProgramiv(kServiceProgramId,
+                                 GL_PROGRAM_BINARY_LENGTH, _))
+      .WillOnce(SetArgumentPointee<2>(static_cast<GLint>(kMaxCacheSize + 1)))
+      .RetiresOnSaturation();
+  cache_->SaveLinkedProgram(
+      kServiceProgramId, kVertexSource, kFragmentSource, bindings_);
+  EXPECT_EQ(0u, cache_->num_entries());
+}
+
+TEST_F(ProgramCacheTest, EntriesCanBeAddedBack) {
+  std::string key;
+  std::string entry;
+  cache_->set_entry_added_callback(base::Bind(&RecordEntry, &key, &entry));
+  SaveProgram("binary", bindings_);
+  EXPECT_FALSE(key.empty());
+  EXPECT_FALSE(entry.empty());
+
+  // As if in a later run.
+  cache_.reset(new ProgramCache(kMaxCacheSize));
+  cache_->AddEntry(key, "garbage");
+  cache_->AddEntry("bad key", entry);
+  EXPECT_EQ(0u, cache_->num_entries());
+  cache_->AddEntry(key, entry);
+  EXPECT_EQ(1u, cache_->num_entries());
+
+  ExpectProgramBinary(6, GL_TRUE);
+  EXPECT_TRUE(LoadProgram(bindings_));
+}
+
+}  // namespace gles2
+}  // namespace gpu
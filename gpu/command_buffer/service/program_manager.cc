@@ -14,6 +14,7 @@
 #include "gpu/command_buffer/common/gles2_cmd_format.h"
 #include "gpu/command_buffer/common/gles2_cmd_utils.h"
 #include "gpu/command_buffer/service/gles2_cmd_decoder.h"
+#include "gpu/command_buffer/service/program_cache.h"
 
 namespace gpu {
 namespace gles2 {
@@ -260,10 +261,29 @@ bool ProgramManager::ProgramInfo::Link() {
     return false;
   }
   ExecuteBindAttribLocationCalls();
+
+  ProgramCache* cache = manager_->program_cache_;
+  std::string vertex_source;
+  std::string fragment_source;
+  if (cache && !GetTranslatedSources(&vertex_source, &fragment_source))
+    cache = NULL;
+  if (cache && cache->LoadLinkedProgram(service_id(), vertex_source,
+                                        fragment_source,
+                                        bind_attrib_location_map_)) {
+    Update();
+    return true;
+  }
+
+  if (cache)
+    cache->WillLinkProgram(service_id());
   glLinkProgram(service_id());
   GLint success = 0;
   glGetProgramiv(service_id(), GL_LINK_STATUS, &success);
   if (success == GL_TRUE) {
+    if (cache) {
+      cache->SaveLinkedProgram(service_id(), vertex_source, fragment_source,
+                               bind_attrib_location_map_);
+    }
     Update();
   } else {
     UpdateLogInfo();
@@ -271,6 +291,22 @@ bool ProgramManager::ProgramInfo::Link() {
   return success == GL_TRUE;
 }
 
+bool ProgramManager::ProgramInfo::GetTranslatedSources(
+    std::string* vertex_source, std::string* fragment_source) const {
+  const ShaderManager::ShaderInfo* vertex_shader =
+      attached_shaders_[ShaderTypeToIndex(GL_VERTEX_SHADER)];
+  const ShaderManager::ShaderInfo* fragment_shader =
+      attached_shaders_[ShaderTypeToIndex(GL_FRAGMENT_SHADER)];
+  // Without the translator there is no telling what the driver compiled,
+  // since the source may have changed since.
+  if (!vertex_shader || !vertex_shader->translated_source() ||
+      !fragment_shader || !fragment_shader->translated_source())
+    return false;
+  *vertex_source = *vertex_shader->translated_source();
+  *fragment_source = *fragment_shader->translated_source();
+  return true;
+}
+
 void ProgramManager::ProgramInfo::Validate() {
   if (!IsValid()) {
     set_log_info("program not linked");
@@ -679,10 +715,11 @@ ProgramManager::ProgramInfo::~ProgramInfo() {
 // by at least 1 bit each time chrome is run.
 static int uniform_random_offset_ = 3;
 
-ProgramManager::ProgramManager()
+ProgramManager::ProgramManager(ProgramCache* program_cache)
     : uniform_swizzle_(uniform_random_offset_++ % 15),
       program_info_count_(0),
-      have_context_(true) {
+      have_context_(true),
+      program_cache_(program_cache) {
 }
 
 ProgramManager::~ProgramManager() {
@@ -20,6 +20,8 @@
 namespace gpu {
 namespace gles2 {
 
+class ProgramCache;
+
 // Tracks the Programs.
 //
 // NOTE: To support shared resources an instance of this class will
@@ -147,7 +149,8 @@ class GPU_EXPORT ProgramManager {
 
     bool CanLink() const;
 
-    // Performs glLinkProgram and related activities.
+    // Performs glLinkProgram and related activities. If the manager has a
+    // program cache, the program is loaded from it when it can be.
     bool Link();
 
     // Performs glValidateProgram and related activities.
@@ -215,6 +218,11 @@ class GPU_EXPORT ProgramManager {
     // Updates the program log info from GL
     void UpdateLogInfo();
 
+    // Gets the sources the attached shaders were compiled from, as the
+    // driver saw them. Returns false if they aren't known.
+    bool GetTranslatedSources(
+        std::string* vertex_source, std::string* fragment_source) const;
+
     // Clears all the uniforms.
     void ClearUniforms(std::vector<uint8>* zero_buffer);
 
@@ -289,7 +297,8 @@ class GPU_EXPORT ProgramManager {
     std::map<std::string, GLint> bind_attrib_location_map_;
   };
 
-  ProgramManager();
+  // |program_cache| may be NULL.
+  explicit ProgramManager(ProgramCache* program_cache);
   ~ProgramManager();
 
   // Must call before destruction.
@@ -342,6 +351,9 @@ class GPU_EXPORT ProgramManager {
 
   bool have_context_;
 
+  // Not owned. NULL if programs aren't cached.
+  ProgramCache* program_cache_;
+
   // Used to clear uniforms.
   std::vector<uint8> zero_;
 
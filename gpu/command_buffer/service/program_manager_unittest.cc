@@ -13,6 +13,7 @@
 #include "gpu/command_buffer/common/gles2_cmd_format.h"
 #include "gpu/command_buffer/service/common_decoder.h"
 #include "gpu/command_buffer/service/mocks.h"
+#include "gpu/command_buffer/service/program_cache.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 using ::gfx::MockGLInterface;
@@ -33,7 +34,7 @@ namespace gles2 {
 
 class ProgramManagerTest : public testing::Test {
  public:
-  ProgramManagerTest() { }
+  ProgramManagerTest() : manager_(NULL) { }
   ~ProgramManagerTest() {
     manager_.Destroy(false);
   }
@@ -140,10 +141,96 @@ TEST_F(ProgramManagerTest, SwizzleLocation) {
   }
 }
 
+namespace {
+
+// The calls ProgramInfo::Update makes for a program without attribs or
+// uniforms.
+void ExpectEmptyProgramUpdate(MockGLInterface* gl, GLuint service_id) {
+  const GLenum kPnames[] = {
+    GL_INFO_LOG_LENGTH,
+    GL_ACTIVE_ATTRIBUTES,
+    GL_ACTIVE_ATTRIBUTE_MAX_LENGTH,
+    GL_ACTIVE_UNIFORMS,
+    GL_ACTIVE_UNIFORM_MAX_LENGTH,
+  };
+  for (size_t ii = 0; ii < arraysize(kPnames); ++ii) {
+    EXPECT_CALL(*gl, GetProgramiv(service_id, kPnames[ii], _))
+        .WillOnce(SetArgumentPointee<2>(0))
+        .RetiresOnSaturation();
+  }
+}
+
+}  // namespace
+
+TEST_F(ProgramManagerTest, LinkUsesProgramCache) {
+  const GLuint kClient1Id = 1;
+  const GLuint kService1Id = 11;
+  const GLuint kClient2Id = 2;
+  const GLuint kService2Id = 12;
+  const GLenum kBinaryFormat = 0x1234;
+  const GLint kBinaryLength = 4;
+
+  ProgramCache cache(1024);
+  ProgramManager manager(&cache);
+  ShaderManager shader_manager;
+  ShaderManager::ShaderInfo* vertex_shader = shader_manager.CreateShaderInfo(
+      kClient1Id, kService1Id, GL_VERTEX_SHADER);
+  ShaderManager::ShaderInfo* fragment_shader = shader_manager.CreateShaderInfo(
+      kClient2Id, kService2Id, GL_FRAGMENT_SHADER);
+  vertex_shader->UpdateTranslatedSource("vertex");
+  vertex_shader->SetStatus(true, "", NULL);
+  fragment_shader->UpdateTranslatedSource("fragment");
+  fragment_shader->SetStatus(true, "", NULL);
+
+  EXPECT_CALL(*gl_, GetString(_))
+      .WillRepeatedly(Return(reinterpret_cast<const GLubyte*>("driver")));
+
+  // The first program is linked, and its binary saved.
+  ProgramManager::ProgramInfo* info1 = manager.CreateProgramInfo(
+      kClient1Id, kService1Id);
+  info1->AttachShader(&shader_manager, vertex_shader);
+  info1->AttachShader(&shader_manager, fragment_shader);
+  EXPECT_CALL(*gl_, LinkProgram(kService1Id))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*gl_, GetProgramiv(kService1Id, GL_LINK_STATUS, _))
+      .WillOnce(SetArgumentPointee<2>(GL_TRUE))
+      .RetiresOnSaturation();
+  EXPECT_CALL(*gl_, GetProgramiv(kService1Id, GL_PROGRAM_BINARY_LENGTH, _))
+      .WillOnce(SetArgumentPointee<2>(kBinaryLength))
+      .RetiresOnSaturation();
+  EXPECT_CALL(*gl_, GetProgramBinary(kService1Id, kBinaryLength, _, _, _))
+      .WillOnce(DoAll(SetArgumentPointee<2>(kBinaryLength),
+                      SetArgumentPointee<3>(kBinaryFormat)))
+      .RetiresOnSaturation();
+  ExpectEmptyProgramUpdate(gl_.get(), kService1Id);
+  EXPECT_TRUE(info1->Link());
+  EXPECT_EQ(1u, cache.num_entries());
+
+  // The second one, made of the same shaders, is loaded rather than linked.
+  ProgramManager::ProgramInfo* info2 = manager.CreateProgramInfo(
+      kClient2Id, kService2Id);
+  info2->AttachShader(&shader_manager, vertex_shader);
+  info2->AttachShader(&shader_manager, fragment_shader);
+  EXPECT_CALL(*gl_, ProgramBinary(kService2Id, kBinaryFormat, _,
+                                  kBinaryLength))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*gl_, GetProgramiv(kService2Id, GL_LINK_STATUS, _))
+      .WillOnce(SetArgumentPointee<2>(GL_TRUE))
+      .RetiresOnSaturation();
+  ExpectEmptyProgramUpdate(gl_.get(), kService2Id);
+  EXPECT_TRUE(info2->Link());
+  EXPECT_TRUE(info2->IsValid());
+
+  manager.Destroy(false);
+  shader_manager.Destroy(false);
+}
+
 class ProgramManagerWithShaderTest : public testing::Test {
  public:
   ProgramManagerWithShaderTest()
-      : program_info_(NULL) {
+      : manager_(NULL), program_info_(NULL) {
   }
 
   ~ProgramManagerWithShaderTest() {
@@ -160,6 +160,11 @@ class GPU_EXPORT RenderbufferManager {
   // Gets a client id for a given service id.
   bool GetClientId(GLuint service_id, GLuint* client_id) const;
 
+  // The number of bytes the renderbuffers are estimated to take up.
+  size_t mem_represented() const {
+    return mem_represented_;
+  }
+
  private:
   void UpdateMemRepresented();
 
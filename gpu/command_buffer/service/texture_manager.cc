@@ -111,7 +111,9 @@ TextureManager::TextureInfo::TextureInfo(TextureManager* manager,
       owned_(true),
       stream_texture_(false),
       immutable_(false),
-      estimated_size_(0) {
+      estimated_size_(0),
+      purgeable_(false),
+      last_used_(0) {
   if (manager_) {
     manager_->StartTracking(this);
   }
@@ -425,6 +427,12 @@ bool TextureManager::TextureInfo::SetParameter(
       }
       usage_ = param;
       break;
+    case GL_TEXTURE_PURGEABLE_CHROMIUM:
+      if (param != GL_TRUE && param != GL_FALSE) {
+        return false;
+      }
+      purgeable_ = param == GL_TRUE;
+      break;
     default:
       NOTREACHED();
       return false;
@@ -605,6 +613,7 @@ TextureManager::TextureManager(
       texture_info_count_(0),
       mem_represented_(0),
       last_reported_mem_represented_(1),
+      use_count_(0),
       have_context_(true) {
   for (int ii = 0; ii < kNumDefaultTextures; ++ii) {
     black_texture_ids_[ii] = 0;
@@ -1040,6 +1049,54 @@ bool TextureManager::GetClientId(GLuint service_id, GLuint* client_id) const {
   return false;
 }
 
+uint32 TextureManager::PurgeTextures(uint32 bytes) {
+  // Sorted by when they were last used.
+  std::vector<std::pair<uint32, TextureInfo*> > candidates;
+  for (TextureInfoMap::const_iterator it = texture_infos_.begin();
+       it != texture_infos_.end(); ++it) {
+    TextureInfo* info = it->second;
+    // Immutable textures can't be redefined, and textures that are attached
+    // or streamed have storage the client relies on.
+    if (info->purgeable() && info->estimated_size() && info->owned_ &&
+        !info->IsImmutable() && !info->IsAttachedToFramebuffer() &&
+        !info->IsStreamTexture() &&
+        (info->target() == GL_TEXTURE_2D ||
+         info->target() == GL_TEXTURE_CUBE_MAP)) {
+      candidates.push_back(std::make_pair(info->last_used_, info));
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  uint32 freed = 0;
+  for (size_t ii = 0; ii < candidates.size() && freed < bytes; ++ii) {
+    TextureInfo* info = candidates[ii].second;
+    GLenum target = info->target();
+    GLenum binding = target == GL_TEXTURE_2D ?
+        GL_TEXTURE_BINDING_2D : GL_TEXTURE_BINDING_CUBE_MAP;
+    GLint bound_service_id = 0;
+    glGetIntegerv(binding, &bound_service_id);
+    glBindTexture(target, info->service_id());
+
+    freed += info->estimated_size();
+    for (size_t face = 0; face < info->level_infos_.size(); ++face) {
+      for (size_t level = 0; level < info->level_infos_[face].size();
+           ++level) {
+        // Copied because SetLevelInfo() updates it.
+        TextureInfo::LevelInfo level_info = info->level_infos_[face][level];
+        if (!level_info.estimated_size)
+          continue;
+        glTexImage2D(level_info.target, level, level_info.internal_format,
+                     0, 0, 0, level_info.format, level_info.type, NULL);
+        SetLevelInfo(info, level_info.target, level,
+                     level_info.internal_format, 0, 0, 1, 0,
+                     level_info.format, level_info.type, true);
+      }
+    }
+    glBindTexture(target, bound_service_id);
+  }
+  return freed;
+}
+
 GLsizei TextureManager::ComputeMipMapCount(
     GLsizei width, GLsizei height, GLsizei depth) {
   return 1 + base::bits::Log2Floor(std::max(std::max(width, height), depth));
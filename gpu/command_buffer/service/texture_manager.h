@@ -63,6 +63,12 @@ class GPU_EXPORT TextureManager {
       return usage_;
     }
 
+    // Whether the client set GL_TEXTURE_PURGEABLE_CHROMIUM, allowing the
+    // storage of the texture to be freed when memory runs short.
+    bool purgeable() const {
+      return purgeable_;
+    }
+
     int num_uncleared_mips() const {
       return num_uncleared_mips_;
     }
@@ -348,6 +354,11 @@ class GPU_EXPORT TextureManager {
     // Size in bytes this texture is assumed to take in memory.
     uint32 estimated_size_;
 
+    bool purgeable_;
+
+    // When the texture was last bound, as counted by the TextureManager.
+    uint32 last_used_;
+
     DISALLOW_COPY_AND_ASSIGN(TextureInfo);
   };
 
@@ -465,6 +476,23 @@ class GPU_EXPORT TextureManager {
   // Gets a client id for a given service id.
   bool GetClientId(GLuint service_id, GLuint* client_id) const;
 
+  // Notes that |info| was bound, so that the textures that have not been used
+  // for the longest time are purged first.
+  void MarkTextureUsed(TextureInfo* info) {
+    info->last_used_ = ++use_count_;
+  }
+
+  // Frees the levels of purgeable textures, least recently used first, until
+  // at least |bytes| are freed or there is nothing more to purge. A purged
+  // texture is left with levels of size 0, as if the client had redefined
+  // them. Returns the number of bytes freed.
+  uint32 PurgeTextures(uint32 bytes);
+
+  // The number of bytes the textures are estimated to take up.
+  uint32 mem_represented() const {
+    return mem_represented_;
+  }
+
   TextureInfo* GetDefaultTextureInfo(GLenum target) {
     switch (target) {
       case GL_TEXTURE_2D:
@@ -542,6 +570,9 @@ class GPU_EXPORT TextureManager {
   uint32 mem_represented_;
   uint32 last_reported_mem_represented_;
 
+  // Incremented each time a texture is used.
+  uint32 use_count_;
+
   bool have_context_;
 
   // Black (0,0,0,1) textures for when non-renderable textures are used.
@@ -13,6 +13,7 @@
 
 using ::testing::Pointee;
 using ::testing::Return;
+using ::testing::SetArgumentPointee;
 using ::testing::_;
 
 namespace gpu {
@@ -143,6 +144,78 @@ TEST_F(TextureManagerTest, TextureUsageExt) {
   manager.Destroy(false);
 }
 
+TEST_F(TextureManagerTest, PurgeTexturesLeastRecentlyUsedFirst) {
+  const GLuint kClient1Id = 1;
+  const GLuint kService1Id = 11;
+  const GLuint kClient2Id = 2;
+  const GLuint kService2Id = 12;
+  const GLuint kClient3Id = 3;
+  const GLuint kService3Id = 13;
+  const uint32 kTextureSize = 4 * 4 * 4;
+  TextureManager::TextureInfo* infos[3];
+  const GLuint client_ids[] = { kClient1Id, kClient2Id, kClient3Id };
+  const GLuint service_ids[] = { kService1Id, kService2Id, kService3Id };
+  for (int ii = 0; ii < 3; ++ii) {
+    manager_.CreateTextureInfo(client_ids[ii], service_ids[ii]);
+    infos[ii] = manager_.GetTextureInfo(client_ids[ii]);
+    ASSERT_TRUE(infos[ii] != NULL);
+    manager_.SetInfoTarget(infos[ii], GL_TEXTURE_2D);
+    manager_.SetLevelInfo(infos[ii], GL_TEXTURE_2D, 0, GL_RGBA, 4, 4, 1, 0,
+                          GL_RGBA, GL_UNSIGNED_BYTE, true);
+  }
+  EXPECT_FALSE(manager_.SetParameter(
+      infos[0], GL_TEXTURE_PURGEABLE_CHROMIUM, 2));
+  EXPECT_TRUE(manager_.SetParameter(
+      infos[0], GL_TEXTURE_PURGEABLE_CHROMIUM, GL_TRUE));
+  EXPECT_TRUE(manager_.SetParameter(
+      infos[1], GL_TEXTURE_PURGEABLE_CHROMIUM, GL_TRUE));
+  EXPECT_TRUE(infos[0]->purgeable());
+  EXPECT_FALSE(infos[2]->purgeable());
+  manager_.MarkTextureUsed(infos[1]);
+  manager_.MarkTextureUsed(infos[0]);
+  const uint32 mem_represented = manager_.mem_represented();
+
+  // The second texture was used the longest time ago.
+  EXPECT_CALL(*gl_, GetIntegerv(GL_TEXTURE_BINDING_2D, _))
+      .WillOnce(SetArgumentPointee<1>(kService3Id))
+      .RetiresOnSaturation();
+  EXPECT_CALL(*gl_, BindTexture(GL_TEXTURE_2D, kService2Id))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*gl_, TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 0, 0, 0,
+                               GL_RGBA, GL_UNSIGNED_BYTE, NULL))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*gl_, BindTexture(GL_TEXTURE_2D, kService3Id))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_EQ(kTextureSize, manager_.PurgeTextures(1));
+  EXPECT_EQ(mem_represented - kTextureSize, manager_.mem_represented());
+  GLsizei width = -1;
+  GLsizei height = -1;
+  EXPECT_TRUE(infos[1]->GetLevelSize(GL_TEXTURE_2D, 0, &width, &height));
+  EXPECT_EQ(0, width);
+  EXPECT_EQ(0, height);
+
+  // Only the first texture is left to purge.
+  EXPECT_CALL(*gl_, GetIntegerv(GL_TEXTURE_BINDING_2D, _))
+      .WillOnce(SetArgumentPointee<1>(0))
+      .RetiresOnSaturation();
+  EXPECT_CALL(*gl_, BindTexture(GL_TEXTURE_2D, kService1Id))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*gl_, TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 0, 0, 0,
+                               GL_RGBA, GL_UNSIGNED_BYTE, NULL))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*gl_, BindTexture(GL_TEXTURE_2D, 0))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_EQ(kTextureSize, manager_.PurgeTextures(kTextureSize * 3));
+  EXPECT_EQ(0u, manager_.PurgeTextures(kTextureSize));
+  EXPECT_EQ(mem_represented - kTextureSize * 2, manager_.mem_represented());
+}
+
 TEST_F(TextureManagerTest, Destroy) {
   const GLuint kClient1Id = 1;
   const GLuint kService1Id = 11;
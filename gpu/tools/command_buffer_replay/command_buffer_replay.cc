@@ -0,0 +1,272 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This tool replays a command buffer recorded by starting the browser with
+// --gpu-record-command-buffers=<dir>, and reports how much time the decoder
+// spent on each type of command.
+//
+// Usage: command_buffer_replay [--finish] <recording>
+//
+// With --finish, glFinish is called after every command and the time it takes
+// is reported as the GL time of the command. Without it, the GL time of a
+// command mostly ends up in the decoder time of the ones after it.
+//
+// The contexts of a page are recorded separately, so commands that wait on
+// other contexts can't be replayed.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/basictypes.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop.h"
+#include "base/time.h"
+#include "gpu/command_buffer/service/cmd_parser.h"
+#include "gpu/command_buffer/service/command_buffer_recorder.h"
+#include "gpu/command_buffer/service/command_buffer_service.h"
+#include "gpu/command_buffer/service/context_group.h"
+#include "gpu/command_buffer/service/gles2_cmd_decoder.h"
+#include "gpu/command_buffer/service/gpu_scheduler.h"
+#include "gpu/command_buffer/service/mailbox_manager.h"
+#include "ui/gfx/gl/gl_bindings.h"
+#include "ui/gfx/gl/gl_context.h"
+#include "ui/gfx/gl/gl_surface.h"
+
+#if defined(TOOLKIT_GTK)
+#include "ui/gfx/gtk_util.h"
+#endif
+
+using base::TimeDelta;
+using base::TimeTicks;
+
+namespace {
+
+const char kFinishSwitch[] = "finish";
+
+// The recording doesn't say how big the surface was, so the commands are
+// replayed onto an offscreen surface of a typical size.
+const int kSurfaceWidth = 1024;
+const int kSurfaceHeight = 768;
+
+struct CommandStats {
+  CommandStats() : count(0) {}
+
+  int count;
+  TimeDelta decoder_time;
+  TimeDelta gl_time;
+};
+
+// Forwards the commands to the decoder, timing each of them.
+class TimingHandler : public gpu::AsyncAPIInterface {
+ public:
+  TimingHandler(gpu::AsyncAPIInterface* decoder, bool finish)
+      : decoder_(decoder),
+        finish_(finish) {
+  }
+
+  virtual gpu::error::Error DoCommand(unsigned int command,
+                                      unsigned int arg_count,
+                                      const void* cmd_data) OVERRIDE {
+    TimeTicks start = TimeTicks::HighResNow();
+    gpu::error::Error error = decoder_->DoCommand(command, arg_count,
+                                                  cmd_data);
+    TimeTicks decoded = TimeTicks::HighResNow();
+    if (finish_)
+      glFinish();
+    TimeTicks finished = TimeTicks::HighResNow();
+
+    CommandStats& stats = stats_[command];
+    ++stats.count;
+    stats.decoder_time += decoded - start;
+    stats.gl_time += finished - decoded;
+    return error;
+  }
+
+  virtual const char* GetCommandName(unsigned int command_id) const OVERRIDE {
+    return decoder_->GetCommandName(command_id);
+  }
+
+  // Prints the stats of the commands, the ones that took longest first.
+  void PrintStats() const {
+    std::vector<std::pair<TimeDelta, unsigned int> > commands;
+    TimeDelta total_decoder_time;
+    TimeDelta total_gl_time;
+    for (StatsMap::const_iterator it = stats_.begin(); it != stats_.end();
+         ++it) {
+      commands.push_back(std::make_pair(
+          it->second.decoder_time + it->second.gl_time, it->first));
+      total_decoder_time += it->second.decoder_time;
+      total_gl_time += it->second.gl_time;
+    }
+    std::sort(commands.rbegin(), commands.rend());
+
+    printf("%-40s %10s %12s %12s\n", "command", "count", "decoder ms",
+           "gl ms");
+    for (size_t ii = 0; ii < commands.size(); ++ii) {
+      const CommandStats& stats = stats_.find(commands[ii].second)->second;
+      printf("%-40s %10d %12.3f %12.3f\n",
+             GetCommandName(commands[ii].second), stats.count,
+             stats.decoder_time.InMillisecondsF(),
+             stats.gl_time.InMillisecondsF());
+    }
+    printf("%-40s %10s %12.3f %12.3f\n", "total", "",
+           total_decoder_time.InMillisecondsF(),
+           total_gl_time.InMillisecondsF());
+  }
+
+ private:
+  typedef std::map<unsigned int, CommandStats> StatsMap;
+
+  gpu::AsyncAPIInterface* decoder_;
+  bool finish_;
+  StatsMap stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimingHandler);
+};
+
+void PumpCommands(gpu::gles2::GLES2Decoder* decoder,
+                  gpu::GpuScheduler* scheduler) {
+  decoder->MakeCurrent();
+  scheduler->PutChanged();
+}
+
+// Replays the records of |reader|. Returns false if one of them can't be.
+bool Replay(gpu::CommandBufferRecordReader* reader,
+            gpu::CommandBufferService* command_buffer) {
+  gpu::CommandBufferRecordReader::Record record;
+  while (reader->ReadRecord(&record)) {
+    switch (record.type) {
+      case gpu::kRecordRegisterTransferBuffer:
+        if (command_buffer->CreateTransferBuffer(
+                record.size_or_offset, record.value) != record.value) {
+          fprintf(stderr, "Could not create transfer buffer %d\n",
+                  record.value);
+          return false;
+        }
+        break;
+      case gpu::kRecordDestroyTransferBuffer:
+        command_buffer->DestroyTransferBuffer(record.value);
+        break;
+      case gpu::kRecordTransferBufferData: {
+        gpu::Buffer buffer = command_buffer->GetTransferBuffer(record.value);
+        if (!buffer.ptr || record.size_or_offset > buffer.size ||
+            static_cast<size_t>(record.data_length) >
+                buffer.size - record.size_or_offset) {
+          fprintf(stderr, "Bad data for transfer buffer %d\n", record.value);
+          return false;
+        }
+        memcpy(static_cast<char*>(buffer.ptr) + record.size_or_offset,
+               record.data, record.data_length);
+        break;
+      }
+      case gpu::kRecordSetGetBuffer:
+        command_buffer->SetGetBuffer(record.value);
+        break;
+      case gpu::kRecordFlush: {
+        command_buffer->Flush(record.value);
+        gpu::CommandBuffer::State state = command_buffer->GetState();
+        if (state.error != gpu::error::kNoError) {
+          fprintf(stderr, "Replay failed with error %d\n", state.error);
+          return false;
+        }
+        if (state.get_offset != state.put_offset) {
+          fprintf(stderr, "Replay stopped waiting on another context\n");
+          return false;
+        }
+        break;
+      }
+      case gpu::kRecordHeader:
+        break;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::AtExitManager exit_manager;
+  CommandLine::Init(argc, argv);
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+#if defined(TOOLKIT_GTK)
+  gfx::GtkInitFromCommandLine(command_line);
+#endif
+  MessageLoop main_message_loop(MessageLoop::TYPE_UI);
+
+  CommandLine::StringVector args = command_line.GetArgs();
+  if (args.size() != 1) {
+    fprintf(stderr, "Usage: %s [--%s] <recording>\n", argv[0], kFinishSwitch);
+    return 1;
+  }
+
+  gpu::CommandBufferRecordReader reader;
+  if (!reader.Initialize(FilePath(args[0]))) {
+    fprintf(stderr, "Could not read the recording\n");
+    return 1;
+  }
+
+  if (!gfx::GLSurface::InitializeOneOff()) {
+    fprintf(stderr, "Could not initialize GL\n");
+    return 1;
+  }
+
+  gfx::Size size(kSurfaceWidth, kSurfaceHeight);
+  scoped_refptr<gfx::GLSurface> surface(
+      gfx::GLSurface::CreateOffscreenGLSurface(false, size));
+  scoped_refptr<gfx::GLContext> context;
+  if (surface.get()) {
+    context = gfx::GLContext::CreateGLContext(NULL, surface.get(),
+                                              gfx::PreferDiscreteGpu);
+  }
+  if (!context.get()) {
+    fprintf(stderr, "Could not create a GL context\n");
+    return 1;
+  }
+
+  gpu::CommandBufferService command_buffer;
+  command_buffer.Initialize();
+  scoped_ptr<gpu::gles2::GLES2Decoder> decoder(
+      gpu::gles2::GLES2Decoder::Create(new gpu::gles2::ContextGroup(
+          new gpu::gles2::MailboxManager, NULL, true)));
+  TimingHandler handler(decoder.get(),
+                        command_line.HasSwitch(kFinishSwitch));
+  gpu::GpuScheduler scheduler(&command_buffer, &handler, decoder.get());
+  decoder->set_engine(&scheduler);
+
+  std::vector<int32> attribs;
+  if (!decoder->Initialize(surface.get(),
+                           context.get(),
+                           true,
+                           size,
+                           gpu::gles2::DisallowedFeatures(),
+                           "*",
+                           attribs)) {
+    fprintf(stderr, "Could not initialize the decoder\n");
+    return 1;
+  }
+
+  command_buffer.SetPutOffsetChangeCallback(
+      base::Bind(&PumpCommands, decoder.get(), &scheduler));
+  command_buffer.SetGetBufferChangeCallback(
+      base::Bind(&gpu::GpuScheduler::SetGetBuffer,
+                 base::Unretained(&scheduler)));
+
+  TimeTicks start = TimeTicks::HighResNow();
+  bool replayed = Replay(&reader, &command_buffer);
+  TimeDelta elapsed = TimeTicks::HighResNow() - start;
+
+  handler.PrintStats();
+  printf("Replayed in %.3f ms\n", elapsed.InMillisecondsF());
+  decoder->Destroy();
+  return replayed ? 0 : 1;
+}
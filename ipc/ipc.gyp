@@ -48,8 +48,10 @@
         'file_descriptor_set_posix_unittest.cc',
         'ipc_channel_posix_unittest.cc',
         'ipc_fuzzing_tests.cc',
+        'ipc_message_stats_unittest.cc',
         'ipc_message_unittest.cc',
         'ipc_send_fds_test.cc',
+        'ipc_shared_payload_posix_unittest.cc',
         'ipc_sync_channel_unittest.cc',
         'ipc_sync_message_unittest.cc',
         'ipc_sync_message_unittest.h',
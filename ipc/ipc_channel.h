@@ -108,6 +108,13 @@ class IPC_EXPORT Channel : public Message::Sender {
                                      // constants starting from 0.
   };
 
+  // A large message may be replaced by a message of this type, which tells
+  // the peer where in shared memory to find it. It is internal to the
+  // Channel class too, and also has a MSG_ROUTING_NONE routing_id.
+  enum {
+    SHARED_PAYLOAD_MESSAGE_TYPE = kuint16max - 1
+  };
+
   // The maximum message size in bytes. Attempting to receive a message of this
   // size or bigger results in a channel error.
   static const size_t kMaximumMessageSize = 128 * 1024 * 1024;
@@ -115,6 +122,10 @@ class IPC_EXPORT Channel : public Message::Sender {
   // Ammount of data to read at once from the pipe.
   static const size_t kReadBufferSize = 4 * 1024;
 
+  // The read buffer is doubled, up to this size, each time a read fills it,
+  // so that a busy channel is drained with fewer reads.
+  static const size_t kMaximumReadBufferSize = 64 * 1024;
+
   // Initialize a Channel.
   //
   // |channel_handle| identifies the communication Channel. For POSIX, if
@@ -10,14 +10,12 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
-#include <sys/un.h>
-
-#if defined(OS_OPENBSD)
 #include <sys/uio.h>
-#endif
+#include <sys/un.h>
 
 #include <string>
 #include <map>
+#include <vector>
 
 #include "base/command_line.h"
 #include "base/eintr_wrapper.h"
@@ -38,6 +36,7 @@
 #include "ipc/file_descriptor_set_posix.h"
 #include "ipc/ipc_logging.h"
 #include "ipc/ipc_message_utils.h"
+#include "ipc/ipc_shared_payload_posix.h"
 
 namespace IPC {
 
@@ -292,6 +291,46 @@ bool SocketWriteErrorIsRecoverable() {
 #endif  // OS_MACOSX
 }
 
+// A message with more pieces than this is flattened before it is sent.
+const size_t kMaxIOVecsPerMessage = 16;
+
+// Queued messages are written together, up to this many iovecs at a time.
+const size_t kMaxIOVecsPerWrite = 4 * kMaxIOVecsPerMessage;
+
+// Fills in |iovs| with the part of |msg| after its first |bytes_written|
+// bytes, and returns the number of iovecs used.  Data written into |msg| by
+// reference is sent from where it is rather than being copied in.
+size_t GetUnwrittenIOVecs(Message* msg, size_t bytes_written,
+                          struct iovec* iovs) {
+  if (!msg->has_references()) {
+    iovs[0].iov_base = const_cast<char*>(
+        reinterpret_cast<const char*>(msg->data()) + bytes_written);
+    iovs[0].iov_len = msg->size() - bytes_written;
+    return 1;
+  }
+
+  std::vector<Pickle::Segment> segments;
+  msg->GetSegments(&segments);
+  if (segments.size() > kMaxIOVecsPerMessage) {
+    msg->Flatten();
+    return GetUnwrittenIOVecs(msg, bytes_written, iovs);
+  }
+
+  size_t num_iovs = 0;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    if (bytes_written >= segments[i].size) {
+      bytes_written -= segments[i].size;
+      continue;
+    }
+    iovs[num_iovs].iov_base =
+        const_cast<char*>(segments[i].data + bytes_written);
+    iovs[num_iovs].iov_len = segments[i].size - bytes_written;
+    bytes_written = 0;
+    ++num_iovs;
+  }
+  return num_iovs;
+}
+
 }  // namespace
 //------------------------------------------------------------------------------
 
@@ -495,13 +534,13 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
 
     size_t amt_to_write = msg->size() - message_send_bytes_written_;
     DCHECK_NE(0U, amt_to_write);
-    const char* out_bytes = reinterpret_cast<const char*>(msg->data()) +
-        message_send_bytes_written_;
+    struct iovec iovs[kMaxIOVecsPerWrite];
+    size_t num_iovs =
+        GetUnwrittenIOVecs(msg, message_send_bytes_written_, iovs);
 
     struct msghdr msgh = {0};
-    struct iovec iov = {const_cast<char*>(out_bytes), amt_to_write};
-    msgh.msg_iov = &iov;
-    msgh.msg_iovlen = 1;
+    msgh.msg_iov = iovs;
+    msgh.msg_iovlen = num_iovs;
     char buf[CMSG_SPACE(
         sizeof(int) * FileDescriptorSet::kMaxDescriptorsPerMessage)];
 
@@ -546,9 +585,11 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
         // fd_pipe_ which makes Seccomp sandbox operation more efficient.
         struct iovec fd_pipe_iov = { const_cast<char *>(""), 1 };
         msgh.msg_iov = &fd_pipe_iov;
+        msgh.msg_iovlen = 1;
         fd_written = fd_pipe_;
         bytes_written = HANDLE_EINTR(sendmsg(fd_pipe_, &msgh, MSG_DONTWAIT));
-        msgh.msg_iov = &iov;
+        msgh.msg_iov = iovs;
+        msgh.msg_iovlen = num_iovs;
         msgh.msg_controllen = 0;
         if (bytes_written > 0) {
           msg->file_descriptor_set()->CommitAll();
@@ -559,12 +600,26 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
 
     if (bytes_written == 1) {
       fd_written = pipe_;
+      // The messages queued behind this one go out in the same write, up to
+      // the first one that has descriptors to send.
+      if (!msgh.msg_controllen) {
+        for (size_t i = 1; i < output_queue_.size() &&
+             num_iovs + kMaxIOVecsPerMessage <= kMaxIOVecsPerWrite; ++i) {
+          Message* next = output_queue_[i];
+          if (!next->file_descriptor_set()->empty())
+            break;
+          num_iovs += GetUnwrittenIOVecs(next, 0, iovs + num_iovs);
+          amt_to_write += next->size();
+        }
+        msgh.msg_iovlen = num_iovs;
+      }
 #if defined(IPC_USES_READWRITE)
       if ((mode_ & MODE_CLIENT_FLAG) && IsHelloMessage(*msg)) {
         DCHECK_EQ(msg->file_descriptor_set()->size(), 1U);
       }
       if (!msgh.msg_controllen) {
-        bytes_written = HANDLE_EINTR(write(pipe_, out_bytes, amt_to_write));
+        bytes_written = HANDLE_EINTR(
+            writev(pipe_, iovs, static_cast<int>(num_iovs)));
       } else
 #endif  // IPC_USES_READWRITE
       {
@@ -593,12 +648,28 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
       return false;
     }
 
-    if (static_cast<size_t>(bytes_written) != amt_to_write) {
-      if (bytes_written > 0) {
-        // If write() fails with EAGAIN then bytes_written will be -1.
-        message_send_bytes_written_ += bytes_written;
+    // Drop the messages that were written out completely, and remember how
+    // much of the next one went. If write() fails with EAGAIN then
+    // bytes_written will be -1.
+    size_t bytes_left = bytes_written > 0 ? bytes_written : 0;
+    while (bytes_left > 0) {
+      Message* sent = output_queue_.front();
+      size_t sent_size = sent->size() - message_send_bytes_written_;
+      if (bytes_left < sent_size) {
+        message_send_bytes_written_ += bytes_left;
+        break;
       }
+      bytes_left -= sent_size;
+      message_send_bytes_written_ = 0;
 
+      // Message sent OK!
+      DVLOG(2) << "sent message @" << sent << " on channel @" << this
+               << " with type " << sent->type() << " on fd " << pipe_;
+      delete sent;
+      output_queue_.pop_front();
+    }
+
+    if (static_cast<size_t>(bytes_written) != amt_to_write) {
       // Tell libevent to call us back once things are unblocked.
       is_blocked_on_write_ = true;
       MessageLoopForIO::current()->WatchFileDescriptor(
@@ -608,14 +679,6 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
           &write_watcher_,
           this);
       return true;
-    } else {
-      message_send_bytes_written_ = 0;
-
-      // Message sent OK!
-      DVLOG(2) << "sent message @" << msg << " on channel @" << this
-               << " with type " << msg->type() << " on fd " << pipe_;
-      delete output_queue_.front();
-      output_queue_.pop();
     }
   }
   return true;
@@ -630,7 +693,10 @@ bool Channel::ChannelImpl::Send(Message* message) {
   Logging::GetInstance()->OnSendMessage(message, "");
 #endif  // IPC_MESSAGE_LOG_ENABLED
 
-  output_queue_.push(message);
+  if (Message* carrier = shared_payload_writer_.Wrap(message))
+    message = carrier;
+
+  output_queue_.push_back(message);
   if (!is_blocked_on_write_ && !waiting_connect_) {
     return ProcessOutgoingMessages();
   }
@@ -724,12 +790,16 @@ void Channel::ChannelImpl::ResetToAcceptingConnectionState() {
 
   while (!output_queue_.empty()) {
     Message* m = output_queue_.front();
-    output_queue_.pop();
+    output_queue_.pop_front();
     delete m;
   }
 
   // Close any outstanding, received file descriptors.
   ClearInputFDs();
+
+  // A new peer gets all the regions it needs along with its messages.
+  shared_payload_writer_.Reset();
+  shared_payload_reader_.Reset();
 }
 
 // static
@@ -886,7 +956,7 @@ void Channel::ChannelImpl::QueueHelloMessage() {
     DCHECK_EQ(msg->file_descriptor_set()->size(), 1U);
   }
 #endif  // IPC_USES_READWRITE
-  output_queue_.push(msg.release());
+  output_queue_.push_back(msg.release());
 }
 
 Channel::ChannelImpl::ReadState Channel::ChannelImpl::ReadData(
@@ -1089,6 +1159,11 @@ void Channel::ChannelImpl::HandleHelloMessage(const Message& msg) {
   listener()->OnChannelConnected(pid);
 }
 
+bool Channel::ChannelImpl::ReadSharedPayload(const Message& carrier,
+                                             std::vector<char>* payload) {
+  return shared_payload_reader_.Unwrap(carrier, payload);
+}
+
 void Channel::ChannelImpl::Close() {
   // Close can be called multiple time, so we need to make sure we're
   // idempotent.
@@ -10,7 +10,7 @@
 
 #include <sys/socket.h>  // for CMSG macros
 
-#include <queue>
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -18,6 +18,7 @@
 #include "base/process.h"
 #include "ipc/file_descriptor_set_posix.h"
 #include "ipc/ipc_channel_reader.h"
+#include "ipc/ipc_shared_payload_posix.h"
 
 #if !defined(OS_MACOSX)
 // On Linux, the seccomp sandbox makes it very expensive to call
@@ -89,6 +90,8 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   virtual bool WillDispatchInputMessage(Message* msg) OVERRIDE;
   virtual bool DidEmptyInputBuffers() OVERRIDE;
   virtual void HandleHelloMessage(const Message& msg) OVERRIDE;
+  virtual bool ReadSharedPayload(const Message& carrier,
+                                 std::vector<char>* payload) OVERRIDE;
 
 #if defined(IPC_USES_READWRITE)
   // Reads the next message from the fd_pipe_ and appends them to the
@@ -154,7 +157,11 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   std::string pipe_name_;
 
   // Messages to be sent are queued here.
-  std::queue<Message*> output_queue_;
+  std::deque<Message*> output_queue_;
+
+  // Large messages go through shared memory in each direction.
+  internal::SharedPayloadWriter shared_payload_writer_;
+  internal::SharedPayloadReader shared_payload_reader_;
 
   // We assume a worst case: kReadBufferSize bytes of messages, where each
   // message has no payload and a full complement of descriptors.
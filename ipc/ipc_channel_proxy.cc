@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/debug/trace_event.h"
@@ -10,10 +12,26 @@
 #include "base/memory/scoped_ptr.h"
 #include "ipc/ipc_channel_proxy.h"
 #include "ipc/ipc_logging.h"
+#include "ipc/ipc_message_macros.h"
+#include "ipc/ipc_message_stats.h"
 #include "ipc/ipc_message_utils.h"
 
 namespace IPC {
 
+namespace {
+
+// Returns true if one of |filters| handled |message|.
+bool TryFilterList(const std::vector<ChannelProxy::MessageFilter*>& filters,
+                   const Message& message) {
+  for (size_t i = 0; i < filters.size(); ++i) {
+    if (filters[i]->OnMessageReceived(message))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
 //------------------------------------------------------------------------------
 
 ChannelProxy::MessageFilter::MessageFilter() {}
@@ -32,6 +50,11 @@ bool ChannelProxy::MessageFilter::OnMessageReceived(const Message& message) {
   return false;
 }
 
+bool ChannelProxy::MessageFilter::GetSupportedMessageClasses(
+    std::vector<uint32>* supported_message_classes) const {
+  return false;
+}
+
 void ChannelProxy::MessageFilter::OnDestruct() const {
   delete this;
 }
@@ -45,6 +68,7 @@ ChannelProxy::Context::Context(Channel::Listener* listener,
     : listener_message_loop_(base::MessageLoopProxy::current()),
       listener_(listener),
       ipc_message_loop_(ipc_message_loop),
+      message_class_filters_(LastIPCMsgStart),
       channel_connected_called_(false),
       peer_pid_(base::kNullProcessId) {
 }
@@ -66,14 +90,28 @@ bool ChannelProxy::Context::TryFilters(const Message& message) {
     logger->OnPreDispatchMessage(message);
 #endif
 
-  for (size_t i = 0; i < filters_.size(); ++i) {
-    if (filters_[i]->OnMessageReceived(message)) {
+  TRACE_EVENT1("ipc", "ChannelProxy::Context::TryFilters",
+               "type", message.type());
+  bool record_stats = MessageStats::IsEnabled();
+  base::TimeTicks start_time;
+  if (record_stats)
+    start_time = base::TimeTicks::Now();
+
+  // The filters that see every message go first, then the ones that asked
+  // for the class of this message: a lookup rather than a call to each one.
+  size_t message_class = IPC_MESSAGE_ID_CLASS(message.type());
+  if (TryFilterList(global_filters_, message) ||
+      (message_class < message_class_filters_.size() &&
+       TryFilterList(message_class_filters_[message_class], message))) {
+    if (record_stats) {
+      MessageStats::GetInstance()->RecordMessage(
+          message, base::TimeTicks(), start_time, base::TimeTicks::Now());
+    }
 #ifdef IPC_MESSAGE_LOG_ENABLED
-      if (logger->Enabled())
-        logger->OnPostDispatchMessage(message, channel_id_);
+    if (logger->Enabled())
+      logger->OnPostDispatchMessage(message, channel_id_);
 #endif
-      return true;
-    }
+    return true;
   }
   return false;
 }
@@ -92,8 +130,12 @@ bool ChannelProxy::Context::OnMessageReceivedNoFilter(const Message& message) {
   // this thread is active.  That should be a reasonable assumption, but it
   // feels risky.  We may want to invent some more indirect way of referring to
   // a MessageLoop if this becomes a problem.
+  base::TimeTicks received_time;
+  if (MessageStats::IsEnabled())
+    received_time = base::TimeTicks::Now();
   listener_message_loop_->PostTask(
-      FROM_HERE, base::Bind(&Context::OnDispatchMessage, this, message));
+      FROM_HERE, base::Bind(&Context::OnDispatchMessage, this, message,
+                            received_time));
   return true;
 }
 
@@ -155,6 +197,7 @@ void ChannelProxy::Context::OnChannelClosed() {
   }
 
   // We don't need the filters anymore.
+  ClearFilterRoutes();
   filters_.clear();
 
   channel_.reset();
@@ -184,6 +227,7 @@ void ChannelProxy::Context::OnAddFilter() {
 
   for (size_t i = 0; i < new_filters.size(); ++i) {
     filters_.push_back(new_filters[i]);
+    AddFilterRoutes(new_filters[i]);
 
     // If the channel has already been created, then we need to send this
     // message so that the filter gets access to the Channel.
@@ -199,6 +243,7 @@ void ChannelProxy::Context::OnAddFilter() {
 void ChannelProxy::Context::OnRemoveFilter(MessageFilter* filter) {
   for (size_t i = 0; i < filters_.size(); ++i) {
     if (filters_[i].get() == filter) {
+      RemoveFilterRoutes(filter);
       filter->OnFilterRemoved();
       filters_.erase(filters_.begin() + i);
       return;
@@ -208,6 +253,41 @@ void ChannelProxy::Context::OnRemoveFilter(MessageFilter* filter) {
   NOTREACHED() << "filter to be removed not found";
 }
 
+// Called on the IPC::Channel thread
+void ChannelProxy::Context::AddFilterRoutes(MessageFilter* filter) {
+  std::vector<uint32> supported_message_classes;
+  if (!filter->GetSupportedMessageClasses(&supported_message_classes)) {
+    global_filters_.push_back(filter);
+    return;
+  }
+
+  for (size_t i = 0; i < supported_message_classes.size(); ++i) {
+    uint32 message_class = supported_message_classes[i];
+    DCHECK_LT(message_class, message_class_filters_.size());
+    if (message_class < message_class_filters_.size())
+      message_class_filters_[message_class].push_back(filter);
+  }
+}
+
+// Called on the IPC::Channel thread
+void ChannelProxy::Context::RemoveFilterRoutes(MessageFilter* filter) {
+  global_filters_.erase(
+      std::remove(global_filters_.begin(), global_filters_.end(), filter),
+      global_filters_.end());
+  for (size_t i = 0; i < message_class_filters_.size(); ++i) {
+    FilterList& filters = message_class_filters_[i];
+    filters.erase(std::remove(filters.begin(), filters.end(), filter),
+                  filters.end());
+  }
+}
+
+// Called on the IPC::Channel thread
+void ChannelProxy::Context::ClearFilterRoutes() {
+  global_filters_.clear();
+  for (size_t i = 0; i < message_class_filters_.size(); ++i)
+    message_class_filters_[i].clear();
+}
+
 // Called on the listener's thread
 void ChannelProxy::Context::AddFilter(MessageFilter* filter) {
   base::AutoLock auto_lock(pending_filters_lock_);
@@ -217,7 +297,8 @@ void ChannelProxy::Context::AddFilter(MessageFilter* filter) {
 }
 
 // Called on the listener's thread
-void ChannelProxy::Context::OnDispatchMessage(const Message& message) {
+void ChannelProxy::Context::OnDispatchMessage(const Message& message,
+                                              base::TimeTicks received_time) {
 #ifdef IPC_MESSAGE_LOG_ENABLED
   Logging* logger = Logging::GetInstance();
   std::string name;
@@ -244,7 +325,14 @@ void ChannelProxy::Context::OnDispatchMessage(const Message& message) {
     logger->OnPreDispatchMessage(message);
 #endif
 
-  listener_->OnMessageReceived(message);
+  if (MessageStats::IsEnabled()) {
+    base::TimeTicks start_time = base::TimeTicks::Now();
+    listener_->OnMessageReceived(message);
+    MessageStats::GetInstance()->RecordMessage(
+        message, received_time, start_time, base::TimeTicks::Now());
+  } else {
+    listener_->OnMessageReceived(message);
+  }
 
 #ifdef IPC_MESSAGE_LOG_ENABLED
   if (logger->Enabled())
@@ -12,6 +12,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop_proxy.h"
 #include "base/synchronization/lock.h"
+#include "base/time.h"
 #include "ipc/ipc_channel.h"
 #include "ipc/ipc_channel_handle.h"
 
@@ -85,6 +86,14 @@ class IPC_EXPORT ChannelProxy : public Message::Sender {
     // the message be handled in the default way.
     virtual bool OnMessageReceived(const Message& message);
 
+    // Called on the background thread when the filter is added. Override to
+    // fill in the classes (IPCMessageStart values) of the messages that the
+    // filter handles, and return true: OnMessageReceived is then only called
+    // for messages of those classes. The default returns false, and the filter
+    // sees every message.
+    virtual bool GetSupportedMessageClasses(
+        std::vector<uint32>* supported_message_classes) const;
+
     // Called when the message filter is about to be deleted.  This gives
     // derived classes the option of controlling which thread they're deleted
     // on etc.
@@ -203,8 +212,10 @@ class IPC_EXPORT ChannelProxy : public Message::Sender {
     }
     const std::string& channel_id() const { return channel_id_; }
 
-    // Dispatches a message on the listener thread.
-    void OnDispatchMessage(const Message& message);
+    // Dispatches a message on the listener thread. |received_time| is when
+    // it came in on the IPC thread, if MessageStats were on by then.
+    void OnDispatchMessage(const Message& message,
+                           base::TimeTicks received_time);
 
    protected:
     friend class base::RefCountedThreadSafe<Context>;
@@ -244,6 +255,11 @@ class IPC_EXPORT ChannelProxy : public Message::Sender {
     void OnAddFilter();
     void OnRemoveFilter(MessageFilter* filter);
 
+    // Add |filter| to, or remove it from, the filters that TryFilters tries.
+    void AddFilterRoutes(MessageFilter* filter);
+    void RemoveFilterRoutes(MessageFilter* filter);
+    void ClearFilterRoutes();
+
     // Methods called on the listener thread.
     void AddFilter(MessageFilter* filter);
     void OnDispatchConnected();
@@ -254,6 +270,13 @@ class IPC_EXPORT ChannelProxy : public Message::Sender {
 
     // List of filters.  This is only accessed on the IPC thread.
     std::vector<scoped_refptr<MessageFilter> > filters_;
+
+    // The filters that see every message, and the filters of each message
+    // class, in the order they were added.  They are owned by filters_, and
+    // only accessed on the IPC thread.
+    typedef std::vector<MessageFilter*> FilterList;
+    FilterList global_filters_;
+    std::vector<FilterList> message_class_filters_;
     scoped_refptr<base::MessageLoopProxy> ipc_message_loop_;
     scoped_ptr<Channel> channel_;
     std::string channel_id_;
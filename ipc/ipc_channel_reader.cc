@@ -8,8 +8,8 @@ namespace IPC {
 namespace internal {
 
 ChannelReader::ChannelReader(Channel::Listener* listener)
-    : listener_(listener) {
-  memset(input_buf_, 0, sizeof(input_buf_));
+    : listener_(listener),
+      input_buf_(Channel::kReadBufferSize) {
 }
 
 ChannelReader::~ChannelReader() {
@@ -18,7 +18,8 @@ ChannelReader::~ChannelReader() {
 bool ChannelReader::ProcessIncomingMessages() {
   while (true) {
     int bytes_read = 0;
-    ReadState read_state = ReadData(input_buf_, Channel::kReadBufferSize,
+    ReadState read_state = ReadData(&input_buf_[0],
+                                    static_cast<int>(input_buf_.size()),
                                     &bytes_read);
     if (read_state == READ_FAILED)
       return false;
@@ -26,13 +27,17 @@ bool ChannelReader::ProcessIncomingMessages() {
       return true;
 
     DCHECK(bytes_read > 0);
-    if (!DispatchInputData(input_buf_, bytes_read))
+    if (!DispatchInputData(&input_buf_[0], bytes_read))
       return false;
+    MaybeGrowInputBuffer(bytes_read);
   }
 }
 
 bool ChannelReader::AsyncReadComplete(int bytes_read) {
-  return DispatchInputData(input_buf_, bytes_read);
+  if (!DispatchInputData(&input_buf_[0], bytes_read))
+    return false;
+  MaybeGrowInputBuffer(bytes_read);
+  return true;
 }
 
 bool ChannelReader::IsHelloMessage(const Message& m) const {
@@ -40,6 +45,11 @@ bool ChannelReader::IsHelloMessage(const Message& m) const {
          m.type() == Channel::HELLO_MESSAGE_TYPE;
 }
 
+bool ChannelReader::IsSharedPayloadMessage(const Message& m) const {
+  return m.routing_id() == MSG_ROUTING_NONE &&
+         m.type() == Channel::SHARED_PAYLOAD_MESSAGE_TYPE;
+}
+
 bool ChannelReader::DispatchInputData(const char* input_data,
                                       int input_data_len) {
   const char* p;
@@ -70,10 +80,14 @@ bool ChannelReader::DispatchInputData(const char* input_data,
       if (!WillDispatchInputMessage(&m))
         return false;
 
-      if (IsHelloMessage(m))
+      if (IsHelloMessage(m)) {
         HandleHelloMessage(m);
-      else
+      } else if (IsSharedPayloadMessage(m)) {
+        if (!DispatchSharedPayload(m))
+          return false;
+      } else {
         listener_->OnMessageReceived(m);
+      }
       p = message_tail;
     } else {
       // Last message is partial.
@@ -81,14 +95,46 @@ bool ChannelReader::DispatchInputData(const char* input_data,
     }
   }
 
-  // Save any partial data in the overflow buffer.
-  input_overflow_buf_.assign(p, end - p);
+  // Save any partial data in the overflow buffer.  If the data came from the
+  // overflow buffer, only drop what was dispatched: copying the rest over
+  // itself after every read would make receiving a large message quadratic.
+  if (input_overflow_buf_.empty())
+    input_overflow_buf_.assign(p, end - p);
+  else
+    input_overflow_buf_.erase(0, p - input_overflow_buf_.data());
 
   if (input_overflow_buf_.empty() && !DidEmptyInputBuffers())
     return false;
   return true;
 }
 
+bool ChannelReader::DispatchSharedPayload(const Message& carrier) {
+  if (!ReadSharedPayload(carrier, &shared_payload_buf_)) {
+    LOG(ERROR) << "Bad shared payload message";
+    return false;
+  }
+  Message m(&shared_payload_buf_[0],
+            static_cast<int>(shared_payload_buf_.size()));
+  if (IsHelloMessage(m) || IsSharedPayloadMessage(m)) {
+    LOG(ERROR) << "Unexpected message in shared payload";
+    return false;
+  }
+  listener_->OnMessageReceived(m);
+  return true;
+}
+
+void ChannelReader::MaybeGrowInputBuffer(int bytes_read) {
+  // The messages dispatched from the buffer are gone by now, and whatever
+  // was left of a partial one is in the overflow buffer, so there is nothing
+  // to copy over.
+  if (static_cast<size_t>(bytes_read) < input_buf_.size() ||
+      input_buf_.size() >= Channel::kMaximumReadBufferSize)
+    return;
+  size_t new_size = input_buf_.size() * 2;
+  if (new_size > Channel::kMaximumReadBufferSize)
+    new_size = Channel::kMaximumReadBufferSize;
+  input_buf_.resize(new_size);
+}
 
 }  // namespace internal
 }  // namespace IPC
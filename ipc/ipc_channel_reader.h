@@ -5,6 +5,8 @@
 #ifndef IPC_IPC_CHANNEL_READER_H_
 #define IPC_IPC_CHANNEL_READER_H_
 
+#include <vector>
+
 #include "base/basictypes.h"
 #include "ipc/ipc_channel.h"
 
@@ -46,6 +48,10 @@ class ChannelReader {
   // set-up.
   bool IsHelloMessage(const Message& m) const;
 
+  // Returns true if the given message stands for a larger one that was sent
+  // through shared memory.
+  bool IsSharedPayloadMessage(const Message& m) const;
+
  protected:
   enum ReadState { READ_SUCCEEDED, READ_FAILED, READ_PENDING };
 
@@ -79,6 +85,11 @@ class ChannelReader {
   // Handles the first message sent over the pipe which contains setup info.
   virtual void HandleHelloMessage(const Message& msg) = 0;
 
+  // Copies the message that |carrier| stands for into |payload|. Returns
+  // false if there is no such message, which is a fatal channel error.
+  virtual bool ReadSharedPayload(const Message& carrier,
+                                 std::vector<char>* payload) = 0;
+
  private:
   // Takes the given data received from the IPC channel and dispatches any
   // fully completed messages.
@@ -86,16 +97,29 @@ class ChannelReader {
   // Returns true on success. False means channel error.
   bool DispatchInputData(const char* input_data, int input_data_len);
 
+  // Grows the input buffer if the last read of |bytes_read| bytes filled it.
+  // Must not be called while an asynchronous read into it is pending.
+  void MaybeGrowInputBuffer(int bytes_read);
+
+  // Dispatches the message that |carrier| stands for. Returns false on
+  // channel error.
+  bool DispatchSharedPayload(const Message& carrier);
+
   Channel::Listener* listener_;
 
   // We read from the pipe into this buffer. Managed by DispatchInputData, do
-  // not access directly outside that function.
-  char input_buf_[Channel::kReadBufferSize];
+  // not access directly outside that function. It starts at
+  // Channel::kReadBufferSize bytes and grows as the channel gets busier.
+  std::vector<char> input_buf_;
 
   // Large messages that span multiple pipe buffers, get built-up using
   // this buffer.
   std::string input_overflow_buf_;
 
+  // Messages sent through shared memory are copied into this buffer before
+  // they are dispatched.
+  std::vector<char> shared_payload_buf_;
+
   DISALLOW_COPY_AND_ASSIGN(ChannelReader);
 };
 
@@ -171,6 +171,13 @@ bool Channel::ChannelImpl::DidEmptyInputBuffers() {
   return true;
 }
 
+bool Channel::ChannelImpl::ReadSharedPayload(const Message& carrier,
+                                             std::vector<char>* payload) {
+  // Messages are always sent inline on Windows, where the handle of a region
+  // would have to be duplicated into the peer.
+  return false;
+}
+
 // static
 const string16 Channel::ChannelImpl::PipeName(
     const std::string& channel_id, int32* secret) {
@@ -372,6 +379,8 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages(
 
   // Write to pipe...
   Message* m = output_queue_.front();
+  // Overlapped writes take a single buffer.
+  m->Flatten();
   DCHECK(m->size() <= INT_MAX);
   BOOL ok = WriteFile(pipe_,
                       m->data(),
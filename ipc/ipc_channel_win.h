@@ -43,6 +43,8 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   virtual bool WillDispatchInputMessage(Message* msg) OVERRIDE;
   bool DidEmptyInputBuffers() OVERRIDE;
   virtual void HandleHelloMessage(const Message& msg) OVERRIDE;
+  virtual bool ReadSharedPayload(const Message& carrier,
+                                 std::vector<char>* payload) OVERRIDE;
 
   static const string16 PipeName(const std::string& channel_id,
                                  int32* secret);
@@ -37,6 +37,13 @@ class Channel;
 class Message;
 struct LogData;
 
+#if defined(OS_POSIX)
+namespace internal {
+class SharedPayloadTest;
+class SharedPayloadWriter;
+}
+#endif
+
 class IPC_EXPORT Message : public Pickle {
  public:
   // Implemented by objects that can send IPC messages across a channel.
@@ -226,6 +233,10 @@ class IPC_EXPORT Message : public Pickle {
   friend class Channel;
   friend class MessageReplyDeserializer;
   friend class SyncMessage;
+#if defined(OS_POSIX)
+  friend class internal::SharedPayloadTest;
+  friend class internal::SharedPayloadWriter;
+#endif
 
 #pragma pack(push, 4)
   struct Header : Pickle::Header {
@@ -0,0 +1,73 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_message_stats.h"
+
+#include "base/memory/singleton.h"
+#include "ipc/ipc_message.h"
+
+namespace IPC {
+
+MessageStats::Entry::Entry()
+    : count(0),
+      bytes(0),
+      queued_count(0) {
+}
+
+// static
+base::subtle::Atomic32 MessageStats::enabled_ = 0;
+
+// static
+MessageStats* MessageStats::GetInstance() {
+  return Singleton<MessageStats>::get();
+}
+
+MessageStats::MessageStats() {
+}
+
+MessageStats::~MessageStats() {
+}
+
+void MessageStats::Enable() {
+  base::subtle::NoBarrier_Store(&enabled_, 1);
+}
+
+void MessageStats::Disable() {
+  base::subtle::NoBarrier_Store(&enabled_, 0);
+}
+
+void MessageStats::RecordMessage(const Message& message,
+                                 base::TimeTicks received_time,
+                                 base::TimeTicks handler_start,
+                                 base::TimeTicks handler_end) {
+  base::TimeDelta handler_time = handler_end - handler_start;
+
+  base::AutoLock auto_lock(lock_);
+  Entry& entry = entries_[message.type()];
+  entry.count++;
+  entry.bytes += message.size();
+  entry.total_handler_time += handler_time;
+  if (handler_time > entry.max_handler_time)
+    entry.max_handler_time = handler_time;
+
+  if (!received_time.is_null()) {
+    base::TimeDelta queue_time = handler_start - received_time;
+    entry.queued_count++;
+    entry.total_queue_time += queue_time;
+    if (queue_time > entry.max_queue_time)
+      entry.max_queue_time = queue_time;
+  }
+}
+
+void MessageStats::GetEntries(EntryMap* entries) const {
+  base::AutoLock auto_lock(lock_);
+  *entries = entries_;
+}
+
+void MessageStats::Reset() {
+  base::AutoLock auto_lock(lock_);
+  entries_.clear();
+}
+
+}  // namespace IPC
@@ -0,0 +1,90 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_IPC_MESSAGE_STATS_H_
+#define IPC_IPC_MESSAGE_STATS_H_
+#pragma once
+
+#include <map>
+
+#include "base/atomicops.h"
+#include "base/basictypes.h"
+#include "base/synchronization/lock.h"
+#include "base/time.h"
+#include "ipc/ipc_export.h"
+
+template <typename T> struct DefaultSingletonTraits;
+
+namespace IPC {
+
+class Message;
+
+// Counts the messages that the channel proxies of a process dispatch, by
+// message type, along with how long they waited to be dispatched after they
+// came in on the IO thread, and how long their handlers took. Unlike
+// Logging, this is available in release builds, so that slow handlers can be
+// found in the field. It is off until Enable() is called, and costs a check
+// of a flag per message until then; once on, each message costs a couple of
+// TimeTicks::Now() calls and a short lock.
+class IPC_EXPORT MessageStats {
+ public:
+  struct IPC_EXPORT Entry {
+    Entry();
+
+    int count;
+    int64 bytes;
+
+    // Only messages dispatched on the listener thread wait in a queue;
+    // messages handled by a filter on the IO thread don't count here.
+    int queued_count;
+    base::TimeDelta total_queue_time;
+    base::TimeDelta max_queue_time;
+
+    base::TimeDelta total_handler_time;
+    base::TimeDelta max_handler_time;
+  };
+
+  // Keyed by message type.
+  typedef std::map<uint32, Entry> EntryMap;
+
+  static MessageStats* GetInstance();
+
+  // Cheap enough to be called for every message.
+  static bool IsEnabled() {
+    return base::subtle::NoBarrier_Load(&enabled_) != 0;
+  }
+
+  void Enable();
+  void Disable();
+
+  // Records that |message| was handled between |handler_start| and
+  // |handler_end|. |received_time| is when it came in on the IO thread; it is
+  // null for messages handled on the IO thread, which aren't queued.
+  void RecordMessage(const Message& message,
+                     base::TimeTicks received_time,
+                     base::TimeTicks handler_start,
+                     base::TimeTicks handler_end);
+
+  // Copies the counts so far into |entries|.
+  void GetEntries(EntryMap* entries) const;
+
+  void Reset();
+
+ private:
+  friend struct DefaultSingletonTraits<MessageStats>;
+
+  MessageStats();
+  ~MessageStats();
+
+  static base::subtle::Atomic32 enabled_;
+
+  mutable base::Lock lock_;
+  EntryMap entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(MessageStats);
+};
+
+}  // namespace IPC
+
+#endif  // IPC_IPC_MESSAGE_STATS_H_
@@ -0,0 +1,73 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_message_stats.h"
+
+#include "ipc/ipc_message.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace IPC {
+
+namespace {
+
+class MessageStatsTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    MessageStats::GetInstance()->Reset();
+  }
+
+  virtual void TearDown() {
+    MessageStats::GetInstance()->Disable();
+    MessageStats::GetInstance()->Reset();
+  }
+};
+
+TEST_F(MessageStatsTest, Enable) {
+  MessageStats* stats = MessageStats::GetInstance();
+  EXPECT_FALSE(MessageStats::IsEnabled());
+  stats->Enable();
+  EXPECT_TRUE(MessageStats::IsEnabled());
+  stats->Disable();
+  EXPECT_FALSE(MessageStats::IsEnabled());
+}
+
+TEST_F(MessageStatsTest, RecordMessage) {
+  MessageStats* stats = MessageStats::GetInstance();
+  Message message(1, 100, Message::PRIORITY_NORMAL);
+  message.WriteInt(42);
+  Message other(1, 200, Message::PRIORITY_NORMAL);
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  base::TimeDelta ms = base::TimeDelta::FromMilliseconds(1);
+
+  // Dispatched on the listener thread after a queue wait of 2ms, then 5ms.
+  stats->RecordMessage(message, start, start + 2 * ms, start + 3 * ms);
+  stats->RecordMessage(message, start, start + 5 * ms, start + 9 * ms);
+  // Handled by a filter, so it doesn't count as queued.
+  stats->RecordMessage(message, base::TimeTicks(), start, start + ms);
+  stats->RecordMessage(other, start, start, start);
+
+  MessageStats::EntryMap entries;
+  stats->GetEntries(&entries);
+  ASSERT_EQ(2u, entries.size());
+
+  const MessageStats::Entry& entry = entries[100];
+  EXPECT_EQ(3, entry.count);
+  EXPECT_EQ(3 * static_cast<int64>(message.size()), entry.bytes);
+  EXPECT_EQ(2, entry.queued_count);
+  EXPECT_EQ(7 * ms, entry.total_queue_time);
+  EXPECT_EQ(5 * ms, entry.max_queue_time);
+  EXPECT_EQ(6 * ms, entry.total_handler_time);
+  EXPECT_EQ(4 * ms, entry.max_handler_time);
+
+  EXPECT_EQ(1, entries[200].count);
+
+  stats->Reset();
+  stats->GetEntries(&entries);
+  EXPECT_TRUE(entries.empty());
+}
+
+}  // namespace
+
+}  // namespace IPC
@@ -0,0 +1,226 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/ipc_shared_payload_posix.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string.h>
+
+#include "base/atomicops.h"
+#include "base/eintr_wrapper.h"
+#include "base/file_descriptor_posix.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/shared_memory.h"
+#include "ipc/file_descriptor_set_posix.h"
+#include "ipc/ipc_channel.h"
+#include "ipc/ipc_message.h"
+
+namespace IPC {
+namespace internal {
+
+namespace {
+
+// The most regions a channel may have.
+const size_t kMaxRegions = 32;
+
+// Regions are at least this big, and their sizes are powers of two, so that
+// they can be used again for messages of similar sizes.
+const size_t kMinRegionSize = 256 * 1024;
+
+// The start of each region. The message follows.
+struct RegionHeader {
+  // Set by the sender when it copies a message in, and cleared by the
+  // receiver once it has copied the message out.
+  base::subtle::Atomic32 in_use;
+  uint32 padding;
+};
+
+const size_t kPayloadOffset = sizeof(RegionHeader);
+
+size_t GetRegionSize(size_t size) {
+  size_t region_size = kMinRegionSize;
+  while (region_size < size)
+    region_size *= 2;
+  return region_size;
+}
+
+}  // namespace
+
+struct SharedPayloadRegion {
+  SharedPayloadRegion() : size(0), peer_has_handle(false) {}
+
+  RegionHeader* header() {
+    return static_cast<RegionHeader*>(memory->memory());
+  }
+
+  scoped_ptr<base::SharedMemory> memory;
+  size_t size;
+
+  // Only used on the sending side: whether the handle of the region went out
+  // with an earlier message.
+  bool peer_has_handle;
+};
+
+//------------------------------------------------------------------------------
+
+SharedPayloadWriter::SharedPayloadWriter()
+    : pool_size_(0),
+      disabled_(false) {
+}
+
+SharedPayloadWriter::~SharedPayloadWriter() {
+}
+
+Message* SharedPayloadWriter::Wrap(Message* message) {
+  if (disabled_ || message->size() < kMinSharedPayloadSize ||
+      !message->file_descriptor_set()->empty())
+    return NULL;
+
+  int index = GetFreeRegion(kPayloadOffset + message->size());
+  if (index < 0)
+    return NULL;
+  SharedPayloadRegion* region = regions_[index].get();
+
+  scoped_ptr<Message> carrier(new Message(MSG_ROUTING_NONE,
+                                          Channel::SHARED_PAYLOAD_MESSAGE_TYPE,
+                                          message->priority()));
+  carrier->WriteInt(index);
+  carrier->WriteInt(static_cast<int>(message->size()));
+  carrier->WriteBool(!region->peer_has_handle);
+  if (!region->peer_has_handle) {
+    int fd = HANDLE_EINTR(dup(region->memory->handle().fd));
+    if (fd < 0) {
+      PLOG(ERROR) << "dup";
+      return NULL;
+    }
+    carrier->WriteInt(static_cast<int>(region->size));
+    if (!carrier->WriteFileDescriptor(base::FileDescriptor(fd, true))) {
+      NOTREACHED();
+      return NULL;
+    }
+    region->peer_has_handle = true;
+  }
+
+  // Whatever was written into |message| by reference is copied straight
+  // from where it is.
+  char* dest = static_cast<char*>(region->memory->memory()) + kPayloadOffset;
+  std::vector<Pickle::Segment> segments;
+  message->GetSegments(&segments);
+  for (size_t i = 0; i < segments.size(); ++i) {
+    memcpy(dest, segments[i].data, segments[i].size);
+    dest += segments[i].size;
+  }
+  base::subtle::NoBarrier_Store(&region->header()->in_use, 1);
+
+  delete message;
+  return carrier.release();
+}
+
+void SharedPayloadWriter::Reset() {
+  regions_.clear();
+  pool_size_ = 0;
+}
+
+int SharedPayloadWriter::GetFreeRegion(size_t size) {
+  // The smallest free region that is big enough.
+  int best = -1;
+  for (size_t i = 0; i < regions_.size(); ++i) {
+    SharedPayloadRegion* region = regions_[i].get();
+    if (region->size < size ||
+        base::subtle::Acquire_Load(&region->header()->in_use))
+      continue;
+    if (best < 0 || region->size < regions_[best]->size)
+      best = static_cast<int>(i);
+  }
+  if (best >= 0)
+    return best;
+
+  size_t region_size = GetRegionSize(size);
+  if (regions_.size() >= kMaxRegions ||
+      pool_size_ + region_size > kMaxPoolSize)
+    return -1;
+
+  linked_ptr<SharedPayloadRegion> region(new SharedPayloadRegion);
+  region->memory.reset(new base::SharedMemory);
+  if (!region->memory->CreateAndMapAnonymous(region_size)) {
+    disabled_ = true;
+    return -1;
+  }
+  region->size = region_size;
+  regions_.push_back(region);
+  pool_size_ += region_size;
+  return static_cast<int>(regions_.size() - 1);
+}
+
+//------------------------------------------------------------------------------
+
+SharedPayloadReader::SharedPayloadReader() {
+}
+
+SharedPayloadReader::~SharedPayloadReader() {
+}
+
+bool SharedPayloadReader::Unwrap(const Message& carrier,
+                                 std::vector<char>* payload) {
+  PickleIterator iter(carrier);
+  int index;
+  int size;
+  bool has_handle;
+  if (!carrier.ReadInt(&iter, &index) ||
+      !carrier.ReadInt(&iter, &size) ||
+      !carrier.ReadBool(&iter, &has_handle))
+    return false;
+  if (index < 0 || static_cast<size_t>(index) >= kMaxRegions || size <= 0)
+    return false;
+
+  if (has_handle) {
+    int region_size;
+    base::FileDescriptor descriptor;
+    if (!carrier.ReadInt(&iter, &region_size) ||
+        !carrier.ReadFileDescriptor(&iter, &descriptor))
+      return false;
+
+    // The region takes the descriptor over. Mapping past the end of the file
+    // would fault when the message is read, so don't take the sender's word
+    // for the size.
+    linked_ptr<SharedPayloadRegion> region(new SharedPayloadRegion);
+    region->memory.reset(new base::SharedMemory(descriptor, false));
+    struct stat st;
+    if (region_size < static_cast<int>(kPayloadOffset) ||
+        fstat(descriptor.fd, &st) < 0 || st.st_size < region_size ||
+        !region->memory->Map(region_size))
+      return false;
+    region->size = region_size;
+
+    if (regions_.size() <= static_cast<size_t>(index))
+      regions_.resize(index + 1);
+    regions_[index] = region;
+  }
+
+  if (static_cast<size_t>(index) >= regions_.size() || !regions_[index].get())
+    return false;
+  SharedPayloadRegion* region = regions_[index].get();
+  if (static_cast<size_t>(size) > region->size - kPayloadOffset)
+    return false;
+
+  // The sender can still write into the region, so the message is only
+  // looked at once it has been copied out.
+  const char* data =
+      static_cast<const char*>(region->memory->memory()) + kPayloadOffset;
+  payload->assign(data, data + size);
+  base::subtle::Release_Store(&region->header()->in_use, 0);
+
+  const char* start = &(*payload)[0];
+  return Message::FindNext(start, start + size) == start + size;
+}
+
+void SharedPayloadReader::Reset() {
+  regions_.clear();
+}
+
+}  // namespace internal
+}  // namespace IPC
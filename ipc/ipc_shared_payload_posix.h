@@ -0,0 +1,94 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_IPC_SHARED_PAYLOAD_POSIX_H_
+#define IPC_IPC_SHARED_PAYLOAD_POSIX_H_
+#pragma once
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/linked_ptr.h"
+#include "ipc/ipc_export.h"
+
+namespace IPC {
+
+class Message;
+
+namespace internal {
+
+struct SharedPayloadRegion;
+
+// Large messages don't go through the channel's socket: the sender copies
+// them into a shared memory region and sends a small carrier message in
+// their place, which the receiver swaps for a copy of the real message.
+//
+// Each end of a channel keeps a pool of regions for the messages it sends.
+// A region carries one message at a time; the receiver marks it as free in
+// the region itself once it has copied the message out, so there is no
+// message going back. The handle of a region is only sent along with the
+// first message that uses it, and the receiver keeps its mapping from then
+// on. Messages that carry descriptors of their own, and messages for which
+// the pool has no room, are sent as they are.
+
+// The sending side, on the channel's IO thread.
+class IPC_EXPORT SharedPayloadWriter {
+ public:
+  // Messages at least this big go through shared memory.
+  static const size_t kMinSharedPayloadSize = 32 * 1024;
+
+  // The most memory the regions of a channel may add up to.
+  static const size_t kMaxPoolSize = 32 * 1024 * 1024;
+
+  SharedPayloadWriter();
+  ~SharedPayloadWriter();
+
+  // Returns the carrier for |message|, and deletes |message|. Returns NULL
+  // if |message| has to be sent as it is, in which case it is left alone.
+  Message* Wrap(Message* message);
+
+  // Lets go of all the regions, when the channel closes.
+  void Reset();
+
+  size_t pool_size() const { return pool_size_; }
+
+ private:
+  // Returns the index of a free region of at least |size| bytes, creating
+  // one if need be, or -1.
+  int GetFreeRegion(size_t size);
+
+  std::vector<linked_ptr<SharedPayloadRegion> > regions_;
+  size_t pool_size_;
+
+  // Set once a region couldn't be created, for instance in a sandboxed
+  // process: there is no point in trying again for every message.
+  bool disabled_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedPayloadWriter);
+};
+
+// The receiving side, on the channel's IO thread.
+class IPC_EXPORT SharedPayloadReader {
+ public:
+  SharedPayloadReader();
+  ~SharedPayloadReader();
+
+  // Copies the message that |carrier| stands for out of shared memory into
+  // |payload|, and gives the region back to the sender. Returns false if the
+  // carrier doesn't make sense, which is a channel error.
+  bool Unwrap(const Message& carrier, std::vector<char>* payload);
+
+  // Unmaps all the regions, when the channel closes.
+  void Reset();
+
+ private:
+  std::vector<linked_ptr<SharedPayloadRegion> > regions_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedPayloadReader);
+};
+
+}  // namespace internal
+}  // namespace IPC
+
+#endif  // IPC_IPC_SHARED_PAYLOAD_POSIX_H_
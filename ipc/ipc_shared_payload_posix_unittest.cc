@@ -0,0 +1,164 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This test is POSIX only.
+
+#include "ipc/ipc_shared_payload_posix.h"
+
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "base/eintr_wrapper.h"
+#include "base/memory/scoped_ptr.h"
+#include "ipc/file_descriptor_set_posix.h"
+#include "ipc/ipc_channel.h"
+#include "ipc/ipc_message.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace IPC {
+namespace internal {
+
+namespace {
+
+const int kRoutingId = 7;
+const uint32 kMessageType = 42;
+
+Message* CreateMessage(size_t payload_size) {
+  Message* message = new Message(kRoutingId, kMessageType,
+                                 Message::PRIORITY_NORMAL);
+  message->WriteString(std::string(payload_size, 'x'));
+  return message;
+}
+
+bool IsCarrier(const Message& message) {
+  return message.routing_id() == MSG_ROUTING_NONE &&
+         message.type() == Channel::SHARED_PAYLOAD_MESSAGE_TYPE;
+}
+
+}  // namespace
+
+class SharedPayloadTest : public testing::Test {
+ protected:
+  // Returns the message that the other end of a channel would get for
+  // |sent|, with its own copies of the descriptors.
+  static Message* Transfer(Message* sent) {
+    Message* received = new Message(static_cast<const char*>(sent->data()),
+                                    sent->size());
+    FileDescriptorSet* fds = sent->file_descriptor_set();
+    if (!fds->empty()) {
+      std::vector<int> buffer(fds->size());
+      fds->GetDescriptors(&buffer[0]);
+      for (size_t i = 0; i < buffer.size(); ++i)
+        buffer[i] = HANDLE_EINTR(dup(buffer[i]));
+      received->file_descriptor_set()->SetDescriptors(&buffer[0],
+                                                      buffer.size());
+      fds->CommitAll();
+    }
+    return received;
+  }
+
+  static size_t GetDescriptorCount(Message* message) {
+    return message->file_descriptor_set()->size();
+  }
+};
+
+TEST_F(SharedPayloadTest, SmallMessagesAreSentInline) {
+  SharedPayloadWriter writer;
+  scoped_ptr<Message> message(CreateMessage(100));
+  EXPECT_EQ(NULL, writer.Wrap(message.get()));
+  EXPECT_EQ(0u, writer.pool_size());
+}
+
+TEST_F(SharedPayloadTest, RoundTrip) {
+  SharedPayloadWriter writer;
+  SharedPayloadReader reader;
+
+  scoped_ptr<Message> carrier(writer.Wrap(CreateMessage(100 * 1024)));
+  ASSERT_TRUE(carrier.get());
+  EXPECT_TRUE(IsCarrier(*carrier));
+  EXPECT_EQ(1u, GetDescriptorCount(carrier.get()));
+  EXPECT_LT(carrier->size(), 1024u);
+
+  scoped_ptr<Message> received(Transfer(carrier.get()));
+  std::vector<char> payload;
+  ASSERT_TRUE(reader.Unwrap(*received, &payload));
+
+  Message message(&payload[0], static_cast<int>(payload.size()));
+  EXPECT_EQ(kRoutingId, message.routing_id());
+  EXPECT_EQ(kMessageType, message.type());
+  PickleIterator iter(message);
+  std::string value;
+  ASSERT_TRUE(message.ReadString(&iter, &value));
+  EXPECT_EQ(std::string(100 * 1024, 'x'), value);
+}
+
+TEST_F(SharedPayloadTest, RegionIsReusedOnceRead) {
+  SharedPayloadWriter writer;
+  SharedPayloadReader reader;
+  std::vector<char> payload;
+
+  scoped_ptr<Message> carrier(writer.Wrap(CreateMessage(100 * 1024)));
+  ASSERT_TRUE(carrier.get());
+  scoped_ptr<Message> received(Transfer(carrier.get()));
+  ASSERT_TRUE(reader.Unwrap(*received, &payload));
+  size_t pool_size = writer.pool_size();
+
+  // The region has been read, so the next message goes into it, and its
+  // handle isn't sent again.
+  carrier.reset(writer.Wrap(CreateMessage(50 * 1024)));
+  ASSERT_TRUE(carrier.get());
+  EXPECT_EQ(0u, GetDescriptorCount(carrier.get()));
+  EXPECT_EQ(pool_size, writer.pool_size());
+  received.reset(Transfer(carrier.get()));
+  ASSERT_TRUE(reader.Unwrap(*received, &payload));
+}
+
+TEST_F(SharedPayloadTest, BusyRegionIsNotReused) {
+  SharedPayloadWriter writer;
+  SharedPayloadReader reader;
+  std::vector<char> payload;
+
+  scoped_ptr<Message> first(writer.Wrap(CreateMessage(100 * 1024)));
+  ASSERT_TRUE(first.get());
+  size_t pool_size = writer.pool_size();
+  scoped_ptr<Message> second(writer.Wrap(CreateMessage(100 * 1024)));
+  ASSERT_TRUE(second.get());
+  EXPECT_EQ(1u, GetDescriptorCount(second.get()));
+  EXPECT_EQ(2 * pool_size, writer.pool_size());
+
+  scoped_ptr<Message> received(Transfer(first.get()));
+  ASSERT_TRUE(reader.Unwrap(*received, &payload));
+  received.reset(Transfer(second.get()));
+  ASSERT_TRUE(reader.Unwrap(*received, &payload));
+}
+
+TEST_F(SharedPayloadTest, MessagesWithDescriptorsAreSentInline) {
+  SharedPayloadWriter writer;
+  scoped_ptr<Message> message(CreateMessage(100 * 1024));
+  ASSERT_TRUE(message->WriteFileDescriptor(base::FileDescriptor(0, false)));
+  EXPECT_EQ(NULL, writer.Wrap(message.get()));
+}
+
+TEST_F(SharedPayloadTest, UnknownRegionIsAnError) {
+  SharedPayloadWriter writer;
+  SharedPayloadReader reader;
+  std::vector<char> payload;
+
+  scoped_ptr<Message> carrier(writer.Wrap(CreateMessage(100 * 1024)));
+  ASSERT_TRUE(carrier.get());
+  scoped_ptr<Message> received(Transfer(carrier.get()));
+  ASSERT_TRUE(reader.Unwrap(*received, &payload));
+
+  // A reader that never got the handle of the region can't read from it.
+  carrier.reset(writer.Wrap(CreateMessage(100 * 1024)));
+  ASSERT_TRUE(carrier.get());
+  received.reset(Transfer(carrier.get()));
+  SharedPayloadReader other_reader;
+  EXPECT_FALSE(other_reader.Unwrap(*received, &payload));
+}
+
+}  // namespace internal
+}  // namespace IPC
@@ -4,6 +4,8 @@
 
 #include "ipc/ipc_sync_channel.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/lazy_instance.h"
 #include "base/location.h"
@@ -11,6 +13,7 @@
 #include "base/threading/thread_local.h"
 #include "base/synchronization/waitable_event.h"
 #include "base/synchronization/waitable_event_watcher.h"
+#include "ipc/ipc_message_stats.h"
 #include "ipc/ipc_sync_message.h"
 
 using base::TimeDelta;
@@ -63,7 +66,10 @@ class SyncChannel::ReceivedSyncMsgQueue :
 
       // We set the event in case the listener thread is blocked (or is about
       // to). In case it's not, the PostTask dispatches the messages.
-      message_queue_.push_back(QueuedMessage(new Message(msg), context));
+      QueuedMessage queued_message(new Message(msg), context);
+      if (MessageStats::IsEnabled())
+        queued_message.received_time = base::TimeTicks::Now();
+      message_queue_.push_back(queued_message);
       message_queue_version_++;
     }
 
@@ -95,6 +101,7 @@ class SyncChannel::ReceivedSyncMsgQueue :
     SyncMessageQueue::iterator it;
     while (true) {
       Message* message = NULL;
+      TimeTicks received_time;
       scoped_refptr<SyncChannel::SyncContext> context;
       {
         base::AutoLock auto_lock(message_lock_);
@@ -107,6 +114,7 @@ class SyncChannel::ReceivedSyncMsgQueue :
           if (message_group == kRestrictDispatchGroup_None ||
               message_group == dispatching_context->restrict_dispatch_group()) {
             message = it->message;
+            received_time = it->received_time;
             context = it->context;
             it = message_queue_.erase(it);
             message_queue_version_++;
@@ -118,7 +126,7 @@ class SyncChannel::ReceivedSyncMsgQueue :
 
       if (message == NULL)
         break;
-      context->OnDispatchMessage(*message);
+      context->OnDispatchMessage(*message, received_time);
       delete message;
     }
   }
@@ -155,13 +163,15 @@ class SyncChannel::ReceivedSyncMsgQueue :
 
   // Called on the ipc thread to check if we can unblock any current Send()
   // calls based on a queued reply.
+  // Several replies can be queued for the messages of a batch.
   void DispatchReplies() {
-    for (size_t i = 0; i < received_replies_.size(); ++i) {
+    for (size_t i = 0; i < received_replies_.size();) {
       Message* message = received_replies_[i].message;
       if (received_replies_[i].context->TryToUnblockListener(message)) {
         delete message;
         received_replies_.erase(received_replies_.begin() + i);
-        return;
+      } else {
+        ++i;
       }
     }
   }
@@ -195,6 +205,8 @@ class SyncChannel::ReceivedSyncMsgQueue :
     QueuedMessage(Message* m, SyncContext* c) : message(m), context(c) { }
     Message* message;
     scoped_refptr<SyncChannel::SyncContext> context;
+    // Only set if MessageStats are on.
+    TimeTicks received_time;
   };
 
   typedef std::list<QueuedMessage> SyncMessageQueue;
@@ -256,16 +268,41 @@ void SyncChannel::SyncContext::Push(SyncMessage* sync_msg) {
   deserializers_.push_back(pending);
 }
 
+void SyncChannel::SyncContext::PushBatch(
+    const std::vector<SyncMessage*>& sync_msgs) {
+  WaitableEvent* done_event = new WaitableEvent(true, false);
+  base::AutoLock auto_lock(deserializers_lock_);
+  for (size_t i = 0; i < sync_msgs.size(); ++i) {
+    PendingSyncMsg pending(SyncMessage::GetMessageId(*sync_msgs[i]),
+                           sync_msgs[i]->GetReplyDeserializer(),
+                           done_event);
+    deserializers_.push_back(pending);
+  }
+}
+
 bool SyncChannel::SyncContext::Pop() {
-  bool result;
+  return PopBatch(NULL);
+}
+
+bool SyncChannel::SyncContext::PopBatch(std::vector<bool>* results) {
+  bool result = true;
   {
     base::AutoLock auto_lock(deserializers_lock_);
-    PendingSyncMsg msg = deserializers_.back();
-    delete msg.deserializer;
-    delete msg.done_event;
-    msg.done_event = NULL;
-    deserializers_.pop_back();
-    result = msg.send_result;
+    WaitableEvent* done_event = deserializers_.back().done_event;
+    size_t count = 0;
+    while (!deserializers_.empty() &&
+           deserializers_.back().done_event == done_event) {
+      PendingSyncMsg msg = deserializers_.back();
+      delete msg.deserializer;
+      deserializers_.pop_back();
+      if (results)
+        results->push_back(msg.send_result);
+      result = result && msg.send_result;
+      ++count;
+    }
+    delete done_event;
+    if (results)
+      std::reverse(results->end() - count, results->end());
   }
 
   // We got a reply to a synchronous Send() call that's blocking the listener
@@ -295,16 +332,34 @@ void SyncChannel::SyncContext::DispatchMessages() {
 
 bool SyncChannel::SyncContext::TryToUnblockListener(const Message* msg) {
   base::AutoLock auto_lock(deserializers_lock_);
-  if (deserializers_.empty() ||
-      !SyncMessage::IsMessageReplyTo(*msg, deserializers_.back().id)) {
+  if (deserializers_.empty())
+    return false;
+
+  // Only the innermost Send can be unblocked, but it may be waiting for the
+  // replies of a whole batch, which all share its done event. The
+  // deserializer of each message goes away once its reply is in.
+  WaitableEvent* done_event = deserializers_.back().done_event;
+  PendingSyncMessageQueue::reverse_iterator begin = deserializers_.rbegin();
+  PendingSyncMessageQueue::reverse_iterator end = begin;
+  while (end != deserializers_.rend() && end->done_event == done_event)
+    ++end;
+
+  PendingSyncMessageQueue::reverse_iterator iter = begin;
+  while (iter != end && !SyncMessage::IsMessageReplyTo(*msg, iter->id))
+    ++iter;
+  if (iter == end || !iter->deserializer)
     return false;
-  }
 
-  if (!msg->is_reply_error()) {
-    deserializers_.back().send_result = deserializers_.back().deserializer->
-        SerializeOutputParameters(*msg);
+  if (!msg->is_reply_error())
+    iter->send_result = iter->deserializer->SerializeOutputParameters(*msg);
+  delete iter->deserializer;
+  iter->deserializer = NULL;
+
+  for (iter = begin; iter != end; ++iter) {
+    if (iter->deserializer)
+      return true;
   }
-  deserializers_.back().done_event->Signal();
+  done_event->Signal();
 
   return true;
 }
@@ -456,6 +511,58 @@ bool SyncChannel::SendWithTimeout(Message* message, int timeout_ms) {
   return context->Pop();
 }
 
+bool SyncChannel::SendBatch(const std::vector<Message*>& messages,
+                            std::vector<bool>* results) {
+  if (results)
+    results->clear();
+
+  // *this* might get deleted in WaitForReply.
+  scoped_refptr<SyncContext> context(sync_context());
+  // The messages belong to the IPC thread once they are sent.
+  std::vector<bool> is_sync(messages.size());
+  std::vector<SyncMessage*> sync_msgs;
+  WaitableEvent* pump_messages_event = NULL;
+  for (size_t i = 0; i < messages.size(); ++i) {
+    is_sync[i] = messages[i]->is_sync();
+    if (!is_sync[i])
+      continue;
+    SyncMessage* sync_msg = static_cast<SyncMessage*>(messages[i]);
+    sync_msgs.push_back(sync_msg);
+    if (!pump_messages_event)
+      pump_messages_event = sync_msg->pump_messages_event();
+  }
+
+  if (!sync_msgs.empty() && context->shutdown_event()->IsSignaled()) {
+    for (size_t i = 0; i < messages.size(); ++i) {
+      if (results)
+        results->push_back(!is_sync[i]);
+      delete messages[i];
+    }
+    return false;
+  }
+
+  DCHECK(sync_messages_with_no_timeout_allowed_ || sync_msgs.empty());
+  if (!sync_msgs.empty())
+    context->PushBatch(sync_msgs);
+  for (size_t i = 0; i < messages.size(); ++i)
+    ChannelProxy::Send(messages[i]);
+
+  std::vector<bool> sync_results;
+  bool result = true;
+  if (!sync_msgs.empty()) {
+    // *this* might get deleted, so only use |context| from here on.
+    WaitForReply(context, pump_messages_event);
+    result = context->PopBatch(&sync_results);
+  }
+
+  if (results) {
+    std::vector<bool>::const_iterator sync_result = sync_results.begin();
+    for (size_t i = 0; i < messages.size(); ++i)
+      results->push_back(is_sync[i] ? *sync_result++ : true);
+  }
+  return result;
+}
+
 void SyncChannel::WaitForReply(
     SyncContext* context, WaitableEvent* pump_messages_event) {
   context->DispatchMessages();
@@ -8,6 +8,7 @@
 
 #include <string>
 #include <deque>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/memory/ref_counted.h"
@@ -87,6 +88,16 @@ class IPC_EXPORT SyncChannel : public ChannelProxy,
   virtual bool Send(Message* message) OVERRIDE;
   virtual bool SendWithTimeout(Message* message, int timeout_ms);
 
+  // Sends |messages| back to back and blocks until all the replies to the
+  // synchronous ones are in, rather than waiting for each reply in turn. The
+  // messages must not depend on each other's results, since none of them is
+  // dispatched before all are sent. Incoming synchronous messages are
+  // dispatched while waiting, as with Send(). If |results| isn't NULL, it
+  // gets what Send() would have returned for each message. Returns true if
+  // all the sends succeeded.
+  bool SendBatch(const std::vector<Message*>& messages,
+                 std::vector<bool>* results);
+
   // Whether we allow sending messages with no time-out.
   void set_sync_messages_with_no_timeout_allowed(bool value) {
     sync_messages_with_no_timeout_allowed_ = value;
@@ -127,10 +138,19 @@ class IPC_EXPORT SyncChannel : public ChannelProxy,
     // we know how to deserialize the reply.
     void Push(SyncMessage* sync_msg);
 
+    // Like Push(), for messages that are waited for together: they share one
+    // send done event, which is set once all their replies are in.
+    void PushBatch(const std::vector<SyncMessage*>& sync_msgs);
+
     // Cleanly remove the top deserializer (and throw it away).  Returns the
     // result of the Send call for that message.
     bool Pop();
 
+    // Removes the top batch of deserializers, and fills |results| with the
+    // result of each Send, in the order of the batch, if it isn't NULL.
+    // Returns true if they all succeeded.
+    bool PopBatch(std::vector<bool>* results);
+
     // Returns an event that's set when the send is complete, timed out or the
     // process shut down.
     base::WaitableEvent* GetSendDoneEvent();
@@ -142,8 +162,9 @@ class IPC_EXPORT SyncChannel : public ChannelProxy,
     void DispatchMessages();
 
     // Checks if the given message is blocking the listener thread because of a
-    // synchronous send.  If it is, the thread is unblocked and true is
-    // returned. Otherwise the function returns false.
+    // synchronous send.  If it is, the thread is unblocked (once all the
+    // replies of a batch are in) and true is returned. Otherwise the function
+    // returns false.
     bool TryToUnblockListener(const Message* msg);
 
     // Called on the IPC thread when a sync send that runs a nested message loop
@@ -882,6 +882,90 @@ TEST_F(IPCSyncChannelTest, QueuedReply) {
 
 namespace {
 
+class BatchServer : public Worker {
+ public:
+  explicit BatchServer(bool pump_during_send)
+      : Worker(Channel::MODE_SERVER, "batch_server"),
+        pump_during_send_(pump_during_send) {}
+
+  void Run() {
+    int answer = 0;
+    int doubled = 0;
+    std::vector<Message*> messages;
+    messages.push_back(new SyncChannelTestMsg_AnswerToLife(&answer));
+    messages.push_back(new SyncChannelTestMsg_Double(5, &doubled));
+    if (pump_during_send_)
+      static_cast<SyncMessage*>(messages[0])->EnableMessagePumping();
+
+    std::vector<bool> results;
+    EXPECT_TRUE(channel()->SendBatch(messages, &results));
+    ASSERT_EQ(2u, results.size());
+    EXPECT_TRUE(results[0]);
+    EXPECT_TRUE(results[1]);
+    EXPECT_EQ(42, answer);
+    EXPECT_EQ(10, doubled);
+    Done();
+  }
+
+  void OnAnswer(int* answer) {
+    *answer = 42;
+  }
+
+  bool pump_during_send_;
+};
+
+// Replies to the messages of a batch in reverse order. If |recursive|, asks
+// the server something first, which the server has to answer while it's
+// waiting for the batch.
+class BatchClient : public Worker {
+ public:
+  explicit BatchClient(bool recursive)
+      : Worker(Channel::MODE_CLIENT, "batch_client"),
+        recursive_(recursive),
+        answer_reply_(NULL) {}
+
+  void OnAnswerDelay(Message* reply_msg) {
+    answer_reply_ = reply_msg;
+  }
+
+  void OnDoubleDelay(int in, Message* reply_msg) {
+    if (recursive_)
+      SendAnswerToLife(false, base::kNoTimeout, true);
+    SyncChannelTestMsg_Double::WriteReplyParams(reply_msg, in * 2);
+    Send(reply_msg);
+
+    ASSERT_TRUE(answer_reply_);
+    SyncChannelTestMsg_AnswerToLife::WriteReplyParams(answer_reply_, 42);
+    Send(answer_reply_);
+    Done();
+  }
+
+  bool recursive_;
+  Message* answer_reply_;
+};
+
+void Batch(bool pump_during_send, bool recursive) {
+  std::vector<Worker*> workers;
+  workers.push_back(new BatchServer(pump_during_send));
+  workers.push_back(new BatchClient(recursive));
+  RunTest(workers);
+}
+
+}  // namespace
+
+// Tests sending several synchronous messages and waiting for all the replies
+// at once.
+TEST_F(IPCSyncChannelTest, Batch) {
+  Batch(false, false);
+  Batch(false, true);
+  Batch(true, false);
+  Batch(true, true);
+}
+
+//-----------------------------------------------------------------------------
+
+namespace {
+
 class ChattyClient : public Worker {
  public:
   ChattyClient() :
@@ -1176,6 +1260,113 @@ TEST_F(IPCSyncChannelTest, SyncMessageFilter) {
   RunTest(workers);
 }
 
+//-----------------------------------------------------------------------------
+
+namespace {
+
+class PendingReplyFilter : public SyncMessageFilter {
+ public:
+  PendingReplyFilter(base::WaitableEvent* shutdown_event, Worker* worker)
+      : SyncMessageFilter(shutdown_event),
+        worker_(worker),
+        thread_("helper_thread") {
+    base::Thread::Options options;
+    options.message_loop_type = MessageLoop::TYPE_DEFAULT;
+    thread_.StartWithOptions(options);
+  }
+
+  virtual void OnFilterAdded(Channel* channel) {
+    SyncMessageFilter::OnFilterAdded(channel);
+    // The server holds on to the filter, and its destructor stops the helper
+    // thread, so the task doesn't need a reference: the last one mustn't go
+    // away on the helper thread.
+    thread_.message_loop()->PostTask(
+        FROM_HERE,
+        base::Bind(&PendingReplyFilter::SendMessagesOnHelperThread,
+                   base::Unretained(this)));
+  }
+
+  void SendMessagesOnHelperThread() {
+    // Both messages are out before either reply is waited for.
+    int answer = 0;
+    int doubled = 0;
+    scoped_ptr<PendingReply> answer_reply(
+        SendWithPendingReply(new SyncChannelTestMsg_AnswerToLife(&answer)));
+    scoped_ptr<PendingReply> double_reply(
+        SendWithPendingReply(new SyncChannelTestMsg_Double(5, &doubled)));
+    DCHECK(double_reply->Wait());
+    DCHECK_EQ(10, doubled);
+    DCHECK(answer_reply->Wait());
+    DCHECK_EQ(42, answer);
+
+    // The reply to a message that isn't waited for is dropped if it comes
+    // later, and doesn't get in the way of the next one.
+    int dropped = 0;
+    delete SendWithPendingReply(new SyncChannelTestMsg_AnswerToLife(&dropped));
+    doubled = 0;
+    DCHECK(Send(new SyncChannelTestMsg_Double(6, &doubled)));
+    DCHECK_EQ(12, doubled);
+
+    worker_->Done();
+  }
+
+ private:
+  virtual ~PendingReplyFilter() {}
+
+  Worker* worker_;
+  base::Thread thread_;
+};
+
+class PendingReplyServer : public Worker {
+ public:
+  PendingReplyServer()
+      : Worker(Channel::MODE_SERVER, "pending_reply_server") {
+    filter_ = new PendingReplyFilter(shutdown_event(), this);
+  }
+
+  void Run() {
+    channel()->AddFilter(filter_.get());
+  }
+
+  scoped_refptr<PendingReplyFilter> filter_;
+};
+
+// Answers a number of messages before it's done.
+class CountingClient : public Worker {
+ public:
+  explicit CountingClient(int message_count)
+      : Worker(Channel::MODE_CLIENT, "counting_client"),
+        messages_left_(message_count) {}
+
+  void OnAnswer(int* answer) {
+    *answer = 42;
+    MaybeDone();
+  }
+
+  void OnDouble(int in, int* out) {
+    *out = in * 2;
+    MaybeDone();
+  }
+
+ private:
+  void MaybeDone() {
+    if (--messages_left_ == 0)
+      Done();
+  }
+
+  int messages_left_;
+};
+
+}  // namespace
+
+// Tests sending from a SyncMessageFilter and waiting for the replies later.
+TEST_F(IPCSyncChannelTest, SyncMessageFilterPendingReply) {
+  std::vector<Worker*> workers;
+  workers.push_back(new PendingReplyServer());
+  workers.push_back(new CountingClient(4));
+  RunTest(workers);
+}
+
 // Test the case when the channel is closed and a Send is attempted after that.
 TEST_F(IPCSyncChannelTest, SendAfterClose) {
   ServerSendAfterClose server;
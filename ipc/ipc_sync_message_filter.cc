@@ -7,6 +7,7 @@
 #include "base/bind.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/message_loop_proxy.h"
 #include "base/synchronization/waitable_event.h"
 #include "ipc/ipc_sync_message.h"
@@ -15,55 +16,83 @@ using base::MessageLoopProxy;
 
 namespace IPC {
 
+SyncMessageFilter::PendingReply::PendingReply(SyncMessageFilter* filter,
+                                              SyncMessage* message)
+    : filter_(filter),
+      done_event_(true, false),
+      pending_message_(SyncMessage::GetMessageId(*message),
+                       message->GetReplyDeserializer(),
+                       &done_event_),
+      waited_(false) {
+}
+
+SyncMessageFilter::PendingReply::~PendingReply() {
+  if (!waited_)
+    filter_->RemovePendingReply(this, true);
+  delete pending_message_.deserializer;
+}
+
+bool SyncMessageFilter::PendingReply::Wait() {
+  if (!waited_) {
+    // Can't block the main thread or else it can lead to deadlocks. Also by
+    // definition, can't block the IO thread since the reply comes in there.
+    if (!done_event_.IsSignaled()) {
+      DCHECK(MessageLoopProxy::current() != filter_->listener_loop_);
+      DCHECK(MessageLoopProxy::current() != filter_->io_loop_);
+    }
+
+    base::WaitableEvent* events[2] = { filter_->shutdown_event_, &done_event_ };
+    base::WaitableEvent::WaitMany(events, 2);
+    filter_->RemovePendingReply(this, false);
+    waited_ = true;
+  }
+  return pending_message_.send_result;
+}
+
 SyncMessageFilter::SyncMessageFilter(base::WaitableEvent* shutdown_event)
     : channel_(NULL),
       listener_loop_(MessageLoopProxy::current()),
       shutdown_event_(shutdown_event) {
 }
 
-bool SyncMessageFilter::Send(Message* message) {
+SyncMessageFilter::PendingReply* SyncMessageFilter::SendWithPendingReply(
+    Message* message) {
+  DCHECK(message->is_sync());
+  PendingReply* reply =
+      new PendingReply(this, static_cast<SyncMessage*>(message));
+
   {
     base::AutoLock auto_lock(lock_);
     if (!io_loop_) {
       delete message;
-      return false;
+      reply->done_event_.Signal();
+      return reply;
     }
+    pending_sync_messages_.insert(&reply->pending_message_);
   }
 
-  if (!message->is_sync()) {
-    io_loop_->PostTask(
+  io_loop_->PostTask(
       FROM_HERE, base::Bind(&SyncMessageFilter::SendOnIOThread, this, message));
-    return true;
-  }
+  return reply;
+}
 
-  base::WaitableEvent done_event(true, false);
-  PendingSyncMsg pending_message(
-      SyncMessage::GetMessageId(*message),
-      reinterpret_cast<SyncMessage*>(message)->GetReplyDeserializer(),
-      &done_event);
+bool SyncMessageFilter::Send(Message* message) {
+  if (message->is_sync()) {
+    scoped_ptr<PendingReply> reply(SendWithPendingReply(message));
+    return reply->Wait();
+  }
 
   {
     base::AutoLock auto_lock(lock_);
-    // Can't use this class on the main thread or else it can lead to deadlocks.
-    // Also by definition, can't use this on IO thread since we're blocking it.
-    DCHECK(MessageLoopProxy::current() != listener_loop_);
-    DCHECK(MessageLoopProxy::current() != io_loop_);
-    pending_sync_messages_.insert(&pending_message);
+    if (!io_loop_) {
+      delete message;
+      return false;
+    }
   }
 
   io_loop_->PostTask(
       FROM_HERE, base::Bind(&SyncMessageFilter::SendOnIOThread, this, message));
-
-  base::WaitableEvent* events[2] = { shutdown_event_, &done_event };
-  base::WaitableEvent::WaitMany(events, 2);
-
-  {
-    base::AutoLock auto_lock(lock_);
-    delete pending_message.deserializer;
-    pending_sync_messages_.erase(&pending_message);
-  }
-
-  return pending_message.send_result;
+  return true;
 }
 
 void SyncMessageFilter::OnFilterAdded(Channel* channel) {
@@ -75,11 +104,15 @@ void SyncMessageFilter::OnFilterAdded(Channel* channel) {
 void SyncMessageFilter::OnChannelError() {
   channel_ = NULL;
   SignalAllEvents();
+  base::AutoLock auto_lock(lock_);
+  abandoned_reply_ids_.clear();
 }
 
 void SyncMessageFilter::OnChannelClosing() {
   channel_ = NULL;
   SignalAllEvents();
+  base::AutoLock auto_lock(lock_);
+  abandoned_reply_ids_.clear();
 }
 
 bool SyncMessageFilter::OnMessageReceived(const Message& message) {
@@ -96,6 +129,14 @@ bool SyncMessageFilter::OnMessageReceived(const Message& message) {
     }
   }
 
+  for (std::set<int>::iterator iter = abandoned_reply_ids_.begin();
+       iter != abandoned_reply_ids_.end(); ++iter) {
+    if (SyncMessage::IsMessageReplyTo(message, *iter)) {
+      abandoned_reply_ids_.erase(iter);
+      return true;
+    }
+  }
+
   return false;
 }
 
@@ -117,6 +158,16 @@ void SyncMessageFilter::SendOnIOThread(Message* message) {
   delete message;
 }
 
+void SyncMessageFilter::RemovePendingReply(PendingReply* reply,
+                                           bool abandoned) {
+  base::AutoLock auto_lock(lock_);
+  // Once the reply is out of the set, nothing writes to it any more.
+  if (!pending_sync_messages_.erase(&reply->pending_message_))
+    return;
+  if (abandoned && !reply->done_event_.IsSignaled())
+    abandoned_reply_ids_.insert(reply->pending_message_.id);
+}
+
 void SyncMessageFilter::SignalAllEvents() {
   base::AutoLock auto_lock(lock_);
   for (PendingSyncMessages::iterator iter = pending_sync_messages_.begin();
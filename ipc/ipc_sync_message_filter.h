@@ -11,12 +11,12 @@
 #include "base/basictypes.h"
 #include "base/memory/ref_counted.h"
 #include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
 #include "ipc/ipc_channel_proxy.h"
 #include "ipc/ipc_sync_message.h"
 
 namespace base {
 class MessageLoopProxy;
-class WaitableEvent;
 }
 
 namespace IPC {
@@ -29,8 +29,40 @@ namespace IPC {
 class IPC_EXPORT SyncMessageFilter : public ChannelProxy::MessageFilter,
                                      public Message::Sender {
  public:
+  // The reply to a synchronous message sent with SendWithPendingReply().
+  // Lives on the sending thread.
+  class IPC_EXPORT PendingReply {
+   public:
+    // Once a reply that hasn't been waited for is dropped, the output
+    // parameters of its message aren't written any more, and the reply is
+    // thrown away when it comes.
+    ~PendingReply();
+
+    // Blocks until the reply arrives, the channel goes away or the process
+    // shuts down, and returns what Send() would have. The output parameters
+    // of the message are only valid once this returns.
+    bool Wait();
+
+   private:
+    friend class SyncMessageFilter;
+
+    PendingReply(SyncMessageFilter* filter, SyncMessage* message);
+
+    scoped_refptr<SyncMessageFilter> filter_;
+    base::WaitableEvent done_event_;
+    PendingSyncMsg pending_message_;
+    bool waited_;
+
+    DISALLOW_COPY_AND_ASSIGN(PendingReply);
+  };
+
   explicit SyncMessageFilter(base::WaitableEvent* shutdown_event);
 
+  // Sends the synchronous |message| without waiting for its reply, so that
+  // the caller can go on with other work, or send other messages, and only
+  // block when it needs the result. The caller owns the returned object.
+  PendingReply* SendWithPendingReply(Message* message);
+
   // Message::Sender implementation.
   virtual bool Send(Message* message) OVERRIDE;
 
@@ -48,6 +80,10 @@ class IPC_EXPORT SyncMessageFilter : public ChannelProxy::MessageFilter,
   // Signal all the pending sends as done, used in an error condition.
   void SignalAllEvents();
 
+  // Called by PendingReply once it's done waiting, or when it goes away
+  // before that.
+  void RemovePendingReply(PendingReply* reply, bool abandoned);
+
   // The channel to which this filter was added.
   Channel* channel_;
 
@@ -60,6 +96,10 @@ class IPC_EXPORT SyncMessageFilter : public ChannelProxy::MessageFilter,
   typedef std::set<PendingSyncMsg*> PendingSyncMessages;
   PendingSyncMessages pending_sync_messages_;
 
+  // The ids of the messages whose PendingReply went away before the reply
+  // came, so that the reply can be dropped when it does.
+  std::set<int> abandoned_reply_ids_;
+
   // Locks data members above.
   base::Lock lock_;
 
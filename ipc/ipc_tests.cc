@@ -12,6 +12,7 @@
 #endif
 
 #include <stdio.h>
+#include <algorithm>
 #include <string>
 #include <utility>
 
@@ -21,12 +22,14 @@
 #include "base/command_line.h"
 #include "base/debug/debug_on_start_win.h"
 #include "base/perftimer.h"
+#include "base/stringprintf.h"
 #include "base/test/perf_test_suite.h"
 #include "base/test/test_suite.h"
 #include "base/threading/thread.h"
 #include "ipc/ipc_descriptors.h"
 #include "ipc/ipc_channel.h"
 #include "ipc/ipc_channel_proxy.h"
+#include "ipc/ipc_message_macros.h"
 #include "ipc/ipc_message_utils.h"
 #include "ipc/ipc_switches.h"
 #include "testing/multiprocess_func_list.h"
@@ -41,8 +44,6 @@ const char kSyncSocketChannel[] = "S4";
 
 const size_t kLongMessageStringNumBytes = 50000;
 
-#ifndef PERFORMANCE_TEST
-
 void IPCChannelTest::SetUp() {
   MultiProcessTest::SetUp();
 
@@ -130,6 +131,106 @@ base::ProcessHandle IPCChannelTest::SpawnChild(ChildType child_type,
 }
 #endif  // defined(OS_POSIX)
 
+// A ChannelProxy without a channel, which pushes messages straight through
+// its filters.
+class FilterOnlyChannelProxy : public IPC::ChannelProxy {
+ public:
+  FilterOnlyChannelProxy()
+      : IPC::ChannelProxy(new Context(NULL,
+                                      base::MessageLoopProxy::current())) {
+  }
+
+  void Dispatch(const IPC::Message& message) {
+    static_cast<IPC::Channel::Listener*>(context())->OnMessageReceived(
+        message);
+  }
+};
+
+// Handles the messages of one class. Unless it is |routed|, the filter
+// doesn't tell the ChannelProxy which class that is, and sees every message.
+class MessageCountFilter : public IPC::ChannelProxy::MessageFilter {
+ public:
+  MessageCountFilter(uint32 message_class, bool routed)
+      : message_class_(message_class),
+        routed_(routed),
+        messages_seen_(0),
+        messages_handled_(0) {
+  }
+
+  virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE {
+    ++messages_seen_;
+    if (IPC_MESSAGE_ID_CLASS(message.type()) != message_class_)
+      return false;
+    ++messages_handled_;
+    return true;
+  }
+
+  virtual bool GetSupportedMessageClasses(
+      std::vector<uint32>* supported_message_classes) const OVERRIDE {
+    if (!routed_)
+      return false;
+    supported_message_classes->push_back(message_class_);
+    return true;
+  }
+
+  int messages_seen() const { return messages_seen_; }
+  int messages_handled() const { return messages_handled_; }
+
+ private:
+  virtual ~MessageCountFilter() {}
+
+  uint32 message_class_;
+  bool routed_;
+  int messages_seen_;
+  int messages_handled_;
+};
+
+#ifndef PERFORMANCE_TEST
+
+TEST_F(IPCChannelTest, FilterRouting) {
+  scoped_refptr<MessageCountFilter> global_filter(
+      new MessageCountFilter(UtilityMsgStart, false));
+  scoped_refptr<MessageCountFilter> test_filter(
+      new MessageCountFilter(TestMsgStart, true));
+  scoped_refptr<MessageCountFilter> view_filter(
+      new MessageCountFilter(ViewMsgStart, true));
+
+  FilterOnlyChannelProxy proxy;
+  proxy.AddFilter(test_filter);
+  proxy.AddFilter(global_filter);
+  proxy.AddFilter(view_filter);
+  MessageLoop::current()->RunAllPending();
+
+  // The global filter sees every message, even though it was added after
+  // the filter of the test messages.
+  proxy.Dispatch(IPC::Message(0, TestMsgStart << 16,
+                              IPC::Message::PRIORITY_NORMAL));
+  EXPECT_EQ(1, global_filter->messages_seen());
+  EXPECT_EQ(1, test_filter->messages_handled());
+  EXPECT_EQ(0, view_filter->messages_seen());
+
+  proxy.Dispatch(IPC::Message(0, ViewMsgStart << 16,
+                              IPC::Message::PRIORITY_NORMAL));
+  EXPECT_EQ(2, global_filter->messages_seen());
+  EXPECT_EQ(1, test_filter->messages_seen());
+  EXPECT_EQ(1, view_filter->messages_handled());
+
+  // Nobody asked for plugin messages.
+  proxy.Dispatch(IPC::Message(0, PluginMsgStart << 16,
+                              IPC::Message::PRIORITY_NORMAL));
+  EXPECT_EQ(3, global_filter->messages_seen());
+  EXPECT_EQ(1, test_filter->messages_seen());
+  EXPECT_EQ(1, view_filter->messages_seen());
+
+  // A removed filter isn't tried anymore.
+  proxy.RemoveFilter(test_filter);
+  MessageLoop::current()->RunAllPending();
+  proxy.Dispatch(IPC::Message(0, TestMsgStart << 16,
+                              IPC::Message::PRIORITY_NORMAL));
+  EXPECT_EQ(4, global_filter->messages_seen());
+  EXPECT_EQ(1, test_filter->messages_seen());
+}
+
 TEST_F(IPCChannelTest, BasicMessageTest) {
   int v1 = 10;
   std::string v2("foobar");
@@ -418,16 +519,32 @@ MULTIPROCESS_TEST_MAIN(RunTestClient) {
 //-----------------------------------------------------------------------------
 // Manually performance test
 //
-//    This test times the roundtrip IPC message cycle. It is enabled with a
-//    special preprocessor define to enable it instead of the standard IPC
+//    These tests time the roundtrip IPC message cycle, and how fast bursts of
+//    messages of different sizes go through a channel. They are enabled with
+//    a special preprocessor define to enable them instead of the standard IPC
 //    unit tests. This works around some funny termination conditions in the
 //    regular unit tests.
 //
-//    This test is not automated. To test, you will want to vary the message
-//    count and message size in TEST to get the numbers you want.
+//    These tests are not automated. To test, you will want to vary the
+//    message count and message size in TEST to get the numbers you want.
 //
 //    FIXME(brettw): Automate this test and have it run by default.
 
+// Message types of the performance tests. The reflector sends ping-pong
+// messages straight back, drops burst messages, and answers the message
+// that ends a burst once it has read everything before it.
+enum {
+  kPingPongMessageType = 2,
+  kBurstMessageType,
+  kEndOfBurstMessageType,
+};
+
+// Returns a timestamp in milliseconds that both ends of a channel agree on.
+int NowInMilliseconds() {
+  return static_cast<int>(base::TimeTicks::Now().ToInternalValue() /
+                          base::Time::kMicrosecondsPerMillisecond);
+}
+
 // This channel listener just replies to all messages with the exact same
 // message. It assumes each message has one string parameter. When the string
 // "quit" is sent, it will exit.
@@ -447,20 +564,29 @@ class ChannelReflectorListener : public IPC::Channel::Listener {
 
   virtual bool OnMessageReceived(const IPC::Message& message) {
     count_messages_++;
+    if (message.type() == kBurstMessageType)
+      return true;
+    if (message.type() == kEndOfBurstMessageType) {
+      channel_->Send(new IPC::Message(0,
+                                      kEndOfBurstMessageType,
+                                      IPC::Message::PRIORITY_NORMAL));
+      return true;
+    }
+
     IPC::MessageIterator iter(message);
     int time = iter.NextInt();
     int msgid = iter.NextInt();
     std::string payload = iter.NextString();
-    latency_messages_ += GetTickCount() - time;
+    latency_messages_ += NowInMilliseconds() - time;
 
     // cout << "reflector msg received: " << msgid << endl;
     if (payload == "quit")
       MessageLoop::current()->Quit();
 
     IPC::Message* msg = new IPC::Message(0,
-                                         2,
+                                         kPingPongMessageType,
                                          IPC::Message::PRIORITY_NORMAL);
-    msg->WriteInt(GetTickCount());
+    msg->WriteInt(NowInMilliseconds());
     msg->WriteInt(msgid);
     msg->WriteString(payload);
     channel_->Send(msg);
@@ -498,27 +624,30 @@ class ChannelPerfListener : public IPC::Channel::Listener {
     int time = iter.NextInt();
     int msgid = iter.NextInt();
     std::string cur = iter.NextString();
-    latency_messages_ += GetTickCount() - time;
+    latency_messages_ += NowInMilliseconds() - time;
 
     // cout << "perflistener got message" << endl;
 
     count_down_--;
     if (count_down_ == 0) {
       IPC::Message* msg = new IPC::Message(0,
-                                           2,
+                                           kPingPongMessageType,
                                            IPC::Message::PRIORITY_NORMAL);
-      msg->WriteInt(GetTickCount());
+      msg->WriteInt(NowInMilliseconds());
       msg->WriteInt(count_down_);
       msg->WriteString("quit");
       channel_->Send(msg);
-      SetTimer(NULL, 1, 250, (TIMERPROC) PostQuitMessage);
+      MessageLoop::current()->PostDelayedTask(
+          FROM_HERE,
+          MessageLoop::QuitClosure(),
+          base::TimeDelta::FromMilliseconds(250));
       return true;
     }
 
     IPC::Message* msg = new IPC::Message(0,
-                                         2,
+                                         kPingPongMessageType,
                                          IPC::Message::PRIORITY_NORMAL);
-    msg->WriteInt(GetTickCount());
+    msg->WriteInt(NowInMilliseconds());
     msg->WriteInt(count_down_);
     msg->WriteString(payload_);
     channel_->Send(msg);
@@ -540,18 +669,18 @@ TEST_F(IPCChannelTest, Performance) {
   chan.set_listener(&perf_listener);
   ASSERT_TRUE(chan.Connect());
 
-  HANDLE process = SpawnChild(TEST_REFLECTOR, &chan);
+  base::ProcessHandle process = SpawnChild(TEST_REFLECTOR, &chan);
   ASSERT_TRUE(process);
 
-  PlatformThread::Sleep(base::TimeDelta::FromSeconds(1));
+  base::PlatformThread::Sleep(base::TimeDelta::FromSeconds(1));
 
   PerfTimeLogger logger("IPC_Perf");
 
   // this initial message will kick-start the ping-pong of messages
   IPC::Message* message = new IPC::Message(0,
-                                           2,
+                                           kPingPongMessageType,
                                            IPC::Message::PRIORITY_NORMAL);
-  message->WriteInt(GetTickCount());
+  message->WriteInt(NowInMilliseconds());
   message->WriteInt(-1);
   message->WriteString("Hello");
   chan.Send(message);
@@ -560,8 +689,120 @@ TEST_F(IPCChannelTest, Performance) {
   MessageLoop::current()->Run();
 
   // cleanup child process
-  WaitForSingleObject(process, 5000);
-  CloseHandle(process);
+  base::WaitForSingleProcess(process, 5000);
+  base::CloseProcessHandle(process);
+}
+
+// Stops the message loop when the reflector has read a whole burst.
+class ChannelBurstListener : public IPC::Channel::Listener {
+ public:
+  virtual bool OnMessageReceived(const IPC::Message& message) {
+    if (message.type() == kEndOfBurstMessageType)
+      MessageLoop::current()->Quit();
+    return true;
+  }
+};
+
+// Sends one way bursts of messages of growing sizes, which is what the
+// browser does when it streams resources to a renderer.
+TEST_F(IPCChannelTest, Throughput) {
+  const int kMessageSizes[] = { 12, 144, 1728, 20736, 248832 };
+  const int kBytesPerBurst = 64 * 1024 * 1024;
+  const int kMaxMessagesPerBurst = 200000;
+
+  ChannelBurstListener listener;
+  IPC::Channel chan(kReflectorChannel, IPC::Channel::MODE_SERVER, &listener);
+  ASSERT_TRUE(chan.Connect());
+
+  base::ProcessHandle process = SpawnChild(TEST_REFLECTOR, &chan);
+  ASSERT_TRUE(process);
+
+  // An empty burst, so that the timings don't include the child start-up.
+  chan.Send(new IPC::Message(0,
+                             kEndOfBurstMessageType,
+                             IPC::Message::PRIORITY_NORMAL));
+  MessageLoop::current()->Run();
+
+  for (size_t i = 0; i < arraysize(kMessageSizes); ++i) {
+    int count = std::min(kMaxMessagesPerBurst,
+                         kBytesPerBurst / kMessageSizes[i]);
+    std::string payload(kMessageSizes[i], 'a');
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int j = 0; j < count; ++j) {
+      IPC::Message* message = new IPC::Message(0,
+                                               kBurstMessageType,
+                                               IPC::Message::PRIORITY_NORMAL);
+      message->WriteString(payload);
+      chan.Send(message);
+    }
+    chan.Send(new IPC::Message(0,
+                               kEndOfBurstMessageType,
+                               IPC::Message::PRIORITY_NORMAL));
+    MessageLoop::current()->Run();
+    double seconds = (base::TimeTicks::Now() - start).InSecondsF();
+
+    std::string name = base::StringPrintf("IPC_Throughput_%d",
+                                          kMessageSizes[i]);
+    LogPerfResult((name + "_messages").c_str(), count / seconds, "msgs/s");
+    LogPerfResult((name + "_bytes").c_str(),
+                  count * static_cast<double>(kMessageSizes[i]) /
+                      (1024 * 1024) / seconds,
+                  "MB/s");
+  }
+
+  IPC::Message* message = new IPC::Message(0,
+                                           kPingPongMessageType,
+                                           IPC::Message::PRIORITY_NORMAL);
+  message->WriteInt(NowInMilliseconds());
+  message->WriteInt(-1);
+  message->WriteString("quit");
+  chan.Send(message);
+
+  // cleanup child process
+  base::WaitForSingleProcess(process, 5000);
+  base::CloseProcessHandle(process);
+}
+
+// Times how long it takes to find the filter of a message, with the filters
+// that RenderProcessHostImpl::CreateMessageFilters gives a renderer's channel
+// in the browser. The ones that handle several classes see every message.
+TEST_F(IPCChannelTest, FilterDispatch) {
+  const uint32 kMessageClasses[] = {
+    AudioMsgStart, AudioMsgStart, VideoCaptureMsgStart, AppCacheMsgStart,
+    ClipboardMsgStart, DOMStorageMsgStart, IndexedDBMsgStart,
+    GeolocationMsgStart, GpuMsgStart, MediaStreamMsgStart, PepperFileMsgStart,
+    SpeechRecognitionMsgStart, DeviceOrientationMsgStart,
+    FileUtilitiesMsgStart, MimeRegistryMsgStart, DatabaseMsgStart,
+    SocketStreamMsgStart, P2PMsgStart, QuotaMsgStart, GamepadMsgStart,
+  };
+  const int kGlobalFilters = 8;
+  const int kMessages = 1000000;
+
+  std::vector<IPC::Message> messages;
+  for (size_t i = 0; i < arraysize(kMessageClasses); ++i) {
+    messages.push_back(IPC::Message(0, kMessageClasses[i] << 16,
+                                    IPC::Message::PRIORITY_NORMAL));
+  }
+
+  for (int routed = 0; routed < 2; ++routed) {
+    FilterOnlyChannelProxy proxy;
+    for (int i = 0; i < kGlobalFilters; ++i)
+      proxy.AddFilter(new MessageCountFilter(LastIPCMsgStart, false));
+    for (size_t i = 0; i < arraysize(kMessageClasses); ++i)
+      proxy.AddFilter(new MessageCountFilter(kMessageClasses[i], routed != 0));
+    MessageLoop::current()->RunAllPending();
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int i = 0; i < kMessages; ++i)
+      proxy.Dispatch(messages[i % messages.size()]);
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+
+    LogPerfResult(routed ? "IPC_FilterDispatch_Routed" :
+                           "IPC_FilterDispatch_Unrouted",
+                  elapsed.InMicroseconds() * 1000.0 / kMessages,
+                  "ns/message");
+  }
 }
 
 // This message loop bounces all messages back to the sender
@@ -570,10 +811,10 @@ MULTIPROCESS_TEST_MAIN(RunReflector) {
   IPC::Channel chan(kReflectorChannel, IPC::Channel::MODE_CLIENT, NULL);
   ChannelReflectorListener channel_reflector_listener(&chan);
   chan.set_listener(&channel_reflector_listener);
-  ASSERT_TRUE(chan.Connect());
+  CHECK(chan.Connect());
 
   MessageLoop::current()->Run();
-  return true;
+  return 0;
 }
 
 #endif  // PERFORMANCE_TEST
@@ -142,8 +142,14 @@ AudioOutputStream* AudioManagerBase::MakeAudioOutputStreamProxy(
   if (!dispatcher) {
     base::TimeDelta close_delay =
         base::TimeDelta::FromSeconds(kStreamCloseDelaySeconds);
+    // Low latency streams are mixed by default, so that each of them doesn't
+    // need its own physical stream and audio thread wakeups. They all use the
+    // hardware parameters, so most of them share a mixer.
     const CommandLine* cmd_line = CommandLine::ForCurrentProcess();
-    if (cmd_line->HasSwitch(switches::kEnableAudioMixer)) {
+    bool use_mixer = cmd_line->HasSwitch(switches::kEnableAudioMixer) ||
+        (params.format() == AudioParameters::AUDIO_PCM_LOW_LATENCY &&
+         !cmd_line->HasSwitch(switches::kDisableAudioMixer));
+    if (use_mixer) {
       dispatcher = new AudioOutputMixer(this, params, close_delay);
     } else {
       dispatcher = new AudioOutputDispatcherImpl(this, params, close_delay);
@@ -186,12 +186,13 @@ uint32 AudioOutputMixer::OnMoreData(uint8* dest,
     if (proxy_data->pending_bytes >= pending_bytes_)
       proxy_data->pending_bytes = buffers_state.pending_bytes;
 
-    // Note: there is no way we can deduce hardware_delay_bytes for the
-    // particular proxy stream. Use zero instead.
+    // All the proxy streams are played by the same physical stream, so they
+    // all have its hardware delay.
     uint32 actual_size = proxy_data->audio_source_callback->OnMoreData(
         actual_dest,
         max_size,
-        AudioBuffersState(proxy_data->pending_bytes, 0));
+        AudioBuffersState(proxy_data->pending_bytes,
+                          buffers_state.hardware_delay_bytes));
     if (actual_size == 0)
       continue;
 
@@ -497,6 +497,63 @@ TEST_F(AudioOutputProxyTest, TwoStreams_BothPlaying_Mixer) {
   WaitForCloseTimer(kTestCloseDelayMs);
 }
 
+// Two streams with different volumes are mixed into one, and both get the
+// hardware delay of the physical stream.
+TEST_F(AudioOutputProxyTest, TwoStreams_Volumes_Mixer) {
+  MockAudioOutputStream stream;
+  MockAudioSourceCallback callback2;
+
+  InitDispatcher(base::TimeDelta::FromMilliseconds(kTestCloseDelayMs));
+
+  EXPECT_CALL(manager(), MakeAudioOutputStream(_))
+      .WillOnce(Return(&stream));
+  EXPECT_CALL(stream, Open())
+      .WillOnce(Return(true));
+  EXPECT_CALL(stream, Start(_))
+      .Times(1);
+  EXPECT_CALL(stream, SetVolume(_))
+      .Times(1);
+  EXPECT_CALL(stream, Stop())
+      .Times(1);
+  EXPECT_CALL(stream, Close())
+      .Times(1);
+
+  AudioOutputProxy* proxy1 = new AudioOutputProxy(mixer_);
+  AudioOutputProxy* proxy2 = new AudioOutputProxy(mixer_);
+  EXPECT_TRUE(proxy1->Open());
+  EXPECT_TRUE(proxy2->Open());
+  proxy1->SetVolume(1.0);
+  proxy2->SetVolume(0.5);
+  proxy1->Start(&callback_);
+  proxy2->Start(&callback2);
+
+  int16 samples1[2] = { 100, -100 };
+  int16 samples2[2] = { 40, 40 };
+  uint8* data1 = reinterpret_cast<uint8*>(samples1);
+  uint8* data2 = reinterpret_cast<uint8*>(samples2);
+  EXPECT_CALL(callback_,
+      OnMoreData(NotNull(), 4,
+                 Field(&AudioBuffersState::hardware_delay_bytes, 8)))
+      .WillOnce(DoAll(SetArrayArgument<0>(data1, data1 + sizeof(samples1)),
+                      Return(4)));
+  EXPECT_CALL(callback2,
+      OnMoreData(NotNull(), 4,
+                 Field(&AudioBuffersState::hardware_delay_bytes, 8)))
+      .WillOnce(DoAll(SetArrayArgument<0>(data2, data2 + sizeof(samples2)),
+                      Return(4)));
+  int16 mixed[2] = { 0, 0 };
+  EXPECT_EQ(4u, mixer_->OnMoreData(reinterpret_cast<uint8*>(mixed),
+                                   sizeof(mixed), AudioBuffersState(0, 8)));
+  EXPECT_EQ(120, mixed[0]);
+  EXPECT_EQ(-80, mixed[1]);
+
+  proxy1->Stop();
+  proxy2->Stop();
+  proxy1->Close();
+  proxy2->Close();
+  WaitForCloseTimer(kTestCloseDelayMs);
+}
+
 TEST_F(AudioOutputProxyTest, OpenFailed) {
   OpenFailed(dispatcher_impl_);
 }
@@ -0,0 +1,102 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "media/audio/audio_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+namespace {
+
+const int kSampleRate = 48000;
+const int kBytesPerSample = 2;
+
+// How many seconds of audio each test processes.
+const int kSeconds = 60;
+
+// Ten milliseconds of 16 bit audio, which is about what the renderer handles
+// at a time.
+class AudioBuffers {
+ public:
+  explicit AudioBuffers(int channels)
+      : channels_(channels),
+        size_(kSampleRate / 100 * channels * kBytesPerSample),
+        dst_(new int16[size_ / kBytesPerSample]),
+        src_(new int16[size_ / kBytesPerSample]) {
+    for (size_t i = 0; i < size_ / kBytesPerSample; ++i) {
+      dst_[i] = static_cast<int16>(i * 331);
+      src_[i] = static_cast<int16>(i * 127);
+    }
+  }
+
+  int channels() const { return channels_; }
+  size_t size() const { return size_; }
+  int16* dst() { return dst_.get(); }
+  int16* src() { return src_.get(); }
+
+ private:
+  int channels_;
+  size_t size_;
+  scoped_array<int16> dst_;
+  scoped_array<int16> src_;
+
+  DISALLOW_COPY_AND_ASSIGN(AudioBuffers);
+};
+
+std::string TestName(const char* name, int channels, float volume) {
+  return base::StringPrintf("Audio_%s_%dch_%.2f", name, channels, volume);
+}
+
+void AdjustVolumeFor(int channels, float volume) {
+  AudioBuffers buffers(channels);
+  PerfTimeLogger timer(TestName("AdjustVolume", channels, volume).c_str());
+  for (int i = 0; i < kSeconds * 100; ++i) {
+    AdjustVolume(buffers.dst(), buffers.size(), channels, kBytesPerSample,
+                 volume);
+  }
+  timer.Done();
+}
+
+void MixStreamsFor(int channels, float volume) {
+  AudioBuffers buffers(channels);
+  PerfTimeLogger timer(TestName("MixStreams", channels, volume).c_str());
+  for (int i = 0; i < kSeconds * 100; ++i) {
+    MixStreams(buffers.dst(), buffers.src(), buffers.size(), kBytesPerSample,
+               volume);
+  }
+  timer.Done();
+}
+
+}  // namespace
+
+TEST(AudioUtilPerfTest, AdjustVolume) {
+  AdjustVolumeFor(2, 0.25f);
+  AdjustVolumeFor(2, 0.75f);
+  AdjustVolumeFor(6, 0.75f);
+}
+
+TEST(AudioUtilPerfTest, MixStreams) {
+  MixStreamsFor(2, 1.0f);
+  MixStreamsFor(2, 0.75f);
+  MixStreamsFor(6, 0.75f);
+}
+
+TEST(AudioUtilPerfTest, FoldChannels) {
+  // FoldChannels() works in place, so fresh 5.1 audio is folded each time.
+  AudioBuffers source(6);
+  AudioBuffers buffers(6);
+  PerfTimeLogger timer(TestName("FoldChannels", 6, 0.75f).c_str());
+  for (int i = 0; i < kSeconds * 100; ++i) {
+    memcpy(buffers.dst(), source.dst(), buffers.size());
+    FoldChannels(buffers.dst(), buffers.size(), 6, kBytesPerSample, 0.75f);
+  }
+  timer.Done();
+}
+
+}  // namespace media
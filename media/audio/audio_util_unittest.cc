@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+
 #include "base/basictypes.h"
 #include "media/audio/audio_util.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -133,6 +135,35 @@ TEST(AudioUtilTest, MixStreams_s16_FullVolume) {
   EXPECT_EQ(0, expected_test);
 }
 
+// Long enough buffers are scaled 8 samples at a time where SIMD is available,
+// which must give the same results as scaling them one by one.
+TEST(AudioUtilTest, AdjustVolumeAndMixStreams_s16_Long) {
+  static const int kSamples = 37;
+  static const float kVolumes[] = { 0.25f, 0.5f, 0.75f, 0.999f };
+  for (size_t v = 0; v < arraysize(kVolumes); ++v) {
+    const int fixed_volume = static_cast<int>(kVolumes[v] * 65536);
+    int16 samples[kSamples];
+    int16 mixed[kSamples];
+    int16 expected_samples[kSamples];
+    int16 expected_mixed[kSamples];
+    for (int i = 0; i < kSamples; ++i) {
+      samples[i] = static_cast<int16>(i * 1777 - 32768);
+      mixed[i] = static_cast<int16>(32767 - i * 1999);
+      int scaled = (samples[i] * fixed_volume) >> 16;
+      expected_samples[i] = static_cast<int16>(scaled);
+      expected_mixed[i] = static_cast<int16>(
+          std::max(-32768, std::min(32767, mixed[i] + scaled)));
+    }
+
+    media::MixStreams(mixed, samples, sizeof(samples), sizeof(samples[0]),
+                      kVolumes[v]);
+    EXPECT_EQ(0, memcmp(mixed, expected_mixed, sizeof(mixed)));
+    EXPECT_TRUE(media::AdjustVolume(samples, sizeof(samples), 1,
+                                    sizeof(samples[0]), kVolumes[v]));
+    EXPECT_EQ(0, memcmp(samples, expected_samples, sizeof(samples)));
+  }
+}
+
 TEST(AudioUtilTest, MixStreams_s32_QuarterVolume) {
   // Test MixStreams() on 32 bit samples.
   int32 dst_s32[kNumberOfSamples] = { -4, 0x40, -32768, 2147483640 };
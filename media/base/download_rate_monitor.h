@@ -48,6 +48,10 @@ class MEDIA_EXPORT DownloadRateMonitor {
   // Resets monitor to uninitialized state.
   void Reset();
 
+  // Returns an approximation of the current download rate in bytes per second.
+  // Returns -1.0 if unknown.
+  float ApproximateDownloadByteRate() const;
+
  private:
   // Represents a point in time in which the media was buffering data.
   struct BufferingPoint {
@@ -103,10 +107,6 @@ class MEDIA_EXPORT DownloadRateMonitor {
   // Updates window with latest sample if it is ready.
   void UpdateSampleWindow();
 
-  // Returns an approximation of the current download rate in bytes per second.
-  // Returns -1.0 if unknown.
-  float ApproximateDownloadByteRate() const;
-
   // Helper method that returns true if the monitor believes it should fire the
   // |canplaythrough_cb_|.
   bool ShouldNotifyCanPlayThrough();
@@ -251,6 +251,8 @@ void MediaLog::AddStatisticsUpdatedEvent() {
                            last_statistics_.video_frames_decoded);
   event->params.SetInteger("video_frames_dropped",
                            last_statistics_.video_frames_dropped);
+  event->params.SetDouble("video_decode_time",
+                          last_statistics_.video_decode_time.InSecondsF());
   AddEvent(event.Pass());
   stats_update_pending_ = false;
 }
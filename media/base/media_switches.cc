@@ -26,7 +26,11 @@ const char kUsePulseAudio[] = "use-pulseaudio";
 // Set number of threads to use for video decoding.
 const char kVideoThreads[] = "video-threads";
 
-// Enables browser-side audio mixer.
+// Enables browser-side audio mixer for all the audio streams.
 const char kEnableAudioMixer[] = "enable-audio-mixer";
 
+// Disables browser-side audio mixer, which otherwise mixes the low latency
+// audio streams that have the same parameters.
+const char kDisableAudioMixer[] = "disable-audio-mixer";
+
 }  // namespace switches
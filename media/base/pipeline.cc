@@ -59,9 +59,21 @@ media::PipelineStatus PipelineStatusNotification::status() {
 }
 
 struct Pipeline::PipelineInitState {
+  PipelineInitState()
+      : video_decoder_started_early(false),
+        video_decoder_done(false),
+        video_decoder_status(PIPELINE_OK) {
+  }
+
   scoped_refptr<AudioDecoder> audio_decoder;
   scoped_refptr<VideoDecoder> video_decoder;
   scoped_refptr<CompositeFilter> composite;
+
+  // Set while the video decoder initializes alongside the audio chain.
+  bool video_decoder_started_early;
+  // Set, along with the status, if it finished before kInitVideoDecoder.
+  bool video_decoder_done;
+  PipelineStatus video_decoder_status;
 };
 
 Pipeline::Pipeline(MessageLoop* message_loop, MediaLog* media_log)
@@ -558,6 +570,12 @@ void Pipeline::OnFilterInitialize(PipelineStatus status) {
       &Pipeline::InitializeTask, this, status));
 }
 
+// Called from any thread.
+void Pipeline::OnVideoDecoderInitialize(PipelineStatus status) {
+  message_loop_->PostTask(FROM_HERE, base::Bind(
+      &Pipeline::VideoDecoderInitializedTask, this, status));
+}
+
 // Called from any thread.
 void Pipeline::OnFilterStateTransition() {
   message_loop_->PostTask(FROM_HERE, base::Bind(
@@ -589,6 +607,7 @@ void Pipeline::OnUpdateStatistics(const PipelineStatistics& stats) {
   statistics_.video_bytes_decoded += stats.video_bytes_decoded;
   statistics_.video_frames_decoded += stats.video_frames_decoded;
   statistics_.video_frames_dropped += stats.video_frames_dropped;
+  statistics_.video_decode_time += stats.video_decode_time;
   media_log_->QueueStatisticsUpdatedEvent(statistics_);
 }
 
@@ -654,9 +673,15 @@ void Pipeline::InitializeTask(PipelineStatus last_stage_status) {
          state_ == kInitVideoDecoder ||
          state_ == kInitVideoRenderer);
 
-  // Demuxer created, create audio decoder.
+  // Demuxer created, create audio decoder. The video decoder doesn't depend
+  // on the audio chain, so it's started now as well rather than after it.
   if (state_ == kInitDemuxer) {
     SetState(kInitAudioDecoder);
+    pipeline_init_state_->video_decoder_started_early =
+        InitializeVideoDecoder(demuxer_);
+    if (!IsPipelineOk())
+      return;
+
     // If this method returns false, then there's no audio stream.
     if (InitializeAudioDecoder(demuxer_))
       return;
@@ -678,6 +703,15 @@ void Pipeline::InitializeTask(PipelineStatus last_stage_status) {
   if (state_ == kInitAudioRenderer) {
     // Then perform the stage of initialization, i.e. initialize video decoder.
     SetState(kInitVideoDecoder);
+    if (pipeline_init_state_->video_decoder_started_early) {
+      // Any decoder tried after this one, because it wasn't supported, is
+      // started here as usual.
+      pipeline_init_state_->video_decoder_started_early = false;
+      if (pipeline_init_state_->video_decoder_done)
+        InitializeTask(pipeline_init_state_->video_decoder_status);
+      // Otherwise VideoDecoderInitializedTask() carries on.
+      return;
+    }
     if (InitializeVideoDecoder(demuxer_))
       return;
   }
@@ -727,6 +761,22 @@ void Pipeline::InitializeTask(PipelineStatus last_stage_status) {
   }
 }
 
+void Pipeline::VideoDecoderInitializedTask(PipelineStatus status) {
+  DCHECK(message_loop_->BelongsToCurrentThread());
+
+  // Initialization may have been torn down in the meantime.
+  if (!pipeline_init_state_.get())
+    return;
+
+  if (state_ == kInitVideoDecoder) {
+    InitializeTask(status);
+    return;
+  }
+
+  pipeline_init_state_->video_decoder_done = true;
+  pipeline_init_state_->video_decoder_status = status;
+}
+
 // This method is called as a result of the client calling Pipeline::Stop() or
 // as the result of an error condition.
 // We stop the filters in the reverse order.
@@ -1165,7 +1215,7 @@ bool Pipeline::InitializeVideoDecoder(
 
   pipeline_init_state_->video_decoder->Initialize(
       stream,
-      base::Bind(&Pipeline::OnFilterInitialize, this),
+      base::Bind(&Pipeline::OnVideoDecoderInitialize, this),
       base::Bind(&Pipeline::OnUpdateStatistics, this));
 
   video_decoder_ = pipeline_init_state_->video_decoder;
@@ -327,6 +327,7 @@ class MEDIA_EXPORT Pipeline
 
   // Callbacks executed by filters upon completing initialization.
   void OnFilterInitialize(PipelineStatus status);
+  void OnVideoDecoderInitialize(PipelineStatus status);
 
   // Callback executed by filters upon completing Play(), Pause(), or Stop().
   void OnFilterStateTransition();
@@ -362,6 +363,11 @@ class MEDIA_EXPORT Pipeline
   // |last_stage_status|.
   void InitializeTask(PipelineStatus last_stage_status);
 
+  // The video decoder starts initializing alongside the audio chain. If
+  // InitializeTask() hasn't reached kInitVideoDecoder yet, the result is
+  // kept until it does.
+  void VideoDecoderInitializedTask(PipelineStatus status);
+
   // Stops and destroys all filters, placing the pipeline in the kStopped state.
   void StopTask(const base::Closure& stop_cb);
 
@@ -0,0 +1,139 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+#include "media/base/simd/convert_yuv_to_rgb.h"
+#include "media/base/simd/yuv_to_rgb_table.h"
+
+// These use the same tables as the MMX and SSE versions, but look up the
+// entries of two pixels into one XMM register and convert four pixels per
+// iteration. The results are the same as those of the C versions.
+
+namespace {
+
+inline __m128i LoadEntry(int index) {
+  return _mm_loadl_epi64(
+      reinterpret_cast<const __m128i*>(kCoefficientsRgbY[index]));
+}
+
+// Returns the sums of the table entries of a pair of pixels that share
+// |u| and |v|, as the MMX and SSE versions compute them, in one register.
+inline __m128i ConvertPair(int y0, int y1, int u, int v) {
+  __m128i uv = _mm_adds_epi16(LoadEntry(256 + u), LoadEntry(512 + v));
+  uv = _mm_unpacklo_epi64(uv, uv);
+  __m128i y = _mm_unpacklo_epi64(LoadEntry(y0), LoadEntry(y1));
+  return _mm_srai_epi16(_mm_adds_epi16(y, uv), 6);
+}
+
+}  // namespace
+
+extern "C" {
+
+void ConvertYUVToRGB32Row_SSE2(const uint8* y_buf,
+                               const uint8* u_buf,
+                               const uint8* v_buf,
+                               uint8* rgb_buf,
+                               int width) {
+  int x = 0;
+  for (; x + 4 <= width; x += 4) {
+    int uv_x = x >> 1;
+    __m128i pixels01 = ConvertPair(y_buf[x], y_buf[x + 1],
+                                   u_buf[uv_x], v_buf[uv_x]);
+    __m128i pixels23 = ConvertPair(y_buf[x + 2], y_buf[x + 3],
+                                   u_buf[uv_x + 1], v_buf[uv_x + 1]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb_buf),
+                     _mm_packus_epi16(pixels01, pixels23));
+    rgb_buf += 16;
+  }
+
+  for (; x < width; x += 2) {
+    int uv_x = x >> 1;
+    int y1 = x + 1 < width ? y_buf[x + 1] : 0;
+    __m128i pixels = ConvertPair(y_buf[x], y1, u_buf[uv_x], v_buf[uv_x]);
+    pixels = _mm_packus_epi16(pixels, pixels);
+    if (x + 1 < width) {
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(rgb_buf), pixels);
+    } else {
+      *reinterpret_cast<int*>(rgb_buf) = _mm_cvtsi128_si32(pixels);
+    }
+    rgb_buf += 8;
+  }
+}
+
+// 16.16 fixed point is used, see ScaleYUVToRGB32Row_C.
+void ScaleYUVToRGB32Row_SSE2(const uint8* y_buf,
+                             const uint8* u_buf,
+                             const uint8* v_buf,
+                             uint8* rgb_buf,
+                             int width,
+                             int source_dx) {
+  int source_x = 0;
+  int x = 0;
+  for (; x + 4 <= width; x += 4) {
+    int x0 = source_x;
+    int x1 = x0 + source_dx;
+    int x2 = x1 + source_dx;
+    int x3 = x2 + source_dx;
+    source_x = x3 + source_dx;
+    __m128i pixels01 = ConvertPair(y_buf[x0 >> 16], y_buf[x1 >> 16],
+                                   u_buf[x0 >> 17], v_buf[x0 >> 17]);
+    __m128i pixels23 = ConvertPair(y_buf[x2 >> 16], y_buf[x3 >> 16],
+                                   u_buf[x2 >> 17], v_buf[x2 >> 17]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb_buf),
+                     _mm_packus_epi16(pixels01, pixels23));
+    rgb_buf += 16;
+  }
+
+  for (; x < width; x += 2) {
+    int x0 = source_x;
+    int x1 = x0 + source_dx;
+    source_x = x1 + source_dx;
+    int y1 = x + 1 < width ? y_buf[x1 >> 16] : 0;
+    __m128i pixels = ConvertPair(y_buf[x0 >> 16], y1,
+                                 u_buf[x0 >> 17], v_buf[x0 >> 17]);
+    pixels = _mm_packus_epi16(pixels, pixels);
+    if (x + 1 < width) {
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(rgb_buf), pixels);
+    } else {
+      *reinterpret_cast<int*>(rgb_buf) = _mm_cvtsi128_si32(pixels);
+    }
+    rgb_buf += 8;
+  }
+}
+
+}  // extern "C"
+
+namespace media {
+
+void ConvertYUVToRGB32_SSE2(const uint8* yplane,
+                            const uint8* uplane,
+                            const uint8* vplane,
+                            uint8* rgbframe,
+                            int width,
+                            int height,
+                            int ystride,
+                            int uvstride,
+                            int rgbstride,
+                            YUVType yuv_type) {
+  unsigned int y_shift = yuv_type;
+  for (int y = 0; y < height; ++y) {
+    uint8* rgb_row = rgbframe + y * rgbstride;
+    const uint8* y_ptr = yplane + y * ystride;
+    const uint8* u_ptr = uplane + (y >> y_shift) * uvstride;
+    const uint8* v_ptr = vplane + (y >> y_shift) * uvstride;
+
+    ConvertYUVToRGB32Row_SSE2(y_ptr,
+                              u_ptr,
+                              v_ptr,
+                              rgb_row,
+                              width);
+  }
+}
+
+}  // namespace media
@@ -0,0 +1,54 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/video_frame_pool.h"
+
+namespace media {
+
+VideoFramePool::VideoFramePool() {
+}
+
+VideoFramePool::~VideoFramePool() {
+}
+
+scoped_refptr<VideoFrame> VideoFramePool::CreateFrame(
+    VideoFrame::Format format,
+    size_t width,
+    size_t height,
+    base::TimeDelta timestamp,
+    base::TimeDelta duration) {
+  FrameList::iterator it = frames_.begin();
+  while (it != frames_.end()) {
+    // Once a frame is only referenced by the pool, nothing else can get a
+    // reference to it but the pool, so it is safe to check this on the pool's
+    // thread while the last other references are released elsewhere.
+    if (!(*it)->HasOneRef()) {
+      ++it;
+      continue;
+    }
+
+    if ((*it)->format() == format && (*it)->width() == width &&
+        (*it)->height() == height) {
+      scoped_refptr<VideoFrame> frame = *it;
+      frame->SetTimestamp(timestamp);
+      frame->SetDuration(duration);
+      return frame;
+    }
+
+    // The video changed size or format, so the free frames that no longer
+    // match are unlikely to be needed again.
+    it = frames_.erase(it);
+  }
+
+  scoped_refptr<VideoFrame> frame =
+      VideoFrame::CreateFrame(format, width, height, timestamp, duration);
+  frames_.push_back(frame);
+  return frame;
+}
+
+void VideoFramePool::Clear() {
+  frames_.clear();
+}
+
+}  // namespace media
@@ -0,0 +1,54 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MEDIA_BASE_VIDEO_FRAME_POOL_H_
+#define MEDIA_BASE_VIDEO_FRAME_POOL_H_
+
+#include <list>
+
+#include "base/memory/ref_counted.h"
+#include "base/time.h"
+#include "media/base/media_export.h"
+#include "media/base/video_frame.h"
+
+namespace media {
+
+// Hands out system memory frames like VideoFrame::CreateFrame(), but reuses
+// the ones it handed out earlier once nobody else holds a reference to them,
+// instead of allocating new ones for every frame.
+//
+// The frames are handed out with whatever they contained last, so the caller
+// has to fill all of them. The pool must only be used on one thread, but the
+// frames can be passed to and released on any thread.
+class MEDIA_EXPORT VideoFramePool {
+ public:
+  VideoFramePool();
+  ~VideoFramePool();
+
+  // Returns a frame of the given parameters, reusing a free one if possible.
+  scoped_refptr<VideoFrame> CreateFrame(VideoFrame::Format format,
+                                        size_t width,
+                                        size_t height,
+                                        base::TimeDelta timestamp,
+                                        base::TimeDelta duration);
+
+  // Drops the frames that aren't in use. The ones that are in use are freed
+  // when they are released.
+  void Clear();
+
+  // Returns how many frames the pool holds, whether or not they are in use.
+  size_t size() const { return frames_.size(); }
+
+ private:
+  typedef std::list<scoped_refptr<VideoFrame> > FrameList;
+
+  // Every frame of the pool. Those that only the pool references are free.
+  FrameList frames_;
+
+  DISALLOW_COPY_AND_ASSIGN(VideoFramePool);
+};
+
+}  // namespace media
+
+#endif  // MEDIA_BASE_VIDEO_FRAME_POOL_H_
@@ -0,0 +1,64 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/video_frame_pool.h"
+
+#include "media/base/buffers.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+static scoped_refptr<VideoFrame> CreateFrame(VideoFramePool* pool,
+                                             size_t width,
+                                             size_t height) {
+  return pool->CreateFrame(VideoFrame::YV12, width, height,
+                           kNoTimestamp(), kNoTimestamp());
+}
+
+TEST(VideoFramePoolTest, ReusesReleasedFrames) {
+  VideoFramePool pool;
+  scoped_refptr<VideoFrame> frame = CreateFrame(&pool, 320, 240);
+  uint8* data = frame->data(VideoFrame::kYPlane);
+
+  // A frame that is still in use isn't handed out again.
+  scoped_refptr<VideoFrame> second_frame = CreateFrame(&pool, 320, 240);
+  EXPECT_NE(frame, second_frame);
+  EXPECT_EQ(2u, pool.size());
+
+  frame = NULL;
+  scoped_refptr<VideoFrame> reused_frame = pool.CreateFrame(
+      VideoFrame::YV12, 320, 240, base::TimeDelta::FromSeconds(1),
+      base::TimeDelta::FromSeconds(2));
+  EXPECT_EQ(data, reused_frame->data(VideoFrame::kYPlane));
+  EXPECT_EQ(base::TimeDelta::FromSeconds(1), reused_frame->GetTimestamp());
+  EXPECT_EQ(base::TimeDelta::FromSeconds(2), reused_frame->GetDuration());
+  EXPECT_EQ(2u, pool.size());
+}
+
+TEST(VideoFramePoolTest, DropsFramesOfOtherSizes) {
+  VideoFramePool pool;
+  scoped_refptr<VideoFrame> frame = CreateFrame(&pool, 320, 240);
+  frame = NULL;
+
+  frame = CreateFrame(&pool, 640, 480);
+  EXPECT_EQ(640u, frame->width());
+  EXPECT_EQ(480u, frame->height());
+  EXPECT_EQ(1u, pool.size());
+}
+
+TEST(VideoFramePoolTest, FramesOutliveThePool) {
+  scoped_refptr<VideoFrame> frame;
+  {
+    VideoFramePool pool;
+    frame = CreateFrame(&pool, 320, 240);
+    scoped_refptr<VideoFrame> free_frame = CreateFrame(&pool, 320, 240);
+    free_frame = NULL;
+    pool.Clear();
+    EXPECT_EQ(0u, pool.size());
+  }
+  EXPECT_TRUE(frame->HasOneRef());
+  EXPECT_EQ(320u, frame->width());
+}
+
+}  // namespace media
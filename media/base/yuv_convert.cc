@@ -47,6 +47,8 @@ static FilterYUVRowsProc ChooseFilterYUVRowsProc() {
 
 static ConvertYUVToRGB32RowProc ChooseConvertYUVToRGB32RowProc() {
 #if defined(ARCH_CPU_X86_FAMILY)
+  if (hasSSE2())
+    return &ConvertYUVToRGB32Row_SSE2;
   if (hasSSE())
     return &ConvertYUVToRGB32Row_SSE;
   if (hasMMX())
@@ -61,6 +63,8 @@ static ScaleYUVToRGB32RowProc ChooseScaleYUVToRGB32RowProc() {
   return &ScaleYUVToRGB32Row_SSE2_X64;
 #elif defined(ARCH_CPU_X86_FAMILY)
   // Choose the best one on 32-bits system.
+  if (hasSSE2())
+    return &ScaleYUVToRGB32Row_SSE2;
   if (hasSSE())
     return &ScaleYUVToRGB32Row_SSE;
   if (hasMMX())
@@ -541,7 +545,9 @@ void ConvertYUVToRGB32(const uint8* yplane,
 #else
   static ConvertYUVToRGB32Proc convert_proc = NULL;
   if (!convert_proc) {
-    if (hasSSE())
+    if (hasSSE2())
+      convert_proc = &ConvertYUVToRGB32_SSE2;
+    else if (hasSSE())
       convert_proc = &ConvertYUVToRGB32_SSE;
     else if (hasMMX())
       convert_proc = &ConvertYUVToRGB32_MMX;
@@ -0,0 +1,129 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "build/build_config.h"
+#include "media/base/cpu_features.h"
+#include "media/base/simd/convert_yuv_to_rgb.h"
+#include "media/base/yuv_convert.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+namespace {
+
+const int kBpp = 4;
+
+// How many frames each test converts.
+const int kFrames = 10;
+
+// A YV12 frame of |width| by |height| filled with a gradient, with room for
+// it converted to RGB.
+class Frame {
+ public:
+  Frame(int width, int height)
+      : width_(width),
+        height_(height),
+        yuv_(new uint8[width * height * 3 / 2]),
+        rgb_(new uint8[width * height * kBpp]) {
+    int size = width * height * 3 / 2;
+    for (int i = 0; i < size; ++i)
+      yuv_[i] = static_cast<uint8>(i * 7 / 3);
+  }
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+  const uint8* y() const { return yuv_.get(); }
+  const uint8* u() const { return yuv_.get() + width_ * height_; }
+  const uint8* v() const { return u() + width_ * height_ / 4; }
+  uint8* rgb() { return rgb_.get(); }
+
+ private:
+  int width_;
+  int height_;
+  scoped_array<uint8> yuv_;
+  scoped_array<uint8> rgb_;
+
+  DISALLOW_COPY_AND_ASSIGN(Frame);
+};
+
+// Converts the rows of |frame| with |proc| |kFrames| times, and logs how long
+// it took.
+void ConvertRows(const char* name,
+                 ConvertYUVToRGB32RowProc proc,
+                 Frame* frame) {
+  PerfTimeLogger timer(base::StringPrintf(
+      "YUVConvert_%s_%dx%d", name, frame->width(), frame->height()).c_str());
+  for (int i = 0; i < kFrames; ++i) {
+    for (int row = 0; row < frame->height(); ++row) {
+      int uv_offset = (row >> 1) * (frame->width() / 2);
+      proc(frame->y() + row * frame->width(),
+           frame->u() + uv_offset,
+           frame->v() + uv_offset,
+           frame->rgb() + row * frame->width() * kBpp,
+           frame->width());
+    }
+  }
+  EmptyRegisterState();
+  timer.Done();
+}
+
+void ConvertRowsWithEachProc(int width, int height) {
+  Frame frame(width, height);
+  ConvertRows("C", &ConvertYUVToRGB32Row_C, &frame);
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (hasMMX())
+    ConvertRows("MMX", &ConvertYUVToRGB32Row_MMX, &frame);
+  if (hasSSE())
+    ConvertRows("SSE", &ConvertYUVToRGB32Row_SSE, &frame);
+  if (hasSSE2())
+    ConvertRows("SSE2", &ConvertYUVToRGB32Row_SSE2, &frame);
+#endif
+}
+
+// Scales |source| into a |width| by |height| frame with |filter| |kFrames|
+// times, and logs how long it took.
+void Scale(const char* name,
+           Frame* source,
+           int width,
+           int height,
+           ScaleFilter filter) {
+  scoped_array<uint8> rgb(new uint8[width * height * kBpp]);
+  PerfTimeLogger timer(base::StringPrintf(
+      "YUVScale_%s_%dx%d_to_%dx%d", name, source->width(), source->height(),
+      width, height).c_str());
+  for (int i = 0; i < kFrames; ++i) {
+    ScaleYUVToRGB32(source->y(), source->u(), source->v(), rgb.get(),
+                    source->width(), source->height(), width, height,
+                    source->width(), source->width() / 2, width * kBpp,
+                    YV12, ROTATE_0, filter);
+  }
+  timer.Done();
+}
+
+}  // namespace
+
+TEST(YUVConvertPerfTest, Convert1080p) {
+  ConvertRowsWithEachProc(1920, 1080);
+}
+
+TEST(YUVConvertPerfTest, Convert4K) {
+  ConvertRowsWithEachProc(3840, 2160);
+}
+
+TEST(YUVConvertPerfTest, Scale1080pTo4K) {
+  Frame frame(1920, 1080);
+  Scale("point", &frame, 3840, 2160, FILTER_NONE);
+  Scale("bilinear", &frame, 3840, 2160, FILTER_BILINEAR);
+}
+
+TEST(YUVConvertPerfTest, Scale4KTo1080p) {
+  Frame frame(3840, 2160);
+  Scale("point", &frame, 1920, 1080, FILTER_NONE);
+  Scale("bilinear", &frame, 1920, 1080, FILTER_BILINEAR);
+}
+
+}  // namespace media
@@ -8,7 +8,10 @@
 #include "base/callback_helpers.h"
 #include "base/command_line.h"
 #include "base/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "base/string_number_conversions.h"
+#include "base/sys_info.h"
+#include "base/time.h"
 #include "media/base/demuxer_stream.h"
 #include "media/base/limits.h"
 #include "media/base/media_switches.h"
@@ -32,12 +35,27 @@ namespace media {
 static const int kDecodeThreads = 2;
 static const int kMaxDecodeThreads = 16;
 
-// Returns the number of threads given the FFmpeg CodecID. Also inspects the
-// command line for a valid --video-threads flag.
-static int GetThreadCount(CodecID codec_id) {
+// Videos bigger than this get a thread per core, up to |kMaxAutoThreads|.
+// Smaller ones decode quickly enough with |kDecodeThreads|, and more frame
+// threads would only add to their latency.
+static const int kMinAutoThreadsArea = 1280 * 720;
+static const int kMaxAutoThreads = 8;
+
+// Returns the number of threads to decode a |coded_size| video of |codec_id|
+// with, given the number of cores. Also inspects the command line for a valid
+// --video-threads flag, which takes precedence.
+static int GetThreadCount(CodecID codec_id, const gfx::Size& coded_size) {
   // Refer to http://crbug.com/93932 for tsan suppressions on decoding.
   int decode_threads = kDecodeThreads;
 
+  // FFmpeg can't decode Theora on multiple threads.
+  if (codec_id != CODEC_ID_THEORA &&
+      coded_size.width() * coded_size.height() > kMinAutoThreadsArea) {
+    decode_threads = std::max(decode_threads,
+                              base::SysInfo::NumberOfProcessors());
+    decode_threads = std::min(decode_threads, kMaxAutoThreads);
+  }
+
   const CommandLine* cmd_line = CommandLine::ForCurrentProcess();
   std::string threads(cmd_line->GetSwitchValueASCII(switches::kVideoThreads));
   if (threads.empty() || !base::StringToInt(threads, &decode_threads))
@@ -105,7 +123,14 @@ void FFmpegVideoDecoder::Initialize(const scoped_refptr<DemuxerStream>& stream,
   // for damaged macroblocks, and set our error detection sensitivity.
   codec_context_->error_concealment = FF_EC_GUESS_MVS | FF_EC_DEBLOCK;
   codec_context_->err_recognition = AV_EF_CAREFUL;
-  codec_context_->thread_count = GetThreadCount(codec_context_->codec_id);
+  codec_context_->thread_count = GetThreadCount(codec_context_->codec_id,
+                                                config.coded_size());
+
+  // Frame threading delays each frame by a packet per extra thread, which
+  // the frames queued by the renderer hide during playback. It scales much
+  // better than slice threading, which only helps streams that were encoded
+  // with several slices (or VP8 token partitions), so let FFmpeg use both.
+  codec_context_->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
 
   AVCodec* codec = avcodec_find_decoder(codec_context_->codec_id);
   if (!codec) {
@@ -272,8 +297,13 @@ void FFmpegVideoDecoder::DoDecodeBuffer(const scoped_refptr<Buffer>& buffer) {
     }
   }
 
+  // This is how long the decoder thread was busy with |buffer|. With frame
+  // threading, most of the decoding happens on FFmpeg's threads meanwhile.
   scoped_refptr<VideoFrame> video_frame;
-  if (!Decode(unencrypted_buffer, &video_frame)) {
+  base::TimeTicks decode_start = base::TimeTicks::HighResNow();
+  bool decoded = Decode(unencrypted_buffer, &video_frame);
+  base::TimeDelta decode_time = base::TimeTicks::HighResNow() - decode_start;
+  if (!decoded) {
     state_ = kDecodeFinished;
     base::ResetAndReturn(&read_cb_).Run(kDecodeError, NULL);
     return;
@@ -281,8 +311,12 @@ void FFmpegVideoDecoder::DoDecodeBuffer(const scoped_refptr<Buffer>& buffer) {
 
   // Any successful decode counts!
   if (buffer->GetDataSize()) {
+    UMA_HISTOGRAM_CUSTOM_TIMES("Media.VideoDecodeTime", decode_time,
+                               base::TimeDelta::FromMicroseconds(100),
+                               base::TimeDelta::FromSeconds(1), 50);
     PipelineStatistics statistics;
     statistics.video_bytes_decoded = buffer->GetDataSize();
+    statistics.video_decode_time = decode_time;
     statistics_cb_.Run(statistics);
   }
 
@@ -414,6 +448,7 @@ void FFmpegVideoDecoder::ReleaseFFmpegResources() {
     av_free(av_frame_);
     av_frame_ = NULL;
   }
+  frame_pool_.Clear();
 }
 
 scoped_refptr<VideoFrame> FFmpegVideoDecoder::AllocateVideoFrame() {
@@ -421,7 +456,7 @@ scoped_refptr<VideoFrame> FFmpegVideoDecoder::AllocateVideoFrame() {
   size_t width = codec_context_->width;
   size_t height = codec_context_->height;
 
-  return VideoFrame::CreateFrame(format, width, height,
+  return frame_pool_.CreateFrame(format, width, height,
                                  kNoTimestamp(), kNoTimestamp());
 }
 
@@ -10,6 +10,7 @@
 #include "base/callback.h"
 #include "base/memory/scoped_ptr.h"
 #include "media/base/video_decoder.h"
+#include "media/base/video_frame_pool.h"
 #include "media/crypto/aes_decryptor.h"
 
 class MessageLoop;
@@ -85,6 +86,10 @@ class MEDIA_EXPORT FFmpegVideoDecoder : public VideoDecoder {
   AVCodecContext* codec_context_;
   AVFrame* av_frame_;
 
+  // The frames the decoded pictures are copied into, which are reused once
+  // the renderer is done with them.
+  VideoFramePool frame_pool_;
+
   // Frame rate of the video.
   int frame_rate_numerator_;
   int frame_rate_denominator_;
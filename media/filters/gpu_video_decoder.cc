@@ -376,6 +376,9 @@ void GpuVideoDecoder::PictureReady(const media::Picture& picture) {
   base::TimeDelta duration;
   GetBufferTimeData(picture.bitstream_buffer_id(), &timestamp, &duration);
 
+  // The picture is handed on in the texture it was decoded into. The textures
+  // are created in the compositor's context, which draws them as they are,
+  // and the decoder gets the buffer back once the frame is released.
   DCHECK(decoder_texture_target_);
   scoped_refptr<VideoFrame> frame(VideoFrame::WrapNativeTexture(
       pb.texture_id(), decoder_texture_target_, pb.size().width(),
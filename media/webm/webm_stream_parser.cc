@@ -223,14 +223,35 @@ bool WebMStreamParser::Parse(const uint8* buf, int size) {
   if (state_ == kError)
     return false;
 
-  byte_queue_.Push(buf, size);
-
-  int result = 0;
-  int bytes_parsed = 0;
   const uint8* cur = NULL;
   int cur_size = 0;
+  byte_queue_.Peek(&cur, &cur_size);
+
+  // When nothing is left over from earlier calls, |buf| is parsed in place and
+  // only the bytes that can't be parsed yet are copied into |byte_queue_|.
+  if (cur_size == 0) {
+    int bytes_parsed = ParseBytes(buf, size);
+    if (bytes_parsed < 0)
+      return false;
+    if (bytes_parsed < size)
+      byte_queue_.Push(buf + bytes_parsed, size - bytes_parsed);
+    return true;
+  }
 
+  byte_queue_.Push(buf, size);
   byte_queue_.Peek(&cur, &cur_size);
+  int bytes_parsed = ParseBytes(cur, cur_size);
+  if (bytes_parsed < 0)
+    return false;
+  byte_queue_.Pop(bytes_parsed);
+  return true;
+}
+
+int WebMStreamParser::ParseBytes(const uint8* data, int size) {
+  int result = 0;
+  int bytes_parsed = 0;
+  const uint8* cur = data;
+  int cur_size = size;
   do {
     switch (state_) {
       case kParsingHeaders:
@@ -243,12 +264,12 @@ bool WebMStreamParser::Parse(const uint8* buf, int size) {
 
       case kWaitingForInit:
       case kError:
-        return false;
+        return -1;
     }
 
     if (result < 0) {
       ChangeState(kError);
-      return false;
+      return -1;
     }
 
     cur += result;
@@ -256,8 +277,7 @@ bool WebMStreamParser::Parse(const uint8* buf, int size) {
     bytes_parsed += result;
   } while (result > 0 && cur_size > 0);
 
-  byte_queue_.Pop(bytes_parsed);
-  return true;
+  return bytes_parsed;
 }
 
 void WebMStreamParser::ChangeState(State new_state) {
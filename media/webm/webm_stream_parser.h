@@ -58,6 +58,11 @@ class WebMStreamParser : public StreamParser {
   // Returning > 0 indicates success & the number of bytes parsed.
   int ParseCluster(const uint8* data, int size);
 
+  // Parses as much of |data| as possible.
+  // Returns < 0 if the parse fails.
+  // Returns the number of bytes parsed otherwise.
+  int ParseBytes(const uint8* data, int size);
+
   State state_;
   InitCB init_cb_;
   NewConfigCB config_cb_;
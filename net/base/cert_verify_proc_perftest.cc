@@ -0,0 +1,95 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/cert_verify_proc.h"
+
+#include <vector>
+
+#include "base/file_path.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "net/base/cert_test_util.h"
+#include "net/base/cert_verify_result.h"
+#include "net/base/multi_threaded_cert_verifier.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_log.h"
+#include "net/base/test_completion_callback.h"
+#include "net/base/test_root_certs.h"
+#include "net/base/x509_certificate.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kNumVerifications = 200;
+
+// The number of connections opened at once by a browser start-up that
+// restores a few dozen tabs.
+const int kBurstSize = 50;
+
+class CertVerifyProcPerfTest : public testing::Test {
+ public:
+  CertVerifyProcPerfTest() {}
+
+  virtual void SetUp() OVERRIDE {
+    FilePath certs_dir = GetTestCertsDirectory();
+    scoped_refptr<X509Certificate> root_cert =
+        ImportCertFromFile(certs_dir, "root_ca_cert.crt");
+    ASSERT_NE(static_cast<X509Certificate*>(NULL), root_cert);
+    test_root_.Reset(root_cert);
+
+    cert_ = ImportCertFromFile(certs_dir, "ok_cert.pem");
+    ASSERT_NE(static_cast<X509Certificate*>(NULL), cert_);
+  }
+
+ protected:
+  MessageLoopForIO message_loop_;
+  ScopedTestRoot test_root_;
+  scoped_refptr<X509Certificate> cert_;
+};
+
+}  // namespace
+
+// Measures a full path build and validation, which every verification paid
+// before it could be cached.
+TEST_F(CertVerifyProcPerfTest, VerifyChain) {
+  scoped_refptr<CertVerifyProc> verify_proc(CertVerifyProc::CreateDefault());
+  PerfTimeLogger timer("CertVerifyProc_verify_chain");
+  for (int i = 0; i < kNumVerifications; ++i) {
+    CertVerifyResult verify_result;
+    EXPECT_EQ(OK, verify_proc->Verify(cert_, "127.0.0.1", 0, NULL,
+                                      &verify_result));
+  }
+  timer.Done();
+}
+
+// Measures a burst of verifications of one chain for many hosts, as at
+// start-up. Each host is a distinct request, so none of them joins another;
+// the verifier runs a few at a time.
+TEST_F(CertVerifyProcPerfTest, VerifierBurst) {
+  MultiThreadedCertVerifier verifier;
+  std::vector<CertVerifyResult> verify_results(kBurstSize);
+  ScopedVector<TestCompletionCallback> callbacks;
+
+  PerfTimeLogger timer("MultiThreadedCertVerifier_burst");
+  for (int i = 0; i < kBurstSize; ++i) {
+    callbacks.push_back(new TestCompletionCallback);
+    CertVerifier::RequestHandle request_handle;
+    int rv = verifier.Verify(
+        cert_, base::StringPrintf("host%d.example", i), 0, NULL,
+        &verify_results[i], callbacks[i]->callback(), &request_handle,
+        BoundNetLog());
+    EXPECT_EQ(ERR_IO_PENDING, rv);
+  }
+  for (int i = 0; i < kBurstSize; ++i) {
+    // None of the names match, so every request fails the name check only.
+    EXPECT_EQ(ERR_CERT_COMMON_NAME_INVALID, callbacks[i]->WaitForResult());
+  }
+  timer.Done();
+}
+
+}  // namespace net
@@ -20,7 +20,14 @@ namespace net {
 // The template types have the following requirements:
 //  KeyType must be LessThanComparable, Assignable, and CopyConstructible.
 //  ValueType must be CopyConstructible and Assignable.
-template <typename KeyType, typename ValueType>
+//  MapType must map KeyType to std::pair<ValueType, base::TimeTicks> with the
+//  interface of std::map, and erasing an element must not invalidate
+//  iterators to other elements. It may be a hash table, such as
+//  base::flat_hash_map, in which case KeyType need only be usable as its key.
+template <typename KeyType,
+          typename ValueType,
+          typename MapType =
+              std::map<KeyType, std::pair<ValueType, base::TimeTicks> > >
 class ExpiringCache {
  private:
   // Intentionally violate the C++ Style Guide so that EntryMap is known to be
@@ -30,7 +37,7 @@ class ExpiringCache {
 
   // Tuple to represent the value and when it expires.
   typedef std::pair<ValueType, base::TimeTicks> Entry;
-  typedef std::map<KeyType, Entry> EntryMap;
+  typedef MapType EntryMap;
 
  public:
   typedef KeyType key_type;
@@ -85,6 +92,26 @@ class ExpiringCache {
     return &it->second.first;
   }
 
+  // Like Get(), but also returns a value that expired less than
+  // |max_staleness| before |now|, setting |*is_stale| to true. Such a value
+  // stays in the cache.
+  const ValueType* GetStale(const KeyType& key,
+                            base::TimeTicks now,
+                            base::TimeDelta max_staleness,
+                            bool* is_stale) {
+    typename EntryMap::iterator it = entries_.find(key);
+    if (it == entries_.end())
+      return NULL;
+
+    if (!CanUseEntry(it->second, now - max_staleness)) {
+      entries_.erase(it);
+      return NULL;
+    }
+
+    *is_stale = !CanUseEntry(it->second, now);
+    return &it->second.first;
+  }
+
   // Updates or replaces the value associated with |key|.
   void Put(const KeyType& key,
            const ValueType& value,
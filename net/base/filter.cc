@@ -4,7 +4,10 @@
 
 #include "net/base/filter.h"
 
+#include <algorithm>
+
 #include "base/file_path.h"
+#include "base/lazy_instance.h"
 #include "base/string_util.h"
 #include "net/base/gzip_filter.h"
 #include "net/base/io_buffer.h"
@@ -34,13 +37,39 @@ const char kApplicationXCompress[] = "application/x-compress";
 const char kApplicationCompress[]  = "application/compress";
 const char kTextHtml[]             = "text/html";
 
-// Buffer size allocated when de-compressing data.
-const int kFilterBufSize = 32 * 1024;
+// Buffer size allocated when de-compressing data of unknown or large size.
+// Raw reads and inflate calls both work in windows of this size.
+const int kFilterBufSize = 64 * 1024;
+
+// Smallest buffer allocated when the size of the data is known.
+const int kMinFilterBufSize = 4 * 1024;
+
+// Sizes the buffers of a filter chain for the encoded content, so that small
+// responses don't each allocate a full window.
+int BufferSizeFor(const net::FilterContext& filter_context) {
+  int64 content_length = filter_context.GetContentLength();
+  if (content_length < 0 || content_length >= kFilterBufSize)
+    return kFilterBufSize;
+  return std::max(kMinFilterBufSize, static_cast<int>(content_length));
+}
 
 }  // namespace
 
 namespace net {
 
+namespace {
+
+struct RegisteredDecoder {
+  std::string encoding;
+  Filter::DecoderFactory factory;
+};
+
+// Indexed by filter type, less FILTER_TYPE_REGISTERED_FIRST.
+base::LazyInstance<std::vector<RegisteredDecoder> >::Leaky
+    g_registered_decoders = LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
 FilterContext::~FilterContext() {
 }
 
@@ -52,10 +81,11 @@ Filter* Filter::Factory(const std::vector<FilterType>& filter_types,
   if (filter_types.empty())
     return NULL;
 
+  int buffer_size = BufferSizeFor(filter_context);
   Filter* filter_list = NULL;  // Linked list of filters.
   for (size_t i = 0; i < filter_types.size(); i++) {
     filter_list = PrependNewFilter(filter_types[i], filter_context,
-                                   kFilterBufSize, filter_list);
+                                   buffer_size, filter_list);
     if (!filter_list)
       return NULL;
   }
@@ -67,6 +97,39 @@ Filter* Filter::GZipFactory() {
   return InitGZipFilter(FILTER_TYPE_GZIP, kFilterBufSize);
 }
 
+// static
+Filter::FilterType Filter::RegisterDecoder(const std::string& encoding,
+                                           DecoderFactory factory) {
+  DCHECK(factory);
+  DCHECK_EQ(FILTER_TYPE_UNSUPPORTED, ConvertEncodingToType(encoding));
+  std::vector<RegisteredDecoder>& decoders = g_registered_decoders.Get();
+  if (decoders.size() >
+      static_cast<size_t>(FILTER_TYPE_REGISTERED_LAST -
+                          FILTER_TYPE_REGISTERED_FIRST)) {
+    return FILTER_TYPE_UNSUPPORTED;
+  }
+  RegisteredDecoder decoder;
+  decoder.encoding = StringToLowerASCII(encoding);
+  decoder.factory = factory;
+  decoders.push_back(decoder);
+  return static_cast<FilterType>(FILTER_TYPE_REGISTERED_FIRST +
+                                 decoders.size() - 1);
+}
+
+// static
+void Filter::AppendRegisteredEncodings(std::string* accept_encoding) {
+  const std::vector<RegisteredDecoder>& decoders = g_registered_decoders.Get();
+  for (size_t i = 0; i < decoders.size(); ++i) {
+    accept_encoding->append(",");
+    accept_encoding->append(decoders[i].encoding);
+  }
+}
+
+// static
+void Filter::ClearRegisteredDecodersForTesting() {
+  g_registered_decoders.Get().clear();
+}
+
 // static
 Filter* Filter::FactoryForTests(const std::vector<FilterType>& filter_types,
                                 const FilterContext& filter_context,
@@ -152,6 +215,14 @@ Filter::FilterType Filter::ConvertEncodingToType(
     // Note we also consider "identity" and "uncompressed" UNSUPPORTED as
     // filter should be disabled in such cases.
     type_id = FILTER_TYPE_UNSUPPORTED;
+    const std::vector<RegisteredDecoder>& decoders =
+        g_registered_decoders.Get();
+    for (size_t i = 0; i < decoders.size(); ++i) {
+      if (LowerCaseEqualsASCII(filter_type, decoders[i].encoding.c_str())) {
+        type_id = static_cast<FilterType>(FILTER_TYPE_REGISTERED_FIRST + i);
+        break;
+      }
+    }
   }
   return type_id;
 }
@@ -362,6 +433,24 @@ Filter* Filter::InitSdchFilter(FilterType type_id,
   return sdch_filter->InitDecoding(type_id) ? sdch_filter.release() : NULL;
 }
 
+// static
+Filter* Filter::InitRegisteredFilter(FilterType type_id,
+                                     const FilterContext& filter_context,
+                                     int buffer_size) {
+  const std::vector<RegisteredDecoder>& decoders = g_registered_decoders.Get();
+  if (type_id < FILTER_TYPE_REGISTERED_FIRST ||
+      type_id > FILTER_TYPE_REGISTERED_LAST) {
+    return NULL;
+  }
+  size_t index = type_id - FILTER_TYPE_REGISTERED_FIRST;
+  if (index >= decoders.size())
+    return NULL;
+  Filter* filter = decoders[index].factory(filter_context);
+  if (filter)
+    filter->InitBuffer(buffer_size);
+  return filter;
+}
+
 // static
 Filter* Filter::PrependNewFilter(FilterType type_id,
                                  const FilterContext& filter_context,
@@ -379,6 +468,8 @@ Filter* Filter::PrependNewFilter(FilterType type_id,
       first_filter.reset(InitSdchFilter(type_id, filter_context, buffer_size));
       break;
     default:
+      first_filter.reset(InitRegisteredFilter(type_id, filter_context,
+                                              buffer_size));
       break;
   }
 
@@ -91,6 +91,10 @@ class NET_EXPORT_PRIVATE FilterContext {
   // pushed into a filter for processing)?
   virtual int64 GetByteReadCount() const = 0;
 
+  // How long is the encoded content, as announced by the server? Returns -1
+  // if the length is not known.
+  virtual int64 GetContentLength() const = 0;
+
   // What response code was received with the associated network transaction?
   // For example: 200 is ok.   4xx are error codes. etc.
   virtual int GetResponseCode() const = 0;
@@ -127,8 +131,15 @@ class NET_EXPORT_PRIVATE Filter {
     FILTER_TYPE_SDCH,
     FILTER_TYPE_SDCH_POSSIBLE,  // Sdch possible, but pass through allowed.
     FILTER_TYPE_UNSUPPORTED,
+    // Handed out by RegisterDecoder().
+    FILTER_TYPE_REGISTERED_FIRST,
+    FILTER_TYPE_REGISTERED_LAST = FILTER_TYPE_REGISTERED_FIRST + 3,
   };
 
+  // Creates a filter for a registered content encoding. Filter allocates its
+  // stream buffer.
+  typedef Filter* (*DecoderFactory)(const FilterContext& filter_context);
+
   virtual ~Filter();
 
   // Creates a Filter object.
@@ -154,6 +165,20 @@ class NET_EXPORT_PRIVATE Filter {
   // initialized.
   static Filter* GZipFactory();
 
+  // Makes Factory() decode the content encoding |encoding| with filters from
+  // |factory|, and has HTTP requests advertise it in Accept-Encoding. Returns
+  // the filter type that ConvertEncodingToType() maps |encoding| to, or
+  // FILTER_TYPE_UNSUPPORTED if no more decoders can be registered.
+  // Must be called before any request is made.
+  static FilterType RegisterDecoder(const std::string& encoding,
+                                    DecoderFactory factory);
+
+  // Appends ",<encoding>" to |accept_encoding| for each registered decoder.
+  static void AppendRegisteredEncodings(std::string* accept_encoding);
+
+  // Forgets the decoders registered with RegisterDecoder().
+  static void ClearRegisteredDecodersForTesting();
+
   // External call to obtain data from this filter chain.  If ther is no
   // next_filter_, then it obtains data from this specific filter.
   FilterStatus ReadData(char* dest_buffer, int* dest_len);
@@ -253,6 +278,9 @@ class NET_EXPORT_PRIVATE Filter {
   static Filter* InitSdchFilter(FilterType type_id,
                                 const FilterContext& filter_context,
                                 int buffer_size);
+  static Filter* InitRegisteredFilter(FilterType type_id,
+                                      const FilterContext& filter_context,
+                                      int buffer_size);
 
   // Helper function to empty our output into the next filter's input.
   void PushDataIntoNextFilter();
@@ -0,0 +1,108 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/filter.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#if defined(USE_SYSTEM_ZLIB)
+#include <zlib.h>
+#else
+#include "third_party/zlib/zlib.h"
+#endif
+
+#include "base/memory/scoped_ptr.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "net/base/io_buffer.h"
+#include "net/base/mock_filter_context.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// About the size of the script bundle of a large web application.
+const size_t kBundleSize = 4 * 1024 * 1024;
+
+// The size of the buffer URLRequest::Read() is typically given.
+const int kReadSize = 32 * 1024;
+
+// Returns |size| bytes of script-like text, which compresses as well as real
+// minified script does.
+std::string MakeBundle(size_t size) {
+  std::string bundle;
+  for (int i = 0; bundle.size() < size; ++i) {
+    bundle.append(base::StringPrintf(
+        "function f%d(a,b){var c=a.length;for(var i=0;i<c;++i)"
+        "b.push(a[i]*%d);return b}", i, i % 97));
+  }
+  bundle.resize(size);
+  return bundle;
+}
+
+// Compresses |input| with a gzip wrapper.
+std::string GZip(const std::string& input) {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  EXPECT_EQ(Z_OK, deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                               MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY));
+  std::vector<char> output(deflateBound(&stream, input.size()));
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+  stream.avail_in = input.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&output[0]);
+  stream.avail_out = output.size();
+  EXPECT_EQ(Z_STREAM_END, deflate(&stream, Z_FINISH));
+  size_t output_size = output.size() - stream.avail_out;
+  deflateEnd(&stream);
+  return std::string(&output[0], output_size);
+}
+
+// Runs |encoded| through |filter| the way URLRequestJob does, and returns
+// the number of decoded bytes.
+size_t Decode(Filter* filter, const std::string& encoded) {
+  std::vector<char> output(kReadSize);
+  size_t offset = 0;
+  size_t decoded = 0;
+  for (;;) {
+    if (!filter->stream_data_len() && offset < encoded.size()) {
+      int size = std::min(static_cast<size_t>(filter->stream_buffer_size()),
+                          encoded.size() - offset);
+      memcpy(filter->stream_buffer()->data(), encoded.data() + offset, size);
+      offset += size;
+      filter->FlushStreamBuffer(size);
+    }
+    int output_len = output.size();
+    Filter::FilterStatus status = filter->ReadData(&output[0], &output_len);
+    decoded += output_len;
+    if (status == Filter::FILTER_DONE || status == Filter::FILTER_ERROR)
+      break;
+    if (status == Filter::FILTER_NEED_MORE_DATA && offset == encoded.size())
+      break;
+  }
+  return decoded;
+}
+
+}  // namespace
+
+TEST(FilterPerfTest, GZipBundle) {
+  std::string bundle = MakeBundle(kBundleSize);
+  std::string encoded = GZip(bundle);
+
+  MockFilterContext filter_context;
+  std::vector<Filter::FilterType> encoding_types;
+  encoding_types.push_back(Filter::FILTER_TYPE_GZIP);
+  scoped_ptr<Filter> filter(Filter::Factory(encoding_types, filter_context));
+  ASSERT_TRUE(filter.get());
+
+  PerfTimeLogger timer("Filter_gzip_bundle");
+  EXPECT_EQ(bundle.size(), Decode(filter.get(), encoded));
+  timer.Done();
+}
+
+}  // namespace net
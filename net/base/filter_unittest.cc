@@ -3,6 +3,11 @@
 // found in the LICENSE file.
 
 #include "net/base/filter.h"
+
+#include <string.h>
+
+#include "base/memory/scoped_ptr.h"
+#include "net/base/io_buffer.h"
 #include "net/base/mock_filter_context.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -11,6 +16,23 @@ namespace net {
 class FilterTest : public testing::Test {
 };
 
+namespace {
+
+// A decoder for a made-up content encoding, which passes data through.
+class PassThroughFilter : public Filter {
+ public:
+  static Filter* Create(const FilterContext& filter_context) {
+    return new PassThroughFilter();
+  }
+
+  virtual FilterStatus ReadFilteredData(char* dest_buffer,
+                                        int* dest_len) OVERRIDE {
+    return CopyOut(dest_buffer, dest_len);
+  }
+};
+
+}  // namespace
+
 TEST(FilterTest, ContentTypeId) {
   // Check for basic translation of Content-Encoding, including case variations.
   EXPECT_EQ(Filter::FILTER_TYPE_DEFLATE,
@@ -347,4 +369,57 @@ TEST(FilterTest, SupportedMimeGzip) {
   EXPECT_TRUE(encoding_types.empty());
 }
 
+TEST(FilterTest, RegisteredDecoder) {
+  Filter::FilterType type =
+      Filter::RegisterDecoder("x-pass", &PassThroughFilter::Create);
+  ASSERT_NE(Filter::FILTER_TYPE_UNSUPPORTED, type);
+  EXPECT_EQ(type, Filter::ConvertEncodingToType("X-Pass"));
+
+  std::string accept_encoding("gzip");
+  Filter::AppendRegisteredEncodings(&accept_encoding);
+  EXPECT_EQ("gzip,x-pass", accept_encoding);
+
+  MockFilterContext filter_context;
+  std::vector<Filter::FilterType> encoding_types;
+  encoding_types.push_back(type);
+  scoped_ptr<Filter> filter(Filter::Factory(encoding_types, filter_context));
+  ASSERT_TRUE(filter.get());
+
+  const char kData[] = "hello";
+  memcpy(filter->stream_buffer()->data(), kData, sizeof(kData));
+  EXPECT_TRUE(filter->FlushStreamBuffer(sizeof(kData)));
+  char output[sizeof(kData)];
+  int output_len = sizeof(output);
+  EXPECT_EQ(Filter::FILTER_NEED_MORE_DATA,
+            filter->ReadData(output, &output_len));
+  EXPECT_EQ(static_cast<int>(sizeof(kData)), output_len);
+  EXPECT_EQ(0, memcmp(kData, output, sizeof(kData)));
+
+  Filter::ClearRegisteredDecodersForTesting();
+  EXPECT_EQ(Filter::FILTER_TYPE_UNSUPPORTED,
+            Filter::ConvertEncodingToType("x-pass"));
+}
+
+// Small responses don't get a full-sized buffer.
+TEST(FilterTest, BufferSizedForContent) {
+  MockFilterContext filter_context;
+  std::vector<Filter::FilterType> encoding_types;
+  encoding_types.push_back(Filter::FILTER_TYPE_GZIP);
+
+  scoped_ptr<Filter> filter(Filter::Factory(encoding_types, filter_context));
+  ASSERT_TRUE(filter.get());
+  int full_size = filter->stream_buffer_size();
+
+  filter_context.SetContentLength(100);
+  filter.reset(Filter::Factory(encoding_types, filter_context));
+  ASSERT_TRUE(filter.get());
+  EXPECT_LT(filter->stream_buffer_size(), full_size);
+  EXPECT_GE(filter->stream_buffer_size(), 100);
+
+  filter_context.SetContentLength(10 * 1024 * 1024);
+  filter.reset(Filter::Factory(encoding_types, filter_context));
+  ASSERT_TRUE(filter.get());
+  EXPECT_EQ(full_size, filter->stream_buffer_size());
+}
+
 }  // namespace net
@@ -5,10 +5,22 @@
 #include "net/base/host_cache.h"
 
 #include "base/logging.h"
+#include "base/string_number_conversions.h"
+#include "base/values.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
+#include "net/base/sys_addrinfo.h"
 
 namespace net {
 
+namespace {
+
+// Version of the format written by Serialize(). Lists of any other version
+// are ignored.
+const int kSerializationVersion = 1;
+
+}  // namespace
+
 //-----------------------------------------------------------------------------
 
 HostCache::Entry::Entry(int error, const AddressList& addrlist)
@@ -37,6 +49,18 @@ const HostCache::Entry* HostCache::Lookup(const Key& key,
   return entries_.Get(key, now);
 }
 
+const HostCache::Entry* HostCache::LookupStale(const Key& key,
+                                               base::TimeTicks now,
+                                               base::TimeDelta max_staleness,
+                                               bool* is_stale) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(is_stale);
+  if (caching_is_disabled())
+    return NULL;
+
+  return entries_.GetStale(key, now, max_staleness, is_stale);
+}
+
 void HostCache::Set(const Key& key,
                     int error,
                     const AddressList& addrlist,
@@ -54,6 +78,97 @@ void HostCache::clear() {
   entries_.Clear();
 }
 
+// Each entry is saved as a list of
+// [hostname, address family, flags, expiration, canonical name, addresses],
+// where the expiration is a string holding base::Time::ToInternalValue() and
+// the addresses are a list of IP literals.
+void HostCache::Serialize(base::TimeTicks now,
+                          base::ListValue* entry_list) const {
+  DCHECK(CalledOnValidThread());
+  entry_list->Clear();
+  entry_list->Append(new base::FundamentalValue(kSerializationVersion));
+  base::Time wall_now = base::Time::Now();
+  for (EntryMap::Iterator it(entries_); it.HasNext(); it.Advance()) {
+    const Entry& entry = it.value();
+    if (entry.error != OK || !entry.addrlist.head())
+      continue;
+
+    base::ListValue* addresses = new base::ListValue;
+    for (const struct addrinfo* ai = entry.addrlist.head(); ai;
+         ai = ai->ai_next) {
+      addresses->Append(new base::StringValue(NetAddressToString(ai)));
+    }
+    std::string canonical_name;
+    entry.addrlist.GetCanonicalName(&canonical_name);
+    base::Time expiration = wall_now + (it.expiration() - now);
+
+    base::ListValue* value = new base::ListValue;
+    value->Append(new base::StringValue(it.key().hostname));
+    value->Append(new base::FundamentalValue(it.key().address_family));
+    value->Append(new base::FundamentalValue(it.key().host_resolver_flags));
+    value->Append(new base::StringValue(
+        base::Int64ToString(expiration.ToInternalValue())));
+    value->Append(new base::StringValue(canonical_name));
+    value->Append(addresses);
+    entry_list->Append(value);
+  }
+}
+
+void HostCache::Deserialize(const base::ListValue& entry_list,
+                            base::TimeTicks now) {
+  DCHECK(CalledOnValidThread());
+  int version = -1;
+  if (caching_is_disabled() || !entry_list.GetInteger(0, &version) ||
+      version != kSerializationVersion) {
+    return;
+  }
+
+  base::Time wall_now = base::Time::Now();
+  for (size_t i = 1; i < entry_list.GetSize(); ++i) {
+    base::ListValue* value;
+    std::string hostname;
+    int address_family;
+    int flags;
+    std::string expiration_string;
+    int64 expiration;
+    std::string canonical_name;
+    base::ListValue* addresses;
+    if (!entry_list.GetList(i, &value) ||
+        !value->GetString(0, &hostname) ||
+        !value->GetInteger(1, &address_family) ||
+        !value->GetInteger(2, &flags) ||
+        !value->GetString(3, &expiration_string) ||
+        !base::StringToInt64(expiration_string, &expiration) ||
+        !value->GetString(4, &canonical_name) ||
+        !value->GetList(5, &addresses)) {
+      continue;
+    }
+
+    IPAddressList ip_addresses;
+    for (size_t j = 0; j < addresses->GetSize(); ++j) {
+      std::string literal;
+      IPAddressNumber ip_address;
+      if (addresses->GetString(j, &literal) &&
+          ParseIPLiteralToNumber(literal, &ip_address)) {
+        ip_addresses.push_back(ip_address);
+      }
+    }
+    if (ip_addresses.empty())
+      continue;
+
+    // What this session has resolved is more recent than the snapshot.
+    Key key(hostname, static_cast<AddressFamily>(address_family), flags);
+    if (entries_.Get(key, now))
+      continue;
+    base::TimeDelta ttl =
+        base::Time::FromInternalValue(expiration) - wall_now;
+    entries_.Put(key,
+                 Entry(OK, AddressList::CreateFromIPAddressList(
+                     ip_addresses, canonical_name)),
+                 now, ttl);
+  }
+}
+
 size_t HostCache::size() const {
   DCHECK(CalledOnValidThread());
   return entries_.size();
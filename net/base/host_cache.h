@@ -8,7 +8,9 @@
 
 #include <string>
 
+#include "base/flat_hash_map.h"
 #include "base/gtest_prod_util.h"
+#include "base/hash_tables.h"
 #include "base/threading/non_thread_safe.h"
 #include "base/time.h"
 #include "net/base/address_family.h"
@@ -16,6 +18,10 @@
 #include "net/base/expiring_cache.h"
 #include "net/base/net_export.h"
 
+namespace base {
+class ListValue;
+}
+
 namespace net {
 
 // Cache used by HostResolver to map hostnames to their resolved result.
@@ -49,12 +55,32 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
       return hostname < other.hostname;
     }
 
+    bool operator==(const Key& other) const {
+      return address_family == other.address_family &&
+             host_resolver_flags == other.host_resolver_flags &&
+             hostname == other.hostname;
+    }
+
     std::string hostname;
     AddressFamily address_family;
     HostResolverFlags host_resolver_flags;
   };
 
-  typedef ExpiringCache<Key, Entry> EntryMap;
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      BASE_HASH_NAMESPACE::hash<std::string> string_hash;
+      return string_hash(key.hostname) * 31 +
+             static_cast<size_t>(key.address_family) * 7 +
+             static_cast<size_t>(key.host_resolver_flags);
+    }
+  };
+
+  // Lookups happen on every resolve, so the entries are kept in a flat hash
+  // table rather than a tree of string comparisons.
+  typedef ExpiringCache<Key, Entry,
+                        base::flat_hash_map<Key,
+                                            std::pair<Entry, base::TimeTicks>,
+                                            KeyHash> > EntryMap;
 
   // Constructs a HostCache that stores up to |max_entries|.
   explicit HostCache(size_t max_entries);
@@ -65,6 +91,13 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // |now|. If there is no such entry, returns NULL.
   const Entry* Lookup(const Key& key, base::TimeTicks now);
 
+  // Like Lookup(), but also returns an entry that expired less than
+  // |max_staleness| before |now|, in which case |*is_stale| is set to true.
+  const Entry* LookupStale(const Key& key,
+                           base::TimeTicks now,
+                           base::TimeDelta max_staleness,
+                           bool* is_stale);
+
   // Overwrites or creates an entry for |key|.
   // (|error|, |addrlist|) is the value to set, |now| is the current time
   // |ttl| is the "time to live".
@@ -77,6 +110,16 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // Empties the cache
   void clear();
 
+  // Writes the successful resolutions in the cache to |entry_list|, so that
+  // a later session can start with them. Expiration times are saved as wall
+  // clock times, as TimeTicks do not survive a restart.
+  void Serialize(base::TimeTicks now, base::ListValue* entry_list) const;
+
+  // Adds the entries saved by Serialize() that the cache does not already
+  // have. Entries that have since expired are added as expired, so that
+  // they can only be served by LookupStale().
+  void Deserialize(const base::ListValue& entry_list, base::TimeTicks now);
+
   // Returns the number of entries in the cache.
   size_t size() const;
 
@@ -8,7 +8,10 @@
 #include "base/stl_util.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
+#include "base/values.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
+#include "net/base/sys_addrinfo.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace net {
@@ -22,6 +25,13 @@ HostCache::Key Key(const std::string& hostname) {
   return HostCache::Key(hostname, ADDRESS_FAMILY_UNSPECIFIED, 0);
 }
 
+// Builds an address list holding the IP literal |address|.
+AddressList Addresses(const std::string& address) {
+  IPAddressNumber ip_number;
+  EXPECT_TRUE(ParseIPLiteralToNumber(address, &ip_number));
+  return AddressList::CreateFromIPAddress(ip_number, 0);
+}
+
 }  // namespace
 
 TEST(HostCacheTest, Basic) {
@@ -287,6 +297,75 @@ TEST(HostCacheTest, Clear) {
   EXPECT_EQ(0u, cache.size());
 }
 
+TEST(HostCacheTest, LookupStale) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+  const base::TimeDelta kMaxStaleness = base::TimeDelta::FromSeconds(5);
+
+  HostCache cache(kMaxCacheEntries);
+  base::TimeTicks now;
+  cache.Set(Key("foobar.com"), OK, AddressList(), now, kTTL);
+
+  bool is_stale = true;
+  EXPECT_TRUE(cache.LookupStale(Key("foobar.com"), now, kMaxStaleness,
+                                &is_stale));
+  EXPECT_FALSE(is_stale);
+
+  // At t=12 the entry has expired, but is within |kMaxStaleness|.
+  now += base::TimeDelta::FromSeconds(12);
+  EXPECT_TRUE(cache.LookupStale(Key("foobar.com"), now, kMaxStaleness,
+                                &is_stale));
+  EXPECT_TRUE(is_stale);
+  EXPECT_EQ(1u, cache.size());
+
+  // At t=15 it is too stale, and is removed.
+  now += base::TimeDelta::FromSeconds(3);
+  EXPECT_FALSE(cache.LookupStale(Key("foobar.com"), now, kMaxStaleness,
+                                 &is_stale));
+  EXPECT_EQ(0u, cache.size());
+}
+
+TEST(HostCacheTest, SerializeAndDeserialize) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  HostCache cache(kMaxCacheEntries);
+  base::TimeTicks now;
+  cache.Set(Key("foobar.com"), OK, Addresses("10.0.0.1"), now, kTTL);
+  cache.Set(Key("foobar2.com"), OK, Addresses("::1"), now,
+            base::TimeDelta());
+  // Failures are not saved.
+  cache.Set(Key("foobar3.com"), ERR_NAME_NOT_RESOLVED, AddressList(), now,
+            kTTL);
+
+  base::ListValue entry_list;
+  cache.Serialize(now, &entry_list);
+  // The version, then two entries.
+  EXPECT_EQ(3u, entry_list.GetSize());
+
+  HostCache restored_cache(kMaxCacheEntries);
+  // An entry restored from the list doesn't replace one the cache has.
+  restored_cache.Set(Key("foobar2.com"), OK, Addresses("10.0.0.2"), now, kTTL);
+  restored_cache.Deserialize(entry_list, now);
+  EXPECT_EQ(2u, restored_cache.size());
+
+  const HostCache::Entry* entry = restored_cache.Lookup(Key("foobar.com"), now);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(OK, entry->error);
+  EXPECT_EQ("10.0.0.1", NetAddressToString(entry->addrlist.head()));
+  entry = restored_cache.Lookup(Key("foobar2.com"), now);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ("10.0.0.2", NetAddressToString(entry->addrlist.head()));
+
+  // Entries keep their expiration times.
+  now += kTTL;
+  EXPECT_FALSE(restored_cache.Lookup(Key("foobar.com"), now));
+
+  // A list of another version is ignored.
+  entry_list.Set(0, new base::FundamentalValue(0));
+  HostCache other_cache(kMaxCacheEntries);
+  other_cache.Deserialize(entry_list, now);
+  EXPECT_EQ(0u, other_cache.size());
+}
+
 // Tests the less than and equal operators for HostCache::Key work.
 TEST(HostCacheTest, KeyComparators) {
   struct {
@@ -25,6 +25,9 @@ AddressFamily HostResolver::GetDefaultAddressFamily() const {
 void HostResolver::ProbeIPv6Support() {
 }
 
+void HostResolver::SetMaxCacheStaleness(base::TimeDelta max_staleness) {
+}
+
 HostCache* HostResolver::GetHostCache() {
   return NULL;
 }
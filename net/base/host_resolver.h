@@ -9,6 +9,7 @@
 #include <string>
 
 #include "base/memory/scoped_ptr.h"
+#include "base/time.h"
 #include "net/base/address_family.h"
 #include "net/base/completion_callback.h"
 #include "net/base/host_port_pair.h"
@@ -161,6 +162,11 @@ class NET_EXPORT HostResolver {
   // address family to IPv4 iff IPv6 is not supported.
   virtual void ProbeIPv6Support();
 
+  // Allows a cached address list that expired less than |max_staleness| ago
+  // to be returned right away while it is refreshed in the background. Zero,
+  // the default, disables this. Negative results are never served stale.
+  virtual void SetMaxCacheStaleness(base::TimeDelta max_staleness);
+
   // Returns the HostResolverCache |this| uses, or NULL if there isn't one.
   // Used primarily to clear the cache and for getting debug information.
   virtual HostCache* GetHostCache();
@@ -10,6 +10,7 @@
 #include <netdb.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
 #include <utility>
 #include <vector>
@@ -1055,27 +1056,41 @@ class HostResolverImpl::DnsTask {
           const Key& key,
           const Callback& callback,
           const BoundNetLog& job_net_log)
-      : callback_(callback), net_log_(job_net_log) {
+      : callback_(callback),
+        net_log_(job_net_log),
+        num_pending_(0),
+        has_a_result_(false),
+        has_aaaa_result_(false),
+        net_error_(OK),
+        result_(DnsResponse::DNS_SUCCESS) {
     DCHECK(factory);
     DCHECK(!callback.is_null());
 
-    // For now we treat ADDRESS_FAMILY_UNSPEC as if it was IPV4.
-    uint16 qtype = (key.address_family == ADDRESS_FAMILY_IPV6)
-                   ? dns_protocol::kTypeAAAA
-                   : dns_protocol::kTypeA;
-    // TODO(szym): Implement "happy eyeballs".
-    transaction_ = factory->CreateTransaction(
-        key.hostname,
-        qtype,
-        base::Bind(&DnsTask::OnTransactionComplete, base::Unretained(this),
-                   base::TimeTicks::Now()),
-        net_log_);
-    DCHECK(transaction_.get());
+    // ADDRESS_FAMILY_UNSPECIFIED sends the A and AAAA queries in parallel
+    // rather than one after the other, and succeeds if either does.
+    if (key.address_family != ADDRESS_FAMILY_IPV4) {
+      transaction_aaaa_ = CreateTransaction(factory, key.hostname,
+                                            dns_protocol::kTypeAAAA);
+    }
+    if (key.address_family != ADDRESS_FAMILY_IPV6) {
+      transaction_a_ = CreateTransaction(factory, key.hostname,
+                                         dns_protocol::kTypeA);
+    }
   }
 
   int Start() {
     net_log_.BeginEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_DNS_TASK, NULL);
-    return transaction_->Start();
+    int rv = StartTransaction(transaction_aaaa_.get());
+    if (rv == ERR_IO_PENDING)
+      rv = StartTransaction(transaction_a_.get());
+    if (rv != ERR_IO_PENDING) {
+      // Give up on both, so that the Job falls back to ProcTask.
+      transaction_aaaa_.reset();
+      transaction_a_.reset();
+      net_log_.EndEventWithNetErrorCode(
+          NetLog::TYPE_HOST_RESOLVER_IMPL_DNS_TASK, rv);
+    }
+    return rv;
   }
 
   void OnTransactionComplete(const base::TimeTicks& start_time,
@@ -1083,7 +1098,9 @@ class HostResolverImpl::DnsTask {
                              int net_error,
                              const DnsResponse* response) {
     DCHECK(transaction);
-    // Run |callback_| last since the owning Job will then delete this DnsTask.
+    DCHECK_GT(num_pending_, 0);
+    --num_pending_;
+
     DnsResponse::Result result = DnsResponse::DNS_SUCCESS;
     if (net_error == OK) {
       CHECK(response);
@@ -1096,28 +1113,95 @@ class HostResolverImpl::DnsTask {
                                 result,
                                 DnsResponse::DNS_PARSE_RESULT_MAX);
       if (result == DnsResponse::DNS_SUCCESS) {
-        net_log_.EndEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_DNS_TASK,
-                          new AddressListNetLogParam(addr_list));
-        callback_.Run(net_error, addr_list, ttl);
-        return;
+        if (!has_a_result_ && !has_aaaa_result_)
+          ttl_ = ttl;
+        else
+          ttl_ = std::min(ttl_, ttl);
+        if (transaction == transaction_aaaa_.get()) {
+          aaaa_addr_list_ = addr_list;
+          has_aaaa_result_ = true;
+        } else {
+          a_addr_list_ = addr_list;
+          has_a_result_ = true;
+        }
+      } else {
+        net_error = ERR_DNS_MALFORMED_RESPONSE;
       }
-      net_error = ERR_DNS_MALFORMED_RESPONSE;
     } else {
       DNS_HISTOGRAM("AsyncDNS.TransactionFailure",
                     base::TimeTicks::Now() - start_time);
     }
+    if (net_error != OK && net_error_ == OK) {
+      net_error_ = net_error;
+      result_ = result;
+    }
+
+    if (num_pending_ > 0)
+      return;
+
+    // Run |callback_| last since the owning Job will then delete this DnsTask.
+    if (!has_a_result_ && !has_aaaa_result_) {
+      net_log_.EndEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_DNS_TASK,
+                        new DnsTaskFailedParams(net_error_, result_));
+      callback_.Run(net_error_, AddressList(), base::TimeDelta());
+      return;
+    }
+
+    // IPv6 goes first, as getaddrinfo would order it. TransportConnectJob
+    // races a connect to the IPv4 addresses against it.
+    AddressList addr_list = has_aaaa_result_ ? aaaa_addr_list_ : a_addr_list_;
+    if (has_aaaa_result_ && has_a_result_)
+      addr_list.Append(a_addr_list_.head());
     net_log_.EndEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_DNS_TASK,
-                      new DnsTaskFailedParams(net_error, result));
-    callback_.Run(net_error, AddressList(), base::TimeDelta());
+                      new AddressListNetLogParam(addr_list));
+    callback_.Run(OK, addr_list, ttl_);
   }
 
  private:
+  scoped_ptr<DnsTransaction> CreateTransaction(DnsTransactionFactory* factory,
+                                               const std::string& hostname,
+                                               uint16 qtype) {
+    scoped_ptr<DnsTransaction> transaction = factory->CreateTransaction(
+        hostname,
+        qtype,
+        base::Bind(&DnsTask::OnTransactionComplete, base::Unretained(this),
+                   base::TimeTicks::Now()),
+        net_log_);
+    DCHECK(transaction.get());
+    return transaction.Pass();
+  }
+
+  // Returns ERR_IO_PENDING if there is no |transaction| to start.
+  int StartTransaction(DnsTransaction* transaction) {
+    if (!transaction)
+      return ERR_IO_PENDING;
+    ++num_pending_;
+    return transaction->Start();
+  }
+
   // The listener to the results of this DnsTask.
   Callback callback_;
 
   const BoundNetLog net_log_;
 
-  scoped_ptr<DnsTransaction> transaction_;
+  scoped_ptr<DnsTransaction> transaction_a_;
+  scoped_ptr<DnsTransaction> transaction_aaaa_;
+
+  // The number of transactions that have not completed yet.
+  int num_pending_;
+
+  // The results of the transactions that succeeded.
+  bool has_a_result_;
+  bool has_aaaa_result_;
+  AddressList a_addr_list_;
+  AddressList aaaa_addr_list_;
+  base::TimeDelta ttl_;
+
+  // The first failure, reported if neither transaction succeeds.
+  int net_error_;
+  DnsResponse::Result result_;
+
+  DISALLOW_COPY_AND_ASSIGN(DnsTask);
 };
 
 //-----------------------------------------------------------------------------
@@ -1134,6 +1218,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
         key_(key),
         had_non_speculative_request_(false),
         had_dns_config_(false),
+        is_refresh_(false),
         net_log_(BoundNetLog::Make(request_net_log.net_log(),
                                    NetLog::SOURCE_HOST_RESOLVER_IMPL_JOB)) {
     request_net_log.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_CREATE_JOB, NULL);
@@ -1181,6 +1266,13 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
     handle_ = resolver_->dispatcher_.Add(this, priority);
   }
 
+  // Adds this job to the dispatcher to refresh a stale cache entry. Such a
+  // job runs to completion, and caches a success, even without Requests.
+  void ScheduleRefresh() {
+    is_refresh_ = true;
+    Schedule(IDLE);
+  }
+
   void AddRequest(scoped_ptr<Request> req) {
     DCHECK_EQ(key_.hostname, req->info().hostname());
 
@@ -1227,7 +1319,7 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
         make_scoped_refptr(new JobAttachParameters(
             req->request_net_log().source(), priority())));
 
-    if (num_active_requests() > 0) {
+    if (num_active_requests() > 0 || is_refresh_) {
       if (is_queued())
         handle_ = resolver_->dispatcher_.ChangePriority(handle_, priority());
     } else {
@@ -1263,6 +1355,10 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
   // Attempts to serve the job from HOSTS. Returns true if succeeded and
   // this Job was destroyed.
   bool ServeFromHosts() {
+    // A refresh without Requests has no port to serve; once HOSTS has the
+    // name, later Requests will be served from it directly.
+    if (is_refresh_ && num_active_requests() == 0)
+      return false;
     DCHECK_GT(num_active_requests(), 0u);
     AddressList addr_list;
     if (resolver_->ServeFromHosts(key(),
@@ -1416,6 +1512,16 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
     }
 
     if (num_active_requests() == 0) {
+      if (is_refresh_ && net_error != ERR_ABORTED &&
+          net_error != ERR_HOST_RESOLVER_QUEUE_TOO_LARGE) {
+        // Keep serving the stale entry if the refresh failed; it ages out of
+        // the cache on its own.
+        if (net_error == OK)
+          resolver_->CacheResult(key_, net_error, list, ttl);
+        net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
+                                          net_error);
+        return;
+      }
       net_log_.AddEvent(NetLog::TYPE_CANCELLED, NULL);
       net_log_.EndEventWithNetErrorCode(NetLog::TYPE_HOST_RESOLVER_IMPL_JOB,
                                         OK);
@@ -1488,6 +1594,9 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job {
   // True if resolver had DnsConfig when the Job was started.
   bool had_dns_config_;
 
+  // True if this Job was started by ScheduleRefresh().
+  bool is_refresh_;
+
   BoundNetLog net_log_;
 
   // Resolves the host using a HostResolverProc.
@@ -1582,6 +1691,11 @@ void HostResolverImpl::SetMaxQueuedJobs(size_t value) {
   max_queued_jobs_ = value;
 }
 
+void HostResolverImpl::SetMaxCacheStaleness(base::TimeDelta max_staleness) {
+  DCHECK(CalledOnValidThread());
+  max_cache_staleness_ = max_staleness;
+}
+
 int HostResolverImpl::Resolve(const RequestInfo& info,
                               AddressList* addresses,
                               const CompletionCallback& callback,
@@ -1660,8 +1774,11 @@ int HostResolverImpl::ResolveHelper(const Key& key,
   int net_error = ERR_UNEXPECTED;
   if (ResolveAsIP(key, info, &net_error, addresses))
     return net_error;
-  if (ServeFromCache(key, info, &net_error, addresses)) {
+  bool is_stale = false;
+  if (ServeFromCache(key, info, &net_error, addresses, &is_stale)) {
     request_net_log.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_CACHE_HIT, NULL);
+    if (is_stale)
+      RefreshInBackground(key, request_net_log);
     return net_error;
   }
   // TODO(szym): Do not do this if nsswitch.conf instructs not to.
@@ -1768,14 +1885,23 @@ bool HostResolverImpl::ResolveAsIP(const Key& key,
 bool HostResolverImpl::ServeFromCache(const Key& key,
                                       const RequestInfo& info,
                                       int* net_error,
-                                      AddressList* addresses) {
+                                      AddressList* addresses,
+                                      bool* is_stale) {
   DCHECK(addresses);
   DCHECK(net_error);
+  DCHECK(is_stale);
   if (!info.allow_cached_response() || !cache_.get())
     return false;
 
-  const HostCache::Entry* cache_entry = cache_->Lookup(
-      key, base::TimeTicks::Now());
+  const HostCache::Entry* cache_entry = NULL;
+  if (max_cache_staleness_ > base::TimeDelta()) {
+    cache_entry = cache_->LookupStale(key, base::TimeTicks::Now(),
+                                      max_cache_staleness_, is_stale);
+    if (cache_entry && *is_stale && cache_entry->error != OK)
+      return false;
+  } else {
+    cache_entry = cache_->Lookup(key, base::TimeTicks::Now());
+  }
   if (!cache_entry)
     return false;
 
@@ -1818,6 +1944,25 @@ bool HostResolverImpl::ServeFromHosts(const Key& key,
   return true;
 }
 
+void HostResolverImpl::RefreshInBackground(
+    const Key& key,
+    const BoundNetLog& request_net_log) {
+  JobMap::iterator jobit = jobs_.find(key);
+  if (jobit != jobs_.end())
+    return;
+
+  Job* job = new Job(this, key, request_net_log);
+  job->ScheduleRefresh();
+  if (dispatcher_.num_queued_jobs() > max_queued_jobs_) {
+    Job* evicted = static_cast<Job*>(dispatcher_.EvictOldestLowest());
+    DCHECK(evicted);
+    evicted->OnEvicted();  // Deletes |evicted|.
+    if (evicted == job)
+      return;
+  }
+  jobs_.insert(jobit, std::make_pair(key, job));
+}
+
 void HostResolverImpl::CacheResult(const Key& key,
                                    int net_error,
                                    const AddressList& addr_list,
@@ -142,6 +142,7 @@ class NET_EXPORT HostResolverImpl
   virtual void SetDefaultAddressFamily(AddressFamily address_family) OVERRIDE;
   virtual AddressFamily GetDefaultAddressFamily() const OVERRIDE;
   virtual void ProbeIPv6Support() OVERRIDE;
+  virtual void SetMaxCacheStaleness(base::TimeDelta max_staleness) OVERRIDE;
   virtual HostCache* GetHostCache() OVERRIDE;
   virtual base::Value* GetDnsConfigAsValue() const OVERRIDE;
 
@@ -178,11 +179,17 @@ class NET_EXPORT HostResolverImpl
 
   // If |key| is not found in cache returns false, otherwise returns
   // true, sets |net_error| to the cached error code and fills |addresses|
-  // if it is a positive entry.
+  // if it is a positive entry. |is_stale| is set if the entry has expired
+  // but is within |max_cache_staleness_|.
   bool ServeFromCache(const Key& key,
                       const RequestInfo& info,
                       int* net_error,
-                      AddressList* addresses);
+                      AddressList* addresses,
+                      bool* is_stale);
+
+  // Starts a low-priority Job for |key|, which has no Requests but updates
+  // the cache when it completes, unless a Job for |key| already exists.
+  void RefreshInBackground(const Key& key, const BoundNetLog& request_net_log);
 
   // If |key| is not found in the HOSTS file or no HOSTS file known, returns
   // false, otherwise returns true and fills |addresses|.
@@ -246,6 +253,10 @@ class NET_EXPORT HostResolverImpl
   // Limit on the maximum number of jobs queued in |dispatcher_|.
   size_t max_queued_jobs_;
 
+  // How long after expiring a cache entry may still be served. See
+  // SetMaxCacheStaleness().
+  base::TimeDelta max_cache_staleness_;
+
   // Parameters for ProcTask.
   ProcTaskParams proc_params_;
 
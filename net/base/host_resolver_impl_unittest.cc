@@ -541,6 +541,19 @@ class HostResolverImplTest : public testing::Test {
     resolver_->set_dns_client_for_tests(client.Pass());
   }
 
+  // Caches |address| for |hostname| as an entry that expired a minute ago.
+  void AddExpiredCacheEntry(const std::string& hostname,
+                            const std::string& address) {
+    HostResolver::RequestInfo info(HostPortPair(hostname, kDefaultPort));
+    IPAddressNumber ip_number;
+    ASSERT_TRUE(ParseIPLiteralToNumber(address, &ip_number));
+    resolver_->GetHostCache()->Set(
+        resolver_->GetEffectiveKeyForRequest(info), OK,
+        AddressList::CreateFromIPAddress(ip_number, 0),
+        base::TimeTicks::Now() - base::TimeDelta::FromMinutes(2),
+        base::TimeDelta::FromMinutes(1));
+  }
+
   scoped_refptr<MockHostResolverProc> proc_;
   scoped_ptr<HostResolverImpl> resolver_;
   ScopedVector<Request> requests_;
@@ -1208,6 +1221,44 @@ TEST_F(HostResolverImplTest, ResolveFromCache) {
   EXPECT_TRUE(requests_[2]->HasOneAddress("192.168.1.42", 80));
 }
 
+// Test that an expired cache entry is served, and refreshed in the background,
+// only when stale entries are allowed.
+TEST_F(HostResolverImplTest, StaleWhileRevalidate) {
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.42");
+  AddExpiredCacheEntry("just.testing", "192.168.1.1");
+
+  // By default, the expired entry is not used.
+  EXPECT_EQ(ERR_DNS_CACHE_MISS, CreateRequest("just.testing")->
+      ResolveFromCache());
+
+  resolver_->SetMaxCacheStaleness(base::TimeDelta::FromHours(1));
+  AddExpiredCacheEntry("just.testing", "192.168.1.1");
+  Request* req = CreateRequest("just.testing");
+  EXPECT_EQ(OK, req->Resolve());
+  EXPECT_TRUE(req->HasOneAddress("192.168.1.1", kDefaultPort));
+
+  // The refresh has started; later requests still get the stale entry.
+  EXPECT_TRUE(proc_->WaitFor(1u));
+  req = CreateRequest("just.testing");
+  EXPECT_EQ(OK, req->Resolve());
+  EXPECT_TRUE(req->HasOneAddress("192.168.1.1", kDefaultPort));
+
+  // A request that bypasses the cache joins the refresh.
+  HostResolver::RequestInfo info(HostPortPair("just.testing", kDefaultPort));
+  info.set_allow_cached_response(false);
+  req = CreateRequest(info);
+  EXPECT_EQ(ERR_IO_PENDING, req->Resolve());
+  proc_->SignalMultiple(1u);
+  EXPECT_EQ(OK, req->WaitForResult());
+  EXPECT_TRUE(req->HasOneAddress("192.168.1.42", kDefaultPort));
+
+  // The cache now has the fresh result.
+  req = CreateRequest("just.testing");
+  EXPECT_EQ(OK, req->Resolve());
+  EXPECT_TRUE(req->HasOneAddress("192.168.1.42", kDefaultPort));
+  EXPECT_EQ(1u, proc_->GetCaptureList().size());
+}
+
 // Test the retry attempts simulating host resolver proc that takes too long.
 TEST_F(HostResolverImplTest, MultipleAttempts) {
   // Total number of attempts would be 3 and we want the 3rd attempt to resolve
@@ -1293,8 +1344,10 @@ TEST_F(HostResolverImplTest, DnsTask) {
   }
 
   EXPECT_EQ(OK, requests_[1]->result());
-  // Resolved by MockDnsClient.
-  EXPECT_TRUE(requests_[1]->HasOneAddress("127.0.0.1", 80));
+  // Resolved by MockDnsClient, which answers both the A and AAAA queries.
+  EXPECT_EQ(2u, requests_[1]->NumberOfAddresses());
+  EXPECT_TRUE(requests_[1]->HasAddress("127.0.0.1", 80));
+  EXPECT_TRUE(requests_[1]->HasAddress("::1", 80));
   EXPECT_EQ(ERR_NAME_NOT_RESOLVED, requests_[2]->result());
   EXPECT_EQ(ERR_NAME_NOT_RESOLVED, requests_[3]->result());
   EXPECT_EQ(OK, requests_[4]->result());
@@ -1303,6 +1356,23 @@ TEST_F(HostResolverImplTest, DnsTask) {
   EXPECT_TRUE(requests_[5]->HasOneAddress("192.168.1.102", 80));
 }
 
+// Test that DnsTask only queries the requested address family.
+TEST_F(HostResolverImplTest, DnsTaskAddressFamily) {
+  set_dns_client(CreateMockDnsClient(CreateValidDnsConfig()));
+
+  Request* req_ipv4 = CreateRequest("ok_ipv4", 80, MEDIUM,
+                                    ADDRESS_FAMILY_IPV4);
+  Request* req_ipv6 = CreateRequest("ok_ipv6", 80, MEDIUM,
+                                    ADDRESS_FAMILY_IPV6);
+  EXPECT_EQ(ERR_IO_PENDING, req_ipv4->Resolve());
+  EXPECT_EQ(ERR_IO_PENDING, req_ipv6->Resolve());
+
+  EXPECT_EQ(OK, req_ipv4->WaitForResult());
+  EXPECT_TRUE(req_ipv4->HasOneAddress("127.0.0.1", 80));
+  EXPECT_EQ(OK, req_ipv6->WaitForResult());
+  EXPECT_TRUE(req_ipv6->HasOneAddress("::1", 80));
+}
+
 TEST_F(HostResolverImplTest, ServeFromHosts) {
   // Initially, there's DnsConfigService, but no DnsConfig.
   MockDnsConfigService* config_service = new MockDnsConfigService();
@@ -0,0 +1,131 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/io_buffer_pool.h"
+
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+
+namespace net {
+
+namespace {
+
+// Enough for a few dozen sockets' worth of reads and writes in flight.
+const size_t kDefaultMaxCachedBytes = 1024 * 1024;
+
+// Holds the reference that keeps the default pool alive.
+struct DefaultPool {
+  DefaultPool() : pool(new IOBufferPool(kDefaultMaxCachedBytes)) {}
+  scoped_refptr<IOBufferPool> pool;
+};
+
+base::LazyInstance<DefaultPool>::Leaky g_default_pool =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+// An IOBufferWithSize whose memory goes back to the pool.
+class IOBufferPool::PooledBuffer : public IOBufferWithSize {
+ public:
+  PooledBuffer(IOBufferPool* pool, int size_class, char* data, int size)
+      : IOBufferWithSize(data, size),
+        pool_(pool),
+        size_class_(size_class) {
+  }
+
+ private:
+  virtual ~PooledBuffer() {
+    pool_->ReturnToPool(size_class_, data_);
+    // The memory is the pool's now; don't let ~IOBuffer() delete it.
+    data_ = NULL;
+  }
+
+  scoped_refptr<IOBufferPool> pool_;
+  const int size_class_;
+
+  DISALLOW_COPY_AND_ASSIGN(PooledBuffer);
+};
+
+IOBufferPool::IOBufferPool(size_t max_cached_bytes)
+    : max_cached_bytes_(max_cached_bytes),
+      cached_bytes_(0) {
+}
+
+IOBufferPool::~IOBufferPool() {
+  Trim();
+}
+
+IOBufferWithSize* IOBufferPool::GetBuffer(int size) {
+  DCHECK_GT(size, 0);
+  if (size > kMaxBufferSize)
+    return new IOBufferWithSize(size);
+
+  int size_class = SizeClassOf(size);
+  char* data = NULL;
+  {
+    base::AutoLock lock(lock_);
+    std::vector<char*>& free_list = free_lists_[size_class];
+    if (!free_list.empty()) {
+      data = free_list.back();
+      free_list.pop_back();
+      cached_bytes_ -= SizeOfClass(size_class);
+    }
+  }
+  if (!data)
+    data = new char[SizeOfClass(size_class)];
+  return new PooledBuffer(this, size_class, data, size);
+}
+
+void IOBufferPool::Trim() {
+  std::vector<char*> to_free[kNumSizeClasses];
+  {
+    base::AutoLock lock(lock_);
+    for (int i = 0; i < kNumSizeClasses; ++i)
+      to_free[i].swap(free_lists_[i]);
+    cached_bytes_ = 0;
+  }
+  for (int i = 0; i < kNumSizeClasses; ++i) {
+    for (size_t j = 0; j < to_free[i].size(); ++j)
+      delete[] to_free[i][j];
+  }
+}
+
+size_t IOBufferPool::cached_bytes() const {
+  base::AutoLock lock(lock_);
+  return cached_bytes_;
+}
+
+// static
+IOBufferPool* IOBufferPool::GetDefault() {
+  return g_default_pool.Get().pool.get();
+}
+
+// static
+int IOBufferPool::SizeClassOf(int size) {
+  int size_class = 0;
+  while (SizeOfClass(size_class) < size)
+    ++size_class;
+  DCHECK_LT(size_class, kNumSizeClasses);
+  return size_class;
+}
+
+// static
+int IOBufferPool::SizeOfClass(int size_class) {
+  return kMinBufferSize << size_class;
+}
+
+void IOBufferPool::ReturnToPool(int size_class, char* data) {
+  size_t size = SizeOfClass(size_class);
+  {
+    base::AutoLock lock(lock_);
+    if (cached_bytes_ + size <= max_cached_bytes_) {
+      free_lists_[size_class].push_back(data);
+      cached_bytes_ += size;
+      return;
+    }
+  }
+  delete[] data;
+}
+
+}  // namespace net
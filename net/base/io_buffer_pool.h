@@ -0,0 +1,83 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_BASE_IO_BUFFER_POOL_H_
+#define NET_BASE_IO_BUFFER_POOL_H_
+#pragma once
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_export.h"
+
+namespace net {
+
+// Hands out IOBuffers whose memory is recycled rather than freed.
+//
+// The socket layers allocate a buffer for every read and write and drop it
+// as soon as the operation completes, which at high request rates is a
+// steady stream of 4-32KB mallocs and frees. A pool rounds each request up
+// to a power-of-two size class and keeps the memory of released buffers on
+// a free list for that class, up to a limit, so that in the steady state no
+// buffer touches the heap.
+//
+// Buffers may be released on any thread, so the free lists are guarded by
+// a lock. Each buffer keeps a reference to its pool, so the pool outlives
+// every buffer it has handed out.
+class NET_EXPORT IOBufferPool
+    : public base::RefCountedThreadSafe<IOBufferPool> {
+ public:
+  enum {
+    kMinBufferSize = 1 << 12,
+    kMaxBufferSize = 1 << 16,
+  };
+
+  // Keeps at most |max_cached_bytes| of released memory.
+  explicit IOBufferPool(size_t max_cached_bytes);
+
+  // Returns a buffer of |size| bytes. Sizes above kMaxBufferSize get an
+  // ordinary, unpooled buffer.
+  IOBufferWithSize* GetBuffer(int size);
+
+  // Frees the memory of released buffers.
+  void Trim();
+
+  // Returns the number of bytes on the free lists.
+  size_t cached_bytes() const;
+
+  // The pool the network stack shares. Never destroyed.
+  static IOBufferPool* GetDefault();
+
+ private:
+  friend class base::RefCountedThreadSafe<IOBufferPool>;
+  class PooledBuffer;
+
+  enum {
+    kNumSizeClasses = 5,  // 4K, 8K, 16K, 32K, 64K.
+  };
+
+  ~IOBufferPool();
+
+  // Returns the index of the smallest class that can hold |size| bytes.
+  static int SizeClassOf(int size);
+  static int SizeOfClass(int size_class);
+
+  // Called by PooledBuffer when it is destroyed.
+  void ReturnToPool(int size_class, char* data);
+
+  const size_t max_cached_bytes_;
+
+  mutable base::Lock lock_;
+  std::vector<char*> free_lists_[kNumSizeClasses];
+  size_t cached_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(IOBufferPool);
+};
+
+}  // namespace net
+
+#endif  // NET_BASE_IO_BUFFER_POOL_H_
@@ -0,0 +1,73 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/io_buffer_pool.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+TEST(IOBufferPoolTest, ReusesMemory) {
+  scoped_refptr<IOBufferPool> pool(new IOBufferPool(1024 * 1024));
+  scoped_refptr<IOBufferWithSize> buffer(pool->GetBuffer(100));
+  EXPECT_EQ(100, buffer->size());
+  char* data = buffer->data();
+  memset(data, 'x', IOBufferPool::kMinBufferSize);
+  buffer = NULL;
+  EXPECT_EQ(static_cast<size_t>(IOBufferPool::kMinBufferSize),
+            pool->cached_bytes());
+
+  // Any size in the same class gets the same memory back.
+  buffer = pool->GetBuffer(IOBufferPool::kMinBufferSize);
+  EXPECT_EQ(data, buffer->data());
+  EXPECT_EQ(0U, pool->cached_bytes());
+
+  // A bigger size comes from another class.
+  scoped_refptr<IOBufferWithSize> bigger(
+      pool->GetBuffer(IOBufferPool::kMinBufferSize + 1));
+  EXPECT_NE(data, bigger->data());
+  buffer = NULL;
+  bigger = NULL;
+  EXPECT_EQ(static_cast<size_t>(IOBufferPool::kMinBufferSize * 3),
+            pool->cached_bytes());
+
+  pool->Trim();
+  EXPECT_EQ(0U, pool->cached_bytes());
+}
+
+TEST(IOBufferPoolTest, LargeBuffersAreNotPooled) {
+  scoped_refptr<IOBufferPool> pool(new IOBufferPool(1024 * 1024));
+  scoped_refptr<IOBufferWithSize> buffer(
+      pool->GetBuffer(IOBufferPool::kMaxBufferSize + 1));
+  EXPECT_EQ(IOBufferPool::kMaxBufferSize + 1, buffer->size());
+  buffer = NULL;
+  EXPECT_EQ(0U, pool->cached_bytes());
+}
+
+TEST(IOBufferPoolTest, CacheIsBounded) {
+  scoped_refptr<IOBufferPool> pool(
+      new IOBufferPool(IOBufferPool::kMinBufferSize * 2));
+  scoped_refptr<IOBufferWithSize> buffers[3];
+  for (int i = 0; i < 3; ++i)
+    buffers[i] = pool->GetBuffer(IOBufferPool::kMinBufferSize);
+  for (int i = 0; i < 3; ++i)
+    buffers[i] = NULL;
+  EXPECT_EQ(static_cast<size_t>(IOBufferPool::kMinBufferSize * 2),
+            pool->cached_bytes());
+}
+
+// Buffers keep their pool alive.
+TEST(IOBufferPoolTest, BufferOutlivesPool) {
+  scoped_refptr<IOBufferPool> pool(new IOBufferPool(1024 * 1024));
+  scoped_refptr<IOBufferWithSize> buffer(pool->GetBuffer(10));
+  pool = NULL;
+  memset(buffer->data(), 0, buffer->size());
+  buffer = NULL;
+}
+
+}  // namespace
+
+}  // namespace net
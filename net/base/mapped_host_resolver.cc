@@ -49,6 +49,11 @@ void MappedHostResolver::ProbeIPv6Support() {
   impl_->ProbeIPv6Support();
 }
 
+void MappedHostResolver::SetMaxCacheStaleness(
+    base::TimeDelta max_staleness) {
+  impl_->SetMaxCacheStaleness(max_staleness);
+}
+
 HostCache* MappedHostResolver::GetHostCache() {
   return impl_->GetHostCache();
 }
@@ -54,6 +54,7 @@ class NET_EXPORT MappedHostResolver : public HostResolver {
                                const BoundNetLog& net_log) OVERRIDE;
   virtual void CancelRequest(RequestHandle req) OVERRIDE;
   virtual void ProbeIPv6Support() OVERRIDE;
+  virtual void SetMaxCacheStaleness(base::TimeDelta max_staleness) OVERRIDE;
   virtual HostCache* GetHostCache() OVERRIDE;
 
  private:
@@ -230,7 +230,10 @@ static bool MagicCmp(const char* magic_entry, const char* content, size_t len) {
   return true;
 }
 
+// |content_strlen| is the length of |content| up to its first '\0', which
+// magic strings are compared against.
 static bool MatchMagicNumber(const char* content, size_t size,
+                             size_t content_strlen,
                              const MagicNumber* magic_entry,
                              std::string* result) {
   const size_t len = magic_entry->magic_len;
@@ -238,14 +241,6 @@ static bool MatchMagicNumber(const char* content, size_t size,
   // Keep kBytesRequiredForMagic honest.
   DCHECK_LE(len, kBytesRequiredForMagic);
 
-  // To compare with magic strings, we need to compute strlen(content), but
-  // content might not actually have a null terminator.  In that case, we
-  // pretend the length is content_size.
-  const char* end =
-      static_cast<const char*>(memchr(content, '\0', size));
-  const size_t content_strlen =
-      (end != NULL) ? static_cast<size_t>(end - content) : size;
-
   bool match = false;
   if (magic_entry->is_string) {
     if (content_strlen >= len) {
@@ -268,8 +263,18 @@ static bool CheckForMagicNumbers(const char* content, size_t size,
                                  const MagicNumber* magic, size_t magic_len,
                                  base::Histogram* counter,
                                  std::string* result) {
+  // To compare with magic strings, we need to compute strlen(content), but
+  // content might not actually have a null terminator.  In that case, we
+  // pretend the length is content_size. This is done once here rather than
+  // for each entry, as most content has no '\0' to stop the search early.
+  const char* end =
+      static_cast<const char*>(memchr(content, '\0', size));
+  const size_t content_strlen =
+      (end != NULL) ? static_cast<size_t>(end - content) : size;
+
   for (size_t i = 0; i < magic_len; ++i) {
-    if (MatchMagicNumber(content, size, &(magic[i]), result)) {
+    if (MatchMagicNumber(content, size, content_strlen, &(magic[i]),
+                         result)) {
       if (counter) counter->Add(static_cast<int>(i));
       return true;
     }
@@ -418,7 +423,7 @@ static const MagicNumber kByteOrderMark[] = {
 
 // Whether a given byte looks like it might be part of binary content.
 // Source: HTML5 spec
-static char kByteLooksBinary[] = {
+static const char kByteLooksBinary[] = {
   1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1, 0, 0, 1, 1,  // 0x00 - 0x0F
   1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1,  // 0x10 - 0x1F
   0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x20 - 0x2F
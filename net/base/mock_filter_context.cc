@@ -10,7 +10,8 @@ MockFilterContext::MockFilterContext()
     : is_cached_content_(false),
       is_download_(false),
       is_sdch_response_(false),
-      response_code_(-1) {
+      response_code_(-1),
+      content_length_(-1) {
 }
 
 MockFilterContext::~MockFilterContext() {}
@@ -40,6 +41,8 @@ bool MockFilterContext::IsSdchResponse() const { return is_sdch_response_; }
 
 int64 MockFilterContext::GetByteReadCount() const { return 0; }
 
+int64 MockFilterContext::GetContentLength() const { return content_length_; }
+
 int MockFilterContext::GetResponseCode() const { return response_code_; }
 
 }  // namespace net
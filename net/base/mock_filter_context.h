@@ -24,6 +24,9 @@ class MockFilterContext : public FilterContext {
   void SetCached(bool is_cached) { is_cached_content_ = is_cached; }
   void SetDownload(bool is_download) { is_download_ = is_download; }
   void SetResponseCode(int response_code) { response_code_ = response_code; }
+  void SetContentLength(int64 content_length) {
+    content_length_ = content_length;
+  }
   void SetSdchResponse(bool is_sdch_response) {
     is_sdch_response_ = is_sdch_response;
   }
@@ -49,6 +52,8 @@ class MockFilterContext : public FilterContext {
   // How many bytes were fed to filter(s) so far?
   virtual int64 GetByteReadCount() const OVERRIDE;
 
+  virtual int64 GetContentLength() const OVERRIDE;
+
   virtual int GetResponseCode() const OVERRIDE;
 
   virtual void RecordPacketStats(StatisticSelector statistic) const OVERRIDE {}
@@ -62,6 +67,7 @@ class MockFilterContext : public FilterContext {
   bool is_download_;
   bool is_sdch_response_;
   int response_code_;
+  int64 content_length_;
 
   DISALLOW_COPY_AND_ASSIGN(MockFilterContext);
 };
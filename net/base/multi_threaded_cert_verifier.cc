@@ -68,6 +68,9 @@ namespace net {
 //
 // On a cache hit, MultiThreadedCertVerifier::Verify() returns synchronously
 // without posting a task to a worker thread.
+//
+// If too many jobs are running, Start is deferred until one of them reaches
+// HandleResult.
 
 namespace {
 
@@ -77,6 +80,11 @@ const unsigned kMaxCacheEntries = 256;
 // The number of seconds for which we'll cache a cache entry.
 const unsigned kTTLSecs = 1800;  // 30 minutes.
 
+// The default value of max_concurrent_jobs_. Verifications can block on the
+// network for revocation checks and AIA fetches, so this leaves room for a
+// few slow ones without letting a burst take over the worker pool.
+const size_t kMaxConcurrentJobs = 6;
+
 }  // namespace
 
 MultiThreadedCertVerifier::CachedResult::CachedResult() : error(ERR_FAILED) {}
@@ -255,13 +263,15 @@ class CertVerifierWorker {
 };
 
 // A CertVerifierJob is a one-to-one counterpart of a CertVerifierWorker. It
-// lives only on the CertVerifier's origin message loop.
+// lives only on the CertVerifier's origin message loop. It owns its worker
+// until the worker has been started.
 class CertVerifierJob {
  public:
   CertVerifierJob(CertVerifierWorker* worker,
                   const BoundNetLog& net_log)
       : start_time_(base::TimeTicks::Now()),
         worker_(worker),
+        started_(false),
         net_log_(net_log) {
     scoped_refptr<NetLog::EventParameters> params(
         new X509CertificateNetLogParam(worker_->certificate()));
@@ -272,11 +282,22 @@ class CertVerifierJob {
     if (worker_) {
       net_log_.AddEvent(NetLog::TYPE_CANCELLED, NULL);
       net_log_.EndEvent(NetLog::TYPE_CERT_VERIFIER_JOB, NULL);
-      worker_->Cancel();
+      if (started_) {
+        worker_->Cancel();
+      } else {
+        delete worker_;
+      }
       DeleteAllCanceled();
     }
   }
 
+  // Starts the worker. Returns false if it couldn't be started.
+  bool Start() {
+    DCHECK(!started_);
+    started_ = worker_->Start();
+    return started_;
+  }
+
   void AddRequest(CertVerifierRequest* request) {
     request->net_log().AddEvent(
         NetLog::TYPE_CERT_VERIFIER_REQUEST_BOUND_TO_JOB,
@@ -288,6 +309,8 @@ class CertVerifierJob {
 
   void HandleResult(
       const MultiThreadedCertVerifier::CachedResult& verify_result) {
+    if (!started_)
+      delete worker_;
     worker_ = NULL;
     net_log_.EndEvent(NetLog::TYPE_CERT_VERIFIER_JOB, NULL);
     UMA_HISTOGRAM_CUSTOM_TIMES("Net.CertVerifier_Job_Latency",
@@ -324,13 +347,18 @@ class CertVerifierJob {
   const base::TimeTicks start_time_;
   std::vector<CertVerifierRequest*> requests_;
   CertVerifierWorker* worker_;
+  bool started_;
   const BoundNetLog net_log_;
 };
 
 MultiThreadedCertVerifier::MultiThreadedCertVerifier()
     : cache_(kMaxCacheEntries),
+      chain_cache_(kMaxCacheEntries),
+      running_jobs_(0),
+      max_concurrent_jobs_(kMaxConcurrentJobs),
       requests_(0),
       cache_hits_(0),
+      chain_cache_hits_(0),
       inflight_joins_(0),
       verify_proc_(CertVerifyProc::CreateDefault()) {
   CertDatabase::AddObserver(this);
@@ -359,10 +387,10 @@ int MultiThreadedCertVerifier::Verify(X509Certificate* cert,
 
   requests_++;
 
+  const base::TimeTicks now = base::TimeTicks::Now();
   const RequestParams key(cert->fingerprint(), cert->ca_fingerprint(),
                           hostname, flags);
-  const CertVerifierCache::value_type* cached_entry =
-      cache_.Get(key, base::TimeTicks::Now());
+  const CertVerifierCache::value_type* cached_entry = cache_.Get(key, now);
   if (cached_entry) {
     ++cache_hits_;
     *out_req = NULL;
@@ -370,6 +398,21 @@ int MultiThreadedCertVerifier::Verify(X509Certificate* cert,
     return cached_entry->error;
   }
 
+  // The chain may have been verified already for another host. Only the
+  // name check depends on |hostname|, so if the name matches we can reuse
+  // that result. Mismatches get a full verification so that the error is
+  // reported exactly as the platform would.
+  const RequestParams chain_key(cert->fingerprint(), cert->ca_fingerprint(),
+                                std::string(), flags);
+  const CertVerifierCache::value_type* chain_entry =
+      chain_cache_.Get(chain_key, now);
+  if (chain_entry && cert->VerifyNameMatch(hostname)) {
+    ++chain_cache_hits_;
+    *out_req = NULL;
+    *verify_result = chain_entry->result;
+    return chain_entry->error;
+  }
+
   // No cache hit. See if an identical request is currently in flight.
   CertVerifierJob* job;
   std::map<RequestParams, CertVerifierJob*>::const_iterator j;
@@ -387,13 +430,17 @@ int MultiThreadedCertVerifier::Verify(X509Certificate* cert,
     job = new CertVerifierJob(
         worker,
         BoundNetLog::Make(net_log.net_log(), NetLog::SOURCE_CERT_VERIFIER_JOB));
-    if (!worker->Start()) {
-      delete job;
-      delete worker;
-      *out_req = NULL;
-      // TODO(wtc): log to the NetLog.
-      LOG(ERROR) << "CertVerifierWorker couldn't be started.";
-      return ERR_INSUFFICIENT_RESOURCES;  // Just a guess.
+    if (running_jobs_ < max_concurrent_jobs_) {
+      if (!job->Start()) {
+        delete job;  // Also deletes |worker|.
+        *out_req = NULL;
+        // TODO(wtc): log to the NetLog.
+        LOG(ERROR) << "CertVerifierWorker couldn't be started.";
+        return ERR_INSUFFICIENT_RESOURCES;  // Just a guess.
+      }
+      ++running_jobs_;
+    } else {
+      pending_.push_back(key);
     }
     inflight_.insert(std::make_pair(key, job));
   }
@@ -411,6 +458,32 @@ void MultiThreadedCertVerifier::CancelRequest(RequestHandle req) {
   request->Cancel();
 }
 
+void MultiThreadedCertVerifier::StartPendingJobs() {
+  while (running_jobs_ < max_concurrent_jobs_ && !pending_.empty()) {
+    std::map<RequestParams, CertVerifierJob*>::iterator j =
+        inflight_.find(pending_.front());
+    pending_.pop_front();
+    if (j == inflight_.end()) {
+      NOTREACHED();
+      continue;
+    }
+    CertVerifierJob* job = j->second;
+    if (job->Start()) {
+      ++running_jobs_;
+      continue;
+    }
+
+    // Verify() has returned already, so fail the requests asynchronously
+    // rather than synchronously.
+    LOG(ERROR) << "CertVerifierWorker couldn't be started.";
+    inflight_.erase(j);
+    CachedResult failed_result;
+    failed_result.error = ERR_INSUFFICIENT_RESOURCES;
+    job->HandleResult(failed_result);
+    delete job;
+  }
+}
+
 // HandleResult is called by CertVerifierWorker on the origin message loop.
 // It deletes CertVerifierJob.
 void MultiThreadedCertVerifier::HandleResult(
@@ -427,8 +500,14 @@ void MultiThreadedCertVerifier::HandleResult(
   CachedResult cached_result;
   cached_result.error = error;
   cached_result.result = verify_result;
-  cache_.Put(key, cached_result, base::TimeTicks::Now(),
-             base::TimeDelta::FromSeconds(kTTLSecs));
+  const base::TimeTicks now = base::TimeTicks::Now();
+  const base::TimeDelta ttl = base::TimeDelta::FromSeconds(kTTLSecs);
+  cache_.Put(key, cached_result, now, ttl);
+  if (error == OK) {
+    const RequestParams chain_key(cert->fingerprint(), cert->ca_fingerprint(),
+                                  std::string(), flags);
+    chain_cache_.Put(chain_key, cached_result, now, ttl);
+  }
 
   std::map<RequestParams, CertVerifierJob*>::iterator j;
   j = inflight_.find(key);
@@ -439,6 +518,10 @@ void MultiThreadedCertVerifier::HandleResult(
   CertVerifierJob* job = j->second;
   inflight_.erase(j);
 
+  DCHECK_GT(running_jobs_, 0u);
+  --running_jobs_;
+  StartPendingJobs();
+
   job->HandleResult(cached_result);
   delete job;
 }
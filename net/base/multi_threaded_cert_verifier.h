@@ -6,6 +6,7 @@
 #define NET_BASE_MULTI_THREADED_CERT_VERIFIER_H_
 #pragma once
 
+#include <deque>
 #include <map>
 #include <string>
 
@@ -31,6 +32,12 @@ class CertVerifyProc;
 
 // MultiThreadedCertVerifier is a CertVerifier implementation that runs
 // synchronous CertVerifier implementations on worker threads.
+//
+// At most a few verifications run at once; the rest wait their turn, so that
+// a burst of new connections doesn't occupy every worker thread with
+// identical path building. Successful verifications are also cached per
+// chain, independently of the hostname, so that a certificate which is
+// valid for several hosts is only path-built once.
 class NET_EXPORT_PRIVATE MultiThreadedCertVerifier :
     public CertVerifier,
     NON_EXPORTED_BASE(public base::NonThreadSafe),
@@ -65,8 +72,14 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier :
   FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest, CancelRequest);
   FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest,
                            RequestParamsComparators);
+  FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest, ChainCacheHit);
+  FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest,
+                           ChainCacheNameMismatch);
+  FRIEND_TEST_ALL_PREFIXES(MultiThreadedCertVerifierTest,
+                           ConcurrencyLimit);
 
-  // Input parameters of a certificate verification request.
+  // Input parameters of a certificate verification request. An empty
+  // |hostname| identifies the chain itself, in |chain_cache_|.
   struct RequestParams {
     RequestParams(const SHA1Fingerprint& cert_fingerprint_arg,
                   const SHA1Fingerprint& ca_fingerprint_arg,
@@ -109,6 +122,9 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier :
     CertVerifyResult result;  // The output of CertVerifier::Verify.
   };
 
+  // Starts queued jobs while fewer than |max_concurrent_jobs_| are running.
+  void StartPendingJobs();
+
   void HandleResult(X509Certificate* cert,
                     const std::string& hostname,
                     int flags,
@@ -119,23 +135,42 @@ class NET_EXPORT_PRIVATE MultiThreadedCertVerifier :
   virtual void OnCertTrustChanged(const X509Certificate* cert) OVERRIDE;
 
   // For unit testing.
-  void ClearCache() { cache_.Clear(); }
+  void ClearCache() {
+    cache_.Clear();
+    chain_cache_.Clear();
+  }
   size_t GetCacheSize() const { return cache_.size(); }
   uint64 cache_hits() const { return cache_hits_; }
+  uint64 chain_cache_hits() const { return chain_cache_hits_; }
   uint64 requests() const { return requests_; }
   uint64 inflight_joins() const { return inflight_joins_; }
+  size_t running_jobs() const { return running_jobs_; }
+  void set_max_concurrent_jobs(size_t max_concurrent_jobs) {
+    max_concurrent_jobs_ = max_concurrent_jobs;
+  }
   void SetCertVerifyProc(CertVerifyProc* verify_proc);
 
   // cache_ maps from a request to a cached result.
   typedef ExpiringCache<RequestParams, CachedResult> CertVerifierCache;
   CertVerifierCache cache_;
 
+  // chain_cache_ maps from a chain, with an empty hostname, to the result of
+  // a successful verification of it for some host that the leaf matched.
+  CertVerifierCache chain_cache_;
+
   // inflight_ maps from a request to an active verification which is taking
   // place.
   std::map<RequestParams, CertVerifierJob*> inflight_;
 
+  // pending_ holds the keys of the |inflight_| jobs that haven't started, in
+  // the order they were created.
+  std::deque<RequestParams> pending_;
+  size_t running_jobs_;
+  size_t max_concurrent_jobs_;
+
   uint64 requests_;
   uint64 cache_hits_;
+  uint64 chain_cache_hits_;
   uint64 inflight_joins_;
 
   scoped_refptr<CertVerifyProc> verify_proc_;
@@ -4,6 +4,7 @@
 
 #include "net/base/multi_threaded_cert_verifier.h"
 
+#include "base/atomicops.h"
 #include "base/bind.h"
 #include "base/file_path.h"
 #include "base/format_macros.h"
@@ -13,6 +14,7 @@
 #include "net/base/cert_verify_result.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_log.h"
+#include "net/base/test_certificate_data.h"
 #include "net/base/test_completion_callback.h"
 #include "net/base/x509_certificate.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -45,6 +47,33 @@ class MockCertVerifyProc : public CertVerifyProc {
   }
 };
 
+// Accepts every certificate, and counts how often it was asked to.
+class MockValidCertVerifyProc : public CertVerifyProc {
+ public:
+  MockValidCertVerifyProc() : verifications_(0) {}
+
+  int verifications() const {
+    return base::subtle::NoBarrier_Load(&verifications_);
+  }
+
+ private:
+  virtual ~MockValidCertVerifyProc() {}
+
+  // CertVerifyProc implementation
+  virtual int VerifyInternal(X509Certificate* cert,
+                             const std::string& hostname,
+                             int flags,
+                             CRLSet* crl_set,
+                             CertVerifyResult* verify_result) OVERRIDE {
+    base::subtle::NoBarrier_AtomicIncrement(&verifications_, 1);
+    verify_result->Reset();
+    verify_result->verified_cert = cert;
+    return OK;
+  }
+
+  base::subtle::Atomic32 verifications_;
+};
+
 }  // namespace
 
 class MultiThreadedCertVerifierTest : public ::testing::Test {
@@ -325,4 +354,105 @@ TEST_F(MultiThreadedCertVerifierTest, RequestParamsComparators) {
   }
 }
 
+// Tests that a chain verified for one host is reused for another host that
+// the certificate is valid for.
+TEST_F(MultiThreadedCertVerifierTest, ChainCacheHit) {
+  scoped_refptr<MockValidCertVerifyProc> verify_proc(
+      new MockValidCertVerifyProc());
+  verifier_.SetCertVerifyProc(verify_proc);
+  scoped_refptr<X509Certificate> webkit_cert(X509Certificate::CreateFromBytes(
+      reinterpret_cast<const char*>(webkit_der), sizeof(webkit_der)));
+  ASSERT_NE(static_cast<X509Certificate*>(NULL), webkit_cert);
+
+  CertVerifyResult verify_result;
+  TestCompletionCallback callback;
+  CertVerifier::RequestHandle request_handle;
+
+  int error = verifier_.Verify(webkit_cert, "www.webkit.org", 0, NULL,
+                               &verify_result, callback.callback(),
+                               &request_handle, BoundNetLog());
+  ASSERT_EQ(ERR_IO_PENDING, error);
+  EXPECT_EQ(OK, callback.WaitForResult());
+  EXPECT_EQ(1, verify_proc->verifications());
+
+  error = verifier_.Verify(webkit_cert, "bugs.webkit.org", 0, NULL,
+                           &verify_result, callback.callback(),
+                           &request_handle, BoundNetLog());
+  // Synchronous completion.
+  EXPECT_EQ(OK, error);
+  EXPECT_TRUE(request_handle == NULL);
+  EXPECT_EQ(0u, verifier_.cache_hits());
+  EXPECT_EQ(1u, verifier_.chain_cache_hits());
+  EXPECT_EQ(1, verify_proc->verifications());
+
+  // Different flags are a different chain verification.
+  error = verifier_.Verify(webkit_cert, "bugs.webkit.org",
+                           X509Certificate::VERIFY_EV_CERT, NULL,
+                           &verify_result, callback.callback(),
+                           &request_handle, BoundNetLog());
+  ASSERT_EQ(ERR_IO_PENDING, error);
+  EXPECT_EQ(OK, callback.WaitForResult());
+  EXPECT_EQ(2, verify_proc->verifications());
+}
+
+// Tests that a host the certificate isn't valid for gets a full
+// verification.
+TEST_F(MultiThreadedCertVerifierTest, ChainCacheNameMismatch) {
+  scoped_refptr<MockValidCertVerifyProc> verify_proc(
+      new MockValidCertVerifyProc());
+  verifier_.SetCertVerifyProc(verify_proc);
+  scoped_refptr<X509Certificate> webkit_cert(X509Certificate::CreateFromBytes(
+      reinterpret_cast<const char*>(webkit_der), sizeof(webkit_der)));
+  ASSERT_NE(static_cast<X509Certificate*>(NULL), webkit_cert);
+
+  CertVerifyResult verify_result;
+  TestCompletionCallback callback;
+  CertVerifier::RequestHandle request_handle;
+
+  int error = verifier_.Verify(webkit_cert, "www.webkit.org", 0, NULL,
+                               &verify_result, callback.callback(),
+                               &request_handle, BoundNetLog());
+  ASSERT_EQ(ERR_IO_PENDING, error);
+  EXPECT_EQ(OK, callback.WaitForResult());
+
+  error = verifier_.Verify(webkit_cert, "www.example.com", 0, NULL,
+                           &verify_result, callback.callback(),
+                           &request_handle, BoundNetLog());
+  ASSERT_EQ(ERR_IO_PENDING, error);
+  callback.WaitForResult();
+  EXPECT_EQ(0u, verifier_.chain_cache_hits());
+  EXPECT_EQ(2, verify_proc->verifications());
+}
+
+// Tests that verifications beyond the limit wait for a running one to finish.
+TEST_F(MultiThreadedCertVerifierTest, ConcurrencyLimit) {
+  verifier_.set_max_concurrent_jobs(1);
+  FilePath certs_dir = GetTestCertsDirectory();
+  scoped_refptr<X509Certificate> test_cert(
+      ImportCertFromFile(certs_dir, "ok_cert.pem"));
+  ASSERT_NE(static_cast<X509Certificate*>(NULL), test_cert);
+
+  CertVerifyResult verify_result1;
+  CertVerifyResult verify_result2;
+  TestCompletionCallback callback1;
+  TestCompletionCallback callback2;
+  CertVerifier::RequestHandle request_handle1;
+  CertVerifier::RequestHandle request_handle2;
+
+  int error = verifier_.Verify(test_cert, "www.example.com", 0, NULL,
+                               &verify_result1, callback1.callback(),
+                               &request_handle1, BoundNetLog());
+  ASSERT_EQ(ERR_IO_PENDING, error);
+  error = verifier_.Verify(test_cert, "www.example.org", 0, NULL,
+                           &verify_result2, callback2.callback(),
+                           &request_handle2, BoundNetLog());
+  ASSERT_EQ(ERR_IO_PENDING, error);
+  EXPECT_EQ(1u, verifier_.running_jobs());
+
+  EXPECT_TRUE(IsCertificateError(callback1.WaitForResult()));
+  EXPECT_TRUE(IsCertificateError(callback2.WaitForResult()));
+  EXPECT_EQ(0u, verifier_.running_jobs());
+  EXPECT_EQ(2u, verifier_.GetCacheSize());
+}
+
 }  // namespace net
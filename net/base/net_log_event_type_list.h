@@ -329,6 +329,10 @@ EVENT_TYPE(WAITING_FOR_PROXY_RESOLVER_THREAD)
 //   }
 EVENT_TYPE(SUBMITTED_TO_RESOLVER_THREAD)
 
+// This event is emitted when a proxy resolve request is answered from the
+// results of an earlier run of the PAC script for the same URL.
+EVENT_TYPE(PROXY_RESOLVER_CACHE_HIT)
+
 // ------------------------------------------------------------------------
 // Socket (Shared by stream and datagram sockets)
 // ------------------------------------------------------------------------
@@ -603,6 +607,21 @@ EVENT_TYPE(CONNECT_JOB_SET_SOCKET)
 // Whether the connect job timed out.
 EVENT_TYPE(SOCKET_POOL_CONNECT_JOB_TIMED_OUT)
 
+// ------------------------------------------------------------------------
+// TransportConnectJob
+// ------------------------------------------------------------------------
+
+// Logged when the IPv6 connect has not finished in time, and the job starts
+// racing a connect that begins with an IPv4 address against it.
+EVENT_TYPE(TRANSPORT_CONNECT_JOB_IPV6_FALLBACK)
+
+// Logged when one of the two racing connects fails while the other is still
+// in progress. The event parameters are:
+//   {
+//     "net_error": <Net error code of the connect that failed>,
+//   }
+EVENT_TYPE(TRANSPORT_CONNECT_JOB_RACE_LOST)
+
 // ------------------------------------------------------------------------
 // ClientSocketPoolBaseHelper
 // ------------------------------------------------------------------------
@@ -1048,6 +1067,14 @@ EVENT_TYPE(SPDY_SESSION_SEND_CREDENTIAL)
 //   }
 EVENT_TYPE(SPDY_SESSION_SEND_DATA)
 
+// A stream's frame has been written to the socket.
+//   {
+//     "stream_id" : <The stream ID of the frame>,
+//     "size"      : <The size of the frame, including its header>,
+//     "latency_ms": <The time from queueing the frame to writing all of it>,
+//   }
+EVENT_TYPE(SPDY_SESSION_WRITE_COMPLETE)
+
 // Receiving a data frame
 //   {
 //     "stream_id": <The stream ID for the window update>,
@@ -1332,6 +1359,17 @@ EVENT_TYPE(DNS_TRANSACTION_QUERY)
 //   }
 EVENT_TYPE(DNS_TRANSACTION_ATTEMPT)
 
+// This event is created when DnsTransaction repeats a query over TCP because
+// the UDP response was truncated.
+//
+// It has a single parameter:
+//
+//   {
+//     "source_dependency": <Source id of the TCP socket created for the
+//                           attempt>,
+//   }
+EVENT_TYPE(DNS_TRANSACTION_TCP_ATTEMPT)
+
 // This event is created when DnsTransaction receives a matching response.
 //
 // It has the following parameters:
@@ -1339,7 +1377,7 @@ EVENT_TYPE(DNS_TRANSACTION_ATTEMPT)
 //   {
 //     "rcode": <rcode in the received response>,
 //     "answer_count": <answer_count in the received response>,
-//     "source_dependency": <Source id of the UDP socket that received the
+//     "source_dependency": <Source id of the socket that received the
 //                           response>,
 //   }
 EVENT_TYPE(DNS_TRANSACTION_RESPONSE)
@@ -75,7 +75,7 @@ std::string RegistryControlledDomainService::GetDomainAndRegistry(
       gurl.parsed_for_possibly_invalid_spec().host;
   if ((host.len <= 0) || gurl.HostIsIPAddress())
     return std::string();
-  return GetDomainAndRegistryImpl(std::string(
+  return GetDomainAndRegistryImpl(base::StringPiece(
       gurl.possibly_invalid_spec().data() + host.begin, host.len));
 }
 
@@ -122,7 +122,8 @@ size_t RegistryControlledDomainService::GetRegistryLength(
   if (gurl.HostIsIPAddress())
     return 0;
   return GetRegistryLengthImpl(
-      std::string(gurl.possibly_invalid_spec().data() + host.begin, host.len),
+      base::StringPiece(gurl.possibly_invalid_spec().data() + host.begin,
+                        host.len),
       allow_unknown_registries);
 }
 
@@ -147,7 +148,7 @@ void RegistryControlledDomainService::UseFindDomainFunction(
 
 // static
 std::string RegistryControlledDomainService::GetDomainAndRegistryImpl(
-    const std::string& host) {
+    const base::StringPiece& host) {
   DCHECK(!host.empty());
 
   // Find the length of the registry for this host.
@@ -167,19 +168,19 @@ std::string RegistryControlledDomainService::GetDomainAndRegistryImpl(
   // dot.  Return the host from after that dot, or the whole host when there is
   // no dot.
   const size_t dot = host.rfind('.', host.length() - registry_length - 2);
-  if (dot == std::string::npos)
-    return host;
-  return host.substr(dot + 1);
+  if (dot == base::StringPiece::npos)
+    return host.as_string();
+  return host.substr(dot + 1).as_string();
 }
 
 size_t RegistryControlledDomainService::GetRegistryLengthImpl(
-    const std::string& host,
+    const base::StringPiece& host,
     bool allow_unknown_registries) {
   DCHECK(!host.empty());
 
   // Skip leading dots.
   const size_t host_check_begin = host.find_first_not_of('.');
-  if (host_check_begin == std::string::npos)
+  if (host_check_begin == base::StringPiece::npos)
     return 0;  // Host is only dots.
 
   // A single trailing dot isn't relevant in this determination, but does need
@@ -198,7 +199,7 @@ size_t RegistryControlledDomainService::GetRegistryLengthImpl(
   size_t prev_start = std::string::npos;
   size_t curr_start = host_check_begin;
   size_t next_dot = host.find('.', curr_start);
-  if (next_dot >= host_check_len)  // Catches std::string::npos as well.
+  if (next_dot >= host_check_len)  // Catches npos as well.
     return 0;  // This can't have a registry + domain.
   while (1) {
     const char* domain_str = host.data() + curr_start;
@@ -220,7 +221,7 @@ size_t RegistryControlledDomainService::GetRegistryLengthImpl(
       }
 
       if (rule->type == kExceptionRule) {
-        if (next_dot == std::string::npos) {
+        if (next_dot == base::StringPiece::npos) {
           // If we get here, we had an exception rule with no dots (e.g.
           // "!foo").  This would only be valid if we had a corresponding
           // wildcard rule, which would have to be "*".  But we explicitly
@@ -237,7 +238,7 @@ size_t RegistryControlledDomainService::GetRegistryLengthImpl(
           0 : (host.length() - curr_start);
     }
 
-    if (next_dot >= host_check_len)  // Catches std::string::npos as well.
+    if (next_dot >= host_check_len)  // Catches npos as well.
       break;
 
     prev_start = curr_start;
@@ -117,6 +117,7 @@
 #include <string>
 
 #include "base/basictypes.h"
+#include "base/string_piece.h"
 #include "net/base/net_export.h"
 
 class GURL;
@@ -195,9 +196,10 @@ class NET_EXPORT RegistryControlledDomainService {
  private:
   friend class RegistryControlledDomainTest;
 
-  // Internal workings of the static public methods.  See above.
-  static std::string GetDomainAndRegistryImpl(const std::string& host);
-  static size_t GetRegistryLengthImpl(const std::string& host,
+  // Internal workings of the static public methods.  See above.  They take
+  // the host as a piece so that GURL hosts needn't be copied to be looked up.
+  static std::string GetDomainAndRegistryImpl(const base::StringPiece& host);
+  static size_t GetRegistryLengthImpl(const base::StringPiece& host,
                                       bool allow_unknown_registries);
 
   typedef const struct DomainRule* (*FindDomainPtr)(const char *, unsigned int);
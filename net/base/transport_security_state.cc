@@ -15,10 +15,13 @@
 #include <nspr.h>
 #endif
 
+#include <string.h>
+
 #include <algorithm>
 #include <utility>
 
 #include "base/base64.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
@@ -44,10 +47,34 @@ namespace net {
 
 const long int TransportSecurityState::kMaxHSTSAgeSecs = 86400 * 365;  // 1 year
 
-static std::string HashHost(const std::string& canonicalized_host) {
-  char hashed[crypto::kSHA256Length];
-  crypto::SHA256HashString(canonicalized_host, hashed, sizeof(hashed));
-  return std::string(hashed, sizeof(hashed));
+// Hashes the suffix of |canonicalized_host| that starts at |offset|.
+static void HashHost(const std::string& canonicalized_host, size_t offset,
+                     TransportSecurityState::HashedHost* hashed) {
+  crypto::SHA256HashString(
+      base::StringPiece(canonicalized_host.data() + offset,
+                        canonicalized_host.size() - offset),
+      hashed->data, sizeof(hashed->data));
+}
+
+// Converts |hashed_host|, as stored by the persister, to a HashedHost.
+static bool HashedHostFromString(const std::string& hashed_host,
+                                 TransportSecurityState::HashedHost* hashed) {
+  if (hashed_host.size() != sizeof(hashed->data))
+    return false;
+  memcpy(hashed->data, hashed_host.data(), sizeof(hashed->data));
+  return true;
+}
+
+static void FillStaticDomainState(
+    const std::string& canonicalized_host,
+    size_t offset,
+    const TransportSecurityState::DomainState* forced,
+    const struct HSTSPreload* preload,
+    TransportSecurityState::DomainState* out);
+
+bool TransportSecurityState::HashedHost::operator<(
+    const HashedHost& other) const {
+  return memcmp(data, other.data, sizeof(data)) < 0;
 }
 
 TransportSecurityState::TransportSecurityState()
@@ -82,7 +109,9 @@ void TransportSecurityState::EnableHost(const std::string& host,
   // is the map key.)
   state_copy.domain.clear();
 
-  enabled_hosts_[HashHost(canonicalized_host)] = state_copy;
+  HashedHost hashed;
+  HashHost(canonicalized_host, 0, &hashed);
+  enabled_hosts_[hashed] = state_copy;
   DirtyNotify();
 }
 
@@ -93,8 +122,9 @@ bool TransportSecurityState::DeleteHost(const std::string& host) {
   if (canonicalized_host.empty())
     return false;
 
-  std::map<std::string, DomainState>::iterator i = enabled_hosts_.find(
-      HashHost(canonicalized_host));
+  HashedHost hashed;
+  HashHost(canonicalized_host, 0, &hashed);
+  DomainStateMap::iterator i = enabled_hosts_.find(hashed);
   if (i != enabled_hosts_.end()) {
     enabled_hosts_.erase(i);
     DirtyNotify();
@@ -108,28 +138,51 @@ bool TransportSecurityState::GetDomainState(const std::string& host,
                                             DomainState* result) {
   DCHECK(CalledOnValidThread());
 
-  DomainState state;
   const std::string canonicalized_host = CanonicalizeHost(host);
   if (canonicalized_host.empty())
     return false;
 
-  bool has_preload = GetStaticDomainState(canonicalized_host, sni_enabled,
-                                          &state);
-  std::string canonicalized_preload = CanonicalizeHost(state.domain);
+  // An exact match of a static entry always wins, so only dynamic entries
+  // for more specific names than the static one are considered.
+  size_t static_offset = canonicalized_host.size();
+  const DomainState* forced = NULL;
+  const HSTSPreload* preload = NULL;
+  bool has_static = FindStaticEntry(canonicalized_host, sni_enabled,
+                                    &static_offset, &forced, &preload);
+
+  size_t offset;
+  DomainStateMap::iterator j =
+      FindDynamicEntry(canonicalized_host, static_offset, &offset);
+  if (j != enabled_hosts_.end()) {
+    // Succeed if we matched the domain exactly or if subdomain matches are
+    // allowed.
+    if (offset != 0 && !j->second.include_subdomains)
+      return false;
+    *result = j->second;
+    result->domain = DNSDomainToString(canonicalized_host.substr(offset));
+    return true;
+  }
+
+  if (!has_static)
+    return false;
+  DomainState state;
+  FillStaticDomainState(canonicalized_host, static_offset, forced, preload,
+                        &state);
+  *result = state;
+  return true;
+}
 
+TransportSecurityState::DomainStateMap::iterator
+TransportSecurityState::FindDynamicEntry(const std::string& canonicalized_host,
+                                         size_t end_offset,
+                                         size_t* offset) {
   base::Time current_time(base::Time::Now());
 
-  for (size_t i = 0; canonicalized_host[i]; i += canonicalized_host[i] + 1) {
-    std::string host_sub_chunk(&canonicalized_host[i],
-                               canonicalized_host.size() - i);
-    // Exact match of a preload always wins.
-    if (has_preload && host_sub_chunk == canonicalized_preload) {
-      *result = state;
-      return true;
-    }
-
-    std::map<std::string, DomainState>::iterator j =
-        enabled_hosts_.find(HashHost(host_sub_chunk));
+  for (size_t i = 0; i < end_offset && canonicalized_host[i];
+       i += canonicalized_host[i] + 1) {
+    HashedHost hashed;
+    HashHost(canonicalized_host, i, &hashed);
+    DomainStateMap::iterator j = enabled_hosts_.find(hashed);
     if (j == enabled_hosts_.end())
       continue;
 
@@ -140,20 +193,11 @@ bool TransportSecurityState::GetDomainState(const std::string& host,
       continue;
     }
 
-    state = j->second;
-    state.domain = DNSDomainToString(host_sub_chunk);
-
-    // Succeed if we matched the domain exactly or if subdomain matches are
-    // allowed.
-    if (i == 0 || j->second.include_subdomains) {
-      *result = state;
-      return true;
-    }
-
-    return false;
+    *offset = i;
+    return j;
   }
 
-  return false;
+  return enabled_hosts_.end();
 }
 
 void TransportSecurityState::DeleteSince(const base::Time& time) {
@@ -161,7 +205,7 @@ void TransportSecurityState::DeleteSince(const base::Time& time) {
 
   bool dirtied = false;
 
-  std::map<std::string, DomainState>::iterator i = enabled_hosts_.begin();
+  DomainStateMap::iterator i = enabled_hosts_.begin();
   while (i != enabled_hosts_.end()) {
     if (i->second.created >= time) {
       dirtied = true;
@@ -588,46 +632,115 @@ struct HSTSPreload {
   SecondLevelDomainName second_level_domain_name;
 };
 
-static bool HasPreload(const struct HSTSPreload* entries, size_t num_entries,
-                       const std::string& canonicalized_host, size_t i,
-                       TransportSecurityState::DomainState* out, bool* ret) {
-  for (size_t j = 0; j < num_entries; j++) {
-    if (entries[j].length == canonicalized_host.size() - i &&
-        memcmp(entries[j].dns_name, &canonicalized_host[i],
-               entries[j].length) == 0) {
-      if (!entries[j].include_subdomains && i != 0) {
-        *ret = false;
-      } else {
-        out->include_subdomains = entries[j].include_subdomains;
-        *ret = true;
-        if (!entries[j].https_required)
-          out->upgrade_mode = TransportSecurityState::DomainState::MODE_DEFAULT;
-        if (entries[j].pins.required_hashes) {
-          const char* const* hash = entries[j].pins.required_hashes;
-          while (*hash) {
-            bool ok = AddHash(*hash, &out->static_spki_hashes);
-            DCHECK(ok) << " failed to parse " << *hash;
-            hash++;
-          }
-        }
-        if (entries[j].pins.excluded_hashes) {
-          const char* const* hash = entries[j].pins.excluded_hashes;
-          while (*hash) {
-            bool ok = AddHash(*hash, &out->bad_static_spki_hashes);
-            DCHECK(ok) << " failed to parse " << *hash;
-            hash++;
-          }
-        }
-      }
-      return true;
+// Fills |*out| from the static entry that FindStaticEntry found for the
+// suffix of |canonicalized_host| at |offset|: either |*forced| or |*preload|.
+static void FillStaticDomainState(
+    const std::string& canonicalized_host,
+    size_t offset,
+    const TransportSecurityState::DomainState* forced,
+    const struct HSTSPreload* preload,
+    TransportSecurityState::DomainState* out) {
+  if (forced) {
+    *out = *forced;
+    out->domain = DNSDomainToString(canonicalized_host.substr(offset));
+    return;
+  }
+
+  out->upgrade_mode = TransportSecurityState::DomainState::MODE_FORCE_HTTPS;
+  out->include_subdomains = preload->include_subdomains;
+  out->domain = DNSDomainToString(canonicalized_host.substr(offset));
+  if (!preload->https_required)
+    out->upgrade_mode = TransportSecurityState::DomainState::MODE_DEFAULT;
+  if (preload->pins.required_hashes) {
+    const char* const* hash = preload->pins.required_hashes;
+    while (*hash) {
+      bool ok = AddHash(*hash, &out->static_spki_hashes);
+      DCHECK(ok) << " failed to parse " << *hash;
+      hash++;
+    }
+  }
+  if (preload->pins.excluded_hashes) {
+    const char* const* hash = preload->pins.excluded_hashes;
+    while (*hash) {
+      bool ok = AddHash(*hash, &out->bad_static_spki_hashes);
+      DCHECK(ok) << " failed to parse " << *hash;
+      hash++;
     }
   }
-  return false;
 }
 
 #include "net/base/transport_security_state_static.h"
 
-// Returns the HSTSPreload entry for the |canonicalized_host| in |entries|,
+namespace {
+
+// Orders |entry| against the DNS-form name |name| of |length| bytes; shorter
+// names come first.
+int ComparePreload(const struct HSTSPreload* entry,
+                   const char* name,
+                   size_t length) {
+  if (entry->length != length)
+    return entry->length < length ? -1 : 1;
+  return memcmp(entry->dns_name, name, length);
+}
+
+bool PreloadLessThan(const struct HSTSPreload* a,
+                     const struct HSTSPreload* b) {
+  return ComparePreload(a, b->dns_name, b->length) < 0;
+}
+
+// A table of preloaded entries, sorted so that finding a name is a binary
+// search rather than a scan of the whole table. The entries themselves stay
+// in the read-only data of the binary; only pointers to them are sorted.
+class PreloadIndex {
+ public:
+  PreloadIndex(const struct HSTSPreload* entries, size_t num_entries) {
+    for (size_t i = 0; i < num_entries; ++i)
+      sorted_.push_back(entries + i);
+    std::stable_sort(sorted_.begin(), sorted_.end(), PreloadLessThan);
+  }
+
+  // Returns the entry for exactly the suffix of |canonicalized_host| at
+  // |offset|, or NULL if there is none.
+  const struct HSTSPreload* Find(const std::string& canonicalized_host,
+                                 size_t offset) const {
+    const char* name = canonicalized_host.data() + offset;
+    size_t length = canonicalized_host.size() - offset;
+    size_t low = 0;
+    size_t high = sorted_.size();
+    while (low < high) {
+      size_t middle = low + (high - low) / 2;
+      if (ComparePreload(sorted_[middle], name, length) < 0)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+    if (low < sorted_.size() &&
+        ComparePreload(sorted_[low], name, length) == 0) {
+      return sorted_[low];
+    }
+    return NULL;
+  }
+
+ private:
+  std::vector<const struct HSTSPreload*> sorted_;
+};
+
+struct PreloadIndices {
+  PreloadIndices()
+      : sts(kPreloadedSTS, kNumPreloadedSTS),
+        sni_sts(kPreloadedSNISTS, kNumPreloadedSNISTS) {
+  }
+
+  const PreloadIndex sts;
+  const PreloadIndex sni_sts;
+};
+
+base::LazyInstance<PreloadIndices>::Leaky g_preload_indices =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+// Returns the HSTSPreload entry for the |canonicalized_host| in |index|,
 // or NULL if there is none. Prefers exact hostname matches to those that
 // match only because HSTSPreload.include_subdomains is true.
 //
@@ -635,20 +748,11 @@ static bool HasPreload(const struct HSTSPreload* entries, size_t num_entries,
 // CanonicalizeHost.
 static const struct HSTSPreload* GetHSTSPreload(
     const std::string& canonicalized_host,
-    const struct HSTSPreload* entries,
-    size_t num_entries) {
+    const PreloadIndex& index) {
   for (size_t i = 0; canonicalized_host[i]; i += canonicalized_host[i] + 1) {
-    for (size_t j = 0; j < num_entries; j++) {
-      const struct HSTSPreload* entry = entries + j;
-
-      if (i != 0 && !entry->include_subdomains)
-        continue;
-
-      if (entry->length == canonicalized_host.size() - i &&
-          memcmp(entry->dns_name, &canonicalized_host[i], entry->length) == 0) {
-        return entry;
-      }
-    }
+    const struct HSTSPreload* entry = index.Find(canonicalized_host, i);
+    if (entry && (i == 0 || entry->include_subdomains))
+      return entry;
   }
 
   return NULL;
@@ -659,14 +763,13 @@ bool TransportSecurityState::IsGooglePinnedProperty(const std::string& host,
                                                     bool sni_enabled) {
   std::string canonicalized_host = CanonicalizeHost(host);
   const struct HSTSPreload* entry =
-      GetHSTSPreload(canonicalized_host, kPreloadedSTS, kNumPreloadedSTS);
+      GetHSTSPreload(canonicalized_host, g_preload_indices.Get().sts);
 
   if (entry && entry->pins.required_hashes == kGoogleAcceptableCerts)
     return true;
 
   if (sni_enabled) {
-    entry = GetHSTSPreload(canonicalized_host, kPreloadedSNISTS,
-                           kNumPreloadedSNISTS);
+    entry = GetHSTSPreload(canonicalized_host, g_preload_indices.Get().sni_sts);
     if (entry && entry->pins.required_hashes == kGoogleAcceptableCerts)
       return true;
   }
@@ -679,11 +782,11 @@ void TransportSecurityState::ReportUMAOnPinFailure(const std::string& host) {
   std::string canonicalized_host = CanonicalizeHost(host);
 
   const struct HSTSPreload* entry =
-      GetHSTSPreload(canonicalized_host, kPreloadedSTS, kNumPreloadedSTS);
+      GetHSTSPreload(canonicalized_host, g_preload_indices.Get().sts);
 
   if (!entry) {
-    entry = GetHSTSPreload(canonicalized_host, kPreloadedSNISTS,
-                           kNumPreloadedSNISTS);
+    entry = GetHSTSPreload(canonicalized_host,
+                           g_preload_indices.Get().sni_sts);
   }
 
   DCHECK(entry);
@@ -700,28 +803,76 @@ bool TransportSecurityState::GetStaticDomainState(
     DomainState* out) {
   DCHECK(CalledOnValidThread());
 
-  out->upgrade_mode = DomainState::MODE_FORCE_HTTPS;
-  out->include_subdomains = false;
+  size_t offset;
+  const DomainState* forced = NULL;
+  const HSTSPreload* preload = NULL;
+  if (!FindStaticEntry(canonicalized_host, sni_enabled, &offset, &forced,
+                       &preload)) {
+    return false;
+  }
+  FillStaticDomainState(canonicalized_host, offset, forced, preload, out);
+  return true;
+}
+
+bool TransportSecurityState::ShouldUpgradeToSSL(const std::string& host,
+                                                bool sni_enabled) {
+  DCHECK(CalledOnValidThread());
+
+  const std::string canonicalized_host = CanonicalizeHost(host);
+  if (canonicalized_host.empty())
+    return false;
+
+  size_t static_offset = canonicalized_host.size();
+  const DomainState* forced = NULL;
+  const HSTSPreload* preload = NULL;
+  bool has_static = FindStaticEntry(canonicalized_host, sni_enabled,
+                                    &static_offset, &forced, &preload);
+
+  size_t offset;
+  DomainStateMap::iterator j =
+      FindDynamicEntry(canonicalized_host, static_offset, &offset);
+  if (j != enabled_hosts_.end()) {
+    if (offset != 0 && !j->second.include_subdomains)
+      return false;
+    return j->second.ShouldRedirectHTTPToHTTPS();
+  }
+
+  if (!has_static)
+    return false;
+  if (forced)
+    return forced->ShouldRedirectHTTPToHTTPS();
+  return preload->https_required;
+}
+
+bool TransportSecurityState::FindStaticEntry(
+    const std::string& canonicalized_host,
+    bool sni_enabled,
+    size_t* offset,
+    const DomainState** forced,
+    const HSTSPreload** preload) const {
+  const PreloadIndices& indices = g_preload_indices.Get();
 
   for (size_t i = 0; canonicalized_host[i]; i += canonicalized_host[i] + 1) {
-    std::string host_sub_chunk(&canonicalized_host[i],
-                               canonicalized_host.size() - i);
-    out->domain = DNSDomainToString(host_sub_chunk);
-    std::string hashed_host(HashHost(host_sub_chunk));
-    if (forced_hosts_.find(hashed_host) != forced_hosts_.end()) {
-      *out = forced_hosts_[hashed_host];
-      out->domain = DNSDomainToString(host_sub_chunk);
+    HashedHost hashed;
+    HashHost(canonicalized_host, i, &hashed);
+    DomainStateMap::const_iterator j = forced_hosts_.find(hashed);
+    if (j != forced_hosts_.end()) {
+      *offset = i;
+      *forced = &j->second;
       return true;
     }
-    bool ret;
-    if (HasPreload(kPreloadedSTS, kNumPreloadedSTS, canonicalized_host, i, out,
-                   &ret)) {
-      return ret;
-    }
-    if (sni_enabled &&
-        HasPreload(kPreloadedSNISTS, kNumPreloadedSNISTS, canonicalized_host, i,
-                   out, &ret)) {
-      return ret;
+
+    // The most specific preload decides, even when it does not cover
+    // subdomains.
+    const HSTSPreload* entry = indices.sts.Find(canonicalized_host, i);
+    if (!entry && sni_enabled)
+      entry = indices.sni_sts.Find(canonicalized_host, i);
+    if (entry) {
+      if (i != 0 && !entry->include_subdomains)
+        return false;
+      *offset = i;
+      *preload = entry;
+      return true;
     }
   }
 
@@ -730,12 +881,22 @@ bool TransportSecurityState::GetStaticDomainState(
 
 void TransportSecurityState::AddOrUpdateEnabledHosts(std::string hashed_host,
                                                      const DomainState& state) {
-  enabled_hosts_[hashed_host] = state;
+  HashedHost hashed;
+  if (!HashedHostFromString(hashed_host, &hashed)) {
+    NOTREACHED();
+    return;
+  }
+  enabled_hosts_[hashed] = state;
 }
 
 void TransportSecurityState::AddOrUpdateForcedHosts(std::string hashed_host,
                                                     const DomainState& state) {
-  forced_hosts_[hashed_host] = state;
+  HashedHost hashed;
+  if (!HashedHostFromString(hashed_host, &hashed)) {
+    NOTREACHED();
+    return;
+  }
+  forced_hosts_[hashed] = state;
 }
 
 static std::string HashesToBase64String(
@@ -15,12 +15,14 @@
 #include "base/gtest_prod_util.h"
 #include "base/threading/non_thread_safe.h"
 #include "base/time.h"
+#include "crypto/sha2.h"
 #include "net/base/net_export.h"
 #include "net/base/x509_certificate.h"
 #include "net/base/x509_cert_types.h"
 
 namespace net {
 
+struct HSTSPreload;
 class SSLInfo;
 
 // Tracks which hosts have enabled strict transport security and/or public
@@ -152,6 +154,15 @@ class NET_EXPORT TransportSecurityState
     std::string domain;
   };
 
+  // The key of the dynamic entries: the SHA-256 hash of a canonicalized
+  // host. It is held inline, so that looking a host up does not allocate.
+  struct HashedHost {
+    bool operator<(const HashedHost& other) const;
+
+    char data[crypto::kSHA256Length];
+  };
+  typedef std::map<HashedHost, DomainState> DomainStateMap;
+
   class Iterator {
    public:
     explicit Iterator(const TransportSecurityState& state)
@@ -162,12 +173,14 @@ class NET_EXPORT TransportSecurityState
 
     bool HasNext() const { return iterator_ != end_; }
     void Advance() { ++iterator_; }
-    const std::string& hostname() const { return iterator_->first; }
+    std::string hostname() const {
+      return std::string(iterator_->first.data, sizeof(iterator_->first.data));
+    }
     const DomainState& domain_state() const { return iterator_->second; }
 
    private:
-    std::map<std::string, DomainState>::const_iterator iterator_;
-    std::map<std::string, DomainState>::const_iterator end_;
+    DomainStateMap::const_iterator iterator_;
+    DomainStateMap::const_iterator end_;
   };
 
   // Assign a |Delegate| for persisting the transport security state. If
@@ -205,6 +218,13 @@ class NET_EXPORT TransportSecurityState
                       bool sni_enabled,
                       DomainState* result);
 
+  // Returns true iff requests to |host| over HTTP should be redirected to
+  // HTTPS. The answer is the same as |GetDomainState| followed by
+  // |DomainState::ShouldRedirectHTTPToHTTPS| would give, but it is found
+  // without copying any DomainState, and without allocating once |host| is
+  // canonicalized. This is the check made for every http:// request.
+  bool ShouldUpgradeToSSL(const std::string& host, bool sni_enabled);
+
   // Returns true and updates |*result| iff there is a static DomainState for
   // |host|.
   //
@@ -281,12 +301,31 @@ class NET_EXPORT TransportSecurityState
   // changed.
   void DirtyNotify();
 
+  // Searches |forced_hosts_| and the preloaded entries for the one that
+  // applies to |canonicalized_host|. On success, returns true, sets
+  // |*offset| to the start of the suffix of |canonicalized_host| that
+  // matched, and sets exactly one of |*forced| and |*preload|.
+  bool FindStaticEntry(const std::string& canonicalized_host,
+                       bool sni_enabled,
+                       size_t* offset,
+                       const DomainState** forced,
+                       const HSTSPreload** preload) const;
+
+  // Returns the most specific entry of |enabled_hosts_| for a suffix of
+  // |canonicalized_host| that starts before |end_offset|, and sets |*offset|
+  // to the start of that suffix. Returns |enabled_hosts_.end()| if there is
+  // none. Expired entries met on the way are removed.
+  DomainStateMap::iterator FindDynamicEntry(
+      const std::string& canonicalized_host,
+      size_t end_offset,
+      size_t* offset);
+
   // The set of hosts that have enabled TransportSecurity.
-  std::map<std::string, DomainState> enabled_hosts_;
+  DomainStateMap enabled_hosts_;
 
   // Extra entries, provided by the user at run-time, to treat as if they
   // were static.
-  std::map<std::string, DomainState> forced_hosts_;
+  DomainStateMap forced_hosts_;
 
   Delegate* delegate_;
 
@@ -410,6 +410,62 @@ TEST_F(TransportSecurityStateTest, SubdomainMatches) {
   EXPECT_FALSE(state.GetDomainState("com", true, &domain_state));
 }
 
+TEST_F(TransportSecurityStateTest, ShouldUpgradeToSSL) {
+  TransportSecurityState state;
+  TransportSecurityState::DomainState domain_state;
+  const base::Time current_time(base::Time::Now());
+  const base::Time expiry = current_time + base::TimeDelta::FromSeconds(1000);
+
+  // Preloaded entries.
+  EXPECT_TRUE(state.ShouldUpgradeToSSL("www.paypal.com", false));
+  EXPECT_FALSE(state.ShouldUpgradeToSSL("a.www.paypal.com", false));
+  EXPECT_TRUE(state.ShouldUpgradeToSSL("foo.mail.google.com", false));
+  // Pinned, but not HSTS.
+  EXPECT_FALSE(state.ShouldUpgradeToSSL("www.google.com", false));
+  // SNI-only entries.
+  EXPECT_FALSE(state.ShouldUpgradeToSSL("gmail.com", false));
+  EXPECT_TRUE(state.ShouldUpgradeToSSL("gmail.com", true));
+
+  // Dynamic entries.
+  EXPECT_FALSE(state.ShouldUpgradeToSSL("yahoo.com", true));
+  domain_state.upgrade_expiry = expiry;
+  domain_state.include_subdomains = true;
+  state.EnableHost("yahoo.com", domain_state);
+  EXPECT_TRUE(state.ShouldUpgradeToSSL("yahoo.com", true));
+  EXPECT_TRUE(state.ShouldUpgradeToSSL("foo.bar.yahoo.com", true));
+  EXPECT_FALSE(state.ShouldUpgradeToSSL("com", true));
+
+  domain_state.upgrade_mode = TransportSecurityState::DomainState::MODE_DEFAULT;
+  domain_state.include_subdomains = false;
+  state.EnableHost("foo.yahoo.com", domain_state);
+  EXPECT_FALSE(state.ShouldUpgradeToSSL("foo.yahoo.com", true));
+  EXPECT_TRUE(state.ShouldUpgradeToSSL("bar.yahoo.com", true));
+
+  // A dynamic entry for a subdomain of a preloaded one takes precedence, but
+  // one for the preloaded name itself does not.
+  state.EnableHost("foo.accounts.google.com", domain_state);
+  EXPECT_FALSE(state.ShouldUpgradeToSSL("foo.accounts.google.com", true));
+  state.EnableHost("accounts.google.com", domain_state);
+  EXPECT_TRUE(state.ShouldUpgradeToSSL("accounts.google.com", true));
+  EXPECT_TRUE(state.ShouldUpgradeToSSL("bar.accounts.google.com", true));
+
+  // The answers agree with those of GetDomainState.
+  const char* const kHosts[] = {
+    "www.paypal.com", "paypal.com", "mail.google.com", "gmail.com",
+    "yahoo.com", "foo.yahoo.com", "a.foo.yahoo.com", "foo.accounts.google.com",
+    "example.com",
+  };
+  for (size_t i = 0; i < arraysize(kHosts); ++i) {
+    for (int sni = 0; sni < 2; ++sni) {
+      bool expected =
+          state.GetDomainState(kHosts[i], sni != 0, &domain_state) &&
+          domain_state.ShouldRedirectHTTPToHTTPS();
+      EXPECT_EQ(expected, state.ShouldUpgradeToSSL(kHosts[i], sni != 0))
+          << kHosts[i];
+    }
+  }
+}
+
 TEST_F(TransportSecurityStateTest, DeleteSince) {
   TransportSecurityState state;
   TransportSecurityState::DomainState domain_state;
@@ -108,6 +108,9 @@ typedef std::vector<CookieMonster::CanonicalCookie*> CanonicalCookieVector;
 // will update it again.
 const int kDefaultAccessUpdateThresholdSeconds = 60;
 
+// Number of domains whose keys GetKey() remembers before starting over.
+const size_t kMaxKeyCacheSize = 1000;
+
 // Comparator to sort cookies from highest creation date to lowest
 // creation date.
 struct OrderByCreationTimeDesc {
@@ -2162,13 +2165,26 @@ int CookieMonster::GarbageCollectDeleteList(
 // be worth it, but is still too much trouble to solve what is currently a
 // non-problem).
 std::string CookieMonster::GetKey(const std::string& domain) const {
+  {
+    base::AutoLock autolock(key_cache_lock_);
+    KeyCache::const_iterator it = key_cache_.find(domain);
+    if (it != key_cache_.end())
+      return it->second;
+  }
+
   std::string effective_domain(
       RegistryControlledDomainService::GetDomainAndRegistry(domain));
   if (effective_domain.empty())
     effective_domain = domain;
-
   if (!effective_domain.empty() && effective_domain[0] == '.')
-    return effective_domain.substr(1);
+    effective_domain.erase(0, 1);
+
+  base::AutoLock autolock(key_cache_lock_);
+  // The set of hosts a profile talks to is usually small, but don't let a
+  // page that touches many random subdomains grow the cache without bound.
+  if (key_cache_.size() >= kMaxKeyCacheSize)
+    key_cache_.clear();
+  key_cache_[domain] = effective_domain;
   return effective_domain;
 }
 
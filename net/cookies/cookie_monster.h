@@ -18,6 +18,7 @@
 
 #include "base/basictypes.h"
 #include "base/callback_forward.h"
+#include "base/flat_hash_map.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
@@ -549,6 +550,8 @@ class NET_EXPORT CookieMonster : public CookieStore {
 
   // Find the key (for lookup in cookies_) based on the given domain.
   // See comment on keys before the CookieMap typedef.
+  // Results are cached in |key_cache_|, as the registry lookup behind them
+  // costs more than the rest of a typical GetCookies().
   std::string GetKey(const std::string& domain) const;
 
   bool HasCookieableScheme(const GURL& url);
@@ -646,6 +649,12 @@ class NET_EXPORT CookieMonster : public CookieStore {
   // Lock for thread-safety
   base::Lock lock_;
 
+  // Maps the domains GetKey() has seen to their keys. It has a lock of its
+  // own, since GetKey() is called both with and without |lock_| held.
+  typedef base::flat_hash_map<std::string, std::string> KeyCache;
+  mutable KeyCache key_cache_;
+  mutable base::Lock key_cache_lock_;
+
   base::Time last_statistic_record_time_;
 
   bool keep_expired_cookies_;
@@ -223,6 +223,36 @@ TEST_F(CookieMonsterTest, TestGetCookiesWithInfo) {
   timer.Done();
 }
 
+// Repeatedly reads cookies for the subdomains of a few sites, in a store
+// that holds cookies for many others, as a long browsing session does.
+TEST_F(CookieMonsterTest, TestGetCookiesManySubdomains) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+  const int kNumSites = 100;
+  const int kNumSubdomains = 20;
+
+  SetCookieCallback setCookieCallback;
+  std::vector<GURL> gurls;
+  for (int i = 0; i < kNumSites; ++i) {
+    for (int j = 0; j < kNumSubdomains; ++j) {
+      GURL gurl(base::StringPrintf("https://s%02d.a%04d.izzle", j, i));
+      setCookieCallback.SetCookie(cm, gurl,
+                                  base::StringPrintf("a%02d=b", j));
+      if (i < 5)
+        gurls.push_back(gurl);
+    }
+  }
+
+  GetCookiesCallback getCookiesCallback;
+  PerfTimeLogger timer("Cookie_monster_query_many_subdomains");
+  for (int i = 0; i < kNumCookies / static_cast<int>(gurls.size()); ++i) {
+    for (std::vector<GURL>::const_iterator it = gurls.begin();
+         it != gurls.end(); ++it) {
+      getCookiesCallback.GetCookies(cm, *it);
+    }
+  }
+  timer.Done();
+}
+
 static int CountInString(const std::string& str, char c) {
   return std::count(str.begin(), str.end(), c);
 }
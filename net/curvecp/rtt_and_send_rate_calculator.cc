@@ -4,6 +4,8 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include "net/curvecp/rtt_and_send_rate_calculator.h"
 
 namespace net {
@@ -29,12 +31,17 @@ void RttAndSendRateCalculator::OnMessage(int32 rtt_us) {
 }
 
 void RttAndSendRateCalculator::OnTimeout() {
-  base::TimeDelta time_since_last_loss = last_sample_time_ - last_loss_time_;
-  if (time_since_last_loss.InMilliseconds() < 4 * rtt_timeout_)
+  // Timeouts come without a sample, so |last_sample_time_| may be long gone.
+  base::TimeTicks now = base::TimeTicks::Now();
+  base::TimeDelta time_since_last_loss = now - last_loss_time_;
+  if (time_since_last_loss.InMicroseconds() < 4 * rtt_timeout_)
     return;
-  send_rate_ *= 2;
-  last_loss_time_ = last_sample_time_;
-  last_edge_time_ = last_sample_time_;
+  // Halve the rate, but never wait more than a second between sends, which
+  // is also where AdjustSendRate() restarts from.
+  send_rate_ = std::min(2 * send_rate_,
+                        static_cast<int32>(base::Time::kMicrosecondsPerSecond));
+  last_loss_time_ = now;
+  last_edge_time_ = now;
 }
 
 // Updates RTT
@@ -4,6 +4,8 @@
 
 #include "net/disk_cache/backend_impl.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/file_path.h"
@@ -28,6 +30,7 @@
 #include "net/disk_cache/file.h"
 #include "net/disk_cache/hash.h"
 #include "net/disk_cache/mem_backend_impl.h"
+#include "net/disk_cache/write_batch.h"
 
 // This has to be defined before including histogram_macros.h from this file.
 #define NET_DISK_CACHE_BACKEND_IMPL_CC_
@@ -52,6 +55,20 @@ const int kDefaultCacheSize = 80 * 1024 * 1024;
 // Avoid trimming the cache for the first 5 minutes (10 timer ticks).
 const int kTrimDelay = 10;
 
+// Limits for the closed entries that are kept open to write their data in a
+// batch (see kBatchWrites): how many, how much data, and for how long.
+const size_t kMaxBatchedEntries = 64;
+const int kMaxBatchedBytes = 512 * 1024;
+const int kBatchDelayMs = 200;
+
+// The entries opened early by the previous session are read this long after
+// startup, a few at a time, while the cache is idle.
+const int kPrefetchDelayMs = 5000;
+const int kPrefetchBatchSize = 8;
+
+// Only the streams up to this size are prefetched.
+const int kMaxPrefetchSize = 16 * 1024;
+
 int DesiredIndexTableLen(int32 storage_size) {
   if (storage_size <= k64kEntriesStore)
     return kBaseTableLen;
@@ -75,6 +92,24 @@ size_t GetIndexSize(int table_len) {
   return sizeof(disk_cache::IndexHeader) + table_size;
 }
 
+// Returns the size of the index file, including the hash tags.
+size_t GetIndexSizeWithTags(int table_len) {
+  return GetIndexSize(table_len) + sizeof(uint32) * table_len;
+}
+
+// Returns the size of the index file, including the hash tags and the
+// frequency sketch.
+size_t GetFullIndexSize(int table_len) {
+  int sketch_size = disk_cache::FrequencySketch::GetStorageSize(table_len);
+  return GetIndexSizeWithTags(table_len) + sizeof(uint32) * sketch_size;
+}
+
+// Returns the bit that stands for |hash| on the tags of its bucket. The bucket
+// is selected by the low bits of the hash, so the tag uses the high ones.
+uint32 HashTag(uint32 hash) {
+  return 1 << (hash >> 27);
+}
+
 // ------------------------------------------------------------------------
 
 // Returns a fully qualified name from path and name, using a given name prefix
@@ -150,7 +185,26 @@ bool InitExperiment(disk_cache::IndexHeader* header) {
     return false;
   }
 
-  header->experiment = disk_cache::NO_EXPERIMENT;
+  if (!base::FieldTrialList::TrialExists("DiskCacheEviction")) {
+    header->experiment = disk_cache::NO_EXPERIMENT;
+    return true;
+  }
+
+  // A cache stays in the group that it joined first, so that each group only
+  // sees the effects of its own policy.
+  if (header->experiment == disk_cache::EXPERIMENT_SKETCH_CONTROL ||
+      header->experiment == disk_cache::EXPERIMENT_SKETCH) {
+    return true;
+  }
+
+  std::string group = base::FieldTrialList::FindFullName("DiskCacheEviction");
+  if (group == "FrequencySketch") {
+    header->experiment = disk_cache::EXPERIMENT_SKETCH;
+  } else if (group == "Control") {
+    header->experiment = disk_cache::EXPERIMENT_SKETCH_CONTROL;
+  } else {
+    header->experiment = disk_cache::NO_EXPERIMENT;
+  }
   return true;
 }
 
@@ -306,9 +360,11 @@ BackendImpl::BackendImpl(const FilePath& path,
                          net::NetLog* net_log)
     : ALLOW_THIS_IN_INITIALIZER_LIST(background_queue_(this, cache_thread)),
       path_(path),
+      hash_tags_(NULL),
       block_files_(path),
       mask_(0),
       max_size_(0),
+      batched_bytes_(0),
       up_ticks_(0),
       cache_type_(net::DISK_CACHE),
       uma_report_(0),
@@ -332,9 +388,11 @@ BackendImpl::BackendImpl(const FilePath& path,
                          net::NetLog* net_log)
     : ALLOW_THIS_IN_INITIALIZER_LIST(background_queue_(this, cache_thread)),
       path_(path),
+      hash_tags_(NULL),
       block_files_(path),
       mask_(mask),
       max_size_(0),
+      batched_bytes_(0),
       up_ticks_(0),
       cache_type_(net::DISK_CACHE),
       uma_report_(0),
@@ -450,6 +508,8 @@ int BackendImpl::SyncInit() {
     return net::ERR_FAILED;
   }
 
+  InitHashTags();
+
   if (create_files || !data_->header.num_entries)
     ReportError(ERR_CACHE_CREATED);
 
@@ -457,6 +517,10 @@ int BackendImpl::SyncInit() {
       cache_type_ == net::DISK_CACHE && !InitExperiment(&data_->header))
     return net::ERR_FAILED;
 
+  if (data_->header.experiment == EXPERIMENT_SKETCH)
+    user_flags_ |= kFrequencySketch;
+  InitFrequencySketch();
+
   // We don't care if the value overflows. The only thing we care about is that
   // the id cannot be zero, because that value is used as "not dirty".
   // Increasing the value once per second gives us many years before we start
@@ -464,6 +528,7 @@ int BackendImpl::SyncInit() {
   data_->header.this_id++;
   if (!data_->header.this_id)
     data_->header.this_id++;
+  data_->header.tags_id = data_->header.this_id;
 
   if (data_->header.crash) {
     ReportError(ERR_PREVIOUS_CRASH);
@@ -488,11 +553,26 @@ int BackendImpl::SyncInit() {
   if (!stats_.Init(this, &data_->header.stats))
     return net::ERR_FAILED;
 
+  if (!startup_list_.Init(this, &data_->header.startup_list))
+    return net::ERR_FAILED;
+
   disabled_ = !rankings_.Init(this, new_eviction_);
 
   if (!disabled_ && !(user_flags_ & kNoRandom) && base::RandInt(0, 99) < 2)
     rankings_.SelfCheck();  // Ignore return value for now.
 
+  if (!disabled_) {
+    // The unit tests don't wait for the prefetch.
+    base::Closure task =
+        base::Bind(&BackendImpl::PrefetchStartupEntries, GetWeakPtr());
+    if (user_flags_ & kNoRandom) {
+      MessageLoop::current()->PostTask(FROM_HERE, task);
+    } else {
+      MessageLoop::current()->PostDelayedTask(
+          FROM_HERE, task, TimeDelta::FromMilliseconds(kPrefetchDelayMs));
+    }
+  }
+
 #if defined(STRESS_CACHE_EXTENDED_VALIDATION)
   trace_object_->EnableTracing(false);
   int sc = SelfCheck();
@@ -506,11 +586,14 @@ int BackendImpl::SyncInit() {
 
 void BackendImpl::CleanupCache() {
   Trace("Backend Cleanup");
+  FlushBatchedEntries();
   eviction_.Stop();
   timer_.reset();
 
   if (init_) {
     stats_.Store();
+    if (!read_only_)
+      startup_list_.Store();
     if (data_)
       data_->header.crash = 0;
 
@@ -566,6 +649,7 @@ int BackendImpl::SyncDoomAllEntries() {
   // This is not really an error, but it is an interesting condition.
   ReportError(ERR_CACHE_DOOMED);
   stats_.OnEvent(Stats::DOOM_CACHE);
+  FlushBatchedEntries();
   if (!num_refs_) {
     RestartCache(false);
     return disabled_ ? net::ERR_FAILED : net::OK;
@@ -671,6 +755,37 @@ void BackendImpl::SyncOnExternalCacheHit(const std::string& key) {
   }
 }
 
+void BackendImpl::SyncCloseEntry(EntryImpl* entry) {
+  if (!(user_flags_ & kBatchWrites) || disabled_ || read_only_ ||
+      !entry->CanBatchWrites()) {
+    entry->Release();
+    return;
+  }
+
+  if (std::find(batched_entries_.begin(), batched_entries_.end(), entry) !=
+      batched_entries_.end()) {
+    // The entry was opened again before the batch was written, so it already
+    // holds the reference that we need.
+    entry->Release();
+    return;
+  }
+
+  // The reference of the user is kept until the data is written.
+  if (batched_entries_.empty()) {
+    MessageLoop::current()->PostDelayedTask(
+        FROM_HERE, base::Bind(&BackendImpl::FlushBatchedEntries, GetWeakPtr()),
+        TimeDelta::FromMilliseconds(kBatchDelayMs));
+  }
+  batched_entries_.push_back(entry);
+  batched_bytes_ += entry->GetDataSize(0) + entry->GetDataSize(1) +
+                    entry->GetDataSize(2);
+
+  if (batched_entries_.size() >= kMaxBatchedEntries ||
+      batched_bytes_ >= kMaxBatchedBytes) {
+    FlushBatchedEntries();
+  }
+}
+
 EntryImpl* BackendImpl::OpenEntryImpl(const std::string& key) {
   if (disabled_)
     return NULL;
@@ -679,6 +794,11 @@ EntryImpl* BackendImpl::OpenEntryImpl(const std::string& key) {
   uint32 hash = Hash(key);
   Trace("Open hash 0x%x", hash);
 
+  // Both hits and misses count: keys that keep coming back after they are
+  // evicted should be kept next time.
+  if (sketch_.is_initialized())
+    sketch_.Increment(hash);
+
   bool error;
   EntryImpl* cache_entry = MatchEntry(key, hash, false, Addr(), &error);
   if (!cache_entry) {
@@ -695,6 +815,8 @@ EntryImpl* BackendImpl::OpenEntryImpl(const std::string& key) {
 
   eviction_.OnOpenEntry(cache_entry);
   entry_count_++;
+  if (!read_only_)
+    startup_list_.OnOpenEntry(hash, cache_entry->entry()->address());
 
   CACHE_UMA(AGE_MS, "OpenTime", 0, start);
   stats_.OnEvent(Stats::OPEN_HIT);
@@ -783,6 +905,7 @@ EntryImpl* BackendImpl::CreateEntryImpl(const std::string& key) {
   entry_count_++;
 
   // Link this entry through the index.
+  AddHashTag(hash);
   if (parent.get()) {
     parent->SetNextAddress(entry_address);
   } else {
@@ -922,6 +1045,7 @@ void BackendImpl::RecoveredEntry(CacheRankingsBlock* rankings) {
   if (data_->table[hash & mask_])
     return;
 
+  AddHashTag(hash);
   data_->table[hash & mask_] = address.value();
 }
 
@@ -1176,6 +1300,10 @@ void BackendImpl::OnEvent(Stats::Counters an_event) {
   stats_.OnEvent(an_event);
 }
 
+void BackendImpl::OnOperation(Stats::Counters ops, base::TimeDelta latency) {
+  stats_.OnOperation(ops, latency);
+}
+
 void BackendImpl::OnRead(int32 bytes) {
   DCHECK_GE(bytes, 0);
   byte_count_ += bytes;
@@ -1423,7 +1551,7 @@ bool BackendImpl::CreateBackingStore(disk_cache::File* file) {
   if (!file->Write(&header, sizeof(header), 0))
     return false;
 
-  return file->SetLength(GetIndexSize(header.table_len));
+  return file->SetLength(GetFullIndexSize(header.table_len));
 }
 
 bool BackendImpl::InitBackingStore(bool* file_created) {
@@ -1464,9 +1592,78 @@ bool BackendImpl::InitBackingStore(bool* file_created) {
     return false;
   }
 
+  // Files created by older versions don't have room for the hash tags or the
+  // frequency sketch. The file cannot be extended while it is mapped.
+  int table_len = data_->header.table_len;
+  if (table_len && index_->GetLength() >= GetIndexSize(table_len) &&
+      index_->GetLength() < GetFullIndexSize(table_len)) {
+    index_ = NULL;
+    data_ = NULL;
+    flags = base::PLATFORM_FILE_OPEN | base::PLATFORM_FILE_READ |
+            base::PLATFORM_FILE_WRITE | base::PLATFORM_FILE_EXCLUSIVE_WRITE;
+    file = new disk_cache::File(
+        base::CreatePlatformFile(index_name, flags, NULL, NULL));
+    if (!file->IsValid() || !file->SetLength(GetFullIndexSize(table_len))) {
+      LOG(ERROR) << "Unable to add hash tags to the Index file";
+    }
+    file = NULL;
+
+    index_ = new MappedFile();
+    data_ = reinterpret_cast<Index*>(index_->Init(index_name, 0));
+    if (!data_) {
+      LOG(ERROR) << "Unable to map Index file";
+      return false;
+    }
+  }
+
   return true;
 }
 
+void BackendImpl::InitHashTags() {
+  int table_len = data_->header.table_len;
+  if (index_->GetLength() < GetIndexSizeWithTags(table_len)) {
+    hash_tags_ = NULL;
+    return;
+  }
+
+  hash_tags_ = reinterpret_cast<uint32*>(&data_->table[table_len]);
+
+  // The tags may be stale if the last run crashed or if a version that
+  // doesn't know about them used the files.
+  if (data_->header.tags_id != data_->header.this_id || data_->header.crash)
+    memset(hash_tags_, 0, sizeof(uint32) * table_len);
+}
+
+void BackendImpl::AddHashTag(uint32 hash) {
+  if (!hash_tags_)
+    return;
+
+  // If the tags of a bucket that has entries are not known, adding one more
+  // doesn't make them known.
+  uint32* tags = &hash_tags_[hash & mask_];
+  if (!data_->table[hash & mask_])
+    *tags = HashTag(hash);
+  else if (*tags)
+    *tags |= HashTag(hash);
+}
+
+void BackendImpl::InitFrequencySketch() {
+  int table_len = data_->header.table_len;
+  if (!(user_flags_ & kFrequencySketch) ||
+      index_->GetLength() < GetFullIndexSize(table_len)) {
+    sketch_.Reset();
+    return;
+  }
+
+  uint32* storage =
+      reinterpret_cast<uint32*>(&data_->table[table_len]) + table_len;
+  sketch_.Init(storage, table_len);
+
+  // Start over if a version that doesn't know about the sketch used the files.
+  if (data_->header.tags_id != data_->header.this_id)
+    sketch_.Clear();
+}
+
 // The maximum cache size will be either set explicitly by the caller, or
 // calculated by this code.
 void BackendImpl::AdjustMaxCacheSize(int table_len) {
@@ -1502,6 +1699,106 @@ void BackendImpl::AdjustMaxCacheSize(int table_len) {
     max_size_= current_max_size;
 }
 
+void BackendImpl::FlushBatchedEntries() {
+  if (batched_entries_.empty())
+    return;
+
+  std::vector<EntryImpl*> entries;
+  entries.swap(batched_entries_);
+  batched_bytes_ = 0;
+
+  // The blocks for the data are created now, in order, so the data of these
+  // entries ends up next to each other on the block files.
+  WriteBatch batch;
+  std::vector<EntryImpl*> failed;
+  for (size_t i = 0; i < entries.size(); i++) {
+    if (!entries[i]->FlushToBatch(&batch))
+      failed.push_back(entries[i]);
+  }
+  if (!batch.Flush()) {
+    LOG(ERROR) << "Failed to save batched user data";
+    failed = entries;
+  }
+  CACHE_UMA(COUNTS_10000, "BatchedWrites", 0, batch.num_writes());
+
+  // The data of these entries cannot be trusted.
+  for (size_t i = 0; i < failed.size(); i++)
+    failed[i]->DoomImpl();
+
+  for (size_t i = 0; i < entries.size(); i++)
+    entries[i]->Release();
+}
+
+void BackendImpl::PrefetchStartupEntries() {
+  if (disabled_)
+    return;
+
+  // Don't compete with the user for the disk.
+  if (num_pending_io_ || user_load_) {
+    MessageLoop::current()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&BackendImpl::PrefetchStartupEntries, GetWeakPtr()),
+        TimeDelta::FromMilliseconds(kPrefetchDelayMs));
+    return;
+  }
+
+  StartupList::Entry entry;
+  for (int i = 0; i < kPrefetchBatchSize; i++) {
+    if (!startup_list_.GetNextPreviousEntry(&entry))
+      return;
+    if (PrefetchEntry(entry.hash, Addr(entry.address)))
+      stats_.OnEvent(Stats::STARTUP_PREFETCH);
+  }
+
+  // Let other work run before the next batch.
+  MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&BackendImpl::PrefetchStartupEntries, GetWeakPtr()));
+}
+
+bool BackendImpl::PrefetchEntry(uint32 hash, Addr address) {
+  if (!address.SanityCheckForEntry() ||
+      open_entries_.find(address.value()) != open_entries_.end()) {
+    return false;
+  }
+
+  MappedFile* file = File(address);
+  if (!file)
+    return false;
+
+  // The block may belong to a different entry by now.
+  EntryStore store;
+  size_t offset = address.start_block() * address.BlockSize() +
+                  kBlockHeaderSize;
+  if (!file->Read(&store, sizeof(store), offset) || store.hash != hash ||
+      store.state != ENTRY_NORMAL) {
+    return false;
+  }
+
+  // The headers are stored on the first stream. The data read here is thrown
+  // away: what matters is that it is in the system cache when it is needed.
+  for (int i = 0; i < 2; i++) {
+    Addr data_address(store.data_addr[i]);
+    if (!data_address.is_initialized() || data_address.is_separate_file() ||
+        !data_address.SanityCheck() || store.data_size[i] <= 0 ||
+        store.data_size[i] > kMaxPrefetchSize) {
+      continue;
+    }
+
+    file = File(data_address);
+    if (!file)
+      continue;
+
+    int size = std::min(store.data_size[i],
+                        data_address.num_blocks() * data_address.BlockSize());
+    scoped_array<char> buffer(new char[size]);
+    offset = data_address.start_block() * data_address.BlockSize() +
+             kBlockHeaderSize;
+    file->Read(buffer.get(), size, offset);
+  }
+  return true;
+}
+
 void BackendImpl::RestartCache(bool failure) {
   int64 errors = stats_.GetCounter(Stats::FATAL_ERROR);
   int64 full_dooms = stats_.GetCounter(Stats::DOOM_CACHE);
@@ -1541,6 +1838,8 @@ void BackendImpl::PrepareForRestart() {
   data_->header.crash = 0;
   index_ = NULL;
   data_ = NULL;
+  hash_tags_ = NULL;
+  sketch_.Reset();
   block_files_.CloseFiles();
   rankings_.Reset();
   init_ = false;
@@ -1634,6 +1933,16 @@ EntryImpl* BackendImpl::MatchEntry(const std::string& key, uint32 hash,
   std::set<CacheAddr> visited;
   *match_error = false;
 
+  // Most of the keys that are not stored don't match the tags of the bucket,
+  // and we don't have to read any entry to find that out.
+  uint32 tags = hash_tags_ ? hash_tags_[hash & mask_] : 0;
+  if (!find_parent && tags && !(tags & HashTag(hash)))
+    return NULL;
+
+  // Tags of the entries found so far, to update those of the bucket after
+  // walking the whole list.
+  tags = 0;
+
   for (;;) {
     if (disabled_)
       break;
@@ -1650,6 +1959,8 @@ EntryImpl* BackendImpl::MatchEntry(const std::string& key, uint32 hash,
     if (!address.is_initialized()) {
       if (find_parent)
         found = true;
+      if (hash_tags_)
+        hash_tags_[hash & mask_] = tags;
       break;
     }
 
@@ -1685,10 +1996,12 @@ EntryImpl* BackendImpl::MatchEntry(const std::string& key, uint32 hash,
       // Restart the search.
       address.set_value(data_->table[hash & mask_]);
       visited.clear();
+      tags = 0;
       continue;
     }
 
     DCHECK_EQ(hash & mask_, cache_entry->entry()->Data()->hash & mask_);
+    tags |= HashTag(cache_entry->entry()->Data()->hash);
     if (cache_entry->IsSameEntry(key, hash)) {
       if (!cache_entry->Update())
         cache_entry = NULL;
@@ -2003,10 +2316,16 @@ void BackendImpl::ReportStats() {
     return;
 
   CACHE_UMA(HOURS, "UseTime", 0, static_cast<int>(use_hours));
-  CACHE_UMA(PERCENTAGE, "HitRatio", 0, stats_.GetHitRatio());
+  // The hit ratio and trim rate tell how well each eviction policy works.
+  int experiment = data_->header.experiment;
+  CACHE_UMA(PERCENTAGE, "HitRatio", experiment, stats_.GetHitRatio());
 
   int64 trim_rate = stats_.GetCounter(Stats::TRIM_ENTRY) / use_hours;
-  CACHE_UMA(COUNTS, "TrimRate", 0, static_cast<int>(trim_rate));
+  CACHE_UMA(COUNTS, "TrimRate", experiment, static_cast<int>(trim_rate));
+  if (user_flags_ & kFrequencySketch) {
+    int64 keep_rate = stats_.GetCounter(Stats::KEEP_ENTRY) / use_hours;
+    CACHE_UMA(COUNTS, "KeepRate", experiment, static_cast<int>(keep_rate));
+  }
 
   int avg_size = data_->header.num_bytes / GetEntryCount();
   CACHE_UMA(COUNTS, "EntrySize", 0, avg_size);
@@ -2033,6 +2352,7 @@ void BackendImpl::ReportStats() {
 
   stats_.ResetRatios();
   stats_.SetCounter(Stats::TRIM_ENTRY, 0);
+  stats_.SetCounter(Stats::KEEP_ENTRY, 0);
 
   if (cache_type_ == net::DISK_CACHE)
     block_files_.ReportStats();
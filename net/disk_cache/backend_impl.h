@@ -8,14 +8,18 @@
 #define NET_DISK_CACHE_BACKEND_IMPL_H_
 #pragma once
 
+#include <vector>
+
 #include "base/file_path.h"
 #include "base/hash_tables.h"
 #include "base/timer.h"
 #include "net/disk_cache/block_files.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/eviction.h"
+#include "net/disk_cache/frequency_sketch.h"
 #include "net/disk_cache/in_flight_backend_io.h"
 #include "net/disk_cache/rankings.h"
+#include "net/disk_cache/startup_list.h"
 #include "net/disk_cache/stats.h"
 #include "net/disk_cache/stress_support.h"
 #include "net/disk_cache/trace.h"
@@ -35,7 +39,9 @@ enum BackendFlags {
   kNewEviction = 1 << 4,        // Use of new eviction was specified.
   kNoRandom = 1 << 5,           // Don't add randomness to the behavior.
   kNoLoadProtection = 1 << 6,   // Don't act conservatively under load.
-  kNoBuffering = 1 << 7         // Disable extended IO buffering.
+  kNoBuffering = 1 << 7,        // Disable extended IO buffering.
+  kBatchWrites = 1 << 8,        // Write the data of small entries in batches.
+  kFrequencySketch = 1 << 9     // Keep frequently used entries on eviction.
 };
 
 // This class implements the Backend interface. An object of this
@@ -81,6 +87,7 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   int SyncOpenPrevEntry(void** iter, Entry** prev_entry);
   void SyncEndEnumeration(void* iter);
   void SyncOnExternalCacheHit(const std::string& key);
+  void SyncCloseEntry(EntryImpl* entry);
 
   // Open or create an entry for the given |key| or |iter|.
   EntryImpl* OpenEntryImpl(const std::string& key);
@@ -207,6 +214,9 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   // Called when an interesting event should be logged (counted).
   void OnEvent(Stats::Counters an_event);
 
+  // Called when an operation counted by |ops| completes on the cache thread.
+  void OnOperation(Stats::Counters ops, base::TimeDelta latency);
+
   // Keeps track of payload access (doesn't include metadata).
   void OnRead(int bytes);
   void OnWrite(int bytes);
@@ -281,6 +291,30 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   bool InitBackingStore(bool* file_created);
   void AdjustMaxCacheSize(int table_len);
 
+  // Sets up the hash tags that follow the index table (see disk_format.h),
+  // discarding them if they cannot be trusted.
+  void InitHashTags();
+
+  // Updates the tags of the bucket of |hash| for an entry that is about to be
+  // linked to it.
+  void AddHashTag(uint32 hash);
+
+  // Sets up the frequency sketch that follows the hash tags, if it is in use.
+  void InitFrequencySketch();
+
+  // Writes the data of the entries that SyncCloseEntry() kept open, and
+  // releases them.
+  void FlushBatchedEntries();
+
+  // Reads from disk a few of the entries opened early by the previous
+  // session, and posts a task to continue with the rest.
+  void PrefetchStartupEntries();
+
+  // Reads the entry at |address| and its small streams, so that opening it
+  // doesn't have to wait for the disk. Returns false if the entry is not there
+  // anymore, or is already open.
+  bool PrefetchEntry(uint32 hash, Addr address);
+
   // Deletes the cache and starts again.
   void RestartCache(bool failure);
   void PrepareForRestart();
@@ -352,6 +386,8 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   scoped_refptr<MappedFile> index_;  // The main cache index.
   FilePath path_;  // Path to the folder used as backing storage.
   Index* data_;  // Pointer to the index data.
+  uint32* hash_tags_;  // Tags of the index buckets (may be NULL).
+  FrequencySketch sketch_;  // Recent accesses, for the eviction policy.
   BlockFiles block_files_;  // Set of files used to store all data.
   Rankings rankings_;  // Rankings to be able to trim the cache.
   uint32 mask_;  // Binary mask to map a hash to the hash table.
@@ -364,6 +400,8 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   int entry_count_;  // Number of entries accessed lately.
   int byte_count_;  // Number of bytes read/written lately.
   int buffer_bytes_;  // Total size of the temporary entries' buffers.
+  std::vector<EntryImpl*> batched_entries_;  // Closed, but not written yet.
+  int batched_bytes_;  // Size of the data of |batched_entries_|.
   int up_ticks_;  // The number of timer ticks received (OnStatsTimer).
   net::CacheType cache_type_;
   int uma_report_;  // Controls transmission of UMA data.
@@ -380,6 +418,7 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   net::NetLog* net_log_;
 
   Stats stats_;  // Usage statistics.
+  StartupList startup_list_;  // Entries opened early, to prefetch next time.
   scoped_ptr<base::RepeatingTimer<BackendImpl> > timer_;  // Usage timer.
   base::WaitableEvent done_;  // Signals the end of background work.
   scoped_refptr<TraceObject> trace_object_;  // Initializes internal tracing.
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <map>
+
 #include "base/basictypes.h"
 #include "base/file_util.h"
 #include "base/string_util.h"
@@ -651,6 +653,274 @@ TEST_F(DiskCacheBackendTest, NewEvictionTrim) {
   entry->Close();
 }
 
+// Tests that entries that are closed while their data waits to be written in
+// a batch can be used again, and that the data makes it to disk.
+TEST_F(DiskCacheBackendTest, BatchWrites) {
+  SetDirectMode();
+  InitCache();
+  cache_impl_->SetFlags(disk_cache::kBatchWrites);
+
+  const int kSize = 1000;
+  scoped_refptr<net::IOBuffer> buffer1(new net::IOBuffer(kSize));
+  scoped_refptr<net::IOBuffer> buffer2(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer1->data(), kSize, false);
+
+  const int kNumEntries = 10;
+  disk_cache::Entry* entries[kNumEntries];
+  for (int i = 0; i < kNumEntries; i++) {
+    std::string name(StringPrintf("Key %d", i));
+    ASSERT_EQ(net::OK, CreateEntry(name, &entries[i]));
+    EXPECT_EQ(100, WriteData(entries[i], 0, 0, buffer1, 100, false));
+    EXPECT_EQ(kSize - i, WriteData(entries[i], 1, 0, buffer1, kSize - i,
+                                   false));
+    entries[i]->Close();
+  }
+
+  // The entry is still in memory, so opening it returns the same object.
+  disk_cache::Entry* entry;
+  ASSERT_EQ(net::OK, OpenEntry("Key 3", &entry));
+  EXPECT_TRUE(entries[3] == entry);
+  EXPECT_EQ(kSize - 3, ReadData(entry, 1, 0, buffer2, kSize));
+  EXPECT_EQ(0, memcmp(buffer1->data(), buffer2->data(), kSize - 3));
+  entry->Close();
+
+  // Restart the cache, so that the data has to be read from disk.
+  delete cache_;
+  cache_ = NULL;
+  cache_impl_ = NULL;
+  DisableFirstCleanup();
+  InitCache();
+
+  EXPECT_EQ(kNumEntries, cache_->GetEntryCount());
+  for (int i = 0; i < kNumEntries; i++) {
+    std::string name(StringPrintf("Key %d", i));
+    ASSERT_EQ(net::OK, OpenEntry(name, &entry));
+    EXPECT_EQ(100, ReadData(entry, 0, 0, buffer2, kSize));
+    EXPECT_EQ(0, memcmp(buffer1->data(), buffer2->data(), 100));
+    EXPECT_EQ(kSize - i, ReadData(entry, 1, 0, buffer2, kSize));
+    EXPECT_EQ(0, memcmp(buffer1->data(), buffer2->data(), kSize - i));
+    entry->Close();
+  }
+}
+
+// Tests that entries waiting to be written in a batch don't get in the way of
+// dooming the cache.
+TEST_F(DiskCacheBackendTest, BatchWritesDoomAll) {
+  SetDirectMode();
+  InitCache();
+  cache_impl_->SetFlags(disk_cache::kBatchWrites);
+
+  const int kSize = 200;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer->data(), kSize, false);
+
+  disk_cache::Entry* entry;
+  for (int i = 0; i < 5; i++) {
+    std::string name(StringPrintf("Key %d", i));
+    ASSERT_EQ(net::OK, CreateEntry(name, &entry));
+    EXPECT_EQ(kSize, WriteData(entry, 1, 0, buffer, kSize, false));
+    entry->Close();
+  }
+  ASSERT_EQ(net::OK, DoomAllEntries());
+  EXPECT_EQ(0, cache_->GetEntryCount());
+  EXPECT_NE(net::OK, OpenEntry("Key 0", &entry));
+}
+
+// Tests that the hash tags of the index don't hide any entry, whether they are
+// kept from the last run, discarded after a crash or missing from the file.
+TEST_F(DiskCacheBackendTest, HashTags) {
+  // Work with a tiny index table (16 entries), to have long lists.
+  SetMask(0xf);
+  SetMaxSize(0x100000);
+  InitCache();
+
+  const int kNumEntries = 100;
+  disk_cache::Entry* entry;
+  for (int i = 0; i < kNumEntries; i++) {
+    std::string name(StringPrintf("Key %d", i));
+    ASSERT_EQ(net::OK, CreateEntry(name, &entry));
+    entry->Close();
+  }
+
+  for (int run = 0; run < 3; run++) {
+    if (run == 0) {
+      // Clean restart: the tags are kept.
+      delete cache_;
+      cache_ = NULL;
+      cache_impl_ = NULL;
+    } else if (run == 1) {
+      SimulateCrash();
+    } else {
+      // Remove the tags, as if the file was created by an older version.
+      delete cache_;
+      cache_ = NULL;
+      cache_impl_ = NULL;
+      base::PlatformFile file = base::CreatePlatformFile(
+          cache_path_.AppendASCII("index"),
+          base::PLATFORM_FILE_OPEN | base::PLATFORM_FILE_WRITE, NULL, NULL);
+      ASSERT_NE(base::kInvalidPlatformFileValue, file);
+      EXPECT_TRUE(base::TruncatePlatformFile(file,
+                                             sizeof(disk_cache::Index)));
+      base::ClosePlatformFile(file);
+    }
+    if (!cache_) {
+      DisableFirstCleanup();
+      InitCache();
+    }
+
+    EXPECT_EQ(kNumEntries, cache_->GetEntryCount());
+    for (int i = 0; i < kNumEntries; i++) {
+      std::string name(StringPrintf("Key %d", i));
+      ASSERT_EQ(net::OK, OpenEntry(name, &entry)) << run << " " << name;
+      entry->Close();
+      name = StringPrintf("Missing key %d", i);
+      EXPECT_NE(net::OK, OpenEntry(name, &entry)) << run << " " << name;
+    }
+  }
+
+  // The tags were added back to the file.
+  int64 index_size;
+  ASSERT_TRUE(file_util::GetFileSize(cache_path_.AppendASCII("index"),
+                                     &index_size));
+  EXPECT_LT(static_cast<int64>(sizeof(disk_cache::Index)), index_size);
+}
+
+// Uses one entry often, then fills the cache with entries that are used once,
+// opening each key before creating it as the HttpCache does. Returns true if
+// the first entry is still stored at the end.
+bool PopularEntrySurvives(const FilePath& path, uint32 flags) {
+  base::Thread cache_thread("CacheThread");
+  EXPECT_TRUE(cache_thread.StartWithOptions(
+                  base::Thread::Options(MessageLoop::TYPE_IO, 0)));
+  scoped_ptr<disk_cache::BackendImpl> cache(new disk_cache::BackendImpl(
+      path, cache_thread.message_loop_proxy(), NULL));
+  EXPECT_TRUE(cache->SetMaxSize(3 * 1024 * 1024));
+  if (flags & disk_cache::kNewEviction)
+    cache->SetNewEviction();
+  cache->SetFlags(flags | disk_cache::kNoRandom |
+                  disk_cache::kNoLoadProtection);
+  net::TestCompletionCallback cb;
+  EXPECT_EQ(net::OK, cb.GetResult(cache->Init(cb.callback())));
+
+  const int kSize = 10000;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer->data(), kSize, false);
+
+  disk_cache::Entry* entry;
+  EXPECT_EQ(net::OK, cb.GetResult(cache->CreateEntry("popular", &entry,
+                                                     cb.callback())));
+  entry->Close();
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(net::OK, cb.GetResult(cache->OpenEntry("popular", &entry,
+                                                     cb.callback())));
+    entry->Close();
+  }
+
+  for (int i = 0; i < 600; i++) {
+    std::string key = StringPrintf("one-off %d", i);
+    EXPECT_NE(net::OK, cb.GetResult(cache->OpenEntry(key, &entry,
+                                                     cb.callback())));
+    EXPECT_EQ(net::OK, cb.GetResult(cache->CreateEntry(key, &entry,
+                                                       cb.callback())));
+    int rv = entry->WriteData(1, 0, buffer, kSize, cb.callback(), false);
+    EXPECT_EQ(kSize, cb.GetResult(rv));
+    entry->Close();
+  }
+
+  int rv = cache->OpenEntry("popular", &entry, cb.callback());
+  if (cb.GetResult(rv) != net::OK)
+    return false;
+  entry->Close();
+  return true;
+}
+
+// Tests that the frequency sketch keeps entries that are used often.
+TEST_F(DiskCacheTest, FrequencySketchEviction) {
+  ASSERT_TRUE(CleanupCacheDir());
+  EXPECT_FALSE(PopularEntrySurvives(cache_path_, disk_cache::kNone));
+
+  ASSERT_TRUE(CleanupCacheDir());
+  EXPECT_TRUE(PopularEntrySurvives(cache_path_,
+                                   disk_cache::kFrequencySketch));
+
+  ASSERT_TRUE(CleanupCacheDir());
+  EXPECT_TRUE(PopularEntrySurvives(cache_path_, disk_cache::kNewEviction |
+                                                disk_cache::kFrequencySketch));
+}
+
+// Tests that the operations that go through the cache thread are counted,
+// together with their latency.
+TEST_F(DiskCacheBackendTest, OperationStats) {
+  InitCache();
+
+  const int kSize = 100;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer->data(), kSize, false);
+
+  disk_cache::Entry* entry;
+  ASSERT_EQ(net::OK, CreateEntry("the first key", &entry));
+  EXPECT_EQ(kSize, WriteData(entry, 1, 0, buffer, kSize, false));
+  EXPECT_EQ(kSize, WriteData(entry, 1, kSize, buffer, kSize, false));
+  EXPECT_EQ(kSize, ReadData(entry, 1, 0, buffer, kSize));
+  entry->Close();
+  ASSERT_EQ(net::OK, OpenEntry("the first key", &entry));
+  entry->Close();
+  EXPECT_NE(net::OK, OpenEntry("some other key", &entry));
+  FlushQueueForTest();
+
+  disk_cache::StatsItems stats;
+  cache_->GetStats(&stats);
+  std::map<std::string, std::string> values(stats.begin(), stats.end());
+  EXPECT_EQ("0x3", values["Open ops"]);
+  EXPECT_EQ("0x1", values["Read ops"]);
+  EXPECT_EQ("0x2", values["Write ops"]);
+  EXPECT_FALSE(values["Open time"].empty());
+}
+
+// Tests that the entries opened early by one session are read from disk when
+// the next one starts.
+TEST_F(DiskCacheBackendTest, StartupPrefetch) {
+  SetDirectMode();
+  InitCache();
+
+  const int kSize = 100;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer->data(), kSize, false);
+
+  disk_cache::Entry* entry;
+  for (int i = 0; i < 4; i++) {
+    ASSERT_EQ(net::OK, CreateEntry(StringPrintf("Key %d", i), &entry));
+    EXPECT_EQ(kSize, WriteData(entry, 0, 0, buffer, kSize, false));
+    entry->Close();
+  }
+
+  // Creating entries doesn't record them; opening them does.
+  for (int run = 0; run < 2; run++) {
+    delete cache_;
+    cache_ = NULL;
+    cache_impl_ = NULL;
+    DisableFirstCleanup();
+    InitCache();
+    FlushQueueForTest();
+    if (run)
+      break;
+
+    for (int i = 0; i < 3; i++) {
+      ASSERT_EQ(net::OK, OpenEntry(StringPrintf("Key %d", i), &entry));
+      entry->Close();
+    }
+
+    // This entry is not there when the next session starts.
+    ASSERT_EQ(net::OK, DoomEntry("Key 2"));
+    FlushQueueForTest();
+  }
+
+  disk_cache::StatsItems stats;
+  cache_->GetStats(&stats);
+  std::map<std::string, std::string> values(stats.begin(), stats.end());
+  EXPECT_EQ("0x2", values["Startup prefetch"]);
+}
+
 // Before looking for invalid entries, let's check a valid entry.
 void DiskCacheBackendTest::BackendValidEntry() {
   SetDirectMode();
@@ -138,6 +138,90 @@ bool TimeRead(int num_entries, disk_cache::Backend* cache,
   return (expected == helper.callbacks_called());
 }
 
+// Creates |num_entries| on the cache, with 200 bytes of metadata and up to
+// |max_data_len| bytes of data each. All the writes are synchronous.
+bool WriteEntries(int num_entries, int max_data_len,
+                  disk_cache::Backend* cache) {
+  const int kSize1 = 200;
+  scoped_refptr<net::IOBuffer> buffer1(new net::IOBuffer(kSize1));
+  scoped_refptr<net::IOBuffer> buffer2(new net::IOBuffer(max_data_len));
+
+  CacheTestFillBuffer(buffer1->data(), kSize1, false);
+  CacheTestFillBuffer(buffer2->data(), max_data_len, false);
+
+  for (int i = 0; i < num_entries; i++) {
+    disk_cache::Entry* cache_entry;
+    net::TestCompletionCallback cb;
+    int rv = cache->CreateEntry(GenerateKey(true), &cache_entry,
+                                cb.callback());
+    if (net::OK != cb.GetResult(rv))
+      return false;
+
+    int data_len = rand() % max_data_len + 1;
+    rv = cache_entry->WriteData(0, 0, buffer1, kSize1, cb.callback(), false);
+    if (kSize1 != cb.GetResult(rv))
+      return false;
+    rv = cache_entry->WriteData(1, 0, buffer2, data_len, cb.callback(), false);
+    if (data_len != cb.GetResult(rv))
+      return false;
+    cache_entry->Close();
+  }
+  return true;
+}
+
+// Measures writing many small entries (as a browser does for most of the
+// resources that it caches) with the given backend |flags|, including the
+// time that it takes for the data to reach the files.
+void TimeSmallEntries(const FilePath& path, uint32 flags,
+                      const char* message) {
+  base::Thread cache_thread("CacheThread");
+  ASSERT_TRUE(cache_thread.StartWithOptions(
+                  base::Thread::Options(MessageLoop::TYPE_IO, 0)));
+
+  disk_cache::BackendImpl* cache = new disk_cache::BackendImpl(
+      path, cache_thread.message_loop_proxy(), NULL);
+  cache->SetFlags(flags);
+  net::TestCompletionCallback cb;
+  ASSERT_EQ(net::OK, cb.GetResult(cache->Init(cb.callback())));
+
+  PerfTimeLogger timer(message);
+  EXPECT_TRUE(WriteEntries(2000, 2 * 1024, cache));
+  delete cache;
+  timer.Done();
+}
+
+// Measures looking up keys that are not stored, as the browser does for every
+// resource that is not in the cache. The index table is small enough to have
+// a few entries on every bucket.
+void TimeMisses(const FilePath& path) {
+  base::Thread cache_thread("CacheThread");
+  ASSERT_TRUE(cache_thread.StartWithOptions(
+                  base::Thread::Options(MessageLoop::TYPE_IO, 0)));
+
+  disk_cache::BackendImpl* cache = new disk_cache::BackendImpl(
+      path, 0xfff, cache_thread.message_loop_proxy(), NULL);
+  cache->SetMaxSize(50 * 1024 * 1024);
+  net::TestCompletionCallback cb;
+  ASSERT_EQ(net::OK, cb.GetResult(cache->Init(cb.callback())));
+
+  for (int i = 0; i < 8000; i++) {
+    disk_cache::Entry* cache_entry;
+    int rv = cache->CreateEntry(GenerateKey(true), &cache_entry,
+                                cb.callback());
+    ASSERT_EQ(net::OK, cb.GetResult(rv));
+    cache_entry->Close();
+  }
+
+  PerfTimeLogger timer("Look up missing keys");
+  for (int i = 0; i < 20000; i++) {
+    disk_cache::Entry* cache_entry;
+    int rv = cache->OpenEntry(GenerateKey(true), &cache_entry, cb.callback());
+    EXPECT_NE(net::OK, cb.GetResult(rv));
+  }
+  timer.Done();
+  delete cache;
+}
+
 int BlockSize() {
   // We can use form 1 to 4 blocks.
   return (rand() & 0x3) + 1;
@@ -206,6 +290,24 @@ TEST_F(DiskCacheTest, CacheBackendPerformance) {
   delete cache;
 }
 
+TEST_F(DiskCacheTest, SmallEntriesPerformance) {
+  int seed = static_cast<int>(Time::Now().ToInternalValue());
+  srand(seed);
+
+  ASSERT_TRUE(CleanupCacheDir());
+  TimeSmallEntries(cache_path_, disk_cache::kNone,
+                   "Write small disk cache entries");
+
+  ASSERT_TRUE(CleanupCacheDir());
+  TimeSmallEntries(cache_path_, disk_cache::kBatchWrites,
+                   "Write small disk cache entries (batched)");
+}
+
+TEST_F(DiskCacheTest, MissPerformance) {
+  ASSERT_TRUE(CleanupCacheDir());
+  TimeMisses(cache_path_);
+}
+
 // Creating and deleting "entries" on a block-file is something quite frequent
 // (after all, almost everything is stored on block files). The operation is
 // almost free when the file is empty, but can be expensive if the file gets
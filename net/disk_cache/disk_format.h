@@ -94,7 +94,9 @@ struct NET_EXPORT_PRIVATE IndexHeader {
   int32       crash;         // Signals a previous crash.
   int32       experiment;    // Id of an ongoing test.
   uint64      create_time;   // Creation time for this set of files.
-  int32       pad[52];
+  int32       tags_id;       // Value of this_id when the tags were valid.
+  CacheAddr   startup_list;  // Entries opened early by the last session.
+  int32       pad[50];
   LruData     lru;           // Eviction control data.
 };
 
@@ -105,6 +107,17 @@ struct Index {
                                        // by header.table_len.
 };
 
+// The table is followed by a set of hash tags, one uint32 per bucket: bit
+// (hash >> 27) is set for the hash of every entry stored on that bucket, so
+// most lookups for keys that are not stored can be answered without reading
+// the entries of the bucket. Zero means that the tags of the bucket are not
+// known. Files created by older versions don't have tags, and older versions
+// don't update them, so the tags are only trusted when header.tags_id is the
+// id of the previous run.
+//
+// The tags are followed by the storage of a FrequencySketch for table_len
+// entries, used by some eviction policies.
+
 // Main structure for an entry on the backing storage. If the key is longer than
 // what can be stored on this structure, it will be extended on consecutive
 // blocks (adding 256 bytes each time), up to 4 blocks (1024 - 32 - 1 chars).
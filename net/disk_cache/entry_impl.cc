@@ -16,6 +16,7 @@
 #include "net/disk_cache/histogram_macros.h"
 #include "net/disk_cache/net_log_parameters.h"
 #include "net/disk_cache/sparse_control.h"
+#include "net/disk_cache/write_batch.h"
 
 using base::Time;
 using base::TimeDelta;
@@ -561,6 +562,46 @@ bool EntryImpl::LeaveRankingsBehind() {
   return !node_.Data()->contents;
 }
 
+bool EntryImpl::CanBatchWrites() {
+  if (doomed_ || read_only_ || sparse_.get())
+    return false;
+
+  bool pending_data = false;
+  for (int index = 0; index < kNumStreams; index++) {
+    if (!user_buffers_[index].get() || !user_buffers_[index]->Size())
+      continue;
+
+    // Flush() creates the block for this data, unless it goes to a separate
+    // file.
+    Addr address(entry_.Data()->data_addr[index]);
+    if (address.is_initialized() ||
+        entry_.Data()->data_size[index] > kMaxBlockSize) {
+      return false;
+    }
+    pending_data = true;
+  }
+  return pending_data;
+}
+
+bool EntryImpl::FlushToBatch(WriteBatch* batch) {
+  if (doomed_)
+    return true;
+
+  for (int index = 0; index < kNumStreams; index++) {
+    if (!user_buffers_[index].get())
+      continue;
+    if (!Flush(index, 0, batch))
+      return false;
+
+    // The batch has its own copy of the data, and a buffer cannot be kept
+    // for data that lives on a block file.
+    Addr address(entry_.Data()->data_addr[index]);
+    if (address.is_block_file())
+      user_buffers_[index].reset();
+  }
+  return true;
+}
+
 // This only includes checks that relate to the first block of the entry (the
 // first 256 bytes), and values that should be set from the entry creation.
 // Basically, even if there is something wrong with this entry, we want to see
@@ -938,7 +979,7 @@ EntryImpl::~EntryImpl() {
     bool ret = true;
     for (int index = 0; index < kNumStreams; index++) {
       if (user_buffers_[index].get()) {
-        if (!(ret = Flush(index, 0)))
+        if (!(ret = Flush(index, 0, NULL)))
           LOG(ERROR) << "Failed to save user data";
       }
       if (unreported_size_[index]) {
@@ -1338,7 +1379,7 @@ bool EntryImpl::HandleTruncation(int index, int offset, int buf_len) {
     if (offset > user_buffers_[index]->Start())
       user_buffers_[index]->Truncate(new_size);
     UpdateSize(index, current_size, new_size);
-    if (!Flush(index, 0))
+    if (!Flush(index, 0, NULL))
       return false;
     user_buffers_[index].reset();
   }
@@ -1407,7 +1448,7 @@ bool EntryImpl::PrepareBuffer(int index, int offset, int buf_len) {
     // that we are not overwriting anything.
     Addr address(entry_.Data()->data_addr[index]);
     if (address.is_initialized() && address.is_separate_file()) {
-      if (!Flush(index, 0))
+      if (!Flush(index, 0, NULL))
         return false;
       // There is an actual file already, and we don't want to keep track of
       // its length so we let this operation go straight to disk.
@@ -1419,7 +1460,7 @@ bool EntryImpl::PrepareBuffer(int index, int offset, int buf_len) {
   }
 
   if (!user_buffers_[index]->PreWrite(offset, buf_len)) {
-    if (!Flush(index, offset + buf_len))
+    if (!Flush(index, offset + buf_len, NULL))
       return false;
 
     // Lets try again.
@@ -1434,7 +1475,7 @@ bool EntryImpl::PrepareBuffer(int index, int offset, int buf_len) {
   return true;
 }
 
-bool EntryImpl::Flush(int index, int min_len) {
+bool EntryImpl::Flush(int index, int min_len, WriteBatch* batch) {
   Addr address(entry_.Data()->data_addr[index]);
   DCHECK(user_buffers_[index].get());
   DCHECK(!address.is_initialized() || address.is_separate_file());
@@ -1466,8 +1507,12 @@ bool EntryImpl::Flush(int index, int min_len) {
   if (!file)
     return false;
 
-  if (!file->Write(user_buffers_[index]->Data(), len, offset, NULL, NULL))
+  if (batch && address.is_block_file()) {
+    batch->Add(file, user_buffers_[index]->Data(), len, offset);
+  } else if (!file->Write(user_buffers_[index]->Data(), len, offset, NULL,
+                          NULL)) {
     return false;
+  }
   user_buffers_[index]->Reset();
 
   return true;
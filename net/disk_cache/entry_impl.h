@@ -17,6 +17,7 @@ namespace disk_cache {
 class BackendImpl;
 class InFlightBackendIO;
 class SparseControl;
+class WriteBatch;
 
 // This class implements the Entry interface. An object of this
 // class represents a single entry on the cache.
@@ -111,6 +112,14 @@ class NET_EXPORT_PRIVATE EntryImpl
   // be removed.
   bool LeaveRankingsBehind();
 
+  // Returns true if all the data that this entry has yet to save goes to the
+  // block files, so it can be written along with that of other entries.
+  bool CanBatchWrites();
+
+  // Saves the data that this entry has yet to write to |batch|, instead of
+  // writing it to disk right away. Returns false on failure.
+  bool FlushToBatch(WriteBatch* batch);
+
   // Returns false if the entry is clearly invalid.
   bool SanityCheck();
   bool DataSanityCheck();
@@ -224,8 +233,9 @@ class NET_EXPORT_PRIVATE EntryImpl
   bool PrepareBuffer(int index, int offset, int buf_len);
 
   // Flushes the in-memory data to the backing storage. The data destination
-  // is determined based on the current data length and |min_len|.
-  bool Flush(int index, int min_len);
+  // is determined based on the current data length and |min_len|. If |batch|
+  // is not NULL, data that goes to a block file is queued there.
+  bool Flush(int index, int min_len, WriteBatch* batch);
 
   // Updates the size of a given data stream.
   void UpdateSize(int index, int old_size, int new_size);
@@ -813,6 +813,44 @@ TEST_F(DiskCacheEntryTest, MemoryOnlyTruncateData) {
   TruncateData();
 }
 
+// Tests IO that crosses the boundaries of the chunks used by the memory cache
+// to store the data.
+TEST_F(DiskCacheEntryTest, MemoryOnlyChunkedData) {
+  SetMemoryOnlyMode();
+  InitCache();
+  std::string key("the first key");
+  disk_cache::Entry* entry;
+  ASSERT_EQ(net::OK, CreateEntry(key, &entry));
+
+  const int kSize = 50000;
+  scoped_refptr<net::IOBuffer> buffer1(new net::IOBuffer(kSize));
+  scoped_refptr<net::IOBuffer> buffer2(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer1->data(), kSize, false);
+
+  // Grow the stream a little at a time, past a few chunks.
+  for (int offset = 0; offset < kSize; offset += 7000) {
+    int len = std::min(7000, kSize - offset);
+    EXPECT_EQ(len, WriteData(entry, 0, offset,
+                             new net::WrappedIOBuffer(buffer1->data() + offset),
+                             len, false));
+  }
+  EXPECT_EQ(kSize, entry->GetDataSize(0));
+  EXPECT_EQ(kSize - 100, ReadData(entry, 0, 100, buffer2, kSize - 100));
+  EXPECT_TRUE(!memcmp(buffer1->data() + 100, buffer2->data(), kSize - 100));
+
+  // Truncate in the middle of a chunk, and grow again leaving a hole.
+  EXPECT_EQ(0, WriteData(entry, 0, 20000, NULL, 0, true));
+  EXPECT_EQ(1000, WriteData(entry, 0, 45000, buffer1, 1000, false));
+  EXPECT_EQ(46000, entry->GetDataSize(0));
+
+  const char zeros[kSize] = {};
+  EXPECT_EQ(46000, ReadData(entry, 0, 0, buffer2, kSize));
+  EXPECT_TRUE(!memcmp(buffer1->data(), buffer2->data(), 20000));
+  EXPECT_TRUE(!memcmp(zeros, buffer2->data() + 20000, 25000));
+  EXPECT_TRUE(!memcmp(buffer1->data(), buffer2->data() + 45000, 1000));
+  entry->Close();
+}
+
 void DiskCacheEntryTest::ZeroLengthIO() {
   std::string key("the first key");
   disk_cache::Entry* entry;
@@ -26,6 +26,12 @@
 // size so that we have a chance to see an element again and move it to another
 // list.
 
+// Both policies can also use a frequency sketch of the recent lookups (see
+// FrequencySketch). An entry that is about to be evicted is kept instead if
+// it is looked up more often than the last created entry: as with TinyLFU,
+// a newcomer only displaces an entry that is less popular. This protects the
+// cache from one-off downloads and scans.
+
 #include "net/disk_cache/eviction.h"
 
 #include "base/bind.h"
@@ -49,6 +55,7 @@ const int kCleanUpMargin = 1024 * 1024;
 const int kHighUse = 10;  // Reuse count to be on the HIGH_USE list.
 const int kTargetTime = 24 * 7;  // Time to be evicted (hours since last use).
 const int kMaxDelayedTrims = 60;
+const int kMaxKeptEntries = 10;  // Per trim, to make sure that we move ahead.
 
 int LowWaterAdjust(int high_water) {
   if (high_water < kCleanUpMargin)
@@ -85,6 +92,8 @@ void Eviction::Init(BackendImpl* backend) {
   trimming_ = false;
   delay_trim_ = false;
   trim_delays_ = 0;
+  kept_entries_ = 0;
+  last_created_hash_ = 0;
   init_ = true;
   test_mode_ = false;
 }
@@ -114,6 +123,7 @@ void Eviction::TrimCache(bool empty) {
 
   Trace("*** Trim Cache ***");
   trimming_ = true;
+  kept_entries_ = 0;
   TimeTicks start = TimeTicks::Now();
   Rankings::ScopedRankingsBlock node(rankings_);
   Rankings::ScopedRankingsBlock next(
@@ -169,6 +179,7 @@ void Eviction::OnOpenEntry(EntryImpl* entry) {
 }
 
 void Eviction::OnCreateEntry(EntryImpl* entry) {
+  last_created_hash_ = entry->GetHash();
   if (new_eviction_)
     return OnCreateEntryV2(entry);
 
@@ -279,6 +290,13 @@ bool Eviction::EvictEntry(CacheRankingsBlock* node, bool empty,
   }
 
   ReportTrimTimes(entry);
+  if (!empty && ShouldKeepEntry(entry)) {
+    rankings_->UpdateRank(entry->rankings(), false, list);
+    backend_->OnEvent(Stats::KEEP_ENTRY);
+    entry->Release();
+    return false;
+  }
+
   if (empty || !new_eviction_) {
     entry->DoomImpl();
     if (!empty)
@@ -299,11 +317,26 @@ bool Eviction::EvictEntry(CacheRankingsBlock* node, bool empty,
   return true;
 }
 
+bool Eviction::ShouldKeepEntry(EntryImpl* entry) {
+  FrequencySketch* sketch = &backend_->sketch_;
+  if (!sketch->is_initialized() || kept_entries_ >= kMaxKeptEntries)
+    return false;
+
+  if (sketch->Estimate(entry->GetHash()) <=
+      sketch->Estimate(last_created_hash_)) {
+    return false;
+  }
+
+  kept_entries_++;
+  return true;
+}
+
 // -----------------------------------------------------------------------
 
 void Eviction::TrimCacheV2(bool empty) {
   Trace("*** Trim Cache ***");
   trimming_ = true;
+  kept_entries_ = 0;
   TimeTicks start = TimeTicks::Now();
 
   const int kListsToSearch = 3;
@@ -53,6 +53,10 @@ class Eviction {
   Rankings::List GetListForEntry(EntryImpl* entry);
   bool EvictEntry(CacheRankingsBlock* node, bool empty, Rankings::List list);
 
+  // Returns true if |entry| is used more often than the last entry that was
+  // created, so it should be given another chance instead of being evicted.
+  bool ShouldKeepEntry(EntryImpl* entry);
+
   // We'll just keep for a while a separate set of methods that implement the
   // new eviction algorithm. This code will replace the original methods when
   // finished.
@@ -75,6 +79,8 @@ class Eviction {
   IndexHeader* header_;
   int max_size_;
   int trim_delays_;
+  int kept_entries_;  // Entries kept on the current trim.
+  uint32 last_created_hash_;
   int index_size_;
   bool new_eviction_;
   bool first_trim_;
@@ -18,7 +18,9 @@ enum {
   EXPERIMENT_DELETED_LIST_OUT = 11,
   EXPERIMENT_DELETED_LIST_CONTROL = 12,
   EXPERIMENT_DELETED_LIST_IN = 13,
-  EXPERIMENT_DELETED_LIST_OUT2 = 14
+  EXPERIMENT_DELETED_LIST_OUT2 = 14,
+  EXPERIMENT_SKETCH_CONTROL = 15,
+  EXPERIMENT_SKETCH = 16
 };
 
 }  // namespace disk_cache
@@ -0,0 +1,115 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/frequency_sketch.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace {
+
+const int kNumRows = 4;
+const int kMaxCount = 15;
+const int kCountersPerWord = 8;
+
+// Odd multipliers that select a different counter for each row.
+const uint32 kSeeds[kNumRows] = {
+  0x9E3779B1, 0x85EBCA77, 0xC2B2AE3D, 0x27D4EB2F
+};
+
+// The counters are halved after this many increments per counter, so that the
+// sketch reflects the recent history.
+const int kSampleFactor = 10;
+
+}  // namespace
+
+namespace disk_cache {
+
+FrequencySketch::FrequencySketch()
+    : additions_(NULL), table_(NULL), num_counters_(0), shift_(0) {
+}
+
+FrequencySketch::~FrequencySketch() {
+}
+
+// static
+int FrequencySketch::GetStorageSize(int num_entries) {
+  int num_counters = kCountersPerWord;
+  while (num_counters < num_entries)
+    num_counters *= 2;
+  return num_counters / kCountersPerWord + 1;
+}
+
+void FrequencySketch::Init(uint32* storage, int num_entries) {
+  DCHECK(storage);
+  additions_ = storage;
+  table_ = storage + 1;
+  num_counters_ = (GetStorageSize(num_entries) - 1) * kCountersPerWord;
+
+  shift_ = 32;
+  for (int i = num_counters_; i > 1; i /= 2)
+    shift_--;
+}
+
+void FrequencySketch::Reset() {
+  additions_ = NULL;
+  table_ = NULL;
+  num_counters_ = 0;
+}
+
+void FrequencySketch::Increment(uint32 hash) {
+  DCHECK(is_initialized());
+  int indexes[kNumRows];
+  int min_count = kMaxCount;
+  for (int row = 0; row < kNumRows; row++) {
+    indexes[row] = GetIndex(hash, row);
+    min_count = std::min(min_count, GetCounter(indexes[row]));
+  }
+
+  // Only the smallest counters go up, which keeps the estimate of keys that
+  // share some of them with more popular keys as low as possible.
+  for (int row = 0; min_count < kMaxCount && row < kNumRows; row++) {
+    if (GetCounter(indexes[row]) == min_count) {
+      table_[indexes[row] / kCountersPerWord] +=
+          1 << (indexes[row] % kCountersPerWord * 4);
+    }
+  }
+
+  if (++*additions_ >= static_cast<uint32>(num_counters_ * kSampleFactor))
+    Age();
+}
+
+int FrequencySketch::Estimate(uint32 hash) const {
+  DCHECK(is_initialized());
+  int count = kMaxCount;
+  for (int row = 0; row < kNumRows; row++)
+    count = std::min(count, GetCounter(GetIndex(hash, row)));
+  return count;
+}
+
+void FrequencySketch::Clear() {
+  DCHECK(is_initialized());
+  *additions_ = 0;
+  memset(table_, 0, num_counters_ / kCountersPerWord * sizeof(*table_));
+}
+
+int FrequencySketch::GetIndex(uint32 hash, int row) const {
+  return static_cast<int>((hash * kSeeds[row]) >> shift_);
+}
+
+int FrequencySketch::GetCounter(int index) const {
+  return (table_[index / kCountersPerWord] >>
+          (index % kCountersPerWord * 4)) & 0xf;
+}
+
+void FrequencySketch::Age() {
+  *additions_ = 0;
+  for (int i = 0; i < num_counters_ / kCountersPerWord; i++)
+    table_[i] = (table_[i] >> 1) & 0x77777777;
+}
+
+}  // namespace disk_cache
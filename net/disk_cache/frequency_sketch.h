@@ -0,0 +1,70 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// See net/disk_cache/disk_cache.h for the public interface.
+
+#ifndef NET_DISK_CACHE_FREQUENCY_SKETCH_H_
+#define NET_DISK_CACHE_FREQUENCY_SKETCH_H_
+#pragma once
+
+#include "base/basictypes.h"
+#include "net/base/net_export.h"
+
+namespace disk_cache {
+
+// This class keeps an approximate count of how many times each hash was seen
+// recently, in a count-min sketch of 4-bit counters. The sketch doesn't own
+// its storage, so it can live on the index file and survive restarts. All the
+// counters are halved every so often, so old accesses fade away.
+class NET_EXPORT_PRIVATE FrequencySketch {
+ public:
+  FrequencySketch();
+  ~FrequencySketch();
+
+  // Returns the number of 32-bit words of storage needed to keep about
+  // |num_entries| counters.
+  static int GetStorageSize(int num_entries);
+
+  // Uses |storage|, which must have GetStorageSize(|num_entries|) words, to
+  // keep the counters. Any previous contents are kept.
+  void Init(uint32* storage, int num_entries);
+
+  // Stops using the storage.
+  void Reset();
+
+  bool is_initialized() const {
+    return table_ != NULL;
+  }
+
+  // Records one access to |hash|.
+  void Increment(uint32 hash);
+
+  // Returns the number of recorded accesses to |hash| (at most 15), which may
+  // be an over-estimate.
+  int Estimate(uint32 hash) const;
+
+  // Forgets all the recorded accesses.
+  void Clear();
+
+ private:
+  // Returns the position of the counter of |hash| on row |row|.
+  int GetIndex(uint32 hash, int row) const;
+  int GetCounter(int index) const;
+
+  // Halves all the counters.
+  void Age();
+
+  // The first word of the storage keeps the number of increments since the
+  // last aging; the counters follow.
+  uint32* additions_;
+  uint32* table_;
+  int num_counters_;
+  int shift_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrequencySketch);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_FREQUENCY_SKETCH_H_
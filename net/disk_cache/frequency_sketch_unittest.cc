@@ -0,0 +1,64 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <vector>
+
+#include "base/stringprintf.h"
+#include "net/disk_cache/frequency_sketch.h"
+#include "net/disk_cache/hash.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+TEST(DiskCacheFrequencySketchTest, Basics) {
+  const int kNumEntries = 1000;
+  std::vector<uint32> storage(
+      disk_cache::FrequencySketch::GetStorageSize(kNumEntries));
+  disk_cache::FrequencySketch sketch;
+  EXPECT_FALSE(sketch.is_initialized());
+  sketch.Init(&storage[0], kNumEntries);
+  EXPECT_TRUE(sketch.is_initialized());
+
+  uint32 hash = disk_cache::Hash("the first key");
+  EXPECT_EQ(0, sketch.Estimate(hash));
+  for (int i = 1; i <= 20; i++) {
+    sketch.Increment(hash);
+    EXPECT_EQ(std::min(i, 15), sketch.Estimate(hash));
+  }
+
+  // A key seen once stands apart from a key seen many times, even when the
+  // sketch is full of other keys.
+  for (int i = 0; i < kNumEntries; i++) {
+    uint32 other = disk_cache::Hash(base::StringPrintf("key %d", i));
+    sketch.Increment(other);
+  }
+  uint32 once = disk_cache::Hash(std::string("key 7"));
+  EXPECT_GT(sketch.Estimate(hash), sketch.Estimate(once) + 5);
+
+  // The storage keeps the counts.
+  disk_cache::FrequencySketch sketch2;
+  sketch2.Init(&storage[0], kNumEntries);
+  EXPECT_EQ(sketch.Estimate(hash), sketch2.Estimate(hash));
+
+  sketch.Clear();
+  EXPECT_EQ(0, sketch.Estimate(hash));
+}
+
+// Tests that old accesses fade away.
+TEST(DiskCacheFrequencySketchTest, Aging) {
+  const int kNumEntries = 64;
+  std::vector<uint32> storage(
+      disk_cache::FrequencySketch::GetStorageSize(kNumEntries));
+  disk_cache::FrequencySketch sketch;
+  sketch.Init(&storage[0], kNumEntries);
+
+  uint32 hash = disk_cache::Hash("the first key");
+  for (int i = 0; i < 15; i++)
+    sketch.Increment(hash);
+  EXPECT_EQ(15, sketch.Estimate(hash));
+
+  // Enough traffic for other keys halves the counters, more than once.
+  for (int i = 0; i < 64 * 10 * 3; i++)
+    sketch.Increment(disk_cache::Hash(base::StringPrintf("key %d", i % 3)));
+  EXPECT_GE(3, sketch.Estimate(hash));
+}
@@ -47,6 +47,7 @@ void BackendIO::OnIOComplete(int result) {
   DCHECK(IsEntryOperation());
   DCHECK_NE(result, net::ERR_IO_PENDING);
   result_ = result;
+  ReportLatency();
   NotifyController();
 }
 
@@ -222,6 +223,26 @@ base::TimeDelta BackendIO::ElapsedTime() const {
   return base::TimeTicks::Now() - start_time_;
 }
 
+// Runs on the background thread.
+void BackendIO::ReportLatency() {
+  switch (operation_) {
+    case OP_OPEN:
+    case OP_CREATE:
+      backend_->OnOperation(Stats::OPEN_OPS, ElapsedTime());
+      break;
+    case OP_READ:
+    case OP_READ_SPARSE:
+      backend_->OnOperation(Stats::READ_OPS, ElapsedTime());
+      break;
+    case OP_WRITE:
+    case OP_WRITE_SPARSE:
+      backend_->OnOperation(Stats::WRITE_OPS, ElapsedTime());
+      break;
+    default:
+      break;
+  }
+}
+
 // Runs on the background thread.
 void BackendIO::ExecuteBackendOperation() {
   switch (operation_) {
@@ -261,7 +282,7 @@ void BackendIO::ExecuteBackendOperation() {
       result_ = net::OK;
       break;
     case OP_CLOSE_ENTRY:
-      entry_->Release();
+      backend_->SyncCloseEntry(entry_);
       result_ = net::OK;
       break;
     case OP_DOOM_ENTRY:
@@ -280,6 +301,7 @@ void BackendIO::ExecuteBackendOperation() {
       result_ = net::ERR_UNEXPECTED;
   }
   DCHECK_NE(net::ERR_IO_PENDING, result_);
+  ReportLatency();
   NotifyController();
 }
 
@@ -322,8 +344,10 @@ void BackendIO::ExecuteEntryOperation() {
       NOTREACHED() << "Invalid Operation";
       result_ = net::ERR_UNEXPECTED;
   }
-  if (result_ != net::ERR_IO_PENDING)
+  if (result_ != net::ERR_IO_PENDING) {
+    ReportLatency();
     NotifyController();
+  }
 }
 
 InFlightBackendIO::InFlightBackendIO(BackendImpl* backend,
@@ -116,6 +116,9 @@ class BackendIO : public BackgroundIO {
   // Returns the time that has passed since the operation was created.
   base::TimeDelta ElapsedTime() const;
 
+  // Records the latency of this operation on the stats of the backend.
+  void ReportLatency();
+
   void ExecuteBackendOperation();
   void ExecuteEntryOperation();
 
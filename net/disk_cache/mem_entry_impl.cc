@@ -4,6 +4,8 @@
 
 #include "net/disk_cache/mem_entry_impl.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "base/stringprintf.h"
 #include "net/base/io_buffer.h"
@@ -17,6 +19,23 @@ namespace {
 
 const int kSparseData = 1;
 
+// Stream data is kept in chunks of this size, so that appending to a stream
+// doesn't copy what it already has. A stream that fits on a single chunk uses
+// a smaller one, with a size that is a power of two of at least
+// kMinChunkSize bytes.
+const int kChunkSize = 16 * 1024;
+const int kMinChunkSize = 256;
+
+// Returns the size of the chunk that holds a stream of |size| bytes, when it
+// fits on a single chunk.
+int GetChunkSizeFor(int size) {
+  DCHECK_LE(size, kChunkSize);
+  int chunk_size = kMinChunkSize;
+  while (chunk_size < size)
+    chunk_size *= 2;
+  return chunk_size;
+}
+
 // Maximum size of a sparse entry is 2 to the power of this number.
 const int kMaxSparseEntryBits = 12;
 
@@ -262,7 +281,7 @@ int MemEntryImpl::ReadyForSparseIO(const CompletionCallback& callback) {
 
 MemEntryImpl::~MemEntryImpl() {
   for (int i = 0; i < NUM_STREAMS; i++)
-    backend_->ModifyStorageSize(data_size_[i], 0);
+    backend_->ModifyStorageSize(GetCapacity(i), 0);
   backend_->ModifyStorageSize(static_cast<int32>(key_.size()), 0);
   net_log_.EndEvent(net::NetLog::TYPE_DISK_CACHE_MEM_ENTRY_IMPL, NULL);
 }
@@ -286,7 +305,7 @@ int MemEntryImpl::InternalReadData(int index, int offset, IOBuffer* buf,
 
   UpdateRank(false);
 
-  memcpy(buf->data(), &(data_[index])[offset], buf_len);
+  CopyFromStream(index, offset, buf->data(), buf_len);
   return buf_len;
 }
 
@@ -314,12 +333,11 @@ int MemEntryImpl::InternalWriteData(int index, int offset, IOBuffer* buf,
   PrepareTarget(index, offset, buf_len);
 
   if (entry_size < offset + buf_len) {
-    backend_->ModifyStorageSize(entry_size, offset + buf_len);
     data_size_[index] = offset + buf_len;
   } else if (truncate) {
     if (entry_size > offset + buf_len) {
-      backend_->ModifyStorageSize(entry_size, offset + buf_len);
       data_size_[index] = offset + buf_len;
+      Shrink(index, offset + buf_len);
     }
   }
 
@@ -328,7 +346,7 @@ int MemEntryImpl::InternalWriteData(int index, int offset, IOBuffer* buf,
   if (!buf_len)
     return 0;
 
-  memcpy(&(data_[index])[offset], buf->data(), buf_len);
+  CopyToStream(index, offset, buf->data(), buf_len);
   return buf_len;
 }
 
@@ -507,15 +525,86 @@ void MemEntryImpl::PrepareTarget(int index, int offset, int buf_len) {
   if (entry_size >= offset + buf_len)
     return;  // Not growing the stored data.
 
-  if (static_cast<int>(data_[index].size()) < offset + buf_len)
-    data_[index].resize(offset + buf_len);
+  Reserve(index, offset + buf_len);
 
   if (offset <= entry_size)
     return;  // There is no "hole" on the stored data.
 
   // Cleanup the hole not written by the user. The point is to avoid returning
   // random stuff later on.
-  memset(&(data_[index])[entry_size], 0, offset - entry_size);
+  CopyToStream(index, entry_size, NULL, offset - entry_size);
+}
+
+int MemEntryImpl::GetCapacity(int index) const {
+  int capacity = 0;
+  for (size_t i = 0; i < data_[index].size(); i++)
+    capacity += data_[index][i]->size();
+  return capacity;
+}
+
+void MemEntryImpl::Reserve(int index, int size) {
+  int old_capacity = GetCapacity(index);
+  if (size <= old_capacity)
+    return;
+
+  // Only a stream that fits on a single chunk has to be moved, and it is small
+  // by definition.
+  Chunks& chunks = data_[index];
+  if (chunks.empty() || chunks[0]->size() < kChunkSize) {
+    DCHECK_LE(chunks.size(), 1U);
+    int chunk_size = std::min(size, kChunkSize);
+    scoped_refptr<net::IOBufferWithSize> chunk(
+        new net::IOBufferWithSize(GetChunkSizeFor(chunk_size)));
+    if (!chunks.empty())
+      memcpy(chunk->data(), chunks[0]->data(), data_size_[index]);
+    chunks.clear();
+    chunks.push_back(chunk);
+  }
+
+  while (static_cast<int>(chunks.size()) * kChunkSize < size)
+    chunks.push_back(new net::IOBufferWithSize(kChunkSize));
+
+  backend_->ModifyStorageSize(old_capacity, GetCapacity(index));
+}
+
+void MemEntryImpl::Shrink(int index, int size) {
+  size_t num_chunks = (size + kChunkSize - 1) / kChunkSize;
+  if (data_[index].size() <= num_chunks)
+    return;
+
+  int old_capacity = GetCapacity(index);
+  data_[index].resize(num_chunks);
+  backend_->ModifyStorageSize(old_capacity, GetCapacity(index));
+}
+
+void MemEntryImpl::CopyFromStream(int index, int offset, char* buf,
+                                  int len) const {
+  while (len) {
+    net::IOBufferWithSize* chunk = data_[index][offset / kChunkSize];
+    int chunk_offset = offset % kChunkSize;
+    int bytes = std::min(len, chunk->size() - chunk_offset);
+    memcpy(buf, chunk->data() + chunk_offset, bytes);
+    buf += bytes;
+    offset += bytes;
+    len -= bytes;
+  }
+}
+
+void MemEntryImpl::CopyToStream(int index, int offset, const char* buf,
+                                int len) {
+  while (len) {
+    net::IOBufferWithSize* chunk = data_[index][offset / kChunkSize];
+    int chunk_offset = offset % kChunkSize;
+    int bytes = std::min(len, chunk->size() - chunk_offset);
+    if (buf) {
+      memcpy(chunk->data() + chunk_offset, buf, bytes);
+      buf += bytes;
+    } else {
+      memset(chunk->data() + chunk_offset, 0, bytes);
+    }
+    offset += bytes;
+    len -= bytes;
+  }
 }
 
 void MemEntryImpl::UpdateRank(bool modified) {
@@ -9,6 +9,7 @@
 #include "base/gtest_prod_util.h"
 #include "base/hash_tables.h"
 #include "base/memory/scoped_ptr.h"
+#include "net/base/io_buffer.h"
 #include "net/base/net_log.h"
 #include "net/disk_cache/disk_cache.h"
 
@@ -115,6 +116,7 @@ class MemEntryImpl : public Entry {
 
  private:
   typedef base::hash_map<int, MemEntryImpl*> EntryMap;
+  typedef std::vector<scoped_refptr<net::IOBufferWithSize> > Chunks;
 
   enum {
     NUM_STREAMS = 3
@@ -136,6 +138,21 @@ class MemEntryImpl : public Entry {
   // Grows and cleans up the data buffer.
   void PrepareTarget(int index, int offset, int buf_len);
 
+  // Returns the number of bytes allocated to hold the stream |index|.
+  int GetCapacity(int index) const;
+
+  // Makes room for |size| bytes on the stream |index|, keeping its data.
+  void Reserve(int index, int size);
+
+  // Releases the chunks that are not needed to hold |size| bytes of the
+  // stream |index|.
+  void Shrink(int index, int size);
+
+  // Copies |len| bytes between |buf| and the stream |index|, at |offset|. The
+  // stream must be big enough. A NULL |buf| means zeros for CopyToStream().
+  void CopyFromStream(int index, int offset, char* buf, int len) const;
+  void CopyToStream(int index, int offset, const char* buf, int len);
+
   // Updates ranking information.
   void UpdateRank(bool modified);
 
@@ -163,7 +180,7 @@ class MemEntryImpl : public Entry {
   void DetachChild(int child_id);
 
   std::string key_;
-  std::vector<char> data_[NUM_STREAMS];  // User data.
+  Chunks data_[NUM_STREAMS];  // User data.
   int32 data_size_[NUM_STREAMS];
   int ref_count_;
 
@@ -0,0 +1,120 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/startup_list.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "net/disk_cache/backend_impl.h"
+
+namespace {
+
+const int32 kStartupSignature = 0xF01427E1;
+
+struct OnDiskStartupList {
+  int32 signature;
+  int32 num_entries;
+  disk_cache::StartupList::Entry entries[disk_cache::StartupList::kMaxEntries];
+};
+COMPILE_ASSERT(sizeof(OnDiskStartupList) == 512, needs_2_blocks);
+
+size_t GetOffset(disk_cache::Addr address) {
+  return address.start_block() * address.BlockSize() +
+         disk_cache::kBlockHeaderSize;
+}
+
+}  // namespace
+
+namespace disk_cache {
+
+StartupList::StartupList()
+    : backend_(NULL), storage_addr_(NULL), next_previous_(0) {
+}
+
+StartupList::~StartupList() {
+}
+
+bool StartupList::Init(BackendImpl* backend, CacheAddr* storage_addr) {
+  backend_ = backend;
+  storage_addr_ = storage_addr;
+  previous_.clear();
+  current_.clear();
+  next_previous_ = 0;
+
+  // The block is only created when there is something to store.
+  Addr address(*storage_addr);
+  if (!address.is_initialized())
+    return true;
+
+  MappedFile* file = backend->File(address);
+  if (!file)
+    return false;
+
+  OnDiskStartupList list;
+  if (!file->Read(&list, sizeof(list), GetOffset(address)))
+    return false;
+
+  // A bad list is not worth failing the cache for; it will be overwritten.
+  if (list.signature != kStartupSignature || list.num_entries < 0 ||
+      list.num_entries > kMaxEntries) {
+    LOG(WARNING) << "Invalid startup list.";
+    return true;
+  }
+
+  previous_.assign(list.entries, list.entries + list.num_entries);
+  return true;
+}
+
+void StartupList::OnOpenEntry(uint32 hash, Addr address) {
+  if (!backend_ || current_.size() >= static_cast<size_t>(kMaxEntries))
+    return;
+
+  for (size_t i = 0; i < current_.size(); i++) {
+    if (current_[i].address == address.value())
+      return;
+  }
+
+  Entry entry;
+  entry.hash = hash;
+  entry.address = address.value();
+  current_.push_back(entry);
+
+  // Don't wait for the end of the session: it may never come.
+  if (current_.size() == static_cast<size_t>(kMaxEntries))
+    Store();
+}
+
+void StartupList::Store() {
+  if (!backend_ || current_.empty())
+    return;
+
+  Addr address(*storage_addr_);
+  if (!address.is_initialized()) {
+    if (!backend_->CreateBlock(BLOCK_256, 2, &address))
+      return;
+    *storage_addr_ = address.value();
+  }
+
+  MappedFile* file = backend_->File(address);
+  if (!file)
+    return;
+
+  OnDiskStartupList list;
+  memset(&list, 0, sizeof(list));
+  list.signature = kStartupSignature;
+  list.num_entries = static_cast<int32>(current_.size());
+  std::copy(current_.begin(), current_.end(), list.entries);
+  file->Write(&list, sizeof(list), GetOffset(address));
+}
+
+bool StartupList::GetNextPreviousEntry(Entry* entry) {
+  if (next_previous_ >= previous_.size())
+    return false;
+
+  *entry = previous_[next_previous_++];
+  return true;
+}
+
+}  // namespace disk_cache
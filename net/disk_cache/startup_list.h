@@ -0,0 +1,62 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// See net/disk_cache/disk_cache.h for the public interface.
+
+#ifndef NET_DISK_CACHE_STARTUP_LIST_H_
+#define NET_DISK_CACHE_STARTUP_LIST_H_
+#pragma once
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "net/disk_cache/addr.h"
+
+namespace disk_cache {
+
+class BackendImpl;
+
+// This class records the first entries opened by a session, and keeps them on
+// the backing store so that the next session can read them from disk before
+// they are requested.
+class StartupList {
+ public:
+  // The number of entries recorded per session.
+  static const int kMaxEntries = 63;
+
+  struct Entry {
+    uint32 hash;  // Hash of the key, to verify that the entry is still there.
+    CacheAddr address;
+  };
+
+  StartupList();
+  ~StartupList();
+
+  // Loads the list recorded by the previous session from the block pointed to
+  // by |storage_addr|, if any, and starts recording a new one.
+  bool Init(BackendImpl* backend, CacheAddr* storage_addr);
+
+  // Records that the entry at |address| was opened.
+  void OnOpenEntry(uint32 hash, Addr address);
+
+  // Saves the entries recorded by this session, if there is any.
+  void Store();
+
+  // Returns the entries recorded by the previous session, that haven't been
+  // returned yet. Returns false when there is none left.
+  bool GetNextPreviousEntry(Entry* entry);
+
+ private:
+  BackendImpl* backend_;
+  CacheAddr* storage_addr_;
+  std::vector<Entry> previous_;  // Recorded by the previous session.
+  size_t next_previous_;  // The next entry to return from |previous_|.
+  std::vector<Entry> current_;  // Recorded by this session.
+
+  DISALLOW_COPY_AND_ASSIGN(StartupList);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_STARTUP_LIST_H_
@@ -60,7 +60,15 @@ static const char* kCounterNames[] = {
   "Fatal error",
   "Last report",
   "Last report timer",
-  "Doom recent entries"
+  "Doom recent entries",
+  "Open ops",
+  "Open time",
+  "Read ops",
+  "Read time",
+  "Write ops",
+  "Write time",
+  "Keep entry",
+  "Startup prefetch"
 };
 COMPILE_ASSERT(arraysize(kCounterNames) == disk_cache::Stats::MAX_COUNTER,
                update_the_names);
@@ -189,6 +197,12 @@ int64 Stats::GetCounter(Counters counter) const {
   return counters_[counter];
 }
 
+void Stats::OnOperation(Counters ops, base::TimeDelta latency) {
+  DCHECK(ops == OPEN_OPS || ops == READ_OPS || ops == WRITE_OPS);
+  counters_[ops]++;
+  counters_[ops + 1] += latency.InMicroseconds();
+}
+
 void Stats::GetItems(StatsItems* items) {
   std::pair<std::string, std::string> item;
   for (int i = 0; i < kDataSizesLength; i++) {
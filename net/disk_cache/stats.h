@@ -11,6 +11,7 @@
 
 #include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/time.h"
 #include "net/disk_cache/stats_histogram.h"
 
 namespace disk_cache {
@@ -46,6 +47,14 @@ class Stats {
     LAST_REPORT,  // Time of the last time we sent a report.
     LAST_REPORT_TIMER,  // Timer count of the last time we sent a report.
     DOOM_RECENT,  // The cache was partially cleared.
+    OPEN_OPS,  // Open and create operations posted to the cache thread.
+    OPEN_TIME,  // Total latency of OPEN_OPS, in microseconds.
+    READ_OPS,  // Read operations posted to the cache thread.
+    READ_TIME,  // Total latency of READ_OPS, in microseconds.
+    WRITE_OPS,  // Write operations posted to the cache thread.
+    WRITE_TIME,  // Total latency of WRITE_OPS, in microseconds.
+    KEEP_ENTRY,  // An entry was not evicted because it is used often.
+    STARTUP_PREFETCH,  // An entry was read ahead of time, on startup.
     MAX_COUNTER
   };
 
@@ -62,6 +71,10 @@ class Stats {
   void SetCounter(Counters counter, int64 value);
   int64 GetCounter(Counters counter) const;
 
+  // Tracks an operation counted by |ops| (OPEN_OPS, READ_OPS or WRITE_OPS)
+  // that took |latency| to complete, including the time it was queued.
+  void OnOperation(Counters ops, base::TimeDelta latency);
+
   void GetItems(StatsItems* items);
   int GetHitRatio() const;
   int GetResurrectRatio() const;
@@ -0,0 +1,69 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/write_batch.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace disk_cache {
+
+WriteBatch::WriteBatch() : num_writes_(0) {
+}
+
+WriteBatch::~WriteBatch() {
+  DCHECK(writes_.empty());
+}
+
+void WriteBatch::Add(File* file, const void* buffer, size_t buffer_len,
+                     size_t offset) {
+  DCHECK(file);
+  if (!buffer_len)
+    return;
+
+  writes_.push_back(PendingWrite());
+  PendingWrite& write = writes_.back();
+  write.file = file;
+  write.offset = offset;
+  write.data.assign(static_cast<const char*>(buffer), buffer_len);
+}
+
+bool WriteBatch::Flush() {
+  std::sort(writes_.begin(), writes_.end(), &WriteBatch::CompareWrites);
+
+  bool success = true;
+  num_writes_ = 0;
+  size_t i = 0;
+  while (i < writes_.size()) {
+    File* file = writes_[i].file;
+    size_t offset = writes_[i].offset;
+    std::string data;
+    data.swap(writes_[i].data);
+
+    // Append all the writes that start where the previous one ends.
+    for (i++; i < writes_.size(); i++) {
+      if (writes_[i].file != file || writes_[i].offset != offset + data.size())
+        break;
+      data.append(writes_[i].data);
+    }
+    DCHECK(i == writes_.size() || writes_[i].file != file ||
+           writes_[i].offset > offset + data.size());
+
+    num_writes_++;
+    if (!file->Write(data.data(), data.size(), offset))
+      success = false;
+  }
+  writes_.clear();
+  return success;
+}
+
+// static
+bool WriteBatch::CompareWrites(const PendingWrite& a, const PendingWrite& b) {
+  if (a.file != b.file)
+    return a.file.get() < b.file.get();
+  return a.offset < b.offset;
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,63 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// See net/disk_cache/disk_cache.h for the public interface.
+
+#ifndef NET_DISK_CACHE_WRITE_BATCH_H_
+#define NET_DISK_CACHE_WRITE_BATCH_H_
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "net/base/net_export.h"
+#include "net/disk_cache/file.h"
+
+namespace disk_cache {
+
+// This class collects writes to the backing files, so that the data of many
+// small entries reaches the disk as a few large writes: writes that end up
+// next to each other on the same file are merged before they are issued.
+class NET_EXPORT_PRIVATE WriteBatch {
+ public:
+  WriteBatch();
+  ~WriteBatch();
+
+  // Queues a copy of |buffer_len| bytes from |buffer|, to be written to |file|
+  // at |offset|. Queued writes must not overlap.
+  void Add(File* file, const void* buffer, size_t buffer_len, size_t offset);
+
+  // Performs all the queued writes (synchronously). Returns false if any of
+  // them failed.
+  bool Flush();
+
+  bool empty() const {
+    return writes_.empty();
+  }
+
+  // Returns the number of writes issued by the last call to Flush().
+  int num_writes() const {
+    return num_writes_;
+  }
+
+ private:
+  struct PendingWrite {
+    scoped_refptr<File> file;
+    size_t offset;
+    std::string data;
+  };
+
+  static bool CompareWrites(const PendingWrite& a, const PendingWrite& b);
+
+  std::vector<PendingWrite> writes_;
+  int num_writes_;
+
+  DISALLOW_COPY_AND_ASSIGN(WriteBatch);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_WRITE_BATCH_H_
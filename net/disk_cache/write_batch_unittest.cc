@@ -0,0 +1,65 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/write_batch.h"
+#include "net/disk_cache/disk_cache_test_base.h"
+#include "net/disk_cache/disk_cache_test_util.h"
+#include "net/disk_cache/mapped_file.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+TEST_F(DiskCacheTest, WriteBatch_MergesAdjacentWrites) {
+  FilePath filename = cache_path_.AppendASCII("a_test");
+  scoped_refptr<disk_cache::MappedFile> file(new disk_cache::MappedFile);
+  ASSERT_TRUE(CreateCacheTestFile(filename));
+  ASSERT_TRUE(file->Init(filename, 8192));
+
+  char buffer1[300];
+  CacheTestFillBuffer(buffer1, sizeof(buffer1), false);
+
+  // Two runs of data, queued out of order.
+  disk_cache::WriteBatch batch;
+  EXPECT_TRUE(batch.empty());
+  batch.Add(file, buffer1 + 100, 100, 8292);
+  batch.Add(file, buffer1 + 200, 100, 9000);
+  batch.Add(file, buffer1, 100, 8192);
+  EXPECT_FALSE(batch.empty());
+
+  EXPECT_TRUE(batch.Flush());
+  EXPECT_TRUE(batch.empty());
+  EXPECT_EQ(2, batch.num_writes());
+
+  char buffer2[300];
+  EXPECT_TRUE(file->Read(buffer2, 200, 8192));
+  EXPECT_EQ(0, memcmp(buffer1, buffer2, 200));
+  EXPECT_TRUE(file->Read(buffer2, 100, 9000));
+  EXPECT_EQ(0, memcmp(buffer1 + 200, buffer2, 100));
+}
+
+TEST_F(DiskCacheTest, WriteBatch_SeparateFiles) {
+  FilePath filename1 = cache_path_.AppendASCII("a_test");
+  FilePath filename2 = cache_path_.AppendASCII("b_test");
+  scoped_refptr<disk_cache::MappedFile> file1(new disk_cache::MappedFile);
+  scoped_refptr<disk_cache::MappedFile> file2(new disk_cache::MappedFile);
+  ASSERT_TRUE(CreateCacheTestFile(filename1));
+  ASSERT_TRUE(CreateCacheTestFile(filename2));
+  ASSERT_TRUE(file1->Init(filename1, 8192));
+  ASSERT_TRUE(file2->Init(filename2, 8192));
+
+  char buffer1[200];
+  CacheTestFillBuffer(buffer1, sizeof(buffer1), false);
+
+  // The same offset on two files is not one run.
+  disk_cache::WriteBatch batch;
+  batch.Add(file1, buffer1, 100, 8192);
+  batch.Add(file2, buffer1 + 100, 100, 8292);
+  batch.Add(file2, buffer1, 100, 8192);
+  EXPECT_TRUE(batch.Flush());
+  EXPECT_EQ(2, batch.num_writes());
+
+  char buffer2[200];
+  EXPECT_TRUE(file1->Read(buffer2, 100, 8192));
+  EXPECT_EQ(0, memcmp(buffer1, buffer2, 100));
+  EXPECT_TRUE(file2->Read(buffer2, 200, 8192));
+  EXPECT_EQ(0, memcmp(buffer1, buffer2, 200));
+}
@@ -8,6 +8,7 @@
 #include "base/rand_util.h"
 #include "net/base/net_log.h"
 #include "net/dns/dns_config_service.h"
+#include "net/dns/dns_protocol.h"
 #include "net/dns/dns_session.h"
 #include "net/dns/dns_transaction.h"
 #include "net/socket/client_socket_factory.h"
@@ -16,6 +17,10 @@ namespace net {
 
 namespace {
 
+// Queries for this many names on the search list at once, so that a short
+// name whose first suffixes don't exist resolves in about one round trip.
+const size_t kMaxParallelQueries = 3;
+
 class DnsClientImpl : public DnsClient {
  public:
   explicit DnsClientImpl(NetLog* net_log) : net_log_(net_log) {}
@@ -28,6 +33,8 @@ class DnsClientImpl : public DnsClient {
                                 ClientSocketFactory::GetDefaultFactory(),
                                 base::Bind(&base::RandInt),
                                 net_log_);
+      session_->set_max_parallel_queries(kMaxParallelQueries);
+      session_->set_udp_payload_size(dns_protocol::kEdnsPayloadSize);
       factory_ = DnsTransactionFactory::CreateFactory(session_);
     }
   }
@@ -97,6 +97,11 @@ static const int kMaxNameLength = 255;
 // bytes (not counting the IP nor UDP headers).
 static const int kMaxUDPSize = 512;
 
+// The UDP payload size we advertise with EDNS0 (RFC 6891). A response this
+// large still fits, with IPv6 and UDP headers, in the 1280-byte minimum IPv6
+// MTU, so it won't be fragmented.
+static const int kEdnsPayloadSize = 1232;
+
 // DNS class types.
 static const uint16 kClassIN = 1;
 
@@ -106,6 +111,7 @@ static const uint16 kTypeA = 1;
 static const uint16 kTypeCNAME = 5;
 static const uint16 kTypeTXT = 16;
 static const uint16 kTypeAAAA = 28;
+static const uint16 kTypeOPT = 41;
 
 // DNS rcode values.
 static const uint8 kRcodeMask = 0xf;
@@ -18,25 +18,16 @@ namespace net {
 // For details, see RFC 1035 section 4.1.1.  This header template sets RD
 // bit, which directs the name server to pursue query recursively, and sets
 // the QDCOUNT to 1, meaning the question section has a single entry.
-DnsQuery::DnsQuery(uint16 id, const base::StringPiece& qname, uint16 qtype)
-    : qname_size_(qname.size()) {
-  DCHECK(!DNSDomainToString(qname).empty());
-  // QNAME + QTYPE + QCLASS
-  size_t question_size = qname_size_ + sizeof(uint16) + sizeof(uint16);
-  io_buffer_ = new IOBufferWithSize(sizeof(dns_protocol::Header) +
-                                    question_size);
-  dns_protocol::Header* header =
-      reinterpret_cast<dns_protocol::Header*>(io_buffer_->data());
-  memset(header, 0, sizeof(dns_protocol::Header));
-  header->id = base::HostToNet16(id);
-  header->flags = base::HostToNet16(dns_protocol::kFlagRD);
-  header->qdcount = base::HostToNet16(1);
+DnsQuery::DnsQuery(uint16 id, const base::StringPiece& qname, uint16 qtype) {
+  Init(id, qname, qtype, 0);
+}
 
-  // Write question section after the header.
-  BigEndianWriter writer(reinterpret_cast<char*>(header + 1), question_size);
-  writer.WriteBytes(qname.data(), qname.size());
-  writer.WriteU16(qtype);
-  writer.WriteU16(dns_protocol::kClassIN);
+DnsQuery::DnsQuery(uint16 id,
+                   const base::StringPiece& qname,
+                   uint16 qtype,
+                   uint16 udp_payload_size) {
+  DCHECK_GE(udp_payload_size, dns_protocol::kMaxUDPSize);
+  Init(id, qname, qtype, udp_payload_size);
 }
 
 DnsQuery::~DnsQuery() {
@@ -65,6 +56,10 @@ uint16 DnsQuery::qtype() const {
   return type;
 }
 
+size_t DnsQuery::max_udp_response_size() const {
+  return udp_payload_size_ ? udp_payload_size_ : dns_protocol::kMaxUDPSize;
+}
+
 base::StringPiece DnsQuery::question() const {
   return base::StringPiece(io_buffer_->data() + sizeof(dns_protocol::Header),
                            qname_size_ + sizeof(uint16) + sizeof(uint16));
@@ -72,6 +67,7 @@ base::StringPiece DnsQuery::question() const {
 
 DnsQuery::DnsQuery(const DnsQuery& orig, uint16 id) {
   qname_size_ = orig.qname_size_;
+  udp_payload_size_ = orig.udp_payload_size_;
   io_buffer_ = new IOBufferWithSize(orig.io_buffer()->size());
   memcpy(io_buffer_.get()->data(), orig.io_buffer()->data(),
          io_buffer_.get()->size());
@@ -80,4 +76,44 @@ DnsQuery::DnsQuery(const DnsQuery& orig, uint16 id) {
   header->id = base::HostToNet16(id);
 }
 
+void DnsQuery::Init(uint16 id, const base::StringPiece& qname, uint16 qtype,
+                    uint16 udp_payload_size) {
+  DCHECK(!DNSDomainToString(qname).empty());
+  qname_size_ = qname.size();
+  udp_payload_size_ = udp_payload_size;
+  // QNAME + QTYPE + QCLASS
+  size_t question_size = qname_size_ + sizeof(uint16) + sizeof(uint16);
+  // The OPT RR has an empty NAME, then TYPE, CLASS, TTL and an empty RDATA.
+  const size_t kOptSize = 1 + sizeof(uint16) + sizeof(uint16) +
+      sizeof(uint32) + sizeof(uint16);
+  size_t additional_size = udp_payload_size ? kOptSize : 0;
+  io_buffer_ = new IOBufferWithSize(sizeof(dns_protocol::Header) +
+                                    question_size + additional_size);
+  dns_protocol::Header* header =
+      reinterpret_cast<dns_protocol::Header*>(io_buffer_->data());
+  memset(header, 0, sizeof(dns_protocol::Header));
+  header->id = base::HostToNet16(id);
+  header->flags = base::HostToNet16(dns_protocol::kFlagRD);
+  header->qdcount = base::HostToNet16(1);
+  if (udp_payload_size)
+    header->arcount = base::HostToNet16(1);
+
+  // Write question section after the header.
+  BigEndianWriter writer(reinterpret_cast<char*>(header + 1),
+                         question_size + additional_size);
+  writer.WriteBytes(qname.data(), qname.size());
+  writer.WriteU16(qtype);
+  writer.WriteU16(dns_protocol::kClassIN);
+
+  if (udp_payload_size) {
+    // The CLASS of an OPT RR is the payload size. The TTL holds the extended
+    // RCODE, the version and the flags, all zero.
+    writer.WriteU8(0);
+    writer.WriteU16(dns_protocol::kTypeOPT);
+    writer.WriteU16(udp_payload_size);
+    writer.WriteU32(0);
+    writer.WriteU16(0);
+  }
+}
+
 }  // namespace net
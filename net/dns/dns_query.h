@@ -16,12 +16,17 @@ namespace net {
 class IOBufferWithSize;
 
 // Represents on-the-wire DNS query message as an object.
-// TODO(szym): add support for the OPT pseudo-RR (EDNS0/DNSSEC).
 class NET_EXPORT_PRIVATE DnsQuery {
  public:
   // Constructs a query message from |qname| which *MUST* be in a valid
   // DNS name format, and |qtype|. The qclass is set to IN.
   DnsQuery(uint16 id, const base::StringPiece& qname, uint16 qtype);
+  // As above, but also adds an OPT pseudo-RR (EDNS0, RFC 6891) advertising
+  // that responses of up to |udp_payload_size| bytes can be received.
+  DnsQuery(uint16 id,
+           const base::StringPiece& qname,
+           uint16 qtype,
+           uint16 udp_payload_size);
   ~DnsQuery();
 
   // Clones |this| verbatim, with ID field of the header set to |id|.
@@ -32,6 +37,9 @@ class NET_EXPORT_PRIVATE DnsQuery {
   base::StringPiece qname() const;
   uint16 qtype() const;
 
+  // Returns the largest UDP response the query asks for.
+  size_t max_udp_response_size() const;
+
   // Returns the Question section of the query.  Used when matching the
   // response.
   base::StringPiece question() const;
@@ -42,10 +50,16 @@ class NET_EXPORT_PRIVATE DnsQuery {
  private:
   DnsQuery(const DnsQuery& orig, uint16 id);
 
+  void Init(uint16 id, const base::StringPiece& qname, uint16 qtype,
+            uint16 udp_payload_size);
+
   // Size of the DNS name (*NOT* hostname) we are trying to resolve; used
   // to calculate offsets.
   size_t qname_size_;
 
+  // The payload size advertised with EDNS0, or 0 if the query has no OPT RR.
+  uint16 udp_payload_size_;
+
   // Contains query bytes to be consumed by higher level Write() call.
   scoped_refptr<IOBufferWithSize> io_buffer_;
 
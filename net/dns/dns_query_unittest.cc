@@ -64,6 +64,43 @@ TEST(DnsQueryTest, Clone) {
   EXPECT_EQ(q1.question(), q2->question());
 }
 
+TEST(DnsQueryTest, Edns) {
+  // This includes \0 at the end.
+  const char qname_data[] = "\x03""www""\x07""example""\x03""com";
+  const uint8 opt_data[] = {
+    0x00,                     // NAME: root.
+    0x00, 0x29,               // TYPE: OPT.
+    0x04, 0xd0,               // CLASS: UDP payload size 1232.
+    0x00, 0x00, 0x00, 0x00,   // TTL: no extended RCODE or flags.
+    0x00, 0x00,               // RDLENGTH: no options.
+  };
+
+  base::StringPiece qname(qname_data, sizeof(qname_data));
+  DnsQuery q1(0xbeef, qname, dns_protocol::kTypeA,
+              dns_protocol::kEdnsPayloadSize);
+  EXPECT_EQ(static_cast<size_t>(dns_protocol::kEdnsPayloadSize),
+            q1.max_udp_response_size());
+
+  // ARCOUNT is 1.
+  EXPECT_EQ(0x00, q1.io_buffer()->data()[10]);
+  EXPECT_EQ(0x01, q1.io_buffer()->data()[11]);
+  // The OPT RR follows the question.
+  size_t question_end = 12 + q1.question().size();
+  ASSERT_EQ(static_cast<int>(question_end + sizeof(opt_data)),
+            q1.io_buffer()->size());
+  EXPECT_EQ(0, memcmp(q1.io_buffer()->data() + question_end, opt_data,
+                      sizeof(opt_data)));
+
+  scoped_ptr<DnsQuery> q2(q1.CloneWithNewId(42));
+  EXPECT_EQ(q1.max_udp_response_size(), q2->max_udp_response_size());
+  EXPECT_EQ(q1.io_buffer()->size(), q2->io_buffer()->size());
+
+  // Without EDNS0, responses are limited to 512 bytes.
+  DnsQuery q3(0xbeef, qname, dns_protocol::kTypeA);
+  EXPECT_EQ(static_cast<size_t>(dns_protocol::kMaxUDPSize),
+            q3.max_udp_response_size());
+}
+
 }  // namespace
 
 }  // namespace net
@@ -131,6 +131,10 @@ DnsResponse::DnsResponse()
     : io_buffer_(new IOBufferWithSize(dns_protocol::kMaxUDPSize + 1)) {
 }
 
+DnsResponse::DnsResponse(size_t length)
+    : io_buffer_(new IOBufferWithSize(length + 1)) {
+}
+
 DnsResponse::DnsResponse(const void* data,
                          size_t length,
                          size_t answer_offset)
@@ -144,9 +148,14 @@ DnsResponse::~DnsResponse() {
 }
 
 bool DnsResponse::InitParse(int nbytes, const DnsQuery& query) {
-  // Response includes query, it should be at least that size.
-  if (nbytes < query.io_buffer()->size() || nbytes > dns_protocol::kMaxUDPSize)
+  // Response includes the header and question of the query, it should be at
+  // least that size. (The OPT RR of the query need not be echoed.)
+  const size_t hdr_size = sizeof(dns_protocol::Header);
+  const base::StringPiece question = query.question();
+  if (nbytes < static_cast<int>(hdr_size + question.size()) ||
+      nbytes >= io_buffer_->size()) {
     return false;
+  }
 
   // Match the query id.
   if (base::NetToHost16(header()->id) != query.id())
@@ -157,8 +166,6 @@ bool DnsResponse::InitParse(int nbytes, const DnsQuery& query) {
     return false;
 
   // Match the question section.
-  const size_t hdr_size = sizeof(dns_protocol::Header);
-  const base::StringPiece question = query.question();
   if (question != base::StringPiece(io_buffer_->data() + hdr_size,
                                     question.size())) {
     return false;
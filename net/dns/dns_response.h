@@ -100,6 +100,9 @@ class NET_EXPORT_PRIVATE DnsResponse {
   // one byte more than largest possible response, to detect malformed
   // responses.
   DnsResponse();
+  // As above, for a response of up to |length| bytes, e.g. one received over
+  // TCP or solicited with EDNS0.
+  explicit DnsResponse(size_t length);
   // Constructs response from |data|. Used for testing purposes only!
   DnsResponse(const void* data, size_t length, size_t answer_offset);
   ~DnsResponse();
@@ -108,8 +111,9 @@ class NET_EXPORT_PRIVATE DnsResponse {
   // read.
   IOBufferWithSize* io_buffer() { return io_buffer_.get(); }
 
-  // Returns false if the packet is shorter than the header or does not match
-  // |query| id or question.
+  // Returns false if the packet is shorter than the header, fills the whole
+  // buffer (and so may have been truncated), or does not match |query| id or
+  // question.
   bool InitParse(int nbytes, const DnsQuery& query);
 
   // Returns true if response is valid, that is, after successful InitParse.
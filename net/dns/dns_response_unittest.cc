@@ -212,6 +212,10 @@ TEST(DnsResponseTest, InitParse) {
   EXPECT_FALSE(resp.InitParse(query->io_buffer()->size() - 1, *query));
   EXPECT_FALSE(resp.IsValid());
 
+  // Reject a packet that fills the buffer; it may have been truncated.
+  EXPECT_FALSE(resp.InitParse(resp.io_buffer()->size(), *query));
+  EXPECT_FALSE(resp.IsValid());
+
   // Reject wrong id.
   scoped_ptr<DnsQuery> other_query(query->CloneWithNewId(0xbeef));
   EXPECT_FALSE(resp.InitParse(sizeof(response_data), *other_query));
@@ -227,6 +231,13 @@ TEST(DnsResponseTest, InitParse) {
   EXPECT_TRUE(resp.InitParse(sizeof(response_data), *query));
   EXPECT_TRUE(resp.IsValid());
 
+  // A response solicited with EDNS0 may exceed 512 bytes.
+  DnsResponse large_resp(dns_protocol::kEdnsPayloadSize);
+  EXPECT_EQ(dns_protocol::kEdnsPayloadSize + 1,
+            large_resp.io_buffer()->size());
+  memcpy(large_resp.io_buffer()->data(), response_data, sizeof(response_data));
+  EXPECT_TRUE(large_resp.InitParse(dns_protocol::kMaxUDPSize + 1, *query));
+
   // Check header access.
   EXPECT_EQ(0x8180, resp.flags());
   EXPECT_EQ(0x0, resp.rcode());
@@ -4,6 +4,8 @@
 
 #include "net/dns/dns_session.h"
 
+#include <algorithm>
+
 #include "base/basictypes.h"
 #include "base/bind.h"
 #include "base/time.h"
@@ -13,6 +15,14 @@
 
 namespace net {
 
+namespace {
+
+// Timeouts derived from measured RTTs are never shorter than this, so that
+// a little jitter on a fast network doesn't cause retransmissions.
+const int kMinTimeoutMs = 50;
+
+}  // namespace
+
 DnsSession::DnsSession(const DnsConfig& config,
                        ClientSocketFactory* factory,
                        const RandIntCallback& rand_int_callback,
@@ -21,7 +31,10 @@ DnsSession::DnsSession(const DnsConfig& config,
       socket_factory_(factory),
       rand_callback_(base::Bind(rand_int_callback, 0, kuint16max)),
       net_log_(net_log),
-      server_index_(0) {
+      server_index_(0),
+      rtt_estimates_(config.nameservers.size()),
+      max_parallel_queries_(1),
+      udp_payload_size_(0) {
 }
 
 int DnsSession::NextQueryId() const {
@@ -35,10 +48,36 @@ int DnsSession::NextFirstServerIndex() {
   return index;
 }
 
-base::TimeDelta DnsSession::NextTimeout(int attempt) {
+base::TimeDelta DnsSession::NextTimeout(unsigned server_index, int attempt) {
+  DCHECK_LT(server_index, rtt_estimates_.size());
+  // Until a server has answered, use the configured timeout. Afterwards,
+  // allow four deviations above the smoothed RTT, but never more than the
+  // configured timeout.
+  base::TimeDelta timeout = config_.timeout;
+  const RTTEstimate& estimate = rtt_estimates_[server_index];
+  if (estimate.has_samples) {
+    timeout = std::min(timeout, std::max(
+        base::TimeDelta::FromMilliseconds(kMinTimeoutMs),
+        estimate.srtt + 4 * estimate.rttvar));
+  }
   // The timeout doubles every full round (each nameserver once).
-  // TODO(szym): Adapt timeout to observed RTT. http://crbug.com/110197
-  return config_.timeout * (1 << (attempt / config_.nameservers.size()));
+  return timeout * (1 << (attempt / config_.nameservers.size()));
+}
+
+void DnsSession::RecordRTT(unsigned server_index, base::TimeDelta rtt) {
+  DCHECK_LT(server_index, rtt_estimates_.size());
+  RTTEstimate& estimate = rtt_estimates_[server_index];
+  if (!estimate.has_samples) {
+    estimate.has_samples = true;
+    estimate.srtt = rtt;
+    estimate.rttvar = rtt / 2;
+    return;
+  }
+  base::TimeDelta deviation = estimate.srtt - rtt;
+  if (deviation < base::TimeDelta())
+    deviation = -deviation;
+  estimate.rttvar = (3 * estimate.rttvar + deviation) / 4;
+  estimate.srtt = (7 * estimate.srtt + rtt) / 8;
 }
 
 DnsSession::~DnsSession() {}
@@ -6,6 +6,9 @@
 #define NET_DNS_DNS_SESSION_H_
 #pragma once
 
+#include <vector>
+
+#include "base/logging.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/time.h"
@@ -42,8 +45,28 @@ class NET_EXPORT_PRIVATE DnsSession
   // Return the index of the first configured server to use on first attempt.
   int NextFirstServerIndex();
 
-  // Return the timeout for the next query.
-  base::TimeDelta NextTimeout(int attempt);
+  // Return the timeout for attempt number |attempt| (counting from 0) of a
+  // query, sent to the server at |server_index|.
+  base::TimeDelta NextTimeout(unsigned server_index, int attempt);
+
+  // Records the round-trip time of an exchange with the server at
+  // |server_index|, which refines the timeouts of later attempts to it.
+  void RecordRTT(unsigned server_index, base::TimeDelta rtt);
+
+  // The number of names on the search list that a transaction may query at
+  // once. Results are still taken in search-list order.
+  size_t max_parallel_queries() const { return max_parallel_queries_; }
+  void set_max_parallel_queries(size_t max_parallel_queries) {
+    DCHECK_GT(max_parallel_queries, 0u);
+    max_parallel_queries_ = max_parallel_queries;
+  }
+
+  // The UDP payload size to advertise with EDNS0, or 0 to send queries
+  // without an OPT RR.
+  uint16 udp_payload_size() const { return udp_payload_size_; }
+  void set_udp_payload_size(uint16 udp_payload_size) {
+    udp_payload_size_ = udp_payload_size;
+  }
 
  private:
   friend class base::RefCounted<DnsSession>;
@@ -54,11 +77,25 @@ class NET_EXPORT_PRIVATE DnsSession
   RandCallback rand_callback_;
   NetLog* net_log_;
 
+  // Smoothed round-trip time and its mean deviation, as in TCP (RFC 6298).
+  struct RTTEstimate {
+    RTTEstimate() : has_samples(false) {}
+
+    bool has_samples;
+    base::TimeDelta srtt;
+    base::TimeDelta rttvar;
+  };
+
   // Current index into |config_.nameservers| to begin resolution with.
   int server_index_;
 
-  // TODO(szym): Add current RTT estimate.
-  // TODO(szym): Add TCP connection pool to support DNS over TCP.
+  // One estimate for each of |config_.nameservers|.
+  std::vector<RTTEstimate> rtt_estimates_;
+
+  size_t max_parallel_queries_;
+  uint16 udp_payload_size_;
+
+  // TODO(szym): Add TCP connection pool to reuse DNS over TCP connections.
   // TODO(szym): Add UDP port pool to avoid NAT table overload.
 
   DISALLOW_COPY_AND_ASSIGN(DnsSession);
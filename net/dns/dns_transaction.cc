@@ -18,8 +18,11 @@
 #include "base/stl_util.h"
 #include "base/string_piece.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time.h"
 #include "base/timer.h"
 #include "base/values.h"
+#include "net/base/address_list.h"
+#include "net/base/big_endian.h"
 #include "net/base/completion_callback.h"
 #include "net/base/dns_util.h"
 #include "net/base/io_buffer.h"
@@ -31,6 +34,7 @@
 #include "net/dns/dns_response.h"
 #include "net/dns/dns_session.h"
 #include "net/socket/client_socket_factory.h"
+#include "net/socket/stream_socket.h"
 #include "net/udp/datagram_client_socket.h"
 
 namespace net {
@@ -95,45 +99,88 @@ class ResponseParameters : public NetLog::EventParameters {
 
 // ----------------------------------------------------------------------------
 
-// A single asynchronous DNS exchange over UDP, which consists of sending out a
-// DNS query, waiting for a response, and returning the response that it
-// matches. Logging is done in the socket and in the outer DnsTransaction.
-class DnsUDPAttempt {
+// Maps the rcode of a parsed response to the result of the attempt.
+int ResultOfResponse(const DnsResponse& response) {
+  // TODO(szym): Extract TTL for NXDOMAIN results. http://crbug.com/115051
+  if (response.rcode() == dns_protocol::kRcodeNXDOMAIN)
+    return ERR_NAME_NOT_RESOLVED;
+  if (response.rcode() != dns_protocol::kRcodeNOERROR)
+    return ERR_DNS_SERVER_FAILED;
+  return OK;
+}
+
+// A single asynchronous DNS exchange with one server, which consists of
+// sending out a DNS query, waiting for a response, and returning the response
+// that it matches. Logging is done in the socket and in the outer
+// DnsTransaction.
+class DnsAttempt {
  public:
-  DnsUDPAttempt(scoped_ptr<DatagramClientSocket> socket,
+  explicit DnsAttempt(unsigned server_index)
+      : server_index_(server_index),
+        start_time_(base::TimeTicks::Now()) {
+  }
+  virtual ~DnsAttempt() {}
+
+  // Starts the attempt. Returns ERR_IO_PENDING if cannot complete synchronously
+  // and calls the callback upon completion.
+  virtual int Start() = 0;
+
+  virtual const DnsQuery* GetQuery() const = 0;
+
+  // Returns the response or NULL if has not received a matching response from
+  // the server.
+  virtual const DnsResponse* GetResponse() const = 0;
+
+  virtual const BoundNetLog& GetSocketNetLog() const = 0;
+
+  // Index of the server within DnsConfig::nameservers.
+  unsigned server_index() const { return server_index_; }
+
+  base::TimeTicks start_time() const { return start_time_; }
+
+ private:
+  const unsigned server_index_;
+  const base::TimeTicks start_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(DnsAttempt);
+};
+
+// An exchange over UDP. The response may be as large as the query advertises
+// with EDNS0.
+class DnsUDPAttempt : public DnsAttempt {
+ public:
+  DnsUDPAttempt(unsigned server_index,
+                scoped_ptr<DatagramClientSocket> socket,
                 const IPEndPoint& server,
                 scoped_ptr<DnsQuery> query,
                 const CompletionCallback& callback)
-      : next_state_(STATE_NONE),
+      : DnsAttempt(server_index),
+        next_state_(STATE_NONE),
         socket_(socket.Pass()),
         server_(server),
         query_(query.Pass()),
         callback_(callback) {
   }
 
-  // Starts the attempt. Returns ERR_IO_PENDING if cannot complete synchronously
-  // and calls |callback| upon completion.
-  int Start() {
+  virtual int Start() OVERRIDE {
     DCHECK_EQ(STATE_NONE, next_state_);
     next_state_ = STATE_CONNECT;
     return DoLoop(OK);
   }
 
-  const DnsQuery* query() const {
+  virtual const DnsQuery* GetQuery() const OVERRIDE {
     return query_.get();
   }
 
-  const DatagramClientSocket* socket() const {
-    return socket_.get();
-  }
-
-  // Returns the response or NULL if has not received a matching response from
-  // the server.
-  const DnsResponse* response() const {
+  virtual const DnsResponse* GetResponse() const OVERRIDE {
     const DnsResponse* resp = response_.get();
     return (resp != NULL && resp->IsValid()) ? resp : NULL;
   }
 
+  virtual const BoundNetLog& GetSocketNetLog() const OVERRIDE {
+    return socket_->NetLog();
+  }
+
  private:
   enum State {
     STATE_CONNECT,
@@ -203,7 +250,7 @@ class DnsUDPAttempt {
 
   int DoReadResponse() {
     next_state_ = STATE_READ_RESPONSE_COMPLETE;
-    response_.reset(new DnsResponse());
+    response_.reset(new DnsResponse(query_->max_udp_response_size()));
     return socket_->Read(response_->io_buffer(),
                          response_->io_buffer()->size(),
                          base::Bind(&DnsUDPAttempt::OnIOComplete,
@@ -226,14 +273,9 @@ class DnsUDPAttempt {
     }
     if (response_->flags() & dns_protocol::kFlagTC)
       return ERR_DNS_SERVER_REQUIRES_TCP;
-    // TODO(szym): Extract TTL for NXDOMAIN results. http://crbug.com/115051
-    if (response_->rcode() == dns_protocol::kRcodeNXDOMAIN)
-      return ERR_NAME_NOT_RESOLVED;
-    if (response_->rcode() != dns_protocol::kRcodeNOERROR)
-      return ERR_DNS_SERVER_FAILED;
-
-    CHECK(response());
-    return OK;
+    rv = ResultOfResponse(*response_);
+    CHECK(rv != OK || GetResponse());
+    return rv;
   }
 
   void OnIOComplete(int rv) {
@@ -255,14 +297,226 @@ class DnsUDPAttempt {
   DISALLOW_COPY_AND_ASSIGN(DnsUDPAttempt);
 };
 
+// An exchange over TCP, used when a UDP response came back truncated. Each
+// message is prefixed with its length (RFC 1035, section 4.2.2).
+class DnsTCPAttempt : public DnsAttempt {
+ public:
+  DnsTCPAttempt(unsigned server_index,
+                scoped_ptr<StreamSocket> socket,
+                scoped_ptr<DnsQuery> query,
+                const CompletionCallback& callback)
+      : DnsAttempt(server_index),
+        next_state_(STATE_NONE),
+        socket_(socket.Pass()),
+        query_(query.Pass()),
+        length_buffer_(new IOBufferWithSize(sizeof(uint16))),
+        response_length_(0),
+        callback_(callback) {
+  }
+
+  virtual int Start() OVERRIDE {
+    DCHECK_EQ(STATE_NONE, next_state_);
+    next_state_ = STATE_CONNECT_COMPLETE;
+    return DoLoop(socket_->Connect(base::Bind(&DnsTCPAttempt::OnIOComplete,
+                                              base::Unretained(this))));
+  }
+
+  virtual const DnsQuery* GetQuery() const OVERRIDE {
+    return query_.get();
+  }
+
+  virtual const DnsResponse* GetResponse() const OVERRIDE {
+    const DnsResponse* resp = response_.get();
+    return (resp != NULL && resp->IsValid()) ? resp : NULL;
+  }
+
+  virtual const BoundNetLog& GetSocketNetLog() const OVERRIDE {
+    return socket_->NetLog();
+  }
+
+ private:
+  enum State {
+    STATE_CONNECT_COMPLETE,
+    STATE_SEND_QUERY,
+    STATE_SEND_QUERY_COMPLETE,
+    STATE_READ_LENGTH,
+    STATE_READ_LENGTH_COMPLETE,
+    STATE_READ_RESPONSE,
+    STATE_READ_RESPONSE_COMPLETE,
+    STATE_NONE,
+  };
+
+  int DoLoop(int result) {
+    CHECK_NE(STATE_NONE, next_state_);
+    int rv = result;
+    do {
+      State state = next_state_;
+      next_state_ = STATE_NONE;
+      switch (state) {
+        case STATE_CONNECT_COMPLETE:
+          rv = DoConnectComplete(rv);
+          break;
+        case STATE_SEND_QUERY:
+          rv = DoSendQuery();
+          break;
+        case STATE_SEND_QUERY_COMPLETE:
+          rv = DoSendQueryComplete(rv);
+          break;
+        case STATE_READ_LENGTH:
+          rv = DoReadLength();
+          break;
+        case STATE_READ_LENGTH_COMPLETE:
+          rv = DoReadLengthComplete(rv);
+          break;
+        case STATE_READ_RESPONSE:
+          rv = DoReadResponse();
+          break;
+        case STATE_READ_RESPONSE_COMPLETE:
+          rv = DoReadResponseComplete(rv);
+          break;
+        default:
+          NOTREACHED();
+          break;
+      }
+    } while (rv != ERR_IO_PENDING && next_state_ != STATE_NONE);
+
+    return rv;
+  }
+
+  int DoConnectComplete(int rv) {
+    DCHECK_NE(ERR_IO_PENDING, rv);
+    if (rv < 0)
+      return rv;
+
+    // Send the length and the query in one write.
+    int query_size = query_->io_buffer()->size();
+    scoped_refptr<IOBufferWithSize> buffer(
+        new IOBufferWithSize(sizeof(uint16) + query_size));
+    WriteBigEndian<uint16>(buffer->data(), static_cast<uint16>(query_size));
+    memcpy(buffer->data() + sizeof(uint16), query_->io_buffer()->data(),
+           query_size);
+    buffer_ = new DrainableIOBuffer(buffer, buffer->size());
+    next_state_ = STATE_SEND_QUERY;
+    return OK;
+  }
+
+  int DoSendQuery() {
+    next_state_ = STATE_SEND_QUERY_COMPLETE;
+    return socket_->Write(buffer_, buffer_->BytesRemaining(),
+                          base::Bind(&DnsTCPAttempt::OnIOComplete,
+                                     base::Unretained(this)));
+  }
+
+  int DoSendQueryComplete(int rv) {
+    DCHECK_NE(ERR_IO_PENDING, rv);
+    if (rv < 0)
+      return rv;
+
+    buffer_->DidConsume(rv);
+    if (buffer_->BytesRemaining() > 0) {
+      next_state_ = STATE_SEND_QUERY;
+      return OK;
+    }
+    buffer_ = new DrainableIOBuffer(length_buffer_, length_buffer_->size());
+    next_state_ = STATE_READ_LENGTH;
+    return OK;
+  }
+
+  int DoReadLength() {
+    next_state_ = STATE_READ_LENGTH_COMPLETE;
+    return socket_->Read(buffer_, buffer_->BytesRemaining(),
+                         base::Bind(&DnsTCPAttempt::OnIOComplete,
+                                    base::Unretained(this)));
+  }
+
+  int DoReadLengthComplete(int rv) {
+    DCHECK_NE(ERR_IO_PENDING, rv);
+    if (rv < 0)
+      return rv;
+    if (rv == 0)
+      return ERR_CONNECTION_CLOSED;
+
+    buffer_->DidConsume(rv);
+    if (buffer_->BytesRemaining() > 0) {
+      next_state_ = STATE_READ_LENGTH;
+      return OK;
+    }
+    ReadBigEndian<uint16>(length_buffer_->data(), &response_length_);
+    // The response includes at least the question of the query.
+    if (response_length_ <
+        sizeof(dns_protocol::Header) + query_->question().size()) {
+      return ERR_DNS_MALFORMED_RESPONSE;
+    }
+    response_.reset(new DnsResponse(response_length_));
+    buffer_ = new DrainableIOBuffer(response_->io_buffer(), response_length_);
+    next_state_ = STATE_READ_RESPONSE;
+    return OK;
+  }
+
+  int DoReadResponse() {
+    next_state_ = STATE_READ_RESPONSE_COMPLETE;
+    return socket_->Read(buffer_, buffer_->BytesRemaining(),
+                         base::Bind(&DnsTCPAttempt::OnIOComplete,
+                                    base::Unretained(this)));
+  }
+
+  int DoReadResponseComplete(int rv) {
+    DCHECK_NE(ERR_IO_PENDING, rv);
+    if (rv < 0)
+      return rv;
+    if (rv == 0)
+      return ERR_CONNECTION_CLOSED;
+
+    buffer_->DidConsume(rv);
+    if (buffer_->BytesRemaining() > 0) {
+      next_state_ = STATE_READ_RESPONSE;
+      return OK;
+    }
+    if (!response_->InitParse(response_length_, *query_))
+      return ERR_DNS_MALFORMED_RESPONSE;
+    // There is nothing to fall back to if even the TCP response is truncated.
+    if (response_->flags() & dns_protocol::kFlagTC)
+      return ERR_DNS_MALFORMED_RESPONSE;
+    rv = ResultOfResponse(*response_);
+    CHECK(rv != OK || GetResponse());
+    return rv;
+  }
+
+  void OnIOComplete(int rv) {
+    rv = DoLoop(rv);
+    if (rv != ERR_IO_PENDING)
+      callback_.Run(rv);
+  }
+
+  State next_state_;
+
+  scoped_ptr<StreamSocket> socket_;
+  scoped_ptr<DnsQuery> query_;
+
+  // The buffer of the current read or write.
+  scoped_refptr<DrainableIOBuffer> buffer_;
+  scoped_refptr<IOBufferWithSize> length_buffer_;
+  uint16 response_length_;
+
+  scoped_ptr<DnsResponse> response_;
+
+  CompletionCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(DnsTCPAttempt);
+};
+
 // ----------------------------------------------------------------------------
 
 // Implements DnsTransaction. Configuration is supplied by DnsSession.
 // The suffix list is built according to the DnsConfig from the session.
+// Up to DnsSession::max_parallel_queries names on the list are queried at
+// once, but their results are taken in list order: the first name to not be
+// NXDOMAIN decides the transaction.
 // The timeout for each DnsUDPAttempt is given by DnsSession::NextTimeout.
 // The first server to attempt on each query is given by
 // DnsSession::NextFirstServerIndex, and the order is round-robin afterwards.
-// Each server is attempted DnsConfig::attempts times.
+// Each server is attempted DnsConfig::attempts times. A truncated response
+// is retried over TCP, with the same server.
 class DnsTransactionImpl : public DnsTransaction,
                            public base::NonThreadSafe,
                            public base::SupportsWeakPtr<DnsTransactionImpl> {
@@ -277,7 +531,7 @@ class DnsTransactionImpl : public DnsTransaction,
       qtype_(qtype),
       callback_(callback),
       net_log_(net_log),
-      first_server_index_(0) {
+      first_pending_(0) {
     DCHECK(session_);
     DCHECK(!hostname_.empty());
     DCHECK(!callback_.is_null());
@@ -303,12 +557,12 @@ class DnsTransactionImpl : public DnsTransaction,
 
   virtual int Start() OVERRIDE {
     DCHECK(!callback_.is_null());
-    DCHECK(attempts_.empty());
+    DCHECK(queries_.empty());
     net_log_.BeginEvent(NetLog::TYPE_DNS_TRANSACTION, make_scoped_refptr(
         new StartParameters(hostname_, qtype_)));
     int rv = PrepareSearch();
     if (rv == OK) {
-      AttemptResult result = FinishAttempt(StartQuery());
+      AttemptResult result = ProcessQueries();
       if (result.rv == OK) {
         // DnsTransaction must never succeed synchronously.
         MessageLoop::current()->PostTask(
@@ -319,6 +573,7 @@ class DnsTransactionImpl : public DnsTransaction,
       rv = result.rv;
     }
     if (rv != ERR_IO_PENDING) {
+      StopQueries();
       callback_.Reset();
       net_log_.EndEventWithNetErrorCode(NetLog::TYPE_DNS_TRANSACTION, rv);
     }
@@ -327,13 +582,38 @@ class DnsTransactionImpl : public DnsTransaction,
   }
 
  private:
-  // Wrapper for the result of a DnsUDPAttempt.
+  // Wrapper for the result of a DnsAttempt.
   struct AttemptResult {
-    AttemptResult(int rv, const DnsUDPAttempt* attempt)
+    AttemptResult(int rv, const DnsAttempt* attempt)
         : rv(rv), attempt(attempt) {}
 
     int rv;
-    const DnsUDPAttempt* attempt;
+    const DnsAttempt* attempt;
+  };
+
+  // The state of the query for one name on the search list.
+  struct QueryState {
+    explicit QueryState(const std::string& qname)
+        : qname(qname),
+          first_server_index(0),
+          result(ERR_IO_PENDING, NULL),
+          timer(false, false) {
+    }
+
+    bool done() const { return result.rv != ERR_IO_PENDING; }
+
+    // In DNS format.
+    std::string qname;
+    ScopedVector<DnsAttempt> attempts;
+    // Index of the first server to try.
+    unsigned first_server_index;
+    // ERR_IO_PENDING until the query is done.
+    AttemptResult result;
+    // Fires when the latest attempt times out.
+    base::Timer timer;
+
+   private:
+    DISALLOW_COPY_AND_ASSIGN(QueryState);
   };
 
   // Prepares |qnames_| according to the DnsConfig.
@@ -388,10 +668,10 @@ class DnsTransactionImpl : public DnsTransaction,
     DCHECK(!callback_.is_null());
     DCHECK_NE(ERR_IO_PENDING, result.rv);
     const DnsResponse* response = result.attempt ?
-        result.attempt->response() : NULL;
+        result.attempt->GetResponse() : NULL;
     CHECK(result.rv != OK || response != NULL);
 
-    timer_.Stop();
+    StopQueries();
 
     DnsTransactionFactory::CallbackType callback = callback_;
     callback_.Reset();
@@ -400,10 +680,23 @@ class DnsTransactionImpl : public DnsTransaction,
     callback.Run(this, result.rv, response);
   }
 
-  // Makes another attempt at the current name, |qnames_.front()|, using the
+  // Abandons the queries that are still running.
+  void StopQueries() {
+    for (size_t i = first_pending_; i < queries_.size(); ++i) {
+      QueryState* query = queries_[i];
+      if (query->done())
+        continue;
+      query->timer.Stop();
+      net_log_.EndEventWithNetErrorCode(
+          NetLog::TYPE_DNS_TRANSACTION_QUERY, ERR_ABORTED);
+    }
+  }
+
+  // Makes another attempt at the query |query_index| over UDP, using the
   // next nameserver.
-  AttemptResult MakeAttempt() {
-    unsigned attempt_number = attempts_.size();
+  AttemptResult MakeAttempt(size_t query_index) {
+    QueryState* query = queries_[query_index];
+    unsigned attempt_number = query->attempts.size();
 
 #if defined(OS_WIN)
     // Avoid the Windows firewall warning about explicit UDP binding.
@@ -421,11 +714,17 @@ class DnsTransactionImpl : public DnsTransaction,
             net_log_.source()));
 
     uint16 id = session_->NextQueryId();
-    scoped_ptr<DnsQuery> query;
-    if (attempts_.empty()) {
-      query.reset(new DnsQuery(id, qnames_.front(), qtype_));
+    scoped_ptr<DnsQuery> query_message;
+    if (query->attempts.empty()) {
+      if (session_->udp_payload_size()) {
+        query_message.reset(new DnsQuery(id, query->qname, qtype_,
+                                         session_->udp_payload_size()));
+      } else {
+        query_message.reset(new DnsQuery(id, query->qname, qtype_));
+      }
     } else {
-      query.reset(attempts_[0]->query()->CloneWithNewId(id));
+      query_message.reset(
+          query->attempts[0]->GetQuery()->CloneWithNewId(id));
     }
 
     net_log_.AddEvent(NetLog::TYPE_DNS_TRANSACTION_ATTEMPT, make_scoped_refptr(
@@ -434,121 +733,237 @@ class DnsTransactionImpl : public DnsTransaction,
 
     const DnsConfig& config = session_->config();
 
-    unsigned server_index = first_server_index_ +
-        (attempt_number % config.nameservers.size());
+    unsigned server_index = (query->first_server_index + attempt_number) %
+        config.nameservers.size();
 
     DnsUDPAttempt* attempt = new DnsUDPAttempt(
+        server_index,
         socket.Pass(),
         config.nameservers[server_index],
-        query.Pass(),
+        query_message.Pass(),
+        base::Bind(&DnsTransactionImpl::OnUDPAttemptComplete,
+                   base::Unretained(this),
+                   query_index,
+                   attempt_number));
+
+    query->attempts.push_back(attempt);
+
+    int rv = attempt->Start();
+    if (rv == ERR_IO_PENDING) {
+      base::TimeDelta timeout = session_->NextTimeout(server_index,
+                                                      attempt_number);
+      StartTimer(query_index, timeout);
+    } else {
+      RecordRTT(attempt);
+    }
+    return AttemptResult(rv, attempt);
+  }
+
+  // Repeats the UDP |previous_attempt| of the query |query_index| over TCP.
+  AttemptResult MakeTCPAttempt(size_t query_index,
+                               const DnsAttempt* previous_attempt) {
+    QueryState* query = queries_[query_index];
+    unsigned attempt_number = query->attempts.size();
+    unsigned server_index = previous_attempt->server_index();
+    const IPEndPoint& server = session_->config().nameservers[server_index];
+
+    scoped_ptr<StreamSocket> socket(
+        session_->socket_factory()->CreateTransportClientSocket(
+            AddressList::CreateFromIPAddress(server.address(), server.port()),
+            net_log_.net_log(),
+            net_log_.source()));
+
+    uint16 id = session_->NextQueryId();
+    scoped_ptr<DnsQuery> query_message(
+        previous_attempt->GetQuery()->CloneWithNewId(id));
+
+    net_log_.AddEvent(NetLog::TYPE_DNS_TRANSACTION_TCP_ATTEMPT,
+        make_scoped_refptr(new NetLogSourceParameter(
+            "source_dependency", socket->NetLog().source())));
+
+    DnsTCPAttempt* attempt = new DnsTCPAttempt(
+        server_index,
+        socket.Pass(),
+        query_message.Pass(),
         base::Bind(&DnsTransactionImpl::OnAttemptComplete,
                    base::Unretained(this),
+                   query_index,
                    attempt_number));
 
-    attempts_.push_back(attempt);
+    query->attempts.push_back(attempt);
 
     int rv = attempt->Start();
     if (rv == ERR_IO_PENDING) {
-      timer_.Stop();
-      base::TimeDelta timeout = session_->NextTimeout(attempt_number);
-      timer_.Start(FROM_HERE, timeout, this, &DnsTransactionImpl::OnTimeout);
+      // A TCP exchange takes at least one more round trip for the handshake,
+      // and the response may take several to arrive.
+      base::TimeDelta timeout =
+          2 * session_->NextTimeout(server_index, attempt_number);
+      StartTimer(query_index, timeout);
     }
     return AttemptResult(rv, attempt);
   }
 
-  // Begins query for the current name. Makes the first attempt.
-  AttemptResult StartQuery() {
-    std::string dotted_qname = DNSDomainToString(qnames_.front());
+  void StartTimer(size_t query_index, base::TimeDelta timeout) {
+    QueryState* query = queries_[query_index];
+    query->timer.Stop();
+    query->timer.Start(FROM_HERE, timeout,
+                       base::Bind(&DnsTransactionImpl::OnTimeout,
+                                  base::Unretained(this),
+                                  query_index));
+  }
+
+  // Feeds the round-trip time of a UDP exchange that got a response to the
+  // session, to adapt the timeouts of later attempts.
+  void RecordRTT(const DnsAttempt* attempt) {
+    if (!attempt->GetResponse())
+      return;
+    session_->RecordRTT(attempt->server_index(),
+                        base::TimeTicks::Now() - attempt->start_time());
+  }
+
+  // Begins the query for the next name on the list. Makes the first attempt.
+  void StartQuery() {
+    DCHECK(!qnames_.empty());
+    QueryState* query = new QueryState(qnames_.front());
+    qnames_.pop_front();
+
+    std::string dotted_qname = DNSDomainToString(query->qname);
     net_log_.BeginEvent(
         NetLog::TYPE_DNS_TRANSACTION_QUERY,
         make_scoped_refptr(new NetLogStringParameter("qname", dotted_qname)));
 
-    first_server_index_ = session_->NextFirstServerIndex();
+    query->first_server_index = session_->NextFirstServerIndex();
+
+    queries_.push_back(query);
+    size_t query_index = queries_.size() - 1;
+    FinishAttempt(query_index, MakeAttempt(query_index));
+  }
+
+  // Takes the results of the queries that are done, in search-list order,
+  // and starts queries for further names as the window allows. Returns the
+  // result of the transaction, or ERR_IO_PENDING if it is not known yet.
+  AttemptResult ProcessQueries() {
+    for (;;) {
+      while (first_pending_ < queries_.size() &&
+             queries_[first_pending_]->done()) {
+        AttemptResult result = queries_[first_pending_]->result;
+        if (result.rv != ERR_NAME_NOT_RESOLVED)
+          return result;
+        // Try next suffix.
+        ++first_pending_;
+      }
+      if (qnames_.empty()) {
+        if (first_pending_ == queries_.size())
+          return AttemptResult(ERR_NAME_NOT_RESOLVED, NULL);
+        return AttemptResult(ERR_IO_PENDING, NULL);
+      }
+      if (queries_.size() - first_pending_ >= session_->max_parallel_queries())
+        return AttemptResult(ERR_IO_PENDING, NULL);
+      StartQuery();
+    }
+  }
 
-    attempts_.reset();
-    return MakeAttempt();
+  void OnUDPAttemptComplete(size_t query_index,
+                            unsigned attempt_number,
+                            int rv) {
+    if (!callback_.is_null())
+      RecordRTT(queries_[query_index]->attempts[attempt_number]);
+    OnAttemptComplete(query_index, attempt_number, rv);
   }
 
-  void OnAttemptComplete(unsigned attempt_number, int rv) {
+  void OnAttemptComplete(size_t query_index, unsigned attempt_number, int rv) {
     if (callback_.is_null())
       return;
-    DCHECK_LT(attempt_number, attempts_.size());
-    const DnsUDPAttempt* attempt = attempts_[attempt_number];
-    AttemptResult result = FinishAttempt(AttemptResult(rv, attempt));
+    QueryState* query = queries_[query_index];
+    if (query->done())
+      return;
+    DCHECK_LT(attempt_number, query->attempts.size());
+    const DnsAttempt* attempt = query->attempts[attempt_number];
+    FinishAttempt(query_index, AttemptResult(rv, attempt));
+    AttemptResult result = ProcessQueries();
     if (result.rv != ERR_IO_PENDING)
       DoCallback(result);
   }
 
-  void LogResponse(const DnsUDPAttempt* attempt) {
-    if (attempt && attempt->response()) {
+  void LogResponse(const DnsAttempt* attempt) {
+    if (attempt && attempt->GetResponse()) {
       net_log_.AddEvent(
           NetLog::TYPE_DNS_TRANSACTION_RESPONSE,
           make_scoped_refptr(
-              new ResponseParameters(attempt->response()->rcode(),
-                                     attempt->response()->answer_count(),
-                                     attempt->socket()->NetLog().source())));
+              new ResponseParameters(attempt->GetResponse()->rcode(),
+                                     attempt->GetResponse()->answer_count(),
+                                     attempt->GetSocketNetLog().source())));
     }
   }
 
-  bool MoreAttemptsAllowed() const {
+  bool MoreAttemptsAllowed(const QueryState* query) const {
     const DnsConfig& config = session_->config();
-    return attempts_.size() < config.attempts * config.nameservers.size();
+    return query->attempts.size() <
+        config.attempts * config.nameservers.size();
   }
 
-  // Resolves the result of a DnsUDPAttempt until a terminal result is reached
-  // or it will complete asynchronously (ERR_IO_PENDING).
-  AttemptResult FinishAttempt(AttemptResult result) {
+  // Marks the query |query_index| done with |result|.
+  void SetQueryResult(size_t query_index, AttemptResult result) {
+    QueryState* query = queries_[query_index];
+    DCHECK(!query->done());
+    query->timer.Stop();
+    query->result = result;
+    net_log_.EndEventWithNetErrorCode(
+        NetLog::TYPE_DNS_TRANSACTION_QUERY, result.rv);
+  }
+
+  // Resolves the result of a DnsAttempt of the query |query_index| until the
+  // query is done or it will complete asynchronously (ERR_IO_PENDING).
+  void FinishAttempt(size_t query_index, AttemptResult result) {
+    QueryState* query = queries_[query_index];
     while (result.rv != ERR_IO_PENDING) {
       LogResponse(result.attempt);
 
       switch (result.rv) {
         case OK:
-          net_log_.EndEventWithNetErrorCode(
-              NetLog::TYPE_DNS_TRANSACTION_QUERY, result.rv);
           DCHECK(result.attempt);
-          DCHECK(result.attempt->response());
-          return result;
+          DCHECK(result.attempt->GetResponse());
+          SetQueryResult(query_index, result);
+          return;
         case ERR_NAME_NOT_RESOLVED:
-          net_log_.EndEventWithNetErrorCode(
-              NetLog::TYPE_DNS_TRANSACTION_QUERY, result.rv);
-          // Try next suffix.
-          qnames_.pop_front();
-          if (qnames_.empty()) {
-            return AttemptResult(ERR_NAME_NOT_RESOLVED, NULL);
-          } else {
-            result = StartQuery();
-          }
+          SetQueryResult(query_index, AttemptResult(result.rv, NULL));
+          return;
+        case ERR_DNS_SERVER_REQUIRES_TCP:
+          DCHECK(result.attempt);
+          result = MakeTCPAttempt(query_index, result.attempt);
           break;
         case ERR_DNS_TIMED_OUT:
-          if (MoreAttemptsAllowed()) {
-            result = MakeAttempt();
+          if (MoreAttemptsAllowed(query)) {
+            result = MakeAttempt(query_index);
           } else {
-            return result;
+            SetQueryResult(query_index, result);
+            return;
           }
           break;
         default:
           // Server failure.
           DCHECK(result.attempt);
-          if (result.attempt != attempts_->back()) {
+          if (result.attempt != query->attempts->back()) {
             // This attempt already timed out. Ignore it.
-            return AttemptResult(ERR_IO_PENDING, NULL);
+            return;
           }
-          if (MoreAttemptsAllowed()) {
-            result = MakeAttempt();
+          if (MoreAttemptsAllowed(query)) {
+            result = MakeAttempt(query_index);
           } else {
-            return AttemptResult(ERR_DNS_SERVER_FAILED, NULL);
+            SetQueryResult(query_index,
+                           AttemptResult(ERR_DNS_SERVER_FAILED, NULL));
+            return;
           }
           break;
       }
     }
-    return result;
   }
 
-  void OnTimeout() {
+  void OnTimeout(size_t query_index) {
     if (callback_.is_null())
       return;
-    AttemptResult result = FinishAttempt(
-        AttemptResult(ERR_DNS_TIMED_OUT, NULL));
+    FinishAttempt(query_index, AttemptResult(ERR_DNS_TIMED_OUT, NULL));
+    AttemptResult result = ProcessQueries();
     if (result.rv != ERR_IO_PENDING)
       DoCallback(result);
   }
@@ -564,13 +979,11 @@ class DnsTransactionImpl : public DnsTransaction,
   // Search list of fully-qualified DNS names to query next (in DNS format).
   std::deque<std::string> qnames_;
 
-  // List of attempts for the current name.
-  ScopedVector<DnsUDPAttempt> attempts_;
-
-  // Index of the first server to try on each search query.
-  int first_server_index_;
+  // Queries started so far, in search-list order.
+  ScopedVector<QueryState> queries_;
 
-  base::OneShotTimer<DnsTransactionImpl> timer_;
+  // Index of the first query in |queries_| whose result is still needed.
+  size_t first_pending_;
 
   DISALLOW_COPY_AND_ASSIGN(DnsTransactionImpl);
 };
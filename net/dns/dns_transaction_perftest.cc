@@ -0,0 +1,99 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/dns/dns_transaction.h"
+
+#include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "net/base/dns_util.h"
+#include "net/base/net_log.h"
+#include "net/dns/dns_protocol.h"
+#include "net/dns/dns_query.h"
+#include "net/dns/dns_session.h"
+#include "net/dns/dns_test_util.h"
+#include "net/socket/socket_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const int kNumTransactions = 1000;
+
+int ZeroId(int min, int max) {
+  return 0;
+}
+
+// Counts completed transactions and stops the loop after the last one.
+class CompletionCounter {
+ public:
+  explicit CompletionCounter(int expected)
+      : expected_(expected), completed_(0) {}
+
+  void OnComplete(DnsTransaction* transaction,
+                  int rv,
+                  const DnsResponse* response) {
+    EXPECT_EQ(OK, rv);
+    if (++completed_ == expected_)
+      MessageLoop::current()->Quit();
+  }
+
+ private:
+  const int expected_;
+  int completed_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompletionCounter);
+};
+
+}  // namespace
+
+// Measures the cost of the transaction machinery itself: a burst of lookups,
+// all in flight at once, answered by mock sockets without any delay.
+TEST(DnsTransactionPerfTest, Burst) {
+  MessageLoopForIO message_loop;
+  std::string qname;
+  ASSERT_TRUE(DNSDomainFromDot(kT0HostName, &qname));
+  DnsQuery query(0, qname, kT0Qtype);
+
+  MockWrite write(ASYNC, query.io_buffer()->data(), query.io_buffer()->size());
+  MockRead read(ASYNC, reinterpret_cast<const char*>(kT0ResponseDatagram),
+                arraysize(kT0ResponseDatagram));
+  MockClientSocketFactory socket_factory;
+  ScopedVector<StaticSocketDataProvider> socket_data;
+  for (int i = 0; i < kNumTransactions; ++i) {
+    StaticSocketDataProvider* data =
+        new StaticSocketDataProvider(&read, 1, &write, 1);
+    socket_data.push_back(data);
+    socket_factory.AddSocketDataProvider(data);
+  }
+
+  DnsConfig config;
+  IPAddressNumber dns_ip;
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.0", &dns_ip));
+  config.nameservers.push_back(IPEndPoint(dns_ip, dns_protocol::kDefaultPort));
+  scoped_refptr<DnsSession> session(new DnsSession(
+      config, &socket_factory, base::Bind(&ZeroId), NULL /* NetLog */));
+  scoped_ptr<DnsTransactionFactory> factory(
+      DnsTransactionFactory::CreateFactory(session));
+
+  CompletionCounter counter(kNumTransactions);
+  ScopedVector<DnsTransaction> transactions;
+  PerfTimeLogger timer("DnsTransaction_burst");
+  for (int i = 0; i < kNumTransactions; ++i) {
+    scoped_ptr<DnsTransaction> transaction(factory->CreateTransaction(
+        kT0HostName,
+        kT0Qtype,
+        base::Bind(&CompletionCounter::OnComplete, base::Unretained(&counter)),
+        BoundNetLog()));
+    EXPECT_EQ(ERR_IO_PENDING, transaction->Start());
+    transactions.push_back(transaction.release());
+  }
+  MessageLoop::current()->Run();
+  timer.Done();
+}
+
+}  // namespace net
@@ -251,6 +251,35 @@ class DnsTransactionTest : public testing::Test {
     transaction_ids_.push_back(id);
   }
 
+  // Add expected query over TCP for |dotted_name| and |qtype| with |id| and
+  // response taken verbatim from |data| of |data_length| bytes. Both are
+  // framed with their length.
+  void AddTCPResponse(const std::string& dotted_name,
+                      uint16 qtype,
+                      uint16 id,
+                      const char* data,
+                      size_t data_length,
+                      IoMode mode) {
+    CHECK(socket_factory_.get());
+    DnsQuery* query = new DnsQuery(id, DomainFromDot(dotted_name), qtype);
+    queries_.push_back(query);
+
+    char length[sizeof(uint16)];
+    WriteBigEndian<uint16>(length, query->io_buffer()->size());
+    tcp_messages_.push_back(std::string(length, sizeof(length)) +
+        std::string(query->io_buffer()->data(), query->io_buffer()->size()));
+    const std::string& write = tcp_messages_.back();
+    writes_.push_back(MockWrite(mode, write.data(), write.size()));
+
+    WriteBigEndian<uint16>(length, data_length);
+    tcp_messages_.push_back(std::string(length, sizeof(length)) +
+                            std::string(data, data_length));
+    const std::string& read = tcp_messages_.back();
+    reads_.push_back(MockRead(mode, read.data(), read.size()));
+
+    transaction_ids_.push_back(id);
+  }
+
   void AddAsyncResponse(const std::string& dotted_name,
                         uint16 qtype,
                         uint16 id,
@@ -364,6 +393,8 @@ class DnsTransactionTest : public testing::Test {
   // Holders for the buffers behind MockRead/MockWrites (they do not own them).
   ScopedVector<DnsQuery> queries_;
   ScopedVector<DnsResponse> responses_;
+  // Length-prefixed messages for TCP. Elements of a deque stay put.
+  std::deque<std::string> tcp_messages_;
 
   // Holders for MockRead/MockWrites (SocketDataProvider does not own it).
   std::vector<MockRead> reads_;
@@ -788,6 +819,70 @@ TEST_F(DnsTransactionTest, SyncSearchQuery) {
   EXPECT_TRUE(helper0.Run(transaction_factory_.get()));
 }
 
+TEST_F(DnsTransactionTest, TCPFallback) {
+  // The UDP response has the TC bit set.
+  std::vector<char> truncated(kT0ResponseDatagram,
+      kT0ResponseDatagram + arraysize(kT0ResponseDatagram));
+  dns_protocol::Header* header =
+      reinterpret_cast<dns_protocol::Header*>(&truncated[0]);
+  header->flags |= base::HostToNet16(dns_protocol::kFlagTC);
+  AddAsyncResponse(kT0HostName,
+                   kT0Qtype,
+                   0 /* id */,
+                   &truncated[0],
+                   truncated.size());
+  AddTCPResponse(kT0HostName,
+                 kT0Qtype,
+                 0 /* id */,
+                 reinterpret_cast<const char*>(kT0ResponseDatagram),
+                 arraysize(kT0ResponseDatagram),
+                 ASYNC);
+  PrepareSockets();
+
+  TransactionHelper helper0(kT0HostName,
+                            kT0Qtype,
+                            kT0RecordCount);
+  EXPECT_TRUE(helper0.Run(transaction_factory_.get()));
+
+  // Only the UDP socket reports its endpoint.
+  unsigned kOrder[] = { 0 };
+  CheckServerOrder(kOrder, arraysize(kOrder));
+}
+
+TEST_F(DnsTransactionTest, ParallelSuffixSearch) {
+  config_.search.push_back("lab.ccs.neu.edu");
+  config_.search.push_back("ccs.neu.edu");
+  config_.search.push_back("google.com");
+  ConfigureFactory();
+  session_->set_max_parallel_queries(3);
+
+  // All three names are queried at once, but the first name to not be
+  // NXDOMAIN decides, even though a later name also resolves.
+  AddAsyncRcode("www.lab.ccs.neu.edu",
+                kT2Qtype,
+                dns_protocol::kRcodeNXDOMAIN);
+  AddAsyncResponse(kT2HostName,  // "www.ccs.neu.edu"
+                   kT2Qtype,
+                   2 /* id */,
+                   reinterpret_cast<const char*>(kT2ResponseDatagram),
+                   arraysize(kT2ResponseDatagram));
+  AddAsyncResponse(kT0HostName,  // "www.google.com"
+                   kT0Qtype,
+                   0 /* id */,
+                   reinterpret_cast<const char*>(kT0ResponseDatagram),
+                   arraysize(kT0ResponseDatagram));
+  PrepareSockets();
+
+  TransactionHelper helper0("www",
+                            kT2Qtype,
+                            kT2RecordCount);
+  helper0.StartTransaction(transaction_factory_.get());
+  // Every query was sent before any response arrived.
+  EXPECT_EQ(3u, socket_factory_->remote_endpoints.size());
+  MessageLoop::current()->RunAllPending();
+  EXPECT_TRUE(helper0.has_completed());
+}
+
 }  // namespace
 
 }  // namespace net
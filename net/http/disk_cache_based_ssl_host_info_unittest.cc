@@ -115,4 +115,78 @@ TEST(DiskCacheBasedSSLHostInfo, Update) {
   RemoveMockTransaction(&kHostInfoTransaction);
 }
 
+// Tests that a session survives a round trip through the cache only while
+// persistent sessions are enabled and the session hasn't expired.
+TEST(DiskCacheBasedSSLHostInfo, PersistSession) {
+  MockHttpCache cache;
+  AddMockTransaction(&kHostInfoTransaction);
+  cache.disk_cache()->set_double_create_check(false);
+  net::TestCompletionCallback callback;
+  scoped_ptr<net::CertVerifier> cert_verifier(new net::MockCertVerifier);
+  net::SSLConfig ssl_config;
+  bool old_enabled =
+      net::SSLHostInfo::set_persistent_sessions_enabled(true);
+
+  scoped_ptr<net::SSLHostInfo> ssl_host_info(
+      new net::DiskCacheBasedSSLHostInfo("https://www.google.com", ssl_config,
+                                         cert_verifier.get(),
+                                         cache.http_cache()));
+  ssl_host_info->Start();
+  int rv = ssl_host_info->WaitForDataReady(callback.callback());
+  EXPECT_EQ(net::OK, callback.GetResult(rv));
+  EXPECT_FALSE(ssl_host_info->HasUsableSession());
+
+  // Oversized sessions are dropped.
+  base::Time expiry = base::Time::Now() + base::TimeDelta::FromHours(1);
+  ssl_host_info->SetSession(
+      std::string(net::SSLHostInfo::kMaxSessionSize + 1, 'x'), expiry);
+  EXPECT_FALSE(ssl_host_info->HasUsableSession());
+
+  // Lifetimes are capped.
+  ssl_host_info->SetSession(
+      "session", base::Time::Now() + base::TimeDelta::FromDays(365));
+  EXPECT_GE(base::Time::Now() + base::TimeDelta::FromHours(
+                net::SSLHostInfo::kMaxSessionLifetimeHours),
+            ssl_host_info->state().session_expiry);
+
+  ssl_host_info->SetSession("session", expiry);
+  EXPECT_TRUE(ssl_host_info->HasUsableSession());
+  ssl_host_info->Persist();
+  MessageLoop::current()->RunAllPending();
+
+  ssl_host_info.reset(
+      new net::DiskCacheBasedSSLHostInfo("https://www.google.com", ssl_config,
+                                         cert_verifier.get(),
+                                         cache.http_cache()));
+  ssl_host_info->Start();
+  rv = ssl_host_info->WaitForDataReady(callback.callback());
+  EXPECT_EQ(net::OK, callback.GetResult(rv));
+  EXPECT_TRUE(ssl_host_info->HasUsableSession());
+  EXPECT_EQ("session", ssl_host_info->state().session);
+  EXPECT_EQ(expiry, ssl_host_info->state().session_expiry);
+
+  // Expired sessions are not loaded.
+  ssl_host_info->SetSession(
+      "session", base::Time::Now() - base::TimeDelta::FromSeconds(1));
+  EXPECT_FALSE(ssl_host_info->HasUsableSession());
+
+  // With persistent sessions off, a stored session is ignored.
+  ssl_host_info->SetSession("session", expiry);
+  ssl_host_info->Persist();
+  MessageLoop::current()->RunAllPending();
+  net::SSLHostInfo::set_persistent_sessions_enabled(false);
+
+  ssl_host_info.reset(
+      new net::DiskCacheBasedSSLHostInfo("https://www.google.com", ssl_config,
+                                         cert_verifier.get(),
+                                         cache.http_cache()));
+  ssl_host_info->Start();
+  rv = ssl_host_info->WaitForDataReady(callback.callback());
+  EXPECT_EQ(net::OK, callback.GetResult(rv));
+  EXPECT_TRUE(ssl_host_info->state().session.empty());
+
+  net::SSLHostInfo::set_persistent_sessions_enabled(old_enabled);
+  RemoveMockTransaction(&kHostInfoTransaction);
+}
+
 }  // namespace
@@ -75,7 +75,7 @@ HttpAuthCache::Entry* HttpAuthCache::Lookup(const GURL& origin,
   for (EntryList::iterator it = entries_.begin(); it != entries_.end(); ++it) {
     if (it->origin() == origin && it->realm() == realm &&
         it->scheme() == scheme)
-      return &(*it);
+      return MoveToFront(it);
   }
   return NULL;  // No realm entry found.
 }
@@ -85,7 +85,7 @@ HttpAuthCache::Entry* HttpAuthCache::Lookup(const GURL& origin,
 // kept small because AddPath() only keeps the shallowest entry.
 HttpAuthCache::Entry* HttpAuthCache::LookupByPath(const GURL& origin,
                                                   const std::string& path) {
-  HttpAuthCache::Entry* best_match = NULL;
+  EntryList::iterator best_match = entries_.end();
   size_t best_match_length = 0;
   CheckOriginIsValid(origin);
   CheckPathIsValid(path);
@@ -100,12 +100,14 @@ HttpAuthCache::Entry* HttpAuthCache::LookupByPath(const GURL& origin,
   for (EntryList::iterator it = entries_.begin(); it != entries_.end(); ++it) {
     size_t len = 0;
     if (it->origin() == origin && it->HasEnclosingPath(parent_dir, &len) &&
-        (!best_match || len > best_match_length)) {
+        (best_match == entries_.end() || len > best_match_length)) {
       best_match_length = len;
-      best_match = &(*it);
+      best_match = it;
     }
   }
-  return best_match;
+  if (best_match == entries_.end())
+    return NULL;
+  return MoveToFront(best_match);
 }
 
 HttpAuthCache::Entry* HttpAuthCache::Add(const GURL& origin,
@@ -222,6 +224,12 @@ bool HttpAuthCache::UpdateStaleChallenge(const GURL& origin,
   return true;
 }
 
+HttpAuthCache::Entry* HttpAuthCache::MoveToFront(EntryList::iterator it) {
+  // Splicing moves the entry without invalidating pointers to it.
+  entries_.splice(entries_.begin(), entries_, it);
+  return &entries_.front();
+}
+
 void HttpAuthCache::UpdateAllFrom(const HttpAuthCache& other) {
   for (EntryList::const_iterator it = other.entries_.begin();
        it != other.entries_.end(); ++it) {
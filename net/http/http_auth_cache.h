@@ -32,7 +32,8 @@ class NET_EXPORT_PRIVATE HttpAuthCache {
   // Prevent unbounded memory growth. These are safeguards for abuse; it is
   // not expected that the limits will be reached in ordinary usage.
   // This also defines the worst-case lookup times (which grow linearly
-  // with number of elements in the cache).
+  // with number of elements in the cache). Once the limit is reached, the
+  // least recently looked up realm entry is evicted.
   enum { kMaxNumPathsPerRealmEntry = 10 };
   enum { kMaxNumRealmEntries = 10 };
 
@@ -44,7 +45,8 @@ class NET_EXPORT_PRIVATE HttpAuthCache {
   //   |origin| - the {scheme, host, port} of the server.
   //   |realm|  - case sensitive realm string.
   //   |scheme| - the authentication scheme (i.e. basic, negotiate).
-  //   returns  - the matched entry or NULL.
+  //   returns  - the matched entry or NULL. A match becomes the most
+  //              recently used entry.
   Entry* Lookup(const GURL& origin,
                 const std::string& realm,
                 HttpAuth::Scheme scheme);
@@ -55,7 +57,8 @@ class NET_EXPORT_PRIVATE HttpAuthCache {
   //   |origin| - the {scheme, host, port} of the server.
   //   |path|   - absolute path of the resource, or empty string in case of
   //              proxy auth (which does not use the concept of paths).
-  //   returns  - the matched entry or NULL.
+  //   returns  - the matched entry or NULL. A match becomes the most
+  //              recently used entry.
   Entry* LookupByPath(const GURL& origin, const std::string& path);
 
   // Add an entry on server |origin| for realm |handler->realm()| and
@@ -103,6 +106,11 @@ class NET_EXPORT_PRIVATE HttpAuthCache {
 
  private:
   typedef std::list<Entry> EntryList;
+
+  // Makes the entry at |it| the most recently used one, which is evicted
+  // last, and returns it.
+  Entry* MoveToFront(EntryList::iterator it);
+
   EntryList entries_;
 };
 
@@ -116,7 +124,7 @@ class NET_EXPORT_PRIVATE HttpAuthCache::Entry {
   }
 
   // The case-sensitive realm string of the challenge.
-  const std::string realm() const {
+  const std::string& realm() const {
     return realm_;
   }
 
@@ -126,7 +134,7 @@ class NET_EXPORT_PRIVATE HttpAuthCache::Entry {
   }
 
   // The authentication challenge.
-  const std::string auth_challenge() const {
+  const std::string& auth_challenge() const {
     return auth_challenge_;
   }
 
@@ -618,4 +618,25 @@ TEST_F(HttpAuthCacheEvictionTest, RealmPathEviction) {
     CheckRealmExistence(i, true);
 }
 
+// Fill the cache, then look up the oldest realm entry and the oldest path of
+// another one. Adding two more entries must evict the least recently used
+// entries rather than the ones just looked up.
+TEST_F(HttpAuthCacheEvictionTest, RealmEntryEvictionIsLRU) {
+  for (int i = 0; i < kMaxRealms; ++i)
+    AddRealm(i);
+
+  CheckRealmExistence(0, true);
+  CheckPathExistence(1, 0, true);
+
+  AddRealm(kMaxRealms);
+  AddRealm(kMaxRealms + 1);
+
+  CheckRealmExistence(0, true);
+  CheckRealmExistence(1, true);
+  CheckRealmExistence(2, false);
+  CheckRealmExistence(3, false);
+  for (int i = 4; i < kMaxRealms + 2; ++i)
+    CheckRealmExistence(i, true);
+}
+
 }  // namespace net
@@ -106,7 +106,8 @@ HttpCache::ActiveEntry::ActiveEntry(disk_cache::Entry* entry)
     : disk_entry(entry),
       writer(NULL),
       will_process_pending_queue(false),
-      doomed(false) {
+      doomed(false),
+      incomplete(false) {
 }
 
 HttpCache::ActiveEntry::~ActiveEntry() {
@@ -369,6 +370,7 @@ HttpCache::~HttpCache() {
     entry->will_process_pending_queue = false;
     entry->pending_queue.clear();
     entry->readers.clear();
+    entry->streaming_readers.clear();
     entry->writer = NULL;
     DeactivateEntry(entry);
   }
@@ -649,6 +651,7 @@ void HttpCache::FinalizeDoomedEntry(ActiveEntry* entry) {
   DCHECK(entry->doomed);
   DCHECK(!entry->writer);
   DCHECK(entry->readers.empty());
+  DCHECK(entry->streaming_readers.empty());
   DCHECK(entry->pending_queue.empty());
 
   ActiveEntriesSet::iterator it = doomed_entries_.find(entry);
@@ -845,6 +848,16 @@ int HttpCache::AddTransactionToEntry(ActiveEntry* entry, Transaction* trans) {
 
 void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
                               bool cancel) {
+  if (entry->writer && trans != entry->writer) {
+    // This transaction was reading along with the writer.
+    TransactionList::iterator it =
+        std::find(entry->streaming_readers.begin(),
+                  entry->streaming_readers.end(), trans);
+    DCHECK(it != entry->streaming_readers.end());
+    entry->streaming_readers.erase(it);
+    return;
+  }
+
   // If we already posted a task to move on to the next transaction and this was
   // the writer, there is nothing to cancel.
   if (entry->will_process_pending_queue && entry->readers.empty())
@@ -860,6 +873,8 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
       // This is a successful operation in the sense that we want to keep the
       // entry.
       success = trans->AddTruncatedFlag();
+      if (trans->truncated() && !entry->streaming_readers.empty())
+        entry->incomplete = true;
     }
     DoneWritingToEntry(entry, success);
   } else {
@@ -872,6 +887,18 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
 
   entry->writer = NULL;
 
+  // The transactions reading along with the writer become regular readers,
+  // and finish with whatever was written.
+  if (!entry->streaming_readers.empty()) {
+    entry->readers.swap(entry->streaming_readers);
+    if (!success)
+      entry->incomplete = true;
+    for (TransactionList::iterator it = entry->readers.begin();
+         it != entry->readers.end(); ++it) {
+      (*it)->OnEntryDataWritten();
+    }
+  }
+
   if (success) {
     ProcessPendingQueue(entry);
   } else {
@@ -881,8 +908,13 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
     TransactionList pending_queue;
     pending_queue.swap(entry->pending_queue);
 
-    entry->disk_entry->Doom();
-    DestroyEntry(entry);
+    if (entry->readers.empty()) {
+      entry->disk_entry->Doom();
+      DestroyEntry(entry);
+    } else if (!entry->doomed) {
+      // Keep the entry for its readers, but out of the way of new requests.
+      DoomActiveEntry(entry->disk_entry->GetKey());
+    }
 
     // We need to do something about these pending entries, which now need to
     // be added to a new entry.
@@ -894,6 +926,32 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
   }
 }
 
+void HttpCache::DataWrittenToEntry(ActiveEntry* entry) {
+  DCHECK(entry->writer);
+  DCHECK(entry->readers.empty());
+
+  // Let in the transactions that can use the response as it is. Those that
+  // need to validate it keep waiting for the writer to finish.
+  const HttpResponseInfo* response = entry->writer->GetResponseInfo();
+  TransactionList::iterator it = entry->pending_queue.begin();
+  while (it != entry->pending_queue.end()) {
+    Transaction* trans = *it;
+    if (!trans->ReadWhileWriting(*response)) {
+      ++it;
+      continue;
+    }
+    it = entry->pending_queue.erase(it);
+    entry->streaming_readers.push_back(trans);
+    MessageLoop::current()->PostTask(FROM_HERE,
+                                     base::Bind(trans->io_callback(), OK));
+  }
+
+  for (it = entry->streaming_readers.begin();
+       it != entry->streaming_readers.end(); ++it) {
+    (*it)->OnEntryDataWritten();
+  }
+}
+
 void HttpCache::DoneReadingFromEntry(ActiveEntry* entry, Transaction* trans) {
   DCHECK(!entry->writer);
 
@@ -970,11 +1028,26 @@ bool HttpCache::RemovePendingTransactionFromEntry(ActiveEntry* entry,
 
   TransactionList::iterator j =
       find(pending_queue.begin(), pending_queue.end(), trans);
-  if (j == pending_queue.end())
-    return false;
+  if (j != pending_queue.end()) {
+    pending_queue.erase(j);
+    return true;
+  }
 
-  pending_queue.erase(j);
-  return true;
+  // The transaction may have been let in to read along with the writer
+  // before it got to hear about it.
+  j = find(entry->streaming_readers.begin(), entry->streaming_readers.end(),
+           trans);
+  if (j != entry->streaming_readers.end()) {
+    entry->streaming_readers.erase(j);
+    return true;
+  }
+  if (!entry->writer &&
+      find(entry->readers.begin(), entry->readers.end(), trans) !=
+          entry->readers.end()) {
+    DoneReadingFromEntry(entry, trans);
+    return true;
+  }
+  return false;
 }
 
 bool HttpCache::RemovePendingTransactionFromPendingOp(PendingOp* pending_op,
@@ -228,9 +228,14 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
     disk_cache::Entry* disk_entry;
     Transaction*       writer;
     TransactionList    readers;
+    // Readers of the response that |writer| is still writing.
+    TransactionList    streaming_readers;
     TransactionList    pending_queue;
     bool               will_process_pending_queue;
     bool               doomed;
+    // The writer stopped before the end of the response that the streaming
+    // readers were reading.
+    bool               incomplete;
   };
 
   typedef base::hash_map<std::string, ActiveEntry*> ActiveEntriesMap;
@@ -323,6 +328,11 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // is false if the cache entry should be deleted.
   void DoneWritingToEntry(ActiveEntry* entry, bool success);
 
+  // Called when the writer of |entry| has appended response data to it. Lets
+  // the pending transactions that can use the response start reading it, and
+  // wakes up the readers waiting for more data.
+  void DataWrittenToEntry(ActiveEntry* entry);
+
   // Called when the transaction has finished reading from this entry.
   void DoneReadingFromEntry(ActiveEntry* entry, Transaction* trans);
 
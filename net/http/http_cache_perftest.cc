@@ -0,0 +1,145 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_cache.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_log.h"
+#include "net/http/http_transaction.h"
+#include "net/http/http_transaction_unittest.h"
+#include "net/http/mock_http_cache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// The number of tabs that load the same large resource at once, as when a
+// session with several tabs of one web application is restored.
+const int kNumTransactions = 10;
+
+const size_t kResourceSize = 1024 * 1024;
+
+// The size of the buffer URLRequest::Read() is typically given.
+const int kReadSize = 32 * 1024;
+
+// Tracks a burst of readers: how many have yet to see their first byte,
+// and how many have yet to finish.
+struct Burst {
+  explicit Burst(int size)
+      : first_byte_timer("HttpCache_concurrent_first_byte"),
+        awaiting_first_byte(size),
+        remaining(size) {}
+
+  PerfTimeLogger first_byte_timer;
+  int awaiting_first_byte;
+  int remaining;
+};
+
+// Reads a response to the end, and stops the loop after the last reader of
+// |burst| is done.
+class Reader {
+ public:
+  explicit Reader(Burst* burst)
+      : burst_(burst),
+        buf_(new IOBuffer(kReadSize)),
+        bytes_read_(0) {}
+
+  void Start(HttpCache* cache, const HttpRequestInfo* request) {
+    ASSERT_EQ(OK, cache->CreateTransaction(&trans_));
+    int rv = trans_->Start(
+        request, base::Bind(&Reader::OnStartComplete, base::Unretained(this)),
+        BoundNetLog());
+    if (rv != ERR_IO_PENDING)
+      OnStartComplete(rv);
+  }
+
+  size_t bytes_read() const { return bytes_read_; }
+
+ private:
+  void OnStartComplete(int rv) {
+    EXPECT_EQ(OK, rv);
+    Read();
+  }
+
+  void Read() {
+    for (;;) {
+      int rv = trans_->Read(
+          buf_, kReadSize,
+          base::Bind(&Reader::OnReadComplete, base::Unretained(this)));
+      if (rv == ERR_IO_PENDING)
+        return;
+      if (!DidRead(rv))
+        return;
+    }
+  }
+
+  void OnReadComplete(int rv) {
+    if (DidRead(rv))
+      Read();
+  }
+
+  // Returns true if there is more to read.
+  bool DidRead(int rv) {
+    if (rv > 0) {
+      if (!bytes_read_ && --burst_->awaiting_first_byte == 0)
+        burst_->first_byte_timer.Done();
+      bytes_read_ += rv;
+      return true;
+    }
+    EXPECT_EQ(0, rv);
+    if (--burst_->remaining == 0)
+      MessageLoop::current()->Quit();
+    return false;
+  }
+
+  Burst* burst_;
+  scoped_ptr<HttpTransaction> trans_;
+  scoped_refptr<IOBuffer> buf_;
+  size_t bytes_read_;
+
+  DISALLOW_COPY_AND_ASSIGN(Reader);
+};
+
+}  // namespace
+
+// Measures how long a burst of transactions for one uncached resource takes
+// to start getting the body, and to finish. One of them fetches it; the
+// others read it from the cache.
+TEST(HttpCachePerfTest, ConcurrentReaders) {
+  MessageLoopForIO message_loop;
+  MockHttpCache cache;
+
+  const std::string data(kResourceSize, 'a');
+  MockTransaction transaction(kSimpleGET_Transaction);
+  transaction.data = data.c_str();
+  AddMockTransaction(&transaction);
+  MockHttpRequest request(transaction);
+
+  ScopedVector<Reader> readers;
+  PerfTimeLogger timer("HttpCache_concurrent_readers");
+  Burst burst(kNumTransactions);
+  for (int i = 0; i < kNumTransactions; ++i) {
+    readers.push_back(new Reader(&burst));
+    readers[i]->Start(cache.http_cache(), &request);
+  }
+  MessageLoop::current()->Run();
+  timer.Done();
+
+  for (int i = 0; i < kNumTransactions; ++i)
+    EXPECT_EQ(kResourceSize, readers[i]->bytes_read());
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+
+  RemoveMockTransaction(&transaction);
+}
+
+}  // namespace net
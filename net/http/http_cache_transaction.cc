@@ -15,6 +15,7 @@
 #include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/memory/ref_counted.h"
+#include "base/message_loop.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/string_util.h"
@@ -118,6 +119,7 @@ HttpCache::Transaction::Transaction(HttpCache* cache)
       handling_206_(false),
       cache_pending_(false),
       done_reading_(false),
+      waiting_for_writer_(false),
       read_offset_(0),
       effective_load_flags_(0),
       write_len_(0),
@@ -207,6 +209,33 @@ LoadState HttpCache::Transaction::GetWriterLoadState() const {
   return LOAD_STATE_WAITING_FOR_CACHE;
 }
 
+bool HttpCache::Transaction::ReadWhileWriting(
+    const HttpResponseInfo& response) {
+  DCHECK(cache_pending_);
+
+  // Ranges and externally conditionalized requests need more than a plain
+  // read of the stored response.
+  if ((mode_ != READ && mode_ != READ_WRITE) || partial_.get())
+    return false;
+  if (!response.headers || response.headers->response_code() != 200)
+    return false;
+
+  if (mode_ == READ_WRITE && !(effective_load_flags_ & LOAD_PREFERRING_CACHE) &&
+      RequiresValidation(response))
+    return false;
+
+  mode_ = READ;
+  return true;
+}
+
+void HttpCache::Transaction::OnEntryDataWritten() {
+  if (!waiting_for_writer_)
+    return;
+
+  waiting_for_writer_ = false;
+  MessageLoop::current()->PostTask(FROM_HERE, base::Bind(io_callback_, OK));
+}
+
 const BoundNetLog& HttpCache::Transaction::net_log() const {
   return net_log_;
 }
@@ -367,7 +396,7 @@ void HttpCache::Transaction::StopCaching() {
   // the next piece of code that executes know that we are now reading directly
   // from the net.
   if (cache_ && entry_ && (mode_ & WRITE) && network_trans_.get() &&
-      !is_sparse_ && !range_requested_)
+      !is_sparse_ && !range_requested_ && entry_->streaming_readers.empty())
     mode_ = NONE;
 }
 
@@ -389,6 +418,9 @@ const HttpResponseInfo* HttpCache::Transaction::GetResponseInfo() const {
 }
 
 LoadState HttpCache::Transaction::GetLoadState() const {
+  if (waiting_for_writer_ && cache_ && entry_->writer)
+    return entry_->writer->GetWriterLoadState();
+
   LoadState state = GetWriterLoadState();
   if (state != LOAD_STATE_WAITING_FOR_CACHE)
     return state;
@@ -980,6 +1012,12 @@ int HttpCache::Transaction::DoAddToEntryComplete(int result) {
   DCHECK(new_entry_);
   cache_pending_ = false;
 
+  // We may hear about a streaming entry after the cache is gone.
+  if (!cache_) {
+    new_entry_ = NULL;
+    return ERR_UNEXPECTED;
+  }
+
   if (result == ERR_CACHE_RACE) {
     new_entry_ = NULL;
     next_state_ = STATE_INIT_ENTRY;
@@ -1323,6 +1361,10 @@ int HttpCache::Transaction::DoCacheReadData() {
   DCHECK(entry_);
   next_state_ = STATE_CACHE_READ_DATA_COMPLETE;
 
+  // Waiting for the writer may have outlived the cache.
+  if (!cache_)
+    return ERR_UNEXPECTED;
+
   if (net_log_.IsLoggingAllEvents())
     net_log_.BeginEvent(NetLog::TYPE_HTTP_CACHE_READ_DATA, NULL);
   if (partial_.get()) {
@@ -1349,6 +1391,14 @@ int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
   if (result > 0) {
     read_offset_ += result;
   } else if (result == 0) {  // End of file.
+    if (entry_->writer) {
+      // We are reading the response as it is written, so wait for more.
+      waiting_for_writer_ = true;
+      next_state_ = STATE_CACHE_READ_DATA;
+      return ERR_IO_PENDING;
+    }
+    if (entry_->incomplete)
+      return ERR_CACHE_READ_FAILURE;
     cache_->DoneReadingFromEntry(entry_, this);
     entry_ = NULL;
   } else {
@@ -1389,6 +1439,10 @@ int HttpCache::Transaction::DoCacheWriteDataComplete(int result) {
       done_reading_ = true;
   }
 
+  // Other transactions may be reading the response as we write it.
+  if (result > 0 && entry_ && mode_ == WRITE && !partial_.get())
+    cache_->DataWrittenToEntry(entry_);
+
   if (partial_.get()) {
     // This may be the last request.
     if (!(result == 0 && !truncated_ &&
@@ -1565,7 +1619,7 @@ int HttpCache::Transaction::BeginCacheValidation() {
   DCHECK(mode_ == READ_WRITE);
 
   bool skip_validation = effective_load_flags_ & LOAD_PREFERRING_CACHE ||
-                         !RequiresValidation();
+                         !RequiresValidation(response_);
 
   if (truncated_)
     skip_validation = !partial_->initial_validation();
@@ -1713,7 +1767,8 @@ int HttpCache::Transaction::RestartNetworkRequestWithAuth(
   return rv;
 }
 
-bool HttpCache::Transaction::RequiresValidation() {
+bool HttpCache::Transaction::RequiresValidation(
+    const HttpResponseInfo& response) {
   // TODO(darin): need to do more work here:
   //  - make sure we have a matching request method
   //  - watch out for cached responses that depend on authentication
@@ -1724,13 +1779,13 @@ bool HttpCache::Transaction::RequiresValidation() {
   if (effective_load_flags_ & LOAD_VALIDATE_CACHE)
     return true;
 
-  if (response_.headers->RequiresValidation(
-          response_.request_time, response_.response_time, Time::Now()))
+  if (response.headers->RequiresValidation(
+          response.request_time, response.response_time, Time::Now()))
     return true;
 
   // Since Vary header computation is fairly expensive, we save it for last.
-  if (response_.vary_data.is_valid() &&
-      !response_.vary_data.MatchesRequest(*request_, *response_.headers))
+  if (response.vary_data.is_valid() &&
+      !response.vary_data.MatchesRequest(*request_, *response.headers))
     return true;
 
   return false;
@@ -94,8 +94,20 @@ class HttpCache::Transaction : public HttpTransaction {
   // to the cache entry.
   LoadState GetWriterLoadState() const;
 
+  // Returns true if the response was marked as truncated in the cache.
+  bool truncated() const { return truncated_; }
+
   const CompletionCallback& io_callback() { return io_callback_; }
 
+  // If this transaction is waiting for its entry and can use the |response|
+  // that the writer of the entry is still writing without validating it,
+  // switches to reading the response as it is written, and returns true.
+  bool ReadWhileWriting(const HttpResponseInfo& response);
+
+  // Called when the writer of the entry that this transaction is reading has
+  // written more data, or is done with the entry.
+  void OnEntryDataWritten();
+
   const BoundNetLog& net_log() const;
 
   // HttpTransaction methods:
@@ -264,8 +276,9 @@ class HttpCache::Transaction : public HttpTransaction {
   // Returns network error code.
   int RestartNetworkRequestWithAuth(const AuthCredentials& credentials);
 
-  // Called to determine if we need to validate the cache entry before using it.
-  bool RequiresValidation();
+  // Called to determine if we need to validate the cached |response| before
+  // using it.
+  bool RequiresValidation(const HttpResponseInfo& response);
 
   // Called to make the request conditional (to ask the server if the cached
   // copy is valid).  Returns true if able to make the request conditional.
@@ -360,6 +373,7 @@ class HttpCache::Transaction : public HttpTransaction {
   bool handling_206_;  // We must deal with this 206 response.
   bool cache_pending_;  // We are waiting for the HttpCache.
   bool done_reading_;
+  bool waiting_for_writer_;  // We have read all the data written so far.
   scoped_refptr<IOBuffer> read_buf_;
   int io_buf_len_;
   int read_offset_;
@@ -965,11 +965,12 @@ TEST(HttpCache, SimpleGET_RacingReaders) {
   c->result = c->callback.WaitForResult();
   ReadAndVerifyTransaction(c->trans.get(), kSimpleGET_Transaction);
 
-  // Now we have 2 active readers and two queued transactions.
+  // The response is fresh, so all the other transactions got to read it as
+  // it was written, and are active readers now.
 
   EXPECT_EQ(net::LOAD_STATE_IDLE,
             context_list[2]->trans->GetLoadState());
-  EXPECT_EQ(net::LOAD_STATE_WAITING_FOR_CACHE,
+  EXPECT_EQ(net::LOAD_STATE_IDLE,
             context_list[3]->trans->GetLoadState());
 
   c = context_list[1];
@@ -978,10 +979,8 @@ TEST(HttpCache, SimpleGET_RacingReaders) {
   if (c->result == net::OK)
     ReadAndVerifyTransaction(c->trans.get(), kSimpleGET_Transaction);
 
-  // At this point we have one reader, two pending transactions and a task on
-  // the queue to move to the next transaction. Now we cancel the request that
-  // is the current reader, and expect the queued task to be able to start the
-  // next request.
+  // Now we cancel one of the readers, and expect the others to be able to
+  // finish.
 
   c = context_list[2];
   c->trans.reset();
@@ -1006,6 +1005,128 @@ TEST(HttpCache, SimpleGET_RacingReaders) {
   }
 }
 
+// Tests that transactions waiting for an entry read the response while it is
+// written, instead of waiting for the writer to finish.
+TEST(HttpCache, SimpleGET_ReadWhileWriting) {
+  MockHttpCache cache;
+
+  const std::string data(1000, 'a');
+  MockTransaction transaction(kSimpleGET_Transaction);
+  transaction.data = data.c_str();
+  AddMockTransaction(&transaction);
+
+  MockHttpRequest request(transaction);
+  MockHttpRequest validating_request(transaction);
+  validating_request.load_flags = net::LOAD_VALIDATE_CACHE;
+
+  ScopedVector<Context> context_list;
+  const int kNumTransactions = 3;
+  for (int i = 0; i < kNumTransactions; ++i) {
+    context_list.push_back(new Context());
+    Context* c = context_list[i];
+    c->result = cache.http_cache()->CreateTransaction(&c->trans);
+    EXPECT_EQ(net::OK, c->result);
+    MockHttpRequest* this_request =
+        (i == kNumTransactions - 1) ? &validating_request : &request;
+    c->result = c->trans->Start(
+        this_request, c->callback.callback(), net::BoundNetLog());
+  }
+  MessageLoop::current()->RunAllPending();
+
+  // The writer gets the first part of the body into the cache.
+  Context* writer = context_list[0];
+  EXPECT_EQ(net::OK, writer->callback.GetResult(writer->result));
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  int rv = writer->trans->Read(buf, 256, writer->callback.callback());
+  EXPECT_EQ(256, writer->callback.GetResult(rv));
+
+  // That is enough for the reader to start, and to read what is there.
+  Context* reader = context_list[1];
+  EXPECT_EQ(net::OK, reader->callback.GetResult(reader->result));
+  scoped_refptr<net::IOBuffer> reader_buf(new net::IOBuffer(1000));
+  rv = reader->trans->Read(reader_buf, 1000, reader->callback.callback());
+  EXPECT_EQ(256, reader->callback.GetResult(rv));
+  std::string reader_content(reader_buf->data(), 256);
+
+  // Then it waits for the writer to add more.
+  rv = reader->trans->Read(reader_buf, 1000, reader->callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+  MessageLoop::current()->RunAllPending();
+  EXPECT_FALSE(reader->callback.have_result());
+  EXPECT_EQ(net::LOAD_STATE_READING_RESPONSE, reader->trans->GetLoadState());
+
+  // A transaction that has to validate the entry waits for all of it.
+  EXPECT_FALSE(context_list[2]->callback.have_result());
+
+  std::string writer_content;
+  EXPECT_EQ(net::OK, ReadTransaction(writer->trans.get(), &writer_content));
+  EXPECT_EQ(data.substr(256), writer_content);
+
+  rv = reader->callback.WaitForResult();
+  ASSERT_LT(0, rv);
+  reader_content.append(reader_buf->data(), rv);
+  std::string rest;
+  EXPECT_EQ(net::OK, ReadTransaction(reader->trans.get(), &rest));
+  reader_content.append(rest);
+  EXPECT_EQ(data, reader_content);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+
+  Context* c = context_list[2];
+  EXPECT_EQ(net::OK, c->callback.GetResult(c->result));
+  ReadAndVerifyTransaction(c->trans.get(), transaction);
+
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+
+  RemoveMockTransaction(&transaction);
+}
+
+// Tests that a transaction reading the response while it is written fails,
+// instead of returning a short body, when the writer goes away.
+TEST(HttpCache, SimpleGET_ReadWhileWritingWriterCancelled) {
+  MockHttpCache cache;
+
+  const std::string data(1000, 'a');
+  MockTransaction transaction(kSimpleGET_Transaction);
+  transaction.data = data.c_str();
+  AddMockTransaction(&transaction);
+
+  MockHttpRequest request(transaction);
+  Context writer;
+  Context reader;
+  ASSERT_EQ(net::OK, cache.http_cache()->CreateTransaction(&writer.trans));
+  ASSERT_EQ(net::OK, cache.http_cache()->CreateTransaction(&reader.trans));
+  writer.result = writer.trans->Start(
+      &request, writer.callback.callback(), net::BoundNetLog());
+  reader.result = reader.trans->Start(
+      &request, reader.callback.callback(), net::BoundNetLog());
+  MessageLoop::current()->RunAllPending();
+
+  EXPECT_EQ(net::OK, writer.callback.GetResult(writer.result));
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(256));
+  int rv = writer.trans->Read(buf, 256, writer.callback.callback());
+  EXPECT_EQ(256, writer.callback.GetResult(rv));
+
+  EXPECT_EQ(net::OK, reader.callback.GetResult(reader.result));
+  rv = reader.trans->Read(buf, 256, reader.callback.callback());
+  EXPECT_EQ(256, reader.callback.GetResult(rv));
+  rv = reader.trans->Read(buf, 256, reader.callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+
+  writer.trans.reset();
+  EXPECT_EQ(net::ERR_CACHE_READ_FAILURE, reader.callback.WaitForResult());
+  reader.trans.reset();
+
+  // The partial entry is gone.
+  RunTransactionTest(cache.http_cache(), transaction);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(2, cache.disk_cache()->create_count());
+
+  RemoveMockTransaction(&transaction);
+}
+
 // Tests that we can doom an entry with pending transactions and delete one of
 // the pending transactions before the first one completes.
 // See http://code.google.com/p/chromium/issues/detail?id=25588
@@ -2553,13 +2674,14 @@ TEST(HttpCache, RangeGET_OK) {
   // Make sure we are done with the previous transaction.
   MessageLoop::current()->RunAllPending();
 
-  // Write and read from the cache (20-59).
+  // Write to the cache (20-59). The cached block (30-49) is too small to be
+  // worth a request of its own for each gap around it.
   transaction.request_headers = "Range: bytes = 20-59\r\n" EXTRA_HEADER;
   transaction.data = "rg: 20-29 rg: 30-39 rg: 40-49 rg: 50-59 ";
   RunTransactionTestWithResponse(cache.http_cache(), transaction, &headers);
 
   Verify206Response(headers, 20, 59);
-  EXPECT_EQ(4, cache.network_layer()->transaction_count());
+  EXPECT_EQ(3, cache.network_layer()->transaction_count());
   EXPECT_EQ(3, cache.disk_cache()->open_count());
   EXPECT_EQ(1, cache.disk_cache()->create_count());
 
@@ -2608,19 +2730,64 @@ TEST(HttpCache, RangeGET_SyncOK) {
   // Make sure we are done with the previous transaction.
   MessageLoop::current()->RunAllPending();
 
-  // Write and read from the cache (20-59).
+  // Write to the cache (20-59). The cached block (30-49) is too small to be
+  // worth a request of its own for each gap around it.
   transaction.request_headers = "Range: bytes = 20-59\r\n" EXTRA_HEADER;
   transaction.data = "rg: 20-29 rg: 30-39 rg: 40-49 rg: 50-59 ";
   RunTransactionTestWithResponse(cache.http_cache(), transaction, &headers);
 
   Verify206Response(headers, 20, 59);
-  EXPECT_EQ(4, cache.network_layer()->transaction_count());
+  EXPECT_EQ(3, cache.network_layer()->transaction_count());
   EXPECT_EQ(2, cache.disk_cache()->open_count());
   EXPECT_EQ(1, cache.disk_cache()->create_count());
 
   RemoveMockTransaction(&transaction);
 }
 
+// Tests that small cached blocks in the middle of a range are fetched again
+// along with the gaps between them, in a single network request.
+TEST(HttpCache, RangeGET_CoalesceSmallBlocks) {
+  MockHttpCache cache;
+  AddMockTransaction(&kRangeGET_TransactionOK);
+  std::string headers;
+
+  // Write to the cache (20-29) and (50-59).
+  MockTransaction transaction(kRangeGET_TransactionOK);
+  transaction.request_headers = "Range: bytes = 20-29\r\n" EXTRA_HEADER;
+  transaction.data = "rg: 20-29 ";
+  RunTransactionTestWithResponse(cache.http_cache(), transaction, &headers);
+  Verify206Response(headers, 20, 29);
+
+  transaction.request_headers = "Range: bytes = 50-59\r\n" EXTRA_HEADER;
+  transaction.data = "rg: 50-59 ";
+  RunTransactionTestWithResponse(cache.http_cache(), transaction, &headers);
+  Verify206Response(headers, 50, 59);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+
+  // Make sure we are done with the previous transaction.
+  MessageLoop::current()->RunAllPending();
+
+  // Write to the cache (10-69) with one request.
+  transaction.request_headers = "Range: bytes = 10-69\r\n" EXTRA_HEADER;
+  transaction.data = "rg: 10-19 rg: 20-29 rg: 30-39 rg: 40-49 rg: 50-59 "
+                     "rg: 60-69 ";
+  RunTransactionTestWithResponse(cache.http_cache(), transaction, &headers);
+  Verify206Response(headers, 10, 69);
+  EXPECT_EQ(3, cache.network_layer()->transaction_count());
+
+  // Make sure we are done with the previous transaction.
+  MessageLoop::current()->RunAllPending();
+
+  // Read from the cache (10-69).
+  RunTransactionTestWithResponse(cache.http_cache(), transaction, &headers);
+  Verify206Response(headers, 10, 69);
+  EXPECT_EQ(3, cache.network_layer()->transaction_count());
+  EXPECT_EQ(3, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+
+  RemoveMockTransaction(&kRangeGET_TransactionOK);
+}
+
 // Tests that we don't revalidate an entry unless we are required to do so.
 TEST(HttpCache, RangeGET_Revalidate1) {
   MockHttpCache cache;
@@ -2877,7 +3044,8 @@ TEST(HttpCache, GET_Previous206) {
   EXPECT_EQ(0, cache.disk_cache()->open_count());
   EXPECT_EQ(1, cache.disk_cache()->create_count());
 
-  // Write and read from the cache (0-79), when not asked for a range.
+  // Write to the cache (0-79), when not asked for a range. The small cached
+  // block is fetched again with the rest.
   MockTransaction transaction(kRangeGET_TransactionOK);
   transaction.request_headers = EXTRA_HEADER;
   transaction.data = "rg: 00-09 rg: 10-19 rg: 20-29 rg: 30-39 rg: 40-49 "
@@ -2885,7 +3053,7 @@ TEST(HttpCache, GET_Previous206) {
   RunTransactionTestWithResponse(cache.http_cache(), transaction, &headers);
 
   EXPECT_EQ(0U, headers.find("HTTP/1.1 200 OK\n"));
-  EXPECT_EQ(3, cache.network_layer()->transaction_count());
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
   EXPECT_EQ(1, cache.disk_cache()->open_count());
   EXPECT_EQ(1, cache.disk_cache()->create_count());
 
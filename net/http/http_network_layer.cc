@@ -45,11 +45,13 @@ void HttpNetworkLayer::EnableSpdy(const std::string& mode) {
   static const char kDisablePing[] = "no-ping";
   static const char kExclude[] = "exclude";  // Hosts to exclude
   static const char kDisableCompression[] = "no-compress";
+  static const char kLowMemoryCompression[] = "low-mem-compress";
   static const char kDisableAltProtocols[] = "no-alt-protocols";
   static const char kForceAltProtocols[] = "force-alt-protocols";
   static const char kSingleDomain[] = "single-domain";
 
   static const char kInitialMaxConcurrentStreams[] = "init-max-streams";
+  static const char kMaxDataFrameSize[] = "max-data-frame-size";
 
   std::vector<std::string> spdy_options;
   base::SplitString(mode, ',', &spdy_options);
@@ -78,6 +80,8 @@ void HttpNetworkLayer::EnableSpdy(const std::string& mode) {
       HttpStreamFactory::add_forced_spdy_exclusion(value);
     } else if (option == kDisableCompression) {
       BufferedSpdyFramer::set_enable_compression_default(false);
+    } else if (option == kLowMemoryCompression) {
+      BufferedSpdyFramer::set_low_memory_compression_default(true);
     } else if (option == kDisableAltProtocols) {
       HttpStreamFactory::set_use_alternate_protocols(false);
     } else if (option == kForceAltProtocols) {
@@ -92,6 +96,10 @@ void HttpNetworkLayer::EnableSpdy(const std::string& mode) {
       int streams;
       if (base::StringToInt(value, &streams) && streams > 0)
         SpdySession::set_init_max_concurrent_streams(streams);
+    } else if (option == kMaxDataFrameSize) {
+      int size;
+      if (base::StringToInt(value, &size) && size > 0)
+        SpdySession::set_max_data_frame_size(size);
     } else if (option.empty() && it == spdy_options.begin()) {
       continue;
     } else {
@@ -1039,12 +1039,20 @@ void HttpNetworkTransaction::LogTransactionConnectedMetrics() {
 }
 
 void HttpNetworkTransaction::LogTransactionMetrics() const {
-  base::TimeDelta duration = base::Time::Now() -
-                             response_.request_time;
+  base::Time now = base::Time::Now();
+  base::TimeDelta duration = now - response_.request_time;
   if (60 < duration.InMinutes())
     return;
 
-  base::TimeDelta total_duration = base::Time::Now() - start_time_;
+  base::TimeDelta total_duration = now - start_time_;
+
+  // The time spent reading the body, after the headers came in. With the
+  // histograms of the connect and first byte times, this covers each phase
+  // of the transaction.
+  UMA_HISTOGRAM_CUSTOM_TIMES("Net.Transaction_Body_Time",
+                             now - response_.response_time,
+                             base::TimeDelta::FromMilliseconds(1),
+                             base::TimeDelta::FromMinutes(10), 100);
 
   UMA_HISTOGRAM_CUSTOM_TIMES("Net.Transaction_Latency_b", duration,
                              base::TimeDelta::FromMilliseconds(1),
@@ -73,6 +73,10 @@ class NET_EXPORT_PRIVATE HttpPipelinedConnection {
   // requests.
   virtual bool active() const = 0;
 
+  // True if the response being read is so large that requests sent behind it
+  // would wait a long time for theirs. New requests should go elsewhere.
+  virtual bool head_of_line_blocked() const = 0;
+
   // The SSLConfig used to establish this connection.
   virtual const SSLConfig& used_ssl_config() const = 0;
 
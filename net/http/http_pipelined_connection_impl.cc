@@ -25,6 +25,10 @@ namespace net {
 
 namespace {
 
+// Responses with a Content-Length of at least this many bytes stop the
+// pipeline from taking new requests until they have been read.
+const int64 kLargeResponseSize = 64 * 1024;
+
 class ReceivedHeadersParameters : public NetLog::EventParameters {
  public:
   ReceivedHeadersParameters(const NetLog::Source& source,
@@ -90,6 +94,7 @@ HttpPipelinedConnectionImpl::HttpPipelinedConnectionImpl(
       active_(false),
       usable_(true),
       completed_one_request_(false),
+      head_of_line_blocked_(false),
       ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)),
       send_next_state_(SEND_STATE_NONE),
       send_still_on_call_stack_(false),
@@ -494,6 +499,12 @@ int HttpPipelinedConnectionImpl::DoReadHeadersComplete(int result) {
 
   CheckHeadersForPipelineCompatibility(active_read_id_, result);
 
+  if (result >= OK) {
+    HttpResponseInfo* info = GetResponseInfo(active_read_id_);
+    head_of_line_blocked_ =
+        info->headers->GetContentLength() >= kLargeResponseSize;
+  }
+
   if (!read_still_on_call_stack_) {
     QueueUserCallback(active_read_id_,
                       stream_info_map_[active_read_id_].read_headers_callback,
@@ -513,6 +524,7 @@ int HttpPipelinedConnectionImpl::DoReadStreamClosed() {
   CHECK(ContainsKey(stream_info_map_, active_read_id_));
   CHECK_EQ(stream_info_map_[active_read_id_].state, STREAM_CLOSED);
   active_read_id_ = 0;
+  head_of_line_blocked_ = false;
   if (!usable_) {
     // TODO(simonjam): Don't wait this long to evict.
     read_next_state_ = READ_STATE_EVICT_PENDING_READS;
@@ -801,6 +813,10 @@ bool HttpPipelinedConnectionImpl::active() const {
   return active_;
 }
 
+bool HttpPipelinedConnectionImpl::head_of_line_blocked() const {
+  return head_of_line_blocked_;
+}
+
 const SSLConfig& HttpPipelinedConnectionImpl::used_ssl_config() const {
   return used_ssl_config_;
 }
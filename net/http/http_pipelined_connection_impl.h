@@ -83,6 +83,7 @@ class NET_EXPORT_PRIVATE HttpPipelinedConnectionImpl
   virtual int depth() const OVERRIDE;
   virtual bool usable() const OVERRIDE;
   virtual bool active() const OVERRIDE;
+  virtual bool head_of_line_blocked() const OVERRIDE;
 
   // Used by HttpStreamFactoryImpl.
   virtual const SSLConfig& used_ssl_config() const OVERRIDE;
@@ -313,6 +314,8 @@ class NET_EXPORT_PRIVATE HttpPipelinedConnectionImpl
   bool active_;
   bool usable_;
   bool completed_one_request_;
+  // True while the active read is of a large response.
+  bool head_of_line_blocked_;
   base::WeakPtrFactory<HttpPipelinedConnectionImpl> weak_factory_;
 
   StreamInfoMap stream_info_map_;
@@ -193,6 +193,30 @@ TEST_F(HttpPipelinedConnectionImplTest, SyncSingleRequest) {
   TestSyncRequest(stream, "ok.html");
 }
 
+TEST_F(HttpPipelinedConnectionImplTest, LargeResponseBlocksHeadOfLine) {
+  MockWrite writes[] = {
+    MockWrite(SYNCHRONOUS, 0, "GET /large.html HTTP/1.1\r\n\r\n"),
+  };
+  MockRead reads[] = {
+    MockRead(SYNCHRONOUS, 1, "HTTP/1.1 200 OK\r\n"),
+    MockRead(SYNCHRONOUS, 2, "Content-Length: 1000000\r\n\r\n"),
+  };
+  Initialize(reads, arraysize(reads), writes, arraysize(writes));
+
+  scoped_ptr<HttpStream> large_stream(NewTestStream("large.html"));
+  HttpRequestHeaders headers;
+  HttpResponseInfo response;
+  EXPECT_EQ(OK, large_stream->SendRequest(
+      headers, NULL, &response, callback_.callback()));
+  EXPECT_FALSE(pipeline_->head_of_line_blocked());
+  EXPECT_EQ(OK, large_stream->ReadResponseHeaders(callback_.callback()));
+  EXPECT_TRUE(pipeline_->head_of_line_blocked());
+
+  // Giving up on the body ends the blocking along with the read.
+  large_stream->Close(true);
+  EXPECT_FALSE(pipeline_->head_of_line_blocked());
+}
+
 TEST_F(HttpPipelinedConnectionImplTest, AsyncSingleRequest) {
   MockWrite writes[] = {
     MockWrite(ASYNC, 0, "GET /ok.html HTTP/1.1\r\n\r\n"),
@@ -175,6 +175,7 @@ bool HttpPipelinedHostImpl::CanPipelineAcceptRequests(
   return capability_ != PIPELINE_INCAPABLE &&
       pipeline->usable() &&
       pipeline->active() &&
+      !pipeline->head_of_line_blocked() &&
       pipeline->depth() < GetPipelineCapacity();
 }
 
@@ -201,6 +202,8 @@ Value* HttpPipelinedHostImpl::PipelineInfoToValue() const {
     pipeline_dict->SetInteger("capacity", GetPipelineCapacity());
     pipeline_dict->SetBoolean("usable", it->first->usable());
     pipeline_dict->SetBoolean("active", it->first->active());
+    pipeline_dict->SetBoolean("head_of_line_blocked",
+                              it->first->head_of_line_blocked());
     pipeline_dict->SetInteger("source_id", it->first->net_log().source().id);
     list_value->Append(pipeline_dict);
   }
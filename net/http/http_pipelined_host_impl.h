@@ -31,7 +31,9 @@ struct SSLConfig;
 
 // Manages all of the pipelining state for specific host with active pipelined
 // HTTP requests. Manages connection jobs, constructs pipelined streams, and
-// assigns requests to the least loaded pipelined connection.
+// assigns requests to the least loaded pipelined connection. Pipelines that
+// are reading a large response take no new requests, so small requests don't
+// wait behind a download; they go to another pipeline or a new connection.
 class NET_EXPORT_PRIVATE HttpPipelinedHostImpl
     : public HttpPipelinedHost,
       public HttpPipelinedConnection::Delegate {
@@ -96,8 +98,8 @@ class NET_EXPORT_PRIVATE HttpPipelinedHostImpl
   int GetPipelineCapacity() const;
 
   // Returns true if |pipeline| can handle a new request. This is true if the
-  // |pipeline| is active, usable, has capacity, and |capability_| is
-  // sufficient.
+  // |pipeline| is active, usable, has capacity, isn't head of line blocked,
+  // and |capability_| is sufficient.
   bool CanPipelineAcceptRequests(HttpPipelinedConnection* pipeline) const;
 
   // Called when |this| moves from UNKNOWN |capability_| to PROBABLY_CAPABLE.
@@ -152,6 +152,26 @@ TEST_F(HttpPipelinedHostImplTest, PicksLeastLoadedPipeline) {
   ClearTestPipeline(empty_pipeline);
 }
 
+TEST_F(HttpPipelinedHostImplTest, IgnoresHeadOfLineBlockedPipeline) {
+  MockPipeline* blocked_pipeline = AddTestPipeline(0, true, true);
+  blocked_pipeline->set_head_of_line_blocked(true);
+
+  EXPECT_FALSE(host_->IsExistingPipelineAvailable());
+  EXPECT_EQ(NULL, host_->CreateStreamOnExistingPipeline());
+
+  MockPipeline* busy_pipeline = AddTestPipeline(
+      HttpPipelinedHostImpl::max_pipeline_depth() - 1, true, true);
+  EXPECT_TRUE(host_->IsExistingPipelineAvailable());
+  EXPECT_CALL(*busy_pipeline, CreateNewStream())
+      .Times(1)
+      .WillOnce(ReturnNull());
+  EXPECT_EQ(NULL, host_->CreateStreamOnExistingPipeline());
+
+  blocked_pipeline->set_head_of_line_blocked(false);
+  ClearTestPipeline(blocked_pipeline);
+  ClearTestPipeline(busy_pipeline);
+}
+
 TEST_F(HttpPipelinedHostImplTest, OpensUpOnPipelineSuccess) {
   SetCapability(PIPELINE_UNKNOWN);
   MockPipeline* pipeline = AddTestPipeline(1, true, true);
@@ -24,7 +24,8 @@ MockPipelineFactory::~MockPipelineFactory() {
 MockPipeline::MockPipeline(int depth, bool usable, bool active)
     : depth_(depth),
       usable_(usable),
-      active_(active) {
+      active_(active),
+      head_of_line_blocked_(false) {
 }
 
 MockPipeline::~MockPipeline() {
@@ -50,6 +50,13 @@ class MockPipeline : public HttpPipelinedConnection {
   virtual int depth() const OVERRIDE { return depth_; }
   virtual bool usable() const OVERRIDE { return usable_; }
   virtual bool active() const OVERRIDE { return active_; }
+  virtual bool head_of_line_blocked() const OVERRIDE {
+    return head_of_line_blocked_;
+  }
+
+  void set_head_of_line_blocked(bool blocked) {
+    head_of_line_blocked_ = blocked;
+  }
 
   MOCK_METHOD0(CreateNewStream, HttpPipelinedStream*());
   MOCK_METHOD1(OnStreamDeleted, void(int pipeline_id));
@@ -63,6 +70,7 @@ class MockPipeline : public HttpPipelinedConnection {
   int depth_;
   bool usable_;
   bool active_;
+  bool head_of_line_blocked_;
 };
 
 MATCHER_P(MatchesOrigin, expected, "") { return expected.Equals(arg); }
@@ -125,6 +125,58 @@ int MapHttpResponseCode(int code) {
   return 0;
 }
 
+// Response headers that are looked up often enough, or filtered by Persist(),
+// that it is worth recognizing them once, while parsing.
+struct CommonHeader {
+  const char* name;
+  size_t length;
+};
+
+#define COMMON_HEADER(name) { name, sizeof(name) - 1 }
+const CommonHeader kCommonHeaders[] = {
+  COMMON_HEADER("accept-ranges"),
+  COMMON_HEADER("access-control-allow-origin"),
+  COMMON_HEADER("age"),
+  COMMON_HEADER("cache-control"),
+  COMMON_HEADER("connection"),
+  COMMON_HEADER("content-disposition"),
+  COMMON_HEADER("content-encoding"),
+  COMMON_HEADER("content-language"),
+  COMMON_HEADER("content-length"),
+  COMMON_HEADER("content-location"),
+  COMMON_HEADER("content-md5"),
+  COMMON_HEADER("content-range"),
+  COMMON_HEADER("content-type"),
+  COMMON_HEADER("date"),
+  COMMON_HEADER("etag"),
+  COMMON_HEADER("expires"),
+  COMMON_HEADER("keep-alive"),
+  COMMON_HEADER("last-modified"),
+  COMMON_HEADER("link"),
+  COMMON_HEADER("location"),
+  COMMON_HEADER("p3p"),
+  COMMON_HEADER("pragma"),
+  COMMON_HEADER("proxy-authenticate"),
+  COMMON_HEADER("proxy-connection"),
+  COMMON_HEADER("public-key-pins"),
+  COMMON_HEADER("refresh"),
+  COMMON_HEADER("server"),
+  COMMON_HEADER("set-cookie"),
+  COMMON_HEADER("set-cookie2"),
+  COMMON_HEADER("strict-transport-security"),
+  COMMON_HEADER("trailer"),
+  COMMON_HEADER("transfer-encoding"),
+  COMMON_HEADER("upgrade"),
+  COMMON_HEADER("vary"),
+  COMMON_HEADER("via"),
+  COMMON_HEADER("warning"),
+  COMMON_HEADER("www-authenticate"),
+  COMMON_HEADER("x-content-type-options"),
+  COMMON_HEADER("x-frame-options"),
+  COMMON_HEADER("x-xss-protection"),
+};
+#undef COMMON_HEADER
+
 void CheckDoesNotHaveEmbededNulls(const std::string& str) {
   // Care needs to be taken when adding values to the raw headers string to
   // make sure it does not contain embeded NULLs. Any embeded '\0' may be
@@ -139,6 +191,10 @@ struct HttpResponseHeaders::ParsedHeader {
   // preceding header.  (Header values are comma separated.)
   bool is_continuation() const { return name_begin == name_end; }
 
+  // The index of the header's name in kCommonHeaders, or kNotCommonHeader.
+  // Continuations have the index of the header they continue.
+  int common_header;
+
   std::string::const_iterator name_begin;
   std::string::const_iterator name_end;
   std::string::const_iterator value_begin;
@@ -149,6 +205,8 @@ struct HttpResponseHeaders::ParsedHeader {
 
 HttpResponseHeaders::HttpResponseHeaders(const std::string& raw_input)
     : response_code_(-1) {
+  COMPILE_ASSERT(arraysize(kCommonHeaders) == kNumCommonHeaders,
+                 common_headers_mismatch);
   Parse(raw_input);
 
   // The most important thing to do with this histogram is find out
@@ -172,6 +230,7 @@ HttpResponseHeaders::HttpResponseHeaders(const std::string& raw_input)
 HttpResponseHeaders::HttpResponseHeaders(const Pickle& pickle,
                                          PickleIterator* iter)
     : response_code_(-1) {
+  ClearCommonHeaderIndex();
   std::string raw_input;
   if (pickle.ReadString(iter, &raw_input))
     Parse(raw_input);
@@ -204,6 +263,20 @@ void HttpResponseHeaders::Persist(Pickle* pickle, PersistOptions options) {
   if ((options & PERSIST_SANS_SECURITY_STATE) == PERSIST_SANS_SECURITY_STATE)
     AddSecurityStateHeaders(&filter_headers);
 
+  // Most filtered headers are common ones, which parsing has already
+  // recognized, so only the other headers need their names lowercased and
+  // looked up.
+  bool filter_common_headers[kNumCommonHeaders] = { false };
+  bool filter_other_headers = false;
+  for (HeaderSet::const_iterator it = filter_headers.begin();
+       it != filter_headers.end(); ++it) {
+    int common_header = LookupCommonHeader(it->begin(), it->end());
+    if (common_header == kNotCommonHeader)
+      filter_other_headers = true;
+    else
+      filter_common_headers[common_header] = true;
+  }
+
   std::string blob;
   blob.reserve(raw_headers_.size());
 
@@ -220,10 +293,18 @@ void HttpResponseHeaders::Persist(Pickle* pickle, PersistOptions options) {
     while (++k < parsed_.size() && parsed_[k].is_continuation()) {}
     --k;
 
-    std::string header_name(parsed_[i].name_begin, parsed_[i].name_end);
-    StringToLowerASCII(&header_name);
+    bool filtered;
+    if (parsed_[i].common_header != kNotCommonHeader) {
+      filtered = filter_common_headers[parsed_[i].common_header];
+    } else if (filter_other_headers) {
+      std::string header_name(parsed_[i].name_begin, parsed_[i].name_end);
+      StringToLowerASCII(&header_name);
+      filtered = filter_headers.find(header_name) != filter_headers.end();
+    } else {
+      filtered = false;
+    }
 
-    if (filter_headers.find(header_name) == filter_headers.end()) {
+    if (!filtered) {
       // Make sure there is a null after the value.
       blob.append(parsed_[i].name_begin, parsed_[k].value_end);
       blob.push_back('\0');
@@ -393,6 +474,8 @@ void HttpResponseHeaders::ReplaceStatusLine(const std::string& new_status) {
 }
 
 void HttpResponseHeaders::Parse(const std::string& raw_input) {
+  DCHECK(parsed_.empty());
+  ClearCommonHeaderIndex();
   raw_headers_.reserve(raw_input.size());
 
   // ParseStatusLine adds a normalized status line to raw_headers_
@@ -611,11 +694,30 @@ bool HttpResponseHeaders::HasHeader(const std::string& name) const {
 }
 
 HttpResponseHeaders::HttpResponseHeaders() : response_code_(-1) {
+  ClearCommonHeaderIndex();
 }
 
 HttpResponseHeaders::~HttpResponseHeaders() {
 }
 
+// static
+int HttpResponseHeaders::LookupCommonHeader(
+    std::string::const_iterator name_begin,
+    std::string::const_iterator name_end) {
+  size_t length = name_end - name_begin;
+  for (int i = 0; i < kNumCommonHeaders; ++i) {
+    if (kCommonHeaders[i].length == length &&
+        LowerCaseEqualsASCII(name_begin, name_end, kCommonHeaders[i].name))
+      return i;
+  }
+  return kNotCommonHeader;
+}
+
+void HttpResponseHeaders::ClearCommonHeaderIndex() {
+  std::fill(first_common_header_, first_common_header_ + kNumCommonHeaders,
+            std::string::npos);
+}
+
 // Note: this implementation implicitly assumes that line_end points at a valid
 // sentinel character (such as '\0').
 // static
@@ -735,8 +837,14 @@ void HttpResponseHeaders::ParseStatusLine(
 
 size_t HttpResponseHeaders::FindHeader(size_t from,
                                        const std::string& search) const {
+  int common_header = LookupCommonHeader(search.begin(), search.end());
+  if (common_header != kNotCommonHeader)
+    return FindCommonHeader(from, common_header);
+
   for (size_t i = from; i < parsed_.size(); ++i) {
-    if (parsed_[i].is_continuation())
+    // A common header's name can't match a name that isn't one.
+    if (parsed_[i].is_continuation() ||
+        parsed_[i].common_header != kNotCommonHeader)
       continue;
     const std::string::const_iterator& name_begin = parsed_[i].name_begin;
     const std::string::const_iterator& name_end = parsed_[i].name_end;
@@ -749,6 +857,19 @@ size_t HttpResponseHeaders::FindHeader(size_t from,
   return std::string::npos;
 }
 
+size_t HttpResponseHeaders::FindCommonHeader(size_t from,
+                                             int common_header) const {
+  DCHECK_GE(common_header, 0);
+  DCHECK_LT(common_header, kNumCommonHeaders);
+  for (size_t i = std::max(from, first_common_header_[common_header]);
+       i < parsed_.size(); ++i) {
+    if (parsed_[i].common_header == common_header &&
+        !parsed_[i].is_continuation())
+      return i;
+  }
+  return std::string::npos;
+}
+
 void HttpResponseHeaders::AddHeader(std::string::const_iterator name_begin,
                                     std::string::const_iterator name_end,
                                     std::string::const_iterator values_begin,
@@ -772,6 +893,15 @@ void HttpResponseHeaders::AddToParsed(std::string::const_iterator name_begin,
                                       std::string::const_iterator value_begin,
                                       std::string::const_iterator value_end) {
   ParsedHeader header;
+  if (name_begin == name_end) {
+    header.common_header = parsed_.empty() ? static_cast<int>(kNotCommonHeader)
+                                           : parsed_.back().common_header;
+  } else {
+    header.common_header = LookupCommonHeader(name_begin, name_end);
+    if (header.common_header != kNotCommonHeader &&
+        first_common_header_[header.common_header] == std::string::npos)
+      first_common_header_[header.common_header] = parsed_.size();
+  }
   header.name_begin = name_begin;
   header.name_end = name_end;
   header.value_begin = value_begin;
@@ -261,9 +261,24 @@ class NET_EXPORT HttpResponseHeaders
   struct ParsedHeader;
   typedef std::vector<ParsedHeader> HeaderList;
 
+  enum {
+    // The number of entries in the table of common header names.
+    kNumCommonHeaders = 40,
+    // Not the index of a common header.
+    kNotCommonHeader = -1,
+  };
+
   HttpResponseHeaders();
   ~HttpResponseHeaders();
 
+  // Returns the index of the common header named [name_begin, name_end),
+  // compared case-insensitively, or kNotCommonHeader.
+  static int LookupCommonHeader(std::string::const_iterator name_begin,
+                                std::string::const_iterator name_end);
+
+  // Forgets where the common headers are.
+  void ClearCommonHeaderIndex();
+
   // Initializes from the given raw headers.
   void Parse(const std::string& raw_input);
 
@@ -289,6 +304,9 @@ class NET_EXPORT HttpResponseHeaders
   // index |from|.  Returns string::npos if not found.
   size_t FindHeader(size_t from, const std::string& name) const;
 
+  // Like FindHeader(), for the common header at |common_header| in the table.
+  size_t FindCommonHeader(size_t from, int common_header) const;
+
   // Add a header->value pair to our list.  If we already have header in our
   // list, append the value to it.
   void AddHeader(std::string::const_iterator name_begin,
@@ -344,6 +362,11 @@ class NET_EXPORT HttpResponseHeaders
   // header-value pairs within raw_headers_.
   HeaderList parsed_;
 
+  // For each common header, the index in parsed_ of its first line, or
+  // string::npos if the response lacks the header. Lookups of common headers
+  // start there and compare table indices instead of names.
+  size_t first_common_header_[kNumCommonHeaders];
+
   // The raw_headers_ consists of the normalized status line (terminated with a
   // null byte) and then followed by the raw null-terminated headers from the
   // input that was passed to our constructor.  We preserve the input [*] to
@@ -507,6 +507,50 @@ TEST(HttpResponseHeadersTest, EnumerateHeader_Coalesced) {
   EXPECT_FALSE(parsed->EnumerateHeader(&iter, "cache-control", &value));
 }
 
+// Common headers are found by index, other headers by name; neither may
+// match the other.
+TEST(HttpResponseHeadersTest, EnumerateHeader_CommonAndOther) {
+  std::string headers =
+      "HTTP/1.1 200 OK\n"
+      "Content-TYPE: text/html\n"
+      "X-Content-Type: bogus\n"
+      "Cache-Control: private\n"
+      "X-Custom: a\n"
+      "cache-control: no-store\n"
+      "x-custom: b\n";
+  HeadersToRaw(&headers);
+  scoped_refptr<net::HttpResponseHeaders> parsed(
+      new net::HttpResponseHeaders(headers));
+
+  std::string value;
+  EXPECT_TRUE(parsed->EnumerateHeader(NULL, "content-type", &value));
+  EXPECT_EQ("text/html", value);
+  EXPECT_TRUE(parsed->EnumerateHeader(NULL, "x-content-type", &value));
+  EXPECT_EQ("bogus", value);
+  EXPECT_TRUE(parsed->HasHeader("CONTENT-type"));
+  EXPECT_FALSE(parsed->HasHeader("content-length"));
+  EXPECT_FALSE(parsed->HasHeader("x-other"));
+
+  void* iter = NULL;
+  EXPECT_TRUE(parsed->EnumerateHeader(&iter, "x-custom", &value));
+  EXPECT_EQ("a", value);
+  EXPECT_TRUE(parsed->EnumerateHeader(&iter, "x-custom", &value));
+  EXPECT_EQ("b", value);
+  EXPECT_FALSE(parsed->EnumerateHeader(&iter, "x-custom", &value));
+
+  EXPECT_TRUE(parsed->GetNormalizedHeader("cache-control", &value));
+  EXPECT_EQ("private, no-store", value);
+
+  // The index follows changes to the headers.
+  parsed->RemoveHeader("Content-Type");
+  EXPECT_FALSE(parsed->HasHeader("content-type"));
+  EXPECT_TRUE(parsed->HasHeader("x-content-type"));
+  parsed->AddHeader("Content-Length: 10");
+  EXPECT_EQ(10, parsed->GetContentLength());
+  EXPECT_TRUE(parsed->GetNormalizedHeader("cache-control", &value));
+  EXPECT_EQ("private, no-store", value);
+}
+
 TEST(HttpResponseHeadersTest, EnumerateHeader_Challenge) {
   // Even though WWW-Authenticate has commas, it should not be treated as
   // coalesced values.
@@ -25,6 +25,11 @@ const char kLengthHeader[] = "Content-Length";
 const char kRangeHeader[] = "Content-Range";
 const int kDataStream = 1;
 
+// Cached blocks smaller than this, with missing data on both sides, are
+// fetched again along with the data around them: one request for the whole
+// span costs less than a round trip for each gap.
+const int kMinCachedRangeLen = 32 * 1024;
+
 void AddRangeHeader(int64 start, int64 end, HttpRequestHeaders* headers) {
   DCHECK(start >= 0 || end >= 0);
   std::string my_start, my_end;
@@ -102,8 +107,14 @@ int PartialData::Core::GetAvailableRange(disk_cache::Entry* entry, int64 offset,
 }
 
 void PartialData::Core::OnIOComplete(int result) {
-  if (owner_)
-    owner_->GetAvailableRangeCompleted(result, start_);
+  // Detach from the owner first; it may start another scan from the callback.
+  PartialData* owner = owner_;
+  if (owner_) {
+    owner_->core_ = NULL;
+    owner_ = NULL;
+  }
+  if (owner)
+    owner->GetAvailableRangeCompleted(result, start_);
   delete this;
 }
 
@@ -115,7 +126,8 @@ PartialData::PartialData()
       sparse_entry_(true),
       truncated_(false),
       initial_validation_(false),
-      core_(NULL) {
+      core_(NULL),
+      scan_entry_(NULL) {
 }
 
 PartialData::~PartialData() {
@@ -173,9 +185,8 @@ int PartialData::ShouldValidateCache(disk_cache::Entry* entry,
 
   if (sparse_entry_) {
     DCHECK(callback_.is_null());
-    Core* core = Core::CreateCore(this);
-    cached_min_len_ = core->GetAvailableRange(entry, current_range_start_, len,
-                                              &cached_start_);
+    scan_entry_ = entry;
+    cached_min_len_ = ScanCache(current_range_start_);
 
     if (cached_min_len_ == ERR_IO_PENDING) {
       callback_ = callback;
@@ -479,11 +490,41 @@ int PartialData::GetNextRangeLen() {
   return static_cast<int32>(range_len);
 }
 
+int PartialData::ScanCache(int64 offset) {
+  DCHECK(scan_entry_);
+  for (;;) {
+    int len = GetNextRangeLen() -
+              static_cast<int>(offset - current_range_start_);
+    Core* core = Core::CreateCore(this);
+    int rv = core->GetAvailableRange(scan_entry_, offset, len, &cached_start_);
+    if (rv == ERR_IO_PENDING || !ShouldSkipCachedRange(rv))
+      return rv;
+    offset = cached_start_ + rv;
+  }
+}
+
+bool PartialData::ShouldSkipCachedRange(int cached_len) const {
+  if (cached_len <= 0 || cached_len >= kMinCachedRangeLen)
+    return false;
+
+  // Only skip a block that sits between two pieces of the range that have to
+  // come from the network anyway.
+  if (cached_start_ == current_range_start_ ||
+      !byte_range_.HasLastBytePosition())
+    return false;
+  return cached_start_ + cached_len <= byte_range_.last_byte_position();
+}
+
 void PartialData::GetAvailableRangeCompleted(int result, int64 start) {
   DCHECK(!callback_.is_null());
   DCHECK_NE(ERR_IO_PENDING, result);
 
   cached_start_ = start;
+  if (ShouldSkipCachedRange(result)) {
+    result = ScanCache(start + result);
+    if (result == ERR_IO_PENDING)
+      return;
+  }
   cached_min_len_ = result;
   if (result >= 0)
     result = 1;  // Return success, go ahead and validate the entry.
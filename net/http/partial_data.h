@@ -120,6 +120,16 @@ class PartialData {
   // Returns the length to use when scanning the cache.
   int GetNextRangeLen();
 
+  // Looks for the next block of cached data worth reading, starting at
+  // |offset|. Returns the length of that block (0 if there is none) and sets
+  // |cached_start_|, or returns ERR_IO_PENDING and finishes the scan from
+  // GetAvailableRangeCompleted().
+  int ScanCache(int64 offset);
+
+  // Returns true if the |cached_len| bytes found at |cached_start_| are better
+  // fetched from the network together with the missing data around them.
+  bool ShouldSkipCachedRange(int cached_len) const;
+
   // Completion routine for our callback.
   void GetAvailableRangeCompleted(int result, int64 start);
 
@@ -136,6 +146,7 @@ class PartialData {
   bool truncated_;  // We have an incomplete 200 stored.
   bool initial_validation_;  // Only used for truncated entries.
   Core* core_;
+  disk_cache::Entry* scan_entry_;  // The entry being scanned, not owned.
   CompletionCallback callback_;
 
   DISALLOW_COPY_AND_ASSIGN(PartialData);
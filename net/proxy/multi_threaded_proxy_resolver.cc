@@ -10,9 +10,12 @@
 #include "base/stringprintf.h"
 #include "base/threading/thread.h"
 #include "base/threading/thread_restrictions.h"
+#include "base/utf_string_conversions.h"
+#include "googleurl/src/gurl.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_log.h"
 #include "net/proxy/proxy_info.h"
+#include "net/proxy/proxy_resolver_script_data.h"
 
 // TODO(eroman): Have the MultiThreadedProxyResolver clear its PAC script
 //               data when SetPacScript fails. That will reclaim memory when
@@ -68,6 +71,8 @@ class MultiThreadedProxyResolver::Executor
 
   int thread_number() const { return thread_number_; }
 
+  MultiThreadedProxyResolver* coordinator() { return coordinator_; }
+
  private:
   friend class base::RefCountedThreadSafe<Executor>;
   ~Executor();
@@ -119,6 +124,12 @@ class MultiThreadedProxyResolver::Job
     return executor_;
   }
 
+  // The MultiThreadedProxyResolver that scheduled this job, or NULL once the
+  // executor is gone.
+  MultiThreadedProxyResolver* coordinator() {
+    return executor_ ? executor_->coordinator() : NULL;
+  }
+
   // Mark the job as having been cancelled.
   void Cancel() {
     was_cancelled_ = true;
@@ -280,6 +291,8 @@ class MultiThreadedProxyResolver::GetProxyForURLJob
       if (result_code >= OK) {  // Note: unit-tests use values > 0.
         results_->Use(results_buf_);
       }
+      if (result_code == OK && coordinator())
+        coordinator()->OnResultAvailable(url_, results_buf_);
       RunUserCallback(result_code);
     }
     OnJobCompleted();
@@ -392,7 +405,8 @@ MultiThreadedProxyResolver::MultiThreadedProxyResolver(
     size_t max_num_threads)
     : ProxyResolver(resolver_factory->resolvers_expect_pac_bytes()),
       resolver_factory_(resolver_factory),
-      max_num_threads_(max_num_threads) {
+      max_num_threads_(max_num_threads),
+      current_script_cacheable_(false) {
   DCHECK_GE(max_num_threads, 1u);
 }
 
@@ -402,6 +416,15 @@ MultiThreadedProxyResolver::~MultiThreadedProxyResolver() {
   ReleaseAllExecutors();
 }
 
+void MultiThreadedProxyResolver::EnableResultCache(size_t max_entries,
+                                                   base::TimeDelta ttl) {
+  DCHECK(CalledOnValidThread());
+  DCHECK_GT(max_entries, 0u);
+  result_cache_.reset(new ResultCache(max_entries));
+  result_cache_ttl_ = ttl;
+  current_script_cacheable_ = IsScriptCacheable(current_script_data_);
+}
+
 int MultiThreadedProxyResolver::GetProxyForURL(
     const GURL& url, ProxyInfo* results, const CompletionCallback& callback,
     RequestHandle* request, const BoundNetLog& net_log) {
@@ -410,6 +433,18 @@ int MultiThreadedProxyResolver::GetProxyForURL(
   DCHECK(current_script_data_.get())
       << "Resolver is un-initialized. Must call SetPacScript() first!";
 
+  if (result_cache_.get() && current_script_cacheable_) {
+    ResultCache::iterator it = result_cache_->Get(url.spec());
+    if (it != result_cache_->end()) {
+      if (base::TimeTicks::Now() < it->second.expiration) {
+        results->Use(it->second.results);
+        net_log.AddEvent(NetLog::TYPE_PROXY_RESOLVER_CACHE_HIT, NULL);
+        return OK;
+      }
+      result_cache_->Erase(it);
+    }
+  }
+
   scoped_refptr<GetProxyForURLJob> job(
       new GetProxyForURLJob(url, results, callback, net_log));
 
@@ -510,6 +545,12 @@ int MultiThreadedProxyResolver::SetPacScript(
   // Save the script details, so we can provision new executors later.
   current_script_data_ = script_data;
 
+  // Results of the previous script no longer apply.
+  if (result_cache_.get()) {
+    result_cache_->Clear();
+    current_script_cacheable_ = IsScriptCacheable(script_data);
+  }
+
   // The user should not have any outstanding requests when they call
   // SetPacScript().
   CheckNoOutstandingUserRequests();
@@ -524,6 +565,41 @@ int MultiThreadedProxyResolver::SetPacScript(
   return ERR_IO_PENDING;
 }
 
+// static
+bool MultiThreadedProxyResolver::IsScriptCacheable(
+    const scoped_refptr<ProxyResolverScriptData>& script_data) {
+  if (!script_data.get() ||
+      script_data->type() != ProxyResolverScriptData::TYPE_SCRIPT_CONTENTS) {
+    return false;
+  }
+
+  // Anything that makes FindProxyForURL() answer differently for the same
+  // URL, other than DNS, which the cache TTL bounds. The PAC utility
+  // functions dateRange(), timeRange() and weekdayRange() are covered by
+  // "Range(".
+  static const char* const kUncacheableTokens[] = {
+    "Date", "Range(", "random",
+  };
+  const string16& script = script_data->utf16();
+  for (size_t i = 0; i < arraysize(kUncacheableTokens); ++i) {
+    if (script.find(ASCIIToUTF16(kUncacheableTokens[i])) != string16::npos)
+      return false;
+  }
+  return true;
+}
+
+void MultiThreadedProxyResolver::OnResultAvailable(const GURL& url,
+                                                   const ProxyInfo& results) {
+  DCHECK(CalledOnValidThread());
+  if (!result_cache_.get() || !current_script_cacheable_)
+    return;
+
+  CachedResult entry;
+  entry.results.Use(results);
+  entry.expiration = base::TimeTicks::Now() + result_cache_ttl_;
+  result_cache_->Put(url.spec(), entry);
+}
+
 void MultiThreadedProxyResolver::CheckNoOutstandingUserRequests() const {
   DCHECK(CalledOnValidThread());
   CHECK_EQ(0u, pending_jobs_.size());
@@ -7,13 +7,17 @@
 #pragma once
 
 #include <deque>
+#include <string>
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/memory/mru_cache.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/non_thread_safe.h"
+#include "base/time.h"
 #include "net/base/net_export.h"
+#include "net/proxy/proxy_info.h"
 #include "net/proxy/proxy_resolver.h"
 
 namespace base {
@@ -91,6 +95,14 @@ class NET_EXPORT_PRIVATE MultiThreadedProxyResolver
 
   virtual ~MultiThreadedProxyResolver();
 
+  // Keeps up to |max_entries| successful results for |ttl|, keyed by the
+  // query URL, so that asking again for a URL completes synchronously
+  // without running the script. The cache is cleared whenever a script is
+  // set. Scripts that read the clock or call Math.random() are not cached,
+  // since their answers depend on more than the URL; neither are scripts
+  // the resolvers fetch for themselves, which cannot be inspected.
+  void EnableResultCache(size_t max_entries, base::TimeDelta ttl);
+
   // ProxyResolver implementation:
   virtual int GetProxyForURL(const GURL& url,
                              ProxyInfo* results,
@@ -117,6 +129,19 @@ class NET_EXPORT_PRIVATE MultiThreadedProxyResolver
   typedef std::deque<scoped_refptr<Job> > PendingJobsQueue;
   typedef std::vector<scoped_refptr<Executor> > ExecutorList;
 
+  struct CachedResult {
+    ProxyInfo results;
+    base::TimeTicks expiration;
+  };
+  typedef base::MRUCache<std::string, CachedResult> ResultCache;
+
+  // Returns true if the results of |script_data| may be cached.
+  static bool IsScriptCacheable(
+      const scoped_refptr<ProxyResolverScriptData>& script_data);
+
+  // Called by a GetProxyForURL job that completed successfully.
+  void OnResultAvailable(const GURL& url, const ProxyInfo& results);
+
   // Asserts that there are no outstanding user-initiated jobs on any of the
   // worker threads.
   void CheckNoOutstandingUserRequests() const;
@@ -139,6 +164,12 @@ class NET_EXPORT_PRIVATE MultiThreadedProxyResolver
   PendingJobsQueue pending_jobs_;
   ExecutorList executors_;
   scoped_refptr<ProxyResolverScriptData> current_script_data_;
+
+  // Only allocated once EnableResultCache() is called.
+  scoped_ptr<ResultCache> result_cache_;
+  base::TimeDelta result_cache_ttl_;
+  // Whether |current_script_data_| may use |result_cache_|.
+  bool current_script_cacheable_;
 };
 
 }  // namespace net
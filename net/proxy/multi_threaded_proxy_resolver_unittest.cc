@@ -793,6 +793,86 @@ TEST(MultiThreadedProxyResolverTest, OneThreadBlocked) {
   EXPECT_EQ(3, factory->resolvers()[1]->request_count());
 }
 
+// Tests that successful results are answered from the cache until a new
+// script is set.
+TEST(MultiThreadedProxyResolverTest, ResultCache) {
+  scoped_ptr<MockProxyResolver> mock(new MockProxyResolver);
+  MultiThreadedProxyResolver resolver(
+      new ForwardingProxyResolverFactory(mock.get()), 1u);
+  resolver.EnableResultCache(10, base::TimeDelta::FromHours(1));
+
+  TestCompletionCallback set_script_callback;
+  int rv = resolver.SetPacScript(
+      ProxyResolverScriptData::FromUTF8("pac script bytes"),
+      set_script_callback.callback());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, set_script_callback.WaitForResult());
+
+  // The first request runs the script, which returns OK.
+  TestCompletionCallback callback0;
+  ProxyInfo results0;
+  rv = resolver.GetProxyForURL(GURL("http://request0"), &results0,
+                               callback0.callback(), NULL, BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, callback0.WaitForResult());
+
+  // Asking again is answered synchronously, without running the script.
+  CapturingBoundNetLog log(CapturingNetLog::kUnbounded);
+  ProxyInfo results1;
+  rv = resolver.GetProxyForURL(GURL("http://request0"), &results1,
+                               callback0.callback(), NULL, log.bound());
+  EXPECT_EQ(OK, rv);
+  EXPECT_EQ("PROXY request0:80", results1.ToPacString());
+  EXPECT_EQ(1, mock->request_count());
+  net::CapturingNetLog::EntryList entries;
+  log.GetEntries(&entries);
+  ASSERT_EQ(1u, entries.size());
+  EXPECT_EQ(NetLog::TYPE_PROXY_RESOLVER_CACHE_HIT, entries[0].type);
+
+  // Setting a script drops the cached results.
+  rv = resolver.SetPacScript(
+      ProxyResolverScriptData::FromUTF8("other pac script bytes"),
+      set_script_callback.callback());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, set_script_callback.WaitForResult());
+
+  TestCompletionCallback callback2;
+  ProxyInfo results2;
+  rv = resolver.GetProxyForURL(GURL("http://request0"), &results2,
+                               callback2.callback(), NULL, BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(1, callback2.WaitForResult());
+  EXPECT_EQ(2, mock->request_count());
+}
+
+// Tests that the results of a script which reads the time are not cached.
+TEST(MultiThreadedProxyResolverTest, ResultCacheTimeDependentScript) {
+  scoped_ptr<MockProxyResolver> mock(new MockProxyResolver);
+  MultiThreadedProxyResolver resolver(
+      new ForwardingProxyResolverFactory(mock.get()), 1u);
+  resolver.EnableResultCache(10, base::TimeDelta::FromHours(1));
+
+  TestCompletionCallback set_script_callback;
+  int rv = resolver.SetPacScript(
+      ProxyResolverScriptData::FromUTF8(
+          "function FindProxyForURL(url, host) {\n"
+          "  return timeRange(9, 17) ? \"PROXY work:80\" : \"DIRECT\";\n"
+          "}\n"),
+      set_script_callback.callback());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, set_script_callback.WaitForResult());
+
+  for (int i = 0; i < 2; ++i) {
+    TestCompletionCallback callback;
+    ProxyInfo results;
+    rv = resolver.GetProxyForURL(GURL("http://request0"), &results,
+                                 callback.callback(), NULL, BoundNetLog());
+    EXPECT_EQ(ERR_IO_PENDING, rv);
+    EXPECT_EQ(i, callback.WaitForResult());
+  }
+  EXPECT_EQ(2, mock->request_count());
+}
+
 }  // namespace
 
 }  // namespace net
@@ -5,9 +5,11 @@
 #include "base/base_paths.h"
 #include "base/compiler_specific.h"
 #include "base/file_util.h"
+#include "base/memory/scoped_vector.h"
 #include "base/path_service.h"
 #include "base/perftimer.h"
 #include "base/string_util.h"
+#include "base/stringprintf.h"
 #include "net/base/mock_host_resolver.h"
 #include "net/base/net_errors.h"
 #include "net/proxy/proxy_info.h"
@@ -89,6 +91,13 @@ int PacPerfTest::NumQueries() const {
 // The number of URLs to resolve when testing a PAC script.
 const int kNumIterations = 500;
 
+// About the size of a large corporate PAC script.
+const size_t kLargeScriptSize = 300 * 1024;
+
+// The number of PAC threads ProxyService runs by default, each of which
+// loads the script into its own resolver.
+const int kNumPacThreads = 4;
+
 // Helper class to run through all the performance tests using the specified
 // proxy resolver implementation.
 class PacPerfSuiteRunner {
@@ -217,3 +226,51 @@ TEST(ProxyResolverPerfTest, ProxyResolverV8) {
   runner.RunAllTests();
 }
 
+// Measures loading a large PAC script once per PAC thread. Every load after
+// the first reuses the first one's preparse data.
+TEST(ProxyResolverPerfTest, ProxyResolverV8LargeScript) {
+  std::string script;
+  for (int i = 0; script.size() < kLargeScriptSize; ++i) {
+    script += base::StringPrintf(
+        "function rule%d(url, host) {\n"
+        "  if (shExpMatch(host, \"*.dept%d.example.com\"))\n"
+        "    return \"PROXY proxy%d.example.com:8080\";\n"
+        "  return null;\n"
+        "}\n", i, i, i % 16);
+  }
+  script +=
+      "function FindProxyForURL(url, host) {\n"
+      "  return rule7(url, host) || \"DIRECT\";\n"
+      "}\n";
+  scoped_refptr<net::ProxyResolverScriptData> script_data(
+      net::ProxyResolverScriptData::FromUTF8(script));
+
+  ScopedVector<net::ProxyResolverV8> resolvers;
+  for (int i = 0; i < kNumPacThreads; ++i) {
+    resolvers.push_back(new net::ProxyResolverV8(
+        net::ProxyResolverJSBindings::CreateDefault(
+            new MockSyncHostResolver, NULL, NULL)));
+  }
+
+  PerfTimeLogger first_timer("ProxyResolverV8_load_first");
+  EXPECT_EQ(net::OK,
+            resolvers[0]->SetPacScript(script_data, net::CompletionCallback()));
+  first_timer.Done();
+
+  PerfTimeLogger others_timer("ProxyResolverV8_load_others");
+  for (int i = 1; i < kNumPacThreads; ++i) {
+    EXPECT_EQ(net::OK,
+              resolvers[i]->SetPacScript(script_data,
+                                         net::CompletionCallback()));
+  }
+  others_timer.Done();
+
+  for (int i = 0; i < kNumPacThreads; ++i) {
+    net::ProxyInfo proxy_info;
+    EXPECT_EQ(net::OK, resolvers[i]->GetProxyForURL(
+        GURL("http://www.dept7.example.com"), &proxy_info,
+        net::CompletionCallback(), NULL, net::BoundNetLog()));
+    EXPECT_EQ("PROXY proxy7.example.com:8080", proxy_info.ToPacString());
+  }
+}
+
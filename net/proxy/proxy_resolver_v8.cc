@@ -9,6 +9,7 @@
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/string_tokenizer.h"
 #include "base/string_util.h"
@@ -184,6 +185,44 @@ v8::Local<v8::String> ASCIILiteralToV8String(const char* ascii) {
   return v8::String::NewExternal(new V8ExternalASCIILiteral(ascii, length));
 }
 
+// Holds the preparse data of the most recently loaded PAC script. Each PAC
+// thread loads the same script into a context of its own; the first one to
+// load it preparses it, and the others compile straight from its data.
+// Must be used while holding a v8::Locker.
+class PreparseCache {
+ public:
+  PreparseCache() {}
+
+  // Returns preparse data for |script_data|, whose V8 string is |source|,
+  // or NULL if it cannot be preparsed. The caller owns the result.
+  v8::ScriptData* Get(const scoped_refptr<ProxyResolverScriptData>& script_data,
+                      v8::Handle<v8::String> source) {
+    base::AutoLock auto_lock(lock_);
+    if (script_data_.get() == script_data.get())
+      return v8::ScriptData::New(data_.data(), data_.size());
+
+    script_data_ = NULL;
+    data_.clear();
+    scoped_ptr<v8::ScriptData> preparsed(v8::ScriptData::PreCompile(source));
+    if (!preparsed.get() || preparsed->HasError())
+      return NULL;
+    data_.assign(preparsed->Data(), preparsed->Length());
+    script_data_ = script_data;
+    return preparsed.release();
+  }
+
+ private:
+  base::Lock lock_;
+  // Keeps the script, and thus its address, alive while |data_| is for it.
+  scoped_refptr<ProxyResolverScriptData> script_data_;
+  std::string data_;
+
+  DISALLOW_COPY_AND_ASSIGN(PreparseCache);
+};
+
+base::LazyInstance<PreparseCache>::Leaky g_preparse_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
 // Stringizes a V8 object by calling its toString() method. Returns true
 // on success. This may fail if the toString() throws an exception.
 bool V8ObjectToUTF16String(v8::Handle<v8::Value> object,
@@ -460,14 +499,18 @@ class ProxyResolverV8::Context {
         ASCIILiteralToV8String(
             PROXY_RESOLVER_SCRIPT
             PROXY_RESOLVER_SCRIPT_EX),
-        kPacUtilityResourceName);
+        kPacUtilityResourceName,
+        NULL);
     if (rv != OK) {
       NOTREACHED();
       return rv;
     }
 
     // Add the user's PAC code to the environment.
-    rv = RunScript(ScriptDataToV8String(pac_script), kPacResourceName);
+    v8::Local<v8::String> source = ScriptDataToV8String(pac_script);
+    scoped_ptr<v8::ScriptData> preparse_data(
+        g_preparse_cache.Get().Get(pac_script, source));
+    rv = RunScript(source, kPacResourceName, preparse_data.get());
     if (rv != OK)
       return rv;
 
@@ -544,15 +587,19 @@ class ProxyResolverV8::Context {
     js_bindings_->OnError(line_number, error_message);
   }
 
-  // Compiles and runs |script| in the current V8 context.
+  // Compiles and runs |script| in the current V8 context, using
+  // |preparse_data| if it is not NULL.
   // Returns OK on success, otherwise an error code.
-  int RunScript(v8::Handle<v8::String> script, const char* script_name) {
+  int RunScript(v8::Handle<v8::String> script,
+                const char* script_name,
+                v8::ScriptData* preparse_data) {
     v8::TryCatch try_catch;
 
     // Compile the script.
     v8::ScriptOrigin origin =
         v8::ScriptOrigin(ASCIILiteralToV8String(script_name));
-    v8::Local<v8::Script> code = v8::Script::Compile(script, &origin);
+    v8::Local<v8::Script> code =
+        v8::Script::Compile(script, &origin, preparse_data);
 
     // Execute.
     if (!code.IsEmpty())
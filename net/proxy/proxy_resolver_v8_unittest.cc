@@ -569,5 +569,44 @@ TEST(ProxyResolverV8Test, IPv6HostnamesNotBracketed) {
   EXPECT_EQ("abcd::efff", resolver.mock_js_bindings()->dns_resolves_ex[0]);
 }
 
+// Resolvers loading the same script share its preparse data; they must all
+// end up with a working script, as must a resolver loading another script
+// afterwards.
+TEST(ProxyResolverV8Test, SharedPreparseData) {
+  std::string script;
+  for (int i = 0; i < 100; ++i) {
+    script += base::StringPrintf(
+        "function helper%d(host) { return host + \"%d\"; }\n", i, i);
+  }
+  scoped_refptr<ProxyResolverScriptData> script_data(
+      ProxyResolverScriptData::FromUTF8(
+          script +
+          "function FindProxyForURL(url, host) {\n"
+          "  return \"PROXY \" + helper42(host) + \":80\";\n"
+          "}\n"));
+
+  ProxyResolverV8WithMockBindings resolvers[3];
+  for (size_t i = 0; i < arraysize(resolvers); ++i) {
+    EXPECT_EQ(OK, resolvers[i].SetPacScript(script_data, CompletionCallback()));
+    ProxyInfo proxy_info;
+    EXPECT_EQ(OK, resolvers[i].GetProxyForURL(
+        kQueryUrl, &proxy_info, CompletionCallback(), NULL, BoundNetLog()));
+    EXPECT_EQ("PROXY www.google.com42:80", proxy_info.ToPacString());
+  }
+
+  ProxyResolverV8WithMockBindings other_resolver;
+  EXPECT_EQ(OK, other_resolver.SetPacScript(
+      ProxyResolverScriptData::FromUTF8(
+          script +
+          "function FindProxyForURL(url, host) {\n"
+          "  return \"PROXY \" + helper7(host) + \":80\";\n"
+          "}\n"),
+      CompletionCallback()));
+  ProxyInfo proxy_info;
+  EXPECT_EQ(OK, other_resolver.GetProxyForURL(
+      kQueryUrl, &proxy_info, CompletionCallback(), NULL, BoundNetLog()));
+  EXPECT_EQ("PROXY www.google.com7:80", proxy_info.ToPacString());
+}
+
 }  // namespace
 }  // namespace net
@@ -52,6 +52,12 @@ namespace {
 const size_t kMaxNumNetLogEntries = 100;
 const size_t kDefaultNumPacThreads = 4;
 
+// How many results of the V8 resolver to keep, and for how long. The TTL
+// matches that of the host cache, since DNS is the one input to a cacheable
+// script besides the URL.
+const size_t kPacResultCacheSize = 500;
+const int kPacResultCacheTTLSeconds = 60;
+
 // When the IP address changes we don't immediately re-run proxy auto-config.
 // Instead, we  wait for |kDelayAfterNetworkChangesMs| before
 // attempting to re-valuate proxy auto-config.
@@ -954,8 +960,11 @@ ProxyService* ProxyService::CreateUsingV8ProxyResolver(
           net_log,
           network_delegate);
 
-  ProxyResolver* proxy_resolver =
+  MultiThreadedProxyResolver* proxy_resolver =
       new MultiThreadedProxyResolver(sync_resolver_factory, num_pac_threads);
+  proxy_resolver->EnableResultCache(
+      kPacResultCacheSize,
+      TimeDelta::FromSeconds(kPacResultCacheTTLSeconds));
 
   ProxyService* proxy_service =
       new ProxyService(proxy_config_service, proxy_resolver, net_log);
@@ -30,14 +30,17 @@ void HttpConnection::Send200(const std::string& data,
                              const std::string& content_type) {
   if (!socket_)
     return;
-  socket_->Send(base::StringPrintf(
+  // The headers and the body go out in one send(), so that Nagle's algorithm
+  // doesn't hold the body back until the client acks the headers.
+  std::string response = base::StringPrintf(
       "HTTP/1.1 200 OK\r\n"
       "Content-Type:%s\r\n"
       "Content-Length:%d\r\n"
       "\r\n",
       content_type.c_str(),
-      static_cast<int>(data.length())));
-  socket_->Send(data);
+      static_cast<int>(data.length()));
+  response.append(data);
+  socket_->Send(response);
 }
 
 void HttpConnection::Send404() {
@@ -78,7 +81,7 @@ void HttpConnection::DetachSocket() {
 }
 
 void HttpConnection::Shift(int num_bytes) {
-  recv_data_ = recv_data_.substr(num_bytes);
+  recv_data_.erase(0, num_bytes);
 }
 
 }  // namespace net
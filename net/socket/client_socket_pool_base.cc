@@ -39,6 +39,16 @@ const int kCleanupInterval = 10;  // DO NOT INCREASE THIS TIMEOUT.
 // after a certain timeout has passed without receiving an ACK.
 bool g_connect_backup_jobs_enabled = true;
 
+// Whether RequestSockets() keeps sockets warm, and idle timeouts adapt to
+// their reuse.
+bool g_warm_pool_enabled = false;
+
+// A group's warm target halves every this many seconds.
+const int kWarmTargetHalfLifeSeconds = 30;
+
+// The weight of each idle socket's fate in a group's reuse rate.
+const double kReuseRateWeight = 0.25;
+
 double g_socket_reuse_policy_penalty_exponent = -1;
 int g_socket_reuse_policy = -1;
 
@@ -296,6 +306,8 @@ void ClientSocketPoolBaseHelper::RequestSockets(
           "num_sockets", num_sockets)));
 
   Group* group = GetOrCreateGroup(group_name);
+  if (g_warm_pool_enabled)
+    group->SetWarmTarget(num_sockets, base::TimeTicks::Now());
 
   // RequestSocketsInternal() may delete the group.
   bool deleted_group = false;
@@ -476,6 +488,7 @@ bool ClientSocketPoolBaseHelper::AssignIdleSocketToGroup(
         base::TimeTicks::Now() - idle_socket_it->start_time;
     IdleSocket idle_socket = *idle_socket_it;
     idle_sockets->erase(idle_socket_it);
+    group->OnIdleSocketReused();
     HandOutSocket(
         idle_socket.socket,
         idle_socket.socket->WasEverUsed(),
@@ -619,6 +632,10 @@ DictionaryValue* ClientSocketPoolBaseHelper::GetInfoAsValue(
     }
 
     group_dict->SetInteger("active_socket_count", group->active_socket_count());
+    if (g_warm_pool_enabled) {
+      group_dict->SetInteger("warm_target",
+                             group->WarmTarget(base::TimeTicks::Now()));
+    }
 
     ListValue* idle_socket_list = new ListValue();
     std::list<IdleSocket>::const_iterator idle_socket;
@@ -655,9 +672,13 @@ bool ClientSocketPoolBaseHelper::IdleSocket::ShouldCleanup(
   bool timed_out = (now - start_time) >= timeout;
   if (timed_out)
     return true;
+  return !IsUsable();
+}
+
+bool ClientSocketPoolBaseHelper::IdleSocket::IsUsable() const {
   if (socket->WasEverUsed())
-    return !socket->IsConnectedAndIdle();
-  return !socket->IsConnected();
+    return socket->IsConnectedAndIdle();
+  return socket->IsConnected();
 }
 
 void ClientSocketPoolBaseHelper::CleanupIdleSockets(bool force) {
@@ -672,16 +693,36 @@ void ClientSocketPoolBaseHelper::CleanupIdleSockets(bool force) {
   while (i != group_map_.end()) {
     Group* group = i->second;
 
+    int warm_target = 0;
+    double timeout_scale = 1.0;
+    if (g_warm_pool_enabled) {
+      warm_target = group->WarmTarget(now);
+      timeout_scale = group->IdleTimeoutScale();
+    }
+    int num_kept = 0;
+
     std::list<IdleSocket>::iterator j = group->mutable_idle_sockets()->begin();
     while (j != group->idle_sockets().end()) {
       base::TimeDelta timeout =
           j->socket->WasEverUsed() ?
           used_idle_socket_timeout_ : unused_idle_socket_timeout_;
-      if (force || j->ShouldCleanup(now, timeout)) {
+      if (timeout_scale != 1.0) {
+        timeout = base::TimeDelta::FromMicroseconds(
+            static_cast<int64>(timeout.InMicroseconds() * timeout_scale));
+      }
+      bool remove = force || j->ShouldCleanup(now, timeout);
+      if (remove && !force && num_kept < warm_target && j->IsUsable()) {
+        // Timed out, but the group is to be kept warm.
+        remove = false;
+      }
+      if (remove) {
+        if (!force && j->IsUsable())
+          group->OnIdleSocketTimedOut();
         delete j->socket;
         j = group->mutable_idle_sockets()->erase(j);
         DecrementIdleCount();
       } else {
+        ++num_kept;
         ++j;
       }
     }
@@ -729,6 +770,18 @@ bool ClientSocketPoolBaseHelper::set_connect_backup_jobs_enabled(bool enabled) {
   return old_value;
 }
 
+// static
+bool ClientSocketPoolBaseHelper::warm_pool_enabled() {
+  return g_warm_pool_enabled;
+}
+
+// static
+bool ClientSocketPoolBaseHelper::set_warm_pool_enabled(bool enabled) {
+  bool old_value = g_warm_pool_enabled;
+  g_warm_pool_enabled = enabled;
+  return old_value;
+}
+
 void ClientSocketPoolBaseHelper::EnableConnectBackupJobs() {
   connect_backup_jobs_enabled_ = g_connect_backup_jobs_enabled;
 }
@@ -1143,12 +1196,42 @@ void ClientSocketPoolBaseHelper::InvokeUserCallback(
 
 ClientSocketPoolBaseHelper::Group::Group()
     : active_socket_count_(0),
+      warm_target_(0),
+      reuse_rate_(0.5),
       ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {}
 
 ClientSocketPoolBaseHelper::Group::~Group() {
   CleanupBackupJob();
 }
 
+void ClientSocketPoolBaseHelper::Group::SetWarmTarget(int num_sockets,
+                                                      base::TimeTicks now) {
+  warm_target_ = std::max(WarmTarget(now), num_sockets);
+  warm_target_time_ = now;
+}
+
+int ClientSocketPoolBaseHelper::Group::WarmTarget(base::TimeTicks now) const {
+  if (!warm_target_)
+    return 0;
+  int64 half_lives = (now - warm_target_time_).InSeconds() /
+      kWarmTargetHalfLifeSeconds;
+  if (half_lives >= 31)
+    return 0;
+  return warm_target_ >> half_lives;
+}
+
+void ClientSocketPoolBaseHelper::Group::OnIdleSocketReused() {
+  reuse_rate_ += kReuseRateWeight * (1 - reuse_rate_);
+}
+
+void ClientSocketPoolBaseHelper::Group::OnIdleSocketTimedOut() {
+  reuse_rate_ -= kReuseRateWeight * reuse_rate_;
+}
+
+double ClientSocketPoolBaseHelper::Group::IdleTimeoutScale() const {
+  return pow(4.0, reuse_rate_ - 0.5);
+}
+
 void ClientSocketPoolBaseHelper::Group::StartBackupSocketTimer(
     const std::string& group_name,
     ClientSocketPoolBaseHelper* pool) {
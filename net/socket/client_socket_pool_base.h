@@ -336,6 +336,15 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
   static bool connect_backup_jobs_enabled();
   static bool set_connect_backup_jobs_enabled(bool enabled);
 
+  // Called to enable/disable the warm pool policy. When enabled, the count
+  // passed to RequestSockets() becomes the group's warm target: up to that
+  // many idle sockets are kept past their timeouts, while the target halves
+  // every thirty seconds that no new preconnect renews it. Idle timeouts
+  // also scale, from half to twice their length, with how often each
+  // group's idle sockets end up reused.
+  static bool warm_pool_enabled();
+  static bool set_warm_pool_enabled(bool enabled);
+
   void EnableConnectBackupJobs();
 
   // ConnectJob::Delegate methods:
@@ -361,6 +370,9 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
     // socket for a new request.
     bool ShouldCleanup(base::TimeTicks now, base::TimeDelta timeout) const;
 
+    // Returns false if the socket can't be reused, as above.
+    bool IsUsable() const;
+
     StreamSocket* socket;
     base::TimeTicks start_time;
   };
@@ -401,6 +413,20 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
 
     bool HasBackupJob() const { return weak_factory_.HasWeakPtrs(); }
 
+    // Raises the warm target to |num_sockets| as of |now|.
+    void SetWarmTarget(int num_sockets, base::TimeTicks now);
+
+    // Returns the number of idle sockets to keep past their timeouts.
+    int WarmTarget(base::TimeTicks now) const;
+
+    // Track what becomes of idle sockets, for IdleTimeoutScale().
+    void OnIdleSocketReused();
+    void OnIdleSocketTimedOut();
+
+    // Returns the factor to scale idle timeouts by: 0.5 if idle sockets always
+    // time out, 1 to start with, and 2 if they are always reused.
+    double IdleTimeoutScale() const;
+
     void CleanupBackupJob() {
       weak_factory_.InvalidateWeakPtrs();
     }
@@ -437,6 +463,11 @@ class NET_EXPORT_PRIVATE ClientSocketPoolBaseHelper
     std::set<ConnectJob*> jobs_;
     RequestQueue pending_requests_;
     int active_socket_count_;  // number of active sockets used by clients
+    int warm_target_;
+    base::TimeTicks warm_target_time_;
+    // A moving average of how many idle sockets were reused, rather than
+    // timed out, from 0 to 1.
+    double reuse_rate_;
     // A factory to pin the backup_job tasks.
     base::WeakPtrFactory<Group> weak_factory_;
   };
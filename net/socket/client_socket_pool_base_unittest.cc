@@ -2962,6 +2962,44 @@ TEST_F(ClientSocketPoolBaseTest, RequestSockets) {
   EXPECT_EQ(2, pool_->IdleSocketCountInGroup("a"));
 }
 
+TEST_F(ClientSocketPoolBaseTest, WarmPoolKeepsPreconnectedSockets) {
+  bool warm_pool_enabled =
+      internal::ClientSocketPoolBaseHelper::set_warm_pool_enabled(true);
+  CreatePoolWithIdleTimeouts(
+      kDefaultMaxSockets, kDefaultMaxSocketsPerGroup,
+      base::TimeDelta(),  // Time out unused sockets immediately.
+      base::TimeDelta::FromDays(1));  // Don't time out used sockets.
+  connect_job_factory_->set_job_type(TestConnectJob::kMockJob);
+
+  pool_->RequestSockets("a", &params_, 2, BoundNetLog());
+  EXPECT_EQ(2, pool_->IdleSocketCountInGroup("a"));
+
+  // An unused socket in a group nobody preconnected to isn't kept warm.
+  ClientSocketHandle handle;
+  TestCompletionCallback callback;
+  EXPECT_EQ(OK, handle.Init("b",
+                            params_,
+                            kDefaultPriority,
+                            callback.callback(),
+                            pool_.get(),
+                            BoundNetLog()));
+  handle.Reset();
+  MessageLoop::current()->RunAllPending();
+  EXPECT_EQ(1, pool_->IdleSocketCountInGroup("b"));
+
+  pool_->CleanupTimedOutIdleSockets();
+  EXPECT_EQ(2, pool_->IdleSocketCountInGroup("a"));
+  EXPECT_FALSE(pool_->HasGroup("b"));
+
+  // Without the policy, the preconnected sockets time out as before.
+  internal::ClientSocketPoolBaseHelper::set_warm_pool_enabled(false);
+  pool_->CleanupTimedOutIdleSockets();
+  EXPECT_FALSE(pool_->HasGroup("a"));
+
+  internal::ClientSocketPoolBaseHelper::set_warm_pool_enabled(
+      warm_pool_enabled);
+}
+
 TEST_F(ClientSocketPoolBaseTest, RequestSocketsWhenAlreadyHaveAConnectJob) {
   CreatePool(kDefaultMaxSockets, kDefaultMaxSocketsPerGroup);
   connect_job_factory_->set_job_type(TestConnectJob::kMockPendingJob);
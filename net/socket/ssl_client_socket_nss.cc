@@ -77,6 +77,7 @@
 #include "base/threading/thread_restrictions.h"
 #include "base/values.h"
 #include "crypto/ec_private_key.h"
+#include "crypto/nss_util.h"
 #include "crypto/rsa_private_key.h"
 #include "crypto/scoped_nss_types.h"
 #include "net/base/address_list.h"
@@ -88,6 +89,7 @@
 #include "net/base/dnssec_chain_verifier.h"
 #include "net/base/transport_security_state.h"
 #include "net/base/io_buffer.h"
+#include "net/base/io_buffer_pool.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_log.h"
 #include "net/base/single_request_cert_verifier.h"
@@ -450,6 +452,7 @@ SSLClientSocketNSS::SSLClientSocketNSS(ClientSocketHandle* transport_socket,
       ssl_session_cache_shard_(context.ssl_session_cache_shard),
       eset_mitm_detected_(false),
       predicted_cert_chain_correct_(false),
+      persisted_session_loaded_(false),
       next_handshake_state_(STATE_NONE),
       nss_fd_(NULL),
       nss_bufs_(NULL),
@@ -590,7 +593,8 @@ int SSLClientSocketNSS::Connect(const CompletionCallback& callback) {
     return rv;
   }
 
-  if (ssl_config_.cached_info_enabled && ssl_host_info_.get()) {
+  if ((ssl_config_.cached_info_enabled ||
+       SSLHostInfo::persistent_sessions_enabled()) && ssl_host_info_.get()) {
     GotoState(STATE_LOAD_SSL_HOST_INFO);
   } else {
     GotoState(STATE_HANDSHAKE);
@@ -650,6 +654,7 @@ void SSLClientSocketNSS::Disconnect() {
   eset_mitm_detected_    = false;
   start_cert_verification_time_ = base::TimeTicks();
   predicted_cert_chain_correct_ = false;
+  persisted_session_loaded_ = false;
   nss_bufs_              = NULL;
   client_certs_.clear();
   client_auth_cert_needed_ = false;
@@ -1364,7 +1369,10 @@ int SSLClientSocketNSS::DoWriteLoop(int result) {
 bool SSLClientSocketNSS::LoadSSLHostInfo() {
   const SSLHostInfo::State& state(ssl_host_info_->state());
 
-  if (state.certs.empty())
+  if (SSLHostInfo::persistent_sessions_enabled())
+    LoadPersistedSession();
+
+  if (!ssl_config_.cached_info_enabled || state.certs.empty())
     return true;
 
   const std::vector<std::string>& certs_in = state.certs;
@@ -1397,6 +1405,26 @@ bool SSLClientSocketNSS::LoadSSLHostInfo() {
   return rv == SECSuccess;
 }
 
+void SSLClientSocketNSS::LoadPersistedSession() {
+  if (!ssl_host_info_->HasUsableSession())
+    return;
+
+#ifdef SSL_SESSION_EXPORT
+  // This needs the SSL_ExportSession/SSL_ImportSession patch to NSS. The
+  // imported session goes into the client session cache under this socket's
+  // peer ID, so NSS offers it exactly as if it had been cached in memory.
+  const std::string& session = ssl_host_info_->state().session;
+  SECStatus rv = SSL_ImportSession(
+      nss_fd_, reinterpret_cast<const unsigned char*>(session.data()),
+      session.size());
+  if (rv == SECSuccess) {
+    persisted_session_loaded_ = true;
+  } else {
+    LogFailedNSSFunction(net_log_, "SSL_ImportSession", "");
+  }
+#endif
+}
+
 int SSLClientSocketNSS::DoLoadSSLHostInfo() {
   EnterFunction("");
   int rv = ssl_host_info_->WaitForDataReady(
@@ -1509,6 +1537,7 @@ int SSLClientSocketNSS::DoHandshake() {
         }
 #endif
 
+        RecordPersistedSessionResult();
         SaveSSLHostInfo();
         // SSL handshake is completed. Let's verify the certificate.
         GotoState(STATE_VERIFY_DNSSEC);
@@ -1890,6 +1919,23 @@ void SSLClientSocketNSS::SaveSSLHostInfo() {
 
   SSLHostInfo::State* state = ssl_host_info_->mutable_state();
 
+#ifdef SSL_SESSION_EXPORT
+  if (SSLHostInfo::persistent_sessions_enabled()) {
+    unsigned int len = 0;
+    PRTime expiry = 0;
+    if (SSL_ExportSession(nss_fd_, NULL, &len, &expiry) == SECSuccess &&
+        len > 0 && len <= SSLHostInfo::kMaxSessionSize) {
+      std::string session(len, '\0');
+      if (SSL_ExportSession(nss_fd_,
+                            reinterpret_cast<unsigned char*>(&session[0]),
+                            &len, &expiry) == SECSuccess) {
+        session.resize(len);
+        ssl_host_info_->SetSession(session, crypto::PRTimeToBaseTime(expiry));
+      }
+    }
+  }
+#endif
+
   state->certs.clear();
   PeerCertificateChain certs(nss_fd_);
   for (unsigned i = 0; i < certs.size(); i++) {
@@ -1904,6 +1950,25 @@ void SSLClientSocketNSS::SaveSSLHostInfo() {
   ssl_host_info_->Persist();
 }
 
+void SSLClientSocketNSS::RecordPersistedSessionResult() {
+  if (!ssl_host_info_.get() || !SSLHostInfo::persistent_sessions_enabled())
+    return;
+
+  SSLHostInfo::PersistentSessionResult result = SSLHostInfo::SESSION_NONE;
+  if (persisted_session_loaded_) {
+    PRBool resumed = PR_FALSE;
+    if (SSL_HandshakeResumedSession(nss_fd_, &resumed) != SECSuccess)
+      return;
+    result = resumed ? SSLHostInfo::SESSION_RESUMED :
+                       SSLHostInfo::SESSION_NOT_RESUMED;
+  } else if (ssl_host_info_->HasUsableSession()) {
+    // We had a session but this NSS can't import it.
+    return;
+  }
+  UMA_HISTOGRAM_ENUMERATION("Net.SSLPersistentSession", result,
+                            SSLHostInfo::SESSION_MAX);
+}
+
 // Do as much network I/O as possible between the buffer and the
 // transport socket. Return true if some I/O performed, false
 // otherwise (error or ERR_IO_PENDING).
@@ -1942,7 +2007,8 @@ int SSLClientSocketNSS::BufferSend(void) {
 
   int rv = 0;
   if (len) {
-    scoped_refptr<IOBuffer> send_buffer(new IOBuffer(len));
+    scoped_refptr<IOBuffer> send_buffer(
+        IOBufferPool::GetDefault()->GetBuffer(len));
     memcpy(send_buffer->data(), buf1, len1);
     memcpy(send_buffer->data() + len1, buf2, len2);
     rv = transport_->socket()->Write(
@@ -1979,7 +2045,7 @@ int SSLClientSocketNSS::BufferRecv(void) {
     // buffer too full to read into, so no I/O possible at moment
     rv = ERR_IO_PENDING;
   } else {
-    recv_buffer_ = new IOBuffer(nb);
+    recv_buffer_ = IOBufferPool::GetDefault()->GetBuffer(nb);
     rv = transport_->socket()->Read(
         recv_buffer_, nb,
         base::Bind(&SSLClientSocketNSS::BufferRecvComplete,
@@ -128,6 +128,8 @@ class SSLClientSocketNSS : public SSLClientSocket {
   int DoWriteLoop(int result);
 
   bool LoadSSLHostInfo();
+  // Offers the session persisted in |ssl_host_info_| to NSS, if any.
+  void LoadPersistedSession();
   int DoLoadSSLHostInfo();
 
   int DoHandshake();
@@ -147,6 +149,8 @@ class SSLClientSocketNSS : public SSLClientSocket {
   int DoPayloadWrite();
   void LogConnectionTypeMetrics() const;
   void SaveSSLHostInfo();
+  // Records whether a session loaded by LoadPersistedSession was resumed.
+  void RecordPersistedSessionResult();
 
   bool DoTransportIO();
   int BufferSend(void);
@@ -276,6 +280,10 @@ class SSLClientSocketNSS : public SSLClientSocket {
   // that we found the prediction to be correct.
   bool predicted_cert_chain_correct_;
 
+  // True iff a session from |ssl_host_info_| was handed to NSS for this
+  // handshake.
+  bool persisted_session_loaded_;
+
   State next_handshake_state_;
 
   // The NSS SSL state machine
@@ -4,6 +4,8 @@
 
 #include "net/socket/ssl_host_info.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/metrics/histogram.h"
 #include "base/pickle.h"
@@ -15,12 +17,25 @@
 
 namespace net {
 
+namespace {
+
+bool g_persistent_sessions_enabled = false;
+
+}  // namespace
+
+// static
+const size_t SSLHostInfo::kMaxSessionSize;
+// static
+const int SSLHostInfo::kMaxSessionLifetimeHours;
+
 SSLHostInfo::State::State() {}
 
 SSLHostInfo::State::~State() {}
 
 void SSLHostInfo::State::Clear() {
   certs.clear();
+  session.clear();
+  session_expiry = base::Time();
 }
 
 SSLHostInfo::SSLHostInfo(
@@ -99,6 +114,20 @@ bool SSLHostInfo::ParseInner(const std::string& data) {
     }
   }
 
+  // The session was added later, so older entries end here.
+  std::string session;
+  int64 session_expiry;
+  if (p.ReadString(&iter, &session) && p.ReadInt64(&iter, &session_expiry)) {
+    if (persistent_sessions_enabled()) {
+      SetSession(session, base::Time::FromInternalValue(session_expiry));
+      if (!session.empty() && !HasUsableSession()) {
+        UMA_HISTOGRAM_ENUMERATION("Net.SSLPersistentSession",
+                                  SESSION_EXPIRED, SESSION_MAX);
+        state->session.clear();
+      }
+    }
+  }
+
   if (!state->certs.empty()) {
     std::vector<base::StringPiece> der_certs(state->certs.size());
     for (size_t i = 0; i < state->certs.size(); i++)
@@ -161,6 +190,19 @@ std::string SSLHostInfo::Serialize() const {
     return "";
   }
 
+  // Sessions that are disabled or expired are written as empty, which also
+  // removes any session persisted before.
+  std::string session;
+  int64 session_expiry = 0;
+  if (persistent_sessions_enabled() && HasUsableSession()) {
+    session = state_.session;
+    session_expiry = state_.session_expiry.ToInternalValue();
+  }
+  if (!p.WriteString(session) ||
+      !p.WriteInt64(session_expiry)) {
+    return "";
+  }
+
   return std::string(reinterpret_cast<const char *>(p.data()), p.size());
 }
 
@@ -179,6 +221,35 @@ int SSLHostInfo::WaitForCertVerification(const CompletionCallback& callback) {
   return ERR_IO_PENDING;
 }
 
+bool SSLHostInfo::HasUsableSession() const {
+  return !state_.session.empty() &&
+         base::Time::Now() < state_.session_expiry;
+}
+
+void SSLHostInfo::SetSession(const std::string& session, base::Time expiry) {
+  if (session.size() > kMaxSessionSize) {
+    state_.session.clear();
+    state_.session_expiry = base::Time();
+    return;
+  }
+  base::Time max_expiry = base::Time::Now() +
+      base::TimeDelta::FromHours(kMaxSessionLifetimeHours);
+  state_.session = session;
+  state_.session_expiry = std::min(expiry, max_expiry);
+}
+
+// static
+bool SSLHostInfo::persistent_sessions_enabled() {
+  return g_persistent_sessions_enabled;
+}
+
+// static
+bool SSLHostInfo::set_persistent_sessions_enabled(bool enabled) {
+  bool old_value = g_persistent_sessions_enabled;
+  g_persistent_sessions_enabled = enabled;
+  return old_value;
+}
+
 void SSLHostInfo::VerifyCallback(int rv) {
   DCHECK(!verification_start_time_.is_null());
   base::TimeTicks now = base::TimeTicks::Now();
@@ -25,11 +25,29 @@ class X509Certificate;
 struct SSLConfig;
 
 // SSLHostInfo is an interface for fetching information about an SSL server.
-// This information may be stored on disk so does not include keys or session
-// information etc. Primarily it's intended for caching the server's
-// certificates.
+// This information may be stored on disk so, by default, does not include
+// keys or session information etc. Primarily it's intended for caching the
+// server's certificates. When persistent sessions are enabled it also keeps
+// one resumable session per origin so that a restart doesn't cost a full
+// handshake.
 class NET_EXPORT_PRIVATE SSLHostInfo {
  public:
+  // The largest session we'll store for an origin. Sessions are typically a
+  // few hundred bytes; anything bigger is most likely a huge ticket.
+  static const size_t kMaxSessionSize = 4 * 1024;
+
+  // Sessions are never kept longer than this, whatever the server says.
+  static const int kMaxSessionLifetimeHours = 24;
+
+  // Outcomes recorded in the Net.SSLPersistentSession histogram.
+  enum PersistentSessionResult {
+    SESSION_NONE,          // Nothing was stored for the origin.
+    SESSION_EXPIRED,       // The stored session had expired.
+    SESSION_RESUMED,       // The stored session was resumed (a hit).
+    SESSION_NOT_RESUMED,   // The server declined the stored session (a miss).
+    SESSION_MAX,
+  };
+
   SSLHostInfo(const std::string& hostname,
               const SSLConfig& ssl_config,
               CertVerifier *certVerifier);
@@ -69,6 +87,12 @@ class NET_EXPORT_PRIVATE SSLHostInfo {
     // returned them and in the same order.
     std::vector<std::string> certs;
 
+    // session is an opaque, serialized TLS session to resume, or empty.
+    // It is only stored when persistent sessions are enabled.
+    std::string session;
+    // session_expiry is when |session| stops being usable.
+    base::Time session_expiry;
+
    private:
     DISALLOW_COPY_AND_ASSIGN(State);
   };
@@ -89,6 +113,19 @@ class NET_EXPORT_PRIVATE SSLHostInfo {
   // that verification.
   int WaitForCertVerification(const CompletionCallback& callback);
 
+  // Returns true if |state().session| holds a session that hasn't expired.
+  bool HasUsableSession() const;
+
+  // Stores |session| as the session to resume next time, expiring at
+  // |expiry| or kMaxSessionLifetimeHours from now, whichever is sooner.
+  // Sessions larger than kMaxSessionSize are dropped.
+  void SetSession(const std::string& session, base::Time expiry);
+
+  // Enables keeping sessions in the persisted data. Off by default since it
+  // writes session secrets to disk. Returns the previous value.
+  static bool persistent_sessions_enabled();
+  static bool set_persistent_sessions_enabled(bool enabled);
+
   base::TimeTicks verification_start_time() const {
     return verification_start_time_;
   }
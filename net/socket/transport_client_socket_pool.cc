@@ -262,14 +262,33 @@ int TransportConnectJob::DoTransportConnectComplete(int result) {
                                    base::TimeDelta::FromMilliseconds(1),
                                    base::TimeDelta::FromMinutes(10),
                                    100);
+        if (fallback_transport_socket_.get()) {
+          UMA_HISTOGRAM_CUSTOM_TIMES(
+              "Net.TCP_Connection_Latency_IPv6_Wins_Race",
+              connect_duration,
+              base::TimeDelta::FromMilliseconds(1),
+              base::TimeDelta::FromMinutes(10),
+              100);
+        }
       }
     }
     set_socket(transport_socket_.release());
     fallback_timer_.Stop();
+  } else if (fallback_transport_socket_.get()) {
+    // The IPv4 connect may still win the race, so wait for it rather than
+    // failing the whole job on the IPv6 path's account.
+    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv6_Loses_Race",
+                               base::TimeTicks::Now() - connect_start_time_,
+                               base::TimeDelta::FromMilliseconds(1),
+                               base::TimeDelta::FromMinutes(10),
+                               100);
+    net_log().AddEventWithNetErrorCode(
+        NetLog::TYPE_TRANSPORT_CONNECT_JOB_RACE_LOST, result);
+    transport_socket_.reset();
+    next_state_ = STATE_TRANSPORT_CONNECT_COMPLETE;
+    return ERR_IO_PENDING;
   } else {
-    // Be a bit paranoid and kill off the fallback members to prevent reuse.
-    fallback_transport_socket_.reset();
-    fallback_addresses_.reset();
+    fallback_timer_.Stop();
   }
 
   return result;
@@ -286,6 +305,7 @@ void TransportConnectJob::DoIPv6FallbackTransportConnect() {
   DCHECK(!fallback_transport_socket_.get());
   DCHECK(!fallback_addresses_.get());
 
+  net_log().AddEvent(NetLog::TYPE_TRANSPORT_CONNECT_JOB_IPV6_FALLBACK, NULL);
   fallback_addresses_.reset(new AddressList(addresses_));
   MakeAddrListStartWithIPv4(fallback_addresses_.get());
   fallback_transport_socket_.reset(
@@ -342,6 +362,12 @@ void TransportConnectJob::DoIPv6FallbackTransportConnectComplete(int result) {
     // Be a bit paranoid and kill off the fallback members to prevent reuse.
     fallback_transport_socket_.reset();
     fallback_addresses_.reset();
+    if (transport_socket_.get()) {
+      // The IPv6 connect is still in progress and may yet succeed.
+      net_log().AddEventWithNetErrorCode(
+          NetLog::TYPE_TRANSPORT_CONNECT_JOB_RACE_LOST, result);
+      return;
+    }
   }
   NotifyDelegateOfCompletion(result);  // Deletes |this|
 }
@@ -54,7 +54,8 @@ class NET_EXPORT_PRIVATE TransportSocketParams
 // user wait 20s for the timeout to fire, we use a fallback timer
 // (kIPv6FallbackTimerInMs) and start a connect() to a IPv4 address if the timer
 // fires. Then we race the IPv4 connect() against the IPv6 connect() (which has
-// a headstart) and return the one that completes first to the socket pool.
+// a headstart) and return the one that completes first to the socket pool. If
+// one of them fails, the job waits for the other rather than failing.
 class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
  public:
   TransportConnectJob(const std::string& group_name,
@@ -26,10 +26,8 @@ SocketStreamJob* SocketStreamJob::CreateSocketStreamJob(
     TransportSecurityState* sts,
     SSLConfigService* ssl) {
   GURL socket_url(url);
-  TransportSecurityState::DomainState domain_state;
-  if (url.scheme() == "ws" && sts && sts->GetDomainState(
-          url.host(), SSLConfigService::IsSNIAvailable(ssl), &domain_state) &&
-      domain_state.ShouldRedirectHTTPToHTTPS()) {
+  if (url.scheme() == "ws" && sts && sts->ShouldUpgradeToSSL(
+          url.host(), SSLConfigService::IsSNIAvailable(ssl))) {
     url_canon::Replacements<char> replacements;
     static const char kNewScheme[] = "wss";
     replacements.SetScheme(kNewScheme,
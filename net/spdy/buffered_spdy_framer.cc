@@ -9,6 +9,14 @@
 namespace {
 
 bool g_enable_compression_default = true;
+bool g_low_memory_compression_default = false;
+
+// Used for header compression in low-memory mode. The window matches what
+// SpdyFramer's compressor uses, so that a peer using SpdyFramer can always
+// be decompressed. In a window this small the deeper match searches of
+// level 9 gain little, so use zlib's default level.
+const int kLowMemoryCompressionLevel = 6;
+const int kLowMemoryWindowSizeInBits = 11;
 
 }  // namespace
 
@@ -22,6 +30,10 @@ BufferedSpdyFramer::BufferedSpdyFramer(int version)
       header_stream_id_(SpdyFramer::kInvalidStream),
       frames_received_(0) {
   spdy_framer_.set_enable_compression(g_enable_compression_default);
+  if (g_low_memory_compression_default) {
+    spdy_framer_.SetHeaderCompressionOptions(kLowMemoryCompressionLevel,
+                                             kLowMemoryWindowSizeInBits);
+  }
   memset(header_buffer_, 0, sizeof(header_buffer_));
 }
 
@@ -262,6 +274,11 @@ void BufferedSpdyFramer::set_enable_compression_default(bool value) {
   g_enable_compression_default = value;
 }
 
+// static
+void BufferedSpdyFramer::set_low_memory_compression_default(bool value) {
+  g_low_memory_compression_default = value;
+}
+
 void BufferedSpdyFramer::InitHeaderStreaming(const SpdyControlFrame* frame) {
   memset(header_buffer_, 0, kHeaderBufferSize);
   header_buffer_used_ = 0;
@@ -144,6 +144,9 @@ class NET_EXPORT_PRIVATE BufferedSpdyFramer
   SpdyControlFrame* CompressControlFrame(const SpdyControlFrame& frame);
   // Specify if newly created SpdySessions should have compression enabled.
   static void set_enable_compression_default(bool value);
+  // Specify if newly created SpdySessions should trade header compression
+  // ratio for memory; see SpdyFramer::SetHeaderCompressionOptions().
+  static void set_low_memory_compression_default(bool value);
 
   int frames_received() const { return frames_received_; }
 
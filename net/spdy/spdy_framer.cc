@@ -15,6 +15,7 @@
 #include "net/spdy/spdy_frame_builder.h"
 #include "net/spdy/spdy_frame_reader.h"
 #include "net/spdy/spdy_bitmasks.h"
+#include "net/spdy/spdy_header_block_builder.h"
 
 #if defined(USE_SYSTEM_ZLIB)
 #include <zlib.h>
@@ -117,6 +118,16 @@ void SettingsFlagsAndId::ConvertFlagsAndIdForSpdy2(uint32* val) {
 SpdyCredential::SpdyCredential() : slot(0) {}
 SpdyCredential::~SpdyCredential() {}
 
+// The following compression setting are based on Brian Olson's analysis. See
+// https://groups.google.com/group/spdy-dev/browse_thread/thread/dfaf498542fac792
+// for more details.
+static const int kCompressorLevel = 9;
+static const int kCompressorWindowSizeInBits = 11;
+static const int kCompressorMemLevel = 1;
+
+// Peers may compress with any window, up to zlib's maximum.
+static const int kDecompressorWindowSizeInBits = 15;
+
 SpdyFramer::SpdyFramer(int version)
     : state_(SPDY_RESET),
       previous_state_(SPDY_RESET),
@@ -127,6 +138,9 @@ SpdyFramer::SpdyFramer(int version)
       current_frame_buffer_(new char[kControlFrameBufferSize]),
       current_frame_len_(0),
       enable_compression_(true),
+      compression_level_(kCompressorLevel),
+      compressor_window_bits_(kCompressorWindowSizeInBits),
+      decompressor_window_bits_(kDecompressorWindowSizeInBits),
       visitor_(NULL),
       display_protocol_("SPDY"),
       spdy_version_(version),
@@ -661,6 +675,18 @@ void SpdyFramer::WriteHeaderBlock(SpdyFrameBuilder* frame,
   }
 }
 
+size_t SpdyFramer::GetSerializedLength(
+    const SpdyHeaderBlockBuilder* headers) const {
+  return headers->size();
+}
+
+void SpdyFramer::WriteHeaderBlock(SpdyFrameBuilder* frame,
+                                  const SpdyHeaderBlockBuilder* headers) const {
+  DCHECK_EQ(spdy_version_, headers->spdy_version());
+  bool wrote_header = frame->WriteBytes(headers->data(), headers->size());
+  DCHECK(wrote_header);
+}
+
 
 size_t SpdyFramer::ProcessControlFrameBeforeHeaderBlock(const char* data,
                                                         size_t len) {
@@ -1028,6 +1054,31 @@ SpdySynStreamControlFrame* SpdyFramer::CreateSynStream(
     SpdyControlFlags flags,
     bool compressed,
     const SpdyHeaderBlock* headers) {
+  return CreateSynStreamImpl(stream_id, associated_stream_id, priority,
+                             credential_slot, flags, compressed, headers);
+}
+
+SpdySynStreamControlFrame* SpdyFramer::CreateSynStream(
+    SpdyStreamId stream_id,
+    SpdyStreamId associated_stream_id,
+    SpdyPriority priority,
+    uint8 credential_slot,
+    SpdyControlFlags flags,
+    bool compressed,
+    const SpdyHeaderBlockBuilder& headers) {
+  return CreateSynStreamImpl(stream_id, associated_stream_id, priority,
+                             credential_slot, flags, compressed, &headers);
+}
+
+template <typename HeaderBlock>
+SpdySynStreamControlFrame* SpdyFramer::CreateSynStreamImpl(
+    SpdyStreamId stream_id,
+    SpdyStreamId associated_stream_id,
+    SpdyPriority priority,
+    uint8 credential_slot,
+    SpdyControlFlags flags,
+    bool compressed,
+    const HeaderBlock* headers) {
   DCHECK_EQ(0u, stream_id & ~kStreamIdMask);
   DCHECK_EQ(0u, associated_stream_id & ~kStreamIdMask);
 
@@ -1063,6 +1114,23 @@ SpdySynReplyControlFrame* SpdyFramer::CreateSynReply(
     SpdyControlFlags flags,
     bool compressed,
     const SpdyHeaderBlock* headers) {
+  return CreateSynReplyImpl(stream_id, flags, compressed, headers);
+}
+
+SpdySynReplyControlFrame* SpdyFramer::CreateSynReply(
+    SpdyStreamId stream_id,
+    SpdyControlFlags flags,
+    bool compressed,
+    const SpdyHeaderBlockBuilder& headers) {
+  return CreateSynReplyImpl(stream_id, flags, compressed, &headers);
+}
+
+template <typename HeaderBlock>
+SpdySynReplyControlFrame* SpdyFramer::CreateSynReplyImpl(
+    SpdyStreamId stream_id,
+    SpdyControlFlags flags,
+    bool compressed,
+    const HeaderBlock* headers) {
   DCHECK_GT(stream_id, 0u);
   DCHECK_EQ(0u, stream_id & ~kStreamIdMask);
 
@@ -1158,6 +1226,23 @@ SpdyHeadersControlFrame* SpdyFramer::CreateHeaders(
     SpdyControlFlags flags,
     bool compressed,
     const SpdyHeaderBlock* headers) {
+  return CreateHeadersImpl(stream_id, flags, compressed, headers);
+}
+
+SpdyHeadersControlFrame* SpdyFramer::CreateHeaders(
+    SpdyStreamId stream_id,
+    SpdyControlFlags flags,
+    bool compressed,
+    const SpdyHeaderBlockBuilder& headers) {
+  return CreateHeadersImpl(stream_id, flags, compressed, &headers);
+}
+
+template <typename HeaderBlock>
+SpdyHeadersControlFrame* SpdyFramer::CreateHeadersImpl(
+    SpdyStreamId stream_id,
+    SpdyControlFlags flags,
+    bool compressed,
+    const HeaderBlock* headers) {
   // Basically the same as CreateSynReply().
   DCHECK_GT(stream_id, 0u);
   DCHECK_EQ(0u, stream_id & ~kStreamIdMask);
@@ -1245,13 +1330,6 @@ SpdyDataFrame* SpdyFramer::CreateDataFrame(SpdyStreamId stream_id,
   return reinterpret_cast<SpdyDataFrame*>(frame.take());
 }
 
-// The following compression setting are based on Brian Olson's analysis. See
-// https://groups.google.com/group/spdy-dev/browse_thread/thread/dfaf498542fac792
-// for more details.
-static const int kCompressorLevel = 9;
-static const int kCompressorWindowSizeInBits = 11;
-static const int kCompressorMemLevel = 1;
-
 z_stream* SpdyFramer::GetHeaderCompressor() {
   if (header_compressor_.get())
     return header_compressor_.get();  // Already initialized.
@@ -1260,9 +1338,9 @@ z_stream* SpdyFramer::GetHeaderCompressor() {
   memset(header_compressor_.get(), 0, sizeof(z_stream));
 
   int success = deflateInit2(header_compressor_.get(),
-                             kCompressorLevel,
+                             compression_level_,
                              Z_DEFLATED,
-                             kCompressorWindowSizeInBits,
+                             compressor_window_bits_,
                              kCompressorMemLevel,
                              Z_DEFAULT_STRATEGY);
   if (success == Z_OK) {
@@ -1289,7 +1367,8 @@ z_stream* SpdyFramer::GetHeaderDecompressor() {
   header_decompressor_.reset(new z_stream);
   memset(header_decompressor_.get(), 0, sizeof(z_stream));
 
-  int success = inflateInit(header_decompressor_.get());
+  int success = inflateInit2(header_decompressor_.get(),
+                             decompressor_window_bits_);
   if (success != Z_OK) {
     LOG(WARNING) << "inflateInit failure: " << success;
     header_decompressor_.reset(NULL);
@@ -1627,4 +1706,15 @@ void SpdyFramer::set_enable_compression(bool value) {
   enable_compression_ = value;
 }
 
+void SpdyFramer::SetHeaderCompressionOptions(int level, int window_bits) {
+  DCHECK(!header_compressor_.get());
+  DCHECK(!header_decompressor_.get());
+  // zlib rejects windows of fewer than 2^9 bytes.
+  DCHECK_GE(window_bits, 9);
+  DCHECK_LE(window_bits, kDecompressorWindowSizeInBits);
+  compression_level_ = level;
+  compressor_window_bits_ = window_bits;
+  decompressor_window_bits_ = window_bits;
+}
+
 }  // namespace net
@@ -37,6 +37,7 @@ class WebSocketJobTest;
 class SpdyFramer;
 class SpdyFrameBuilder;
 class SpdyFramerTest;
+class SpdyHeaderBlockBuilder;
 
 namespace test {
 
@@ -291,6 +292,17 @@ class NET_EXPORT_PRIVATE SpdyFramer {
                                              bool compressed,
                                              const SpdyHeaderBlock* headers);
 
+  // As above, but with a header block serialized by |headers|, which must be
+  // for this framer's SPDY version.
+  SpdySynStreamControlFrame* CreateSynStream(
+      SpdyStreamId stream_id,
+      SpdyStreamId associated_stream_id,
+      SpdyPriority priority,
+      uint8 credential_slot,
+      SpdyControlFlags flags,
+      bool compressed,
+      const SpdyHeaderBlockBuilder& headers);
+
   // Create a SpdySynReplyControlFrame.
   // |stream_id| is the stream for this frame.
   // |flags| is the flags to use with the data.
@@ -301,6 +313,11 @@ class NET_EXPORT_PRIVATE SpdyFramer {
                                            SpdyControlFlags flags,
                                            bool compressed,
                                            const SpdyHeaderBlock* headers);
+  SpdySynReplyControlFrame* CreateSynReply(
+      SpdyStreamId stream_id,
+      SpdyControlFlags flags,
+      bool compressed,
+      const SpdyHeaderBlockBuilder& headers);
 
   SpdyRstStreamControlFrame* CreateRstStream(SpdyStreamId stream_id,
                                              SpdyStatusCodes status) const;
@@ -327,6 +344,11 @@ class NET_EXPORT_PRIVATE SpdyFramer {
                                          SpdyControlFlags flags,
                                          bool compressed,
                                          const SpdyHeaderBlock* headers);
+  SpdyHeadersControlFrame* CreateHeaders(
+      SpdyStreamId stream_id,
+      SpdyControlFlags flags,
+      bool compressed,
+      const SpdyHeaderBlockBuilder& headers);
 
   // Creates an instance of SpdyWindowUpdateControlFrame. The WINDOW_UPDATE
   // frame is used to implement per stream flow control in SPDY.
@@ -402,6 +424,16 @@ class NET_EXPORT_PRIVATE SpdyFramer {
   // For ease of testing and experimentation we can tweak compression on/off.
   void set_enable_compression(bool value);
 
+  // Tunes header compression for memory rather than ratio. |level| is the
+  // zlib level for outgoing headers, and 2^|window_bits| bytes the history
+  // window kept in each direction. By default the compressor keeps 2^11
+  // bytes and the decompressor 2^15, which is enough for any peer. A
+  // decompressor window smaller than the peer's compressor window fails to
+  // decompress, so only pass |window_bits| below 15 for peers known to
+  // compress with a window that small, such as another SpdyFramer. Must be
+  // called before the first header block is compressed or decompressed.
+  void SetHeaderCompressionOptions(int level, int window_bits);
+
   // Used only in log messages.
   void set_display_protocol(const std::string& protocol) {
     display_protocol_ = protocol;
@@ -492,10 +524,35 @@ class NET_EXPORT_PRIVATE SpdyFramer {
 
   // Retrieve serialized length of SpdyHeaderBlock.
   size_t GetSerializedLength(const SpdyHeaderBlock* headers) const;
+  size_t GetSerializedLength(const SpdyHeaderBlockBuilder* headers) const;
 
   // Serializes a SpdyHeaderBlock.
   void WriteHeaderBlock(SpdyFrameBuilder* frame,
                         const SpdyHeaderBlock* headers) const;
+  void WriteHeaderBlock(SpdyFrameBuilder* frame,
+                        const SpdyHeaderBlockBuilder* headers) const;
+
+  // The implementations of the Create*() methods that take a header block,
+  // for either kind of |headers|.
+  template <typename HeaderBlock>
+  SpdySynStreamControlFrame* CreateSynStreamImpl(
+      SpdyStreamId stream_id,
+      SpdyStreamId associated_stream_id,
+      SpdyPriority priority,
+      uint8 credential_slot,
+      SpdyControlFlags flags,
+      bool compressed,
+      const HeaderBlock* headers);
+  template <typename HeaderBlock>
+  SpdySynReplyControlFrame* CreateSynReplyImpl(SpdyStreamId stream_id,
+                                               SpdyControlFlags flags,
+                                               bool compressed,
+                                               const HeaderBlock* headers);
+  template <typename HeaderBlock>
+  SpdyHeadersControlFrame* CreateHeadersImpl(SpdyStreamId stream_id,
+                                             SpdyControlFlags flags,
+                                             bool compressed,
+                                             const HeaderBlock* headers);
 
   // Set the error code and moves the framer into the error state.
   void set_error(SpdyError error);
@@ -540,6 +597,10 @@ class NET_EXPORT_PRIVATE SpdyFramer {
   SpdySettingsScratch settings_scratch_;
 
   bool enable_compression_;  // Controls all compression
+  // See SetHeaderCompressionOptions().
+  int compression_level_;
+  int compressor_window_bits_;
+  int decompressor_window_bits_;
   // SPDY header compressors.
   scoped_ptr<z_stream> header_compressor_;
   scoped_ptr<z_stream> header_decompressor_;
@@ -0,0 +1,66 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/spdy/spdy_header_block_builder.h"
+
+#include "base/logging.h"
+#include "base/sys_byteorder.h"
+
+namespace net {
+
+namespace {
+
+// Enough for a typical request's headers.
+const size_t kInitialCapacity = 512;
+
+}  // namespace
+
+SpdyHeaderBlockBuilder::SpdyHeaderBlockBuilder(int spdy_version)
+    : spdy_version_(spdy_version),
+      num_headers_(0) {
+  buffer_.reserve(kInitialCapacity);
+  Clear();
+}
+
+SpdyHeaderBlockBuilder::~SpdyHeaderBlockBuilder() {}
+
+void SpdyHeaderBlockBuilder::AddHeader(const base::StringPiece& name,
+                                       const base::StringPiece& value) {
+  AppendLength(name.size());
+  buffer_.append(name.data(), name.size());
+  AppendLength(value.size());
+  buffer_.append(value.data(), value.size());
+  ++num_headers_;
+
+  // Rewrite the count at the start of the block.
+  if (spdy_version_ < 3) {
+    DCHECK_LE(num_headers_, kuint16max);
+    uint16 count = base::HostToNet16(static_cast<uint16>(num_headers_));
+    buffer_.replace(0, sizeof(count), reinterpret_cast<char*>(&count),
+                    sizeof(count));
+  } else {
+    uint32 count = base::HostToNet32(static_cast<uint32>(num_headers_));
+    buffer_.replace(0, sizeof(count), reinterpret_cast<char*>(&count),
+                    sizeof(count));
+  }
+}
+
+void SpdyHeaderBlockBuilder::Clear() {
+  buffer_.clear();
+  num_headers_ = 0;
+  AppendLength(0);
+}
+
+void SpdyHeaderBlockBuilder::AppendLength(size_t length) {
+  if (spdy_version_ < 3) {
+    DCHECK_LE(length, kuint16max);
+    uint16 value = base::HostToNet16(static_cast<uint16>(length));
+    buffer_.append(reinterpret_cast<char*>(&value), sizeof(value));
+  } else {
+    uint32 value = base::HostToNet32(static_cast<uint32>(length));
+    buffer_.append(reinterpret_cast<char*>(&value), sizeof(value));
+  }
+}
+
+}  // namespace net
@@ -0,0 +1,57 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_SPDY_SPDY_HEADER_BLOCK_BUILDER_H_
+#define NET_SPDY_SPDY_HEADER_BLOCK_BUILDER_H_
+#pragma once
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/string_piece.h"
+#include "net/base/net_export.h"
+
+namespace net {
+
+// Serializes a SPDY header block as its headers are added, for callers that
+// would otherwise fill a SpdyHeaderBlock only to have SpdyFramer walk it
+// again. The names and values are copied straight into one buffer, and no
+// per-header strings or map nodes are allocated. Clear() keeps the buffer,
+// so a builder that is reused for every frame stops allocating altogether.
+//
+// Unlike a SpdyHeaderBlock, the builder neither sorts nor merges headers:
+// the caller adds each name once, joining multiple values with '\0'.
+class NET_EXPORT_PRIVATE SpdyHeaderBlockBuilder {
+ public:
+  explicit SpdyHeaderBlockBuilder(int spdy_version);
+  ~SpdyHeaderBlockBuilder();
+
+  // Appends the header |name| with |value|.
+  void AddHeader(const base::StringPiece& name,
+                 const base::StringPiece& value);
+
+  // Removes all headers.
+  void Clear();
+
+  int spdy_version() const { return spdy_version_; }
+  size_t num_headers() const { return num_headers_; }
+
+  // The serialized header block, as it appears uncompressed in a frame.
+  const char* data() const { return buffer_.data(); }
+  size_t size() const { return buffer_.size(); }
+
+ private:
+  // Appends |length| in the width the SPDY version uses for lengths.
+  void AppendLength(size_t length);
+
+  const int spdy_version_;
+  std::string buffer_;
+  size_t num_headers_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpdyHeaderBlockBuilder);
+};
+
+}  // namespace net
+
+#endif  // NET_SPDY_SPDY_HEADER_BLOCK_BUILDER_H_
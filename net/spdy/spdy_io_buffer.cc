@@ -15,7 +15,8 @@ SpdyIOBuffer::SpdyIOBuffer(
   : buffer_(new DrainableIOBuffer(buffer, size)),
     priority_(priority),
     position_(++order_),
-    stream_(stream) {}
+    stream_(stream),
+    queue_time_(base::TimeTicks::Now()) {}
 
 SpdyIOBuffer::SpdyIOBuffer() : priority_(HIGHEST), position_(0), stream_(NULL) {
 }
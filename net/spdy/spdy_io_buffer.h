@@ -7,6 +7,7 @@
 #pragma once
 
 #include "base/memory/ref_counted.h"
+#include "base/time.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_export.h"
 #include "net/spdy/spdy_stream.h"
@@ -35,6 +36,8 @@ class NET_EXPORT_PRIVATE SpdyIOBuffer {
   void release();
   RequestPriority priority() const { return priority_; }
   const scoped_refptr<SpdyStream>& stream() const { return stream_; }
+  // When the buffer was created, which is when its frame was queued.
+  base::TimeTicks queue_time() const { return queue_time_; }
 
   // Comparison operator to support sorting.
   bool operator<(const SpdyIOBuffer& other) const {
@@ -48,6 +51,7 @@ class NET_EXPORT_PRIVATE SpdyIOBuffer {
   RequestPriority priority_;
   uint64 position_;
   scoped_refptr<SpdyStream> stream_;
+  base::TimeTicks queue_time_;
   static uint64 order_;  // Maintains a FIFO order for equal priorities.
 };
 
@@ -25,6 +25,7 @@
 #include "crypto/signature_creator.h"
 #include "net/base/asn1_util.h"
 #include "net/base/connection_type_histograms.h"
+#include "net/base/io_buffer_pool.h"
 #include "net/base/net_log.h"
 #include "net/base/net_util.h"
 #include "net/base/server_bound_cert_service.h"
@@ -224,6 +225,31 @@ class NetLogSpdyDataParameter : public NetLog::EventParameters {
   DISALLOW_COPY_AND_ASSIGN(NetLogSpdyDataParameter);
 };
 
+class NetLogSpdyWriteParameter : public NetLog::EventParameters {
+ public:
+  NetLogSpdyWriteParameter(SpdyStreamId stream_id,
+                           int size,
+                           base::TimeDelta latency)
+      : stream_id_(stream_id), size_(size), latency_(latency) {}
+
+  virtual Value* ToValue() const {
+    DictionaryValue* dict = new DictionaryValue();
+    dict->SetInteger("stream_id", static_cast<int>(stream_id_));
+    dict->SetInteger("size", size_);
+    dict->SetInteger("latency_ms",
+                     static_cast<int>(latency_.InMilliseconds()));
+    return dict;
+  }
+
+ private:
+  ~NetLogSpdyWriteParameter() {}
+  const SpdyStreamId stream_id_;
+  const int size_;
+  const base::TimeDelta latency_;
+
+  DISALLOW_COPY_AND_ASSIGN(NetLogSpdyWriteParameter);
+};
+
 class NetLogSpdyRstParameter : public NetLog::EventParameters {
  public:
   NetLogSpdyRstParameter(SpdyStreamId stream_id,
@@ -302,6 +328,7 @@ NextProto g_default_protocol = kProtoUnknown;
 size_t g_init_max_concurrent_streams = 10;
 size_t g_max_concurrent_stream_limit = 256;
 bool g_enable_ping_based_connection_checking = true;
+int g_max_data_frame_size = kMaxSpdyFrameChunkSize;
 
 }  // namespace
 
@@ -326,6 +353,12 @@ void SpdySession::set_init_max_concurrent_streams(size_t value) {
       std::min(value, g_max_concurrent_stream_limit);
 }
 
+// static
+void SpdySession::set_max_data_frame_size(int value) {
+  DCHECK_GT(value, 0);
+  g_max_data_frame_size = std::min(value, kMaxSpdyFrameChunkSize);
+}
+
 // static
 void SpdySession::ResetStaticSettingsToInit() {
   // WARNING: These must match the initializers above.
@@ -333,6 +366,7 @@ void SpdySession::ResetStaticSettingsToInit() {
   g_init_max_concurrent_streams = 10;
   g_max_concurrent_stream_limit = 256;
   g_enable_ping_based_connection_checking = true;
+  g_max_data_frame_size = kMaxSpdyFrameChunkSize;
 }
 
 SpdySession::SpdySession(const HostPortProxyPair& host_port_proxy_pair,
@@ -349,6 +383,7 @@ SpdySession::SpdySession(const HostPortProxyPair& host_port_proxy_pair,
       read_buffer_(new IOBuffer(kReadBufferSize)),
       read_pending_(false),
       stream_hi_water_mark_(1),  // Always start at 1 for the first stream id.
+      queue_(SpdyDataFrame::size() + g_max_data_frame_size),
       write_pending_(false),
       delayed_write_pending_(false),
       is_secure_(false),
@@ -756,8 +791,8 @@ int SpdySession::WriteStreamData(SpdyStreamId stream_id,
   scoped_refptr<SpdyStream> stream = active_streams_[stream_id];
   CHECK_EQ(stream->stream_id(), stream_id);
 
-  if (len > kMaxSpdyFrameChunkSize) {
-    len = kMaxSpdyFrameChunkSize;
+  if (len > g_max_data_frame_size) {
+    len = g_max_data_frame_size;
     flags = static_cast<SpdyDataFlags>(flags & ~DATA_FLAG_FIN);
   }
 
@@ -934,6 +969,15 @@ void SpdySession::OnWriteComplete(int result) {
           result -= static_cast<int>(SpdyFrame::kHeaderSize);
         }
 
+        if (net_log().IsLoggingAllEvents()) {
+          net_log().AddEvent(
+              NetLog::TYPE_SPDY_SESSION_WRITE_COMPLETE,
+              make_scoped_refptr(new NetLogSpdyWriteParameter(
+                  stream->stream_id(),
+                  in_flight_write_.buffer()->size(),
+                  base::TimeTicks::Now() - in_flight_write_queue_time_)));
+        }
+
         // It is possible that the stream was cancelled while we were writing
         // to the socket.
         if (!stream->cancelled())
@@ -1028,8 +1072,8 @@ void SpdySession::WriteSocket() {
   while (in_flight_write_.buffer() || !queue_.empty()) {
     if (!in_flight_write_.buffer()) {
       // Grab the next SpdyFrame to send.
-      SpdyIOBuffer next_buffer = queue_.top();
-      queue_.pop();
+      SpdyIOBuffer next_buffer = queue_.Pop();
+      in_flight_write_queue_time_ = next_buffer.queue_time();
 
       // We've deferred compression until just before we write it to the socket,
       // which is now.  At this time, we don't compress our data frames.
@@ -1053,7 +1097,8 @@ void SpdySession::WriteSocket() {
         DCHECK_GT(size, 0u);
 
         // TODO(mbelshe): We have too much copying of data here.
-        IOBufferWithSize* buffer = new IOBufferWithSize(size);
+        IOBufferWithSize* buffer =
+            IOBufferPool::GetDefault()->GetBuffer(size);
         memcpy(buffer->data(), compressed_frame->data(), size);
 
         // Attempt to send the frame.
@@ -1117,8 +1162,7 @@ void SpdySession::CloseAllStreams(net::Error status) {
   }
 
   // We also need to drain the queue.
-  while (queue_.size())
-    queue_.pop();
+  queue_.Clear();
 }
 
 int SpdySession::GetNewStreamId() {
@@ -1133,9 +1177,9 @@ void SpdySession::QueueFrame(SpdyFrame* frame,
                              RequestPriority priority,
                              SpdyStream* stream) {
   int length = SpdyFrame::kHeaderSize + frame->length();
-  IOBuffer* buffer = new IOBuffer(length);
+  IOBuffer* buffer = IOBufferPool::GetDefault()->GetBuffer(length);
   memcpy(buffer->data(), frame->data(), length);
-  queue_.push(SpdyIOBuffer(buffer, length, priority, stream));
+  queue_.Push(SpdyIOBuffer(buffer, length, priority, stream));
 
   WriteSocketLater();
 }
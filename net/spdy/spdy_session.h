@@ -31,6 +31,7 @@
 #include "net/spdy/spdy_io_buffer.h"
 #include "net/spdy/spdy_protocol.h"
 #include "net/spdy/spdy_session_pool.h"
+#include "net/spdy/spdy_write_scheduler.h"
 
 namespace base {
 class Value;
@@ -232,6 +233,11 @@ class NET_EXPORT SpdySession : public base::RefCounted<SpdySession>,
   // server via SETTINGS.
   static void set_init_max_concurrent_streams(size_t value);
 
+  // The largest payload of the data frames a stream's writes are split into,
+  // at most kMaxSpdyFrameChunkSize. Smaller frames let the other streams in
+  // a priority band take their turns sooner.
+  static void set_max_data_frame_size(int value);
+
   // Send WINDOW_UPDATE frame, called by a stream whenever receive window
   // size is increased.
   void SendWindowUpdate(SpdyStreamId stream_id, int32 delta_window_size);
@@ -354,7 +360,6 @@ class NET_EXPORT SpdySession : public base::RefCounted<SpdySession>,
   typedef std::map<int, scoped_refptr<SpdyStream> > ActiveStreamMap;
   // Only HTTP push a stream.
   typedef std::map<std::string, scoped_refptr<SpdyStream> > PushedStreamMap;
-  typedef std::priority_queue<SpdyIOBuffer> OutputQueue;
 
   struct CallbackResultPair {
     CallbackResultPair(const CompletionCallback& callback_in, int result_in)
@@ -574,11 +579,13 @@ class NET_EXPORT SpdySession : public base::RefCounted<SpdySession>,
   PushedStreamMap unclaimed_pushed_streams_;
 
   // As we gather data to be sent, we put it into the output queue.
-  OutputQueue queue_;
+  SpdyWriteScheduler queue_;
 
   // The packet we are currently sending.
   bool write_pending_;            // Will be true when a write is in progress.
   SpdyIOBuffer in_flight_write_;  // This is the write buffer in progress.
+  // When |in_flight_write_| was queued.
+  base::TimeTicks in_flight_write_queue_time_;
 
   // Flag if we have a pending message scheduled for WriteSocket.
   bool delayed_write_pending_;
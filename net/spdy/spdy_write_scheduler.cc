@@ -0,0 +1,96 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/spdy/spdy_write_scheduler.h"
+
+#include "base/logging.h"
+
+namespace net {
+
+SpdyWriteScheduler::StreamQueue::StreamQueue() : deficit(0) {}
+
+SpdyWriteScheduler::StreamQueue::~StreamQueue() {}
+
+SpdyWriteScheduler::SpdyWriteScheduler(size_t quantum)
+    : quantum_(quantum),
+      size_(0) {
+  DCHECK_GT(quantum, 0u);
+}
+
+SpdyWriteScheduler::~SpdyWriteScheduler() {}
+
+void SpdyWriteScheduler::Push(const SpdyIOBuffer& buffer) {
+  ++size_;
+  SpdyFrame frame(buffer.buffer()->data(), false);
+  if (frame.is_control_frame()) {
+    control_frames_.push(buffer);
+    return;
+  }
+
+  SpdyStreamId stream_id =
+      reinterpret_cast<const SpdyDataFrame&>(frame).stream_id();
+  StreamQueueMap::iterator it = streams_.find(stream_id);
+  if (it == streams_.end()) {
+    it = streams_.insert(std::make_pair(stream_id, StreamQueue())).first;
+    bands_[buffer.priority()].push_back(stream_id);
+  }
+  it->second.frames.push_back(buffer);
+}
+
+SpdyIOBuffer SpdyWriteScheduler::Pop() {
+  DCHECK(!empty());
+  --size_;
+  if (!control_frames_.empty()) {
+    SpdyIOBuffer buffer = control_frames_.top();
+    control_frames_.pop();
+    return buffer;
+  }
+
+  for (int i = NUM_PRIORITIES - 1; i >= MINIMUM_PRIORITY; --i) {
+    if (!bands_[i].empty())
+      return PopFromBand(static_cast<RequestPriority>(i));
+  }
+  NOTREACHED();
+  return SpdyIOBuffer();
+}
+
+void SpdyWriteScheduler::Clear() {
+  while (!control_frames_.empty())
+    control_frames_.pop();
+  streams_.clear();
+  for (int i = 0; i < NUM_PRIORITIES; ++i)
+    bands_[i].clear();
+  size_ = 0;
+}
+
+SpdyIOBuffer SpdyWriteScheduler::PopFromBand(RequestPriority priority) {
+  std::deque<SpdyStreamId>& band = bands_[priority];
+  while (true) {
+    DCHECK(!band.empty());
+    StreamQueueMap::iterator it = streams_.find(band.front());
+    DCHECK(it != streams_.end());
+    StreamQueue& queue = it->second;
+    DCHECK(!queue.frames.empty());
+
+    if (queue.deficit < queue.frames.front().size()) {
+      // Out of credit: top it up, and let the next stream have its turn.
+      queue.deficit += quantum_;
+      band.push_back(band.front());
+      band.pop_front();
+      continue;
+    }
+
+    SpdyIOBuffer buffer = queue.frames.front();
+    queue.frames.pop_front();
+    queue.deficit -= buffer.size();
+    if (queue.frames.empty()) {
+      // A stream keeps no credit while it has nothing to send.
+      streams_.erase(it);
+      band.pop_front();
+    }
+    return buffer;
+  }
+}
+
+}  // namespace net
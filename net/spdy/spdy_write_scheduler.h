@@ -0,0 +1,79 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_SPDY_SPDY_WRITE_SCHEDULER_H_
+#define NET_SPDY_SPDY_WRITE_SCHEDULER_H_
+#pragma once
+
+#include <deque>
+#include <map>
+#include <queue>
+
+#include "base/basictypes.h"
+#include "net/base/net_export.h"
+#include "net/base/request_priority.h"
+#include "net/spdy/spdy_io_buffer.h"
+#include "net/spdy/spdy_protocol.h"
+
+namespace net {
+
+// Decides the order in which a SpdySession writes its queued frames.
+//
+// Control frames always go first, highest priority first and in FIFO order
+// within a priority, so SETTINGS, PING and new SYN_STREAMs never wait behind
+// data. Data frames are served strictly by priority band. Within a band,
+// streams take turns by deficit round robin: each turn credits a stream
+// with |quantum| bytes, so streams share the band by bytes written rather
+// than by frames, however their frames are sized. A stream's own frames
+// stay in order.
+class NET_EXPORT_PRIVATE SpdyWriteScheduler {
+ public:
+  // |quantum| should be at least the size of the largest data frame.
+  explicit SpdyWriteScheduler(size_t quantum);
+  ~SpdyWriteScheduler();
+
+  // Queues |buffer|, which must hold exactly one, not yet written, frame.
+  void Push(const SpdyIOBuffer& buffer);
+
+  // Removes and returns the frame to write next. Must not be empty().
+  SpdyIOBuffer Pop();
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+
+  // Drops every queued frame.
+  void Clear();
+
+ private:
+  // The data frames of one stream, and its credit in the current round.
+  struct StreamQueue {
+    StreamQueue();
+    ~StreamQueue();
+
+    std::deque<SpdyIOBuffer> frames;
+    size_t deficit;
+  };
+  typedef std::map<SpdyStreamId, StreamQueue> StreamQueueMap;
+
+  // Returns the next data frame of the band for |priority|.
+  SpdyIOBuffer PopFromBand(RequestPriority priority);
+
+  const size_t quantum_;
+
+  std::priority_queue<SpdyIOBuffer> control_frames_;
+
+  // The streams with queued data, and for each band the order in which
+  // they take turns. The stream at the front of a band is the one whose
+  // turn it is.
+  StreamQueueMap streams_;
+  std::deque<SpdyStreamId> bands_[NUM_PRIORITIES];
+
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(SpdyWriteScheduler);
+};
+
+}  // namespace net
+
+#endif  // NET_SPDY_SPDY_WRITE_SCHEDULER_H_
@@ -0,0 +1,153 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/spdy/spdy_write_scheduler.h"
+
+#include <string.h>
+
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "net/base/io_buffer.h"
+#include "net/spdy/spdy_framer.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const size_t kQuantum = 100;
+
+SpdyIOBuffer MakeBuffer(const SpdyFrame& frame, RequestPriority priority) {
+  int size = frame.length() + SpdyFrame::kHeaderSize;
+  scoped_refptr<IOBuffer> buffer(new IOBuffer(size));
+  memcpy(buffer->data(), frame.data(), size);
+  return SpdyIOBuffer(buffer, size, priority, NULL);
+}
+
+// A data frame on |stream_id| whose payload is |length| bytes.
+SpdyIOBuffer DataBuffer(SpdyStreamId stream_id, size_t length,
+                        RequestPriority priority) {
+  SpdyFramer framer(2);
+  std::string data(length, 'x');
+  scoped_ptr<SpdyFrame> frame(
+      framer.CreateDataFrame(stream_id, data.data(), length, DATA_FLAG_NONE));
+  return MakeBuffer(*frame, priority);
+}
+
+SpdyIOBuffer PingBuffer(uint32 id, RequestPriority priority) {
+  SpdyFramer framer(2);
+  scoped_ptr<SpdyFrame> frame(framer.CreatePingFrame(id));
+  return MakeBuffer(*frame, priority);
+}
+
+bool IsControl(const SpdyIOBuffer& buffer) {
+  return SpdyFrame(buffer.buffer()->data(), false).is_control_frame();
+}
+
+SpdyStreamId StreamIdOf(const SpdyIOBuffer& buffer) {
+  SpdyDataFrame frame(buffer.buffer()->data(), false);
+  return frame.stream_id();
+}
+
+}  // namespace
+
+TEST(SpdyWriteSchedulerTest, ControlFramesFirst) {
+  SpdyWriteScheduler scheduler(kQuantum);
+  EXPECT_TRUE(scheduler.empty());
+  scheduler.Push(DataBuffer(1, 10, HIGHEST));
+  scheduler.Push(PingBuffer(1, LOWEST));
+  scheduler.Push(PingBuffer(2, HIGHEST));
+  EXPECT_EQ(3u, scheduler.size());
+
+  SpdyIOBuffer buffer = scheduler.Pop();
+  ASSERT_TRUE(IsControl(buffer));
+  EXPECT_EQ(HIGHEST, buffer.priority());
+  buffer = scheduler.Pop();
+  ASSERT_TRUE(IsControl(buffer));
+  EXPECT_EQ(LOWEST, buffer.priority());
+  buffer = scheduler.Pop();
+  EXPECT_FALSE(IsControl(buffer));
+  EXPECT_TRUE(scheduler.empty());
+}
+
+TEST(SpdyWriteSchedulerTest, HigherPriorityBandFirst) {
+  SpdyWriteScheduler scheduler(kQuantum);
+  scheduler.Push(DataBuffer(1, 10, LOW));
+  scheduler.Push(DataBuffer(3, 10, MEDIUM));
+  scheduler.Push(DataBuffer(5, 10, HIGHEST));
+
+  EXPECT_EQ(5u, StreamIdOf(scheduler.Pop()));
+  EXPECT_EQ(3u, StreamIdOf(scheduler.Pop()));
+  EXPECT_EQ(1u, StreamIdOf(scheduler.Pop()));
+}
+
+// Streams in a band take turns, and each stream's frames stay in order.
+TEST(SpdyWriteSchedulerTest, RoundRobinWithinBand) {
+  SpdyWriteScheduler scheduler(kQuantum);
+  for (int i = 0; i < 3; ++i) {
+    scheduler.Push(DataBuffer(1, 90 - i, MEDIUM));
+    scheduler.Push(DataBuffer(3, 90 - i, MEDIUM));
+  }
+
+  for (int i = 0; i < 3; ++i) {
+    SpdyIOBuffer buffer = scheduler.Pop();
+    EXPECT_EQ(1u, StreamIdOf(buffer));
+    EXPECT_EQ(90u - i + SpdyFrame::kHeaderSize, buffer.size());
+    buffer = scheduler.Pop();
+    EXPECT_EQ(3u, StreamIdOf(buffer));
+    EXPECT_EQ(90u - i + SpdyFrame::kHeaderSize, buffer.size());
+  }
+  EXPECT_TRUE(scheduler.empty());
+}
+
+// A stream writing small frames gets as many bytes through as one writing
+// large frames, not just as many frames.
+TEST(SpdyWriteSchedulerTest, FairByBytes) {
+  SpdyWriteScheduler scheduler(kQuantum);
+  const size_t kSmall = 25 - SpdyFrame::kHeaderSize;
+  const size_t kLarge = 100 - SpdyFrame::kHeaderSize;
+  for (int i = 0; i < 8; ++i)
+    scheduler.Push(DataBuffer(1, kSmall, MEDIUM));
+  for (int i = 0; i < 2; ++i)
+    scheduler.Push(DataBuffer(3, kLarge, MEDIUM));
+
+  // Each turn, stream 1 writes four small frames and stream 3 one large.
+  SpdyStreamId expected[] = { 1, 1, 1, 1, 3, 1, 1, 1, 1, 3 };
+  for (size_t i = 0; i < arraysize(expected); ++i)
+    EXPECT_EQ(expected[i], StreamIdOf(scheduler.Pop())) << i;
+  EXPECT_TRUE(scheduler.empty());
+}
+
+// A stream that joins a band goes to the back of the line.
+TEST(SpdyWriteSchedulerTest, NewStreamWaitsItsTurn) {
+  SpdyWriteScheduler scheduler(kQuantum);
+  scheduler.Push(DataBuffer(1, 50, MEDIUM));
+  scheduler.Push(DataBuffer(1, 50, MEDIUM));
+  scheduler.Push(DataBuffer(3, 50, MEDIUM));
+  EXPECT_EQ(1u, StreamIdOf(scheduler.Pop()));
+  EXPECT_EQ(3u, StreamIdOf(scheduler.Pop()));
+  scheduler.Push(DataBuffer(5, 50, MEDIUM));
+  scheduler.Push(DataBuffer(3, 50, MEDIUM));
+  EXPECT_EQ(1u, StreamIdOf(scheduler.Pop()));
+  EXPECT_EQ(5u, StreamIdOf(scheduler.Pop()));
+  EXPECT_EQ(3u, StreamIdOf(scheduler.Pop()));
+  EXPECT_TRUE(scheduler.empty());
+}
+
+TEST(SpdyWriteSchedulerTest, Clear) {
+  SpdyWriteScheduler scheduler(kQuantum);
+  scheduler.Push(PingBuffer(1, HIGHEST));
+  scheduler.Push(DataBuffer(1, 10, LOW));
+  scheduler.Push(DataBuffer(3, 10, LOW));
+  scheduler.Clear();
+  EXPECT_TRUE(scheduler.empty());
+  EXPECT_EQ(0u, scheduler.size());
+
+  scheduler.Push(DataBuffer(5, 10, LOW));
+  EXPECT_EQ(5u, StreamIdOf(scheduler.Pop()));
+  EXPECT_TRUE(scheduler.empty());
+}
+
+}  // namespace net
@@ -61,6 +61,7 @@ class URLRequestHttpJob::HttpFilterContext : public FilterContext {
   virtual bool IsDownload() const;
   virtual bool IsSdchResponse() const;
   virtual int64 GetByteReadCount() const;
+  virtual int64 GetContentLength() const;
   virtual int GetResponseCode() const;
   virtual void RecordPacketStats(StatisticSelector statistic) const;
 
@@ -119,6 +120,13 @@ int64 URLRequestHttpJob::HttpFilterContext::GetByteReadCount() const {
   return job_->filter_input_byte_count();
 }
 
+int64 URLRequestHttpJob::HttpFilterContext::GetContentLength() const {
+  if (!job_->transaction_.get() || !job_->transaction_->GetResponseInfo())
+    return -1;
+  HttpResponseHeaders* headers = job_->GetResponseHeaders();
+  return headers ? headers->GetContentLength() : -1;
+}
+
 int URLRequestHttpJob::HttpFilterContext::GetResponseCode() const {
   return job_->GetResponseCode();
 }
@@ -140,15 +148,12 @@ URLRequestJob* URLRequestHttpJob::Factory(URLRequest* request,
     return new URLRequestErrorJob(request, ERR_INVALID_ARGUMENT);
   }
 
-  TransportSecurityState::DomainState domain_state;
   if (scheme == "http" &&
       request->context()->transport_security_state() &&
-      request->context()->transport_security_state()->GetDomainState(
+      request->context()->transport_security_state()->ShouldUpgradeToSSL(
           request->url().host(),
           SSLConfigService::IsSNIAvailable(
-              request->context()->ssl_config_service()),
-          &domain_state) &&
-      domain_state.ShouldRedirectHTTPToHTTPS()) {
+              request->context()->ssl_config_service()))) {
     DCHECK_EQ(request->url().scheme(), "http");
     url_canon::Replacements<char> replacements;
     static const char kNewScheme[] = "https";
@@ -400,14 +405,16 @@ void URLRequestHttpJob::AddExtraHeaders() {
     // easier to filter and analyze the streams to assure that a proxy has not
     // damaged these headers.  Some proxies deliberately corrupt Accept-Encoding
     // headers.
+    std::string accept_encoding("gzip,deflate");
+    Filter::AppendRegisteredEncodings(&accept_encoding);
     if (!advertise_sdch) {
       // Tell the server what compression formats we support (other than SDCH).
       request_info_.extra_headers.SetHeader(
-          HttpRequestHeaders::kAcceptEncoding, "gzip,deflate");
+          HttpRequestHeaders::kAcceptEncoding, accept_encoding);
     } else {
       // Include SDCH in acceptable list.
       request_info_.extra_headers.SetHeader(
-          HttpRequestHeaders::kAcceptEncoding, "gzip,deflate,sdch");
+          HttpRequestHeaders::kAcceptEncoding, accept_encoding + ",sdch");
       if (!avail_dictionaries.empty()) {
         request_info_.extra_headers.SetHeader(
             kAvailDictionaryHeader,
@@ -0,0 +1,233 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/url_request/url_request.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/compiler_specific.h"
+#include "base/file_path.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop.h"
+#include "base/perftimer.h"
+#include "base/stringprintf.h"
+#include "base/time.h"
+#include "net/base/io_buffer.h"
+#include "net/test/test_server.h"
+#include "net/url_request/url_request_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// The number of requests of a page load that start at once. Several times
+// the number of sockets allowed per host, so that some wait in the pool.
+const int kNumRequests = 30;
+
+// The size of the buffer given to URLRequest::Read(), as ResourceDispatcher
+// uses.
+const int kReadSize = 32 * 1024;
+
+// Logs the median and 90th percentile of |times| as |name|.
+void LogPercentiles(const std::string& name,
+                    std::vector<base::TimeDelta>* times) {
+  ASSERT_FALSE(times->empty());
+  std::sort(times->begin(), times->end());
+  LogPerfResult((name + "_p50").c_str(),
+                (*times)[times->size() / 2].InMillisecondsF(), "ms");
+  LogPerfResult((name + "_p90").c_str(),
+                (*times)[times->size() * 9 / 10].InMillisecondsF(), "ms");
+}
+
+// The requests of one page load, which all start together. Stops the loop
+// once the last of them is done.
+class PageLoad {
+ public:
+  PageLoad() : remaining_(0), bytes_read_(0) {}
+
+  void Start(const std::vector<GURL>& urls, URLRequestContext* context);
+
+  // Logs how long the requests took to get their headers and to finish,
+  // and how fast the page was read as a whole.
+  void LogResults(const std::string& name);
+
+  int64 bytes_read() const { return bytes_read_; }
+
+ private:
+  class Loader;
+
+  void OnLoaderDone(Loader* loader);
+
+  ScopedVector<Loader> loaders_;
+  base::TimeTicks start_time_;
+  base::TimeDelta elapsed_;
+  int remaining_;
+  int64 bytes_read_;
+  std::vector<base::TimeDelta> response_started_times_;
+  std::vector<base::TimeDelta> completed_times_;
+
+  DISALLOW_COPY_AND_ASSIGN(PageLoad);
+};
+
+// Reads one request of a PageLoad to the end.
+class PageLoad::Loader : public URLRequest::Delegate {
+ public:
+  Loader(PageLoad* page, const GURL& url, URLRequestContext* context)
+      : page_(page),
+        ALLOW_THIS_IN_INITIALIZER_LIST(request_(url, this)),
+        buf_(new IOBuffer(kReadSize)),
+        bytes_read_(0) {
+    request_.set_context(context);
+  }
+
+  void Start() { request_.Start(); }
+
+  const URLRequest& request() const { return request_; }
+  int bytes_read() const { return bytes_read_; }
+  base::TimeTicks response_started_time() const {
+    return response_started_time_;
+  }
+
+  // URLRequest::Delegate implementation.
+  virtual void OnResponseStarted(URLRequest* request) OVERRIDE {
+    response_started_time_ = base::TimeTicks::Now();
+    if (request->status().is_success())
+      ReadMore();
+    else
+      page_->OnLoaderDone(this);
+  }
+
+  virtual void OnReadCompleted(URLRequest* request, int bytes_read) OVERRIDE {
+    if (DidRead(bytes_read))
+      ReadMore();
+  }
+
+ private:
+  void ReadMore() {
+    int bytes_read = 0;
+    while (request_.Read(buf_, kReadSize, &bytes_read)) {
+      if (!DidRead(bytes_read))
+        return;
+    }
+    if (!request_.status().is_io_pending())
+      page_->OnLoaderDone(this);
+  }
+
+  // Returns true if there is more to read.
+  bool DidRead(int bytes_read) {
+    if (bytes_read > 0 && request_.status().is_success()) {
+      bytes_read_ += bytes_read;
+      return true;
+    }
+    page_->OnLoaderDone(this);
+    return false;
+  }
+
+  PageLoad* page_;
+  URLRequest request_;
+  scoped_refptr<IOBuffer> buf_;
+  int bytes_read_;
+  base::TimeTicks response_started_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(Loader);
+};
+
+void PageLoad::Start(const std::vector<GURL>& urls,
+                     URLRequestContext* context) {
+  loaders_.reset();
+  response_started_times_.clear();
+  completed_times_.clear();
+  bytes_read_ = 0;
+  remaining_ = static_cast<int>(urls.size());
+  start_time_ = base::TimeTicks::Now();
+  for (size_t i = 0; i < urls.size(); ++i)
+    loaders_.push_back(new Loader(this, urls[i], context));
+  for (size_t i = 0; i < loaders_.size(); ++i)
+    loaders_[i]->Start();
+}
+
+void PageLoad::LogResults(const std::string& name) {
+  LogPerfResult((name + "_total").c_str(), elapsed_.InMillisecondsF(), "ms");
+  LogPercentiles(name + "_response_started", &response_started_times_);
+  LogPercentiles(name + "_completed", &completed_times_);
+  LogPerfResult((name + "_throughput").c_str(),
+                bytes_read_ / 1024.0 / elapsed_.InSecondsF(), "KB/s");
+}
+
+void PageLoad::OnLoaderDone(Loader* loader) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  EXPECT_TRUE(loader->request().status().is_success());
+  response_started_times_.push_back(
+      loader->response_started_time() - start_time_);
+  completed_times_.push_back(now - start_time_);
+  bytes_read_ += loader->bytes_read();
+  if (--remaining_ == 0) {
+    elapsed_ = now - start_time_;
+    MessageLoop::current()->Quit();
+  }
+}
+
+class URLRequestPerfTest : public testing::Test {
+ protected:
+  URLRequestPerfTest()
+      : message_loop_(MessageLoop::TYPE_IO),
+        test_server_(TestServer::TYPE_HTTP,
+                     TestServer::kLocalhost,
+                     FilePath()) {
+  }
+
+  virtual void SetUp() {
+    ASSERT_TRUE(test_server_.Start());
+  }
+
+  // Returns kNumRequests distinct URLs for |path|, to which a query is added.
+  std::vector<GURL> GetURLs(const std::string& path) const {
+    std::vector<GURL> urls;
+    for (int i = 0; i < kNumRequests; ++i)
+      urls.push_back(test_server_.GetURL(base::StringPrintf("%s%d",
+                                                            path.c_str(),
+                                                            i)));
+    return urls;
+  }
+
+  MessageLoop message_loop_;
+  TestServer test_server_;
+};
+
+}  // namespace
+
+// Measures a page load whose requests all go through the HttpCache to the
+// network, contending for the sockets of one host. The python test server
+// handles one connection at a time, so this mostly measures the overhead
+// of URLRequest, HttpCache, HttpNetworkTransaction and the socket pools
+// rather than any network.
+TEST_F(URLRequestPerfTest, ConcurrentNetworkLoads) {
+  TestURLRequestContext context;
+  PageLoad page;
+  page.Start(GetURLs("chunked?chunkSize=4096&chunksNumber=16&request="),
+             &context);
+  MessageLoop::current()->Run();
+  EXPECT_EQ(kNumRequests * 16 * 4096, page.bytes_read());
+  page.LogResults("URLRequest_network");
+}
+
+// Measures loading the same page again, once all of its requests are in
+// the cache.
+TEST_F(URLRequestPerfTest, ConcurrentCachedLoads) {
+  TestURLRequestContext context;
+  std::vector<GURL> urls = GetURLs("cachetime?request=");
+  PageLoad page;
+  page.Start(urls, &context);
+  MessageLoop::current()->Run();
+
+  page.Start(urls, &context);
+  MessageLoop::current()->Run();
+  page.LogResults("URLRequest_cached");
+}
+
+}  // namespace net
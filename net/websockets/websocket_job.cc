@@ -649,8 +649,33 @@ void WebSocketJob::SendPending() {
     return;
   }
 
+  // Send the queued buffers that fit in kMaxPendingSendAllowed in one write,
+  // rather than one socket write and message loop round trip per buffer.
+  // The delegate is told of the bytes sent once they all are.
   scoped_refptr<IOBufferWithSize> next_buffer = send_buffer_queue_.front();
   send_buffer_queue_.pop_front();
+  size_t coalesced_count = 0;
+  int total_size = next_buffer->size();
+  while (coalesced_count < send_buffer_queue_.size() &&
+         total_size + send_buffer_queue_[coalesced_count]->size() <=
+             kMaxPendingSendAllowed) {
+    total_size += send_buffer_queue_[coalesced_count]->size();
+    ++coalesced_count;
+  }
+  if (coalesced_count > 0) {
+    scoped_refptr<IOBufferWithSize> coalesced_buffer =
+        new IOBufferWithSize(total_size);
+    memcpy(coalesced_buffer->data(), next_buffer->data(), next_buffer->size());
+    int offset = next_buffer->size();
+    for (size_t i = 0; i < coalesced_count; ++i) {
+      IOBufferWithSize* buffer = send_buffer_queue_.front().get();
+      memcpy(coalesced_buffer->data() + offset, buffer->data(),
+             buffer->size());
+      offset += buffer->size();
+      send_buffer_queue_.pop_front();
+    }
+    next_buffer = coalesced_buffer;
+  }
   current_send_buffer_ = new DrainableIOBuffer(next_buffer,
                                                next_buffer->size());
   SendDataInternal(current_send_buffer_->data(),
@@ -22,12 +22,16 @@ PluginVarTracker::HostVar::HostVar(PluginDispatcher* d, int32 i)
       host_object_id(i) {
 }
 
-bool PluginVarTracker::HostVar::operator<(const HostVar& other) const {
-  if (dispatcher < other.dispatcher)
-    return true;
-  if (other.dispatcher < dispatcher)
-    return false;
-  return host_object_id < other.host_object_id;
+bool PluginVarTracker::HostVar::operator==(const HostVar& other) const {
+  return dispatcher == other.dispatcher &&
+         host_object_id == other.host_object_id;
+}
+
+size_t PluginVarTracker::HostVarHash::operator()(
+    const HostVar& host_var) const {
+  // The table mixes the bits, so combining them is enough.
+  return reinterpret_cast<size_t>(host_var.dispatcher) * 31 +
+         static_cast<size_t>(host_var.host_object_id);
 }
 
 PluginVarTracker::PluginVarTracker() {
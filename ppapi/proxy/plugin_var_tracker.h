@@ -5,11 +5,11 @@
 #ifndef PPAPI_PROXY_PLUGIN_VAR_TRACKER_H_
 #define PPAPI_PROXY_PLUGIN_VAR_TRACKER_H_
 
-#include <map>
 #include <string>
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/flat_hash_map.h"
 #include "base/memory/ref_counted.h"
 #include "ppapi/c/pp_stdint.h"
 #include "ppapi/c/pp_var.h"
@@ -72,7 +72,7 @@ class PPAPI_PROXY_EXPORT PluginVarTracker : public VarTracker {
   struct HostVar {
     HostVar(PluginDispatcher* d, int32 i);
 
-    bool operator<(const HostVar& other) const;
+    bool operator==(const HostVar& other) const;
 
     // The dispatcher that sent us this object. This is used so we know how to
     // send back requests on this object.
@@ -102,8 +102,13 @@ class PPAPI_PROXY_EXPORT PluginVarTracker : public VarTracker {
       const PP_Var& var,
       PluginDispatcher* dispatcher);
 
+  struct HostVarHash {
+    size_t operator()(const HostVar& host_var) const;
+  };
+
   // Maps host vars in the host to IDs in the plugin process.
-  typedef std::map<HostVar, int32> HostVarToPluginVarMap;
+  typedef base::flat_hash_map<HostVar, int32, HostVarHash>
+      HostVarToPluginVarMap;
   HostVarToPluginVarMap host_var_to_plugin_var_;
 
   DISALLOW_COPY_AND_ASSIGN(PluginVarTracker);
@@ -44,6 +44,9 @@ namespace proxy {
 
 namespace {
 
+// How long an answer of GetLocalTimeZoneOffset() is reused for.
+const int kLocalTimeZoneOffsetCacheSeconds = 1;
+
 IPC::PlatformFileForTransit PlatformFileToPlatformFileForTransit(
     Dispatcher* dispatcher,
     int32_t* error,
@@ -369,7 +372,9 @@ void ModuleLocalThreadAdapter::OnModuleLocalMessageFailedLocked(
 // -----------------------------------------------------------------------------
 
 PPB_Flash_Proxy::PPB_Flash_Proxy(Dispatcher* dispatcher)
-    : InterfaceProxy(dispatcher) {
+    : InterfaceProxy(dispatcher),
+      cached_local_offset_time_(0),
+      cached_local_offset_(0) {
 }
 
 PPB_Flash_Proxy::~PPB_Flash_Proxy() {
@@ -527,9 +532,17 @@ double PPB_Flash_Proxy::GetLocalTimeZoneOffset(PP_Instance instance,
   //
   // On Linux, it would be better to go directly to the browser process for
   // this message rather than proxy it through some instance in a renderer.
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (t == cached_local_offset_time_ && now < cached_local_offset_expiry_)
+    return cached_local_offset_;
+
   double result = 0;
   dispatcher()->Send(new PpapiHostMsg_PPBFlash_GetLocalTimeZoneOffset(
       API_ID_PPB_FLASH, instance, t, &result));
+  cached_local_offset_time_ = t;
+  cached_local_offset_ = result;
+  cached_local_offset_expiry_ =
+      now + base::TimeDelta::FromSeconds(kLocalTimeZoneOffsetCacheSeconds);
   return result;
 }
 
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "base/compiler_specific.h"
+#include "base/time.h"
 #include "ipc/ipc_platform_file.h"
 #include "ppapi/c/pp_bool.h"
 #include "ppapi/c/pp_instance.h"
@@ -190,6 +191,13 @@ class PPB_Flash_Proxy : public InterfaceProxy, public PPB_Flash_Shared {
   void OnHostMsgGetDeviceID(PP_Instance instance,
                             SerializedVarReturnValue id);
 
+  // The last answer of GetLocalTimeZoneOffset(), which Flash tends to ask
+  // for the same time several times in a row. It's only reused until
+  // |cached_local_offset_expiry_|, so that time zone changes are noticed.
+  PP_Time cached_local_offset_time_;
+  double cached_local_offset_;
+  base::TimeTicks cached_local_offset_expiry_;
+
   DISALLOW_COPY_AND_ASSIGN(PPB_Flash_Proxy);
 };
 
@@ -19,6 +19,16 @@ namespace {
 base::WaitableEvent handle_message_called(false, false);
 
 void HandleMessage(PP_Instance /* instance */, PP_Var message_data) {
+  if (message_data.type == PP_VARTYPE_ARRAY_BUFFER) {
+    // Touch the data for the same reason as the string contents below.
+    ArrayBufferVar* buffer_var = ArrayBufferVar::FromPPVar(message_data);
+    DCHECK(buffer_var);
+    if (buffer_var->ByteLength() > 0)
+      static_cast<char*>(buffer_var->Map())[0] = 'a';
+    PpapiGlobals::Get()->GetVarTracker()->ReleaseVar(message_data);
+    handle_message_called.Signal();
+    return;
+  }
   StringVar* string_var = StringVar::FromPPVar(message_data);
   DCHECK(string_var);
   // Retrieve the string to make sure the proxy can't "optimize away" sending
@@ -83,6 +93,31 @@ TEST_F(PppMessagingPerfTest, StringPerformance) {
   }
 }
 
+// Tests the throughput of sending ArrayBuffers of 1KB to 16MB through the
+// proxy.
+TEST_F(PppMessagingPerfTest, ArrayBufferPerformance) {
+  const PPP_Messaging* ppp_messaging = static_cast<const PPP_Messaging*>(
+      host().host_dispatcher()->GetProxiedInterface(
+          PPP_MESSAGING_INTERFACE));
+  const PP_Instance kTestInstance = pp_instance();
+  const uint32 kMinBufferSize = 1024;
+  const uint32 kMaxBufferSize = 16 * 1024 * 1024;
+  // Send the same number of bytes at each size.
+  const uint32 kBytesPerSize = 64 * 1024 * 1024;
+  for (uint32 size = kMinBufferSize; size <= kMaxBufferSize; size *= 4) {
+    PP_Var host_buffer =
+        PpapiGlobals::Get()->GetVarTracker()->MakeArrayBufferPPVar(size);
+    PerfTimeLogger logger(("PppMessagingPerfTest.ArrayBufferPerformance_" +
+                           base::UintToString(size)).c_str());
+    for (uint32 sent = 0; sent < kBytesPerSize; sent += size) {
+      ppp_messaging->HandleMessage(kTestInstance, host_buffer);
+      handle_message_called.Wait();
+    }
+    logger.Done();
+    PpapiGlobals::Get()->GetVarTracker()->ReleaseVar(host_buffer);
+  }
+}
+
 }  // namespace proxy
 }  // namespace ppapi
 
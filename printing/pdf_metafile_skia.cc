@@ -118,8 +118,9 @@ bool PdfMetafileSkia::GetData(void* dst_buffer,
   if (dst_buffer_size < GetDataSize())
     return false;
 
-  SkAutoDataUnref data(data_->pdf_stream_.copyToData());
-  memcpy(dst_buffer, data.bytes(), dst_buffer_size);
+  // Copy straight out of the stream's blocks, rather than through a
+  // contiguous copy of the whole document.
+  data_->pdf_stream_.copyTo(dst_buffer);
   return true;
 }
 
@@ -4,6 +4,8 @@
 
 #include "remoting/base/encoder_vp8.h"
 
+#include <algorithm>
+
 #include "base/logging.h"
 #include "base/sys_info.h"
 #include "media/base/yuv_convert.h"
@@ -23,6 +25,21 @@ namespace {
 // map for the encoder.
 const int kMacroBlockSize = 16;
 
+// Upper bound on the number of threads the encoder is given.
+const int kMaxEncoderThreads = 4;
+
+// Returns the number of threads to encode with on this machine.
+int GetEncoderThreadCount() {
+  // Using 2 threads gives a great boost in performance for most systems with
+  // adequate processing power. NB: Going to multiple threads on low end
+  // windows systems can really hurt performance.
+  // http://crbug.com/99179
+  int processors = base::SysInfo::NumberOfProcessors();
+  if (processors <= 2)
+    return 1;
+  return std::min(std::max(processors / 2, 2), kMaxEncoderThreads);
+}
+
 }  // namespace remoting
 
 namespace remoting {
@@ -124,11 +141,7 @@ bool EncoderVp8::Init(const SkISize& size) {
   // encoding.
   config.g_profile = 2;
 
-  // Using 2 threads gives a great boost in performance for most systems with
-  // adequate processing power. NB: Going to multiple threads on low end
-  // windows systems can really hurt performance.
-  // http://crbug.com/99179
-  config.g_threads = (base::SysInfo::NumberOfProcessors() > 2) ? 2 : 1;
+  config.g_threads = GetEncoderThreadCount();
   config.rc_min_quantizer = 20;
   config.rc_max_quantizer = 30;
   config.g_timebase.num = 1;
@@ -146,6 +159,17 @@ bool EncoderVp8::Init(const SkISize& size) {
   // on motion estimation and inter-prediction mode.
   if (vpx_codec_control(codec_.get(), VP8E_SET_NOISE_SENSITIVITY, 0))
     return false;
+
+  // Split the tokens into one partition per thread, so that the threads
+  // don't have to wait on each other to write them out.
+  vp8e_token_partitions partitions = VP8_ONE_TOKENPARTITION;
+  if (config.g_threads >= 4) {
+    partitions = VP8_FOUR_TOKENPARTITION;
+  } else if (config.g_threads >= 2) {
+    partitions = VP8_TWO_TOKENPARTITION;
+  }
+  if (vpx_codec_control(codec_.get(), VP8E_SET_TOKEN_PARTITIONS, partitions))
+    return false;
   return true;
 }
 
@@ -68,25 +68,30 @@ void Differ::MarkDirtyBlocks(const void* prev_buffer, const void* curr_buffer) {
   DiffInfo* diff_info_row_start = static_cast<DiffInfo*>(diff_info_.get());
 
   for (int y = 0; y < y_full_blocks; y++) {
-    const uint8* prev_block = prev_block_row_start;
-    const uint8* curr_block = curr_block_row_start;
-    DiffInfo* diff_info = diff_info_row_start;
-
-    for (int x = 0; x < x_full_blocks; x++) {
-      // Mark this block as being modified so that it gets incorporated into
-      // a dirty rect.
-      *diff_info = BlockDifference(prev_block, curr_block, bytes_per_row_);
-      prev_block += block_x_offset;
-      curr_block += block_x_offset;
-      diff_info += sizeof(DiffInfo);
-    }
+    // Most updates touch only a few rows of blocks, so compare the whole
+    // scanlines first and only look at the blocks of rows that changed.
+    // The diff info of the other rows has already been cleared.
+    if (DiffRows(prev_block_row_start, curr_block_row_start, kBlockSize)) {
+      const uint8* prev_block = prev_block_row_start;
+      const uint8* curr_block = curr_block_row_start;
+      DiffInfo* diff_info = diff_info_row_start;
+
+      for (int x = 0; x < x_full_blocks; x++) {
+        // Mark this block as being modified so that it gets incorporated
+        // into a dirty rect.
+        *diff_info = BlockDifference(prev_block, curr_block, bytes_per_row_);
+        prev_block += block_x_offset;
+        curr_block += block_x_offset;
+        diff_info += sizeof(DiffInfo);
+      }
 
-    // If there is a partial column at the end, handle it.
-    // This condition should rarely, if ever, occur.
-    if (partial_column_width != 0) {
-      *diff_info = DiffPartialBlock(prev_block, curr_block, bytes_per_row_,
-                                    partial_column_width, kBlockSize);
-      diff_info += sizeof(DiffInfo);
+      // If there is a partial column at the end, handle it.
+      // This condition should rarely, if ever, occur.
+      if (partial_column_width != 0) {
+        *diff_info = DiffPartialBlock(prev_block, curr_block, bytes_per_row_,
+                                      partial_column_width, kBlockSize);
+        diff_info += sizeof(DiffInfo);
+      }
     }
 
     // Update pointers for next row.
@@ -98,7 +103,9 @@ void Differ::MarkDirtyBlocks(const void* prev_buffer, const void* curr_buffer) {
   // If the screen height is not a multiple of the block size, then this
   // handles the last partial row. This situation is far more common than the
   // 'partial column' case.
-  if (partial_row_height != 0) {
+  if (partial_row_height != 0 &&
+      DiffRows(prev_block_row_start, curr_block_row_start,
+               partial_row_height)) {
     const uint8* prev_block = prev_block_row_start;
     const uint8* curr_block = curr_block_row_start;
     DiffInfo* diff_info = diff_info_row_start;
@@ -118,6 +125,18 @@ void Differ::MarkDirtyBlocks(const void* prev_buffer, const void* curr_buffer) {
   }
 }
 
+bool Differ::DiffRows(const uint8* prev_buffer, const uint8* curr_buffer,
+                      int height) {
+  int width_bytes = width_ * bytes_per_pixel_;
+  for (int y = 0; y < height; y++) {
+    if (memcmp(prev_buffer, curr_buffer, width_bytes) != 0)
+      return true;
+    prev_buffer += bytes_per_row_;
+    curr_buffer += bytes_per_row_;
+  }
+  return false;
+}
+
 DiffInfo Differ::DiffPartialBlock(const uint8* prev_buffer,
                                   const uint8* curr_buffer,
                                   int stride, int width, int height) {
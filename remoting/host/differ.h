@@ -48,6 +48,11 @@ class Differ {
   // The goal is to minimize the region that covers the dirty blocks.
   void MergeBlocks(SkRegion* region);
 
+  // Returns true if any of the first |height| rows of |prev_buffer| and
+  // |curr_buffer| differ.
+  bool DiffRows(const uint8* prev_buffer, const uint8* curr_buffer,
+                int height);
+
   // Check for diffs in upper-left portion of the block. The size of the portion
   // to check is specified by the |width| and |height| values.
   // Note that if we force the capturer to always return images whose width and
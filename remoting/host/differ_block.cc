@@ -8,6 +8,10 @@
 #include "media/base/cpu_features.h"
 #include "remoting/host/differ_block_internal.h"
 
+#if defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 namespace remoting {
 
 int BlockDifference_C(const uint8* image1, const uint8* image2, int stride) {
@@ -22,14 +26,39 @@ int BlockDifference_C(const uint8* image1, const uint8* image2, int stride) {
   return 0;
 }
 
+#if defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+int BlockDifference_NEON(const uint8* image1, const uint8* image2,
+                         int stride) {
+  int width_bytes = kBlockSize * kBytesPerPixel;
+
+  for (int y = 0; y < kBlockSize; y++) {
+    // OR together the XOR of each 16 bytes of the row, so that the row
+    // differs if any bit of the result is set.
+    uint8x16_t acc = vdupq_n_u8(0);
+    for (int x = 0; x < width_bytes; x += 16)
+      acc = vorrq_u8(acc, veorq_u8(vld1q_u8(image1 + x),
+                                   vld1q_u8(image2 + x)));
+    uint64x2_t diff = vreinterpretq_u64_u8(acc);
+    if (vgetq_lane_u64(diff, 0) | vgetq_lane_u64(diff, 1))
+      return 1;
+    image1 += stride;
+    image2 += stride;
+  }
+  return 0;
+}
+#endif
+
 int BlockDifference(const uint8* image1, const uint8* image2, int stride) {
   static int (*diff_proc)(const uint8*, const uint8*, int) = NULL;
 
   if (!diff_proc) {
 #if defined(ARCH_CPU_ARM_FAMILY)
-    // For ARM processors, always use C version.
-    // TODO(hclam): Implement a NEON version.
+    // NEON is a build time option on ARM, so there is nothing to detect.
+#if defined(__ARM_NEON__)
+    diff_proc = &BlockDifference_NEON;
+#else
     diff_proc = &BlockDifference_C;
+#endif
 #else
     // For x86 processors, check if SSE2 is supported.
     if (media::hasSSE2() && kBlockSize == 32)
@@ -256,6 +256,34 @@ TEST_F(DifferTest, MarkDirtyBlocks_Sampling) {
   EXPECT_EQ(0, GetDiffInfo(2, 2));
 }
 
+// Rows of blocks without changes are skipped as a whole, including the
+// partial row at the bottom.
+TEST_F(DifferTest, MarkDirtyBlocks_UnchangedRows) {
+  InitDiffer(kPartialScreenWidth, kPartialScreenHeight);
+  ClearDiffInfo();
+
+  WriteBlockPixel(curr_.get(), 1, 1, 0, 0, 0xff00ff);
+  MarkDirtyBlocks(prev_.get(), curr_.get());
+  for (int y = 0; y < GetDiffInfoHeight() - 1; y++) {
+    for (int x = 0; x < GetDiffInfoWidth() - 1; x++) {
+      EXPECT_EQ(x == 1 && y == 1 ? 1 : 0, GetDiffInfo(x, y))
+          << "when x = " << x << ", and y = " << y;
+    }
+  }
+
+  // Now change only the partial row.
+  ClearBuffer(curr_.get());
+  WritePixel(curr_.get(), 0, kPartialScreenHeight - 1, 0xff00ff);
+  MarkDirtyBlocks(prev_.get(), curr_.get());
+  int last_row = GetDiffInfoHeight() - 2;
+  for (int y = 0; y < GetDiffInfoHeight() - 1; y++) {
+    for (int x = 0; x < GetDiffInfoWidth() - 1; x++) {
+      EXPECT_EQ(x == 0 && y == last_row ? 1 : 0, GetDiffInfo(x, y))
+          << "when x = " << x << ", and y = " << y;
+    }
+  }
+}
+
 TEST_F(DifferTest, DiffBlock) {
   InitDiffer(kScreenWidth, kScreenHeight);
 
@@ -27,6 +27,10 @@
 
 namespace {
 
+// The most |family,style| misses that are remembered. The families come from
+// web content, so the set is cleared rather than let grow without bound.
+const size_t kMaxFontMisses = 1024;
+
 // Equivalence classes, used to match the Liberation and other fonts
 // with their metric-compatible replacements.  See the discussion in
 // GetFontEquivClass().
@@ -287,10 +291,13 @@ bool FontConfigDirect::Match(std::string* result_family,
     // be a function of these three parameters, and thus eligible for caching.
     // This is the fast path for |SkTypeface::CreateFromName()|.
     bool eligible_for_cache = !family.empty() && is_bold && is_italic && !data;
+    FontMatchKey key;
     if (eligible_for_cache) {
         int style = (*is_bold ? SkTypeface::kBold : 0 ) |
                     (*is_italic ? SkTypeface::kItalic : 0);
-        FontMatchKey key = FontMatchKey(family, style);
+        key = FontMatchKey(family, style);
+        if (font_miss_cache_.count(key))
+            return false;
         const std::map<FontMatchKey, FontMatch>::const_iterator i =
             font_match_cache_.find(key);
         if (i != font_match_cache_.end()) {
@@ -391,6 +398,11 @@ bool FontConfigDirect::Match(std::string* result_family,
     if (!match) {
         FcPatternDestroy(pattern);
         FcFontSetDestroy(font_set);
+        if (eligible_for_cache) {
+            if (font_miss_cache_.size() >= kMaxFontMisses)
+                font_miss_cache_.clear();
+            font_miss_cache_.insert(key);
+        }
         return false;
     }
 
@@ -437,11 +449,8 @@ bool FontConfigDirect::Match(std::string* result_family,
 
     if (success) {
         // If eligible, cache the result of the matching.
-        if (eligible_for_cache) {
-            int style = (*is_bold ? SkTypeface::kBold : 0 ) |
-                        (*is_italic ? SkTypeface::kItalic : 0);
-            font_match_cache_[FontMatchKey(family, style)] = font_match;
-        }
+        if (eligible_for_cache)
+            font_match_cache_[key] = font_match;
 
         if (result_family)
             *result_family = font_match.family;
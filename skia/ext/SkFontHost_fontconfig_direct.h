@@ -20,6 +20,7 @@
 #pragma once
 
 #include <map>
+#include <set>
 #include <string>
 
 #include "SkThread.h"
@@ -53,6 +54,10 @@ class SK_API FontConfigDirect : public FontConfigInterface {
     unsigned filefaceid;
   };
   std::map<FontMatchKey, FontMatch> font_match_cache_;
+  // The |family,style| requests which matched no font. The families of CSS
+  // fallback lists which aren't installed are asked for again and again, and
+  // each miss would otherwise sort every font on the system.
+  std::set<FontMatchKey> font_miss_cache_;
 
   unsigned next_file_id_;
 };
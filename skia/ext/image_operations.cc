@@ -10,10 +10,14 @@
 #include "skia/ext/image_operations.h"
 
 // TODO(pkasting): skia/ext should not depend on base/!
+#include "base/compiler_specific.h"
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
 #include "base/metrics/histogram.h"
 #include "base/stack_container.h"
+#include "base/sys_info.h"
+#include "base/threading/simple_thread.h"
 #include "base/time.h"
 #include "build/build_config.h"
 #include "skia/ext/convolver.h"
@@ -314,6 +318,57 @@ void ResizeFilter::ComputeFilters(int src_size,
   output->PaddingForSIMD(8);
 }
 
+// Sources of at least this many pixels are resized in bands on several
+// threads, below it starting the threads costs more than it saves.
+const int kMinBandedResizePixels = 1024 * 1024;
+
+// The most bands, and so threads, a resize is split into.
+const int kMaxResizeBands = 4;
+
+// Resizes the rows |band| of the destination subset. The filters of each
+// output row only depend on the position of the row in the destination, so
+// the bands of a subset give the same pixels as the whole subset.
+class ResizeBand : public base::DelegateSimpleThread::Delegate {
+ public:
+  ResizeBand(const SkBitmap& source,
+             ImageOperations::ResizeMethod method,
+             int dest_width, int dest_height,
+             const SkIRect& band,
+             unsigned char* output,
+             int output_byte_row_stride,
+             bool use_sse2)
+      : source_(source),
+        method_(method),
+        dest_width_(dest_width),
+        dest_height_(dest_height),
+        band_(band),
+        output_(output),
+        output_byte_row_stride_(output_byte_row_stride),
+        use_sse2_(use_sse2) {
+  }
+
+  virtual void Run() OVERRIDE {
+    ResizeFilter filter(method_, source_.width(), source_.height(),
+                        dest_width_, dest_height_, band_);
+    BGRAConvolve2D(reinterpret_cast<const uint8*>(source_.getPixels()),
+                   static_cast<int>(source_.rowBytes()),
+                   !source_.isOpaque(), filter.x_filter(), filter.y_filter(),
+                   output_byte_row_stride_, output_, use_sse2_);
+  }
+
+ private:
+  const SkBitmap& source_;
+  ImageOperations::ResizeMethod method_;
+  int dest_width_;
+  int dest_height_;
+  SkIRect band_;
+  unsigned char* output_;
+  int output_byte_row_stride_;
+  bool use_sse2_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResizeBand);
+};
+
 ImageOperations::ResizeMethod ResizeMethodToAlgorithmMethod(
     ImageOperations::ResizeMethod method) {
   // Convert any "Quality Method" into an "Algorithm Method"
@@ -504,15 +559,6 @@ SkBitmap ImageOperations::ResizeBasic(const SkBitmap& source,
   if (!source.readyToDraw())
       return SkBitmap();
 
-  ResizeFilter filter(method, source.width(), source.height(),
-                      dest_width, dest_height, dest_subset);
-
-  // Get a source bitmap encompassing this touched area. We construct the
-  // offsets and row strides such that it looks like a new bitmap, while
-  // referring to the old data.
-  const uint8* source_subset =
-      reinterpret_cast<const uint8*>(source.getPixels());
-
   // Convolve into the result.
   base::CPU cpu;
   SkBitmap result;
@@ -522,11 +568,37 @@ SkBitmap ImageOperations::ResizeBasic(const SkBitmap& source,
   if (!result.readyToDraw())
     return SkBitmap();
 
-  BGRAConvolve2D(source_subset, static_cast<int>(source.rowBytes()),
-                 !source.isOpaque(), filter.x_filter(), filter.y_filter(),
-                 static_cast<int>(result.rowBytes()),
-                 static_cast<unsigned char*>(result.getPixels()),
-                 cpu.has_sse2());
+  // Large sources are split into horizontal bands of the destination that
+  // are resized in parallel.
+  int num_bands = 1;
+  if (source.width() * source.height() >= kMinBandedResizePixels) {
+    num_bands = std::min(base::SysInfo::NumberOfProcessors(), kMaxResizeBands);
+    num_bands = std::max(1, std::min(num_bands, dest_subset.height()));
+  }
+
+  ScopedVector<ResizeBand> bands;
+  for (int i = 0; i < num_bands; ++i) {
+    int top = dest_subset.height() * i / num_bands;
+    int bottom = dest_subset.height() * (i + 1) / num_bands;
+    SkIRect band = { dest_subset.fLeft, dest_subset.fTop + top,
+                     dest_subset.fRight, dest_subset.fTop + bottom };
+    bands.push_back(new ResizeBand(
+        source, method, dest_width, dest_height, band,
+        reinterpret_cast<unsigned char*>(result.getAddr32(0, top)),
+        static_cast<int>(result.rowBytes()), cpu.has_sse2()));
+  }
+
+  if (num_bands == 1) {
+    bands[0]->Run();
+  } else {
+    // This thread resizes the first band while the pool does the others.
+    base::DelegateSimpleThreadPool pool("ImageResize", num_bands - 1);
+    for (int i = 1; i < num_bands; ++i)
+      pool.AddWork(bands[i]);
+    pool.Start();
+    bands[0]->Run();
+    pool.JoinAll();
+  }
 
   // Preserve the "opaque" flag for use as an optimization later.
   result.setIsOpaque(source.isOpaque());
@@ -471,6 +471,31 @@ TEST(ImageOperations, HalveSubset) {
   }
 }
 
+// Large images are resized in bands on several threads, which should give the
+// same result as resizing one row at a time.
+TEST(ImageOperations, ResizeLargeImage) {
+  int src_w = 1024, src_h = 1024;
+  SkBitmap src;
+  FillDataToBitmap(src_w, src_h, &src);
+
+  int dest_w = 100, dest_h = 75;
+  SkBitmap full_results = skia::ImageOperations::Resize(
+      src, skia::ImageOperations::RESIZE_LANCZOS3, dest_w, dest_h);
+  ASSERT_EQ(dest_w, full_results.width());
+  ASSERT_EQ(dest_h, full_results.height());
+
+  SkAutoLockPixels full_lock(full_results);
+  for (int y = 0; y < dest_h; y++) {
+    SkIRect row_rect = { 0, y, dest_w, y + 1 };
+    SkBitmap row_results = skia::ImageOperations::Resize(
+        src, skia::ImageOperations::RESIZE_LANCZOS3, dest_w, dest_h,
+        row_rect);
+    SkAutoLockPixels row_lock(row_results);
+    for (int x = 0; x < dest_w; x++)
+      ASSERT_EQ(*full_results.getAddr32(x, y), *row_results.getAddr32(x, 0));
+  }
+}
+
 // Resamples an image to the same image, it should give the same result.
 TEST(ImageOperations, ResampleToSameHamming1) {
   CheckResampleToSame(skia::ImageOperations::RESIZE_HAMMING1);
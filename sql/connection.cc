@@ -8,6 +8,7 @@
 
 #include "base/file_path.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
 #include "base/utf_string_conversions.h"
@@ -56,15 +57,23 @@ ErrorDelegate::ErrorDelegate() {
 ErrorDelegate::~ErrorDelegate() {
 }
 
+StatementProfile::StatementProfile()
+    : steps(0),
+      rows(0),
+      full_scan_steps(0) {
+}
+
 Connection::StatementRef::StatementRef()
     : connection_(NULL),
-      stmt_(NULL) {
+      stmt_(NULL),
+      profile_(NULL) {
 }
 
 Connection::StatementRef::StatementRef(Connection* connection,
                                        sqlite3_stmt* stmt)
     : connection_(connection),
-      stmt_(stmt) {
+      stmt_(stmt),
+      profile_(NULL) {
   connection_->StatementRefCreated(this);
 }
 
@@ -80,6 +89,7 @@ void Connection::StatementRef::Close() {
     stmt_ = NULL;
   }
   connection_ = NULL;  // The connection may be getting deleted.
+  profile_ = NULL;
 }
 
 Connection::Connection()
@@ -87,14 +97,25 @@ Connection::Connection()
       page_size_(0),
       cache_size_(0),
       exclusive_locking_(false),
+      write_ahead_log_(false),
+      read_only_(false),
       transaction_nesting_(0),
-      needs_rollback_(false) {
+      needs_rollback_(false),
+      step_time_histogram_(NULL) {
 }
 
 Connection::~Connection() {
   Close();
 }
 
+void Connection::EnableStatementProfiling(const std::string& histogram_tag) {
+  step_time_histogram_ = base::Histogram::FactoryTimeGet(
+      "Sqlite.StepTime." + histogram_tag,
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromSeconds(10),
+      50, base::Histogram::kUmaTargetedHistogramFlag);
+}
+
 bool Connection::Open(const FilePath& path) {
 #if defined(OS_WIN)
   return OpenInternal(WideToUTF8(path.value()));
@@ -346,12 +367,17 @@ scoped_refptr<Connection::StatementRef> Connection::GetCachedStatement(
     // case it still has some stuff bound.
     DCHECK(i->second->is_valid());
     sqlite3_reset(i->second->stmt());
+    if (step_time_histogram_ && !i->second->profile())
+      i->second->set_profile(&statement_profiles_[id]);
     return i->second;
   }
 
   scoped_refptr<StatementRef> statement = GetUniqueStatement(sql);
-  if (statement->is_valid())
+  if (statement->is_valid()) {
     statement_cache_[id] = statement;  // Only cache valid statements.
+    if (step_time_histogram_)
+      statement->set_profile(&statement_profiles_[id]);
+  }
   return statement;
 }
 
@@ -369,6 +395,12 @@ scoped_refptr<Connection::StatementRef> Connection::GetUniqueStatement(
   return new StatementRef(this, stmt);
 }
 
+const StatementProfile* Connection::GetStatementProfile(
+    const StatementID& id) const {
+  StatementProfileMap::const_iterator i = statement_profiles_.find(id);
+  return i == statement_profiles_.end() ? NULL : &i->second;
+}
+
 bool Connection::IsSQLValid(const char* sql) {
   sqlite3_stmt* stmt = NULL;
   if (sqlite3_prepare_v2(db_, sql, -1, &stmt, NULL) != SQLITE_OK)
@@ -455,13 +487,45 @@ const char* Connection::GetErrorMessage() const {
   return sqlite3_errmsg(db_);
 }
 
+void Connection::SetJournalMode() {
+  // http://www.sqlite.org/pragma.html#pragma_journal_mode
+  // DELETE (default) - delete -journal file to commit.
+  // TRUNCATE - truncate -journal file to commit.
+  // PERSIST - zero out header of -journal file to commit.
+  // WAL - append to the -wal file to commit, see set_write_ahead_log().
+  // journal_size_limit provides size to trim to in PERSIST, and the size
+  // the -wal file is trimmed to after checkpoints.
+  // TODO(shess): Figure out if PERSIST and journal_size_limit really
+  // matter.  In theory, it keeps pages pre-allocated, so if
+  // transactions usually fit, it should be faster.
+  bool use_write_ahead_log = false;
+  if (write_ahead_log_) {
+    // The new mode is returned, which is the old one if it can't be changed.
+    Statement journal_mode(GetUniqueStatement("PRAGMA journal_mode = WAL"));
+    use_write_ahead_log =
+        journal_mode.Step() && journal_mode.ColumnString(0) == "wal";
+    DLOG_IF(WARNING, !use_write_ahead_log)
+        << "Could not use write-ahead log: " << GetErrorMessage();
+  }
+  if (use_write_ahead_log) {
+    // In WAL mode, NORMAL only syncs at checkpoints, and is still safe
+    // against corruption.
+    ignore_result(Execute("PRAGMA synchronous = NORMAL"));
+  } else {
+    ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
+  }
+  ignore_result(Execute("PRAGMA journal_size_limit = 16384"));
+}
+
 bool Connection::OpenInternal(const std::string& file_name) {
   if (db_) {
     DLOG(FATAL) << "sql::Connection is already open.";
     return false;
   }
 
-  int err = sqlite3_open(file_name.c_str(), &db_);
+  int flags = read_only_ ?
+      SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
+  int err = sqlite3_open_v2(file_name.c_str(), &db_, flags, NULL);
   if (err != SQLITE_OK) {
     OnSqliteError(err, NULL);
     Close();
@@ -492,16 +556,9 @@ bool Connection::OpenInternal(const std::string& file_name) {
       DLOG(FATAL) << "Could not set locking mode: " << GetErrorMessage();
   }
 
-  // http://www.sqlite.org/pragma.html#pragma_journal_mode
-  // DELETE (default) - delete -journal file to commit.
-  // TRUNCATE - truncate -journal file to commit.
-  // PERSIST - zero out header of -journal file to commit.
-  // journal_size_limit provides size to trim to in PERSIST.
-  // TODO(shess): Figure out if PERSIST and journal_size_limit really
-  // matter.  In theory, it keeps pages pre-allocated, so if
-  // transactions usually fit, it should be faster.
-  ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
-  ignore_result(Execute("PRAGMA journal_size_limit = 16384"));
+  // A read-only connection keeps whatever mode the database is in.
+  if (!read_only_)
+    SetJournalMode();
 
   const base::TimeDelta kBusyTimeout =
     base::TimeDelta::FromSeconds(kBusyTimeoutSeconds);
@@ -562,6 +619,10 @@ void Connection::ClearCache() {
     (*i)->Close();
 }
 
+void Connection::RecordStepTime(base::TimeDelta step_time) {
+  step_time_histogram_->AddTime(step_time);
+}
+
 int Connection::OnSqliteError(int err, sql::Statement *stmt) {
   if (error_delegate_.get())
     return error_delegate_->OnError(err, this, stmt);
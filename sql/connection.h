@@ -20,6 +20,10 @@ class FilePath;
 struct sqlite3;
 struct sqlite3_stmt;
 
+namespace base {
+class Histogram;
+}
+
 namespace sql {
 
 class Statement;
@@ -70,6 +74,24 @@ class StatementID {
 
 #define SQL_FROM_HERE sql::StatementID(__FILE__, __LINE__)
 
+// What a cached statement has done since statement profiling was enabled on
+// its connection. See Connection::EnableStatementProfiling().
+struct SQL_EXPORT StatementProfile {
+  StatementProfile();
+
+  // The number of times the statement was stepped, and how many of those
+  // steps returned a row.
+  int64 steps;
+  int64 rows;
+
+  // The time spent in sqlite3_step().
+  base::TimeDelta step_time;
+
+  // The number of rows SQLite went through in full table or index scans,
+  // rather than by seeking. Large numbers often mean a missing index.
+  int64 full_scan_steps;
+};
+
 class Connection;
 
 // ErrorDelegate defines the interface to implement error handling and recovery
@@ -139,6 +161,27 @@ class SQL_EXPORT Connection {
   // This must be called before Open() to have an effect.
   void set_exclusive_locking() { exclusive_locking_ = true; }
 
+  // Call to commit through a write-ahead log rather than a rollback journal.
+  // A commit then appends the changed pages to the -wal file, and only syncs
+  // that file. Every so often SQLite checkpoints the log, copying the pages
+  // back into the database. Readers also no longer wait for writers. The
+  // last commits before a power failure may be rolled back, but the
+  // database stays consistent.
+  //
+  // A database which was last opened with the log is switched back to the
+  // rollback journal when opened without it.
+  //
+  // This must be called before Open() to have an effect.
+  void set_write_ahead_log() { write_ahead_log_ = true; }
+
+  // Call to open the database read-only. Statements which would change it
+  // fail with SQLITE_READONLY, and its journal mode is left alone, so that
+  // the connection can read a database another connection writes through a
+  // write-ahead log. See ReaderPool.
+  //
+  // This must be called before Open() to have an effect.
+  void set_read_only() { read_only_ = true; }
+
   // Sets the object that will handle errors. Recomended that it should be set
   // before calling Open(). If not set, the default is to ignore errors on
   // release and assert on debug builds.
@@ -146,6 +189,12 @@ class SQL_EXPORT Connection {
     error_delegate_ = delegate;
   }
 
+  // Starts keeping a StatementProfile for each cached statement, to find the
+  // statements that keep the database's thread busy. Every step of these
+  // statements is also traced, and its time is added to the
+  // "Sqlite.StepTime.<histogram_tag>" histogram.
+  void EnableStatementProfiling(const std::string& histogram_tag);
+
   // Initialization ------------------------------------------------------------
 
   // Initializes the SQL connection for the given file, returning true if the
@@ -278,6 +327,10 @@ class SQL_EXPORT Connection {
   // See GetCachedStatement above for examples and error information.
   scoped_refptr<StatementRef> GetUniqueStatement(const char* sql);
 
+  // Returns the profile of the cached statement |id|, or NULL if statement
+  // profiling is not enabled or the statement has not been used since.
+  const StatementProfile* GetStatementProfile(const StatementID& id) const;
+
   // Info querying -------------------------------------------------------------
 
   // Returns true if the given table exists.
@@ -321,6 +374,10 @@ class SQL_EXPORT Connection {
   // sqlite3_open. The string can also be sqlite's special ":memory:" string.
   bool OpenInternal(const std::string& file_name);
 
+  // Sets the journal mode and journal size limit on open, see
+  // set_write_ahead_log().
+  void SetJournalMode();
+
   // Internal helper for DoesTableExist and DoesIndexExist.
   bool DoesTableOrIndexExist(const char* name, const char* type) const;
 
@@ -352,6 +409,10 @@ class SQL_EXPORT Connection {
     // this will return NULL.
     sqlite3_stmt* stmt() const { return stmt_; }
 
+    // The profile that the steps of the statement are added to, if any.
+    StatementProfile* profile() const { return profile_; }
+    void set_profile(StatementProfile* profile) { profile_ = profile; }
+
     // Destroys the compiled statement and marks it NULL. The statement will
     // no longer be active.
     void Close();
@@ -363,6 +424,7 @@ class SQL_EXPORT Connection {
 
     Connection* connection_;
     sqlite3_stmt* stmt_;
+    StatementProfile* profile_;
 
     DISALLOW_COPY_AND_ASSIGN(StatementRef);
   };
@@ -380,6 +442,9 @@ class SQL_EXPORT Connection {
   // Frees all cached statements from statement_cache_.
   void ClearCache();
 
+  // Called by profiled Statement objects after each step.
+  void RecordStepTime(base::TimeDelta step_time);
+
   // Called by Statement objects when an sqlite function returns an error.
   // The return value is the error code reflected back to client code.
   int OnSqliteError(int err, Statement* stmt);
@@ -397,6 +462,8 @@ class SQL_EXPORT Connection {
   int page_size_;
   int cache_size_;
   bool exclusive_locking_;
+  bool write_ahead_log_;
+  bool read_only_;
 
   // All cached statements. Keeping a reference to these statements means that
   // they'll remain active.
@@ -410,6 +477,12 @@ class SQL_EXPORT Connection {
   typedef std::set<StatementRef*> StatementRefSet;
   StatementRefSet open_statements_;
 
+  // The profiles of the cached statements, and the histogram of the time
+  // of their steps. The histogram is NULL unless profiling is enabled.
+  typedef std::map<StatementID, StatementProfile> StatementProfileMap;
+  StatementProfileMap statement_profiles_;
+  base::Histogram* step_time_histogram_;
+
   // Number of currently-nested transactions.
   int transaction_nesting_;
 
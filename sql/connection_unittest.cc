@@ -86,6 +86,28 @@ TEST_F(SQLConnectionTest, CachedStatement) {
   EXPECT_FALSE(db().HasCachedStatement(SQL_FROM_HERE));
 }
 
+TEST_F(SQLConnectionTest, StatementProfile) {
+  sql::StatementID id1("foo", 12);
+
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+  ASSERT_TRUE(db().Execute("INSERT INTO foo(a, b) VALUES (12, 13)"));
+  ASSERT_TRUE(db().Execute("INSERT INTO foo(a, b) VALUES (14, 15)"));
+  EXPECT_TRUE(db().GetStatementProfile(id1) == NULL);
+
+  db().EnableStatementProfiling("Test");
+  for (int i = 0; i < 2; ++i) {
+    sql::Statement s(db().GetCachedStatement(id1, "SELECT a FROM foo"));
+    while (s.Step()) {}
+  }
+
+  // Two runs of two rows each, and the step which found no more rows.
+  const sql::StatementProfile* profile = db().GetStatementProfile(id1);
+  ASSERT_TRUE(profile != NULL);
+  EXPECT_EQ(6, profile->steps);
+  EXPECT_EQ(4, profile->rows);
+  EXPECT_LT(0, profile->full_scan_steps);
+}
+
 TEST_F(SQLConnectionTest, IsSQLValidTest) {
   ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
   ASSERT_TRUE(db().IsSQLValid("SELECT a FROM foo"));
@@ -134,6 +156,34 @@ TEST_F(SQLConnectionTest, Rollback) {
   EXPECT_TRUE(db().BeginTransaction());
 }
 
+// Test that set_write_ahead_log() switches the database to the
+// write-ahead log, and that it is switched back when opened without it.
+TEST_F(SQLConnectionTest, WriteAheadLog) {
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+  db().Close();
+
+  {
+    sql::Connection wal_db;
+    wal_db.set_write_ahead_log();
+    ASSERT_TRUE(wal_db.Open(db_path()));
+    sql::Statement s(wal_db.GetUniqueStatement("PRAGMA journal_mode"));
+    ASSERT_TRUE(s.Step());
+    EXPECT_EQ("wal", s.ColumnString(0));
+    s.Clear();
+    EXPECT_TRUE(wal_db.Execute("INSERT INTO foo (a, b) VALUES (1, 2)"));
+  }
+
+  ASSERT_TRUE(db().Open(db_path()));
+  {
+    sql::Statement s(db().GetUniqueStatement("PRAGMA journal_mode"));
+    ASSERT_TRUE(s.Step());
+    EXPECT_EQ("persist", s.ColumnString(0));
+  }
+  sql::Statement s(db().GetUniqueStatement("SELECT COUNT(*) FROM foo"));
+  ASSERT_TRUE(s.Step());
+  EXPECT_EQ(1, s.ColumnInt(0));
+}
+
 // Test that sql::Connection::Raze() results in a database without the
 // tables from the original database.
 TEST_F(SQLConnectionTest, Raze) {
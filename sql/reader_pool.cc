@@ -0,0 +1,94 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sql/reader_pool.h"
+
+#include "base/bind.h"
+#include "base/file_path.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/threading/thread.h"
+#include "sql/connection.h"
+
+namespace sql {
+
+struct ReaderPool::Reader {
+  Reader() : thread("sql::ReaderPool"), pending_reads(0) {}
+
+  Connection connection;
+  base::Thread thread;
+
+  // The reads posted to |thread| whose replies haven't run yet.
+  int pending_reads;
+};
+
+ReaderPool::ReaderPool()
+    : ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
+}
+
+ReaderPool::~ReaderPool() {
+  DCHECK(CalledOnValidThread());
+  // The connections are closed once their threads are done with them.
+  for (size_t i = 0; i < readers_.size(); ++i)
+    readers_[i]->thread.Stop();
+}
+
+bool ReaderPool::Init(const FilePath& path, int size) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(readers_.empty());
+  DCHECK_GT(size, 0);
+
+  for (int i = 0; i < size; ++i) {
+    scoped_ptr<Reader> reader(new Reader);
+    reader->connection.set_read_only();
+    if (!reader->connection.Open(path) || !reader->thread.Start()) {
+      readers_.reset();
+      return false;
+    }
+    readers_.push_back(reader.release());
+  }
+  return true;
+}
+
+bool ReaderPool::PostRead(const tracked_objects::Location& from_here,
+                          const ReadCallback& read,
+                          const base::Closure& reply) {
+  DCHECK(CalledOnValidThread());
+  if (readers_.empty())
+    return false;
+
+  size_t index = 0;
+  for (size_t i = 1; i < readers_.size(); ++i) {
+    if (readers_[i]->pending_reads < readers_[index]->pending_reads)
+      index = i;
+  }
+
+  Reader* reader = readers_[index];
+  if (!reader->thread.message_loop_proxy()->PostTaskAndReply(
+          from_here,
+          base::Bind(&ReaderPool::RunRead, read,
+                     base::Unretained(&reader->connection)),
+          base::Bind(&ReaderPool::RunReply, weak_factory_.GetWeakPtr(),
+                     index, reply))) {
+    return false;
+  }
+  ++reader->pending_reads;
+  return true;
+}
+
+// static
+void ReaderPool::RunRead(const ReadCallback& read, Connection* connection) {
+  read.Run(connection);
+}
+
+// static
+void ReaderPool::RunReply(const base::WeakPtr<ReaderPool>& pool,
+                          size_t index,
+                          const base::Closure& reply) {
+  if (pool)
+    --pool->readers_[index]->pending_reads;
+  reply.Run();
+}
+
+}  // namespace sql
@@ -0,0 +1,91 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SQL_READER_POOL_H_
+#define SQL_READER_POOL_H_
+#pragma once
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/compiler_specific.h"
+#include "base/memory/scoped_vector.h"
+#include "base/memory/weak_ptr.h"
+#include "base/threading/non_thread_safe.h"
+#include "sql/sql_export.h"
+
+class FilePath;
+
+namespace tracked_objects {
+class Location;
+}
+
+namespace sql {
+
+class Connection;
+
+// A ReaderPool runs reads of a database on threads of its own, each with a
+// read-only Connection to it, so that long reads neither wait for the writes
+// of the database's own Connection nor hold them up. For the reads to see
+// the last commit rather than wait on the next one, the database's own
+// Connection must use set_write_ahead_log() and not set_exclusive_locking().
+//
+// A ReaderPool must be used on the thread which created it, which must have
+// a MessageLoop.
+//
+// Usage:
+//   struct Count { int rows; };
+//   void CountRows(Count* count, sql::Connection* db) {
+//     sql::Statement s(db->GetUniqueStatement("SELECT COUNT(*) FROM foo"));
+//     count->rows = s.Step() ? s.ColumnInt(0) : -1;
+//   }
+//   void OnCounted(Count* count) { ... }
+//
+//   Count* count = new Count;
+//   pool.PostRead(FROM_HERE,
+//                 base::Bind(&CountRows, count),
+//                 base::Bind(&OnCounted, base::Owned(count)));
+class SQL_EXPORT ReaderPool : public base::NonThreadSafe {
+ public:
+  // A read gets one of the pool's connections, which must not be kept once
+  // the read returns.
+  typedef base::Callback<void(Connection*)> ReadCallback;
+
+  ReaderPool();
+
+  // Waits for the pending reads to finish. Their replies are still run.
+  ~ReaderPool();
+
+  // Opens |size| read-only connections to the database at |path|, and
+  // starts a thread for each. Returns false if one of them can't be opened
+  // or started.
+  bool Init(const FilePath& path, int size) WARN_UNUSED_RESULT;
+
+  // Runs |read| on the thread with the fewest pending reads, then |reply| on
+  // this thread. Returns false, and runs neither, if Init() hasn't succeeded.
+  bool PostRead(const tracked_objects::Location& from_here,
+                const ReadCallback& read,
+                const base::Closure& reply);
+
+ private:
+  struct Reader;
+
+  // Runs |read| with |connection|, on the reader's thread.
+  static void RunRead(const ReadCallback& read, Connection* connection);
+
+  // Notes that a read of the |index|th reader is done and runs its |reply|,
+  // even if |pool| is gone.
+  static void RunReply(const base::WeakPtr<ReaderPool>& pool,
+                       size_t index,
+                       const base::Closure& reply);
+
+  ScopedVector<Reader> readers_;
+
+  base::WeakPtrFactory<ReaderPool> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReaderPool);
+};
+
+}  // namespace sql
+
+#endif  // SQL_READER_POOL_H_
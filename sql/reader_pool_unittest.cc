@@ -0,0 +1,99 @@
+// Copyright (c) 2012 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sql/reader_pool.h"
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/message_loop.h"
+#include "base/scoped_temp_dir.h"
+#include "sql/connection.h"
+#include "sql/statement.h"
+#include "sql/transaction.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/sqlite/sqlite3.h"
+
+namespace {
+
+struct ReadResult {
+  ReadResult() : rows(-1), insert_error(SQLITE_OK) {}
+
+  int rows;
+  int insert_error;
+};
+
+void CountRows(ReadResult* result, sql::Connection* db) {
+  sql::Statement s(db->GetUniqueStatement("SELECT COUNT(*) FROM foo"));
+  if (s.Step())
+    result->rows = s.ColumnInt(0);
+  result->insert_error =
+      db->ExecuteAndReturnErrorCode("INSERT INTO foo (a) VALUES (3)");
+}
+
+void QuitAfter(int* replies_left) {
+  if (--*replies_left == 0)
+    MessageLoop::current()->Quit();
+}
+
+class SQLReaderPoolTest : public testing::Test {
+ public:
+  void SetUp() {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    db_.set_write_ahead_log();
+    ASSERT_TRUE(db_.Open(db_path()));
+    ASSERT_TRUE(db_.Execute("CREATE TABLE foo (a)"));
+    ASSERT_TRUE(db_.Execute("INSERT INTO foo (a) VALUES (1)"));
+  }
+
+  void TearDown() {
+    db_.Close();
+  }
+
+  sql::Connection& db() { return db_; }
+
+  FilePath db_path() {
+    return temp_dir_.path().AppendASCII("SQLReaderPoolTest.db");
+  }
+
+ private:
+  MessageLoop message_loop_;
+  ScopedTempDir temp_dir_;
+  sql::Connection db_;
+};
+
+TEST_F(SQLReaderPoolTest, ReadsAlongsideWrites) {
+  sql::ReaderPool pool;
+  ASSERT_TRUE(pool.Init(db_path(), 2));
+
+  // The reads see the last commit, and don't wait for the transaction.
+  sql::Transaction transaction(&db());
+  ASSERT_TRUE(transaction.Begin());
+  ASSERT_TRUE(db().Execute("INSERT INTO foo (a) VALUES (2)"));
+
+  const int kReads = 3;
+  ReadResult results[kReads];
+  int replies_left = kReads;
+  for (int i = 0; i < kReads; ++i) {
+    ASSERT_TRUE(pool.PostRead(FROM_HERE,
+                              base::Bind(&CountRows, &results[i]),
+                              base::Bind(&QuitAfter, &replies_left)));
+  }
+  MessageLoop::current()->Run();
+  ASSERT_TRUE(transaction.Commit());
+
+  for (int i = 0; i < kReads; ++i) {
+    EXPECT_EQ(1, results[i].rows);
+    EXPECT_EQ(SQLITE_READONLY, results[i].insert_error);
+  }
+}
+
+TEST_F(SQLReaderPoolTest, NotInitialized) {
+  sql::ReaderPool pool;
+  ReadResult result;
+  EXPECT_FALSE(pool.PostRead(FROM_HERE,
+                             base::Bind(&CountRows, &result),
+                             base::Bind(&base::DoNothing)));
+}
+
+}  // namespace
@@ -22,6 +22,8 @@
         'init_status.h',
         'meta_table.cc',
         'meta_table.h',
+        'reader_pool.cc',
+        'reader_pool.h',
         'statement.cc',
         'statement.h',
         'transaction.cc',
@@ -39,6 +41,7 @@
       'sources': [
         'run_all_unittests.cc',
         'connection_unittest.cc',
+        'reader_pool_unittest.cc',
         'sqlite_features_unittest.cc',
         'statement_unittest.cc',
         'transaction_unittest.cc',
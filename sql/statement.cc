@@ -4,6 +4,7 @@
 
 #include "sql/statement.h"
 
+#include "base/debug/trace_event.h"
 #include "base/logging.h"
 #include "base/string_util.h"
 #include "base/utf_string_conversions.h"
@@ -51,14 +52,35 @@ bool Statement::Run() {
   if (!CheckValid())
     return false;
 
-  return CheckError(sqlite3_step(ref_->stmt())) == SQLITE_DONE;
+  return StepInternal() == SQLITE_DONE;
 }
 
 bool Statement::Step() {
   if (!CheckValid())
     return false;
 
-  return CheckError(sqlite3_step(ref_->stmt())) == SQLITE_ROW;
+  return StepInternal() == SQLITE_ROW;
+}
+
+int Statement::StepInternal() {
+  StatementProfile* profile = ref_->profile();
+  if (!profile)
+    return CheckError(sqlite3_step(ref_->stmt()));
+
+  TRACE_EVENT1("sql", "Statement::Step",
+               "sql", TRACE_STR_COPY(sqlite3_sql(ref_->stmt())));
+  base::TimeTicks start = base::TimeTicks::Now();
+  int err = sqlite3_step(ref_->stmt());
+  base::TimeDelta step_time = base::TimeTicks::Now() - start;
+
+  ++profile->steps;
+  if (err == SQLITE_ROW)
+    ++profile->rows;
+  profile->step_time += step_time;
+  profile->full_scan_steps += sqlite3_stmt_status(
+      ref_->stmt(), SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+  ref_->connection()->RecordStepTime(step_time);
+  return CheckError(err);
 }
 
 void Statement::Reset(bool clear_bound_vars) {
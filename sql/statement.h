@@ -156,6 +156,10 @@ class SQL_EXPORT Statement {
   // enhanced in the future to do the notification.
   int CheckError(int err);
 
+  // Steps the statement, keeping its profile if it has one, and returns the
+  // result after checking it with CheckError().
+  int StepInternal();
+
   // Contraction for checking an error code against SQLITE_OK. Does not set the
   // succeeded flag.
   bool CheckOk(int err) const;
@@ -7,6 +7,7 @@
 #include "base/basictypes.h"
 #include "base/bind.h"
 #include "base/bind_helpers.h"
+#include "base/debug/trace_event.h"
 #include "sync/sessions/status_controller.h"
 #include "sync/sessions/sync_session.h"
 
@@ -32,6 +33,12 @@ SyncerError ModelChangingSyncerCommand::ExecuteImpl(
       continue;
     }
 
+    // Together with the event in StartChangingModel(), this shows how long
+    // the group's work waited for the worker's thread.
+    const std::string group_name = ModelSafeGroupToString(group);
+    TRACE_EVENT1("sync", "ModelChangingSyncerCommand::DoWork",
+                 "group", TRACE_STR_COPY(group_name.c_str()));
+
     sessions::StatusController* status =
         work_session_->mutable_status_controller();
     sessions::ScopedModelSafeGroupRestriction r(status, group);
@@ -51,6 +58,14 @@ SyncerError ModelChangingSyncerCommand::ExecuteImpl(
   return result;
 }
 
+SyncerError ModelChangingSyncerCommand::StartChangingModel() {
+  const std::string group_name = ModelSafeGroupToString(
+      work_session_->status_controller().group_restriction());
+  TRACE_EVENT1("sync", "ModelChangingSyncerCommand::StartChangingModel",
+               "group", TRACE_STR_COPY(group_name.c_str()));
+  return ModelChangingExecuteImpl(work_session_);
+}
+
 SyncerError ModelChangingSyncerCommand::ModelNeutralExecuteImpl(
     sessions::SyncSession* session) {
   return SYNCER_OK;
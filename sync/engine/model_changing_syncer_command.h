@@ -35,9 +35,7 @@ class ModelChangingSyncerCommand : public SyncerCommand {
       sessions::SyncSession* session) OVERRIDE;
 
   // Wrapper so implementations don't worry about storing work_session.
-  SyncerError StartChangingModel() {
-    return ModelChangingExecuteImpl(work_session_);
-  }
+  SyncerError StartChangingModel();
 
   std::set<ModelSafeGroup> GetGroupsToChangeForTest(
       const sessions::SyncSession& session) const {
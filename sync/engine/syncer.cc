@@ -229,11 +229,24 @@ void Syncer::SyncShare(sessions::SyncSession* session,
         break;
       }
       case PROCESS_COMMIT_RESPONSE: {
+        StatusController* status = session->mutable_status_controller();
+        int successes_before = status->syncer_status().num_successful_commits;
         ProcessCommitResponseCommand process_response_command;
-        session->mutable_status_controller()->
-            set_last_process_commit_response_result(
-                process_response_command.Execute(session));
-        next_step = RESOLVE_CONFLICTS;
+        SyncerError result = process_response_command.Execute(session);
+        status->set_last_process_commit_response_result(result);
+
+        // If the unsynced items didn't fit in one commit, send the next
+        // batch now rather than leaving it to another sync cycle, which
+        // would first download updates again.  Stop as soon as a batch fails
+        // or commits nothing, so that a stuck item can't keep us here.
+        if (result == SYNCER_OK &&
+            status->syncer_status().num_successful_commits >
+                successes_before &&
+            status->commit_ids().size() < status->unsynced_handles().size()) {
+          next_step = BUILD_COMMIT_REQUEST;
+        } else {
+          next_step = RESOLVE_CONFLICTS;
+        }
         break;
       }
       case RESOLVE_CONFLICTS: {
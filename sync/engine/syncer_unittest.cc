@@ -2713,6 +2713,28 @@ TEST_F(SyncerTest, CommitManyItemsInOneGo) {
   EXPECT_GE(mock_server_->commit_messages().size(), max_batches);
 }
 
+TEST_F(SyncerTest, CommitManyItemsInOneCycle) {
+  uint32 max_batches = 3;
+  uint32 items_to_commit = kDefaultMaxCommitBatchSize * max_batches;
+  {
+    WriteTransaction trans(FROM_HERE, UNITTEST, directory());
+    for (uint32 i = 0; i < items_to_commit; i++) {
+      string nameutf8 = base::StringPrintf("%d", i);
+      string name(nameutf8.begin(), nameutf8.end());
+      MutableEntry e(&trans, CREATE, trans.root_id(), name);
+      e.Put(IS_UNSYNCED, true);
+      e.Put(IS_DIR, true);
+      e.Put(SPECIFICS, DefaultBookmarkSpecifics());
+    }
+  }
+  mock_server_->GetAndClearNumGetUpdatesRequests();
+
+  // All the batches are committed after a single GetUpdates.
+  EXPECT_FALSE(SyncShareNudge());
+  EXPECT_EQ(max_batches, mock_server_->commit_messages().size());
+  EXPECT_EQ(1, mock_server_->GetAndClearNumGetUpdatesRequests());
+}
+
 TEST_F(SyncerTest, HugeConflict) {
   int item_count = 300;  // We should be able to do 300 or 3000 w/o issue.
 
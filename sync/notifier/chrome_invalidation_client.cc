@@ -7,8 +7,10 @@
 #include <string>
 #include <vector>
 
+#include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/logging.h"
+#include "base/message_loop.h"
 #include "base/tracked_objects.h"
 #include "google/cacheinvalidation/include/invalidation-client-factory.h"
 #include "google/cacheinvalidation/include/invalidation-client.h"
@@ -33,7 +35,8 @@ ChromeInvalidationClient::ChromeInvalidationClient()
     : chrome_system_resources_(ALLOW_THIS_IN_INITIALIZER_LIST(this)),
       listener_(NULL),
       state_writer_(NULL),
-      ticl_ready_(false) {
+      ticl_ready_(false),
+      ALLOW_THIS_IN_INITIALIZER_LIST(weak_ptr_factory_(this)) {
   DCHECK(non_thread_safe_.CalledOnValidThread());
 }
 
@@ -121,6 +124,8 @@ void ChromeInvalidationClient::Stop() {
   invalidation_client_->Stop();
 
   invalidation_client_.reset();
+  weak_ptr_factory_.InvalidateWeakPtrs();
+  pending_invalidations_.clear();
   state_writer_ = NULL;
   listener_ = NULL;
 
@@ -232,8 +237,22 @@ void ChromeInvalidationClient::InvalidateAll(
 void ChromeInvalidationClient::EmitInvalidation(
     syncable::ModelTypeSet types, const std::string& payload) {
   DCHECK(non_thread_safe_.CalledOnValidThread());
-  syncable::ModelTypePayloadMap type_payloads =
-      syncable::ModelTypePayloadMapFromEnumSet(types, payload);
+  if (!weak_ptr_factory_.HasWeakPtrs()) {
+    MessageLoop::current()->PostTask(
+        FROM_HERE,
+        base::Bind(&ChromeInvalidationClient::EmitPendingInvalidations,
+                   weak_ptr_factory_.GetWeakPtr()));
+  }
+  syncable::CoalescePayloads(
+      &pending_invalidations_,
+      syncable::ModelTypePayloadMapFromEnumSet(types, payload));
+}
+
+void ChromeInvalidationClient::EmitPendingInvalidations() {
+  DCHECK(non_thread_safe_.CalledOnValidThread());
+  weak_ptr_factory_.InvalidateWeakPtrs();
+  syncable::ModelTypePayloadMap type_payloads;
+  type_payloads.swap(pending_invalidations_);
   listener_->OnInvalidate(type_payloads);
 }
 
@@ -116,9 +116,15 @@ class ChromeInvalidationClient
  private:
   friend class ChromeInvalidationClientTest;
 
+  // Adds |types| with |payload| to the invalidations to send to
+  // |listener_| once the current task is done. The invalidations of a
+  // packet arrive in the same task, so they reach the listener, and
+  // cause a sync, together rather than one at a time.
   void EmitInvalidation(
       syncable::ModelTypeSet types, const std::string& payload);
 
+  void EmitPendingInvalidations();
+
   base::NonThreadSafe non_thread_safe_;
   ChromeSystemResources chrome_system_resources_;
   InvalidationVersionMap max_invalidation_versions_;
@@ -133,6 +139,9 @@ class ChromeInvalidationClient
   // Stored to pass to |registration_manager_| on start.
   syncable::ModelTypeSet registered_types_;
   bool ticl_ready_;
+  syncable::ModelTypePayloadMap pending_invalidations_;
+  // Only has weak pointers while EmitPendingInvalidations() is posted.
+  base::WeakPtrFactory<ChromeInvalidationClient> weak_ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(ChromeInvalidationClient);
 };
@@ -111,12 +111,14 @@ class ChromeInvalidationClientTest : public testing::Test {
     EXPECT_CALL(mock_invalidation_client_, Acknowledge(ack_handle));
     client_.InvalidateUnknownVersion(&mock_invalidation_client_, object_id,
                                      ack_handle);
+    message_loop_.RunAllPending();
   }
 
   void FireInvalidateAll() {
     invalidation::AckHandle ack_handle("fakedata");
     EXPECT_CALL(mock_invalidation_client_, Acknowledge(ack_handle));
     client_.InvalidateAll(&mock_invalidation_client_, ack_handle);
+    message_loop_.RunAllPending();
   }
 
   MessageLoop message_loop_;
@@ -253,6 +255,37 @@ TEST_F(ChromeInvalidationClientTest, InvalidateVersionMultipleTypes) {
   FireInvalidate("APP", 4, NULL);
 }
 
+TEST_F(ChromeInvalidationClientTest, InvalidateBatched) {
+  syncable::ModelTypePayloadMap type_payloads;
+  type_payloads[syncable::APPS] = "payload";
+  type_payloads[syncable::EXTENSIONS] = "";
+  EXPECT_CALL(mock_listener_, OnInvalidate(type_payloads));
+
+  // Invalidations received in the same task should be sent together.
+  invalidation::AckHandle ack_handle("fakedata");
+  EXPECT_CALL(mock_invalidation_client_, Acknowledge(ack_handle)).Times(3);
+  client_.InvalidateUnknownVersion(
+      &mock_invalidation_client_,
+      invalidation::ObjectId(ipc::invalidation::ObjectSource::CHROME_SYNC,
+                             "APP"),
+      ack_handle);
+  client_.InvalidateUnknownVersion(
+      &mock_invalidation_client_,
+      invalidation::ObjectId(ipc::invalidation::ObjectSource::CHROME_SYNC,
+                             "EXTENSION"),
+      ack_handle);
+  EXPECT_CALL(mock_invalidation_version_tracker_,
+              SetMaxVersion(syncable::APPS, 1));
+  client_.Invalidate(
+      &mock_invalidation_client_,
+      invalidation::Invalidation(
+          invalidation::ObjectId(ipc::invalidation::ObjectSource::CHROME_SYNC,
+                                 "APP"),
+          1, "payload"),
+      ack_handle);
+  message_loop_.RunAllPending();
+}
+
 TEST_F(ChromeInvalidationClientTest, InvalidateAll) {
   syncable::ModelTypeSet types(syncable::PREFERENCES, syncable::EXTENSIONS);
   client_.RegisterTypes(types);
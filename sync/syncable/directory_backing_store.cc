@@ -40,34 +40,52 @@ static const string::size_type kUpdateStatementBufferSize = 2048;
 extern const int32 kCurrentDBVersion;  // Global visibility for our unittest.
 const int32 kCurrentDBVersion = 78;
 
-// Iterate over the fields of |entry| and bind each to |statement| for
-// updating.  Returns the number of args bound.
-void BindFields(const EntryKernel& entry,
-                sql::Statement* statement) {
+// Iterate over the fields of |entry|, or if |dirty_only| its dirty fields
+// other than META_HANDLE, and bind each to |statement| for updating.  Returns
+// the number of args bound.
+int BindFields(const EntryKernel& entry,
+               bool dirty_only,
+               sql::Statement* statement) {
+  EntryKernel::FieldSet fields = entry.dirty_fields();
+  if (dirty_only)
+    fields.reset(META_HANDLE);
+  else
+    fields.set();
   int index = 0;
   int i = 0;
   for (i = BEGIN_FIELDS; i < INT64_FIELDS_END; ++i) {
-    statement->BindInt64(index++, entry.ref(static_cast<Int64Field>(i)));
+    if (fields[i])
+      statement->BindInt64(index++, entry.ref(static_cast<Int64Field>(i)));
   }
   for ( ; i < TIME_FIELDS_END; ++i) {
-    statement->BindInt64(index++,
-                         browser_sync::TimeToProtoTime(
-                             entry.ref(static_cast<TimeField>(i))));
+    if (fields[i]) {
+      statement->BindInt64(index++,
+                           browser_sync::TimeToProtoTime(
+                               entry.ref(static_cast<TimeField>(i))));
+    }
   }
   for ( ; i < ID_FIELDS_END; ++i) {
-    statement->BindString(index++, entry.ref(static_cast<IdField>(i)).s_);
+    if (fields[i])
+      statement->BindString(index++, entry.ref(static_cast<IdField>(i)).s_);
   }
   for ( ; i < BIT_FIELDS_END; ++i) {
-    statement->BindInt(index++, entry.ref(static_cast<BitField>(i)));
+    if (fields[i])
+      statement->BindInt(index++, entry.ref(static_cast<BitField>(i)));
   }
   for ( ; i < STRING_FIELDS_END; ++i) {
-    statement->BindString(index++, entry.ref(static_cast<StringField>(i)));
+    if (fields[i]) {
+      statement->BindString(index++,
+                            entry.ref(static_cast<StringField>(i)));
+    }
   }
   std::string temp;
   for ( ; i < PROTO_FIELDS_END; ++i) {
-    entry.ref(static_cast<ProtoField>(i)).SerializeToString(&temp);
-    statement->BindBlob(index++, temp.data(), temp.length());
+    if (fields[i]) {
+      entry.ref(static_cast<ProtoField>(i)).SerializeToString(&temp);
+      statement->BindBlob(index++, temp.data(), temp.length());
+    }
   }
+  return index;
 }
 
 // The caller owns the returned EntryKernel*.  Assumes the statement currently
@@ -98,6 +116,8 @@ EntryKernel* UnpackEntry(sql::Statement* statement) {
     kernel->mutable_ref(static_cast<ProtoField>(i)).ParseFromArray(
         statement->ColumnBlob(i), statement->ColumnByteLength(i));
   }
+  // Nothing has changed since the entry was saved.
+  kernel->clear_dirty(NULL);
   return kernel;
 }
 
@@ -473,6 +493,25 @@ bool DirectoryBackingStore::LoadInfo(Directory::KernelLoadInfo* info) {
 }
 
 bool DirectoryBackingStore::SaveEntryToDB(const EntryKernel& entry) {
+  // Entries which were loaded are usually saved for a few changed fields,
+  // so only those columns are updated rather than the whole row, specifics
+  // included. A new entry, or one whose changes aren't known, is written
+  // whole.
+  EntryKernel::FieldSet fields = entry.dirty_fields();
+  fields.reset(META_HANDLE);
+  if (fields.none() || fields.count() == fields.size() - 1)
+    return SaveNewEntryToDB(entry);
+
+  if (!UpdateEntryToDB(entry))
+    return false;
+  if (db_->GetLastChangeCount() > 0)
+    return true;
+
+  // The entry was never saved.
+  return SaveNewEntryToDB(entry);
+}
+
+bool DirectoryBackingStore::SaveNewEntryToDB(const EntryKernel& entry) {
   // This statement is constructed at runtime, so we can't use
   // GetCachedStatement() to let the Connection cache it.   We will construct
   // and cache it ourselves the first time this function is called.
@@ -502,10 +541,43 @@ bool DirectoryBackingStore::SaveEntryToDB(const EntryKernel& entry) {
     save_entry_statement_.Reset(true);
   }
 
-  BindFields(entry, &save_entry_statement_);
+  BindFields(entry, false, &save_entry_statement_);
   return save_entry_statement_.Run();
 }
 
+bool DirectoryBackingStore::UpdateEntryToDB(const EntryKernel& entry) {
+  EntryKernel::FieldSet fields = entry.dirty_fields();
+  fields.reset(META_HANDLE);
+
+  string query;
+  query.reserve(kUpdateStatementBufferSize);
+  query.append("UPDATE metas SET ");
+  const char* separator = "";
+  for (int i = BEGIN_FIELDS; i < PROTO_FIELDS_END; ++i) {
+    if (!fields[i])
+      continue;
+    query.append(separator);
+    separator = ", ";
+    query.append(ColumnName(i));
+    query.append(" = ?");
+  }
+  query.append(" WHERE metahandle = ?");
+
+  // A batch of changes usually touches the same few sets of columns, so the
+  // statement for each set is kept, keyed by its text.
+  linked_ptr<sql::Statement>& statement = update_entry_statements_[query];
+  if (!statement.get()) {
+    statement.reset(new sql::Statement(
+        db_->GetUniqueStatement(query.c_str())));
+  } else {
+    statement->Reset(true);
+  }
+
+  int index = BindFields(entry, true, statement.get());
+  statement->BindInt64(index, entry.ref(META_HANDLE));
+  return statement->Run();
+}
+
 bool DirectoryBackingStore::DropDeletedEntries() {
   return db_->Execute("DELETE FROM metas "
                       "WHERE is_del > 0 "
@@ -6,8 +6,10 @@
 #define SYNC_SYNCABLE_DIRECTORY_BACKING_STORE_H_
 #pragma once
 
+#include <map>
 #include <string>
 
+#include "base/memory/linked_ptr.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/non_thread_safe.h"
 #include "sql/connection.h"
@@ -94,6 +96,8 @@ class DirectoryBackingStore : public base::NonThreadSafe {
   bool LoadInfo(Directory::KernelLoadInfo* info);
 
   // Save/update helpers for entries.  Return false if sqlite commit fails.
+  // SaveEntryToDB() updates the dirty fields of the entry's row, or writes
+  // the whole row.
   bool SaveEntryToDB(const EntryKernel& entry);
   bool SaveNewEntryToDB(const EntryKernel& entry);
   bool UpdateEntryToDB(const EntryKernel& entry);
@@ -152,6 +156,8 @@ class DirectoryBackingStore : public base::NonThreadSafe {
 
   scoped_ptr<sql::Connection> db_;
   sql::Statement save_entry_statement_;
+  // The statements of UpdateEntryToDB(), keyed by their text.
+  std::map<std::string, linked_ptr<sql::Statement> > update_entry_statements_;
   std::string dir_name_;
 
   // Set to true if migration left some old columns around that need to be
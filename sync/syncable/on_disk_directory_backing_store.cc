@@ -14,6 +14,7 @@ OnDiskDirectoryBackingStore::OnDiskDirectoryBackingStore(
       backing_filepath_(backing_filepath) {
   db_->set_exclusive_locking();
   db_->set_page_size(4096);
+  db_->set_write_ahead_log();
 }
 
 DirOpenResult OnDiskDirectoryBackingStore::Load(
@@ -200,7 +200,7 @@ namespace {
 // before updating the field.
 //
 // This class is parameterized on the Indexer traits type, which
-// must define a Comparator and a static bool ShouldInclude
+// must define a Comparator or Key and a static bool ShouldInclude
 // function for testing whether the item ought to be included
 // in the index.
 template<typename Indexer>
@@ -985,6 +985,7 @@ void Directory::HandleSaveChangesFailure(const SaveChangesSnapshot& snapshot) {
         kernel_->metahandles_index->find(&kernel_->needle);
     if (found != kernel_->metahandles_index->end()) {
       (*found)->mark_dirty(kernel_->dirty_metahandles);
+      (*found)->mark_fields_dirty(i->dirty_fields());
     }
   }
 
@@ -21,6 +21,7 @@
 #include "base/compiler_specific.h"
 #include "base/file_path.h"
 #include "base/gtest_prod_util.h"
+#include "base/hash_tables.h"
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted.h"
@@ -260,6 +261,10 @@ enum UnlinkReason {
 
 // The EntryKernel class contains the actual data for an entry.
 struct EntryKernel {
+ public:
+  // One bit per persisted field, see dirty_fields().
+  typedef std::bitset<FIELD_COUNT> FieldSet;
+
  private:
   std::string string_fields[STRING_FIELDS_COUNT];
   sync_pb::EntitySpecifics specifics_fields[PROTO_FIELDS_COUNT];
@@ -284,27 +289,43 @@ struct EntryKernel {
     dirty_ = true;
   }
 
-  // Clear the dirty bit, and optionally remove this entry's metahandle from
-  // a provided index on dirty bits in |dirty_index|. Parameter may be null,
-  // and will result only in clearing dirty bit of this entry.
+  // Clear the dirty bit and the dirty fields, and optionally remove this
+  // entry's metahandle from a provided index on dirty bits in |dirty_index|.
+  // Parameter may be null, and will result only in clearing dirty bit of this
+  // entry.
   inline void clear_dirty(syncable::MetahandleSet* dirty_index) {
     if (dirty_ && dirty_index) {
       DCHECK_NE(0, ref(META_HANDLE));
       dirty_index->erase(ref(META_HANDLE));
     }
     dirty_ = false;
+    dirty_fields_.reset();
   }
 
   inline bool is_dirty() const {
     return dirty_;
   }
 
+  // The persisted fields which were put, or handed out by mutable_ref(),
+  // since the dirty bit was last cleared. Saving the entry only needs to
+  // write these columns.
+  inline const FieldSet& dirty_fields() const {
+    return dirty_fields_;
+  }
+
+  // Adds |fields| to the dirty fields, for when a save of them failed.
+  inline void mark_fields_dirty(const FieldSet& fields) {
+    dirty_fields_ |= fields;
+  }
+
   // Setters.
   inline void put(MetahandleField field, int64 value) {
     int64_fields[field - INT64_FIELDS_BEGIN] = value;
+    dirty_fields_.set(field);
   }
   inline void put(Int64Field field, int64 value) {
     int64_fields[field - INT64_FIELDS_BEGIN] = value;
+    dirty_fields_.set(field);
   }
   inline void put(TimeField field, const base::Time& value) {
     // Round-trip to proto time format and back so that we have
@@ -312,27 +333,35 @@ struct EntryKernel {
     time_fields[field - TIME_FIELDS_BEGIN] =
         browser_sync::ProtoTimeToTime(
             browser_sync::TimeToProtoTime(value));
+    dirty_fields_.set(field);
   }
   inline void put(IdField field, const Id& value) {
     id_fields[field - ID_FIELDS_BEGIN] = value;
+    dirty_fields_.set(field);
   }
   inline void put(BaseVersion field, int64 value) {
     int64_fields[field - INT64_FIELDS_BEGIN] = value;
+    dirty_fields_.set(field);
   }
   inline void put(IndexedBitField field, bool value) {
     bit_fields[field - BIT_FIELDS_BEGIN] = value;
+    dirty_fields_.set(field);
   }
   inline void put(IsDelField field, bool value) {
     bit_fields[field - BIT_FIELDS_BEGIN] = value;
+    dirty_fields_.set(field);
   }
   inline void put(BitField field, bool value) {
     bit_fields[field - BIT_FIELDS_BEGIN] = value;
+    dirty_fields_.set(field);
   }
   inline void put(StringField field, const std::string& value) {
     string_fields[field - STRING_FIELDS_BEGIN] = value;
+    dirty_fields_.set(field);
   }
   inline void put(ProtoField field, const sync_pb::EntitySpecifics& value) {
     specifics_fields[field - PROTO_FIELDS_BEGIN].CopyFrom(value);
+    dirty_fields_.set(field);
   }
   inline void put(BitTemp field, bool value) {
     bit_temps[field - BIT_TEMPS_BEGIN] = value;
@@ -375,12 +404,15 @@ struct EntryKernel {
 
   // Non-const, mutable ref getters for object types only.
   inline std::string& mutable_ref(StringField field) {
+    dirty_fields_.set(field);
     return string_fields[field - STRING_FIELDS_BEGIN];
   }
   inline sync_pb::EntitySpecifics& mutable_ref(ProtoField field) {
+    dirty_fields_.set(field);
     return specifics_fields[field - PROTO_FIELDS_BEGIN];
   }
   inline Id& mutable_ref(IdField field) {
+    dirty_fields_.set(field);
     return id_fields[field - ID_FIELDS_BEGIN];
   }
 
@@ -393,6 +425,9 @@ struct EntryKernel {
  private:
   // Tracks whether this entry needs to be saved to the database.
   bool dirty_;
+
+  // Tracks which of its fields changed, see dirty_fields().
+  FieldSet dirty_fields_;
 };
 
 // A read-only meta entry.
@@ -658,14 +693,16 @@ base::ListValue* EntryKernelMutationMapToValue(
 // The indices follow a common pattern:
 //   (a) The index allows efficient lookup of an Entry* with particular
 //       field values.  This is done by use of a std::set<> and a custom
-//       comparator.
+//       comparator, or for fields which are only ever looked up by value, a
+//       HashedIndex and a Key function.
 //   (b) There may be conditions for inclusion in the index -- for example,
 //       deleted items might not be indexed.
 //   (c) Because the index set contains only Entry*, one must be careful
 //       to remove Entries from the set before updating the value of
 //       an indexed field.
-// The traits of an index are a Comparator (to define the set ordering) and a
-// ShouldInclude function (to define the conditions for inclusion).  For each
+// The traits of an index are a Comparator (to define the set ordering) or a
+// Key function (to define the hashed value), and a ShouldInclude function (to
+// define the conditions for inclusion).  For each
 // index, the traits are grouped into a class called an Indexer which
 // can be used as a template type parameter.
 
@@ -683,7 +720,9 @@ struct MetahandleIndexer {
 // Traits type for ID field index.
 struct IdIndexer {
   // This index is of the ID field values.
-  typedef LessField<IdField, ID> Comparator;
+  static const std::string& Key(const EntryKernel* a) {
+    return a->ref(ID).value();
+  }
 
   // This index includes all entries.
   inline static bool ShouldInclude(const EntryKernel* a) {
@@ -694,7 +733,9 @@ struct IdIndexer {
 // Traits type for unique client tag index.
 struct ClientTagIndexer {
   // This index is of the client-tag values.
-  typedef LessField<StringField, UNIQUE_CLIENT_TAG> Comparator;
+  static const std::string& Key(const EntryKernel* a) {
+    return a->ref(UNIQUE_CLIENT_TAG);
+  }
 
   // Items are only in this index if they have a non-empty client tag value.
   static bool ShouldInclude(const EntryKernel* a);
@@ -715,6 +756,60 @@ struct ParentIdAndHandleIndexer {
   static bool ShouldInclude(const EntryKernel* a);
 };
 
+// An index of entries by a string field, in a hash table rather than a
+// std::set, so that a lookup hashes the value once instead of comparing it
+// with log(n) others.  It has the part of the std::set interface which the
+// Directory uses, with the entries keyed by |Indexer::Key()|.
+template <typename Indexer>
+class HashedIndex {
+ private:
+  typedef base::hash_map<std::string, EntryKernel*> Map;
+
+ public:
+  class iterator {
+   public:
+    iterator() {}
+    explicit iterator(const typename Map::iterator& it) : it_(it) {}
+
+    EntryKernel* operator*() const { return it_->second; }
+    iterator& operator++() {
+      ++it_;
+      return *this;
+    }
+    bool operator==(const iterator& other) const { return it_ == other.it_; }
+    bool operator!=(const iterator& other) const { return it_ != other.it_; }
+
+   private:
+    typename Map::iterator it_;
+  };
+
+  iterator begin() { return iterator(map_.begin()); }
+  iterator end() { return iterator(map_.end()); }
+  size_t size() const { return map_.size(); }
+  bool empty() const { return map_.empty(); }
+
+  // Like std::set, entries are found, counted and erased by their key, so
+  // |entry| can be a needle.
+  std::pair<iterator, bool> insert(EntryKernel* entry) {
+    std::pair<typename Map::iterator, bool> result =
+        map_.insert(std::make_pair(Indexer::Key(entry), entry));
+    return std::make_pair(iterator(result.first), result.second);
+  }
+  iterator find(const EntryKernel* entry) {
+    return iterator(map_.find(Indexer::Key(entry)));
+  }
+  size_t count(const EntryKernel* entry) const {
+    return map_.count(Indexer::Key(entry));
+  }
+  size_t erase(const EntryKernel* entry) {
+    return map_.erase(Indexer::Key(entry));
+  }
+  void clear() { map_.clear(); }
+
+ private:
+  Map map_;
+};
+
 // Given an Indexer providing the semantics of an index, defines the
 // set type used to actually contain the index.
 template <typename Indexer>
@@ -722,6 +817,17 @@ struct Index {
   typedef std::set<EntryKernel*, typename Indexer::Comparator> Set;
 };
 
+// The IDs and client tags are only ever looked up by value.
+template <>
+struct Index<IdIndexer> {
+  typedef HashedIndex<IdIndexer> Set;
+};
+
+template <>
+struct Index<ClientTagIndexer> {
+  typedef HashedIndex<ClientTagIndexer> Set;
+};
+
 // The name Directory in this case means the entire directory
 // structure within a single user account.
 //
@@ -115,8 +115,9 @@ class Id {
 
  private:
   friend EntryKernel* UnpackEntry(sql::Statement* statement);
-  friend void BindFields(const EntryKernel& entry,
-                         sql::Statement* statement);
+  friend int BindFields(const EntryKernel& entry,
+                        bool dirty_only,
+                        sql::Statement* statement);
   friend std::ostream& operator<<(std::ostream& out, const Id& id);
   friend class MockConnectionManager;
   friend class SyncableIdTest;
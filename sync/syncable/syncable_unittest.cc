@@ -1401,6 +1401,52 @@ TEST_F(OnDiskSyncableDirectoryTest,
   }
 }
 
+// Changes to an entry which was saved before only update their columns.
+TEST_F(OnDiskSyncableDirectoryTest, TestSaveChangesOfDirtyFields) {
+  int64 handle = 0;
+  sync_pb::EntitySpecifics specifics;
+  specifics.mutable_bookmark()->set_url("http://nowhere");
+  {
+    WriteTransaction trans(FROM_HERE, UNITTEST, dir_.get());
+    MutableEntry e(&trans, CREATE, trans.root_id(), "name");
+    ASSERT_TRUE(e.good());
+    handle = e.Get(META_HANDLE);
+    e.Put(SPECIFICS, specifics);
+  }
+  ASSERT_TRUE(dir_->SaveChanges());
+
+  {
+    WriteTransaction trans(FROM_HERE, UNITTEST, dir_.get());
+    MutableEntry e(&trans, GET_BY_HANDLE, handle);
+    ASSERT_TRUE(e.good());
+    EXPECT_TRUE(e.GetKernelCopy().dirty_fields().none());
+    e.Put(NON_UNIQUE_NAME, "renamed");
+    e.Put(IS_UNSYNCED, true);
+    EntryKernel::FieldSet dirty_fields = e.GetKernelCopy().dirty_fields();
+    EXPECT_EQ(2U, dirty_fields.count());
+    EXPECT_TRUE(dirty_fields[NON_UNIQUE_NAME]);
+    EXPECT_TRUE(dirty_fields[IS_UNSYNCED]);
+  }
+  ASSERT_TRUE(dir_->SaveChanges());
+
+  dir_.reset(new Directory(&encryptor_, &handler_, NULL));
+  ASSERT_TRUE(dir_.get());
+  ASSERT_EQ(OPENED, dir_->Open(file_path_, kName,
+                               &delegate_, NullTransactionObserver()));
+  ASSERT_TRUE(dir_->good());
+
+  {
+    ReadTransaction trans(FROM_HERE, dir_.get());
+    Entry e(&trans, GET_BY_HANDLE, handle);
+    ASSERT_TRUE(e.good());
+    EXPECT_EQ("renamed", e.Get(NON_UNIQUE_NAME));
+    EXPECT_TRUE(e.Get(IS_UNSYNCED));
+    EXPECT_EQ(specifics.SerializeAsString(),
+              e.Get(SPECIFICS).SerializeAsString());
+    EXPECT_TRUE(e.GetKernelCopy().dirty_fields().none());
+  }
+}
+
 TEST_F(OnDiskSyncableDirectoryTest, TestSaveChangesFailure) {
   int64 handle1 = 0;
   // Set up an item using a regular, saveable directory.
@@ -463,13 +463,14 @@ class CCGenerator(object):
 
     if self._IsFundamentalOrFundamentalRef(prop):
       if prop.optional:
-        (c.Append('%(ctype)s temp;')
+        # Read straight into the new member rather than copying it there.
+        (c.Append('scoped_ptr<%(ctype)s> temp(new %(ctype)s());')
           .Append('if (%s)' %
               cpp_util.GetAsFundamentalValue(
                   self._cpp_type_generator.GetReferencedProperty(prop),
                   value_var,
-                  '&temp'))
-          .Append('  %(dst)s->%(name)s.reset(new %(ctype)s(temp));')
+                  'temp.get()'))
+          .Append('  %(dst)s->%(name)s = temp.Pass();')
         )
       else:
         (c.Append('if (!%s)' %
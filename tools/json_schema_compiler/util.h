@@ -51,6 +51,7 @@ template <class T>
 bool PopulateArrayFromList(
     const base::ListValue& list, std::vector<T>* out) {
   out->clear();
+  out->reserve(list.GetSize());
   T value;
   for (size_t i = 0; i < list.GetSize(); ++i) {
     if (!GetItemFromList(list, i, &value))
@@ -83,6 +84,7 @@ bool PopulateOptionalArrayFromList(
     const base::ListValue& list,
     scoped_ptr<std::vector<T> >* out) {
   out->reset(new std::vector<T>());
+  (*out)->reserve(list.GetSize());
   T value;
   for (size_t i = 0; i < list.GetSize(); ++i) {
     if (!GetItemFromList(list, i, &value)) {
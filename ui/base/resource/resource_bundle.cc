@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "base/command_line.h"
+#include "base/debug/trace_event.h"
 #include "base/file_util.h"
 #include "base/logging.h"
 #include "base/memory/ref_counted_memory.h"
@@ -15,6 +16,7 @@
 #include "base/stl_util.h"
 #include "base/string_piece.h"
 #include "base/synchronization/lock.h"
+#include "base/time.h"
 #include "base/utf_string_conversions.h"
 #include "build/build_config.h"
 #include "third_party/skia/include/core/SkBitmap.h"
@@ -163,12 +165,15 @@ void ResourceBundle::LoadTestResources(const FilePath& path) {
     data_packs_.push_back(data_pack.release());
 
   data_pack.reset(new DataPack(ResourceHandle::kScaleFactor100x));
-  if (data_pack->Load(path))
+  if (data_pack->Load(path)) {
     locale_resources_data_.reset(data_pack.release());
+    decoded_strings_.clear();
+  }
 }
 
 void ResourceBundle::UnloadLocaleResources() {
   locale_resources_data_.reset();
+  decoded_strings_.clear();
 }
 
 string16 ResourceBundle::GetLocalizedString(int message_id) {
@@ -183,8 +188,14 @@ string16 ResourceBundle::GetLocalizedString(int message_id) {
     return string16();
   }
 
+  StringMap::const_iterator decoded = decoded_strings_.find(message_id);
+  if (decoded != decoded_strings_.end())
+    return decoded->second;
+
   base::StringPiece data;
-  if (!locale_resources_data_->GetStringPiece(message_id, &data)) {
+  bool in_locale_resources =
+      locale_resources_data_->GetStringPiece(message_id, &data);
+  if (!in_locale_resources) {
     // Fall back on the main data pack (shouldn't be any strings here except in
     // unittests).
     data = GetRawDataResource(message_id);
@@ -207,6 +218,11 @@ string16 ResourceBundle::GetLocalizedString(int message_id) {
                    data.length() / 2);
   } else if (encoding == ResourceHandle::UTF8) {
     msg = UTF8ToUTF16(data);
+    // UTF-16 strings are a single copy out of the pack, but UTF-8 ones need
+    // converting, which UI code asking for the same strings over and over
+    // would otherwise redo every time.
+    if (in_locale_resources)
+      decoded_strings_[message_id] = msg;
   }
   return msg;
 }
@@ -241,12 +257,19 @@ gfx::Image& ResourceBundle::GetImageNamed(int resource_id) {
   }
 
   DCHECK(!data_packs_.empty()) << "Missing call to SetResourcesDataDLL?";
+  TRACE_EVENT1("ui", "ResourceBundle::GetImageNamed",
+               "resource_id", resource_id);
+  base::TimeTicks decode_start = base::TimeTicks::Now();
   ScopedVector<const SkBitmap> bitmaps;
   for (size_t i = 0; i < data_packs_.size(); ++i) {
     SkBitmap* bitmap = LoadBitmap(*data_packs_[i], resource_id);
     if (bitmap)
       bitmaps.push_back(bitmap);
   }
+  // Images are decoded once at every scale factor and kept for the life of
+  // the process, so this is where their cost on startup shows.
+  UMA_HISTOGRAM_TIMES("ResourceBundle.ImageDecodeTime",
+                      base::TimeTicks::Now() - decode_start);
 
   if (bitmaps.empty()) {
     LOG(WARNING) << "Unable to load image with id " << resource_id;
@@ -193,13 +193,18 @@ class UI_EXPORT ResourceBundle {
   // Protects |images_| and font-related members.
   scoped_ptr<base::Lock> images_and_fonts_lock_;
 
-  // Protects |locale_resources_data_|.
+  // Protects |locale_resources_data_| and |decoded_strings_|.
   scoped_ptr<base::Lock> locale_resources_data_lock_;
 
   // Handles for data sources.
   scoped_ptr<ResourceHandle> locale_resources_data_;
   ScopedVector<ResourceHandle> data_packs_;
 
+  // The strings of a UTF-8 |locale_resources_data_| that have been converted
+  // to UTF-16, so that each is only converted once.
+  typedef std::map<int, string16> StringMap;
+  StringMap decoded_strings_;
+
   // Cached images. The ResourceBundle caches all retrieved images and keeps
   // ownership of the pointers.
   typedef std::map<int, gfx::Image*> ImageMap;
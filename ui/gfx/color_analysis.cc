@@ -17,6 +17,10 @@ const int kNumberOfIterations = 50;
 const uint32_t kMaxBrightness = 600;
 const uint32_t kMinDarkness = 100;
 
+// The most pixels assigned to clusters per iteration. Larger images are
+// sampled evenly, which also keeps the cluster sums from overflowing.
+const int kMaxSampledPixels = 256 * 256;
+
 // Background Color Modification Constants
 const SkColor kDefaultBgColor = SK_ColorWHITE;
 
@@ -195,6 +199,10 @@ SkColor CalculateKMeanColorOfPNG(scoped_refptr<base::RefCountedMemory> png,
                             &decoded_data,
                             &img_width,
                             &img_height)) {
+    const int pixel_count = img_width * img_height;
+    const int pixel_step =
+        (pixel_count + kMaxSampledPixels - 1) / kMaxSampledPixels;
+
     std::vector<KMeanCluster> clusters;
     clusters.resize(kNumberOfClusters, KMeanCluster());
 
@@ -205,8 +213,7 @@ SkColor CalculateKMeanColorOfPNG(scoped_refptr<base::RefCountedMemory> png,
       // found, destroy this cluster.
       bool color_unique = false;
       for (int i = 0; i < 10; ++i) {
-        int pixel_pos = sampler.GetSample(img_width, img_height) %
-            (img_width * img_height);
+        int pixel_pos = sampler.GetSample(img_width, img_height) % pixel_count;
 
         uint8_t b = decoded_data[pixel_pos * 4];
         uint8_t g = decoded_data[pixel_pos * 4 + 1];
@@ -248,19 +255,15 @@ SkColor CalculateKMeanColorOfPNG(scoped_refptr<base::RefCountedMemory> png,
         iteration < kNumberOfIterations && !convergence && !clusters.empty();
         ++iteration) {
 
-      // Loop through each pixel so we can place it in the appropriate cluster.
-      std::vector<uint8_t>::iterator pixel = decoded_data.begin();
-      while (pixel != decoded_data.end()) {
-        uint8_t b = *(pixel++);
-        if (pixel == decoded_data.end())
-          continue;
-        uint8_t g = *(pixel++);
-        if (pixel == decoded_data.end())
-          continue;
-        uint8_t r = *(pixel++);
-        if (pixel == decoded_data.end())
-          continue;
-        ++pixel; // Ignore the alpha channel.
+      // Loop through the sampled pixels so we can place each of them in the
+      // appropriate cluster.
+      for (int pixel_pos = 0; pixel_pos < pixel_count;
+           pixel_pos += pixel_step) {
+        // Ignore the alpha channel.
+        const uint8_t* pixel = &decoded_data[pixel_pos * 4];
+        uint8_t b = pixel[0];
+        uint8_t g = pixel[1];
+        uint8_t r = pixel[2];
 
         uint32_t distance_sqr_to_closest_cluster = UINT_MAX;
         std::vector<KMeanCluster>::iterator closest_cluster = clusters.begin();
@@ -8,6 +8,8 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "third_party/skia/include/core/SkColor.h"
+#include "ui/gfx/codec/png_codec.h"
+#include "ui/gfx/size.h"
 
 namespace {
 
@@ -178,3 +180,33 @@ TEST_F(ColorAnalysisTest, CalculatePNGKMeanPickMostCommon) {
 
   EXPECT_EQ(color, SkColorSetARGB(0xFF, 0xFF, 0x00, 0x00));
 }
+
+// Images too big to assign every pixel to clusters are sampled.
+TEST_F(ColorAnalysisTest, CalculatePNGKMeanLargeImage) {
+  const int kWidth = 512;
+  const int kHeight = 512;
+  // Red on the top three quarters, blue below, in BGRA.
+  std::vector<unsigned char> bgra(kWidth * kHeight * 4, 0xFF);
+  for (int i = 0; i < kWidth * kHeight; ++i) {
+    bool red = i < kWidth * kHeight * 3 / 4;
+    bgra[i * 4] = red ? 0x00 : 0xFF;
+    bgra[i * 4 + 1] = 0x00;
+    bgra[i * 4 + 2] = red ? 0xFF : 0x00;
+  }
+  std::vector<unsigned char> encoded;
+  ASSERT_TRUE(gfx::PNGCodec::Encode(&bgra[0], gfx::PNGCodec::FORMAT_BGRA,
+                                    gfx::Size(kWidth, kHeight), kWidth * 4,
+                                    false,
+                                    std::vector<gfx::PNGCodec::Comment>(),
+                                    &encoded));
+
+  MockKMeanImageSampler test_sampler;
+  test_sampler.AddSample(0);
+  test_sampler.AddSample(kWidth * kHeight - 1);
+  scoped_refptr<base::RefCountedBytes> png(
+      new base::RefCountedBytes(encoded));
+
+  SkColor color = CalculateKMeanColorOfPNG(png, 100, 600, test_sampler);
+
+  EXPECT_EQ(color, SkColorSetARGB(0xFF, 0xFF, 0x00, 0x00));
+}
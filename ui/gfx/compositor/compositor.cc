@@ -135,8 +135,11 @@ Compositor::Compositor(CompositorDelegate* delegate,
       command_line->HasSwitch(switches::kUIShowLayerTree);
   settings.refreshRate = test_compositor_enabled ?
       kTestRefreshRate : kDefaultRefreshRate;
+  // Only the damaged part of the screen is drawn and swapped when the
+  // surface supports post_sub_buffer, so that small animations don't redraw
+  // the whole screen.
   settings.partialSwapEnabled =
-      command_line->HasSwitch(switches::kUIEnablePartialSwap);
+      !command_line->HasSwitch(switches::kUIDisablePartialSwap);
   settings.perTilePainting =
     command_line->HasSwitch(switches::kUIEnablePerTilePainting);
 
@@ -10,7 +10,7 @@ const char kDisableTestCompositor[] = "disable-test-compositor";
 
 const char kDisableUIVsync[] = "disable-ui-vsync";
 
-const char kUIEnablePartialSwap[] = "ui-enable-partial-swap";
+const char kUIDisablePartialSwap[] = "ui-disable-partial-swap";
 
 // Show FPS counter.
 const char kUIShowFPSCounter[] = "ui-show-fps-counter";
@@ -23,8 +23,11 @@ namespace {
 static const base::TimeDelta kDefaultTransitionDuration =
     base::TimeDelta::FromMilliseconds(120);
 
+// Animations are stepped once per frame of a 60Hz display. Stepping them more
+// often only makes more work for the UI thread, since the compositor draws at
+// most once per frame anyway.
 static const base::TimeDelta kTimerInterval =
-    base::TimeDelta::FromMilliseconds(10);
+    base::TimeDelta::FromMicroseconds(16667);
 
 } // namespace;
 
@@ -56,6 +56,22 @@ void CheckStyleRanges(const gfx::StyleRanges& style_ranges, size_t length) {
 }
 #endif
 
+// Returns true if applying |style_range| changes the font style of some of
+// the text styled by |style_ranges|. If |whole_text| is true, |style_range|
+// replaces all of them.
+bool ChangesFontStyle(const gfx::StyleRanges& style_ranges,
+                      const gfx::StyleRange& style_range,
+                      bool whole_text) {
+  for (gfx::StyleRanges::const_iterator i = style_ranges.begin();
+       i != style_ranges.end(); ++i) {
+    if ((whole_text || i->range.Intersects(style_range.range)) &&
+        i->font_style != style_range.font_style) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void ApplyStyleRangeImpl(gfx::StyleRanges* style_ranges,
                          const gfx::StyleRange& style_range) {
   const ui::Range& new_range = style_range.range;
@@ -546,7 +562,7 @@ void RenderText::SetCompositionRange(const ui::Range& composition_range) {
         ui::Range(0, text_.length()).Contains(composition_range));
   composition_range_.set_end(composition_range.end());
   composition_range_.set_start(composition_range.start());
-  ResetLayout();
+  DecorationsChanged();
 }
 
 void RenderText::ApplyStyleRange(const StyleRange& style_range) {
@@ -555,22 +571,31 @@ void RenderText::ApplyStyleRange(const StyleRange& style_range) {
     return;
   CHECK(!new_range.is_reversed());
   CHECK(ui::Range(0, text_.length()).Contains(new_range));
+  bool font_style_changed =
+      ChangesFontStyle(style_ranges_, style_range, false);
   ApplyStyleRangeImpl(&style_ranges_, style_range);
 #ifndef NDEBUG
   CheckStyleRanges(style_ranges_, text_.length());
 #endif
-  // TODO(xji): only invalidate if font or underline changes.
   cached_bounds_and_offset_valid_ = false;
-  ResetLayout();
+  // Only the font styles affect the shaping of the text.
+  if (font_style_changed)
+    ResetLayout();
+  else
+    DecorationsChanged();
 }
 
 void RenderText::ApplyDefaultStyle() {
-  style_ranges_.clear();
   StyleRange style = StyleRange(default_style_);
   style.range.set_end(text_.length());
+  bool font_style_changed = ChangesFontStyle(style_ranges_, style, true);
+  style_ranges_.clear();
   style_ranges_.push_back(style);
   cached_bounds_and_offset_valid_ = false;
-  ResetLayout();
+  if (font_style_changed)
+    ResetLayout();
+  else
+    DecorationsChanged();
 }
 
 VisualCursorDirection RenderText::GetVisualDirectionOfLogicalEnd() {
@@ -701,6 +726,10 @@ void RenderText::SetSelectionModel(const SelectionModel& model) {
   cached_bounds_and_offset_valid_ = false;
 }
 
+void RenderText::DecorationsChanged() {
+  ResetLayout();
+}
+
 string16 RenderText::GetDisplayText() const {
   if (!obscured_)
     return text_;
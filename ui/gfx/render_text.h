@@ -313,6 +313,11 @@ class UI_EXPORT RenderText {
   // Reset the layout to be invalid.
   virtual void ResetLayout() = 0;
 
+  // Called when the colors, decorations or composition of the text change
+  // but not its fonts. The default resets the layout; platforms that only
+  // apply those when drawing keep it, so the text isn't shaped again.
+  virtual void DecorationsChanged();
+
   // Ensure the text is laid out.
   virtual void EnsureLayout() = 0;
 
@@ -289,6 +289,11 @@ void RenderTextLinux::ResetLayout() {
   layout_text_len_ = 0;
 }
 
+void RenderTextLinux::DecorationsChanged() {
+  // Only the font styles are set on |layout_|, the colors and decorations are
+  // applied by DrawVisualText.
+}
+
 void RenderTextLinux::EnsureLayout() {
   if (layout_ == NULL) {
     cairo_surface_t* surface =
@@ -42,6 +42,7 @@ class RenderTextLinux : public RenderText {
   virtual std::vector<Rect> GetSubstringBounds(ui::Range range) OVERRIDE;
   virtual bool IsCursorablePosition(size_t position) OVERRIDE;
   virtual void ResetLayout() OVERRIDE;
+  virtual void DecorationsChanged() OVERRIDE;
   virtual void EnsureLayout() OVERRIDE;
   virtual void DrawVisualText(Canvas* canvas) OVERRIDE;
 
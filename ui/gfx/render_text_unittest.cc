@@ -951,6 +951,27 @@ TEST_F(RenderTextTest, StringSizeBoldWidth) {
   EXPECT_GT(bold_width, plain_width);
 }
 
+TEST_F(RenderTextTest, StringSizeColorThenBoldWidth) {
+  scoped_ptr<RenderText> render_text(RenderText::CreateRenderText());
+  render_text->SetText(UTF8ToUTF16("Hello World"));
+
+  const int plain_width = render_text->GetStringSize().width();
+  EXPECT_GT(plain_width, 0);
+
+  // A color doesn't change the width.
+  StyleRange red;
+  red.foreground = SK_ColorRED;
+  red.range = ui::Range(0, 5);
+  render_text->ApplyStyleRange(red);
+  EXPECT_EQ(plain_width, render_text->GetStringSize().width());
+
+  // Making the colored text bold does.
+  StyleRange bold(red);
+  bold.font_style |= gfx::Font::BOLD;
+  render_text->ApplyStyleRange(bold);
+  EXPECT_GT(render_text->GetStringSize().width(), plain_width);
+}
+
 TEST_F(RenderTextTest, StringSizeHeight) {
   struct {
     string16 text;
@@ -12,6 +12,7 @@
 #include "base/message_loop.h"
 #include "base/stringprintf.h"
 #include "base/utf_string_conversions.h"
+#include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkRect.h"
 #include "ui/base/accessibility/accessibility_types.h"
 #include "ui/base/dragdrop/drag_drop_types.h"
@@ -138,6 +139,7 @@ View::View()
       registered_for_visible_bounds_notification_(false),
       clip_insets_(0, 0, 0, 0),
       needs_layout_(true),
+      paint_cache_enabled_(false),
       flip_canvas_on_paint_for_rtl_ui_(false),
       paint_to_layer_(false),
       accelerator_registration_delayed_(false),
@@ -205,6 +207,7 @@ void View::AddChildViewAt(View* view, int index) {
   // Let's insert the view.
   view->parent_ = this;
   children_.insert(children_.begin() + index, view);
+  InvalidatePaintCache();
 
   for (View* v = this; v; v = v->parent_)
     v->ViewHierarchyChangedImpl(false, true, this, view);
@@ -251,6 +254,7 @@ void View::ReorderChildView(View* view, int index) {
   // Add it in the specified index now.
   InitFocusSiblings(view, index);
   children_.insert(children_.begin() + index, view);
+  InvalidatePaintCache();
 
   if (use_acceleration_when_possible)
     ReorderLayers();
@@ -711,6 +715,7 @@ void View::SchedulePaint() {
 }
 
 void View::SchedulePaintInRect(const gfx::Rect& rect_in_dip) {
+  InvalidatePaintCache();
   if (!visible_ || !painting_enabled_)
     return;
 
@@ -747,7 +752,24 @@ void View::Paint(gfx::Canvas* canvas) {
   canvas->Translate(GetMirroredPosition());
   canvas->Transform(GetTransform());
 
-  PaintCommon(canvas);
+  if (!paint_cache_enabled_ || !visible_ || !painting_enabled_) {
+    PaintCommon(canvas);
+    return;
+  }
+
+  if (!paint_cache_.get()) {
+    paint_cache_.reset(new SkPicture);
+    gfx::Canvas recording_canvas(
+        paint_cache_->beginRecording(width(), height()));
+    PaintCommon(&recording_canvas);
+    paint_cache_->endRecording();
+  }
+  paint_cache_->draw(canvas->sk_canvas());
+}
+
+void View::set_paint_cache_enabled(bool enabled) {
+  paint_cache_enabled_ = enabled;
+  paint_cache_.reset();
 }
 
 ThemeProvider* View::GetThemeProvider() const {
@@ -1554,6 +1576,14 @@ void View::PaintCommon(gfx::Canvas* canvas) {
   PaintChildren(canvas);
 }
 
+void View::InvalidatePaintCache() {
+  for (View* v = this; v; v = v->parent_) {
+    v->paint_cache_.reset();
+    if (v->layer())
+      break;
+  }
+}
+
 // Tree operations -------------------------------------------------------------
 
 void View::DoRemoveChildView(View* view,
@@ -1584,6 +1614,7 @@ void View::DoRemoveChildView(View* view,
       view_to_be_deleted.reset(view);
 
     children_.erase(i);
+    InvalidatePaintCache();
   }
 
   if (update_tool_tip)
@@ -1829,6 +1860,10 @@ void View::CreateLayer() {
   UpdateParentLayers();
   UpdateLayerVisibility();
 
+  // The View now paints to its own layer rather than into its ancestors.
+  if (parent_)
+    parent_->InvalidatePaintCache();
+
   // The new layer needs to be ordered in the layer tree according
   // to the view tree. Children of this layer were added in order
   // in UpdateParentLayers().
@@ -32,6 +32,8 @@
 
 using ui::OSExchangeData;
 
+class SkPicture;
+
 namespace gfx {
 class Canvas;
 class Insets;
@@ -461,6 +463,14 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // the hierarchy beneath it.
   virtual void Paint(gfx::Canvas* canvas);
 
+  // Sets whether Paint() keeps a recording of what the View and its children
+  // paint, and replays it instead of painting them again until SchedulePaint()
+  // is called on one of them or the children change. Only suits Views whose
+  // painting depends on nothing but the state that schedules their paints,
+  // and which don't paint natively. Off by default.
+  void set_paint_cache_enabled(bool enabled);
+  bool paint_cache_enabled() const { return paint_cache_enabled_; }
+
   // The background object is owned by this object and may be NULL.
   void set_background(Background* b) { background_.reset(b); }
   const Background* background() const { return background_.get(); }
@@ -1147,6 +1157,10 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // invoke OnPaint() on the View.
   void PaintCommon(gfx::Canvas* canvas);
 
+  // Drops the paint recordings of the View and of its ancestors up to the
+  // closest one painting to a layer, as they include what the View paints.
+  void InvalidatePaintCache();
+
   // Tree operations -----------------------------------------------------------
 
   // Removes |view| from the hierarchy tree.  If |update_focus_cycle| is true,
@@ -1235,7 +1249,10 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // Disables painting during time critical operations. Used by PaintLock.
   // TODO(vollick) Ideally, the widget would not dispatch paints into the
   // hierarchy during time critical operations and this would not be needed.
-  void set_painting_enabled(bool enabled) { painting_enabled_ = enabled; }
+  void set_painting_enabled(bool enabled) {
+    painting_enabled_ = enabled;
+    InvalidatePaintCache();
+  }
 
   // Creates the layer and related fields for this view.
   void CreateLayer();
@@ -1413,6 +1430,10 @@ class VIEWS_EXPORT View : public ui::LayerDelegate,
   // Border.
   scoped_ptr<Border> border_;
 
+  // Whether Paint() records and replays, and the recording if any.
+  bool paint_cache_enabled_;
+  scoped_ptr<SkPicture> paint_cache_;
+
   // RTL painting --------------------------------------------------------------
 
   // Indicates whether or not the gfx::Canvas object passed to View::Paint()
@@ -2133,6 +2133,54 @@ TEST_F(ViewTest, SetBoundsPaint) {
   EXPECT_EQ(gfx::Rect(10, 10, 40, 40), paint_rect);
 }
 
+class PaintCountingView : public View {
+ public:
+  PaintCountingView() : paint_count_(0) {
+  }
+
+  int paint_count() const { return paint_count_; }
+
+  virtual void OnPaint(gfx::Canvas* canvas) OVERRIDE {
+    ++paint_count_;
+  }
+
+ private:
+  int paint_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(PaintCountingView);
+};
+
+// Makes sure a View with a paint cache replays it until something in its
+// subtree schedules a paint.
+TEST_F(ViewTest, PaintCache) {
+  PaintCountingView top_view;
+  PaintCountingView* child_view = new PaintCountingView;
+  top_view.SetBoundsRect(gfx::Rect(0, 0, 100, 100));
+  child_view->SetBoundsRect(gfx::Rect(10, 10, 20, 20));
+  top_view.AddChildView(child_view);
+  top_view.set_paint_cache_enabled(true);
+
+  gfx::Canvas canvas(gfx::Size(100, 100), false);
+  top_view.Paint(&canvas);
+  top_view.Paint(&canvas);
+  EXPECT_EQ(1, top_view.paint_count());
+  EXPECT_EQ(1, child_view->paint_count());
+
+  child_view->SchedulePaint();
+  top_view.Paint(&canvas);
+  EXPECT_EQ(2, top_view.paint_count());
+  EXPECT_EQ(2, child_view->paint_count());
+
+  top_view.AddChildView(new View);
+  top_view.Paint(&canvas);
+  EXPECT_EQ(3, child_view->paint_count());
+
+  top_view.set_paint_cache_enabled(false);
+  top_view.Paint(&canvas);
+  top_view.Paint(&canvas);
+  EXPECT_EQ(5, child_view->paint_count());
+}
+
 // Tests conversion methods with a transform.
 TEST_F(ViewTest, ConvertPointToViewWithTransform) {
   TestView top_view;
@@ -42,6 +42,9 @@ static const int kMaxMemDiskCacheSize = 10 * 1024 * 1024;
 static const FilePath::CharType kDiskCacheDirectoryName[] =
     FILE_PATH_LITERAL("Cache");
 
+// How many main resource urls without a response are remembered.
+static const size_t kMaxMainResponseMisses = 1000;
+
 namespace {
 
 // Helper with no return value for use with base::Bind.
@@ -762,6 +765,7 @@ void AppCacheStorageImpl::StoreGroupAndCacheTask::RunCompleted() {
   if (success_) {
     storage_->UpdateUsageMapAndNotify(
         group_->manifest_url().GetOrigin(), new_origin_usage_);
+    storage_->ForgetMainResponseMisses(group_->manifest_url().GetOrigin());
     if (cache_ != group_->newest_complete_cache()) {
       cache_->set_complete(true);
       group_->AddCache(cache_);
@@ -1076,6 +1080,8 @@ FindMainResponseTask::FindFirstValidNamespace(
 }
 
 void AppCacheStorageImpl::FindMainResponseTask::RunCompleted() {
+  if (cache_id_ == kNoCacheId)
+    storage_->AddMainResponseMiss(url_);
   storage_->CallOnMainResponseFound(
       &delegates_, url_, entry_, namespace_entry_url_, fallback_entry_,
       cache_id_, group_id_, manifest_url_);
@@ -1301,6 +1307,7 @@ AppCacheStorageImpl::AppCacheStorageImpl(AppCacheService* service)
       did_start_deleting_responses_(false),
       last_deletable_response_rowid_(0),
       database_(NULL), is_disabled_(false),
+      main_response_miss_count_(0),
       ALLOW_THIS_IN_INITIALIZER_LIST(weak_factory_(this)) {
 }
 
@@ -1491,7 +1498,8 @@ void AppCacheStorageImpl::FindResponseForMainRequest(
     }
   }
 
-  if (IsInitTaskComplete() &&  usage_map_.find(origin) == usage_map_.end()) {
+  if ((IsInitTaskComplete() && usage_map_.find(origin) == usage_map_.end()) ||
+      IsMainResponseMiss(*url_ptr)) {
     // No need to query the database, return async'ly but without going thru
     // the DB thread.
     scoped_refptr<AppCacheGroup> no_group;
@@ -1512,6 +1520,30 @@ void AppCacheStorageImpl::FindResponseForMainRequest(
   task->Schedule();
 }
 
+void AppCacheStorageImpl::AddMainResponseMiss(const GURL& url) {
+  if (main_response_miss_count_ >= kMaxMainResponseMisses) {
+    main_response_misses_.clear();
+    main_response_miss_count_ = 0;
+  }
+  if (main_response_misses_[url.GetOrigin()].insert(url).second)
+    ++main_response_miss_count_;
+}
+
+bool AppCacheStorageImpl::IsMainResponseMiss(const GURL& url) const {
+  MainResponseMisses::const_iterator found =
+      main_response_misses_.find(url.GetOrigin());
+  return found != main_response_misses_.end() &&
+         found->second.find(url) != found->second.end();
+}
+
+void AppCacheStorageImpl::ForgetMainResponseMisses(const GURL& origin) {
+  MainResponseMisses::iterator found = main_response_misses_.find(origin);
+  if (found == main_response_misses_.end())
+    return;
+  main_response_miss_count_ -= found->second.size();
+  main_response_misses_.erase(found);
+}
+
 bool AppCacheStorageImpl::FindResponseForMainRequestInGroup(
     AppCacheGroup* group,  const GURL& url, Delegate* delegate) {
   AppCache* cache = group->newest_complete_cache();
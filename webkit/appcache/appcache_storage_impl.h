@@ -90,6 +90,7 @@ class AppCacheStorageImpl : public AppCacheStorage {
   typedef std::map<GURL, GroupLoadTask*> PendingGroupLoads;
   typedef std::deque<std::pair<GURL, int64> > PendingForeignMarkings;
   typedef std::set<StoreGroupAndCacheTask*> PendingQuotaQueries;
+  typedef std::map<GURL, std::set<GURL> > MainResponseMisses;
 
   bool IsInitTaskComplete() {
     return last_cache_id_ != AppCacheStorage::kUnitializedId;
@@ -127,6 +128,12 @@ class AppCacheStorageImpl : public AppCacheStorage {
       const GURL& namespace_entry_url, const AppCacheEntry& fallback_entry,
       int64 cache_id, int64 group_id, const GURL& manifest_url);
 
+  // The database is only asked once for a main resource it has no response
+  // for, until a cache of the resource's origin is stored.
+  void AddMainResponseMiss(const GURL& url);
+  bool IsMainResponseMiss(const GURL& url) const;
+  void ForgetMainResponseMisses(const GURL& origin);
+
   APPCACHE_EXPORT AppCacheDiskCache* disk_cache();
 
   // The directory in which we place files in the file system.
@@ -162,6 +169,10 @@ class AppCacheStorageImpl : public AppCacheStorage {
 
   scoped_ptr<AppCacheDiskCache> disk_cache_;
 
+  // The main resource urls the database has no response for, by origin.
+  MainResponseMisses main_response_misses_;
+  size_t main_response_miss_count_;
+
   // Used to short-circuit certain operations without having to schedule
   // any tasks on the background database thread.
   std::deque<base::Closure> pending_simple_tasks_;
@@ -22,6 +22,11 @@ namespace appcache {
 
 static const int kBufferSize = 32768;
 static const size_t kMaxConcurrentUrlFetches = 2;
+
+// The fetches of the manifest's entries start at kMaxConcurrentUrlFetches
+// at a time, which grows with each response received, up to the number of
+// connections the network stack opens to one host.
+static const size_t kMaxConcurrentUrlFetchesAfterResponses = 6;
 static const int kMax503Retries = 3;
 
 // Helper class for collecting hosts per frontend when sending notifications
@@ -301,6 +306,7 @@ AppCacheUpdateJob::AppCacheUpdateJob(AppCacheService* service,
       internal_state_(FETCH_MANIFEST),
       master_entries_completed_(0),
       url_fetches_completed_(0),
+      max_concurrent_url_fetches_(kMaxConcurrentUrlFetches),
       manifest_fetcher_(NULL),
       stored_state_(UNSTORED) {
 }
@@ -543,6 +549,10 @@ void AppCacheUpdateJob::HandleUrlFetchCompleted(URLFetcher* fetcher) {
       ? request->GetResponseCode() : -1;
   AppCacheEntry& entry = url_file_list_.find(url)->second;
 
+  if (response_code != -1 &&
+      max_concurrent_url_fetches_ < kMaxConcurrentUrlFetchesAfterResponses)
+    ++max_concurrent_url_fetches_;
+
   if (response_code / 100 == 2) {
     // Associate storage with the new entry.
     DCHECK(fetcher->response_writer());
@@ -931,7 +941,7 @@ void AppCacheUpdateJob::FetchUrls() {
   // Fetch each URL in the list according to section 6.9.4 step 17.1-17.3.
   // Fetch up to the concurrent limit. Other fetches will be triggered as each
   // each fetch completes.
-  while (pending_url_fetches_.size() < kMaxConcurrentUrlFetches &&
+  while (pending_url_fetches_.size() < max_concurrent_url_fetches_ &&
          !urls_to_fetch_.empty()) {
     UrlToFetch url_to_fetch = urls_to_fetch_.front();
     urls_to_fetch_.pop_front();
@@ -260,6 +260,9 @@ class APPCACHE_EXPORT AppCacheUpdateJob : public AppCacheStorage::Delegate,
   AppCache::EntryMap url_file_list_;
   size_t url_fetches_completed_;
 
+  // How many of the URLs to fetch may be fetched at once.
+  size_t max_concurrent_url_fetches_;
+
   // Helper container to track which urls have not been fetched yet. URLs are
   // removed when the fetch is initiated. Flag indicates whether an attempt
   // to load the URL from storage has already been tried and failed.
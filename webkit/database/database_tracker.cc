@@ -272,6 +272,7 @@ void DatabaseTracker::CloseTrackerDatabaseAndClearCaches() {
   ClearAllCachedOriginInfo();
 
   if (!is_incognito_) {
+    database_ids_.clear();
     meta_table_.reset(NULL);
     databases_table_.reset(NULL);
     db_->Close();
@@ -302,10 +303,17 @@ FilePath DatabaseTracker::GetFullDBFilePath(
   if (!LazyInit())
     return FilePath();
 
-  int64 id = databases_table_->GetDatabaseID(
-      origin_identifier, database_name);
-  if (id < 0)
-    return FilePath();
+  int64 id;
+  std::pair<string16, string16> key(origin_identifier, database_name);
+  DatabaseIdsMap::const_iterator it = database_ids_.find(key);
+  if (it != database_ids_.end()) {
+    id = it->second;
+  } else {
+    id = databases_table_->GetDatabaseID(origin_identifier, database_name);
+    if (id < 0)
+      return FilePath();
+    database_ids_[key] = id;
+  }
 
   FilePath file_name = FilePath::FromWStringHack(
       UTF8ToWide(base::Int64ToString(id)));
@@ -386,6 +394,7 @@ bool DatabaseTracker::DeleteClosedDatabase(const string16& origin_identifier,
   // Clean up the main database and invalidate the cached record.
   databases_table_->DeleteDatabaseDetails(origin_identifier, database_name);
   origins_info_map_.erase(origin_identifier);
+  database_ids_.erase(std::make_pair(origin_identifier, database_name));
 
   std::vector<DatabaseDetails> details;
   if (databases_table_->GetAllDatabaseDetailsForOrigin(
@@ -436,6 +445,12 @@ bool DatabaseTracker::DeleteOrigin(const string16& origin_identifier,
   file_util::Delete(new_origin_dir, true); // might fail on windows.
 
   databases_table_->DeleteOrigin(origin_identifier);
+  DatabaseIdsMap::iterator id_it =
+      database_ids_.lower_bound(std::make_pair(origin_identifier, string16()));
+  while (id_it != database_ids_.end() &&
+         id_it->first.first == origin_identifier) {
+    database_ids_.erase(id_it++);
+  }
 
   if (quota_manager_proxy_ && deleted_size) {
     quota_manager_proxy_->NotifyStorageModified(
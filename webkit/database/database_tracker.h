@@ -180,6 +180,7 @@ class DatabaseTracker
       PendingDeletionCallbacks;
   typedef std::map<string16, base::PlatformFile> FileHandlesMap;
   typedef std::map<string16, string16> OriginDirectoriesMap;
+  typedef std::map<std::pair<string16, string16>, int64> DatabaseIdsMap;
 
   class CachedOriginInfo : public OriginInfo {
    public:
@@ -273,6 +274,11 @@ class DatabaseTracker
   std::map<string16, CachedOriginInfo> origins_info_map_;
   DatabaseConnections database_connections_;
 
+  // The IDs of the databases in |databases_table_|, keyed on their origin
+  // and name, so that GetFullDBFilePath() doesn't query the tracker database
+  // every time a database is opened or modified.
+  DatabaseIdsMap database_ids_;
+
   // The set of databases that should be deleted but are still opened
   DatabaseSet dbs_to_be_deleted_;
   PendingDeletionCallbacks deletion_callbacks_;
@@ -23,9 +23,16 @@ using webkit_database::DatabaseUtil;
 namespace dom_storage {
 
 static const int kCommitTimerSeconds = 1;
+static const size_t kMaxCommitBatchBytes = 1024 * 1024;
+
+static size_t SizeOfChange(const string16& key,
+                           const NullableString16& value) {
+  return (key.length() + value.string().length()) * sizeof(char16);
+}
 
 DomStorageArea::CommitBatch::CommitBatch()
-  : clear_all_first(false) {
+  : clear_all_first(false),
+    bytes(0) {
 }
 DomStorageArea::CommitBatch::~CommitBatch() {}
 
@@ -60,7 +67,9 @@ DomStorageArea::DomStorageArea(
       task_runner_(task_runner),
       map_(new DomStorageMap(kPerAreaQuota)),
       is_initial_import_done_(true),
-      is_shutdown_(false) {
+      is_shutdown_(false),
+      commit_delay_(base::TimeDelta::FromSeconds(kCommitTimerSeconds)),
+      max_commit_batch_bytes_(kMaxCommitBatchBytes) {
   if (namespace_id == kLocalStorageNamespaceId && !directory.empty()) {
     FilePath path = directory.Append(DatabaseFileNameFromOrigin(origin_));
     backing_.reset(new DomStorageDatabase(path));
@@ -108,10 +117,8 @@ bool DomStorageArea::SetItem(const string16& key,
   if (!map_->HasOneRef())
     map_ = map_->DeepCopy();
   bool success = map_->SetItem(key, value, old_value);
-  if (success && backing_.get()) {
-    CommitBatch* commit_batch = CreateCommitBatchIfNeeded();
-    commit_batch->changed_values[key] = NullableString16(value, false);
-  }
+  if (success && backing_.get())
+    AddToCommitBatch(key, NullableString16(value, false));
   return success;
 }
 
@@ -122,10 +129,8 @@ bool DomStorageArea::RemoveItem(const string16& key, string16* old_value) {
   if (!map_->HasOneRef())
     map_ = map_->DeepCopy();
   bool success = map_->RemoveItem(key, old_value);
-  if (success && backing_.get()) {
-    CommitBatch* commit_batch = CreateCommitBatchIfNeeded();
-    commit_batch->changed_values[key] = NullableString16(true);
-  }
+  if (success && backing_.get())
+    AddToCommitBatch(key, NullableString16(true));
   return success;
 }
 
@@ -142,6 +147,7 @@ bool DomStorageArea::Clear() {
     CommitBatch* commit_batch = CreateCommitBatchIfNeeded();
     commit_batch->clear_all_first = true;
     commit_batch->changed_values.clear();
+    commit_batch->bytes = 0;
   }
 
   return true;
@@ -164,6 +170,12 @@ bool DomStorageArea::HasUncommittedChanges() const {
   return commit_batch_.get() || in_flight_commit_batch_.get();
 }
 
+void DomStorageArea::SetCommitPolicy(base::TimeDelta commit_delay,
+                                     size_t max_commit_batch_bytes) {
+  commit_delay_ = commit_delay;
+  max_commit_batch_bytes_ = max_commit_batch_bytes;
+}
+
 void DomStorageArea::DeleteOrigin() {
   DCHECK(!is_shutdown_);
   if (HasUncommittedChanges()) {
@@ -240,17 +252,45 @@ DomStorageArea::CommitBatch* DomStorageArea::CreateCommitBatchIfNeeded() {
       task_runner_->PostDelayedTask(
           FROM_HERE,
           base::Bind(&DomStorageArea::OnCommitTimer, this),
-          base::TimeDelta::FromSeconds(kCommitTimerSeconds));
+          commit_delay_);
     }
   }
   return commit_batch_.get();
 }
 
+void DomStorageArea::AddToCommitBatch(const string16& key,
+                                      const NullableString16& value) {
+  CommitBatch* commit_batch = CreateCommitBatchIfNeeded();
+  ValuesMap::iterator found = commit_batch->changed_values.find(key);
+  if (found != commit_batch->changed_values.end()) {
+    commit_batch->bytes -= SizeOfChange(key, found->second);
+    found->second = value;
+  } else {
+    commit_batch->changed_values[key] = value;
+  }
+  commit_batch->bytes += SizeOfChange(key, value);
+
+  // Don't wait for the timer once the batch is big enough. If a commit is
+  // in flight, OnCommitComplete() checks the size again.
+  if (commit_batch->bytes >= max_commit_batch_bytes_ &&
+      !in_flight_commit_batch_.get()) {
+    PostCommitTask();
+  }
+}
+
 void DomStorageArea::OnCommitTimer() {
   DCHECK_EQ(kLocalStorageNamespaceId, namespace_id_);
   if (is_shutdown_)
     return;
 
+  // The batch the timer was started for may already have been committed
+  // because it grew too big, so a later batch may be committed early.
+  if (!commit_batch_.get() || in_flight_commit_batch_.get())
+    return;
+  PostCommitTask();
+}
+
+void DomStorageArea::PostCommitTask() {
   DCHECK(backing_.get());
   DCHECK(commit_batch_.get());
   DCHECK(!in_flight_commit_batch_.get());
@@ -286,11 +326,16 @@ void DomStorageArea::OnCommitComplete() {
     return;
   in_flight_commit_batch_.reset();
   if (commit_batch_.get()) {
-    // More changes have accrued, restart the timer.
+    // More changes have accrued, commit them now if there are enough of
+    // them, otherwise restart the timer.
+    if (commit_batch_->bytes >= max_commit_batch_bytes_) {
+      PostCommitTask();
+      return;
+    }
     task_runner_->PostDelayedTask(
         FROM_HERE,
         base::Bind(&DomStorageArea::OnCommitTimer, this),
-        base::TimeDelta::FromSeconds(kCommitTimerSeconds));
+        commit_delay_);
   }
 }
 
@@ -11,6 +11,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/nullable_string16.h"
 #include "base/string16.h"
+#include "base/time.h"
 #include "googleurl/src/gurl.h"
 #include "webkit/dom_storage/dom_storage_database.h"
 #include "webkit/dom_storage/dom_storage_types.h"
@@ -54,6 +55,12 @@ class DomStorageArea
 
   bool HasUncommittedChanges() const;
 
+  // Changes are written to disk |commit_delay| after the first of them,
+  // or as soon as they add up to |max_commit_batch_bytes| of keys and
+  // values, so that a burst of large writes isn't all held in memory.
+  void SetCommitPolicy(base::TimeDelta commit_delay,
+                       size_t max_commit_batch_bytes);
+
   // Similar to Clear() but more optimized for just deleting
   // without raising events.
   void DeleteOrigin();
@@ -74,6 +81,7 @@ class DomStorageArea
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, BackingDatabaseOpened);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, TestDatabaseFilePath);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, CommitTasks);
+  FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, CommitBatchCap);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, CommitChangesAtShutdown);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, DeleteOrigin);
   FRIEND_TEST_ALL_PREFIXES(DomStorageAreaTest, PurgeMemory);
@@ -82,6 +90,7 @@ class DomStorageArea
   struct CommitBatch {
     bool clear_all_first;
     ValuesMap changed_values;
+    size_t bytes;  // Of the keys and values in |changed_values|.
     CommitBatch();
     ~CommitBatch();
   };
@@ -97,7 +106,9 @@ class DomStorageArea
   // disk on the commit sequence, and to call back on the primary
   // task sequence when complete.
   CommitBatch* CreateCommitBatchIfNeeded();
+  void AddToCommitBatch(const string16& key, const NullableString16& value);
   void OnCommitTimer();
+  void PostCommitTask();
   void CommitChanges();
   void OnCommitComplete();
 
@@ -113,6 +124,8 @@ class DomStorageArea
   bool is_shutdown_;
   scoped_ptr<CommitBatch> commit_batch_;
   scoped_ptr<CommitBatch> in_flight_commit_batch_;
+  base::TimeDelta commit_delay_;
+  size_t max_commit_batch_bytes_;
 };
 
 }  // namespace dom_storage
@@ -270,6 +270,39 @@ TEST_F(DomStorageAreaTest, CommitTasks) {
   EXPECT_EQ(kValue2, values[kKey2].string());
 }
 
+TEST_F(DomStorageAreaTest, CommitBatchCap) {
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+
+  scoped_refptr<DomStorageArea> area(
+      new DomStorageArea(kLocalStorageNamespaceId, kOrigin,
+          temp_dir.path(),
+          new MockDomStorageTaskRunner(base::MessageLoopProxy::current())));
+  area->backing_.reset(new DomStorageDatabase());
+  const size_t kItemBytes = (kKey.length() + kValue.length()) * sizeof(char16);
+  area->SetCommitPolicy(base::TimeDelta::FromHours(1), 2 * kItemBytes);
+
+  // Changing the same key again doesn't add up to the cap.
+  NullableString16 old_value;
+  EXPECT_TRUE(area->SetItem(kKey, kValue, &old_value));
+  EXPECT_TRUE(area->SetItem(kKey, kValue, &old_value));
+  EXPECT_EQ(kItemBytes, area->commit_batch_->bytes);
+  EXPECT_FALSE(area->in_flight_commit_batch_.get());
+
+  // A second key does, and puts the batch in flight without waiting for
+  // the timer.
+  EXPECT_TRUE(area->SetItem(kKey2, kValue, &old_value));
+  EXPECT_FALSE(area->commit_batch_.get());
+  EXPECT_TRUE(area->in_flight_commit_batch_.get());
+  MessageLoop::current()->RunAllPending();
+  EXPECT_FALSE(area->HasUncommittedChanges());
+
+  ValuesMap values;
+  area->backing_->ReadAllValues(&values);
+  EXPECT_EQ(2u, values.size());
+  EXPECT_EQ(kValue, values[kKey2].string());
+}
+
 TEST_F(DomStorageAreaTest, CommitChangesAtShutdown) {
   ScopedTempDir temp_dir;
   ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
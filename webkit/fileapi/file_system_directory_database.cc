@@ -70,6 +70,7 @@ const char kChildLookupSeparator[] = ":";
 const char kLastFileIdKey[] = "LAST_FILE_ID";
 const char kLastIntegerKey[] = "LAST_INTEGER";
 const int64 kMinimumReportIntervalHours = 1;
+const size_t kChildIdCacheSize = 1024;
 const char kInitStatusHistogramLabel[] = "FileSystem.DirectoryDatabaseInit";
 
 enum InitStatus {
@@ -380,7 +381,8 @@ FileSystemDirectoryDatabase::FileInfo::~FileInfo() {
 
 FileSystemDirectoryDatabase::FileSystemDirectoryDatabase(
     const FilePath& filesystem_data_directory)
-    : filesystem_data_directory_(filesystem_data_directory) {
+    : filesystem_data_directory_(filesystem_data_directory),
+      child_id_cache_(kChildIdCacheSize) {
 }
 
 FileSystemDirectoryDatabase::~FileSystemDirectoryDatabase() {
@@ -392,6 +394,11 @@ bool FileSystemDirectoryDatabase::GetChildWithName(
     return false;
   DCHECK(child_id);
   std::string child_key = GetChildLookupKey(parent_id, name);
+  ChildIdCache::iterator cached = child_id_cache_.Get(child_key);
+  if (cached != child_id_cache_.end()) {
+    *child_id = cached->second;
+    return true;
+  }
   std::string child_id_string;
   leveldb::Status status =
       db_->Get(leveldb::ReadOptions(), child_key, &child_id_string);
@@ -402,6 +409,7 @@ bool FileSystemDirectoryDatabase::GetChildWithName(
       LOG(ERROR) << "Hit database corruption!";
       return false;
     }
+    child_id_cache_.Put(child_key, *child_id);
     return true;
   }
   HandleError(FROM_HERE, status);
@@ -669,6 +677,8 @@ bool FileSystemDirectoryDatabase::DestroyDatabase(const FilePath& path) {
 bool FileSystemDirectoryDatabase::Init(RecoveryOption recovery_option) {
   if (db_.get())
     return true;
+  // A repaired or recreated database may not have the cached entries.
+  child_id_cache_.Clear();
 
   std::string path =
       FilePathToString(filesystem_data_directory_.Append(
@@ -853,7 +863,11 @@ bool FileSystemDirectoryDatabase::RemoveFileInfoHelper(
       return false;
     }
   }
-  batch->Delete(GetChildLookupKey(info.parent_id, info.name));
+  std::string child_key = GetChildLookupKey(info.parent_id, info.name);
+  ChildIdCache::iterator cached = child_id_cache_.Peek(child_key);
+  if (cached != child_id_cache_.end())
+    child_id_cache_.Erase(cached);
+  batch->Delete(child_key);
   batch->Delete(GetFileLookupKey(file_id));
   return true;
 }
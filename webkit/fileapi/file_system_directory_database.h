@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "base/file_path.h"
+#include "base/memory/mru_cache.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/time.h"
 
@@ -110,8 +111,14 @@ class FileSystemDirectoryDatabase {
   void HandleError(const tracked_objects::Location& from_here,
                    const leveldb::Status& status);
 
+  // Maps the child lookup keys of recently looked up paths to their ids, so
+  // that each lookup of a path doesn't read all of its components from the
+  // database.
+  typedef base::MRUCache<std::string, FileId> ChildIdCache;
+
   FilePath filesystem_data_directory_;
   scoped_ptr<leveldb::DB> db_;
+  ChildIdCache child_id_cache_;
   base::Time last_reported_time_;
   DISALLOW_COPY_AND_ASSIGN(FileSystemDirectoryDatabase);
 };
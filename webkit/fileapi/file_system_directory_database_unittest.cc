@@ -319,6 +319,31 @@ TEST_F(FileSystemDirectoryDatabaseTest, TestGetFileWithPath) {
   EXPECT_EQ(file_id2, check_file_id);
 }
 
+TEST_F(FileSystemDirectoryDatabaseTest, TestGetFileWithPathAfterChanges) {
+  FileId dir_id;
+  FileId file_id;
+  CreateDirectory(0, FPL("foo"), &dir_id);
+  CreateDirectory(dir_id, FPL("bar"), &file_id);
+
+  // Look the path up so that its components are cached.
+  const FilePath old_path = FilePath(FPL("foo")).Append(FPL("bar"));
+  const FilePath new_path = FilePath(FPL("baz")).Append(FPL("bar"));
+  FileId check_file_id;
+  EXPECT_TRUE(db()->GetFileWithPath(old_path, &check_file_id));
+  EXPECT_EQ(file_id, check_file_id);
+
+  FileInfo info;
+  ASSERT_TRUE(db()->GetFileInfo(dir_id, &info));
+  info.name = FPL("baz");
+  EXPECT_TRUE(db()->UpdateFileInfo(dir_id, info));
+  EXPECT_FALSE(db()->GetFileWithPath(old_path, &check_file_id));
+  EXPECT_TRUE(db()->GetFileWithPath(new_path, &check_file_id));
+  EXPECT_EQ(file_id, check_file_id);
+
+  EXPECT_TRUE(db()->RemoveFileInfo(file_id));
+  EXPECT_FALSE(db()->GetFileWithPath(new_path, &check_file_id));
+}
+
 TEST_F(FileSystemDirectoryDatabaseTest, TestListChildren) {
   // No children in the root.
   std::vector<FileId> children;
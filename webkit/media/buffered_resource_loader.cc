@@ -4,11 +4,14 @@
 
 #include "webkit/media/buffered_resource_loader.h"
 
+#include "base/bind.h"
+#include "base/bind_helpers.h"
 #include "base/callback_helpers.h"
 #include "base/format_macros.h"
 #include "base/string_number_conversions.h"
 #include "base/string_util.h"
 #include "base/stringprintf.h"
+#include "base/time.h"
 #include "media/base/media_log.h"
 #include "media/base/seekable_buffer.h"
 #include "net/http/http_request_headers.h"
@@ -45,12 +48,17 @@ static const int kMinBufferCapacity = 2 * kMegabyte;
 // 20MB is an arbitrary limit; it just seems to be "good enough" in practice.
 static const int kMaxBufferCapacity = 20 * kMegabyte;
 
-// Maximum number of bytes outside the buffer we will wait for in order to
-// fulfill a read. If a read starts more than 2MB away from the data we
-// currently have in the buffer, we will not wait for buffer to reach the read's
-// location and will instead reset the request.
+// Minimum number of bytes outside the buffer we will wait for in order to
+// fulfill a read. If a read starts more than ForwardWaitThreshold() away from
+// the data we currently have in the buffer, we will not wait for buffer to
+// reach the read's location and will instead reset the request.
 static const int kForwardWaitThreshold = 2 * kMegabyte;
 
+// On fast connections, reads up to this many seconds of downloading away are
+// waited for too, since restarting the request would cost a round trip.
+static const int kForwardWaitSeconds = 2;
+static const int kMaxForwardWaitThreshold = 8 * kMegabyte;
+
 // Computes the suggested backward and forward capacity for the buffer
 // if one wants to play at |playback_rate| * the natural playback speed.
 // Use a value of 0 for |bitrate| if it is unknown.
@@ -143,6 +151,8 @@ void BufferedResourceLoader::Start(
 
   start_cb_ = start_cb;
   event_cb_ = event_cb;
+  download_rate_monitor_.Start(base::Bind(&base::DoNothing), bitrate_,
+                               false, false);
 
   if (first_byte_position_ != kPositionNotSpecified) {
     // TODO(hclam): server may not support range request so |offset_| may not
@@ -276,7 +286,7 @@ void BufferedResourceLoader::Read(
     // capacity.
     //
     // This can happen when reading in a large seek index or when the
-    // first byte of a read request falls within kForwardWaitThreshold.
+    // first byte of a read request falls within ForwardWaitThreshold().
     if (last_offset_ > buffer_->forward_capacity()) {
       saved_forward_capacity_ = buffer_->forward_capacity();
       buffer_->set_forward_capacity(last_offset_);
@@ -434,6 +444,8 @@ void BufferedResourceLoader::didReceiveData(
 
   // Writes more data to |buffer_|.
   buffer_->Append(reinterpret_cast<const uint8*>(data), data_length);
+  download_rate_monitor_.SetBufferedBytes(offset_ + buffer_->forward_bytes(),
+                                          base::Time::Now());
 
   // If there is an active read request, try to fulfill the request.
   if (HasPendingRead() && CanFulfillRead())
@@ -594,6 +606,7 @@ void BufferedResourceLoader::UpdateDeferBehavior() {
 
 void BufferedResourceLoader::SetDeferred(bool deferred) {
   active_loader_->SetDeferred(deferred);
+  download_rate_monitor_.SetNetworkActivity(!deferred);
   NotifyNetworkEvent();
 }
 
@@ -675,7 +688,7 @@ bool BufferedResourceLoader::WillFulfillRead() const {
     return false;
 
   // Trying to read too far ahead.
-  if ((first_offset_ - buffer_->forward_bytes()) >= kForwardWaitThreshold)
+  if ((first_offset_ - buffer_->forward_bytes()) >= ForwardWaitThreshold())
     return false;
 
   // The resource request has completed, there's no way we can fulfill the
@@ -686,6 +699,16 @@ bool BufferedResourceLoader::WillFulfillRead() const {
   return true;
 }
 
+int BufferedResourceLoader::ForwardWaitThreshold() const {
+  float bytes_per_second = download_rate_monitor_.ApproximateDownloadByteRate();
+  if (bytes_per_second <= 0)
+    return kForwardWaitThreshold;
+  float threshold = bytes_per_second * kForwardWaitSeconds;
+  if (threshold >= kMaxForwardWaitThreshold)
+    return kMaxForwardWaitThreshold;
+  return std::max(static_cast<int>(threshold), kForwardWaitThreshold);
+}
+
 void BufferedResourceLoader::ReadInternal() {
   // Seek to the first byte requested.
   bool ret = buffer_->Seek(first_offset_);
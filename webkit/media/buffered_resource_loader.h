@@ -11,6 +11,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/timer.h"
 #include "googleurl/src/gurl.h"
+#include "media/base/download_rate_monitor.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/WebFrame.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/platform/WebURLLoader.h"
 #include "third_party/WebKit/Source/WebKit/chromium/public/platform/WebURLLoaderClient.h"
@@ -219,6 +220,10 @@ class BufferedResourceLoader : public WebKit::WebURLLoaderClient {
   // Returns true if the current read request will be fulfilled in the future.
   bool WillFulfillRead() const;
 
+  // Returns how many bytes past the buffered data a read may start and still
+  // be waited for, rather than failed so that the request is restarted.
+  int ForwardWaitThreshold() const;
+
   // Method that does the actual read and calls the |read_cb_|, assuming the
   // request range is in |buffer_|.
   void ReadInternal();
@@ -303,6 +308,9 @@ class BufferedResourceLoader : public WebKit::WebURLLoaderClient {
   // Playback rate of the media.
   float playback_rate_;
 
+  // Measures how fast |buffer_| is filled while the request isn't deferred.
+  media::DownloadRateMonitor download_rate_monitor_;
+
   scoped_refptr<media::MediaLog> media_log_;
 
   DISALLOW_COPY_AND_ASSIGN(BufferedResourceLoader);
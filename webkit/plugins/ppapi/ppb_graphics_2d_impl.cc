@@ -323,8 +323,19 @@ int32_t PPB_Graphics2D_Impl::Flush(PP_CompletionCallback callback) {
   if (HasPendingFlush())
     return PP_ERROR_INPROGRESS;
 
+  // A ReplaceContents overwrites the whole backing store, so the operations
+  // queued before the last one would only be copied over and invalidated
+  // again.
+  size_t first_operation = 0;
+  for (size_t i = queued_operations_.size(); i > 0; i--) {
+    if (queued_operations_[i - 1].type == QueuedOperation::REPLACE) {
+      first_operation = i - 1;
+      break;
+    }
+  }
+
   bool nothing_visible = true;
-  for (size_t i = 0; i < queued_operations_.size(); i++) {
+  for (size_t i = first_operation; i < queued_operations_.size(); i++) {
     QueuedOperation& operation = queued_operations_[i];
     gfx::Rect op_rect;
     switch (operation.type) {
@@ -45,16 +45,12 @@ class ClientUsageTracker::GatherUsageTaskBase : public QuotaTask {
   void GetUsageForOrigins(const std::set<GURL>& origins, StorageType type) {
     DCHECK(original_message_loop()->BelongsToCurrentThread());
     // We do not get usage for origins for which we have valid usage cache.
+    // |origins| is a set, so it holds no duplicates.
     std::vector<GURL> origins_to_gather;
-    std::set<GURL> cached_origins;
-    client_tracker()->GetCachedOrigins(&cached_origins);
-    std::set<GURL> already_added;
     for (std::set<GURL>::const_iterator iter = origins.begin();
          iter != origins.end(); ++iter) {
-      if (cached_origins.find(*iter) == cached_origins.end() &&
-          already_added.insert(*iter).second) {
+      if (!client_tracker()->IsOriginCached(*iter))
         origins_to_gather.push_back(*iter);
-      }
     }
     if (origins_to_gather.empty()) {
       CallCompleted();
@@ -427,6 +423,13 @@ void ClientUsageTracker::GetCachedOrigins(std::set<GURL>* origins) const {
   }
 }
 
+bool ClientUsageTracker::IsOriginCached(const GURL& origin) const {
+  HostUsageMap::const_iterator found =
+      cached_usage_.find(net::GetHostOrSpecFromURL(origin));
+  return found != cached_usage_.end() &&
+         found->second.find(origin) != found->second.end();
+}
+
 void ClientUsageTracker::AddCachedOrigin(
     const GURL& origin, int64 usage) {
   std::string host = net::GetHostOrSpecFromURL(origin);
@@ -94,6 +94,7 @@ class ClientUsageTracker : public SpecialStoragePolicy::Observer,
   void UpdateUsageCache(const GURL& origin, int64 delta);
   void GetCachedHostsUsage(std::map<std::string, int64>* host_usage) const;
   void GetCachedOrigins(std::set<GURL>* origins) const;
+  bool IsOriginCached(const GURL& origin) const;
 
  private:
   typedef std::set<std::string> HostSet;